@@ -0,0 +1,204 @@
+// HTTP准入控制的过载测试：有效吞吐 (goodput) 随负载的变化
+//
+// 用法: admission_bench [workers] [service_ms] [seconds]
+// 服务端每个请求在阻塞任务池上占用一个线程service_ms毫秒，容量为workers * 1000 / service_ms req/s。
+// 客户端按固定速率开环发送 (每个请求一个连接，延迟从计划发送时刻算起)，负载为容量的0.5、1、2倍。
+// off:    关闭准入控制，请求全部排进线程池
+// codel:  并发上限2 * workers、队列上限4 * workers，CoDel目标20ms
+// goodput只统计延迟不超过SLO (250ms) 的200响应；开启准入控制后2倍过载下应与1倍负载持平。
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/beast.hpp>
+#include <spdlog/spdlog.h>
+
+#include "core/http/admission_controller.h"
+#include "core/http/http_server.h"
+
+namespace {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+namespace server = ai_backend::core::http;
+namespace async = ai_backend::core::async;
+
+constexpr std::chrono::milliseconds kSlo{250};
+constexpr std::chrono::seconds kClientTimeout{5};
+
+// 每个请求在阻塞任务池上睡眠固定时间，模拟容量有限的下游
+class WorkRouter : public server::Router {
+public:
+    WorkRouter(async::Runtime& runtime, std::chrono::milliseconds service_time)
+        : runtime_(runtime), service_time_(service_time) {}
+
+    void Initialize() override {}
+
+    async::Task<server::Response> Route(server::Request&) override {
+        auto service_time = service_time_;
+        co_await runtime_.RunBlocking([service_time]() { std::this_thread::sleep_for(service_time); },
+                                      runtime_.GetIoExecutor());
+        server::Response response;
+        response.status_code = 200;
+        response.headers["Content-Type"] = "application/json";
+        response.body = R"({"code":0,"message":"ok"})";
+        co_return response;
+    }
+
+private:
+    async::Runtime& runtime_;
+    std::chrono::milliseconds service_time_;
+};
+
+struct LoadResult {
+    size_t sent = 0;
+    size_t ok = 0;
+    size_t good = 0;
+    size_t shed = 0;
+    size_t errors = 0;
+    std::vector<double> ok_latencies_ms;
+};
+
+double Percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+net::awaitable<void> SendRequest(tcp::endpoint endpoint, Clock::time_point scheduled, LoadResult& result) {
+    auto executor = co_await net::this_coro::executor;
+    beast::tcp_stream stream(executor);
+    stream.expires_after(kClientTimeout);
+
+    try {
+        co_await stream.async_connect(endpoint, net::use_awaitable);
+
+        http::request<http::empty_body> req{http::verb::get, "/work", 11};
+        req.set(http::field::host, "127.0.0.1");
+        req.keep_alive(false);
+        co_await http::async_write(stream, req, net::use_awaitable);
+
+        beast::flat_buffer buffer;
+        http::response<http::string_body> res;
+        co_await http::async_read(stream, buffer, res, net::use_awaitable);
+
+        auto latency = Clock::now() - scheduled;
+        if (res.result_int() == 200) {
+            result.ok++;
+            result.ok_latencies_ms.push_back(std::chrono::duration<double, std::milli>(latency).count());
+            if (latency <= kSlo) {
+                result.good++;
+            }
+        } else if (res.result_int() == 503) {
+            result.shed++;
+        } else {
+            result.errors++;
+        }
+    } catch (const std::exception&) {
+        result.errors++;
+    }
+}
+
+// 按固定间隔发送，不等待前一个请求完成
+net::awaitable<void> GenerateLoad(tcp::endpoint endpoint, double rate, std::chrono::seconds duration,
+                                  LoadResult& result) {
+    auto executor = co_await net::this_coro::executor;
+    net::steady_timer timer(executor);
+    auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+    auto start = Clock::now();
+    auto count = static_cast<size_t>(rate * duration.count());
+
+    for (size_t i = 0; i < count; ++i) {
+        auto scheduled = start + period * i;
+        timer.expires_at(scheduled);
+        co_await timer.async_wait(net::use_awaitable);
+        result.sent++;
+        net::co_spawn(executor, SendRequest(endpoint, scheduled, result), net::detached);
+    }
+}
+
+LoadResult RunLoad(uint16_t port, double rate, std::chrono::seconds duration) {
+    LoadResult result;
+    net::io_context client;
+    tcp::endpoint endpoint(net::ip::make_address("127.0.0.1"), port);
+    net::co_spawn(client, GenerateLoad(endpoint, rate, duration, result), net::detached);
+    client.run();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t workers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4;
+    auto service_time = std::chrono::milliseconds(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5);
+    auto duration = std::chrono::seconds(argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 3);
+    double capacity = workers * 1000.0 / service_time.count();
+
+    spdlog::set_level(spdlog::level::warn);
+
+    std::printf("workers=%zu service=%lldms capacity=%.0f req/s slo=%lldms\n", workers,
+                static_cast<long long>(service_time.count()), capacity, static_cast<long long>(kSlo.count()));
+    std::printf("%-6s %5s %10s %10s %10s %8s %8s %10s\n",
+                "mode", "load", "offered/s", "ok/s", "goodput/s", "shed", "errors", "p99(ms)");
+
+    const struct {
+        const char* name;
+        bool enabled;
+    } modes[] = {
+        {"off", false},
+        {"codel", true},
+    };
+
+    uint16_t port = 18090;
+    for (const auto& mode : modes) {
+        for (double load : {0.5, 1.0, 2.0}) {
+            async::RuntimeOptions runtime_options;
+            runtime_options.io_threads = 2;
+            runtime_options.blocking_threads = workers;
+            runtime_options.cpu_threads = 1;
+            runtime_options.watchdog.enabled = false;
+            async::Runtime runtime(runtime_options);
+            runtime.Start();
+
+            server::AdmissionOptions admission_options;
+            admission_options.enabled = mode.enabled;
+            admission_options.target = std::chrono::milliseconds(20);
+            admission_options.interval = std::chrono::milliseconds(200);
+            admission_options.max_queue_time = std::chrono::milliseconds(200);
+            admission_options.classes.push_back({"work", {"/work"}, 2 * workers, 4 * workers});
+            server::AdmissionController admission(admission_options);
+
+            auto http_server = std::make_shared<server::HttpServer>(port, runtime, admission);
+            http_server->SetRouter(std::make_shared<WorkRouter>(runtime, service_time));
+            http_server->Start();
+
+            auto result = RunLoad(port, capacity * load, duration);
+
+            http_server->Stop();
+            runtime.Stop();
+            ++port;
+
+            double seconds = static_cast<double>(duration.count());
+            std::printf("%-6s %4.1fx %10.0f %10.0f %10.0f %8zu %8zu %10.1f\n",
+                        mode.name, load, result.sent / seconds, result.ok / seconds, result.good / seconds,
+                        result.shed, result.errors, Percentile(result.ok_latencies_ms, 0.99));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+// 协程同步原语的开销
+//
+// 用法: async_sync_bench [ops] [threads]
+// mutex-fast:  单个协程反复加锁解锁，没有竞争，测量快速路径
+// mutex:       64个协程在threads个I/O线程上争用同一把锁，临界区内让出一次线程
+// semaphore:   同样的负载，8个许可 (连接池的用法)
+// channel:     4个生产者、4个消费者经过容量64的通道传递ops个整数 (WebSocket发送队列的用法)
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "core/async/async_mutex.h"
+#include "core/async/async_semaphore.h"
+#include "core/async/channel.h"
+
+namespace {
+
+using ai_backend::core::async::AsyncMutex;
+using ai_backend::core::async::AsyncSemaphore;
+using ai_backend::core::async::Channel;
+using ai_backend::core::async::Spawn;
+using ai_backend::core::async::Task;
+
+constexpr size_t kWorkers = 64;
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Report(const char* name, size_t ops, double elapsed) {
+    std::printf("%-12s %12.1f %14.2f\n", name, elapsed * 1e9 / ops, ops / elapsed / 1e6);
+}
+
+struct YieldAwaiter {
+    boost::asio::any_io_executor executor;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        boost::asio::post(executor, [handle]() { handle.resume(); });
+    }
+    void await_resume() const noexcept {}
+};
+
+void Run(boost::asio::io_context& io_context, size_t threads) {
+    std::vector<std::thread> pool;
+    for (size_t i = 0; i < threads; ++i) {
+        pool.emplace_back([&io_context]() { io_context.run(); });
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+Task<void> Contend(AsyncSemaphore& semaphore, boost::asio::any_io_executor executor, size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+        co_await semaphore.Acquire();
+        YieldAwaiter yield{executor};
+        co_await yield;
+        semaphore.Release();
+    }
+}
+
+double BenchSemaphore(size_t permits, size_t ops, size_t threads) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    AsyncSemaphore semaphore(permits, executor);
+    for (size_t i = 0; i < kWorkers; ++i) {
+        Spawn(executor, Contend(semaphore, executor, ops / kWorkers));
+    }
+    auto start = std::chrono::steady_clock::now();
+    Run(io_context, threads);
+    return Seconds(start);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t ops = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+
+    std::printf("ops=%zu threads=%zu\n", ops, threads);
+    std::printf("%-12s %12s %14s\n", "case", "ns/op", "Mops/s");
+
+    {
+        boost::asio::io_context io_context;
+        AsyncMutex mutex(io_context.get_executor());
+        auto loop = [&]() -> Task<void> {
+            for (size_t i = 0; i < ops; ++i) {
+                auto lock = co_await mutex.ScopedLock();
+            }
+        };
+        auto start = std::chrono::steady_clock::now();
+        Spawn(io_context.get_executor(), loop());
+        io_context.run();
+        Report("mutex-fast", ops, Seconds(start));
+    }
+
+    Report("mutex", ops / kWorkers * kWorkers, BenchSemaphore(1, ops, threads));
+    Report("semaphore", ops / kWorkers * kWorkers, BenchSemaphore(8, ops, threads));
+
+    {
+        boost::asio::io_context io_context;
+        auto executor = io_context.get_executor();
+        Channel<size_t> channel(64, executor);
+        std::atomic<size_t> producers{4};
+        std::atomic<size_t> received{0};
+
+        auto producer = [&]() -> Task<void> {
+            for (size_t i = 0; i < ops / 4; ++i) {
+                co_await channel.Send(i);
+            }
+            if (--producers == 0) {
+                channel.Close();
+            }
+        };
+        auto consumer = [&]() -> Task<void> {
+            while (co_await channel.Receive()) {
+                received.fetch_add(1, std::memory_order_relaxed);
+            }
+        };
+        for (int i = 0; i < 4; ++i) {
+            Spawn(executor, consumer());
+            Spawn(executor, producer());
+        }
+        auto start = std::chrono::steady_clock::now();
+        Run(io_context, threads);
+        Report("channel", received.load(), Seconds(start));
+    }
+
+    return 0;
+}
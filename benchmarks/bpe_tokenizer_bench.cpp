@@ -0,0 +1,186 @@
+// BPE分词吞吐：完整编码、只计数、流式增量计数，以及二进制词表的mmap加载耗时
+//
+// 用法: bpe_tokenizer_bench [tokenizer.json或编译后的词表] [iterations]
+// 未指定词表时在生成的中英文混合文本上训练一个小词表 (约1000次合并)，
+// 只用于观察分词器本身的开销，token数与真实词表不可比。
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "services/ai/tokenizer/bpe_tokenizer.h"
+
+namespace {
+
+using ai_backend::services::ai::tokenizer::BpeTokenizer;
+using ai_backend::services::ai::tokenizer::NextPretokenEnd;
+using ai_backend::services::ai::tokenizer::StreamingTokenCounter;
+using ai_backend::services::ai::tokenizer::TokenId;
+
+std::string MakeCorpus(size_t bytes) {
+    const char* words[] = {
+        "the", "model", "response", "token", "stream", "server", "request", "context", "budget",
+        "async", "coroutine", "buffer", "latency", "function", "return", "value", "error", "cache",
+        "你好", "模型", "回复", "上下文", "请求", "服务器", "缓存", "延迟", "我们", "可以", "这个", "问题",
+        "2024", "128", "3.14", "don't", "it's", "(x)", "{\"a\": 1}", "->", "==", "//",
+    };
+    const char* separators[] = {" ", " ", " ", " ", ", ", ". ", "，", "。", "\n", "\n\n    "};
+
+    std::mt19937 rng(42);
+    std::string corpus;
+    while (corpus.size() < bytes) {
+        corpus += words[rng() % std::size(words)];
+        corpus += separators[rng() % std::size(separators)];
+    }
+    return corpus;
+}
+
+// 在预分词后的片段上做朴素的BPE训练
+std::shared_ptr<BpeTokenizer> TrainTokenizer(const std::string& corpus, size_t merge_count) {
+    std::map<std::string, size_t> piece_counts;
+    for (size_t pos = 0; pos < corpus.size();) {
+        size_t end = NextPretokenEnd(corpus, pos);
+        piece_counts[corpus.substr(pos, end - pos)]++;
+        pos = end;
+    }
+
+    std::vector<std::pair<std::vector<std::string>, size_t>> pieces;
+    for (const auto& [piece, count] : piece_counts) {
+        std::vector<std::string> symbols;
+        for (char c : piece) {
+            symbols.emplace_back(1, c);
+        }
+        pieces.emplace_back(std::move(symbols), count);
+    }
+
+    std::vector<std::string> tokens;
+    for (int b = 0; b < 256; ++b) {
+        tokens.emplace_back(1, static_cast<char>(b));
+    }
+    std::vector<std::pair<std::string, std::string>> merges;
+
+    for (size_t m = 0; m < merge_count; ++m) {
+        std::map<std::pair<std::string, std::string>, size_t> pair_counts;
+        for (const auto& [symbols, count] : pieces) {
+            for (size_t i = 0; i + 1 < symbols.size(); ++i) {
+                pair_counts[{symbols[i], symbols[i + 1]}] += count;
+            }
+        }
+        if (pair_counts.empty()) {
+            break;
+        }
+
+        auto best = pair_counts.begin();
+        for (auto it = pair_counts.begin(); it != pair_counts.end(); ++it) {
+            if (it->second > best->second) {
+                best = it;
+            }
+        }
+        const auto [left, right] = best->first;
+        merges.emplace_back(left, right);
+        tokens.push_back(left + right);
+
+        for (auto& [symbols, count] : pieces) {
+            std::vector<std::string> merged;
+            for (size_t i = 0; i < symbols.size(); ++i) {
+                if (i + 1 < symbols.size() && symbols[i] == left && symbols[i + 1] == right) {
+                    merged.push_back(left + right);
+                    ++i;
+                } else {
+                    merged.push_back(symbols[i]);
+                }
+            }
+            symbols = std::move(merged);
+        }
+    }
+
+    return BpeTokenizer::Build(tokens, merges).GetValue();
+}
+
+template<typename Fn>
+double MegabytesPerSecond(size_t bytes, size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(bytes) * iterations / seconds / (1024.0 * 1024.0);
+}
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "";
+    size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+
+    std::string corpus = MakeCorpus(1 << 20);
+    std::shared_ptr<BpeTokenizer> tokenizer;
+
+    auto load_start = std::chrono::steady_clock::now();
+    if (path.empty()) {
+        tokenizer = TrainTokenizer(corpus.substr(0, 32 << 10), 1000);
+        std::printf("synthetic vocab: %zu tokens, trained in %.1f ms\n", tokenizer->GetVocabSize(),
+                    MillisecondsSince(load_start));
+    } else {
+        auto result = BpeTokenizer::LoadFromFile(path);
+        if (result.IsError()) {
+            std::fprintf(stderr, "%s\n", result.GetError().c_str());
+            return 1;
+        }
+        tokenizer = result.GetValue();
+        std::printf("loaded %s: %zu tokens in %.1f ms (%s)\n", path.c_str(), tokenizer->GetVocabSize(),
+                    MillisecondsSince(load_start), tokenizer->IsMapped() ? "mmap" : "json");
+    }
+
+    // 保存为二进制后重新加载，对比加载耗时
+    std::string compiled_path = "/tmp/bpe_tokenizer_bench.bin";
+    if (tokenizer->SaveCompiled(compiled_path).IsOk()) {
+        auto mmap_start = std::chrono::steady_clock::now();
+        auto mapped = BpeTokenizer::LoadFromFile(compiled_path);
+        if (mapped.IsOk()) {
+            std::printf("mmap reload: %.3f ms\n", MillisecondsSince(mmap_start));
+            tokenizer = mapped.GetValue();
+        }
+        std::remove(compiled_path.c_str());
+    }
+
+    volatile size_t sink = 0;
+    std::vector<TokenId> ids;
+    ids.reserve(corpus.size());
+
+    std::printf("corpus=%zu bytes, iterations=%zu\n", corpus.size(), iterations);
+
+    double encode_mbps = MegabytesPerSecond(corpus.size(), iterations, [&]() {
+        ids.clear();
+        tokenizer->Encode(corpus, ids);
+        sink = sink + ids.size();
+    });
+    std::printf("%-10s %10.1f MB/s  tokens=%zu (%.2f bytes/token)\n", "encode", encode_mbps, ids.size(),
+                static_cast<double>(corpus.size()) / ids.size());
+
+    double count_mbps = MegabytesPerSecond(corpus.size(), iterations, [&]() {
+        sink = sink + tokenizer->CountTokens(corpus);
+    });
+    std::printf("%-10s %10.1f MB/s\n", "count", count_mbps);
+
+    // 模拟流式响应：每次追加约8字节
+    double stream_mbps = MegabytesPerSecond(corpus.size(), iterations, [&]() {
+        StreamingTokenCounter counter(tokenizer);
+        std::string_view view(corpus);
+        for (size_t pos = 0; pos < view.size(); pos += 8) {
+            counter.Append(view.substr(pos, 8));
+        }
+        sink = sink + counter.GetCount();
+    });
+    std::printf("%-10s %10.1f MB/s\n", "streaming", stream_mbps);
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+// BufferChain与原ZeroCopyBuffer在流式响应和大响应体上的耗时和复制字节数对比
+//
+// 用法: buffer_chain_bench [iterations] [tokens] [body_kb]
+// sse/legacy:  原SessionStreamWriter的做法，每个token拼成事件字符串，写入进行中到达的事件
+//              拼接成一个连续的chunk (ZeroCopyBuffer::Append后ToString交给写操作)
+// sse/chain:   事件前后缀和内容依次追加到BufferChain的池化段，chunk按切片分散/聚集写出
+// body/legacy: 上游返回的大响应体追加到ZeroCopyBuffer后ToString
+// body/chain:  大响应体的std::string直接被BufferChain接管
+// 每轮模拟一次流式响应：tokens个token，每8个合并为一次写操作；写操作用buffer_copy复制到
+// 固定的socket缓冲区代替内核复制，不计入copied_bytes/op。copied_bytes/op为用户态数据复制量。
+// body用例中模拟上游返回响应体的那次复制两边相同，不计入。
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+#include "core/memory/buffer_chain.h"
+
+namespace {
+
+using ai_backend::core::memory::BufferChain;
+
+size_t g_copied = 0;
+
+// 原core/memory/zero_copy_buffer.h，只保留基准测试用到的接口
+class LegacyBuffer {
+public:
+    explicit LegacyBuffer(size_t initial_capacity = 4096)
+        : buffer_(new char[initial_capacity]), size_(0), capacity_(initial_capacity) {}
+    ~LegacyBuffer() { delete[] buffer_; }
+
+    void Clear() { size_ = 0; }
+
+    void Append(const char* data, size_t size) {
+        if (size_ + size > capacity_) {
+            Reserve(std::max(capacity_ * 2, size_ + size));
+        }
+        std::memcpy(buffer_ + size_, data, size);
+        size_ += size;
+        g_copied += size;
+    }
+
+    std::string ToString() const {
+        g_copied += size_;
+        return std::string(buffer_, size_);
+    }
+
+private:
+    void Reserve(size_t capacity) {
+        char* new_buffer = new char[capacity];
+        std::memcpy(new_buffer, buffer_, size_);
+        g_copied += size_;
+        delete[] buffer_;
+        buffer_ = new_buffer;
+        capacity_ = capacity;
+    }
+
+    char* buffer_;
+    size_t size_;
+    size_t capacity_;
+};
+
+char g_socket[256 * 1024];
+
+template <typename ConstBufferSequence>
+size_t SocketWrite(const ConstBufferSequence& buffers) {
+    return boost::asio::buffer_copy(boost::asio::buffer(g_socket), buffers);
+}
+
+std::vector<std::string> MakeTokens(size_t count) {
+    static const char* words[] = {"the", " model", " streams", " tokens", "\n", " \"quoted\"", "，", " back"};
+    std::vector<std::string> tokens;
+    for (size_t i = 0; i < count; ++i) {
+        tokens.emplace_back(words[i % 8]);
+    }
+    return tokens;
+}
+
+size_t SseLegacy(const std::vector<std::string>& tokens, const std::string&) {
+    size_t written = 0;
+    LegacyBuffer pending;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        std::string event = "data: {\"delta\":\"" + tokens[i] + "\"}\n\n";
+        g_copied += event.size();
+        pending.Append(event.data(), event.size());
+        if (i % 8 == 7 || i + 1 == tokens.size()) {
+            std::string chunk = pending.ToString();
+            written += SocketWrite(boost::asio::buffer(chunk));
+            pending.Clear();
+        }
+    }
+    return written;
+}
+
+size_t SseChain(const std::vector<std::string>& tokens, const std::string&) {
+    size_t written = 0;
+    BufferChain pending;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        pending.Append("data: {\"delta\":\"");
+        pending.Append(tokens[i]);
+        pending.Append("\"}\n\n");
+        g_copied += 18 + tokens[i].size();
+        if (i % 8 == 7 || i + 1 == tokens.size()) {
+            BufferChain chunk = std::move(pending);
+            written += SocketWrite(chunk);
+            pending.Clear();
+        }
+    }
+    return written;
+}
+
+size_t BodyLegacy(const std::vector<std::string>&, const std::string& body) {
+    std::string upstream = body;
+    LegacyBuffer buffer;
+    buffer.Append(upstream.data(), upstream.size());
+    std::string out = buffer.ToString();
+    return SocketWrite(boost::asio::buffer(out));
+}
+
+size_t BodyChain(const std::vector<std::string>&, const std::string& body) {
+    std::string upstream = body;
+    BufferChain chain(std::move(upstream));
+    return SocketWrite(chain);
+}
+
+void Run(const char* name, size_t iterations, const std::vector<std::string>& tokens, const std::string& body,
+         size_t (*handler)(const std::vector<std::string>&, const std::string&)) {
+    size_t sink = 0;
+    g_copied = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        sink += handler(tokens, body);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-12s %12.1f %16.1f %14zu\n", name, elapsed * 1e9 / iterations,
+                static_cast<double>(g_copied) / iterations, sink / iterations);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    size_t token_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256;
+    size_t body_kb = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 128;
+    auto tokens = MakeTokens(token_count);
+    std::string body(body_kb * 1024, 'b');
+
+    std::printf("iterations=%zu tokens=%zu body=%zuKB\n", iterations, token_count, body_kb);
+    std::printf("%-12s %12s %16s %14s\n", "case", "ns/op", "copied_bytes/op", "bytes/op");
+
+    Run("sse/legacy", iterations, tokens, body, SseLegacy);
+    Run("sse/chain", iterations, tokens, body, SseChain);
+    Run("body/legacy", iterations, tokens, body, BodyLegacy);
+    Run("body/chain", iterations, tokens, body, BodyChain);
+    return 0;
+}
@@ -0,0 +1,130 @@
+// 工作窃取线程池的吞吐量
+//
+// 用法: coroutine_pool_bench [tasks] [threads]
+// fan-out:   外部线程提交tasks个空任务后WaitAll，经过全局注入队列
+// nested:    一个根任务在池内递归提交二叉树形的子任务，走本地队列和窃取
+// contended: 4个外部线程同时提交，测量注入队列的竞争
+// schedule:  协程通过co_await Schedule()切换到池线程，等待器本身作为任务节点，不分配内存
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/system_executor.hpp>
+
+#include "core/async/coroutine_pool.h"
+#include "core/async/task.h"
+
+namespace {
+
+using ai_backend::core::async::CoroutinePool;
+using ai_backend::core::async::Spawn;
+using ai_backend::core::async::Task;
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Report(const char* name, size_t tasks, double elapsed, const CoroutinePool& pool, size_t steals_before) {
+    std::printf("%-10s %12.1f %14.2f %12zu\n", name, elapsed * 1e9 / tasks, tasks / elapsed / 1e6,
+                pool.GetStealCount() - steals_before);
+}
+
+// 递归提交子任务直到叶子数达到2^depth
+void Spread(CoroutinePool& pool, std::atomic<size_t>& counter, int depth) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+    if (depth == 0) {
+        return;
+    }
+    pool.Post([&pool, &counter, depth]() { Spread(pool, counter, depth - 1); });
+    pool.Post([&pool, &counter, depth]() { Spread(pool, counter, depth - 1); });
+}
+
+Task<void> Hop(CoroutinePool& pool, size_t hops, std::atomic<size_t>& counter) {
+    for (size_t i = 0; i < hops; ++i) {
+        co_await pool.Schedule();
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t tasks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::thread::hardware_concurrency();
+
+    CoroutinePool pool(threads, threads);
+    std::atomic<size_t> counter{0};
+
+    std::printf("tasks=%zu threads=%zu\n", tasks, pool.GetWorkerCount());
+    std::printf("%-10s %12s %14s %12s\n", "case", "ns/task", "Mtasks/s", "steals");
+
+    {
+        size_t steals = pool.GetStealCount();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < tasks; ++i) {
+            pool.Post([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+        pool.WaitAll();
+        Report("fan-out", tasks, Seconds(start), pool, steals);
+    }
+
+    {
+        int depth = 0;
+        while ((size_t{2} << depth) - 1 < tasks) {
+            ++depth;
+        }
+        size_t nodes = (size_t{2} << depth) - 1;
+
+        size_t steals = pool.GetStealCount();
+        auto start = std::chrono::steady_clock::now();
+        pool.Post([&pool, &counter, depth]() { Spread(pool, counter, depth); });
+        pool.WaitAll();
+        Report("nested", nodes, Seconds(start), pool, steals);
+    }
+
+    {
+        constexpr size_t kProducers = 4;
+        size_t per_producer = tasks / kProducers;
+
+        size_t steals = pool.GetStealCount();
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < kProducers; ++p) {
+            producers.emplace_back([&]() {
+                for (size_t i = 0; i < per_producer; ++i) {
+                    pool.Post([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        pool.WaitAll();
+        Report("contended", per_producer * kProducers, Seconds(start), pool, steals);
+    }
+
+    {
+        constexpr size_t kCoroutines = 64;
+        size_t hops = tasks / kCoroutines;
+
+        size_t steals = pool.GetStealCount();
+        size_t before = counter.load();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kCoroutines; ++i) {
+            Spawn(boost::asio::system_executor(), Hop(pool, hops, counter));
+        }
+        while (counter.load(std::memory_order_relaxed) - before < hops * kCoroutines) {
+            std::this_thread::yield();
+        }
+        pool.WaitAll();
+        Report("schedule", hops * kCoroutines, Seconds(start), pool, steals);
+    }
+
+    return counter.load() == 0;
+}
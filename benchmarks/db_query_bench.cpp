@@ -0,0 +1,271 @@
+// 数据库查询对IO线程的占用：同步libpq调用 vs 非阻塞Connection
+//
+// 用法: db_query_bench [connections] [latency_ms] [queries]
+// 本地模拟的PostgreSQL服务端 (扩展查询协议) 每条语句延迟latency_ms毫秒后返回一行。
+// 所有查询都从同一个IO线程发起，同时用1ms的定时器测量事件循环的延迟 (定时器实际触发时刻晚于预期的时间)。
+// blocking: 在IO线程上直接调用PQexecParams，与原先在IO线程上执行pqxx::work相同，连接轮流使用
+// async:    每个连接一个协程，Connection::Query挂起等待结果，IO线程在等待期间处理其他事件
+// async的吞吐应接近connections * 1000 / latency_ms，事件循环延迟保持在毫秒级。
+
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <libpq-fe.h>
+
+#include "core/async/task.h"
+#include "core/db/connection.h"
+
+namespace {
+
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+using ai_backend::core::async::Deadline;
+using ai_backend::core::async::Spawn;
+using ai_backend::core::async::Task;
+using ai_backend::core::db::Connection;
+
+void AppendInt32(std::string& out, uint32_t value) {
+    value = htonl(value);
+    out.append(reinterpret_cast<const char*>(&value), 4);
+}
+
+void AppendInt16(std::string& out, uint16_t value) {
+    value = htons(value);
+    out.append(reinterpret_cast<const char*>(&value), 2);
+}
+
+void AppendMessage(std::string& out, char type, const std::string& body) {
+    out.push_back(type);
+    AppendInt32(out, static_cast<uint32_t>(body.size() + 4));
+    out.append(body);
+}
+
+uint32_t ReadInt32(const char* data) {
+    uint32_t value;
+    std::memcpy(&value, data, 4);
+    return ntohl(value);
+}
+
+// 每个连接一个线程；收到Sync时等待latency后返回一行一列的结果
+class MockServer {
+public:
+    explicit MockServer(std::chrono::milliseconds latency)
+        : latency_(latency), acceptor_(io_context_, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0)) {
+        std::thread([this]() {
+            for (;;) {
+                tcp::socket socket(io_context_);
+                boost::system::error_code ec;
+                acceptor_.accept(socket, ec);
+                if (ec) {
+                    return;
+                }
+                std::thread([this, socket = std::move(socket)]() mutable { Serve(std::move(socket)); }).detach();
+            }
+        }).detach();
+    }
+
+    std::string ConnInfo() const {
+        return "host=127.0.0.1 port=" + std::to_string(acceptor_.local_endpoint().port()) +
+               " user=bench dbname=bench sslmode=disable gssencmode=disable";
+    }
+
+private:
+    void Serve(tcp::socket socket) {
+        boost::system::error_code ec;
+        char header[5];
+        net::read(socket, net::buffer(header, 4), ec);
+        std::string body(ReadInt32(header) - 4, '\0');
+        net::read(socket, net::buffer(body), ec);
+        if (ec) {
+            return;
+        }
+
+        std::string out;
+        std::string auth;
+        AppendInt32(auth, 0);
+        AppendMessage(out, 'R', auth);
+        AppendMessage(out, 'S', std::string("server_version") + '\0' + "15.0" + '\0');
+        AppendMessage(out, 'S', std::string("client_encoding") + '\0' + "UTF8" + '\0');
+        AppendMessage(out, 'Z', "I");
+        net::write(socket, net::buffer(out), ec);
+
+        std::string reply;
+        AppendMessage(reply, '1', "");
+        AppendMessage(reply, '2', "");
+        std::string description;
+        AppendInt16(description, 1);
+        description += std::string("n") + '\0';
+        AppendInt32(description, 0);
+        AppendInt16(description, 0);
+        AppendInt32(description, 25);
+        AppendInt16(description, 0xFFFF);
+        AppendInt32(description, 0xFFFFFFFF);
+        AppendInt16(description, 0);
+        AppendMessage(reply, 'T', description);
+        std::string row;
+        AppendInt16(row, 1);
+        AppendInt32(row, 1);
+        row += "1";
+        AppendMessage(reply, 'D', row);
+        AppendMessage(reply, 'C', std::string("SELECT 1") + '\0');
+        AppendMessage(reply, 'Z', "I");
+
+        for (;;) {
+            net::read(socket, net::buffer(header, 5), ec);
+            if (ec || header[0] == 'X') {
+                return;
+            }
+            body.resize(ReadInt32(header + 1) - 4);
+            net::read(socket, net::buffer(body), ec);
+            if (ec) {
+                return;
+            }
+            if (header[0] == 'S') {
+                std::this_thread::sleep_for(latency_);
+                net::write(socket, net::buffer(reply), ec);
+            }
+        }
+    }
+
+    std::chrono::milliseconds latency_;
+    net::io_context io_context_;
+    tcp::acceptor acceptor_;
+};
+
+// 每1ms检查一次定时器的实际触发时刻，记录最大延迟
+class LoopLagProbe {
+public:
+    explicit LoopLagProbe(net::io_context& io_context) : timer_(io_context) { Arm(); }
+
+    // 最后一次等待尚未触发时也计入已经超出的时间
+    void Stop() {
+        Record();
+        stopped_ = true;
+        timer_.cancel();
+    }
+
+    double MaxLagMs() const { return max_lag_.count() / 1000.0; }
+
+private:
+    void Arm() {
+        expected_ = Clock::now() + std::chrono::milliseconds(1);
+        timer_.expires_at(expected_);
+        timer_.async_wait([this](const boost::system::error_code& ec) {
+            if (ec || stopped_) {
+                return;
+            }
+            Record();
+            Arm();
+        });
+    }
+
+    void Record() {
+        auto lag = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - expected_);
+        max_lag_ = std::max(max_lag_, lag);
+    }
+
+    net::steady_timer timer_;
+    Clock::time_point expected_;
+    std::chrono::microseconds max_lag_{0};
+    bool stopped_ = false;
+};
+
+struct CaseResult {
+    double seconds;
+    double max_lag_ms;
+};
+
+CaseResult RunBlocking(const std::string& conninfo, int connections, int queries) {
+    std::vector<PGconn*> conns;
+    for (int i = 0; i < connections; ++i) {
+        conns.push_back(PQconnectdb(conninfo.c_str()));
+    }
+
+    net::io_context io_context;
+    LoopLagProbe probe(io_context);
+    auto start = Clock::now();
+    int remaining = queries;
+    // 每个查询作为一个处理函数投递到IO线程，执行期间IO线程被阻塞
+    for (int i = 0; i < queries; ++i) {
+        net::post(io_context, [&, i]() {
+            const char* values[] = {"1"};
+            PGresult* result = PQexecParams(conns[i % connections], "SELECT $1", 1, nullptr, values,
+                                            nullptr, nullptr, 0);
+            PQclear(result);
+            if (--remaining == 0) {
+                probe.Stop();
+            }
+        });
+    }
+    io_context.run();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (auto* conn : conns) {
+        PQfinish(conn);
+    }
+    return {seconds, probe.MaxLagMs()};
+}
+
+Task<void> RunWorker(std::shared_ptr<Connection> connection, int count, int& remaining, LoopLagProbe& probe) {
+    for (int i = 0; i < count; ++i) {
+        auto query = connection->Query("SELECT $1", {1}, Deadline());
+        co_await query;
+    }
+    if (--remaining == 0) {
+        probe.Stop();
+    }
+}
+
+CaseResult RunAsync(const std::string& conninfo, int connections, int queries) {
+    net::io_context io_context;
+    std::vector<std::shared_ptr<Connection>> conns;
+    for (int i = 0; i < connections; ++i) {
+        conns.push_back(Connection::ConnectBlocking(io_context, conninfo));
+    }
+
+    LoopLagProbe probe(io_context);
+    auto start = Clock::now();
+    int remaining = connections;
+    for (int i = 0; i < connections; ++i) {
+        int count = queries / connections + (i < queries % connections ? 1 : 0);
+        Spawn(io_context.get_executor(), RunWorker(conns[i], count, remaining, probe));
+    }
+    io_context.run();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return {seconds, probe.MaxLagMs()};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int connections = argc > 1 ? std::atoi(argv[1]) : 8;
+    int latency_ms = argc > 2 ? std::atoi(argv[2]) : 5;
+    int queries = argc > 3 ? std::atoi(argv[3]) : 400;
+
+    MockServer server{std::chrono::milliseconds(latency_ms)};
+    std::string conninfo = server.ConnInfo();
+
+    std::printf("connections=%d latency=%dms queries=%d\n", connections, latency_ms, queries);
+    std::printf("%-10s %10s %12s %16s\n", "mode", "seconds", "queries/s", "max loop lag ms");
+
+    auto print = [queries](const char* mode, CaseResult result) {
+        std::printf("%-10s %10.3f %12.0f %16.2f\n", mode, result.seconds, queries / result.seconds,
+                    result.max_lag_ms);
+    };
+    print("blocking", RunBlocking(conninfo, connections, queries));
+    print("async", RunAsync(conninfo, connections, queries));
+    return 0;
+}
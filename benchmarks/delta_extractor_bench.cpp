@@ -0,0 +1,92 @@
+// 流式增量提取开销：每个token完整构建nlohmann::json DOM vs DeltaExtractor单遍扫描
+//
+// 用法: delta_extractor_bench [iterations]
+// 输入是与DeepSeek chat/completions流式响应一致的chunk，
+// 分别测量纯ASCII内容、含转义/中文的内容和带usage的最后一个chunk。
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "services/ai/streaming/delta_extractor.h"
+
+namespace {
+
+using json = nlohmann::json;
+using ai_backend::services::ai::streaming::DeltaExtractor;
+using ai_backend::services::ai::streaming::StreamDelta;
+
+std::string MakeChunk(const std::string& delta, const std::string& tail = ",\"finish_reason\":null}]}") {
+    return "{\"id\":\"a1b2c3d4-e5f6-7890-abcd-ef0123456789\",\"object\":\"chat.completion.chunk\","
+           "\"created\":1718345013,\"model\":\"deepseek-reasoner\",\"system_fingerprint\":\"fp_a49d71b8a1\","
+           "\"choices\":[{\"index\":0,\"delta\":" + delta + ",\"logprobs\":null" + tail;
+}
+
+// 旧实现：HandleStreamChunk中的完整解析
+size_t DomExtract(const std::string& chunk) {
+    auto json_response = json::parse(chunk);
+    if (json_response.contains("choices") &&
+        !json_response["choices"].empty() &&
+        json_response["choices"][0].contains("delta") &&
+        json_response["choices"][0]["delta"].contains("content") &&
+        json_response["choices"][0]["delta"]["content"].is_string()) {
+        std::string content_delta = json_response["choices"][0]["delta"]["content"].get<std::string>();
+        return content_delta.size();
+    }
+    return 0;
+}
+
+template<typename Fn>
+double NanosPerCall(size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500000;
+
+    const struct {
+        const char* name;
+        std::string chunk;
+    } cases[] = {
+        {"ascii", MakeChunk(R"({"content":" world"})")},
+        {"escaped", MakeChunk(R"({"content":"\n\n```cpp\nint main() {\"x\";}\n```"})")},
+        {"chinese", MakeChunk(R"({"content":"你好，世界"})")},
+        {"reasoning", MakeChunk(R"({"content":null,"reasoning_content":"Let me think"})")},
+        {"usage", MakeChunk(R"({"content":""})",
+                            ",\"finish_reason\":\"stop\"}],\"usage\":{\"prompt_tokens\":15,\"completion_tokens\":421,"
+                            "\"total_tokens\":436,\"prompt_tokens_details\":{\"cached_tokens\":0},"
+                            "\"prompt_cache_hit_tokens\":0,\"prompt_cache_miss_tokens\":15}}")},
+    };
+
+    DeltaExtractor extractor;
+    volatile size_t sink = 0;
+
+    std::printf("iterations=%zu\n", iterations);
+    std::printf("%-10s %8s %14s %14s %9s\n", "case", "bytes", "dom(ns)", "extract(ns)", "speedup");
+
+    for (const auto& c : cases) {
+        double dom_ns = NanosPerCall(iterations / 10, [&]() {
+            sink = sink + DomExtract(c.chunk);
+        });
+
+        double extract_ns = NanosPerCall(iterations, [&]() {
+            StreamDelta delta;
+            extractor.Extract(c.chunk, delta);
+            sink = sink + delta.content.size() + delta.reasoning_content.size() + delta.usage.has_value();
+        });
+
+        std::printf("%-10s %8zu %14.1f %14.1f %8.1fx\n", c.name, c.chunk.size(), dom_ns, extract_ns, dom_ns / extract_ns);
+    }
+
+    std::printf("fallbacks=%zu\n", extractor.GetFallbackCount());
+    return 0;
+}
@@ -0,0 +1,161 @@
+// 协程帧分配器对每个请求堆分配次数和耗时的影响
+//
+// 用法: frame_allocator_bench [requests]
+// heap:   关闭帧池，每个协程帧走全局new/delete (改动前的行为)
+// pooled: 帧从线程本地的分级空闲链表分配
+// arena:  整条调用链以 (std::allocator_arg, FrameArena&) 调用，帧从会话帧内的arena缓冲区分配
+// 每个请求模拟一次完整的协程链 (会话 -> 路由 -> 4个中间件 -> 控制器 -> 2个服务)，
+// 运行在io_context上，heap_allocs/req为全局operator new的调用次数
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include <boost/asio.hpp>
+
+#include "core/async/frame_allocator.h"
+#include "core/async/task.h"
+
+namespace {
+
+std::atomic<size_t> g_allocations{0};
+std::atomic<size_t> g_bytes{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+using ai_backend::core::async::FrameArena;
+using ai_backend::core::async::Spawn;
+using ai_backend::core::async::Task;
+
+Task<int> Service(int value) {
+    co_return value * 2;
+}
+
+Task<int> Controller(int value) {
+    co_return co_await Service(value) + co_await Service(value + 1);
+}
+
+Task<bool> Middleware(int value) {
+    co_return value >= 0;
+}
+
+Task<int> Route(int value) {
+    for (int i = 0; i < 4; ++i) {
+        if (!co_await Middleware(value)) {
+            co_return 0;
+        }
+    }
+    co_return co_await Controller(value);
+}
+
+Task<void> Session(int value, volatile int* sink) {
+    *sink = *sink + co_await Route(value);
+}
+
+// 同一条调用链的arena版本
+Task<int> ArenaService(std::allocator_arg_t, FrameArena&, int value) {
+    co_return value * 2;
+}
+
+Task<int> ArenaController(std::allocator_arg_t, FrameArena& arena, int value) {
+    co_return co_await ArenaService(std::allocator_arg, arena, value) +
+        co_await ArenaService(std::allocator_arg, arena, value + 1);
+}
+
+Task<bool> ArenaMiddleware(std::allocator_arg_t, FrameArena&, int value) {
+    co_return value >= 0;
+}
+
+Task<int> ArenaRoute(std::allocator_arg_t, FrameArena& arena, int value) {
+    for (int i = 0; i < 4; ++i) {
+        if (!co_await ArenaMiddleware(std::allocator_arg, arena, value)) {
+            co_return 0;
+        }
+    }
+    co_return co_await ArenaController(std::allocator_arg, arena, value);
+}
+
+// arena的第一块内存放在会话协程帧中，整条调用链不再单独分配
+Task<void> ArenaSession(int value, volatile int* sink) {
+    alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) std::byte buffer[1536];
+    FrameArena arena(buffer, sizeof(buffer));
+    *sink = *sink + co_await ArenaRoute(std::allocator_arg, arena, value);
+}
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename MakeSession>
+void Run(const char* name, size_t requests, MakeSession make_session) {
+    boost::asio::io_context io_context;
+
+    size_t allocations = g_allocations.load();
+    size_t bytes = g_bytes.load();
+    auto stats = ai_backend::core::async::GetFrameAllocatorStats();
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < requests; ++i) {
+        Spawn(io_context.get_executor(), make_session(static_cast<int>(i)));
+        // 每批运行一次，模拟有限的并发请求数
+        if (i % 256 == 255) {
+            io_context.run();
+            io_context.restart();
+        }
+    }
+    io_context.run();
+
+    double elapsed = Seconds(start);
+    auto after = ai_backend::core::async::GetFrameAllocatorStats();
+    std::printf("%-8s %10.1f %16.2f %16.1f %14.2f\n", name, elapsed * 1e9 / requests,
+                static_cast<double>(g_allocations.load() - allocations) / requests,
+                static_cast<double>(g_bytes.load() - bytes) / requests,
+                static_cast<double>(after.allocations - stats.allocations) / requests);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t requests = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    volatile int sink = 0;
+
+    std::printf("requests=%zu\n", requests);
+    std::printf("%-8s %10s %16s %16s %14s\n", "case", "ns/req", "heap_allocs/req", "heap_bytes/req",
+                "frames/req");
+
+    auto session = [&sink](int value) { return Session(value, &sink); };
+
+    ai_backend::core::async::SetFramePoolingEnabled(false);
+    Run("heap", requests, session);
+
+    ai_backend::core::async::SetFramePoolingEnabled(true);
+    Run("pooled", requests, session);
+
+    Run("arena", requests, [&sink](int value) { return ArenaSession(value, &sink); });
+
+    return 0;
+}
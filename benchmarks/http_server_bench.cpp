@@ -0,0 +1,168 @@
+// HttpServer IO模型对比：共享io_context vs 分片io_context + SO_REUSEPORT
+//
+// 用法: http_server_bench [threads] [connections] [requests_per_connection]
+// 每个连接使用keep-alive连续发送请求，统计吞吐量与p50/p99/p999延迟。
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+#include <spdlog/spdlog.h>
+
+#include "core/http/http_server.h"
+
+namespace {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+namespace server = ai_backend::core::http;
+namespace async = ai_backend::core::async;
+
+// 固定返回小JSON的路由器，只测量服务器本身的开销
+class StaticRouter : public server::Router {
+public:
+    void Initialize() override {}
+
+    async::Task<server::Response> Route(server::Request&) override {
+        server::Response response;
+        response.status_code = 200;
+        response.headers["Content-Type"] = "application/json";
+        response.body = R"({"code":0,"message":"ok"})";
+        co_return response;
+    }
+};
+
+struct RunResult {
+    double requests_per_second;
+    double p50_us;
+    double p99_us;
+    double p999_us;
+    size_t errors;
+};
+
+double Percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+RunResult RunLoad(uint16_t port, size_t connections, size_t requests_per_connection) {
+    std::vector<std::vector<double>> latencies(connections);
+    std::atomic<size_t> errors{0};
+    std::vector<std::thread> clients;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t c = 0; c < connections; ++c) {
+        clients.emplace_back([&, c]() {
+            try {
+                net::io_context ioc;
+                tcp::socket socket(ioc);
+                socket.connect(tcp::endpoint(net::ip::make_address("127.0.0.1"), port));
+                socket.set_option(tcp::no_delay(true));
+
+                beast::flat_buffer buffer;
+                http::request<http::empty_body> req{http::verb::get, "/api/v1/models", 11};
+                req.set(http::field::host, "127.0.0.1");
+                req.keep_alive(true);
+
+                latencies[c].reserve(requests_per_connection);
+                for (size_t i = 0; i < requests_per_connection; ++i) {
+                    auto t0 = std::chrono::steady_clock::now();
+                    http::write(socket, req);
+                    http::response<http::string_body> res;
+                    http::read(socket, buffer, res);
+                    auto t1 = std::chrono::steady_clock::now();
+                    latencies[c].push_back(
+                        std::chrono::duration<double, std::micro>(t1 - t0).count());
+                }
+            } catch (const std::exception&) {
+                errors++;
+            }
+        });
+    }
+
+    for (auto& client : clients) {
+        client.join();
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    for (auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+
+    RunResult result;
+    result.requests_per_second = all.size() / elapsed;
+    result.p50_us = Percentile(all, 0.50);
+    result.p99_us = Percentile(all, 0.99);
+    result.p999_us = Percentile(all, 0.999);
+    result.errors = errors;
+    return result;
+}
+
+RunResult RunMode(async::IoMode mode, uint16_t port, size_t threads,
+                  size_t connections, size_t requests_per_connection) {
+    async::RuntimeOptions options;
+    options.io_threads = threads;
+    options.io_mode = mode;
+    options.blocking_threads = 1;
+    options.cpu_threads = 1;
+    async::Runtime runtime(options);
+    runtime.Start();
+
+    auto http_server = std::make_shared<server::HttpServer>(port, runtime);
+    http_server->SetRouter(std::make_shared<StaticRouter>());
+    http_server->Start();
+
+    // 预热，建立连接并填充缓存
+    RunLoad(port, connections, 100);
+    auto result = RunLoad(port, connections, requests_per_connection);
+
+    http_server->Stop();
+    runtime.Stop();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+    size_t connections = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+    size_t requests = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 5000;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    std::printf("threads=%zu connections=%zu requests/conn=%zu\n", threads, connections, requests);
+    std::printf("%-8s %12s %10s %10s %10s %7s\n", "mode", "req/s", "p50(us)", "p99(us)", "p999(us)", "errors");
+
+    const struct {
+        const char* name;
+        async::IoMode mode;
+        uint16_t port;
+    } modes[] = {
+        {"shared", async::IoMode::kShared, 18080},
+        {"sharded", async::IoMode::kSharded, 18081},
+    };
+
+    for (const auto& m : modes) {
+        auto r = RunMode(m.mode, m.port, threads, connections, requests);
+        std::printf("%-8s %12.0f %10.1f %10.1f %10.1f %7zu\n",
+                    m.name, r.requests_per_second, r.p50_us, r.p99_us, r.p999_us, r.errors);
+    }
+
+    return 0;
+}
@@ -0,0 +1,205 @@
+// 内存池在多线程竞争下的分配/释放吞吐
+//
+// 用法: memory_pool_bench [ops_per_thread] [max_threads]
+// legacy: 改动前的内存池，单一块大小 (1024字节)，每次分配和释放都持有同一把互斥锁
+// pool:   按大小分级的内存池，线程本地弹匣 + 无锁全局仓库
+// malloc: glibc malloc/free
+// 每个线程维护256个存活对象的窗口，每次操作释放窗口中的一个对象再分配一个16~1024字节的新对象；
+// 每隔一段时间与相邻线程交换一半窗口，模拟跨线程释放。线程数从1倍增到max_threads。
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "core/memory/memory_pool.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kWindow = 256;
+constexpr size_t kMaxSize = 1024;
+constexpr size_t kExchangeInterval = 4096;
+
+// 改动前的实现
+class LegacyPool {
+public:
+    explicit LegacyPool(size_t block_size) : block_size_(block_size) {}
+
+    ~LegacyPool() {
+        for (auto* block : memory_blocks_) {
+            delete[] block;
+        }
+    }
+
+    void* Allocate(size_t size) {
+        if (size > block_size_) {
+            throw std::bad_alloc();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_blocks_.empty()) {
+            char* block = new char[block_size_ * 32];
+            memory_blocks_.push_back(block);
+            for (size_t i = 0; i < 32; ++i) {
+                free_blocks_.push_back(block + i * block_size_);
+            }
+        }
+        void* ptr = free_blocks_.back();
+        free_blocks_.pop_back();
+        return ptr;
+    }
+
+    void Deallocate(void* ptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_blocks_.push_back(ptr);
+    }
+
+private:
+    size_t block_size_;
+    std::mutex mutex_;
+    std::vector<char*> memory_blocks_;
+    std::vector<void*> free_blocks_;
+};
+
+struct Slot {
+    void* ptr = nullptr;
+    size_t size = 0;
+};
+
+// 相邻线程交换窗口用的信箱
+struct Mailbox {
+    std::mutex mutex;
+    std::vector<Slot> slots;
+};
+
+template <typename Allocate, typename Deallocate>
+double Run(size_t threads, size_t ops, Allocate allocate, Deallocate deallocate) {
+    std::vector<Mailbox> mailboxes(threads);
+    std::barrier start(static_cast<std::ptrdiff_t>(threads + 1));
+    std::atomic<int64_t> finished_ns{0};
+    std::vector<std::thread> workers;
+    Clock::time_point begin;
+
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            uint64_t state = 0x9e3779b97f4a7c15ull * (t + 1);
+            auto next_size = [&state] {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                return 16 + state % (kMaxSize - 15);
+            };
+
+            std::vector<Slot> window(kWindow);
+            for (auto& slot : window) {
+                slot.size = next_size();
+                slot.ptr = allocate(slot.size);
+            }
+            start.arrive_and_wait();
+
+            for (size_t i = 0; i < ops; ++i) {
+                auto& slot = window[i % kWindow];
+                deallocate(slot.ptr, slot.size);
+                slot.size = next_size();
+                slot.ptr = allocate(slot.size);
+                static_cast<char*>(slot.ptr)[0] = static_cast<char>(i);
+
+                if (threads > 1 && i % kExchangeInterval == kExchangeInterval - 1) {
+                    // 一半窗口交给下一个线程，取回上一个线程留下的对象
+                    auto& outbox = mailboxes[(t + 1) % threads];
+                    {
+                        std::lock_guard<std::mutex> lock(outbox.mutex);
+                        outbox.slots.insert(outbox.slots.end(), window.begin(), window.begin() + kWindow / 2);
+                    }
+                    std::vector<Slot> received;
+                    {
+                        std::lock_guard<std::mutex> lock(mailboxes[t].mutex);
+                        received.swap(mailboxes[t].slots);
+                    }
+                    for (size_t j = 0; j < kWindow / 2; ++j) {
+                        if (j < received.size()) {
+                            window[j] = received[j];
+                        } else {
+                            window[j].size = next_size();
+                            window[j].ptr = allocate(window[j].size);
+                        }
+                    }
+                    for (size_t j = kWindow / 2; j < received.size(); ++j) {
+                        deallocate(received[j].ptr, received[j].size);
+                    }
+                }
+            }
+
+            auto elapsed = Clock::now() - begin;
+            int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            int64_t current = finished_ns.load();
+            while (ns > current && !finished_ns.compare_exchange_weak(current, ns)) {
+            }
+
+            start.arrive_and_wait();
+            for (auto& slot : window) {
+                deallocate(slot.ptr, slot.size);
+            }
+            std::lock_guard<std::mutex> lock(mailboxes[t].mutex);
+            for (auto& slot : mailboxes[t].slots) {
+                deallocate(slot.ptr, slot.size);
+            }
+            mailboxes[t].slots.clear();
+        });
+    }
+
+    begin = Clock::now();
+    start.arrive_and_wait();
+    start.arrive_and_wait();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    // 最后一轮交换留在信箱里的对象
+    for (auto& mailbox : mailboxes) {
+        for (auto& slot : mailbox.slots) {
+            deallocate(slot.ptr, slot.size);
+        }
+    }
+
+    double seconds = finished_ns.load() / 1e9;
+    return threads * ops / seconds / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t ops = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t max_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+
+    std::printf("ops/thread=%zu window=%zu sizes=16..%zu\n", ops, kWindow, kMaxSize);
+    std::printf("%-8s %12s %12s %12s\n", "threads", "legacy Mops", "pool Mops", "malloc Mops");
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        LegacyPool legacy(kMaxSize);
+        double legacy_mops = Run(threads, ops,
+                                 [&](size_t size) { return legacy.Allocate(size); },
+                                 [&](void* ptr, size_t) { legacy.Deallocate(ptr); });
+
+        auto& pool = ai_backend::core::memory::MemoryPool::GetInstance();
+        double pool_mops = Run(threads, ops,
+                               [&](size_t size) { return pool.Allocate(size); },
+                               [&](void* ptr, size_t size) { pool.Deallocate(ptr, size); });
+        pool.ReleaseFreeMemory();
+
+        double malloc_mops = Run(threads, ops,
+                                 [](size_t size) { return std::malloc(size); },
+                                 [](void* ptr, size_t) { std::free(ptr); });
+
+        std::printf("%-8zu %12.1f %12.1f %12.1f\n", threads, legacy_mops, pool_mops, malloc_mops);
+    }
+
+    return 0;
+}
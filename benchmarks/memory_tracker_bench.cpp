@@ -0,0 +1,91 @@
+// 按子系统内存记账和分配采样的开销
+//
+// 用法: memory_tracker_bench [ops_per_thread] [max_threads]
+// pool:      直接使用PoolResource，不记账
+// tracked:   TrackedResource记账，不采样
+// sampled:   TrackedResource记账，按默认的512KB平均间隔采样调用栈
+// 每个线程维护256个存活对象的窗口，每次操作释放窗口中的一个对象再分配一个16~1024字节的新对象，
+// 所有线程记入同一个标签 (最坏情况：同一组计数器上的竞争)。线程数从1倍增到max_threads。
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+#include "core/memory/memory_pool.h"
+#include "core/memory/memory_tracker.h"
+
+namespace {
+
+using ai_backend::core::memory::MemoryTag;
+using ai_backend::core::memory::MemoryTracker;
+using ai_backend::core::memory::PoolResource;
+using ai_backend::core::memory::TrackedResource;
+
+constexpr size_t kWindow = 256;
+
+void Worker(std::pmr::memory_resource* resource, size_t ops, unsigned seed) {
+    struct Block {
+        void* ptr = nullptr;
+        size_t size = 0;
+    };
+    std::vector<Block> window(kWindow);
+    uint32_t state = seed;
+    for (size_t i = 0; i < ops; ++i) {
+        state = state * 1664525u + 1013904223u;
+        auto& block = window[i % kWindow];
+        if (block.ptr) {
+            resource->deallocate(block.ptr, block.size);
+        }
+        block.size = 16 + (state >> 8) % 1009;
+        block.ptr = resource->allocate(block.size);
+    }
+    for (auto& block : window) {
+        if (block.ptr) {
+            resource->deallocate(block.ptr, block.size);
+        }
+    }
+}
+
+double Run(std::pmr::memory_resource* resource, size_t ops, size_t threads) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back(Worker, resource, ops, static_cast<unsigned>(t + 1));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return elapsed * 1e9 / static_cast<double>(ops * threads);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t ops = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    size_t max_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 8;
+    auto& tracker = MemoryTracker::GetInstance();
+    TrackedResource tracked(MemoryTag::kCache);
+
+    std::printf("ops/thread=%zu\n", ops);
+    std::printf("%8s %12s %12s %12s %10s\n", "threads", "pool(ns)", "tracked(ns)", "sampled(ns)", "samples");
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        tracker.SetSampleInterval(0);
+        double pool = Run(PoolResource::GetInstance(), ops, threads);
+        double plain = Run(&tracked, ops, threads);
+
+        auto before = tracker.GetProfileStats().samples;
+        tracker.SetSampleInterval(512 * 1024);
+        double sampled = Run(&tracked, ops, threads);
+        auto samples = tracker.GetProfileStats().samples - before;
+
+        std::printf("%8zu %12.1f %12.1f %12.1f %10llu\n", threads, pool, plain, sampled,
+                    static_cast<unsigned long long>(samples));
+    }
+    return 0;
+}
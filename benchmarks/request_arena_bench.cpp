@@ -0,0 +1,322 @@
+// 请求级arena对消息列表接口 (GET /api/v1/dialogs/{id}/messages) 堆分配次数、耗时和RSS的影响
+//
+// 用法: request_arena_bench [requests_per_thread] [threads] [messages]
+// heap:  改动前的做法，models::Message的std::string字段、std::unordered_map中间件头部、
+//        nlohmann::json DOM拼装响应后dump
+// arena: 会话借出的RequestArena，models::pmr::Message和请求/响应头部从arena分配，
+//        JsonWriter直接写出响应体
+// 每个请求模拟一次完整处理：中间件写入CORS/限流头部和请求ID，从数据库行缓冲区复制messages条消息
+// (每3条带一个附件)，拼装JSON响应体并附加中间件头部。每个用例在独立的子进程中运行，
+// heap_allocs/req为全局operator new的调用次数，rss为用例结束时的常驻内存 (VmRSS)。
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+
+#include "core/http/request.h"
+#include "core/http/response.h"
+#include "core/memory/request_arena.h"
+#include "core/utils/json_writer.h"
+#include "models/message.h"
+
+namespace {
+
+std::atomic<size_t> g_allocations{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+using ai_backend::core::http::Request;
+using ai_backend::core::http::Response;
+using ai_backend::core::memory::RequestArena;
+using ai_backend::core::memory::RequestArenaSlot;
+using json = nlohmann::json;
+
+// 模拟查询结果中的一行
+struct Row {
+    std::string id;
+    std::string dialog_id;
+    std::string role;
+    std::string content;
+    std::string type;
+    size_t tokens;
+    std::string created_at;
+    std::string attachment_url;
+};
+
+std::vector<Row> MakeRows(size_t count) {
+    std::vector<Row> rows;
+    for (size_t i = 0; i < count; ++i) {
+        rows.push_back({
+            "6f1c2a9e-4b7d-4e21-9a3f-" + std::to_string(100000000000 + i),
+            "2d7e5b10-93c4-4f8a-b6d2-7a1e0c9f3b55",
+            i % 2 ? "assistant" : "user",
+            std::string(160 + i % 7 * 40, 'x'),
+            "text",
+            42 + i,
+            "2025-01-01 12:00:00.000000+08",
+            i % 3 == 0 ? "https://files.example.com/uploads/" + std::to_string(i) + ".png" : ""
+        });
+    }
+    return rows;
+}
+
+// 中间件：CORS、限流头部和请求ID
+template <typename HeaderMap, typename String>
+void RunMiddlewares(HeaderMap& cors_headers, HeaderMap& rate_limit_headers, String& request_id) {
+    request_id = "req-5f0e8c7a-1d2b-4c3d-8e9f-0a1b2c3d4e5f";
+    cors_headers["Access-Control-Allow-Origin"] = "https://chat.example.com";
+    cors_headers["Access-Control-Allow-Methods"] = "GET, POST, PUT, DELETE, OPTIONS";
+    cors_headers["Access-Control-Allow-Headers"] = "Content-Type, Authorization, X-Request-Timeout";
+    rate_limit_headers["X-RateLimit-Limit"] = std::to_string(600);
+    rate_limit_headers["X-RateLimit-Remaining"] = std::to_string(599);
+}
+
+size_t HeapRequest(const std::vector<Row>& rows) {
+    std::unordered_map<std::string, std::string> cors_headers;
+    std::unordered_map<std::string, std::string> rate_limit_headers;
+    std::string request_id;
+    RunMiddlewares(cors_headers, rate_limit_headers, request_id);
+
+    std::vector<ai_backend::models::Message> messages;
+    for (const auto& row : rows) {
+        ai_backend::models::Message message;
+        message.id = row.id;
+        message.dialog_id = row.dialog_id;
+        message.role = row.role;
+        message.content = row.content;
+        message.type = row.type;
+        message.tokens = row.tokens;
+        message.created_at = row.created_at;
+        if (!row.attachment_url.empty()) {
+            ai_backend::models::Attachment attachment;
+            attachment.id = row.id;
+            attachment.type = "image";
+            attachment.name = "image.png";
+            attachment.url = row.attachment_url;
+            message.attachments.push_back(attachment);
+        }
+        messages.push_back(message);
+    }
+
+    json messages_json = json::array();
+    for (const auto& message : messages) {
+        json message_json = {
+            {"id", message.id},
+            {"dialog_id", message.dialog_id},
+            {"role", message.role},
+            {"content", message.content},
+            {"type", message.type},
+            {"created_at", message.created_at},
+            {"tokens", message.tokens}
+        };
+        if (!message.attachments.empty()) {
+            json attachments_json = json::array();
+            for (const auto& attachment : message.attachments) {
+                attachments_json.push_back({
+                    {"id", attachment.id},
+                    {"type", attachment.type},
+                    {"name", attachment.name},
+                    {"url", attachment.url}
+                });
+            }
+            message_json["attachments"] = attachments_json;
+        }
+        messages_json.push_back(message_json);
+    }
+
+    Response response = Response::OK({
+        {"messages", messages_json},
+        {"total", messages_json.size()},
+        {"page", 1},
+        {"page_size", 50}
+    });
+    for (const auto& [name, value] : cors_headers) {
+        response.headers[Response::HeaderMap::key_type(name)] = value;
+    }
+    for (const auto& [name, value] : rate_limit_headers) {
+        response.headers[Response::HeaderMap::key_type(name)] = value;
+    }
+    return response.body.size();
+}
+
+size_t ArenaRequest(RequestArenaSlot& slot, const std::vector<Row>& rows) {
+    auto arena = slot.Acquire();
+    Request request(arena.Get());
+    RunMiddlewares(request.cors_headers, request.rate_limit_headers, request.request_id);
+
+    std::pmr::vector<ai_backend::models::pmr::Message> messages(arena.Get());
+    messages.reserve(rows.size());
+    for (const auto& row : rows) {
+        auto& message = messages.emplace_back();
+        message.id = row.id;
+        message.dialog_id = row.dialog_id;
+        message.role = row.role;
+        message.content = row.content;
+        message.type = row.type;
+        message.tokens = row.tokens;
+        message.created_at = row.created_at;
+        if (!row.attachment_url.empty()) {
+            auto& attachment = message.attachments.emplace_back();
+            attachment.id = row.id;
+            attachment.type = "image";
+            attachment.name = "image.png";
+            attachment.url = row.attachment_url;
+        }
+    }
+
+    Response response(arena.Get());
+    response.headers["Content-Type"] = "application/json";
+    size_t estimated_size = 128;
+    for (const auto& message : messages) {
+        estimated_size += 160 + message.content.size();
+    }
+    response.body.reserve(estimated_size);
+
+    ai_backend::core::utils::JsonWriter writer(response.body);
+    writer.BeginObject().Key("code").Int(0).Key("message").String("获取成功")
+        .Key("data").BeginObject().Key("messages").BeginArray();
+    for (const auto& message : messages) {
+        writer.BeginObject()
+            .Key("id").String(message.id)
+            .Key("dialog_id").String(message.dialog_id)
+            .Key("role").String(message.role)
+            .Key("content").String(message.content)
+            .Key("type").String(message.type)
+            .Key("created_at").String(message.created_at)
+            .Key("tokens").Uint(message.tokens);
+        if (!message.attachments.empty()) {
+            writer.Key("attachments").BeginArray();
+            for (const auto& attachment : message.attachments) {
+                writer.BeginObject()
+                    .Key("id").String(attachment.id)
+                    .Key("type").String(attachment.type)
+                    .Key("name").String(attachment.name)
+                    .Key("url").String(attachment.url)
+                    .EndObject();
+            }
+            writer.EndArray();
+        }
+        writer.EndObject();
+    }
+    writer.EndArray().Key("total").Uint(messages.size()).Key("page").Int(1).Key("page_size").Int(50)
+        .EndObject().EndObject();
+
+    for (const auto& [name, value] : request.cors_headers) {
+        response.headers[name] = value;
+    }
+    for (const auto& [name, value] : request.rate_limit_headers) {
+        response.headers[name] = value;
+    }
+    return response.body.size();
+}
+
+long ReadRssKb() {
+    FILE* file = std::fopen("/proc/self/status", "r");
+    if (!file) {
+        return 0;
+    }
+    char line[256];
+    long rss = 0;
+    while (std::fgets(line, sizeof(line), file)) {
+        if (std::strncmp(line, "VmRSS:", 6) == 0) {
+            rss = std::strtol(line + 6, nullptr, 10);
+            break;
+        }
+    }
+    std::fclose(file);
+    return rss;
+}
+
+template <typename Handler>
+void Run(const char* name, size_t requests, size_t threads, const std::vector<Row>& rows, Handler handler) {
+    std::atomic<size_t> sink{0};
+    size_t allocations = g_allocations.load();
+    auto arena_stats = RequestArena::GetStats();
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            RequestArenaSlot slot;
+            size_t bytes = 0;
+            for (size_t i = 0; i < requests; ++i) {
+                bytes += handler(slot, rows);
+            }
+            sink += bytes;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double total = static_cast<double>(requests * threads);
+    auto arena_after = RequestArena::GetStats();
+    std::printf("%-6s %10.1f %16.2f %16.2f %12.1f\n", name, elapsed * 1e9 / total,
+                (g_allocations.load() - allocations) / total,
+                (arena_after.allocations - arena_stats.allocations) / total, ReadRssKb() / 1024.0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t requests = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    size_t threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+    size_t message_count = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 50;
+    auto rows = MakeRows(message_count);
+
+    std::printf("requests/thread=%zu threads=%zu messages=%zu\n", requests, threads, message_count);
+    std::printf("%-6s %10s %16s %16s %12s\n", "case", "ns/req", "heap_allocs/req", "arena_allocs/req", "rss(MB)");
+    std::fflush(stdout);
+
+    const struct {
+        const char* name;
+        size_t (*handler)(RequestArenaSlot&, const std::vector<Row>&);
+    } cases[] = {
+        {"heap", [](RequestArenaSlot&, const std::vector<Row>& rows) { return HeapRequest(rows); }},
+        {"arena", ArenaRequest},
+    };
+
+    // 每个用例一个子进程，RSS互不影响
+    for (const auto& test_case : cases) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            Run(test_case.name, requests, threads, rows, test_case.handler);
+            std::fflush(stdout);
+            std::_Exit(0);
+        }
+        waitpid(pid, nullptr, 0);
+    }
+
+    return 0;
+}
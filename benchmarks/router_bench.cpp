@@ -0,0 +1,154 @@
+// 路由匹配开销：旧的逐条std::regex扫描 vs 压缩基数树
+//
+// 用法: router_bench [iterations]
+// 路由表与ApiRouter::SetupRoutes一致，重点测量参数最多的
+// /api/v1/dialogs/{dialog_id}/messages/{message_id}/reply。
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/http/route_tree.h"
+
+namespace {
+
+using ai_backend::core::http::RouteTree;
+
+struct RouteSpec {
+    const char* method;
+    const char* path;
+};
+
+// 与ApiRouter::SetupRoutes保持一致
+const RouteSpec kRoutes[] = {
+    {"POST", "/api/v1/auth/register"},
+    {"POST", "/api/v1/auth/login"},
+    {"POST", "/api/v1/auth/refresh"},
+    {"GET", "/api/v1/dialogs"},
+    {"POST", "/api/v1/dialogs"},
+    {"GET", "/api/v1/dialogs/{id}"},
+    {"PUT", "/api/v1/dialogs/{id}"},
+    {"DELETE", "/api/v1/dialogs/{id}"},
+    {"GET", "/api/v1/dialogs/{dialog_id}/messages"},
+    {"POST", "/api/v1/dialogs/{dialog_id}/messages"},
+    {"GET", "/api/v1/dialogs/{dialog_id}/messages/{message_id}/reply"},
+    {"DELETE", "/api/v1/dialogs/{dialog_id}/messages/{message_id}"},
+    {"POST", "/api/v1/files"},
+    {"GET", "/api/v1/files/{id}"},
+    {"DELETE", "/api/v1/files/{id}"},
+    {"GET", "/api/v1/models"},
+    {"GET", "/api/v1/models/{id}"},
+};
+
+// 旧实现：精确匹配失败后按添加顺序逐条regex_match，
+// 命中后每次请求重新构造参数名正则提取参数
+class LegacyRegexRouter {
+public:
+    void AddRoute(const std::string& path, const std::string& method) {
+        routes_[method + ":" + path] = true;
+
+        if (path.find('{') != std::string::npos) {
+            std::regex param_regex(R"(\{([^{}]+)\})");
+            std::string regex_str = std::regex_replace(path, param_regex, "([^/]+)");
+            path_params_regexes_.emplace_back(std::regex(regex_str), path);
+        }
+    }
+
+    bool Route(const std::string& method, const std::string& path,
+               std::unordered_map<std::string, std::string>& path_params) const {
+        if (routes_.count(method + ":" + path)) {
+            return true;
+        }
+
+        for (const auto& [regex, route_template] : path_params_regexes_) {
+            std::smatch matches;
+            if (!std::regex_match(path, matches, regex)) {
+                continue;
+            }
+            if (!routes_.count(method + ":" + route_template)) {
+                continue;
+            }
+
+            std::smatch param_matches;
+            std::regex param_regex(R"(\{([^{}]+)\})");
+            std::string::const_iterator search_start = route_template.cbegin();
+            size_t param_index = 1;
+            while (std::regex_search(search_start, route_template.cend(), param_matches, param_regex)) {
+                if (param_index < matches.size()) {
+                    path_params[param_matches[1].str()] = matches[param_index].str();
+                }
+                search_start = param_matches.suffix().first;
+                param_index++;
+            }
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    std::unordered_map<std::string, bool> routes_;
+    std::vector<std::pair<std::regex, std::string>> path_params_regexes_;
+};
+
+template<typename Fn>
+double NanosPerCall(size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    LegacyRegexRouter legacy;
+    RouteTree tree;
+    size_t route_id = 0;
+    for (const auto& route : kRoutes) {
+        legacy.AddRoute(route.path, route.method);
+        tree.Insert(route.method, route.path, route_id++);
+    }
+
+    const struct {
+        const char* name;
+        const char* method;
+        const char* path;
+    } cases[] = {
+        {"reply", "GET", "/api/v1/dialogs/3f2b9c1e-8d7a-4e6b-9f10-2c4d5e6f7a8b/messages/7a1c2d3e-4f5a-6b7c-8d9e-0f1a2b3c4d5e/reply"},
+        {"messages", "POST", "/api/v1/dialogs/3f2b9c1e-8d7a-4e6b-9f10-2c4d5e6f7a8b/messages"},
+        {"static", "GET", "/api/v1/models"},
+        {"miss", "GET", "/api/v1/unknown/path"},
+    };
+
+    volatile size_t sink = 0;
+
+    std::printf("iterations=%zu routes=%zu\n", iterations, route_id);
+    std::printf("%-10s %14s %14s %9s\n", "case", "regex(ns)", "tree(ns)", "speedup");
+
+    for (const auto& c : cases) {
+        std::string method = c.method;
+        std::string path = c.path;
+
+        double regex_ns = NanosPerCall(iterations / 10, [&]() {
+            std::unordered_map<std::string, std::string> path_params;
+            sink = sink + legacy.Route(method, path, path_params) + path_params.size();
+        });
+
+        double tree_ns = NanosPerCall(iterations, [&]() {
+            auto result = tree.Match(method, path);
+            sink = sink + static_cast<size_t>(result.status) + result.param_count;
+        });
+
+        std::printf("%-10s %14.1f %14.1f %8.1fx\n", c.name, regex_ns, tree_ns, regex_ns / tree_ns);
+    }
+
+    return 0;
+}
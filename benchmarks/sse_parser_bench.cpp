@@ -0,0 +1,152 @@
+// SSE流解析吞吐：旧的按行切分+substr vs 增量SseParser
+//
+// 用法: sse_parser_bench [capture_file...]
+// capture_file是录制的上游原始响应体 (如 curl -N 的输出)，
+// 未指定时生成一段与DeepSeek chat/completions流式响应格式一致的数据。
+// 输入按1~1460字节的随机长度切块，模拟TCP读取的任意边界。
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "services/ai/streaming/sse_parser.h"
+
+namespace {
+
+using ai_backend::services::ai::streaming::SseEvent;
+using ai_backend::services::ai::streaming::SseParser;
+
+struct Capture {
+    std::string name;
+    std::string body;
+};
+
+std::string GenerateDeepseekCapture(size_t events) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> word_length(1, 12);
+    std::string body;
+    for (size_t i = 0; i < events; ++i) {
+        std::string delta(word_length(rng), 'x');
+        body += "data: {\"id\":\"a1b2c3d4-e5f6-7890-abcd-ef0123456789\",\"object\":\"chat.completion.chunk\","
+                "\"created\":1718345013,\"model\":\"deepseek-chat\",\"system_fingerprint\":\"fp_a49d71b8a1\","
+                "\"choices\":[{\"index\":0,\"delta\":{\"content\":\"" + delta + "\"},"
+                "\"logprobs\":null,\"finish_reason\":null}]}\r\n\r\n";
+        if (i % 200 == 199) {
+            body += ": keep-alive\r\n\r\n";
+        }
+    }
+    body += "data: [DONE]\r\n\r\n";
+    return body;
+}
+
+std::vector<std::string_view> Slice(const std::string& body) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<size_t> slice_length(1, 1460);
+    std::vector<std::string_view> slices;
+    for (size_t offset = 0; offset < body.size();) {
+        size_t length = std::min(slice_length(rng), body.size() - offset);
+        slices.emplace_back(body.data() + offset, length);
+        offset += length;
+    }
+    return slices;
+}
+
+// 旧实现：累积到pending，按'\n'切行并erase，"data: "行再substr出负载
+size_t LegacyParse(const std::vector<std::string_view>& slices, size_t& payload_bytes) {
+    size_t events = 0;
+    std::string pending;
+    for (auto slice : slices) {
+        pending.append(slice);
+        size_t line_end;
+        while ((line_end = pending.find('\n')) != std::string::npos) {
+            std::string line = pending.substr(0, line_end);
+            pending.erase(0, line_end + 1);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (!line.empty() && line.find("data: ") == 0) {
+                std::string payload = line.substr(6);
+                payload_bytes += payload.size();
+                events++;
+            }
+        }
+    }
+    return events;
+}
+
+size_t IncrementalParse(const std::vector<std::string_view>& slices, size_t& payload_bytes) {
+    size_t events = 0;
+    SseParser parser;
+    SseEvent event;
+    for (auto slice : slices) {
+        parser.Feed(slice);
+        while (parser.Next(event)) {
+            payload_bytes += event.data.size();
+            events++;
+        }
+    }
+    return events;
+}
+
+template<typename Fn>
+double MegabytesPerSecond(size_t bytes, size_t rounds, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < rounds; ++i) {
+        fn();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(bytes) * rounds / seconds / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<Capture> captures;
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "cannot open %s\n", argv[i]);
+            return 1;
+        }
+        std::ostringstream content;
+        content << file.rdbuf();
+        captures.push_back({argv[i], content.str()});
+    }
+    if (captures.empty()) {
+        captures.push_back({"deepseek-synthetic", GenerateDeepseekCapture(20000)});
+    }
+
+    std::printf("%-24s %10s %8s %14s %14s %9s\n", "capture", "bytes", "events", "legacy(MB/s)", "parser(MB/s)", "speedup");
+
+    for (const auto& capture : captures) {
+        auto slices = Slice(capture.body);
+        size_t rounds = std::max<size_t>(1, (64u << 20) / std::max<size_t>(capture.body.size(), 1));
+
+        size_t legacy_bytes = 0;
+        size_t parser_bytes = 0;
+        size_t events = IncrementalParse(slices, parser_bytes);
+        if (LegacyParse(slices, legacy_bytes) != events || legacy_bytes != parser_bytes) {
+            std::fprintf(stderr, "%s: parsers disagree (multi-line data or bare CR in capture?)\n", capture.name.c_str());
+        }
+
+        volatile size_t sink = 0;
+        double legacy = MegabytesPerSecond(capture.body.size(), rounds, [&]() {
+            size_t bytes = 0;
+            sink = sink + LegacyParse(slices, bytes) + bytes;
+        });
+        double incremental = MegabytesPerSecond(capture.body.size(), rounds, [&]() {
+            size_t bytes = 0;
+            sink = sink + IncrementalParse(slices, bytes) + bytes;
+        });
+
+        std::printf("%-24s %10zu %8zu %14.1f %14.1f %8.1fx\n", capture.name.c_str(), capture.body.size(),
+                    events, legacy, incremental, incremental / legacy);
+    }
+
+    return 0;
+}
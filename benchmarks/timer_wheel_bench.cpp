@@ -0,0 +1,109 @@
+// 时间轮与asio定时器在大量定时器下的开销
+//
+// 用法: timer_wheel_bench [timers]
+// wheel:  启动、刷新 (空闲超时的用法)、取消各timers个定时器，以及推进时间让它们全部到期
+// asio:   同样数量的steady_timer，每个async_wait一次再取消 (改动前ScheduleAfter和会话超时的做法)
+// 延迟在1秒到5分钟之间均匀分布，模拟大量空闲的keep-alive和WebSocket连接
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "core/async/timer_wheel.h"
+
+namespace {
+
+using ai_backend::core::async::TimerWheel;
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Report(const char* name, size_t ops, double elapsed) {
+    std::printf("%-16s %12.1f %14.2f\n", name, elapsed * 1e9 / ops, ops / elapsed / 1e6);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int64_t> delay_ms(1000, 300000);
+    std::vector<std::chrono::milliseconds> delays(count);
+    for (auto& delay : delays) {
+        delay = std::chrono::milliseconds(delay_ms(rng));
+    }
+
+    std::printf("timers=%zu\n", count);
+    std::printf("%-16s %12s %14s\n", "case", "ns/op", "Mops/s");
+
+    {
+        auto origin = TimerWheel::Clock::now();
+        TimerWheel wheel(origin);
+        size_t fired = 0;
+        std::vector<TimerWheel::Timer> timers(count);
+        for (auto& timer : timers) {
+            timer.SetCallback([&fired]() { ++fired; });
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            wheel.ScheduleAt(timers[i], origin + delays[i]);
+        }
+        Report("wheel schedule", count, Seconds(start));
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            wheel.ScheduleAt(timers[i], origin + delays[count - 1 - i]);
+        }
+        Report("wheel refresh", count, Seconds(start));
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; i += 2) {
+            wheel.Cancel(timers[i]);
+        }
+        Report("wheel cancel", (count + 1) / 2, Seconds(start));
+
+        // 剩下的一半按时间推进全部到期，包含所有级联的开销
+        start = std::chrono::steady_clock::now();
+        wheel.Advance(origin + std::chrono::minutes(6));
+        Report("wheel expire", fired, Seconds(start));
+    }
+
+    {
+        boost::asio::io_context io_context;
+        std::vector<std::unique_ptr<boost::asio::steady_timer>> timers;
+        timers.reserve(count);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            timers.push_back(std::make_unique<boost::asio::steady_timer>(io_context, delays[i]));
+            timers.back()->async_wait([](const boost::system::error_code&) {});
+        }
+        Report("asio schedule", count, Seconds(start));
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            timers[i]->expires_after(delays[count - 1 - i]);
+            timers[i]->async_wait([](const boost::system::error_code&) {});
+        }
+        io_context.poll();
+        Report("asio refresh", count, Seconds(start));
+
+        start = std::chrono::steady_clock::now();
+        for (auto& timer : timers) {
+            timer->cancel();
+        }
+        io_context.poll();
+        Report("asio cancel", count, Seconds(start));
+    }
+
+    return 0;
+}
@@ -2,9 +2,12 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "core/http/request.h"
 #include "core/http/response.h"
+#include "core/http/stream_pump.h"
+#include "core/async/deadline.h"
 #include "core/async/task.h"
 #include "services/message/message_service.h"
 #include "services/dialog/dialog_service.h"
@@ -35,16 +38,35 @@ public:
 
 private:
     // 验证对话访问权限
-    common::Result<std::string> ValidateDialogAccess(
+    core::async::Task<common::Result<std::string>> ValidateDialogAccess(
         const core::http::Request& request, 
         const std::string& dialog_id
     );
     
+    // 构建发给模型的上下文：系统消息、最近的历史消息和当前用户消息
+    core::async::Task<std::vector<models::Message>> BuildMessageContext(
+        const std::string& dialog_id,
+        const std::string& message_id,
+        core::async::Deadline deadline
+    );
+    
+    // 模型参数
+    services::ai::ModelInterface::ModelConfig BuildModelConfig();
+    
+    // 生成流式回复，token经pump写出；生成结束 (包括抛出异常) 时结束pump
+    core::async::Task<common::Result<services::ai::TokenUsage>> GenerateStreamingReply(
+        const std::string& model_id,
+        const std::vector<models::Message>& context,
+        const services::ai::ModelInterface::ModelConfig& config,
+        std::pmr::string& generated_content,
+        core::http::StreamPump& pump
+    );
+    
     // 处理流式回复
     void HandleStreamingResponse(
         const std::string& content,
         bool is_done,
-        core::http::StreamWriter& writer
+        core::http::StreamPump& pump
     );
 
 private:
@@ -16,6 +16,7 @@ public:
     
     core::async::Task<core::http::Response> GetModels(const core::http::Request& request);
     core::async::Task<core::http::Response> GetModelById(const core::http::Request& request);
+    core::async::Task<core::http::Response> GetUpstreamStats(const core::http::Request& /*request*/);
 
 private:
     services::ai::ModelService& model_service_;
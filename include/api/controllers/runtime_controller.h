@@ -0,0 +1,28 @@
+#pragma once
+
+#include "core/http/request.h"
+#include "core/http/response.h"
+#include "core/async/task.h"
+
+namespace ai_backend::api::controllers {
+
+// 运行时诊断接口
+class RuntimeController {
+public:
+    RuntimeController() = default;
+    
+    // 各IO线程的事件循环延迟、处理函数耗时直方图和慢处理函数排行
+    core::async::Task<core::http::Response> GetLoopStats(const core::http::Request& request);
+    
+    // 各路由类别的并发、排队时间直方图和拒绝计数，以及事件循环队列的状态
+    core::async::Task<core::http::Response> GetAdmissionStats(const core::http::Request& request);
+    
+    // 各子系统的在用内存、峰值和分配速率，以及内存池、请求arena和协程帧分配的统计
+    core::async::Task<core::http::Response> GetMemoryStats(const core::http::Request& request);
+    
+    // 采样的在用分配，gperftools heap profile文本格式，可交给pprof分析；
+    // 查询参数tag只导出一个子系统；路由只接受本机直接发起的请求
+    core::async::Task<core::http::Response> GetHeapProfile(const core::http::Request& request);
+};
+
+} // namespace ai_backend::api::controllers
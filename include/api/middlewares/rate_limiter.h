@@ -2,14 +2,18 @@
 
 #include <atomic>
 #include <chrono>
+#include <memory_resource>
 #include <mutex>
 #include <string>
-#include <thread>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include "core/http/request.h"
+#include "core/async/async_mutex.h"
 #include "core/async/task.h"
+#include "core/async/timer_wheel.h"
+#include "core/memory/memory_tracker.h"
 
 namespace ai_backend::api::middlewares {
 
@@ -21,22 +25,38 @@ public:
     core::async::Task<bool> Process(core::http::Request& request);
 
 private:
+    // 请求历史从ratelimit标签的内存分配，按字符串视图查找，不为每次查找构造键
+    struct HistoryKeyHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view key) const noexcept {
+            return std::hash<std::string_view>()(key);
+        }
+    };
+    using History = std::pmr::vector<std::chrono::steady_clock::time_point>;
+    using HistoryMap = std::pmr::unordered_map<std::pmr::string, History, HistoryKeyHash, std::equal_to<>>;
+    
+    // 取出键对应的历史，不存在时插入
+    static History& GetHistory(HistoryMap& map, const std::string& key);
+    
     core::async::Task<bool> CheckRateLimit(const std::string& client_id, const std::string& client_ip, int limit_multiplier);
     void InitCleanupTask();
+    void CleanupHistory();
     bool IsWhitelisted(const std::string& ip);
-    int CalculateRetryAfter(const std::string& client_id);
+    core::async::Task<int> CalculateRetryAfter(const std::string& client_id);
 
 private:
-    std::unordered_map<std::string, std::vector<std::chrono::steady_clock::time_point>> request_history_;
-    std::unordered_map<std::string, std::vector<std::chrono::steady_clock::time_point>> ip_request_history_;
-    std::mutex mutex_;
-    std::atomic<bool> shutdown_{false};
-    std::thread cleanup_thread_;
+    HistoryMap request_history_;
+    HistoryMap ip_request_history_;
+    // 请求历史在I/O线程的协程中访问，争用时挂起协程而不是阻塞线程；
+    // 等待者回到各自会话的strand上恢复，不绑定全局执行器
+    core::async::AsyncMutex mutex_;
     int max_requests_per_minute_;
     int max_requests_per_hour_;
     int max_requests_per_day_;
     int ip_max_requests_per_minute_;
     bool enabled_;
+    // 定期清理过期的请求历史，挂在EventLoop的时间轮上；最后声明，析构时最先取消
+    core::async::TimerWheel::Timer cleanup_timer_;
 };
 
 } // namespace ai_backend::api::middlewares
\ No newline at end of file
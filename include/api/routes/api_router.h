@@ -1,11 +1,14 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "core/async/frame_allocator.h"
 #include "core/http/router.h"
+#include "core/http/route_tree.h"
 #include "core/http/request.h"
 #include "core/http/response.h"
 #include "api/controllers/auth_controller.h"
@@ -13,6 +16,7 @@
 #include "api/controllers/message_controller.h"
 #include "api/controllers/file_controller.h"
 #include "api/controllers/model_controller.h"
+#include "api/controllers/runtime_controller.h"
 #include "api/middlewares/auth_middleware.h"
 #include "api/middlewares/cors_middleware.h"
 #include "api/middlewares/rate_limiter.h"
@@ -29,9 +33,14 @@ public:
     void Initialize() override;
     
     // 路由请求
-    core::async::Task<core::http::Response> Route(const core::http::Request& request) override;
+    core::async::Task<core::http::Response> Route(core::http::Request& request) override;
 
 private:
+    // 执行中间件并分发到处理器
+    // 分发和中间件的协程帧从Route帧内的arena分配，它们都在Route返回前结束
+    core::async::Task<core::http::Response> Dispatch(std::allocator_arg_t, core::async::FrameArena& arena,
+                                                     core::http::Request& request);
+    
     // 设置中间件
     void SetupMiddlewares();
     
@@ -41,25 +50,45 @@ private:
     // 创建控制器
     void CreateControllers();
     
-    // 添加路由
+    // 添加路由，timeout为0时使用默认处理时限
     void AddRoute(const std::string& path, 
                  const std::string& method, 
                  std::function<core::async::Task<core::http::Response>(const core::http::Request&)> handler,
-                 bool require_auth = true);
+                 bool require_auth = true,
+                 std::chrono::milliseconds timeout = std::chrono::milliseconds::zero());
+    
+    // 添加诊断路由，需要登录，且只接受本机直接发起的请求，其他来源返回403
+    void AddLocalRoute(const std::string& path, 
+                       const std::string& method, 
+                       std::function<core::async::Task<core::http::Response>(const core::http::Request&)> handler);
 
 private:
-    // 中间件集合
-    std::vector<std::function<core::async::Task<bool>(core::http::Request&)>> middlewares_;
+    // 中间件集合，协程帧从请求的帧arena分配
+    using Middleware = std::function<core::async::Task<bool>(std::allocator_arg_t, core::async::FrameArena&,
+                                                             core::http::Request&)>;
+    std::vector<Middleware> middlewares_;
     
-    // 路由表，key为"方法:路径"
+    // Route帧内为分发链预留的帧缓冲区，足够容纳分发和一个中间件的帧，超出时arena再分配新块
+    static constexpr size_t kFrameBufferSize = 1024;
+    
+    // 路由处理器，下标即路由树中的路由ID
     struct RouteEntry {
         std::function<core::async::Task<core::http::Response>(const core::http::Request&)> handler;
         bool require_auth;
+        
+        // 只接受本机直接发起的请求
+        bool local_only;
+        
+        // 处理时限，收紧请求的截止时间
+        std::chrono::milliseconds timeout;
     };
-    std::unordered_map<std::string, RouteEntry> routes_;
+    std::vector<RouteEntry> routes_;
+    
+    // 默认处理时限
+    std::chrono::milliseconds default_timeout_;
     
-    // 路径参数正则表达式
-    std::vector<std::pair<std::regex, std::string>> path_params_regexes_;
+    // 路由树，启动时构建
+    core::http::RouteTree route_tree_;
     
     // 控制器
     std::shared_ptr<controllers::AuthController> auth_controller_;
@@ -67,6 +96,7 @@ private:
     std::shared_ptr<controllers::MessageController> message_controller_;
     std::shared_ptr<controllers::FileController> file_controller_;
     std::shared_ptr<controllers::ModelController> model_controller_;
+    std::shared_ptr<controllers::RuntimeController> runtime_controller_;
     
     // 中间件
     std::shared_ptr<middlewares::AuthMiddleware> auth_middleware_;
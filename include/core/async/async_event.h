@@ -0,0 +1,57 @@
+#pragma once
+
+#include <coroutine>
+#include <memory>
+#include <mutex>
+
+#include <boost/asio/any_io_executor.hpp>
+
+#include "core/async/deadline.h"
+#include "core/async/wait_queue.h"
+
+namespace ai_backend::core::async {
+
+// 手动重置的协程事件
+// Set之后所有等待者和之后的Wait都立即继续，直到Reset。用于启动完成、关闭通知等一次性信号。
+class AsyncEvent {
+public:
+    class WaitAwaiter {
+    public:
+        WaitAwaiter(AsyncEvent& event, Deadline deadline)
+            : event_(event), deadline_(std::move(deadline)) {}
+
+        bool await_ready() const { return event_.IsSet(); }
+        bool await_suspend(std::coroutine_handle<> handle);
+        // 截止时间先于Set到达时抛出DeadlineExceeded
+        void await_resume() const;
+
+    private:
+        AsyncEvent& event_;
+        Deadline deadline_;
+        std::shared_ptr<detail::Waiter> waiter_;
+    };
+
+    explicit AsyncEvent(boost::asio::any_io_executor executor = {}, bool initially_set = false);
+    ~AsyncEvent();
+
+    AsyncEvent(const AsyncEvent&) = delete;
+    AsyncEvent& operator=(const AsyncEvent&) = delete;
+
+    // 等待事件被Set
+    [[nodiscard]] WaitAwaiter Wait(Deadline deadline = {}) { return WaitAwaiter(*this, std::move(deadline)); }
+
+    // 设置事件并恢复所有等待者
+    void Set();
+
+    void Reset();
+
+    bool IsSet() const;
+
+private:
+    mutable std::mutex mutex_;
+    bool set_;
+    detail::WaitQueue waiters_;
+    boost::asio::any_io_executor executor_;
+};
+
+} // namespace ai_backend::core::async
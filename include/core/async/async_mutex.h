@@ -0,0 +1,83 @@
+#pragma once
+
+#include <utility>
+
+#include <boost/asio/any_io_executor.hpp>
+
+#include "core/async/async_semaphore.h"
+#include "core/async/deadline.h"
+
+namespace ai_backend::core::async {
+
+// 协程互斥锁
+// 锁被占用时挂起协程而不是阻塞I/O线程，Unlock把锁直接交给最早的等待者。
+// 不可重入，持有锁的协程可以在临界区内co_await，其他协程不会因此阻塞线程。
+class AsyncMutex {
+public:
+    // 作用域锁，析构时解锁
+    class [[nodiscard]] Guard {
+    public:
+        Guard() = default;
+        explicit Guard(AsyncMutex& mutex) : mutex_(&mutex) {}
+        ~Guard() { Unlock(); }
+
+        Guard(Guard&& other) noexcept : mutex_(std::exchange(other.mutex_, nullptr)) {}
+        Guard& operator=(Guard&& other) noexcept {
+            if (this != &other) {
+                Unlock();
+                mutex_ = std::exchange(other.mutex_, nullptr);
+            }
+            return *this;
+        }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        // 提前解锁
+        void Unlock() {
+            if (auto* mutex = std::exchange(mutex_, nullptr)) {
+                mutex->Unlock();
+            }
+        }
+
+        bool OwnsLock() const { return mutex_ != nullptr; }
+
+    private:
+        AsyncMutex* mutex_ = nullptr;
+    };
+
+    class ScopedLockAwaiter : public AsyncSemaphore::AcquireAwaiter {
+    public:
+        ScopedLockAwaiter(AsyncMutex& mutex, Deadline deadline)
+            : AsyncSemaphore::AcquireAwaiter(mutex.semaphore_, std::move(deadline)), mutex_(mutex) {}
+
+        Guard await_resume() const {
+            AsyncSemaphore::AcquireAwaiter::await_resume();
+            return Guard(mutex_);
+        }
+
+    private:
+        AsyncMutex& mutex_;
+    };
+
+    explicit AsyncMutex(boost::asio::any_io_executor executor = {}) : semaphore_(1, std::move(executor)) {}
+
+    AsyncMutex(const AsyncMutex&) = delete;
+    AsyncMutex& operator=(const AsyncMutex&) = delete;
+
+    // 加锁，之后必须调用Unlock；截止时间先到时抛出DeadlineExceeded
+    [[nodiscard]] AsyncSemaphore::AcquireAwaiter Lock(Deadline deadline = {}) { return semaphore_.Acquire(std::move(deadline)); }
+
+    // 加锁并返回作用域锁: auto lock = co_await mutex.ScopedLock();
+    [[nodiscard]] ScopedLockAwaiter ScopedLock(Deadline deadline = {}) { return ScopedLockAwaiter(*this, std::move(deadline)); }
+
+    bool TryLock() { return semaphore_.TryAcquire(); }
+
+    void Unlock() { semaphore_.Release(); }
+
+    bool IsLocked() const { return semaphore_.GetAvailable() == 0; }
+
+private:
+    AsyncSemaphore semaphore_;
+};
+
+} // namespace ai_backend::core::async
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+#include <boost/asio/any_io_executor.hpp>
+
+#include "core/async/deadline.h"
+#include "core/async/task.h"
+
+namespace ai_backend::core::async {
+
+// 结构化并发作用域 (nursery)
+// 通过Spawn在executor上启动数量不定的子任务，Join等待全部结束并重新抛出第一个异常。
+// 任一子任务抛出异常时取消作用域的截止时间，子任务应通过GetDeadline()观察取消并尽快返回。
+// 作用域的截止时间由parent派生，父截止时间 (例如请求的截止时间) 到期时一并到期。
+// 析构前必须Join，否则子任务可能引用已经失效的数据。
+class AsyncScope {
+public:
+    explicit AsyncScope(boost::asio::any_io_executor executor, const Deadline& parent = {});
+    ~AsyncScope();
+
+    AsyncScope(const AsyncScope&) = delete;
+    AsyncScope& operator=(const AsyncScope&) = delete;
+
+    // 启动子任务，结果被丢弃
+    template <typename T>
+    void Spawn(Task<T> task) {
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->active++;
+        }
+        async::Spawn(executor_, Run(state_, std::move(task)));
+    }
+
+    // 等待所有已启动的子任务结束，有子任务失败时重新抛出第一个异常
+    // Join返回后可以继续启动子任务，但作用域被取消后不会恢复
+    Task<void> Join();
+
+    // 取消作用域内的所有子任务
+    void Cancel() const;
+
+    // 作用域的截止时间，传给子任务用于取消
+    const Deadline& GetDeadline() const { return state_->deadline; }
+
+    // 尚未结束的子任务数
+    size_t GetActiveCount() const;
+
+private:
+    struct State {
+        std::mutex mutex;
+        size_t active = 0;
+        std::coroutine_handle<> joiner;
+        boost::asio::any_io_executor joiner_executor;
+        std::exception_ptr first_exception;
+        Deadline deadline;
+    };
+
+    class JoinAwaiter;
+
+    template <typename T>
+    static Task<void> Run(std::shared_ptr<State> state, Task<T> task) {
+        std::exception_ptr exception;
+        try {
+            co_await task;
+        } catch (...) {
+            exception = std::current_exception();
+        }
+        OnChildDone(state, std::move(exception));
+    }
+
+    // 子任务结束时调用，最后一个子任务恢复Join的等待者
+    static void OnChildDone(const std::shared_ptr<State>& state, std::exception_ptr exception);
+
+    boost::asio::any_io_executor executor_;
+    std::shared_ptr<State> state_;
+};
+
+} // namespace ai_backend::core::async
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+#include <boost/asio/any_io_executor.hpp>
+
+#include "core/async/deadline.h"
+#include "core/async/wait_queue.h"
+
+namespace ai_backend::core::async {
+
+// 协程信号量
+// 没有许可时挂起协程而不是阻塞线程，等待者按先进先出获得许可。Release直接把许可交给最早的等待者，
+// 等待者投递回它挂起时所在的执行器恢复；协程不在执行器上运行时投递到构造时的executor，
+// 两者都为空时在调用Release的线程上直接恢复。
+// 内部的锁只保护计数和队列，不会在持有时挂起或恢复协程。
+class AsyncSemaphore {
+public:
+    class AcquireAwaiter {
+    public:
+        AcquireAwaiter(AsyncSemaphore& semaphore, Deadline deadline)
+            : semaphore_(semaphore), deadline_(std::move(deadline)) {}
+
+        bool await_ready() { return semaphore_.TryAcquire(); }
+        bool await_suspend(std::coroutine_handle<> handle);
+        // 截止时间先于许可到达时抛出DeadlineExceeded
+        void await_resume() const;
+
+    private:
+        AsyncSemaphore& semaphore_;
+        Deadline deadline_;
+        std::shared_ptr<detail::Waiter> waiter_;
+    };
+
+    explicit AsyncSemaphore(size_t initial, boost::asio::any_io_executor executor = {});
+    ~AsyncSemaphore();
+
+    AsyncSemaphore(const AsyncSemaphore&) = delete;
+    AsyncSemaphore& operator=(const AsyncSemaphore&) = delete;
+
+    // 获取一个许可，没有时挂起直到Release或截止时间到期
+    [[nodiscard]] AcquireAwaiter Acquire(Deadline deadline = {}) { return AcquireAwaiter(*this, std::move(deadline)); }
+
+    // 不等待地获取许可
+    bool TryAcquire();
+
+    // 归还许可，有等待者时依次交给它们
+    void Release(size_t count = 1);
+
+    // 当前可用的许可数
+    size_t GetAvailable() const;
+
+    // 正在等待的协程数
+    size_t GetWaiterCount() const;
+
+private:
+    mutable std::mutex mutex_;
+    size_t available_;
+    detail::WaitQueue waiters_;
+    boost::asio::any_io_executor executor_;
+};
+
+} // namespace ai_backend::core::async
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include <boost/asio/any_io_executor.hpp>
+
+#include "core/async/deadline.h"
+#include "core/async/task.h"
+#include "core/async/wait_queue.h"
+
+namespace ai_backend::core::async {
+
+// 有界多生产者多消费者通道
+// 缓冲区满时Send挂起发送方，空时Receive挂起接收方，都不阻塞线程；被唤醒的协程重新检查条件，
+// 被抢先时重新排队。Close之后Send返回false，Receive取完剩余元素后返回std::nullopt。
+template <typename T>
+class Channel {
+public:
+    explicit Channel(size_t capacity, boost::asio::any_io_executor executor = {})
+        : capacity_(capacity), executor_(std::move(executor)) {
+        if (capacity_ == 0) {
+            throw std::invalid_argument("Channel capacity must be positive");
+        }
+    }
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    // 发送，缓冲区满时等待空位；通道已关闭时返回false，截止时间先到时抛出DeadlineExceeded
+    Task<bool> Send(T value, Deadline deadline = {}) {
+        while (true) {
+            if (auto pushed = TryPush(value)) {
+                co_return *pushed;
+            }
+            co_await WaitAwaiter(*this, senders_, &Channel::CanSend, deadline);
+        }
+    }
+
+    // 接收，缓冲区空时等待；通道已关闭且取完时返回std::nullopt
+    Task<std::optional<T>> Receive(Deadline deadline = {}) {
+        while (true) {
+            bool closed = false;
+            if (auto value = TryPop(closed); value || closed) {
+                co_return value;
+            }
+            co_await WaitAwaiter(*this, receivers_, &Channel::CanReceive, deadline);
+        }
+    }
+
+    // 不等待地发送，缓冲区满或已关闭时返回false
+    bool TrySend(T value) {
+        auto pushed = TryPush(value);
+        return pushed && *pushed;
+    }
+
+    // 不等待地接收，缓冲区空时返回std::nullopt
+    std::optional<T> TryReceive() {
+        bool closed = false;
+        return TryPop(closed);
+    }
+
+    // 关闭通道并唤醒所有等待者，已在缓冲区中的元素仍可接收
+    void Close() {
+        std::deque<std::shared_ptr<detail::Waiter>> resumed;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_) {
+                return;
+            }
+            closed_ = true;
+            resumed = senders_.PopAllWaiting();
+            auto receivers = receivers_.PopAllWaiting();
+            resumed.insert(resumed.end(), receivers.begin(), receivers.end());
+        }
+        for (auto& waiter : resumed) {
+            waiter->Resume();
+        }
+    }
+
+    bool IsClosed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+    // 缓冲区中的元素数
+    size_t Size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return buffer_.size();
+    }
+
+    size_t Capacity() const { return capacity_; }
+
+private:
+    // 挂起直到ready条件成立，条件在持有锁时检查，避免错过唤醒
+    class WaitAwaiter {
+    public:
+        WaitAwaiter(Channel& channel, detail::WaitQueue& queue, bool (Channel::*ready)() const, const Deadline& deadline)
+            : channel_(channel), queue_(queue), ready_(ready), deadline_(deadline) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            // 入队之后等待者可能随时被其他线程恢复，之后只能使用局部变量
+            auto waiter = std::make_shared<detail::Waiter>();
+            waiter->handle = handle;
+            waiter->executor = detail::Waiter::HomeExecutor(channel_.executor_);
+            waiter_ = waiter;
+            auto deadline = deadline_;
+
+            {
+                std::lock_guard<std::mutex> lock(channel_.mutex_);
+                if ((channel_.*ready_)()) {
+                    waiter_.reset();
+                    return false;
+                }
+                queue_.Push(waiter);
+            }
+
+            detail::RegisterDeadline(waiter, deadline);
+            return true;
+        }
+
+        void await_resume() const {
+            if (waiter_ && waiter_->IsCancelled()) {
+                throw DeadlineExceeded("Deadline exceeded while waiting on channel");
+            }
+        }
+
+    private:
+        Channel& channel_;
+        detail::WaitQueue& queue_;
+        bool (Channel::*ready_)() const;
+        Deadline deadline_;
+        std::shared_ptr<detail::Waiter> waiter_;
+    };
+
+    bool CanSend() const { return closed_ || buffer_.size() < capacity_; }
+    bool CanReceive() const { return closed_ || !buffer_.empty(); }
+
+    // 缓冲区满时返回std::nullopt，否则返回是否发送成功
+    std::optional<bool> TryPush(T& value) {
+        std::shared_ptr<detail::Waiter> receiver;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_) {
+                return false;
+            }
+            if (buffer_.size() >= capacity_) {
+                return std::nullopt;
+            }
+            buffer_.push_back(std::move(value));
+            receiver = receivers_.PopWaiting();
+        }
+        if (receiver) {
+            receiver->Resume();
+        }
+        return true;
+    }
+
+    std::optional<T> TryPop(bool& closed) {
+        std::optional<T> value;
+        std::shared_ptr<detail::Waiter> sender;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (buffer_.empty()) {
+                closed = closed_;
+                return std::nullopt;
+            }
+            value.emplace(std::move(buffer_.front()));
+            buffer_.pop_front();
+            sender = senders_.PopWaiting();
+        }
+        if (sender) {
+            sender->Resume();
+        }
+        return value;
+    }
+
+    const size_t capacity_;
+    boost::asio::any_io_executor executor_;
+
+    mutable std::mutex mutex_;
+    std::deque<T> buffer_;
+    bool closed_ = false;
+    detail::WaitQueue senders_;
+    detail::WaitQueue receivers_;
+};
+
+} // namespace ai_backend::core::async
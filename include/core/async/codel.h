@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace ai_backend::core::async {
+
+// CoDel (Controlled Delay) 式的排队过载检测
+// 不看队列长度而看排队时间：一个观察窗口内的最小排队时间仍超过目标，说明队列是持续存在的积压
+// 而不是突发，窗口结束时进入过载状态；过载时排队超过2倍目标的任务应被丢弃，等待上限也缩短到
+// 2倍目标，让队列尽快回到目标以内。任意线程可并发调用，只有几次原子操作。
+class CoDel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    CoDel(std::chrono::milliseconds target, std::chrono::milliseconds interval);
+
+    // 记录一个出队任务的排队时间，返回是否应丢弃该任务
+    bool OnDequeue(std::chrono::nanoseconds sojourn, Clock::time_point now = Clock::now());
+
+    // 上一个窗口是否处于过载状态
+    bool IsOverloaded() const { return overloaded_.load(std::memory_order_relaxed); }
+
+    // 排队等待的上限：过载时为2倍目标，否则为normal
+    std::chrono::milliseconds GetQueueTimeout(std::chrono::milliseconds normal) const;
+
+    std::chrono::milliseconds GetTarget() const { return target_; }
+    std::chrono::milliseconds GetInterval() const { return interval_; }
+
+private:
+    static constexpr int64_t kNoSample = INT64_MAX;
+
+    const std::chrono::milliseconds target_;
+    const std::chrono::milliseconds interval_;
+
+    // 当前窗口的结束时刻 (steady_clock纳秒) 和窗口内的最小排队时间
+    std::atomic<int64_t> interval_end_{0};
+    std::atomic<int64_t> min_sojourn_{kNoSample};
+    std::atomic<bool> overloaded_{false};
+    // 窗口切换由一个线程完成
+    std::atomic<bool> rolling_{false};
+};
+
+} // namespace ai_backend::core::async
@@ -1,95 +1,212 @@
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
 #include <deque>
+#include <exception>
 #include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
-#include <stdexcept>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
-#include <coroutine>
-#include "task.h"
+
+#include "core/async/work_stealing_deque.h"
 
 namespace ai_backend::core::async {
 
-class TaskWrapper {
-public:
-    virtual ~TaskWrapper() = default;
-    virtual void execute() = 0;
+namespace detail {
+
+// 池中的任务节点：入口函数指针加上紧跟其后的可调用对象，没有虚函数表，
+// 函数任务只需一次分配，协程恢复任务直接嵌在等待器中，不需要分配
+struct PoolJob {
+    void (*run)(PoolJob* job);
 };
 
 template <typename Func>
-class ConcreteTask : public TaskWrapper {
+struct FunctionJob : PoolJob {
+    explicit FunctionJob(Func&& func) : PoolJob{&FunctionJob::Invoke}, func(std::move(func)) {}
+
+    static void Invoke(PoolJob* job) {
+        std::unique_ptr<FunctionJob> self(static_cast<FunctionJob*>(job));
+        self->func();
+    }
+
+    Func func;
+};
+
+// 事件计数器，用于工作线程休眠和唤醒
+// 等待方先PrepareWait登记，再检查是否有任务，确实没有才Wait；
+// 通知方在发布任务之后检查登记数，只有存在等待者时才进行系统调用。
+// 休眠基于std::atomic::wait，在Linux上由futex实现。
+class EventCount {
 public:
-    explicit ConcreteTask(Func&& func) : func_(std::move(func)) {}
-    
-    void execute() override {
-        func_();
+    uint32_t PrepareWait() {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+    void CancelWait() {
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void Wait(uint32_t key) {
+        epoch_.wait(key, std::memory_order_acquire);
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
     }
-    
+
+    void NotifyOne() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) > 0) {
+            epoch_.fetch_add(1, std::memory_order_release);
+            epoch_.notify_one();
+        }
+    }
+
+    void NotifyAll() {
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        epoch_.notify_all();
+    }
+
 private:
-    Func func_;
+    alignas(64) std::atomic<uint32_t> epoch_{0};
+    alignas(64) std::atomic<uint32_t> waiters_{0};
 };
 
+} // namespace detail
+
+// 工作窃取线程池，用于CPU密集或阻塞的任务以及在池线程上恢复协程
+// 每个工作线程有一个Chase-Lev双端队列，池内线程提交的任务放入自己的队列 (LIFO执行)，
+// 外部线程提交的任务进入全局注入队列；线程空闲时依次检查本地队列、注入队列，
+// 再从其他线程的队列顶部窃取，仍然没有任务时通过事件计数器休眠。
 class CoroutinePool {
 public:
-    CoroutinePool(size_t max_coroutines, size_t thread_count = 0);
+    class ScheduleAwaiter;
+
+    // 工作线程启动时在该线程上调用，参数为线程下标，用于设置CPU亲和性等
+    using ThreadStartHook = std::function<void(size_t)>;
+
+    // max_coroutines限制工作线程数，thread_count为0时使用硬件核心数
+    CoroutinePool(size_t max_coroutines, size_t thread_count = 0, ThreadStartHook on_thread_start = nullptr);
+
+    // 执行完所有已提交的任务后停止工作线程
     ~CoroutinePool();
-    
+
+    CoroutinePool(const CoroutinePool&) = delete;
+    CoroutinePool& operator=(const CoroutinePool&) = delete;
+
+    // 提交任务，通过future获取结果或异常
     template <typename Func>
     auto Submit(Func&& func) {
-        using ReturnType = std::invoke_result_t<Func>;
-        
+        using ReturnType = std::invoke_result_t<std::decay_t<Func>&>;
+
         std::promise<ReturnType> promise;
         std::future<ReturnType> future = promise.get_future();
-        
-        auto task = std::make_unique<ConcreteTask<std::function<void()>>>(
-            [func = std::forward<Func>(func), p = std::move(promise)]() mutable {
-                try {
-                    if constexpr (std::is_void_v<ReturnType>) {
-                        func();
-                        p.set_value();
-                    } else {
-                        p.set_value(func());
-                    }
-                } catch (...) {
-                    p.set_exception(std::current_exception());
+
+        Post([func = std::forward<Func>(func), promise = std::move(promise)]() mutable {
+            try {
+                if constexpr (std::is_void_v<ReturnType>) {
+                    func();
+                    promise.set_value();
+                } else {
+                    promise.set_value(func());
                 }
+            } catch (...) {
+                promise.set_exception(std::current_exception());
             }
-        );
-        
-        EnqueueTask(std::move(task));
+        });
         return future;
     }
-    
+
+    // 提交不需要结果的任务，任务抛出的异常只记录日志
+    template <typename Func>
+    void Post(Func&& func) {
+        Enqueue(new detail::FunctionJob<std::decay_t<Func>>(std::forward<Func>(func)));
+    }
+
+    // 切换到池中的线程上继续执行：co_await pool.Schedule()
+    ScheduleAwaiter Schedule();
+
+    // 等待所有已提交的任务 (包括执行期间提交的任务) 完成
     void WaitAll();
+
+    // 正在执行的任务数
     size_t GetActiveCount() const;
+
+    // 等待执行的任务数
     size_t GetPendingCount() const;
     size_t GetPendingTaskCount() const;
+
+    // 正在执行任务的工作线程比例
     float GetUtilizationRate() const;
-    void AddWorkers(size_t count);
-    void RemoveWorkers(size_t count);
+
+    size_t GetWorkerCount() const;
+
+    // 从其他线程窃取到的任务数
+    size_t GetStealCount() const;
+
+private:
+    struct Worker;
+
+    void Enqueue(detail::PoolJob* job);
+    void WorkerThread(size_t index);
+
+    // 按本地队列、注入队列、其他线程的顺序查找任务
+    detail::PoolJob* FindJob(Worker& worker);
+    detail::PoolJob* PopInjected();
+    detail::PoolJob* StealFrom(Worker& thief);
+    bool HasQueuedJobs() const;
+
+    void RunJob(detail::PoolJob* job);
 
 private:
-    void EnqueueTask(std::unique_ptr<TaskWrapper> task);
-    void WorkerThread();
-    void StartHealthCheck();
-    void PerformHealthCheck();
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    // 外部线程提交的任务
+    mutable std::mutex inject_mutex_;
+    std::deque<detail::PoolJob*> inject_queue_;
+    std::atomic<size_t> inject_size_{0};
+
+    detail::EventCount idle_;
+    std::atomic<bool> stopping_{false};
+
+    // 已提交但未完成的任务数，WaitAll等待它归零
+    alignas(64) std::atomic<size_t> outstanding_{0};
+    alignas(64) std::atomic<size_t> active_{0};
+    std::atomic<size_t> steals_{0};
+
+    ThreadStartHook on_thread_start_;
+};
+
+// co_await CoroutinePool::Schedule() 的等待器，本身作为任务节点入队，不需要分配
+class CoroutinePool::ScheduleAwaiter : private detail::PoolJob {
+public:
+    explicit ScheduleAwaiter(CoroutinePool& pool) : PoolJob{&ScheduleAwaiter::Resume}, pool_(pool) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        handle_ = handle;
+        pool_.Enqueue(this);
+    }
+
+    void await_resume() const noexcept {}
 
 private:
-    const size_t max_coroutines_;
-    std::atomic<size_t> active_coroutines_;
-    std::atomic<bool> should_terminate_;
-    mutable std::mutex mutex_;
-    std::condition_variable task_cv_;
-    std::condition_variable completion_cv_;
-    std::deque<std::unique_ptr<TaskWrapper>> task_queue_;
-    std::vector<std::thread> worker_threads_;
-    std::atomic<size_t> workers_to_remove_{0};
-    std::thread health_check_thread_;
+    static void Resume(PoolJob* job) {
+        static_cast<ScheduleAwaiter*>(job)->handle_.resume();
+    }
+
+    CoroutinePool& pool_;
+    std::coroutine_handle<> handle_;
 };
 
-} // namespace ai_backend::core::async
\ No newline at end of file
+inline CoroutinePool::ScheduleAwaiter CoroutinePool::Schedule() {
+    return ScheduleAwaiter(*this);
+}
+
+} // namespace ai_backend::core::async
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <boost/asio/any_io_executor.hpp>
+
+namespace ai_backend::core::async {
+
+namespace detail {
+struct DeadlineState;
+} // namespace detail
+
+// 超过截止时间时抛出
+class DeadlineExceeded : public std::runtime_error {
+public:
+    explicit DeadlineExceeded(const std::string& what = "Deadline exceeded")
+        : std::runtime_error(what) {}
+};
+
+// 请求级截止时间
+// 由HttpSession按请求头或路由配置创建，随请求传递给数据库连接池、上游客户端和流式写入器。
+// 到期 (或被Cancel) 时在创建它的executor上依次调用已注册的回调，各层据此中止等待和传输，
+// 不再为无法按时完成的请求消耗资源。
+// 拷贝开销很小，所有拷贝共享同一状态；默认构造的对象没有截止时间，永不过期。
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 到期回调的注册句柄，析构时注销
+    // 回调可能与注销并发执行，回调中不能引用注销后失效的对象
+    class Registration {
+    public:
+        Registration() = default;
+        ~Registration();
+        Registration(Registration&& other) noexcept;
+        Registration& operator=(Registration&& other) noexcept;
+        Registration(const Registration&) = delete;
+        Registration& operator=(const Registration&) = delete;
+
+    private:
+        friend class Deadline;
+        Registration(const std::shared_ptr<detail::DeadlineState>& state, uint64_t id);
+
+        std::weak_ptr<detail::DeadlineState> state_;
+        uint64_t id_ = 0;
+    };
+
+    Deadline() = default;
+
+    // 在executor上计时，timeout后到期
+    static Deadline After(const boost::asio::any_io_executor& executor, std::chrono::milliseconds timeout);
+
+    // 派生更早的截止时间：min(当前截止时间, 现在 + timeout)，父截止时间到期时一并到期
+    // 没有截止时间的对象无法派生，需要executor时使用After
+    Deadline Tighten(std::chrono::milliseconds timeout) const;
+
+    // 派生可以单独取消的截止时间，到期时刻与当前相同，父截止时间到期时一并到期
+    // 用于取消一组子任务而不影响整个请求；未设置截止时间时派生出的对象只能被Cancel
+    Deadline Derive(const boost::asio::any_io_executor& executor) const;
+
+    // 是否设置了截止时间
+    bool IsSet() const { return state_ != nullptr; }
+
+    // 是否已到期或被取消
+    bool IsExpired() const;
+
+    // 剩余时间，未设置时返回milliseconds::max()，已到期时返回0
+    std::chrono::milliseconds Remaining() const;
+
+    // 截止时刻，未设置时返回time_point::max()
+    Clock::time_point GetExpiry() const;
+
+    // 提前到期，例如客户端断开连接
+    void Cancel() const;
+
+    // 注册到期回调，已到期时立即在当前线程调用；未设置截止时间时不注册
+    [[nodiscard]] Registration OnExpire(std::function<void()> callback) const;
+
+private:
+    explicit Deadline(std::shared_ptr<detail::DeadlineState> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<detail::DeadlineState> state_;
+};
+
+} // namespace ai_backend::core::async
@@ -5,13 +5,26 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
 #include <boost/asio.hpp>
 
+#include "core/async/codel.h"
+#include "core/async/runtime.h"
+#include "core/async/timer_wheel.h"
+#include "core/utils/latency_histogram.h"
+
 namespace ai_backend::core::async {
 
+// 事件循环积压时Post拒绝新任务
+class QueueFullError : public std::runtime_error {
+public:
+    explicit QueueFullError(const std::string& what = "EventLoop queue full")
+        : std::runtime_error(what) {}
+};
+
 struct EventLoopMetrics {
     std::atomic<size_t> tasks_posted{0};
     std::atomic<size_t> tasks_dispatched{0};
@@ -22,11 +35,16 @@ struct EventLoopMetrics {
     std::atomic<size_t> recurring_tasks_executed{0};
     std::atomic<size_t> exception_count{0};
     std::atomic<size_t> timer_errors{0};
+    std::atomic<size_t> tasks_rejected{0};
 };
 
+// 运行时第0个io_context之上的任务投递接口
+// 线程由Runtime持有，EventLoop只负责投递、定时任务和指标，Start/Stop不再创建或停止线程。
+// Post的队列有界：未执行的任务达到上限，或CoDel检测到任务排队时间持续超过目标时，
+// Post抛出QueueFullError，调用方应放弃或降级这部分工作。
 class EventLoop {
 public:
-    EventLoop(size_t thread_count = 0);
+    explicit EventLoop(Runtime& runtime = Runtime::GetInstance());
     ~EventLoop();
     
     void Start();
@@ -36,6 +54,19 @@ public:
     
     static EventLoop& GetInstance();
     
+    // 设置Post的队列上限 (0表示不限) 和排队时间目标，只能在Start之前调用
+    void ConfigureQueue(size_t max_pending_tasks, std::chrono::milliseconds target,
+                        std::chrono::milliseconds interval);
+    
+    // 已投递未执行的任务数
+    size_t GetPendingTasks() const;
+    
+    // 被拒绝的Post任务数
+    size_t GetRejectedTasks() const;
+    
+    // Post任务的排队时间
+    utils::LatencyHistogram::Snapshot GetQueueSojourn() const;
+    
     template <typename Task>
     void Post(Task&& task);
     
@@ -62,15 +93,18 @@ private:
     void StartMetricsCollection();
 
 private:
-    boost::asio::io_context io_context_;
-    std::unique_ptr<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> work_guard_;
-    std::vector<std::thread> worker_threads_;
-    size_t thread_count_;
+    boost::asio::io_context& io_context_;
     std::atomic<bool> running_;
     std::mutex mutex_;
-    std::thread metrics_thread_;
+    TimerWheel::Timer metrics_timer_;
     std::atomic<bool> metrics_collection_enabled_;
     EventLoopMetrics metrics_;
+    
+    // Post队列的准入状态
+    size_t max_pending_tasks_;
+    std::atomic<size_t> pending_tasks_;
+    std::unique_ptr<CoDel> codel_;
+    utils::LatencyHistogram queue_sojourn_;
 };
 
 } // namespace ai_backend::core::async
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ai_backend::core::async {
+
+// 协程帧分配统计，所有线程的累计值
+struct FrameAllocatorStats {
+    uint64_t allocations = 0;       // 分配的协程帧数
+    uint64_t deallocations = 0;     // 释放的协程帧数
+    uint64_t cache_hits = 0;        // 从线程本地空闲链表取得的帧数
+    uint64_t arena_allocations = 0; // 从请求arena分配的帧数
+    uint64_t bytes_allocated = 0;   // 累计分配字节数 (含帧头)
+    uint64_t bytes_freed = 0;       // 累计释放字节数 (含帧头)
+
+    uint64_t GetLiveFrames() const { return allocations - deallocations; }
+    uint64_t GetLiveBytes() const { return bytes_allocated - bytes_freed; }
+};
+
+// 单个请求的协程帧arena
+// 从连续的内存块中顺序分配，释放帧时不回收，arena析构时整体释放。
+// 只适合生命周期不超过请求的协程，且不是线程安全的：同一个arena只能在
+// 串行执行的协程之间共享 (例如同一会话strand上的调用链)。
+// 协程函数把 (std::allocator_arg, arena) 作为前两个参数即可使用：
+//   Task<Response> Handle(std::allocator_arg_t, FrameArena& arena, const Request& request);
+class FrameArena {
+public:
+    explicit FrameArena(size_t chunk_size = 4096);
+
+    // 先使用调用者提供的缓冲区 (例如会话协程帧中的数组)，用完后再分配新块
+    FrameArena(void* buffer, size_t size, size_t chunk_size = 4096);
+
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* Allocate(size_t size);
+
+    // 帧被释放时调用，只用于检查是否有帧比arena活得更久
+    void Release() noexcept { --live_frames_; }
+
+    size_t GetBytesReserved() const { return bytes_reserved_; }
+    size_t GetLiveFrames() const { return live_frames_; }
+
+private:
+    // 额外分配的块，块头之后是可用内存
+    struct Chunk {
+        Chunk* next;
+    };
+
+    size_t chunk_size_;
+    Chunk* chunks_ = nullptr;
+    std::byte* cursor_ = nullptr;
+    std::byte* end_ = nullptr;
+    size_t bytes_reserved_ = 0;
+    size_t live_frames_ = 0;
+};
+
+// 关闭后所有协程帧直接使用全局new/delete，用于对比测试和配合ASan排查释放后使用
+void SetFramePoolingEnabled(bool enabled);
+bool IsFramePoolingEnabled();
+
+FrameAllocatorStats GetFrameAllocatorStats();
+
+namespace detail {
+
+// 协程帧的分配入口，由Task::promise_type的operator new/delete调用
+// 小帧按大小分级缓存在线程本地的空闲链表中，超过最大级别的帧直接走全局new。
+// 帧可以在另一个线程上释放，此时放入释放线程的链表，链表长度有上限。
+void* AllocateFrame(size_t size);
+void* AllocateFrame(size_t size, FrameArena& arena);
+void DeallocateFrame(void* frame, size_t size) noexcept;
+
+} // namespace detail
+
+} // namespace ai_backend::core::async
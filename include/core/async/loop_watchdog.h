@@ -0,0 +1,233 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+
+#include "core/utils/latency_histogram.h"
+
+namespace ai_backend::core::async {
+
+// 事件循环看门狗的配置，对应config.toml的[runtime.watchdog]节
+struct LoopWatchdogOptions {
+    bool enabled = true;
+    // 向每个io_context投递探测任务的间隔，探测任务从投递到执行的时间即事件循环延迟
+    std::chrono::milliseconds probe_interval{100};
+    // 处理函数运行超过该值记为慢处理函数，探测任务等待超过该值记为停顿
+    std::chrono::milliseconds threshold{50};
+    // 每分钟最多采集的调用栈数，采集需要中断IO线程
+    size_t stack_samples_per_minute = 6;
+    // 定期输出延迟汇总的间隔
+    std::chrono::seconds report_interval{60};
+};
+
+// 处理函数的标识
+// 协程取恢复函数的地址 (GCC和Clang的协程帧以恢复函数指针开头)，符号化后是协程函数名；
+// 函数对象取类型，lambda的类型名包含定义它的函数。
+struct HandlerIdentity {
+    const void* address = nullptr;
+    const std::type_info* type = nullptr;
+
+    static HandlerIdentity Of(std::coroutine_handle<> handle) noexcept {
+#if defined(__GNUC__)
+        if (handle) {
+            return {*static_cast<void* const*>(handle.address()), nullptr};
+        }
+#endif
+        return {handle.address(), nullptr};
+    }
+
+    template <typename Func>
+    static HandlerIdentity Of(const Func&) noexcept {
+        return {nullptr, &typeid(Func)};
+    }
+
+    // 可读的名称，无法符号化时返回地址
+    std::string Describe() const;
+
+    bool operator<(const HandlerIdentity& other) const {
+        return std::pair(address, type) < std::pair(other.address, other.type);
+    }
+};
+
+class LoopWatchdog;
+
+namespace detail {
+
+// 每个已注册IO线程的状态，由IO线程写入、看门狗线程读取
+struct ThreadActivity {
+    LoopWatchdog* watchdog = nullptr;
+    size_t index = 0;
+    size_t io_context = 0;
+    std::thread::native_handle_type native_handle{};
+    int64_t threshold_ns = 0;
+
+    // 当前处理函数开始的时刻 (steady_clock纳秒)，空闲时为0
+    std::atomic<int64_t> busy_since{0};
+    std::atomic<const void*> identity_address{nullptr};
+    std::atomic<const std::type_info*> identity_type{nullptr};
+    // 嵌套的处理函数只记录最外层，只在本线程访问
+    unsigned depth = 0;
+
+    utils::LatencyHistogram lag;
+    utils::LatencyHistogram handlers;
+    std::atomic<uint64_t> slow_handlers{0};
+    std::atomic<uint64_t> stalls{0};
+
+    // 以下由看门狗线程在持有锁时访问：是否仍在运行、已报告过的忙碌区间，以及信号处理函数写入的调用栈
+    bool registered = false;
+    int64_t reported_since = 0;
+    std::array<void*, 48> frames{};
+    std::atomic<int> frame_count{0};
+};
+
+// 当前线程的状态，未注册的线程 (测试、线程池) 为空，HandlerScope不做任何事
+extern thread_local ThreadActivity* t_thread_activity;
+
+inline int64_t MonotonicNanos() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace detail
+
+// 标记IO线程上一段处理函数的执行
+// 在Spawn、ResumeOn、等待队列和时间轮恢复协程或运行回调的地方使用；
+// 未注册的线程上只有一次线程本地变量的读取。
+class HandlerScope {
+public:
+    explicit HandlerScope(HandlerIdentity identity) noexcept
+        : activity_(detail::t_thread_activity), identity_(identity) {
+        if (!activity_ || activity_->depth++ > 0) {
+            return;
+        }
+        start_ = detail::MonotonicNanos();
+        activity_->identity_address.store(identity.address, std::memory_order_relaxed);
+        activity_->identity_type.store(identity.type, std::memory_order_relaxed);
+        activity_->busy_since.store(start_, std::memory_order_release);
+    }
+
+    ~HandlerScope() {
+        if (!activity_ || --activity_->depth > 0) {
+            return;
+        }
+        activity_->busy_since.store(0, std::memory_order_release);
+        auto elapsed = detail::MonotonicNanos() - start_;
+        activity_->handlers.Record(std::chrono::nanoseconds(elapsed));
+        if (elapsed > activity_->threshold_ns) {
+            OnSlowHandler(elapsed);
+        }
+    }
+
+    HandlerScope(const HandlerScope&) = delete;
+    HandlerScope& operator=(const HandlerScope&) = delete;
+
+private:
+    void OnSlowHandler(int64_t elapsed_ns);
+
+    detail::ThreadActivity* activity_;
+    HandlerIdentity identity_;
+    int64_t start_ = 0;
+};
+
+// 事件循环延迟和阻塞调用检测
+// 看门狗线程定期向每个io_context投递探测任务，执行探测任务的IO线程记录从投递到执行的延迟；
+// 探测任务超过阈值仍未执行时记为停顿，采集该io_context上IO线程的调用栈。
+// HandlerScope标记的处理函数运行超过阈值时记为慢处理函数，按标识汇总；仍在运行时看门狗
+// 通过信号中断该线程采集调用栈并记录日志。调用栈采集按每分钟的配额限流。
+class LoopWatchdog : public std::enable_shared_from_this<LoopWatchdog> {
+public:
+    struct ThreadStats {
+        size_t index;
+        size_t io_context;
+        utils::LatencyHistogram::Snapshot lag;
+        utils::LatencyHistogram::Snapshot handlers;
+        uint64_t slow_handlers;
+        uint64_t stalls;
+    };
+
+    struct SlowHandlerStats {
+        std::string handler;
+        uint64_t count;
+        uint64_t total_us;
+        uint64_t max_us;
+    };
+
+    struct Stats {
+        std::vector<ThreadStats> threads;
+        // 按累计耗时从高到低排列
+        std::vector<SlowHandlerStats> slow_handlers;
+    };
+
+    LoopWatchdog(LoopWatchdogOptions options, std::vector<boost::asio::io_context*> io_contexts);
+    ~LoopWatchdog();
+
+    LoopWatchdog(const LoopWatchdog&) = delete;
+    LoopWatchdog& operator=(const LoopWatchdog&) = delete;
+
+    // 启动看门狗线程，之后才能投递探测任务
+    void Start();
+    void Stop();
+
+    // 由IO线程在运行io_context之前和退出时调用
+    void RegisterCurrentThread(size_t index, size_t io_context);
+    void UnregisterCurrentThread();
+
+    Stats GetStats() const;
+
+    const LoopWatchdogOptions& GetOptions() const { return options_; }
+
+private:
+    friend class HandlerScope;
+
+    struct ProbeState {
+        bool outstanding = false;
+        int64_t posted_at = 0;
+        bool stall_reported = false;
+    };
+
+    void Run();
+    void PostProbes(int64_t now);
+    void OnProbe(size_t io_context, int64_t posted_at);
+    void CheckThreads(int64_t now);
+    void RecordSlowHandler(detail::ThreadActivity& activity, HandlerIdentity identity, int64_t elapsed_ns);
+    void Report();
+
+    // 消耗一次调用栈采集配额
+    bool TakeSampleBudget(int64_t now);
+    // 中断线程采集调用栈，返回符号化后的多行文本
+    std::string CaptureStack(detail::ThreadActivity& activity);
+
+private:
+    const LoopWatchdogOptions options_;
+    const std::vector<boost::asio::io_context*> io_contexts_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeup_;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    std::vector<std::unique_ptr<detail::ThreadActivity>> threads_;
+    std::vector<ProbeState> probes_;
+    // 已退出线程的统计仍然保留
+    std::map<HandlerIdentity, SlowHandlerStats> slow_handlers_;
+
+    // 调用栈采集配额，按分钟重置
+    int64_t budget_window_start_ = 0;
+    size_t budget_used_ = 0;
+};
+
+} // namespace ai_backend::core::async
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+
+#include "core/async/coroutine_pool.h"
+#include "core/async/loop_watchdog.h"
+#include "core/async/task.h"
+
+namespace ai_backend::core::async {
+
+// IO线程模型
+enum class IoMode {
+    // 所有IO线程共享一个io_context
+    kShared,
+    // 每个IO线程独占一个io_context，会话不跨线程迁移
+    kSharded
+};
+
+// 运行时的线程布局，对应config.toml的[runtime]节
+struct RuntimeOptions {
+    // IO线程数，0表示使用可用的核心数
+    size_t io_threads = 0;
+    IoMode io_mode = IoMode::kShared;
+    // 阻塞任务 (PBKDF2、文件读写等) 的线程数，有上限，阻塞调用不会占用IO线程
+    size_t blocking_threads = 8;
+    // CPU密集任务的线程数，0表示可用核心数的一半
+    size_t cpu_threads = 0;
+    // 将IO线程绑定到单个CPU核心，开启numa_aware时线程池绑定到所在的NUMA节点
+    bool pin_threads = false;
+    // IO线程按NUMA节点交错分布，线程池的线程留在对应节点上
+    bool numa_aware = false;
+    // IO线程的事件循环延迟和阻塞调用检测
+    LoopWatchdogOptions watchdog;
+
+    // 解析配置中的IO模型名称 ("shared" / "sharded")
+    static IoMode ParseIoMode(const std::string& name);
+};
+
+namespace detail {
+
+// 解析sysfs格式的CPU列表，例如"0-3,8-11"
+std::vector<int> ParseCpuList(const std::string& text);
+
+// 当前进程可用的CPU按NUMA节点分组，无法读取拓扑时返回单个节点
+std::vector<std::vector<int>> DetectNumaNodes();
+
+} // namespace detail
+
+// 进程的执行器拓扑
+// 统一持有IO线程、有界的阻塞任务池和CPU任务池，HttpServer、WebSocketServer、EventLoop、
+// 连接池等都从这里获取executor，不再各自创建线程。
+// 第0个io_context在构造时创建，Start之前即可取得，EventLoop和各单例使用它；
+// 分片模式下其余io_context由Configure创建，HttpServer在每个io_context上各开一个接受器。
+class Runtime {
+public:
+    explicit Runtime(RuntimeOptions options = {});
+    ~Runtime();
+
+    Runtime(const Runtime&) = delete;
+    Runtime& operator=(const Runtime&) = delete;
+
+    // 进程共享的运行时
+    static Runtime& GetInstance();
+
+    // 修改线程布局，只能在Start之前调用
+    void Configure(RuntimeOptions options);
+
+    // 启动IO线程和线程池
+    void Start();
+
+    // 停止IO线程，线程池执行完已提交的任务后退出
+    void Stop();
+
+    bool IsRunning() const;
+
+    const RuntimeOptions& GetOptions() const;
+
+    size_t GetIoContextCount() const;
+
+    // 第index个io_context (按数量取模)
+    boost::asio::io_context& GetIoContext(size_t index = 0);
+
+    // 轮流返回各io_context，用于把新连接分散到各分片
+    boost::asio::io_context& NextIoContext();
+
+    boost::asio::any_io_executor GetIoExecutor() { return GetIoContext().get_executor(); }
+
+    // 看门狗，未启用或未启动过时为空；Stop之后仍保留最近一次运行的统计
+    std::shared_ptr<LoopWatchdog> GetWatchdog() const;
+
+    // 只能在Start之后调用
+    CoroutinePool& GetBlockingPool();
+    CoroutinePool& GetCpuPool();
+
+    // 在阻塞任务池上执行func，完成后回到resume_on继续，func抛出的异常在resume_on上重新抛出
+    template <typename Func>
+    Task<std::invoke_result_t<Func&>> RunBlocking(Func func, boost::asio::any_io_executor resume_on) {
+        return RunOn(GetBlockingPool(), std::move(func), std::move(resume_on));
+    }
+
+    // 在CPU任务池上执行func，用于分词、压缩等会拖慢IO线程的计算
+    template <typename Func>
+    Task<std::invoke_result_t<Func&>> RunCpu(Func func, boost::asio::any_io_executor resume_on) {
+        return RunOn(GetCpuPool(), std::move(func), std::move(resume_on));
+    }
+
+private:
+    using WorkGuard = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
+
+    template <typename Func>
+    static Task<std::invoke_result_t<Func&>> RunOn(CoroutinePool& pool, Func func,
+                                                  boost::asio::any_io_executor resume_on) {
+        using Result = std::invoke_result_t<Func&>;
+
+        auto schedule = pool.Schedule();
+        co_await schedule;
+
+        std::exception_ptr exception;
+        std::optional<std::conditional_t<std::is_void_v<Result>, bool, Result>> result;
+        try {
+            if constexpr (std::is_void_v<Result>) {
+                func();
+            } else {
+                result.emplace(func());
+            }
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        ResumeOn<boost::asio::any_io_executor> resume(std::move(resume_on));
+        co_await resume;
+
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        if constexpr (!std::is_void_v<Result>) {
+            co_return std::move(*result);
+        }
+    }
+
+    // 按IO线程下标计算绑定的CPU，不绑定时返回空
+    std::vector<int> IoThreadCpus(size_t index) const;
+    std::vector<int> PoolThreadCpus(size_t index) const;
+
+    void ResizeIoContexts();
+
+    mutable std::mutex mutex_;
+    RuntimeOptions options_;
+    std::atomic<bool> running_{false};
+
+    std::vector<std::unique_ptr<boost::asio::io_context>> io_contexts_;
+    std::vector<WorkGuard> work_guards_;
+    std::vector<std::thread> io_threads_;
+    std::atomic<size_t> next_io_context_{0};
+
+    std::unique_ptr<CoroutinePool> blocking_pool_;
+    std::unique_ptr<CoroutinePool> cpu_pool_;
+    std::shared_ptr<LoopWatchdog> watchdog_;
+
+    // Start时探测的NUMA拓扑
+    std::vector<std::vector<int>> nodes_;
+};
+
+} // namespace ai_backend::core::async
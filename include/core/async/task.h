@@ -4,50 +4,184 @@
 #include <exception>
 #include <functional>
 #include <future>
+#include <memory>
 #include <optional>
+#include <stdexcept>
+#include <utility>
 #include <variant>
 
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/post.hpp>
+
+#include "core/async/frame_allocator.h"
+#include "core/async/loop_watchdog.h"
+
 namespace ai_backend::core::async {
 
+namespace detail {
+
+// 当前线程上正在恢复的协程所在的executor，由ExecutorScope设置
+extern thread_local const boost::asio::any_io_executor* t_current_executor;
+
+} // namespace detail
+
+// 当前协程所在的executor (会话的strand、io_context等)
+// Spawn、ResumeOn和各等待器恢复协程时设置；不是从这些地方恢复的代码 (测试主线程、阻塞任务池) 为空。
+// 等待外部事件的等待器在await_suspend中记录它，完成时投递回这里恢复，协程不会因为等待
+// 而离开所在的strand或IO线程。
+inline boost::asio::any_io_executor CurrentExecutor() noexcept {
+    auto* executor = detail::t_current_executor;
+    return executor ? *executor : boost::asio::any_io_executor();
+}
+
+// 恢复协程期间设置当前executor，结束时还原；executor须在作用域内保持有效
+class ExecutorScope {
+public:
+    explicit ExecutorScope(const boost::asio::any_io_executor& executor) noexcept
+        : previous_(std::exchange(detail::t_current_executor, &executor)) {}
+    ~ExecutorScope() { detail::t_current_executor = previous_; }
+
+    ExecutorScope(const ExecutorScope&) = delete;
+    ExecutorScope& operator=(const ExecutorScope&) = delete;
+
+private:
+    const boost::asio::any_io_executor* previous_;
+};
+
+namespace detail {
+
+// 投递到executor上恢复协程，executor为空时在当前线程直接恢复
+inline void ResumeAt(const boost::asio::any_io_executor& executor, std::coroutine_handle<> handle) {
+    if (!executor) {
+        handle.resume();
+        return;
+    }
+    boost::asio::post(executor, [executor, handle]() {
+        ExecutorScope executor_scope(executor);
+        HandlerScope scope(HandlerIdentity::Of(handle));
+        handle.resume();
+    });
+}
+
+// 记录分离运行的任务中未捕获的异常
+void LogUnhandledException(std::exception_ptr exception) noexcept;
+
+// Task的promise公共部分
+// 协程创建后先挂起，在被co_await或Spawn时才开始执行；结束时通过对称转移直接切换到等待者，
+// 嵌套任务的完成链不会在栈上累积。分离运行的任务没有等待者，结束时自行销毁协程帧。
+// 协程帧从线程本地的分级空闲链表分配；参数以 (std::allocator_arg, FrameArena&) 开头的协程
+// (成员函数则在this之后) 从该arena分配。
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation;
+    bool detached = false;
+
+    static void* operator new(size_t size) {
+        return AllocateFrame(size);
+    }
+
+    template <typename... Args>
+    static void* operator new(size_t size, std::allocator_arg_t, FrameArena& arena, Args&&...) {
+        return AllocateFrame(size, arena);
+    }
+
+    template <typename Self, typename... Args>
+    static void* operator new(size_t size, Self&&, std::allocator_arg_t, FrameArena& arena, Args&&...) {
+        return AllocateFrame(size, arena);
+    }
+
+    static void operator delete(void* frame, size_t size) noexcept {
+        DeallocateFrame(frame, size);
+    }
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            auto& promise = handle.promise();
+            if (promise.detached) {
+                promise.LogIfFailed();
+                handle.destroy();
+                return std::noop_coroutine();
+            }
+            if (promise.continuation) {
+                return promise.continuation;
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+};
+
+// 投递到executor上启动分离任务，处理函数未执行就被销毁时 (io_context停止) 一并销毁协程帧
+class SpawnHandler {
+public:
+    SpawnHandler(std::coroutine_handle<> handle, boost::asio::any_io_executor executor) noexcept
+        : handle_(handle), executor_(std::move(executor)) {}
+    SpawnHandler(SpawnHandler&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)), executor_(std::move(other.executor_)) {}
+    SpawnHandler(const SpawnHandler&) = delete;
+    SpawnHandler& operator=(const SpawnHandler&) = delete;
+    SpawnHandler& operator=(SpawnHandler&&) = delete;
+
+    ~SpawnHandler() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    void operator()() {
+        auto handle = std::exchange(handle_, nullptr);
+        ExecutorScope executor_scope(executor_);
+        HandlerScope scope(HandlerIdentity::Of(handle));
+        handle.resume();
+    }
+
+private:
+    std::coroutine_handle<> handle_;
+    boost::asio::any_io_executor executor_;
+};
+
+} // namespace detail
+
 // Task 类是协程的返回类型，用于支持 C++20 协程
+// 惰性启动：调用协程函数只创建协程帧，co_await时才开始执行。
+// co_await直接把控制权转移给子任务 (对称转移)，不经过调度器也不产生额外分配。
 template <typename T>
 class Task {
 public:
     struct promise_type;
     using handle_type = std::coroutine_handle<promise_type>;
 
-    struct promise_type {
+    struct promise_type : detail::TaskPromiseBase {
         std::variant<std::monostate, T, std::exception_ptr> result;
-        std::coroutine_handle<> continuation; // 添加缺少的成员
         
-        Task get_return_object() { 
+        Task get_return_object() noexcept { 
             return Task(handle_type::from_promise(*this)); 
         }
         
-        std::suspend_never initial_suspend() { return {}; }
-        std::suspend_always final_suspend() noexcept { return {}; }
-        
         void return_value(T value) { 
             result.template emplace<1>(std::move(value)); 
         }
         
-        void unhandled_exception() { 
+        void unhandled_exception() noexcept { 
             result.template emplace<2>(std::current_exception()); 
         }
 
-        // 处理协程未恢复的情况
-        ~promise_type() {
+        void LogIfFailed() noexcept {
             if (result.index() == 2) {
-                // 记录未处理的异常
+                detail::LogUnhandledException(std::get<2>(result));
             }
         }
     };
 
     Task() noexcept : handle_(nullptr) {}
-    Task(handle_type h) noexcept : handle_(h) {}
-    Task(Task&& other) noexcept : handle_(other.handle_) {
-        other.handle_ = nullptr;
-    }
+    explicit Task(handle_type h) noexcept : handle_(h) {}
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
     
     ~Task() {
         if (handle_) {
@@ -60,8 +194,7 @@ public:
             if (handle_) {
                 handle_.destroy();
             }
-            handle_ = other.handle_;
-            other.handle_ = nullptr;
+            handle_ = std::exchange(other.handle_, nullptr);
         }
         return *this;
     }
@@ -75,9 +208,10 @@ public:
         return !handle_ || handle_.done(); 
     }
     
-    void await_suspend(std::coroutine_handle<> awaiting) const noexcept {
-        // 保存当前协程句柄，并设置恢复函数
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) const noexcept {
+        // 记录等待者后直接切换到子任务，子任务结束时再切换回来
         handle_.promise().continuation = awaiting;
+        return handle_;
     }
     
     T await_resume() {
@@ -95,6 +229,11 @@ public:
         }
     }
 
+    // 交出协程帧的所有权，由调用者负责启动和销毁
+    handle_type Release() noexcept {
+        return std::exchange(handle_, nullptr);
+    }
+
 private:
     handle_type handle_;
 };
@@ -106,45 +245,29 @@ public:
     struct promise_type;
     using handle_type = std::coroutine_handle<promise_type>;
 
-    struct promise_type {
-        std::variant<std::monostate, std::exception_ptr> result;
-        std::coroutine_handle<> continuation; // 添加缺少的成员
+    struct promise_type : detail::TaskPromiseBase {
+        std::exception_ptr exception;
         
-        Task get_return_object() { 
+        Task get_return_object() noexcept { 
             return Task(handle_type::from_promise(*this)); 
         }
         
-        std::suspend_never initial_suspend() { return {}; }
+        void return_void() noexcept {}
         
-        auto final_suspend() noexcept {
-            struct FinalAwaiter {
-                bool await_ready() const noexcept { return false; }
-                
-                std::coroutine_handle<> await_suspend(handle_type h) noexcept {
-                    auto& promise = h.promise();
-                    if (promise.continuation) {
-                        return promise.continuation;
-                    }
-                    return std::noop_coroutine();
-                }
-                
-                void await_resume() noexcept {}
-            };
-            return FinalAwaiter{};
+        void unhandled_exception() noexcept {
+            exception = std::current_exception();
         }
-        
-        void return_void() {}
-        
-        void unhandled_exception() {
-            result.template emplace<1>(std::current_exception());
+
+        void LogIfFailed() noexcept {
+            if (exception) {
+                detail::LogUnhandledException(exception);
+            }
         }
     };
 
     Task() noexcept : handle_(nullptr) {}
-    Task(handle_type h) noexcept : handle_(h) {}
-    Task(Task&& other) noexcept : handle_(other.handle_) {
-        other.handle_ = nullptr;
-    }
+    explicit Task(handle_type h) noexcept : handle_(h) {}
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
     
     ~Task() {
         if (handle_) {
@@ -157,8 +280,7 @@ public:
             if (handle_) {
                 handle_.destroy();
             }
-            handle_ = other.handle_;
-            other.handle_ = nullptr;
+            handle_ = std::exchange(other.handle_, nullptr);
         }
         return *this;
     }
@@ -172,8 +294,9 @@ public:
         return !handle_ || handle_.done(); 
     }
     
-    void await_suspend(std::coroutine_handle<> awaiting) const noexcept {
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) const noexcept {
         handle_.promise().continuation = awaiting;
+        return handle_;
     }
     
     void await_resume() {
@@ -182,34 +305,49 @@ public:
         }
         
         auto& promise = handle_.promise();
-        if (promise.result.index() == 1) {
-            std::rethrow_exception(std::get<1>(promise.result));
+        if (promise.exception) {
+            std::rethrow_exception(promise.exception);
         }
     }
 
+    // 交出协程帧的所有权，由调用者负责启动和销毁
+    handle_type Release() noexcept {
+        return std::exchange(handle_, nullptr);
+    }
+
 private:
     handle_type handle_;
 };
 
-// 增加超时任务封装
-template <typename T>
-class TimeoutTask {
+// 在executor上分离运行任务
+// 任务结束时自行销毁协程帧，未捕获的异常记录到日志。
+template <typename Executor, typename T>
+void Spawn(const Executor& executor, Task<T> task) {
+    auto handle = task.Release();
+    if (!handle) {
+        return;
+    }
+    handle.promise().detached = true;
+    boost::asio::post(executor, detail::SpawnHandler(handle, executor));
+}
+
+// 切换到指定executor上继续执行：co_await ResumeOn(executor)
+// 用于从上游回调线程等外部线程回到会话所在的strand或io_context，之后的CurrentExecutor为该executor。
+template <typename Executor>
+class ResumeOn {
 public:
-    TimeoutTask(Task<T>&& task, std::chrono::milliseconds timeout)
-        : task_(std::move(task)), timeout_(timeout) {}
+    explicit ResumeOn(Executor executor) : executor_(std::move(executor)) {}
 
-    bool await_ready() const { return task_.await_ready(); }
-    
-    template <typename PromiseType>
-    void await_suspend(std::coroutine_handle<PromiseType> handle) {
-        // 实现超时逻辑
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        detail::ResumeAt(executor_, handle);
     }
-    
-    T await_resume() { return task_.await_resume(); }
+
+    void await_resume() const noexcept {}
 
 private:
-    Task<T> task_;
-    std::chrono::milliseconds timeout_;
+    boost::asio::any_io_executor executor_;
 };
 
 } // namespace ai_backend::core::async
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <boost/asio/any_io_executor.hpp>
+
+#include "core/async/deadline.h"
+#include "core/async/task.h"
+
+namespace ai_backend::core::async {
+
+// 带超时的等待：co_await TimeoutTask(executor, std::move(task), deadline)
+// 子任务在executor上启动，先结束的一方恢复等待者；超时时抛出DeadlineExceeded。
+// 计时复用Deadline的到期回调：传入Deadline时不再单独计时，传入时长时创建一个挂在时间轮上的Deadline，
+// 每次调用只占一个时间轮节点，不创建asio定时器。等待者回到挂起时所在的执行器 (没有时为executor) 上恢复。
+// 协程无法从外部中止，超时后子任务在后台继续运行到结束，其结果被丢弃；
+// 因此子任务必须持有自己用到的数据，并应同时收到同一个Deadline，让其中的连接等待和上游传输在到期时尽快中止。
+template <typename T>
+class TimeoutTask {
+public:
+    // 以截止时间作为超时，未设置截止时间时不计时
+    TimeoutTask(boost::asio::any_io_executor executor, Task<T>&& task, Deadline deadline)
+        : executor_(std::move(executor)),
+          task_(std::move(task)),
+          deadline_(std::move(deadline)),
+          state_(std::make_shared<State>()) {}
+
+    TimeoutTask(boost::asio::any_io_executor executor, Task<T>&& task, std::chrono::milliseconds timeout)
+        : TimeoutTask(executor, std::move(task),
+                      timeout == std::chrono::milliseconds::max() ? Deadline() : Deadline::After(executor, timeout)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> awaiting) {
+        if (deadline_.IsExpired()) {
+            // 已到期时不启动子任务，直接抛出
+            state_->timed_out = true;
+            return false;
+        }
+
+        auto resume_executor = CurrentExecutor();
+        state_->awaiting = awaiting;
+        state_->resume_executor = resume_executor ? resume_executor : executor_;
+
+        // 到期回调或子任务都可能在其他线程上立即恢复等待者，此后不能再访问this
+        auto state = state_;
+        auto executor = executor_;
+        auto task = std::move(task_);
+        state->registration = deadline_.OnExpire([weak = std::weak_ptr<State>(state)]() {
+            auto state = weak.lock();
+            if (!state || state->finished.exchange(true)) {
+                return;
+            }
+            state->timed_out = true;
+            detail::ResumeAt(state->resume_executor, state->awaiting);
+        });
+        Spawn(executor, Run(state, std::move(task)));
+        return true;
+    }
+
+    T await_resume() {
+        if (state_->timed_out) {
+            throw DeadlineExceeded("Operation timed out");
+        }
+        if (state_->exception) {
+            std::rethrow_exception(state_->exception);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*state_->value);
+        }
+    }
+
+private:
+    // 子任务和到期回调共享的状态，先将finished置位的一方负责恢复等待者
+    struct State {
+        std::coroutine_handle<> awaiting;
+        boost::asio::any_io_executor resume_executor;
+        std::atomic<bool> finished{false};
+        bool timed_out = false;
+        std::conditional_t<std::is_void_v<T>, std::monostate, std::optional<T>> value;
+        std::exception_ptr exception;
+        Deadline::Registration registration;
+    };
+
+    static Task<void> Run(std::shared_ptr<State> state, Task<T> task) {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await task;
+            } else {
+                state->value.emplace(co_await task);
+            }
+        } catch (...) {
+            state->exception = std::current_exception();
+        }
+
+        if (!state->finished.exchange(true)) {
+            detail::ResumeAt(state->resume_executor, state->awaiting);
+        }
+    }
+
+    boost::asio::any_io_executor executor_;
+    Task<T> task_;
+    Deadline deadline_;
+    std::shared_ptr<State> state_;
+};
+
+} // namespace ai_backend::core::async
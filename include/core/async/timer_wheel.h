@@ -0,0 +1,124 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/io_context.hpp>
+
+namespace ai_backend::core::async {
+
+// 分层哈希时间轮 (Varghese & Lauck)
+// 4层、每层256个槽，精度1毫秒，覆盖约49天。定时器是侵入式链表节点，插入和取消都是O(1)，
+// 重新设置到期时间不需要分配；每个io_context只有一个asio定时器驱动整个时间轮，
+// 只在最近的非空槽或下一次级联时唤醒。
+// 用于会话空闲超时、请求截止时间和EventLoop的定时任务。
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds kTick{1};
+
+    // 由使用者持有的定时器节点
+    // 析构时自动取消；回调正在其他线程上运行时，析构和Cancel会等待回调结束。
+    class Timer {
+    public:
+        Timer() = default;
+        explicit Timer(std::function<void()> callback) : callback_(std::move(callback)) {}
+        ~Timer();
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        // 只能在定时器未启动时设置
+        void SetCallback(std::function<void()> callback) { callback_ = std::move(callback); }
+
+    private:
+        friend class TimerWheel;
+
+        TimerWheel* wheel_ = nullptr;
+        Timer** slot_ = nullptr;  // 所在槽的链表头，未启动时为空
+        Timer* prev_ = nullptr;
+        Timer* next_ = nullptr;
+        uint64_t expiry_ = 0;     // 到期的tick
+        bool owned_ = false;      // 由时间轮持有，回调结束后删除或重新启动
+        std::function<void()> callback_;
+    };
+
+    explicit TimerWheel(Clock::time_point origin = Clock::now());
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // executor所属io_context的时间轮，首次使用时创建并由io_context驱动
+    static TimerWheel& For(boost::asio::io_context& io_context);
+    static TimerWheel& For(const boost::asio::any_io_executor& executor);
+
+    // 启动或重新设置定时器，回调在驱动时间轮的线程上运行
+    void Schedule(Timer& timer, std::chrono::milliseconds delay);
+    void ScheduleAt(Timer& timer, Clock::time_point expiry);
+
+    // 取消定时器，返回是否在到期前取消
+    bool Cancel(Timer& timer);
+
+    // 由时间轮持有节点的一次性和周期任务
+    void ScheduleAfter(std::chrono::milliseconds delay, std::function<void()> callback);
+    void ScheduleRecurring(std::chrono::milliseconds interval, std::function<void()> callback);
+
+    // 推进到now并运行所有到期的回调，返回运行的回调数
+    size_t Advance(Clock::time_point now);
+
+    // 计算下一次需要调用Advance的时刻并记录；没有定时器时返回time_point::max()
+    // 之后插入更早到期的定时器时会调用唤醒回调
+    Clock::time_point PrepareWakeup();
+
+    // 唤醒回调，由驱动方设置，在持有时间轮锁时调用，只能投递任务
+    void SetWakeupHandler(std::function<void()> handler);
+
+    // 已启动的定时器数
+    size_t Size() const;
+
+private:
+    static constexpr size_t kLevels = 4;
+    static constexpr size_t kSlotBits = 8;
+    static constexpr size_t kSlots = size_t{1} << kSlotBits;
+    static constexpr uint64_t kSlotMask = kSlots - 1;
+    static constexpr uint64_t kMaxDelta = (uint64_t{1} << (kLevels * kSlotBits)) - 1;
+    static constexpr uint64_t kNoWakeup = UINT64_MAX;
+
+    struct OwnedTimer;
+
+    uint64_t TickAtOrAfter(Clock::time_point time) const;
+    Clock::time_point TimeOfTick(uint64_t tick) const;
+
+    void Link(Timer& timer, uint64_t expiry);
+    void Unlink(Timer& timer);
+    void Cascade(size_t level, size_t index);
+    void Fire(Timer& timer, uint64_t tick, std::unique_lock<std::mutex>& lock);
+
+private:
+    Clock::time_point origin_;
+
+    mutable std::mutex mutex_;
+    Timer* slots_[kLevels][kSlots] = {};
+    Timer* expired_ = nullptr;  // 当前tick已到期、等待运行回调的定时器
+    uint64_t next_tick_ = 0;  // 下一个要处理的tick
+    size_t size_ = 0;
+
+    // 驱动方已安排的唤醒tick
+    uint64_t wakeup_tick_ = kNoWakeup;
+    std::function<void()> wakeup_handler_;
+
+    // 正在运行回调的定时器，Cancel据此等待
+    Timer* firing_ = nullptr;
+    std::thread::id firing_thread_;
+    size_t firing_waiters_ = 0;
+    std::condition_variable firing_done_;
+};
+
+} // namespace ai_backend::core::async
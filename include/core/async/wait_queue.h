@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <memory>
+
+#include <boost/asio/any_io_executor.hpp>
+
+#include "core/async/deadline.h"
+#include "core/async/task.h"
+
+namespace ai_backend::core::async::detail {
+
+// 协程同步原语中挂起的协程
+// 唤醒和截止时间到期通过state竞争，只有成功的一方恢复协程。截止时间的回调不访问所属原语，
+// 回调与原语析构并发也是安全的；被取消的节点留在队列中，出队时跳过。
+struct Waiter {
+    enum State : int { kWaiting, kResumed, kCancelled };
+
+    // 唤醒等待者，返回false表示已被取消
+    bool TryResume() {
+        int expected = kWaiting;
+        return state.compare_exchange_strong(expected, kResumed, std::memory_order_acq_rel);
+    }
+
+    bool TryCancel() {
+        int expected = kWaiting;
+        return state.compare_exchange_strong(expected, kCancelled, std::memory_order_acq_rel);
+    }
+
+    bool IsCancelled() const { return state.load(std::memory_order_acquire) == kCancelled; }
+
+    // 投递到executor上恢复，没有executor时在当前线程直接恢复
+    void Resume();
+
+    // 等待者恢复时使用的执行器：挂起时所在的执行器 (如会话strand)，
+    // 协程不在任何执行器上运行时退回到原语构造时的executor
+    static boost::asio::any_io_executor HomeExecutor(const boost::asio::any_io_executor& fallback) {
+        auto executor = CurrentExecutor();
+        return executor ? executor : fallback;
+    }
+
+    std::coroutine_handle<> handle;
+    boost::asio::any_io_executor executor;
+    std::atomic<int> state{kWaiting};
+    Deadline::Registration registration;
+};
+
+// 挂起协程的先进先出队列，由所属原语的锁保护
+class WaitQueue {
+public:
+    // 加入队列，顺带清理已取消的节点
+    void Push(std::shared_ptr<Waiter> waiter);
+
+    // 取出最早的仍在等待的协程并标记为已唤醒，由调用方在锁外Resume；没有时返回空
+    std::shared_ptr<Waiter> PopWaiting();
+
+    // 取出所有仍在等待的协程并标记为已唤醒
+    std::deque<std::shared_ptr<Waiter>> PopAllWaiting();
+
+    // 仍在等待的协程数
+    size_t CountWaiting() const;
+
+private:
+    static constexpr size_t kMinCompactSize = 64;
+
+    std::deque<std::shared_ptr<Waiter>> waiters_;
+    size_t compact_threshold_ = kMinCompactSize;
+};
+
+// 挂起等待器的公共部分：在持有原语锁时入队，锁外注册截止时间
+// 截止时间已过时回调立即执行，协程随即被恢复，调用方之后只能使用局部变量并持有waiter的副本
+void RegisterDeadline(const std::shared_ptr<Waiter>& waiter, const Deadline& deadline);
+
+} // namespace ai_backend::core::async::detail
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <boost/asio/any_io_executor.hpp>
+
+#include "core/async/deadline.h"
+#include "core/async/task.h"
+
+namespace ai_backend::core::async {
+
+namespace detail {
+
+// void结果在元组和variant中以monostate占位
+template <typename T>
+using NonVoid = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+// 等待计数归零后恢复等待者
+// 计数比子任务数多1，由await_suspend在启动全部子任务后扣除，
+// 子任务在启动过程中就全部完成时不挂起，避免在await_suspend返回前被恢复。
+// 等待者投递回挂起时所在的执行器 (如会话strand)，而不是在最后完成的子任务线程上恢复
+class JoinCounter {
+public:
+    explicit JoinCounter(size_t count) : remaining_(count + 1) {}
+
+    // 子任务完成时调用
+    void Arrive() {
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ResumeAt(executor_, awaiting_);
+        }
+    }
+
+    template <typename Start>
+    auto Wait(Start start) {
+        struct Awaiter {
+            JoinCounter* counter;
+            Start start;
+
+            bool await_ready() const noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> handle) {
+                counter->awaiting_ = handle;
+                counter->executor_ = CurrentExecutor();
+                start();
+                return counter->remaining_.fetch_sub(1, std::memory_order_acq_rel) != 1;
+            }
+
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{this, std::move(start)};
+    }
+
+private:
+    std::atomic<size_t> remaining_;
+    std::coroutine_handle<> awaiting_;
+    boost::asio::any_io_executor executor_;
+};
+
+// WhenAll各子任务共享的状态
+struct WhenAllState {
+    WhenAllState(size_t count, Deadline cancel) : join(count), cancel(std::move(cancel)) {}
+
+    // 记录第一个异常并取消其余子任务
+    void Fail(std::exception_ptr exception) {
+        if (!failed.exchange(true, std::memory_order_acq_rel)) {
+            first_exception = std::move(exception);
+            cancel.Cancel();
+        }
+    }
+
+    JoinCounter join;
+    Deadline cancel;
+    std::atomic<bool> failed{false};
+    std::exception_ptr first_exception;
+};
+
+template <typename T>
+Task<void> RunWhenAllChild(WhenAllState& state, Task<T> task, std::optional<NonVoid<T>>& slot) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await task;
+            slot.emplace();
+        } else {
+            slot.emplace(co_await task);
+        }
+    } catch (...) {
+        state.Fail(std::current_exception());
+    }
+    state.join.Arrive();
+}
+
+} // namespace detail
+
+// 在executor上并发运行所有子任务，全部结束后按参数顺序返回结果，void结果为monostate
+// 某个子任务抛出异常时取消cancel，待其余子任务结束后重新抛出第一个异常。
+// 子任务总是运行到结束才返回，可以安全引用调用方协程帧中的数据；
+// 需要提前中止的子任务应接收cancel (或由其派生的截止时间) 并在到期时尽快返回。
+template <typename... T>
+Task<std::tuple<detail::NonVoid<T>...>> WhenAll(boost::asio::any_io_executor executor, Deadline cancel,
+                                                Task<T>... tasks) {
+    detail::WhenAllState state(sizeof...(T), std::move(cancel));
+    std::tuple<std::optional<detail::NonVoid<T>>...> slots;
+
+    co_await state.join.Wait([&]() {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (Spawn(executor, detail::RunWhenAllChild(state, std::move(tasks), std::get<I>(slots))), ...);
+        }(std::index_sequence_for<T...>{});
+    });
+
+    if (state.first_exception) {
+        std::rethrow_exception(state.first_exception);
+    }
+    co_return std::apply([](auto&... slot) {
+        return std::tuple<detail::NonVoid<T>...>(std::move(*slot)...);
+    }, slots);
+}
+
+template <typename... T>
+Task<std::tuple<detail::NonVoid<T>...>> WhenAll(boost::asio::any_io_executor executor, Task<T>... tasks) {
+    return WhenAll(std::move(executor), Deadline{}, std::move(tasks)...);
+}
+
+// 同类型子任务的WhenAll，结果与输入顺序一致
+template <typename T>
+Task<std::vector<detail::NonVoid<T>>> WhenAll(boost::asio::any_io_executor executor, Deadline cancel,
+                                              std::vector<Task<T>> tasks) {
+    detail::WhenAllState state(tasks.size(), std::move(cancel));
+    std::vector<std::optional<detail::NonVoid<T>>> slots(tasks.size());
+
+    co_await state.join.Wait([&]() {
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            Spawn(executor, detail::RunWhenAllChild(state, std::move(tasks[i]), slots[i]));
+        }
+    });
+
+    if (state.first_exception) {
+        std::rethrow_exception(state.first_exception);
+    }
+    std::vector<detail::NonVoid<T>> results;
+    results.reserve(slots.size());
+    for (auto& slot : slots) {
+        results.push_back(std::move(*slot));
+    }
+    co_return results;
+}
+
+template <typename T>
+Task<std::vector<detail::NonVoid<T>>> WhenAll(boost::asio::any_io_executor executor, std::vector<Task<T>> tasks) {
+    return WhenAll(std::move(executor), Deadline{}, std::move(tasks));
+}
+
+} // namespace ai_backend::core::async
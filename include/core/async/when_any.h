@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <boost/asio/any_io_executor.hpp>
+
+#include "core/async/deadline.h"
+#include "core/async/task.h"
+#include "core/async/when_all.h"
+
+namespace ai_backend::core::async {
+
+namespace detail {
+
+// WhenAny各子任务共享的状态，Result为最终返回值的类型
+template <typename Result>
+struct WhenAnyState {
+    WhenAnyState(size_t count, Deadline cancel) : join(count), cancel(std::move(cancel)) {}
+
+    // 第一个结束的子任务返回true，负责写入结果并取消其余子任务
+    bool TryWin() {
+        if (decided.exchange(true, std::memory_order_acq_rel)) {
+            return false;
+        }
+        cancel.Cancel();
+        return true;
+    }
+
+    JoinCounter join;
+    Deadline cancel;
+    std::atomic<bool> decided{false};
+    std::optional<Result> result;
+    std::exception_ptr exception;
+};
+
+template <size_t I, typename Result, typename T>
+Task<void> RunWhenAnyChild(WhenAnyState<Result>& state, Task<T> task) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await task;
+            if (state.TryWin()) {
+                state.result.emplace(std::in_place_index<I>);
+            }
+        } else {
+            auto value = co_await task;
+            if (state.TryWin()) {
+                state.result.emplace(std::in_place_index<I>, std::move(value));
+            }
+        }
+    } catch (...) {
+        if (state.TryWin()) {
+            state.exception = std::current_exception();
+        }
+    }
+    state.join.Arrive();
+}
+
+template <typename T>
+Task<void> RunWhenAnyChild(WhenAnyState<std::pair<size_t, NonVoid<T>>>& state, Task<T> task, size_t index) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await task;
+            if (state.TryWin()) {
+                state.result.emplace(index, std::monostate{});
+            }
+        } else {
+            auto value = co_await task;
+            if (state.TryWin()) {
+                state.result.emplace(index, std::move(value));
+            }
+        }
+    } catch (...) {
+        if (state.TryWin()) {
+            state.exception = std::current_exception();
+        }
+    }
+    state.join.Arrive();
+}
+
+} // namespace detail
+
+// 在executor上并发运行所有子任务，以第一个结束的子任务为准：
+// 返回其结果 (variant::index()为子任务下标) 或重新抛出其异常，同时取消cancel。
+// 与WhenAll一样，其余子任务结束后才返回，子任务可以引用调用方协程帧中的数据；
+// 子任务必须观察cancel (或由其派生的截止时间) 才能在落选后尽快返回。
+template <typename... T>
+Task<std::variant<detail::NonVoid<T>...>> WhenAny(boost::asio::any_io_executor executor, Deadline cancel,
+                                                  Task<T>... tasks) {
+    static_assert(sizeof...(T) > 0, "WhenAny requires at least one task");
+
+    using Result = std::variant<detail::NonVoid<T>...>;
+    detail::WhenAnyState<Result> state(sizeof...(T), std::move(cancel));
+
+    co_await state.join.Wait([&]() {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (Spawn(executor, detail::RunWhenAnyChild<I>(state, std::move(tasks))), ...);
+        }(std::index_sequence_for<T...>{});
+    });
+
+    if (state.exception) {
+        std::rethrow_exception(state.exception);
+    }
+    co_return std::move(*state.result);
+}
+
+// 同类型子任务的WhenAny，返回(下标, 结果)，tasks不能为空
+template <typename T>
+Task<std::pair<size_t, detail::NonVoid<T>>> WhenAny(boost::asio::any_io_executor executor, Deadline cancel,
+                                                    std::vector<Task<T>> tasks) {
+    if (tasks.empty()) {
+        throw std::invalid_argument("WhenAny requires at least one task");
+    }
+
+    detail::WhenAnyState<std::pair<size_t, detail::NonVoid<T>>> state(tasks.size(), std::move(cancel));
+
+    co_await state.join.Wait([&]() {
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            Spawn(executor, detail::RunWhenAnyChild(state, std::move(tasks[i]), i));
+        }
+    });
+
+    if (state.exception) {
+        std::rethrow_exception(state.exception);
+    }
+    co_return std::move(*state.result);
+}
+
+} // namespace ai_backend::core::async
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace ai_backend::core::async {
+
+// Chase-Lev工作窃取双端队列 (按Lê等人针对弱内存模型的实现)
+// 所有者线程在底部Push/Pop (LIFO，缓存友好)，其他线程从顶部Steal (FIFO)。
+// 只存放指针；容量不足时所有者把环形数组扩大一倍，旧数组保留到析构，
+// 因为窃取者可能仍在读取它。
+template <typename T>
+class WorkStealingDeque {
+    static_assert(std::is_pointer_v<T>, "WorkStealingDeque stores pointers");
+
+public:
+    explicit WorkStealingDeque(size_t capacity = 256) {
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        arrays_.push_back(std::make_unique<Array>(rounded));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // 仅所有者线程调用
+    void Push(T item) {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_acquire);
+        Array* array = array_.load(std::memory_order_relaxed);
+
+        if (bottom - top > static_cast<int64_t>(array->capacity) - 1) {
+            array = Grow(array, top, bottom);
+        }
+
+        array->Put(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    // 仅所有者线程调用，队列为空时返回nullptr
+    T Pop() {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* array = array_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            // 已空
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T item = array->Get(bottom);
+        if (top == bottom) {
+            // 最后一个元素，与窃取者竞争
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // 任意线程调用，队列为空或与其他线程竞争失败时返回nullptr
+    T Steal() {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+        if (top >= bottom) {
+            return nullptr;
+        }
+
+        Array* array = array_.load(std::memory_order_acquire);
+        T item = array->Get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    // 近似元素数，只用于统计和判断是否有任务
+    size_t Size() const {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    bool Empty() const {
+        return Size() == 0;
+    }
+
+private:
+    struct Array {
+        explicit Array(size_t capacity)
+            : capacity(capacity), mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+
+        T Get(int64_t index) const {
+            return slots[static_cast<size_t>(index) & mask].load(std::memory_order_relaxed);
+        }
+
+        void Put(int64_t index, T item) {
+            slots[static_cast<size_t>(index) & mask].store(item, std::memory_order_relaxed);
+        }
+
+        size_t capacity;
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    Array* Grow(Array* array, int64_t top, int64_t bottom) {
+        auto grown = std::make_unique<Array>(array->capacity * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            grown->Put(i, array->Get(i));
+        }
+        Array* result = grown.get();
+        arrays_.push_back(std::move(grown));
+        array_.store(result, std::memory_order_release);
+        return result;
+    }
+
+    // top和bottom分别由窃取者和所有者频繁写入，放在不同的缓存行
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    alignas(64) std::atomic<Array*> array_{nullptr};
+
+    // 所有用过的数组，只由所有者线程修改
+    std::vector<std::unique_ptr<Array>> arrays_;
+};
+
+} // namespace ai_backend::core::async
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/io_context.hpp>
+#include <libpq-fe.h>
+
+#include "core/async/deadline.h"
+#include "core/async/task.h"
+#include "core/db/prepared_statement.h"
+#include "core/db/query_params.h"
+#include "core/db/query_result.h"
+
+namespace ai_backend::core::db {
+
+// 非阻塞的PostgreSQL连接
+// 基于libpq的异步接口 (PQconnectPoll、PQsendQueryParams、PQconsumeInput)：连接的套接字注册到
+// io_context，发送查询后协程挂起等待套接字可读，等待期间不占用线程；套接字就绪后协程回到它挂起时
+// 所在的执行器 (如会话strand) 继续，调用方可以运行在其他io_context上。
+// 套接字以generic::stream_protocol::socket而不是posix::stream_descriptor注册，等待可读时用MSG_PEEK
+// 接收代替async_wait，不会错过注册等待之前到达的数据。
+// 同一时刻只能执行一条语句，由连接池保证每个连接只借给一个协程。
+// 截止时间到期时在阻塞任务池上向服务端发送取消请求 (PQcancel)，并关闭套接字的读写，
+// 等待中的语句抛出DeadlineExceeded，连接随之作废。
+class Connection : public std::enable_shared_from_this<Connection> {
+public:
+    // 建立连接，TLS握手和认证由套接字就绪事件驱动
+    // 运行时已启动时PQconnectStart (其中包括主机名解析) 在阻塞任务池上执行
+    static async::Task<std::shared_ptr<Connection>> Connect(boost::asio::io_context& io_context,
+                                                            std::string conninfo,
+                                                            async::Deadline deadline = {});
+
+    // 阻塞建立连接，只在启动时 (IO线程之外) 使用
+    static std::shared_ptr<Connection> ConnectBlocking(boost::asio::io_context& io_context,
+                                                       const std::string& conninfo);
+
+    ~Connection();
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    // 执行一条语句 (扩展查询协议，参数按文本格式绑定)
+    // 语句执行失败时抛出DbError，连接仍可使用；连接断开时抛出DbError并作废连接
+    // 截止时间没有默认值，调用方传入请求的截止时间；确实不需要时显式传入Deadline()
+    async::Task<QueryResult> Query(std::string sql, QueryParams params, async::Deadline deadline);
+
+    // 执行预处理语句，在这个连接上第一次执行时先准备
+    async::Task<QueryResult> Query(const PreparedStatement& statement, QueryParams params,
+                                   async::Deadline deadline);
+
+    // 连接已断开或被截止时间中断，不能继续使用
+    bool IsBroken() const;
+
+    // 处于未结束的事务中 (包括出错后等待回滚的事务)
+    bool InTransaction() const;
+
+    boost::asio::io_context& GetIoContext() const { return io_context_; }
+
+private:
+    using Socket = boost::asio::generic::stream_protocol::socket;
+
+    class Operation;
+
+    Connection(boost::asio::io_context& io_context, PGconn* conn);
+
+    // 驱动PQconnectPoll直到连接建立
+    async::Task<void> CompleteConnect(async::Deadline deadline);
+
+    // 连接建立后切换到非阻塞模式，取得取消请求需要的信息
+    void OnConnected();
+
+    // 把libpq当前的套接字 (重新) 注册到io_context；连接过程中libpq可能换用新的套接字
+    void AttachSocket();
+
+    // 从io_context注销套接字，描述符仍由libpq持有
+    void DetachSocket();
+
+    // 等待套接字可读，数据已经到达时不挂起
+    async::Task<void> WaitReadable();
+
+    // 等待套接字可写
+    async::Task<void> WaitWritable();
+
+    // 发送缓冲区中剩余的数据，然后读取语句的结果
+    async::Task<QueryResult> ReceiveResult();
+
+    // 截止时间到期时由Operation注册的回调调用，可能在任意线程
+    void Interrupt(uint64_t operation);
+
+    // 发送或接收失败，作废连接并抛出异常
+    [[noreturn]] void Fail(const char* what);
+
+    // 连接已作废或截止时间已到期时抛出异常
+    void CheckUsable(const async::Deadline& deadline) const;
+
+private:
+    boost::asio::io_context& io_context_;
+    PGconn* conn_;
+    Socket socket_;
+    char peek_byte_ = 0;
+
+    // 连接建立后取得，PQcancel可以在其他线程使用
+    std::shared_ptr<PGcancel> cancel_;
+
+    // 已在这个连接上准备的语句名
+    std::unordered_set<std::string> prepared_;
+
+    // 保护socket_fd_和operation_，与Interrupt同步
+    std::mutex mutex_;
+    int socket_fd_ = -1;
+    // 正在进行的操作编号，0表示空闲；迟到的截止时间回调不会中断后续的操作
+    uint64_t operation_ = 0;
+    uint64_t next_operation_ = 0;
+
+    std::atomic<bool> interrupted_{false};
+    std::atomic<bool> broken_{false};
+};
+
+} // namespace ai_backend::core::db
@@ -2,45 +2,98 @@
 
 #include <atomic>
 #include <chrono>
-#include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
-#include <thread>
-#include <unordered_set>
 
-#include <pqxx/pqxx>
+#include "core/async/async_semaphore.h"
+#include "core/async/deadline.h"
 #include "core/async/task.h"
+#include "core/async/timer_wheel.h"
+#include "core/db/connection.h"
 
 namespace ai_backend::core::db {
 
+class ConnectionPool;
+class Transaction;
+
+// 从连接池借出的连接，析构时归还
+// 连接仍处于事务中时 (例如Transaction未提交就析构)，连接池先异步回滚再放回空闲队列；
+// 已断开或被截止时间中断的连接直接关闭，下一个取得许可的请求会新建连接。
+class PooledConnection {
+public:
+    PooledConnection() = default;
+    PooledConnection(ConnectionPool* pool, std::shared_ptr<Connection> connection)
+        : pool_(pool), connection_(std::move(connection)) {}
+
+    ~PooledConnection() { Release(); }
+
+    PooledConnection(PooledConnection&& other) noexcept
+        : pool_(std::exchange(other.pool_, nullptr)), connection_(std::move(other.connection_)) {}
+
+    PooledConnection& operator=(PooledConnection&& other) noexcept {
+        if (this != &other) {
+            Release();
+            pool_ = std::exchange(other.pool_, nullptr);
+            connection_ = std::move(other.connection_);
+        }
+        return *this;
+    }
+
+    PooledConnection(const PooledConnection&) = delete;
+    PooledConnection& operator=(const PooledConnection&) = delete;
+
+    Connection* operator->() const { return connection_.get(); }
+    Connection& operator*() const { return *connection_; }
+    explicit operator bool() const { return connection_ != nullptr; }
+
+    // 提前归还
+    void Release();
+
+private:
+    ConnectionPool* pool_ = nullptr;
+    std::shared_ptr<Connection> connection_;
+};
+
 // 数据库连接池类
+// 连接是非阻塞的libpq连接 (见Connection)，分布在运行时的各io_context上，借出时优先选择与调用方
+// 在同一io_context上的连接；借出连接和执行语句都是可等待的，等待空闲连接和等待查询结果都不占用IO线程，
+// 调用方协程总是回到它挂起时所在的执行器继续。
+// 各入口都要求传入截止时间 (通常是request.deadline)，到期时等待和执行中的语句一并中止。
+//     auto result = co_await ConnectionPool::GetInstance().Query("SELECT ... WHERE id = $1", {id}, deadline);
 class ConnectionPool {
 public:
     // 单例访问
     static ConnectionPool& GetInstance();
-    
-    // 初始化连接池
-    bool Initialize(const std::string& connection_string, 
-                  size_t min_connections = 5, 
+
+    // 初始化连接池，同步建立min_connections个连接，在IO线程之外调用
+    bool Initialize(const std::string& connection_string,
+                  size_t min_connections = 5,
                   size_t max_connections = 20);
-    
+
     // 析构函数
     ~ConnectionPool();
-    
-    // 获取连接（同步版本）
-    std::shared_ptr<pqxx::connection> GetConnection();
-    
-    // 获取连接（异步版本）
-    async::Task<std::shared_ptr<pqxx::connection>> GetConnectionAsync();
-    
-    // 释放连接
-    void ReleaseConnection(std::shared_ptr<pqxx::connection> connection);
-    
+
+    // 设置等待空闲连接和建立新连接的默认时限，调用方没有截止时间时使用
+    void SetAcquireTimeout(std::chrono::milliseconds timeout);
+
+    // 借出连接
+    // 没有空闲连接且已达上限时挂起等待归还的连接，截止时间到期时抛出DeadlineExceeded；
+    // 未设置截止时间时等待以acquire_timeout为限
+    async::Task<PooledConnection> Acquire(async::Deadline deadline);
+
+    // 借出一个连接执行一条语句后立即归还，deadline同时限制等待连接和执行语句
+    async::Task<QueryResult> Query(std::string sql, QueryParams params, async::Deadline deadline);
+    async::Task<QueryResult> Query(const PreparedStatement& statement, QueryParams params,
+                                   async::Deadline deadline);
+
+    // 借出一个连接并开始事务，deadline限制事务中的每条语句
+    async::Task<Transaction> BeginTransaction(async::Deadline deadline);
+
     // 关闭所有连接
     void CloseAll();
-    
+
     // 获取连接池状态
     struct PoolStats {
         size_t active_connections;
@@ -50,47 +103,70 @@ public:
     PoolStats GetStats() const;
 
 private:
+    friend class PooledConnection;
+
+    // 空闲连接和放回空闲队列的时间
+    struct IdleConnection {
+        std::shared_ptr<Connection> connection;
+        std::chrono::steady_clock::time_point since;
+    };
+
     // 私有构造函数
     ConnectionPool();
-    
+
     // 禁止拷贝和移动
     ConnectionPool(const ConnectionPool&) = delete;
     ConnectionPool& operator=(const ConnectionPool&) = delete;
     ConnectionPool(ConnectionPool&&) = delete;
     ConnectionPool& operator=(ConnectionPool&&) = delete;
-    
-    // 创建新连接
-    std::shared_ptr<pqxx::connection> CreateConnection();
-    
-    // 初始化连接池
-    void InitializePool();
-    
-    // 监控空闲连接
-    void MonitorConnections();
-    
-    // 测试连接是否有效
-    bool TestConnection(pqxx::connection& conn);
+
+    // 在调用方所在的io_context上建立新连接，调用方不在io_context上运行时轮流选择
+    async::Task<std::shared_ptr<Connection>> CreateConnection(async::Deadline deadline);
+
+    // 已取得许可后计入借出的连接，取出最近归还的空闲连接 (优先与调用方在同一io_context上的)，没有时返回空
+    std::shared_ptr<Connection> TakeIdleConnection();
+
+    // PooledConnection归还连接；仍在事务中的连接先回滚
+    void ReleaseConnection(std::shared_ptr<Connection> connection);
+
+    // 回滚未结束的事务后归还
+    async::Task<void> RollbackAndReturn(std::shared_ptr<Connection> connection);
+
+    // 放回空闲队列 (reuse为false时关闭) 并归还许可
+    void ReturnConnection(std::shared_ptr<Connection> connection, bool reuse);
+
+    // 关闭闲置超时的连接，检查其余空闲连接，并补足最少连接数
+    async::Task<void> MonitorConnections();
+
+    // 安排下一次检查
+    void ScheduleMonitor();
 
 private:
     std::string connection_string_;
     size_t min_connections_;
     size_t max_connections_;
-    
-    // 连接池
-    std::deque<std::shared_ptr<pqxx::connection>> idle_connections_;
-    std::unordered_set<std::shared_ptr<pqxx::connection>> active_connections_;
-    
+
+    // 空闲连接，队尾是最近归还的
+    std::deque<IdleConnection> idle_connections_;
+    size_t active_connections_ = 0;
+
+    // 每个借出的连接占用一个许可，许可数即最大连接数；异步等待者在信号量上挂起，不占用线程，
+    // 被唤醒时回到各自的执行器
+    async::AsyncSemaphore permits_{0};
+
     // 连接管理
     mutable std::mutex mutex_;
-    std::condition_variable condition_;
     std::atomic<bool> shutdown_;
-    
-    // 连接监控
-    std::thread monitor_thread_;
+
     std::chrono::seconds idle_timeout_{300}; // 默认5分钟
-    
+    std::chrono::milliseconds acquire_timeout_{5000}; // 默认5秒
+
     // 统计信息
     std::atomic<size_t> pending_requests_{0};
+
+    // 连接监控，挂在运行时第0个io_context的时间轮上，不再占用单独的线程；
+    // 最后声明，析构时最先取消
+    async::TimerWheel::Timer monitor_timer_;
 };
 
-} // namespace ai_backend::core::db
\ No newline at end of file
+} // namespace ai_backend::core::db
@@ -1,51 +1,26 @@
 #pragma once
 
-#include <memory>
 #include <string>
-#include <unordered_map>
-#include <vector>
-#include <pqxx/pqxx>
+#include <utility>
 
 namespace ai_backend::core::db {
 
+// 命名的预处理语句
+// 每个连接在第一次执行时发送一次Parse (PQsendPrepare)，记住已准备的名称，之后只发送Bind/Execute，
+// 省去服务端重复的解析和规划。通常定义为静态对象，名称在进程内唯一：
+//     static const PreparedStatement kGetMessage("get_message", "SELECT ... FROM messages WHERE id = $1");
+//     auto result = co_await pool.Query(kGetMessage, {message_id}, deadline);
 class PreparedStatement {
 public:
-    PreparedStatement(std::shared_ptr<pqxx::connection> conn, const std::string& name, const std::string& sql);
-    
-    template<typename... Args>
-    pqxx::result Execute(Args&&... args) {
-        pqxx::work txn(*conn_);
-        auto result = txn.exec_prepared(name_, std::forward<Args>(args)...);
-        txn.commit();
-        return result;
-    }
-    
-    template<typename... Args>
-    pqxx::result ExecuteWithTxn(pqxx::work& txn, Args&&... args) {
-        return txn.exec_prepared(name_, std::forward<Args>(args)...);
-    }
-    
-    std::string GetName() const;
-    std::string GetSQL() const;
-    
+    PreparedStatement(std::string name, std::string sql)
+        : name_(std::move(name)), sql_(std::move(sql)) {}
+
+    const std::string& GetName() const { return name_; }
+    const std::string& GetSQL() const { return sql_; }
+
 private:
-    std::shared_ptr<pqxx::connection> conn_;
     std::string name_;
     std::string sql_;
 };
 
-class PreparedStatementCache {
-public:
-    PreparedStatementCache(std::shared_ptr<pqxx::connection> conn);
-    
-    std::shared_ptr<PreparedStatement> GetOrCreate(const std::string& name, const std::string& sql);
-    bool HasStatement(const std::string& name) const;
-    void Clear();
-    
-private:
-    std::shared_ptr<pqxx::connection> conn_;
-    std::unordered_map<std::string, std::shared_ptr<PreparedStatement>> statements_;
-    mutable std::mutex mutex_;
-};
-
-} // namespace ai_backend::core::db
\ No newline at end of file
+} // namespace ai_backend::core::db
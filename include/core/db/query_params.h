@@ -0,0 +1,99 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace ai_backend::core::db {
+
+// 单个查询参数，按PostgreSQL的文本格式表示
+// 只作为QueryParams构造和Add的实参使用：字符串参数引用调用方的数据，QueryParams立即复制。
+class QueryParam {
+public:
+    // SQL NULL
+    QueryParam(std::nullptr_t) noexcept : kind_(Kind::kNull) {}
+    QueryParam(std::nullopt_t) noexcept : kind_(Kind::kNull) {}
+
+    QueryParam(const char* value) noexcept : QueryParam(std::string_view(value)) {}
+    QueryParam(std::string_view value) noexcept
+        : kind_(Kind::kText), text_(value.data()), size_(value.size()) {}
+
+    template <typename Allocator>
+    QueryParam(const std::basic_string<char, std::char_traits<char>, Allocator>& value) noexcept
+        : QueryParam(std::string_view(value.data(), value.size())) {}
+
+    QueryParam(bool value) noexcept : QueryParam(std::string_view(value ? "t" : "f")) {}
+
+    template <typename T,
+              std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+                               !std::is_same_v<T, char>, int> = 0>
+    QueryParam(T value) noexcept : kind_(Kind::kNumber) {
+        size_ = static_cast<size_t>(std::to_chars(number_, number_ + sizeof(number_), value).ptr - number_);
+    }
+
+    // 空的optional作为NULL
+    template <typename T>
+    QueryParam(const std::optional<T>& value) : kind_(Kind::kNull) {
+        if (value) {
+            *this = QueryParam(*value);
+        }
+    }
+
+    bool IsNull() const noexcept { return kind_ == Kind::kNull; }
+
+    std::string_view GetText() const noexcept {
+        return kind_ == Kind::kNumber ? std::string_view(number_, size_) : std::string_view(text_, size_);
+    }
+
+private:
+    enum class Kind : uint8_t { kNull, kText, kNumber };
+
+    Kind kind_;
+    const char* text_ = nullptr;
+    size_t size_ = 0;
+    // 数字的文本保存在对象内部，最长为double的最短往返表示
+    char number_[32];
+};
+
+// 查询参数列表，对应SQL中的$1、$2...
+// 参数值连同结尾的空字符复制到一块连续的存储中，从数据库层的TrackedResource分配 (kDb标签)，
+// 发送时直接把各参数的指针交给libpq，不再逐个分配字符串。
+//     co_await pool.Query("SELECT ... WHERE id = $1 LIMIT $2", {dialog_id, page_size}, deadline);
+class QueryParams {
+public:
+    QueryParams();
+    QueryParams(std::initializer_list<QueryParam> params);
+
+    QueryParams(QueryParams&&) noexcept = default;
+    QueryParams& operator=(QueryParams&&) noexcept = default;
+    QueryParams(const QueryParams&) = delete;
+    QueryParams& operator=(const QueryParams&) = delete;
+
+    // 追加一个参数，用于按条件拼接的SQL
+    void Add(const QueryParam& param);
+
+    size_t Size() const { return offsets_.size(); }
+    bool Empty() const { return offsets_.empty(); }
+
+    // 第index个参数的文本，NULL时返回nullptr；指针在下一次Add之前有效
+    const char* GetValue(size_t index) const;
+
+    // 按顺序写入所有参数的指针，供PQsendQueryParams使用
+    void CollectValues(std::pmr::vector<const char*>& values) const;
+
+private:
+    // NULL参数的偏移
+    static constexpr size_t kNull = static_cast<size_t>(-1);
+
+    std::pmr::string storage_;
+    std::pmr::vector<size_t> offsets_;
+};
+
+} // namespace ai_backend::core::db
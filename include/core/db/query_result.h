@@ -0,0 +1,184 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <libpq-fe.h>
+
+namespace ai_backend::core::db {
+
+// 数据库错误：连接失败、SQL执行失败或结果类型转换失败
+class DbError : public std::runtime_error {
+public:
+    explicit DbError(const std::string& what, std::string sql_state = {})
+        : std::runtime_error(what), sql_state_(std::move(sql_state)) {}
+
+    // 服务端返回的SQLSTATE (如唯一约束冲突为23505)，连接层面的错误为空
+    const std::string& GetSqlState() const { return sql_state_; }
+
+private:
+    std::string sql_state_;
+};
+
+namespace detail {
+
+template <typename T>
+struct IsOptional : std::false_type {};
+
+template <typename T>
+struct IsOptional<std::optional<T>> : std::true_type {};
+
+[[noreturn]] void ThrowConversionError(std::string_view text, const char* type);
+
+} // namespace detail
+
+// 查询结果，持有libpq的PGresult
+// 结果中的字段直接引用PGresult的缓冲区，View返回的string_view在QueryResult销毁前有效。
+// PGresult由libpq分配，大小 (PQresultMemorySize) 记入数据库层的内存统计 (kDb标签)。
+class QueryResult {
+public:
+    // 单个字段，文本格式
+    class Field {
+    public:
+        Field(const PGresult* result, int row, int column) : result_(result), row_(row), column_(column) {}
+
+        bool IsNull() const { return PQgetisnull(result_, row_, column_) != 0; }
+
+        // NULL时为空串
+        std::string_view View() const {
+            return std::string_view(PQgetvalue(result_, row_, column_),
+                                    static_cast<size_t>(PQgetlength(result_, row_, column_)));
+        }
+
+        // 转换为T：字符串、bool、整数、浮点数，或它们的optional (NULL为nullopt)
+        // 非optional类型遇到NULL或无法解析时抛出DbError
+        template <typename T>
+        T As() const {
+            if constexpr (detail::IsOptional<T>::value) {
+                if (IsNull()) {
+                    return std::nullopt;
+                }
+                return As<typename T::value_type>();
+            } else {
+                if (IsNull()) {
+                    throw DbError("Unexpected NULL in column " + std::to_string(column_));
+                }
+                auto text = View();
+                if constexpr (std::is_same_v<T, std::string>) {
+                    return std::string(text);
+                } else if constexpr (std::is_same_v<T, std::string_view>) {
+                    return text;
+                } else if constexpr (std::is_same_v<T, bool>) {
+                    if (text == "t" || text == "true") {
+                        return true;
+                    }
+                    if (text == "f" || text == "false") {
+                        return false;
+                    }
+                    detail::ThrowConversionError(text, "bool");
+                } else if constexpr (std::is_arithmetic_v<T>) {
+                    T value{};
+                    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+                    if (ec != std::errc() || end != text.data() + text.size()) {
+                        detail::ThrowConversionError(text, std::is_integral_v<T> ? "integer" : "number");
+                    }
+                    return value;
+                } else {
+                    static_assert(std::is_same_v<T, std::string>, "Unsupported field type");
+                }
+            }
+        }
+
+    private:
+        const PGresult* result_;
+        int row_;
+        int column_;
+    };
+
+    // 一行
+    class Row {
+    public:
+        Row(const PGresult* result, int row) : result_(result), row_(row) {}
+
+        Field operator[](size_t column) const { return Field(result_, row_, static_cast<int>(column)); }
+        size_t size() const { return static_cast<size_t>(PQnfields(result_)); }
+
+    private:
+        const PGresult* result_;
+        int row_;
+    };
+
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Row;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Row;
+
+        Iterator(const PGresult* result, int row) : result_(result), row_(row) {}
+
+        Row operator*() const { return Row(result_, row_); }
+        Iterator& operator++() {
+            ++row_;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator copy = *this;
+            ++row_;
+            return copy;
+        }
+        bool operator==(const Iterator& other) const { return row_ == other.row_; }
+        bool operator!=(const Iterator& other) const { return row_ != other.row_; }
+
+    private:
+        const PGresult* result_;
+        int row_;
+    };
+
+    QueryResult() = default;
+
+    // 接管result
+    explicit QueryResult(PGresult* result);
+
+    ~QueryResult();
+
+    QueryResult(QueryResult&& other) noexcept;
+    QueryResult& operator=(QueryResult&& other) noexcept;
+    QueryResult(const QueryResult&) = delete;
+    QueryResult& operator=(const QueryResult&) = delete;
+
+    // 行数
+    size_t size() const { return result_ ? static_cast<size_t>(PQntuples(result_)) : 0; }
+    bool empty() const { return size() == 0; }
+
+    Row operator[](size_t row) const { return Row(result_, static_cast<int>(row)); }
+
+    Iterator begin() const { return Iterator(result_, 0); }
+    Iterator end() const { return Iterator(result_, static_cast<int>(size())); }
+
+    // 列数和列名
+    size_t Columns() const { return result_ ? static_cast<size_t>(PQnfields(result_)) : 0; }
+    std::string_view ColumnName(size_t column) const;
+
+    // INSERT/UPDATE/DELETE影响的行数
+    size_t AffectedRows() const;
+
+    const PGresult* Get() const { return result_; }
+
+private:
+    void Clear() noexcept;
+
+    PGresult* result_ = nullptr;
+    // 记入内存统计的字节数，释放时按同样的大小扣除
+    size_t memory_bytes_ = 0;
+};
+
+} // namespace ai_backend::core::db
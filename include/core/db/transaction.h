@@ -1,36 +1,51 @@
 #pragma once
 
-#include <memory>
-#include <pqxx/pqxx>
-#include "connection_pool.h"
+#include <string>
+
+#include "core/async/deadline.h"
+#include "core/async/task.h"
+#include "core/db/connection_pool.h"
 
 namespace ai_backend::core::db {
 
+// 数据库事务
+// 由ConnectionPool::BeginTransaction借出一个连接并执行BEGIN，之后的语句都在这个连接上执行，
+// Commit或Rollback后归还连接。开始事务时的截止时间限制事务中的每条语句。
+// 未提交就析构时 (例如语句抛出异常)，连接带着未结束的事务归还，由连接池异步回滚。
+//     auto txn = co_await pool.BeginTransaction(deadline);
+//     co_await txn.Query("INSERT ...", {...});
+//     co_await txn.Commit();
 class Transaction {
 public:
-    Transaction();
-    ~Transaction();
-    
-    void Begin();
-    void Commit();
-    void Rollback();
-    
-    pqxx::work& GetTxn();
-    
-    template<typename... Args>
-    pqxx::result ExecParams(const std::string& sql, Args&&... args) {
-        return txn_->exec_params(sql, std::forward<Args>(args)...);
-    }
-    
-    template<typename... Args>
-    pqxx::result ExecPrepared(const std::string& name, Args&&... args) {
-        return txn_->exec_prepared(name, std::forward<Args>(args)...);
-    }
+    Transaction(Transaction&&) noexcept = default;
+    Transaction& operator=(Transaction&&) noexcept = default;
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    async::Task<QueryResult> Query(std::string sql, QueryParams params = {});
+    async::Task<QueryResult> Query(const PreparedStatement& statement, QueryParams params = {});
+
+    async::Task<void> Commit();
+    async::Task<void> Rollback();
+
+    // 尚未提交或回滚
+    bool IsActive() const { return static_cast<bool>(connection_); }
+
+private:
+    friend class ConnectionPool;
+
+    Transaction(PooledConnection connection, async::Deadline deadline)
+        : connection_(std::move(connection)), deadline_(std::move(deadline)) {}
+
+    // 执行COMMIT或ROLLBACK后归还连接
+    async::Task<void> Finish(const char* sql);
+
+    // 事务结束后已经归还的连接仍可能被误用
+    void CheckActive() const;
 
 private:
-    std::shared_ptr<pqxx::connection> conn_;
-    std::unique_ptr<pqxx::work> txn_;
-    bool is_active_;
+    PooledConnection connection_;
+    async::Deadline deadline_;
 };
 
-} // namespace ai_backend::core::db
\ No newline at end of file
+} // namespace ai_backend::core::db
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/asio/any_io_executor.hpp>
+
+#include "core/async/async_semaphore.h"
+#include "core/async/codel.h"
+#include "core/async/task.h"
+#include "core/utils/latency_histogram.h"
+
+namespace ai_backend::core::http {
+
+// 路由类别：路径匹配同一组模式的请求共享并发上限、等待队列和过载状态
+struct RouteClassOptions {
+    std::string name;
+    // 路径模式按段匹配，*匹配任意一段，模式是路径的前缀即算匹配，如/api/v1/dialogs/*/messages
+    std::vector<std::string> patterns;
+    // 同时处理的请求数上限，0表示不限
+    size_t max_in_flight = 0;
+    // 等待并发名额的请求数上限，超过时立即拒绝；0表示不限
+    size_t max_queue = 0;
+};
+
+// 准入控制的配置，对应config.toml的[server.admission]节
+struct AdmissionOptions {
+    bool enabled = true;
+    // CoDel的排队时间目标和观察窗口
+    std::chrono::milliseconds target{50};
+    std::chrono::milliseconds interval{500};
+    // 未过载时等待并发名额的上限，过载时缩短为2倍target
+    std::chrono::milliseconds max_queue_time{1000};
+    // 503响应的Retry-After
+    std::chrono::seconds retry_after{1};
+    // 同时保持的连接数上限，超过时新连接收到503后关闭；0表示不限
+    size_t max_connections = 0;
+    // 按顺序匹配，第一个匹配的类别生效
+    std::vector<RouteClassOptions> classes;
+    // 未匹配任何类别的请求
+    RouteClassOptions default_class{.name = "default", .patterns = {}};
+};
+
+namespace detail {
+
+struct RouteClass {
+    explicit RouteClass(RouteClassOptions options, const AdmissionOptions& admission);
+
+    const RouteClassOptions options;
+    // 没有并发上限时为空
+    std::unique_ptr<async::AsyncSemaphore> permits;
+    async::CoDel codel;
+
+    std::atomic<size_t> in_flight{0};
+    std::atomic<size_t> queued{0};
+    std::atomic<uint64_t> admitted{0};
+    std::atomic<uint64_t> shed_queue_full{0};
+    std::atomic<uint64_t> shed_queue_timeout{0};
+    std::atomic<uint64_t> shed_sojourn{0};
+    // 从请求读取完成到开始处理的排队时间
+    utils::LatencyHistogram sojourn;
+};
+
+} // namespace detail
+
+// 已接纳请求的凭证，析构时归还并发名额
+// 流式响应的凭证随处理函数一起保留到响应结束。
+class AdmissionTicket {
+public:
+    AdmissionTicket() = default;
+    ~AdmissionTicket();
+
+    AdmissionTicket(AdmissionTicket&& other) noexcept;
+    AdmissionTicket& operator=(AdmissionTicket&& other) noexcept;
+    AdmissionTicket(const AdmissionTicket&) = delete;
+    AdmissionTicket& operator=(const AdmissionTicket&) = delete;
+
+    // 为空表示请求被拒绝
+    explicit operator bool() const { return route_class_ != nullptr; }
+
+    // 所属类别的名称，被拒绝的凭证返回空
+    std::string_view GetRouteClass() const;
+
+    // 提前归还名额
+    void Release();
+
+private:
+    friend class AdmissionController;
+    AdmissionTicket(std::shared_ptr<detail::RouteClass> route_class, bool has_permit);
+
+    std::shared_ptr<detail::RouteClass> route_class_;
+    bool has_permit_ = false;
+};
+
+// 连接凭证，析构时减少连接计数
+class ConnectionTicket {
+public:
+    ConnectionTicket() = default;
+    ~ConnectionTicket();
+
+    ConnectionTicket(ConnectionTicket&& other) noexcept = default;
+    ConnectionTicket& operator=(ConnectionTicket&& other) noexcept;
+    ConnectionTicket(const ConnectionTicket&) = delete;
+    ConnectionTicket& operator=(const ConnectionTicket&) = delete;
+
+    explicit operator bool() const { return counter_ != nullptr; }
+
+private:
+    friend class AdmissionController;
+    explicit ConnectionTicket(std::shared_ptr<std::atomic<size_t>> counter) : counter_(std::move(counter)) {}
+
+    std::shared_ptr<std::atomic<size_t>> counter_;
+};
+
+// HTTP请求的准入控制
+// 每个路由类别用协程信号量限制同时处理的请求数，超出的请求在有界队列中等待；请求从读取完成到
+// 开始处理的排队时间 (包括io_context的排队) 交给该类别的CoDel，持续超过目标时进入过载状态，
+// 过载期间排队超过2倍目标的请求直接拒绝，等待上限也缩短到2倍目标。被拒绝的请求由HttpServer
+// 返回带Retry-After的503，不再占用处理能力，已接纳请求的延迟保持在目标附近。
+class AdmissionController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct ClassStats {
+        std::string name;
+        size_t max_in_flight;
+        size_t max_queue;
+        size_t in_flight;
+        size_t queued;
+        bool overloaded;
+        uint64_t admitted;
+        uint64_t shed_queue_full;
+        uint64_t shed_queue_timeout;
+        uint64_t shed_sojourn;
+        utils::LatencyHistogram::Snapshot sojourn;
+
+        uint64_t GetShed() const { return shed_queue_full + shed_queue_timeout + shed_sojourn; }
+    };
+
+    struct Stats {
+        size_t active_connections;
+        uint64_t rejected_connections;
+        std::vector<ClassStats> classes;
+    };
+
+    explicit AdmissionController(AdmissionOptions options = {});
+
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    static AdmissionController& GetInstance();
+
+    // 替换配置，已接纳的请求仍按原来的类别归还名额
+    void Configure(AdmissionOptions options);
+
+    // 接受新连接时调用，超过连接数上限时返回空凭证
+    ConnectionTicket AdmitConnection();
+
+    // 请求读取完成后调用，received_at为读取完成的时刻；协程在executor上恢复，返回空凭证时应返回503。
+    // path只在第一次挂起之前使用。
+    async::Task<AdmissionTicket> Admit(std::string_view path, Clock::time_point received_at,
+                                       boost::asio::any_io_executor executor);
+
+    std::chrono::seconds GetRetryAfter() const;
+
+    size_t GetActiveConnections() const;
+
+    Stats GetStats() const;
+
+    // 路径是否匹配模式
+    static bool MatchPattern(std::string_view pattern, std::string_view path);
+
+private:
+    std::shared_ptr<detail::RouteClass> Classify(std::string_view path) const;
+
+private:
+    mutable std::mutex mutex_;
+    AdmissionOptions options_;
+    // 默认类别在最后
+    std::vector<std::shared_ptr<detail::RouteClass>> classes_;
+
+    std::shared_ptr<std::atomic<size_t>> connections_;
+    std::atomic<uint64_t> rejected_connections_{0};
+};
+
+} // namespace ai_backend::core::http
@@ -2,16 +2,24 @@
 
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include "request.h"
 #include "response.h"
 #include "router.h"
+#include "admission_controller.h"
+#include "core/async/runtime.h"
 #include "core/async/task.h"
+#include "core/async/timer_wheel.h"
+#include "core/memory/memory_tracker.h"
+#include "core/memory/request_arena.h"
 
 namespace ai_backend::core::http {
 
@@ -21,11 +29,15 @@ namespace net = boost::asio;
 using tcp = boost::asio::ip::tcp;
 
 // HTTP服务器类，处理HTTP请求
+// IO线程由Runtime持有：共享模式下只有一个接受器；分片模式下每个io_context各有一个
+// SO_REUSEPORT接受器，内核按四元组哈希分发连接，会话不跨线程迁移。
+// 连接数和请求由AdmissionController准入，超出处理能力的请求尽快收到503而不是无限排队。
 class HttpServer : public std::enable_shared_from_this<HttpServer> {
 public:
-    HttpServer(uint16_t port, size_t thread_count = 0);
+    explicit HttpServer(uint16_t port, async::Runtime& runtime = async::Runtime::GetInstance(),
+                        AdmissionController& admission = AdmissionController::GetInstance());
     ~HttpServer();
-
+    
     // 启动服务器
     void Start();
     
@@ -43,54 +55,108 @@ public:
     
     // 检查服务器是否正在运行
     bool IsRunning() const;
+    
+    // 请求截止时间上限，X-Request-Timeout不能超过该值，未指定时使用该值
+    void SetMaxRequestTimeout(std::chrono::milliseconds timeout);
 
 private:
+    // 打开并监听接受器
+    void OpenAcceptor(tcp::acceptor& acceptor, bool reuse_port);
+    
     // 接受新连接
-    void AcceptConnection();
+    void AcceptConnection(tcp::acceptor& acceptor);
+    
+    // 超过连接数上限时发送503并关闭连接
+    void RejectConnection(tcp::socket socket);
     
     // 处理HTTP会话
     class HttpSession : public std::enable_shared_from_this<HttpSession> {
     public:
-        HttpSession(tcp::socket&& socket, std::shared_ptr<Router> router);
+        HttpSession(tcp::socket&& socket, std::shared_ptr<Router> router,
+                    std::chrono::milliseconds max_request_timeout,
+                    AdmissionController& admission, ConnectionTicket connection);
         
         // 启动会话
         void Start();
         
     private:
+        // 流式响应写入器，实现在http_server.cpp中
+        class SessionStreamWriter;
+        
         // 读取请求
         void ReadRequest();
         
-        // 处理完整请求
-        async::Task<void> ProcessRequest();
+        // 处理完整请求，self保持会话存活
+        async::Task<void> ProcessRequest(std::shared_ptr<HttpSession> self);
         
         // 写入响应
-        void WriteResponse(const Response& response);
+        void WriteResponse(Response response);
+        
+        // 发送流式响应头部，然后运行流式处理函数，截止时间到期时停止写入；
+        // 准入凭证保留到流式响应结束
+        void WriteStreamingResponse(Response response, async::Deadline deadline, AdmissionTicket ticket);
+        
+        // 运行流式处理函数，结束后确保写入终止块
+        static async::Task<void> RunStreamHandler(
+            std::shared_ptr<SessionStreamWriter> writer,
+            std::function<async::Task<void>(StreamWriter&)> handler,
+            AdmissionTicket ticket);
+        
+        // 响应发送完毕，关闭连接或读取下一个请求
+        void FinishResponse(bool should_close);
+        
+        // 设置响应公共头部，返回是否应关闭连接
+        template <typename Body>
+        bool PrepareHeaders(http::response<Body>& response, const Response& resp);
         
         // 关闭连接
         void Close();
         
+        // 等待请求超时，关闭socket
+        void OnIdleTimeout();
+        
         // 处理错误
         void HandleError(beast::error_code ec, const char* what);
 
     private:
         tcp::socket socket_;
-        beast::flat_buffer buffer_;
+        // 读缓冲区和请求arena的内存计入http标签
+        beast::basic_flat_buffer<std::pmr::polymorphic_allocator<char>> buffer_;
         http::request<http::string_body> request_;
         http::response<http::string_body> response_;
         std::shared_ptr<Router> router_;
+        std::chrono::milliseconds max_request_timeout_;
         std::atomic<bool> close_connection_;
+        
+        // 准入控制：连接凭证随会话释放，received_at_为当前请求读取完成的时刻
+        AdmissionController& admission_;
+        ConnectionTicket connection_;
+        std::chrono::steady_clock::time_point received_at_;
+        
+        // 每个请求从这里借出请求级arena
+        memory::RequestArenaSlot arena_;
+        
+        // 流式响应状态
+        // 头部由序列化器发送，数据块由SessionStreamWriter直接写入socket
+        http::response<http::empty_body> stream_response_;
+        std::optional<http::response_serializer<http::empty_body>> stream_serializer_;
+        
+        // 读取请求的空闲超时，挂在会话所在io_context的时间轮上，每次读取只重设到期时间；
+        // 最后声明，析构时最先取消，回调不会看到已销毁的成员
+        async::TimerWheel& wheel_;
+        async::TimerWheel::Timer idle_timer_;
     };
 
 private:
     uint16_t port_;
-    size_t thread_count_;
+    async::Runtime& runtime_;
+    AdmissionController& admission_;
+    std::chrono::milliseconds max_request_timeout_;
     std::atomic<bool> running_;
-    std::atomic<size_t> active_connections_;
     
-    net::io_context io_context_;
-    std::optional<net::executor_work_guard<net::io_context::executor_type>> work_guard_;
-    tcp::acceptor acceptor_;
-    std::vector<std::thread> worker_threads_;
+    // 每个io_context一个接受器，不支持SO_REUSEPORT时只有一个，连接轮流分给各io_context
+    std::vector<std::unique_ptr<tcp::acceptor>> acceptors_;
+    
     std::shared_ptr<Router> router_;
 };
 
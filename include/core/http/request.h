@@ -1,61 +1,137 @@
 #pragma once
 
+#include <chrono>
+#include <functional>
+#include <memory_resource>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
-#include <vector>
+#include <utility>
+
+#include <boost/beast/http/fields.hpp>
+#include <boost/container/small_vector.hpp>
+
+#include "core/async/deadline.h"
 
 namespace ai_backend::core::http {
 
 // HTTP请求类
+// 方法、路径、头部、请求体和参数都是指向HttpSession解析器存储的视图，
+// 构造请求不复制任何数据。视图只在当前请求的响应发送完成前有效，
+// 需要保存到请求生命周期之外的值必须显式复制为std::string。
+//
+// HttpSession为每个请求提供一个请求级arena (GetMemoryResource)，中间件写入的字符串和头部
+// 以及控制器的临时对象都可以从中分配，请求处理协程结束时一次性回收。流式处理函数在协程结束后
+// 才运行，不能捕获从arena分配的对象。
 class Request {
 public:
-    Request() = default;
-    
+    // 参数键值对，均为视图
+    using Param = std::pair<std::string_view, std::string_view>;
+
+    // 绝大多数请求的参数个数很少，内联存储避免堆分配
+    using ParamList = boost::container::small_vector<Param, 8>;
+
+    // 中间件附加到响应上的头部，从请求的arena分配
+    using HeaderMap = std::pmr::unordered_map<std::pmr::string, std::pmr::string>;
+
+    Request() : Request(std::pmr::get_default_resource()) {}
+
+    explicit Request(std::pmr::memory_resource* memory)
+        : request_id(memory), client_ip(memory), cors_headers(memory), rate_limit_headers(memory),
+          memory_(memory) {}
+
     // 请求方法 (GET, POST, PUT, DELETE等)
-    std::string method;
-    
+    std::string_view method;
+
     // 请求目标URL
-    std::string target;
-    
+    std::string_view target;
+
     // 路径部分 (不含查询参数)
-    std::string path;
-    
+    std::string_view path;
+
+    // 查询字符串 (不含'?')
+    std::string_view query_string;
+
     // HTTP版本
-    unsigned version;
-    
-    // 请求头
-    std::unordered_map<std::string, std::string> headers;
-    
+    unsigned version = 11;
+
     // 请求体
-    std::string body;
-    
-    // 查询参数
-    std::unordered_map<std::string, std::string> query_params;
-    
-    // 路径参数
-    std::unordered_map<std::string, std::string> path_params;
-    
+    std::string_view body;
+
+    // 查询参数，由ParseQueryString单次扫描生成，值未做URL解码
+    ParamList query_params;
+
+    // 路径参数，由路由器填充
+    ParamList path_params;
+
+    // 以下为中间件写入的请求副状态，中间件只修改这些字段，不复制请求本身
+
     // 认证用户ID (由Auth中间件设置)
     std::optional<std::string> user_id;
-    
-    // 获取头部值，如果不存在返回空字符串
-    std::string GetHeader(const std::string& name) const;
-    
+
+    // 请求ID和开始时间 (由RequestLogger设置)
+    std::pmr::string request_id;
+    std::chrono::steady_clock::time_point start_time;
+
+    // 客户端地址 (由HttpSession设置)
+    std::pmr::string client_ip;
+
+    // 请求截止时间 (由HttpSession按X-Request-Timeout头创建，路由器按路由配置收紧)
+    // 传给数据库、上游和流式写入器，到期时中止等待和传输
+    async::Deadline deadline;
+
+    // 需要附加到响应上的头部 (由CORS和限流中间件设置)
+    HeaderMap cors_headers;
+    HeaderMap rate_limit_headers;
+
+    // 是否为CORS预检请求
+    bool is_preflight = false;
+
+    // 请求级内存资源，只在请求处理协程结束前有效
+    std::pmr::memory_resource* GetMemoryResource() const { return memory_; }
+
+    // 设置头部来源，头部查找直接在Beast解析出的字段上进行，不做复制
+    void SetHeaderSource(const boost::beast::http::fields* fields);
+
+    // 添加额外头部 (用于非Beast来源的请求)，调用方负责保持数据有效
+    void AddHeader(std::string_view name, std::string_view value);
+
+    // 遍历所有头部
+    void ForEachHeader(const std::function<void(std::string_view, std::string_view)>& visitor) const;
+
+    // 单次扫描解析查询字符串到query_params
+    void ParseQueryString(std::string_view query);
+
+    // 设置路径参数，名称和值都必须比请求活得更久
+    void SetPathParam(std::string_view name, std::string_view value);
+
+    // 获取头部值 (名称不区分大小写)，如果不存在返回空视图
+    std::string_view GetHeader(std::string_view name) const;
+
     // 获取查询参数，如果不存在返回默认值
-    std::string GetQueryParam(const std::string& name, const std::string& default_value = "") const;
-    
+    std::string_view GetQueryParam(std::string_view name, std::string_view default_value = {}) const;
+
     // 获取路径参数，如果不存在返回默认值
-    std::string GetPathParam(const std::string& name, const std::string& default_value = "") const;
-    
+    std::string_view GetPathParam(std::string_view name, std::string_view default_value = {}) const;
+
     // 检查头部是否存在
-    bool HasHeader(const std::string& name) const;
-    
+    bool HasHeader(std::string_view name) const;
+
     // 检查查询参数是否存在
-    bool HasQueryParam(const std::string& name) const;
-    
+    bool HasQueryParam(std::string_view name) const;
+
     // 检查路径参数是否存在
-    bool HasPathParam(const std::string& name) const;
+    bool HasPathParam(std::string_view name) const;
+
+private:
+    // 在参数列表中查找
+    static const Param* FindParam(const ParamList& params, std::string_view name);
+
+private:
+    std::pmr::memory_resource* memory_;
+    const boost::beast::http::fields* header_fields_ = nullptr;
+    boost::container::small_vector<Param, 4> extra_headers_;
 };
 
-} // namespace ai_backend::core::http
\ No newline at end of file
+} // namespace ai_backend::core::http
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
+#include <memory_resource>
 #include <string>
 #include <unordered_map>
 #include <nlohmann/json.hpp>
 #include "core/async/task.h"
+#include "core/memory/buffer_chain.h"
 
 namespace ai_backend::core::http {
 
@@ -16,20 +19,38 @@ public:
     // 写入数据
     virtual void Write(const std::string& data) = 0;
     
+    // 写入已组装好的缓冲区链，支持分散/聚集写的实现直接发送各个切片
+    virtual void Write(memory::BufferChain data) { Write(data.ToString()); }
+    
     // 结束写入
     virtual void End() = 0;
+    
+    // 客户端是否仍然连接，断开后生产者应尽快停止
+    virtual bool IsOpen() const { return true; }
+    
+    // 发送队列是否低于高水位
+    virtual bool IsWritable() const { return true; }
+    
+    // 等待发送队列降到低水位以下，用于生产者背压
+    virtual core::async::Task<void> WaitWritable() { co_return; }
 };
 
 // HTTP响应类
+// 头部可以从请求的arena分配 (Response(request.GetMemoryResource()))，响应在处理协程结束前
+// 转换为Beast消息。响应体仍是std::string，发送时移交给Beast，不再复制。
 class Response {
 public:
+    using HeaderMap = std::pmr::unordered_map<std::pmr::string, std::pmr::string>;
+    
     Response() = default;
     
+    explicit Response(std::pmr::memory_resource* memory) : headers(memory) {}
+    
     // 状态码
     int status_code = 200;
     
     // 响应头
-    std::unordered_map<std::string, std::string> headers;
+    HeaderMap headers;
     
     // 响应体
     std::string body;
@@ -50,7 +71,14 @@ public:
     static Response Unauthorized(const nlohmann::json& error = {});
     static Response Forbidden(const nlohmann::json& error = {});
     static Response NotFound(const nlohmann::json& error = {});
+    static Response MethodNotAllowed(const std::string& allow, const nlohmann::json& error = {});
     static Response InternalServerError(const nlohmann::json& error = {});
+    // 以下两个由HttpServer直接生成，默认参数须是空对象，null不能调用value()
+    static Response GatewayTimeout(const nlohmann::json& error = nlohmann::json::object());
+    
+    // 过载时拒绝请求，Retry-After告诉客户端多久后重试
+    static Response ServiceUnavailable(std::chrono::seconds retry_after,
+                                       const nlohmann::json& error = nlohmann::json::object());
 };
 
 } // namespace ai_backend::core::http
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/http/request.h"
+
+namespace ai_backend::core::http {
+
+// 压缩基数树路由表
+// 路由在启动时通过Insert一次性构建，匹配时只做前缀比较，不使用正则也不分配内存。
+// 路径模板中的"{name}"表示占据一个完整路径段的参数。静态段优先于参数段匹配，
+// 静态分支失败时回溯到参数分支。
+// Insert与Match不能并发执行，匹配结果中的参数名引用树内存储，在下一次Insert前有效。
+class RouteTree {
+public:
+    // 单条路由支持的最大参数个数
+    static constexpr size_t kMaxParams = 8;
+
+    enum class MatchStatus {
+        kFound,             // 路径和方法都匹配
+        kMethodNotAllowed,  // 路径匹配但方法不匹配
+        kNotFound           // 路径不匹配
+    };
+
+    struct MatchResult {
+        MatchStatus status = MatchStatus::kNotFound;
+
+        // Insert时传入的路由ID
+        size_t route_id = 0;
+
+        // 路径匹配时该节点允许的方法，用于405响应的Allow头
+        std::string_view allow;
+
+        // 参数值引用请求路径
+        std::array<Request::Param, kMaxParams> params{};
+        size_t param_count = 0;
+    };
+
+    RouteTree();
+    ~RouteTree();
+
+    RouteTree(const RouteTree&) = delete;
+    RouteTree& operator=(const RouteTree&) = delete;
+
+    // 添加路由，模板非法或重复注册时抛出std::invalid_argument
+    void Insert(std::string_view method, std::string_view path_template, size_t route_id);
+
+    // 匹配请求
+    MatchResult Match(std::string_view method, std::string_view path) const;
+
+private:
+    enum Method : int {
+        kGet,
+        kPost,
+        kPut,
+        kDelete,
+        kPatch,
+        kHead,
+        kOptions,
+        kMethodCount
+    };
+
+    struct Node;
+
+    struct RouteRecord {
+        size_t route_id;
+        std::vector<std::string> param_names;
+    };
+
+    static int MethodIndex(std::string_view method);
+    static const char* MethodName(int method);
+
+    // 在节点prefix的common位置拆分
+    static void Split(Node* node, size_t common);
+
+    // 重建节点的Allow头
+    static void RebuildAllow(Node* node);
+
+    // 从已匹配的node继续匹配剩余路径
+    bool MatchNode(const Node* node, std::string_view rest, int method,
+                   MatchResult& result, MatchResult& fallback) const;
+
+private:
+    std::unique_ptr<Node> root_;
+    std::vector<RouteRecord> routes_;
+};
+
+} // namespace ai_backend::core::http
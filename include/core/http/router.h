@@ -15,7 +15,9 @@ public:
     virtual ~Router() = default;
     
     virtual void Initialize() = 0;
-    virtual async::Task<Response> Route(const Request& request) = 0;
+    
+    // 路由请求，路由器和中间件可以直接写入请求的路径参数和副状态
+    virtual async::Task<Response> Route(Request& request) = 0;
 };
 
 } // namespace ai_backend::core::http
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string_view>
+
+#include "core/async/async_event.h"
+#include "core/async/task.h"
+#include "core/http/response.h"
+#include "core/memory/buffer_chain.h"
+
+namespace ai_backend::core::http {
+
+// 把同步回调产生的数据按StreamWriter的背压写出
+// Push可以在任意线程上调用且不会阻塞 (例如在上游客户端strand上运行的token回调)；Run在处理函数的
+// 协程中运行，每次等待写入器降到低水位以下，再把期间积累的数据 (最多kMaxWriteBytes) 作为一次写入交给写入器。
+// 客户端读得慢时数据在这里合并成更大的块，写入器的发送队列不会越过高水位继续增长。
+//     StreamPump pump(writer);
+//     co_await WhenAll(CurrentExecutor(), Generate(pump), pump.Run());
+class StreamPump {
+public:
+    // 单次交给写入器的数据上限
+    static constexpr size_t kMaxWriteBytes = 64 * 1024;
+
+    explicit StreamPump(StreamWriter& writer) : writer_(writer) {}
+
+    StreamPump(const StreamPump&) = delete;
+    StreamPump& operator=(const StreamPump&) = delete;
+
+    // 追加数据；Finish之后或写入器已关闭时丢弃
+    void Push(memory::BufferChain data);
+    void Push(std::string_view data);
+
+    // 生产者结束，Run写出剩余数据后返回
+    void Finish();
+
+    // 写出数据，直到Finish之后全部写出，或写入器关闭 (客户端断开、截止时间到期)
+    async::Task<void> Run();
+
+    // 写入器是否仍然打开，关闭后生产者可以停止积累数据
+    bool IsOpen() const { return writer_.IsOpen(); }
+
+    // 已积累但尚未交给写入器的字节数
+    size_t GetPendingBytes() const;
+
+private:
+    StreamWriter& writer_;
+    async::AsyncEvent ready_;
+
+    mutable std::mutex mutex_;
+    memory::BufferChain pending_;
+    bool finished_ = false;
+    bool closed_ = false;
+};
+
+} // namespace ai_backend::core::http
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <curl/curl.h>
+
+#include "core/async/deadline.h"
+
+namespace ai_backend::core::http {
+
+// 发往上游服务 (如AI模型API) 的HTTP请求
+struct UpstreamRequest {
+    std::string method = "GET";
+    std::string url;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+
+    // 整个请求的超时时间，包括读取流式响应
+    std::chrono::milliseconds timeout{std::chrono::minutes(5)};
+
+    // 建立连接的超时时间
+    std::chrono::milliseconds connect_timeout{std::chrono::seconds(10)};
+
+    // 是否校验服务端证书
+    bool verify_tls = true;
+
+    // 所属请求的截止时间，curl超时不会超过剩余时间，到期或被取消时中止传输
+    async::Deadline deadline;
+};
+
+// 上游服务的响应
+struct UpstreamResponse {
+    // HTTP状态码，传输失败时为0
+    int status_code = 0;
+
+    // 响应头，名称统一为小写
+    std::unordered_map<std::string, std::string> headers;
+
+    // 响应体，流式请求只包含非2xx响应的错误内容
+    std::string body;
+
+    // 传输层错误描述，成功时为空
+    std::string error;
+
+    // 是否因超时失败
+    bool timed_out = false;
+
+    bool IsTransportOk() const {
+        return error.empty();
+    }
+};
+
+// 上游连接管理配置
+struct UpstreamOptions {
+    // 每个主机的最大连接数，0表示不限制
+    long max_host_connections = 16;
+
+    // 空闲连接缓存上限
+    long max_cached_connections = 64;
+
+    // DNS缓存时间 (秒)
+    long dns_cache_timeout = 300;
+
+    // 是否通过ALPN协商HTTP/2，并在同一连接上复用并发请求
+    bool enable_http2 = true;
+
+    // TCP keepalive探测间隔 (秒)
+    long tcp_keepalive_interval = 60;
+};
+
+// 按基础URL (协议://主机[:端口]) 统计的连接池状态
+struct UpstreamPoolStats {
+    std::string base_url;
+    size_t requests = 0;            // 已完成的请求数
+    size_t failures = 0;            // 传输失败数
+    size_t active = 0;              // 进行中的请求数
+    size_t connections_opened = 0;  // 新建连接的请求数
+    size_t connections_reused = 0;  // 复用已有连接的请求数
+    size_t http2_requests = 0;      // 通过HTTP/2完成的请求数
+    double avg_connect_ms = 0.0;    // 新建连接的平均TCP握手耗时
+    double avg_tls_ms = 0.0;        // 新建连接的平均TLS握手完成耗时 (含TCP)
+};
+
+// 流式响应数据回调，在客户端的strand上调用，不能阻塞
+using UpstreamChunkHandler = std::function<void(std::string_view)>;
+
+// 基于curl_multi_socket_action的异步上游HTTP客户端
+// curl的套接字通过stream_descriptor注册到io_context，超时由steady_timer驱动，
+// 所有curl调用都在同一个strand上串行执行，并发请求不占用额外线程。
+// 请求完成后等待的协程被投递回它等待时所在的executor (会话的strand或分片的io_context) 恢复，
+// 而不是在curl的strand上直接恢复。
+// multi句柄的连接缓存保持到各上游的keep-alive连接，DNS和TLS会话通过share句柄缓存，
+// 启用HTTP/2时并发请求优先等待并复用已有连接 (CURLOPT_PIPEWAIT)。
+class UpstreamClient {
+public:
+    class SendAwaiter;
+
+    explicit UpstreamClient(boost::asio::io_context& io_context);
+    ~UpstreamClient();
+
+    UpstreamClient(const UpstreamClient&) = delete;
+    UpstreamClient& operator=(const UpstreamClient&) = delete;
+
+    // 获取绑定到全局EventLoop的实例
+    static UpstreamClient& GetInstance();
+
+    // 发送请求并等待完整响应
+    SendAwaiter Send(UpstreamRequest request);
+
+    // 发送请求，2xx响应体通过on_chunk逐块交付
+    SendAwaiter SendStream(UpstreamRequest request, UpstreamChunkHandler on_chunk);
+
+    // 正在进行的传输数
+    size_t GetActiveTransfers() const;
+
+    // 更新连接管理配置，对之后开始的传输生效
+    void Configure(const UpstreamOptions& options);
+
+    // 预热到请求目标的连接，发送connections个并发请求并丢弃响应
+    void Prewarm(const UpstreamRequest& request, size_t connections);
+
+    // 各上游的连接池统计
+    std::vector<UpstreamPoolStats> GetPoolStats() const;
+
+    // 提取URL的基础部分 (协议://主机[:端口])
+    static std::string BaseUrlOf(const std::string& url);
+
+private:
+    struct Transfer;
+    struct SocketWatcher;
+
+    // 在strand上把传输加入multi句柄
+    void StartTransfer(std::shared_ptr<Transfer> transfer);
+
+    // 配置easy句柄
+    bool SetupEasyHandle(Transfer& transfer);
+
+    // 在strand上驱动curl
+    void SocketAction(curl_socket_t socket, int event_bitmask);
+
+    // 收集已完成的传输并恢复等待者
+    void CheckCompleted();
+
+    // 截止时间到期时中止仍在进行的传输
+    void AbortTransfer(CURL* easy, const std::weak_ptr<Transfer>& weak_transfer);
+
+    // 移出multi句柄后记录结果并恢复等待者
+    void FinishTransfer(std::shared_ptr<Transfer> transfer, bool failed);
+
+    // 记录传输结果到连接池统计
+    void RecordCompletion(Transfer& transfer, bool failed);
+
+    // 根据curl要求的事件注册读写等待
+    void WatchSocket(const std::shared_ptr<SocketWatcher>& watcher);
+
+    // curl回调
+    static int SocketCallback(CURL* easy, curl_socket_t socket, int what, void* userp, void* socketp);
+    static int TimerCallback(CURLM* multi, long timeout_ms, void* userp);
+    static size_t WriteCallback(char* data, size_t size, size_t nmemb, void* userp);
+    static size_t HeaderCallback(char* data, size_t size, size_t nmemb, void* userp);
+
+private:
+    boost::asio::io_context& io_context_;
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+    boost::asio::steady_timer timer_;
+    CURLM* multi_;
+    CURLSH* share_;
+
+    // 以下成员只在strand上访问
+    std::unordered_map<CURL*, std::shared_ptr<Transfer>> transfers_;
+    std::unordered_map<curl_socket_t, std::shared_ptr<SocketWatcher>> watchers_;
+    UpstreamOptions options_;
+
+    std::atomic<size_t> active_transfers_{0};
+
+    // 连接池统计，strand上写入，任意线程读取
+    struct PoolCounters {
+        UpstreamPoolStats stats;
+        int64_t total_connect_us = 0;
+        int64_t total_tls_us = 0;
+    };
+    mutable std::mutex stats_mutex_;
+    std::unordered_map<std::string, PoolCounters> pool_stats_;
+};
+
+// co_await UpstreamClient::Send/SendStream 的等待器
+class UpstreamClient::SendAwaiter {
+public:
+    SendAwaiter(UpstreamClient& client, std::shared_ptr<Transfer> transfer);
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    UpstreamResponse await_resume();
+
+private:
+    UpstreamClient& client_;
+    std::shared_ptr<Transfer> transfer_;
+};
+
+} // namespace ai_backend::core::http
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/container/small_vector.hpp>
+
+namespace ai_backend::core::memory {
+
+namespace detail {
+
+// 引用计数的内存段：从MemoryPool分配的定长段，或接管的std::string
+struct BufferSegment {
+    std::atomic<uint32_t> refs{1};
+    void (*destroy)(BufferSegment*) = nullptr;
+    char* data = nullptr;
+    size_t capacity = 0;
+    // 已写入的字节数，只由持有写权限的链 (段的分配者) 修改
+    size_t used = 0;
+};
+
+inline void RetainSegment(BufferSegment* segment) noexcept {
+    if (segment) {
+        segment->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+inline void ReleaseSegment(BufferSegment* segment) noexcept {
+    if (segment && segment->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        segment->destroy(segment);
+    }
+}
+
+} // namespace detail
+
+// 内存段中一段已写入数据的只读视图，持有段的引用
+class BufferSlice {
+public:
+    BufferSlice() = default;
+
+    // 接管调用方持有的一个段引用
+    BufferSlice(detail::BufferSegment* segment, const char* data, size_t size) noexcept
+        : segment_(segment), data_(data), size_(size) {}
+
+    BufferSlice(const BufferSlice& other) noexcept
+        : segment_(other.segment_), data_(other.data_), size_(other.size_) {
+        detail::RetainSegment(segment_);
+    }
+
+    BufferSlice(BufferSlice&& other) noexcept
+        : segment_(other.segment_), data_(other.data_), size_(other.size_) {
+        other.segment_ = nullptr;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    BufferSlice& operator=(BufferSlice other) noexcept {
+        std::swap(segment_, other.segment_);
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    ~BufferSlice() {
+        detail::ReleaseSegment(segment_);
+    }
+
+    const char* Data() const noexcept { return data_; }
+    size_t Size() const noexcept { return size_; }
+    std::string_view View() const noexcept { return {data_, size_}; }
+
+    // 共享同一个段的子切片
+    BufferSlice Sub(size_t offset, size_t length = std::string_view::npos) const;
+
+    void RemovePrefix(size_t n) noexcept {
+        data_ += n;
+        size_ -= n;
+    }
+
+private:
+    friend class BufferChain;
+
+    detail::BufferSegment* segment_ = nullptr;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// 分段、引用计数的缓冲区链
+// Append把数据复制到链尾的定长段 (从MemoryPool分配)，段写满后接着写新段，已写入的数据从不搬移；
+// 较大的std::string右值直接接管，不复制。复制链、Slice和Split只增加段的引用计数，不复制数据。
+// 链本身是Asio的ConstBufferSequence，可以直接交给async_write做分散/聚集写。
+// 已写入的数据不可修改，切片可以在线程间传递；单个链对象不是线程安全的。
+class BufferChain {
+public:
+    // 段大小 (含段头部)，对应MemoryPool的4KB级别
+    static constexpr size_t kSegmentSize = 4096;
+
+    // 不小于该值的std::string右值直接接管
+    static constexpr size_t kAdoptThreshold = 1024;
+
+    using Slices = boost::container::small_vector<BufferSlice, 4>;
+
+    // ConstBufferSequence的迭代器，每个切片对应一个const_buffer
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = boost::asio::const_buffer;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const boost::asio::const_buffer*;
+        using reference = boost::asio::const_buffer;
+
+        const_iterator() = default;
+        explicit const_iterator(Slices::const_iterator it) : it_(it) {}
+
+        boost::asio::const_buffer operator*() const { return {it_->Data(), it_->Size()}; }
+
+        const_iterator& operator++() { ++it_; return *this; }
+        const_iterator operator++(int) { auto copy = *this; ++it_; return copy; }
+        const_iterator& operator--() { --it_; return *this; }
+        const_iterator operator--(int) { auto copy = *this; --it_; return copy; }
+
+        bool operator==(const const_iterator& other) const { return it_ == other.it_; }
+        bool operator!=(const const_iterator& other) const { return it_ != other.it_; }
+
+    private:
+        Slices::const_iterator it_;
+    };
+
+    using value_type = boost::asio::const_buffer;
+
+    BufferChain() = default;
+
+    // 接管字符串，不复制
+    explicit BufferChain(std::string data);
+
+    // 复制只共享切片，副本没有写权限，之后的Append写入新段
+    BufferChain(const BufferChain& other);
+    BufferChain& operator=(const BufferChain& other);
+    BufferChain(BufferChain&& other) noexcept;
+    BufferChain& operator=(BufferChain&& other) noexcept;
+    ~BufferChain();
+
+    // 复制数据到链尾
+    void Append(const void* data, size_t size);
+    void Append(std::string_view data) { Append(data.data(), data.size()); }
+    void Append(const char* data) { Append(std::string_view(data)); }
+    void Append(const std::string& data) { Append(std::string_view(data)); }
+
+    // 较大的字符串直接接管，较小的复制到链尾的段
+    void Append(std::string&& data);
+
+    // 共享切片或另一个链的数据，不复制
+    void Append(BufferSlice slice);
+    void Append(const BufferChain& other);
+    void Append(BufferChain&& other);
+
+    // 取出前n个字节作为新链返回，边界所在的切片被分成两部分
+    BufferChain Split(size_t n);
+
+    // 共享[offset, offset + length)的新链
+    BufferChain Slice(size_t offset, size_t length = std::string_view::npos) const;
+
+    // 丢弃前n个字节 (例如部分写出之后)
+    void Consume(size_t n);
+
+    void Clear();
+
+    size_t Size() const noexcept { return size_; }
+    bool Empty() const noexcept { return size_ == 0; }
+    size_t GetSliceCount() const noexcept { return slices_.size(); }
+    const Slices& GetSlices() const noexcept { return slices_; }
+
+    // 复制为连续的字符串，只在确实需要连续内存时使用
+    std::string ToString() const;
+    void CopyTo(char* out) const;
+
+    const_iterator begin() const { return const_iterator(slices_.begin()); }
+    const_iterator end() const { return const_iterator(slices_.end()); }
+
+private:
+    void ReleaseWriteSegment() noexcept;
+
+private:
+    Slices slices_;
+    size_t size_ = 0;
+    // 当前可写的段 (持有一个引用)，只有分配它的链可以继续写入
+    detail::BufferSegment* write_segment_ = nullptr;
+};
+
+} // namespace ai_backend::core::memory
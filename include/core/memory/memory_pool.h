@@ -1,72 +1,147 @@
 #pragma once
 
-#include <atomic>
-#include <mutex>
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <memory_resource>
+#include <new>
+#include <vector>
 
 namespace ai_backend::core::memory {
 
+// 单个大小级别的统计
+struct MemoryPoolClassStats {
+    size_t block_size = 0;
+    uint64_t allocations = 0;       // 累计分配的块数
+    uint64_t deallocations = 0;     // 累计释放的块数
+    uint64_t depot_blocks = 0;      // 全局仓库中的空闲块数
+    uint64_t cached_blocks = 0;     // 各线程缓存中的空闲块数
+    uint64_t spans = 0;             // 当前持有的span数
+    uint64_t spans_released = 0;    // 累计归还给操作系统的span数
+
+    uint64_t GetLiveBlocks() const { return allocations - deallocations; }
+    uint64_t GetLiveBytes() const { return GetLiveBlocks() * block_size; }
+    uint64_t GetReservedBytes() const;
+};
+
+struct MemoryPoolStats {
+    std::vector<MemoryPoolClassStats> classes;
+    // 超过最大级别的分配直接使用全局new
+    uint64_t large_allocations = 0;
+    uint64_t large_deallocations = 0;
+    uint64_t large_live_bytes = 0;
+
+    uint64_t GetLiveBytes() const;
+    uint64_t GetReservedBytes() const;
+};
+
+namespace detail {
+struct PoolCore;
+} // namespace detail
+
+// 多大小级别的内存池
+// 16字节到32KB按2的幂分为12个级别，每个级别从256KB对齐的span中切分内存块。
+// 每个线程为每个级别缓存两个弹匣 (magazine，最多64个空闲块)，分配和释放通常只访问线程本地的
+// 弹匣；弹匣满或空时与全局仓库交换整个弹匣，仓库是无锁的栈。只有切分新span时按级别加锁。
+// 块可以在任意线程上释放，释放时必须给出分配时的大小 (与sized delete相同)。
+// Trim把上次Trim以来一直闲置在仓库中的完全空闲span归还给操作系统，由调用方定期调用。
 class MemoryPool {
 public:
-    MemoryPool(size_t block_size, size_t initial_blocks = 32);
+    static constexpr size_t kSpanSize = 256 * 1024;
+    static constexpr size_t kMaxBlockSize = 32 * 1024;
+
+    MemoryPool();
     ~MemoryPool();
-    
+
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    static MemoryPool& GetInstance();
+
+    // size为0时分配最小的块；块按级别大小自然对齐 (最多4KB)
     void* Allocate(size_t size);
-    void Deallocate(void* ptr);
-    
-    size_t GetBlockSize() const;
-    size_t GetUsedBlocks() const;
-    size_t GetFreeBlocks() const;
-    size_t GetTotalBlocks() const;
-    
-private:
-    void AllocateNewBlock();
-    
+    void Deallocate(void* ptr, size_t size) noexcept;
+
+    // 归还上次Trim以来一直没有被用到的空闲span，返回释放的字节数
+    size_t Trim();
+
+    // 归还所有完全空闲、且不在线程缓存中的span，返回释放的字节数
+    size_t ReleaseFreeMemory();
+
+    MemoryPoolStats GetStats() const;
+
+    // size所在级别的块大小，超过最大级别时返回size
+    static size_t GetBlockSize(size_t size);
+
 private:
-    size_t block_size_;
-    std::mutex mutex_;
-    std::vector<char*> memory_blocks_;
-    std::vector<void*> free_blocks_;
-    std::atomic<size_t> used_blocks_{0};
+    std::shared_ptr<detail::PoolCore> core_;
 };
 
+// 从MemoryPool分配的标准分配器，可用于容器
+// 默认使用全局内存池；同一个内存池的分配器相等，可以互相释放。
 template <typename T>
 class PoolAllocator {
 public:
     using value_type = T;
-    
-    PoolAllocator(MemoryPool& pool) : pool_(pool) {}
-    
+
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned types are not supported");
+
+    PoolAllocator() noexcept : pool_(&MemoryPool::GetInstance()) {}
+
+    PoolAllocator(MemoryPool& pool) noexcept : pool_(&pool) {}
+
     template <typename U>
-    PoolAllocator(const PoolAllocator<U>& other) : pool_(other.pool_) {}
-    
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool_(other.pool_) {}
+
     T* allocate(std::size_t n) {
-        if (n * sizeof(T) > pool_.GetBlockSize()) {
-            throw std::bad_alloc();
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
         }
-        return static_cast<T*>(pool_.Allocate(n * sizeof(T)));
+        return static_cast<T*>(pool_->Allocate(n * sizeof(T)));
     }
-    
-    void deallocate(T* p, std::size_t n) {
-        pool_.Deallocate(p);
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        pool_->Deallocate(p, n * sizeof(T));
     }
-    
+
+    MemoryPool& GetPool() const { return *pool_; }
+
     template <typename U>
     bool operator==(const PoolAllocator<U>& other) const {
-        return &pool_ == &other.pool_;
+        return pool_ == other.pool_;
     }
-    
+
     template <typename U>
     bool operator!=(const PoolAllocator<U>& other) const {
         return !(*this == other);
     }
-    
+
 private:
-    MemoryPool& pool_;
-    
+    MemoryPool* pool_;
+
     template <typename U>
     friend class PoolAllocator;
 };
 
-} // namespace ai_backend::core::memory
\ No newline at end of file
+// MemoryPool的std::pmr适配，可作为monotonic_buffer_resource等的上游
+// 超过默认对齐的请求按对齐取整到对应级别 (级别块按大小自然对齐)，大块使用对齐的全局new。
+class PoolResource : public std::pmr::memory_resource {
+public:
+    explicit PoolResource(MemoryPool& pool = MemoryPool::GetInstance()) noexcept : pool_(&pool) {}
+
+    // 使用全局内存池的实例
+    static PoolResource* GetInstance();
+
+    MemoryPool& GetPool() const { return *pool_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    MemoryPool* pool_;
+};
+
+} // namespace ai_backend::core::memory
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ai_backend::core::memory {
+
+// 按子系统统计内存的标签
+enum class MemoryTag : uint8_t {
+    kHttp,          // HTTP会话的读缓冲区和请求级arena
+    kWebSocket,     // WebSocket读缓冲区和发送队列
+    kRateLimit,     // 限流器的请求历史
+    kDb,            // 数据库层的缓冲区和预处理语句
+    kAiStream,      // 上游流式响应的解析缓冲区和生成内容
+    kCache,         // 进程内缓存
+};
+
+inline constexpr size_t kMemoryTagCount = 6;
+
+// 标签名称，用于统计接口和profile的查询参数
+const char* GetMemoryTagName(MemoryTag tag);
+std::optional<MemoryTag> ParseMemoryTag(std::string_view name);
+
+// 单个标签的统计
+struct MemoryTagStats {
+    MemoryTag tag = MemoryTag::kHttp;
+    uint64_t live_bytes = 0;        // 当前持有的字节数
+    uint64_t peak_bytes = 0;        // 持有字节数的峰值
+    uint64_t allocations = 0;       // 累计分配次数
+    uint64_t deallocations = 0;     // 累计释放次数
+    uint64_t allocated_bytes = 0;   // 累计分配的字节数
+    double bytes_per_second = 0.0;  // 最近一个统计周期的分配速率
+    double allocations_per_second = 0.0;
+};
+
+// 采样的统计
+struct MemoryProfileStats {
+    size_t sample_interval = 0;     // 平均采样间隔 (字节)，0表示未开启
+    uint64_t samples = 0;           // 累计采样次数
+    uint64_t live_samples = 0;      // 尚未释放的采样分配
+    uint64_t dropped = 0;           // 采样表已满而丢弃的采样
+};
+
+// 按子系统的内存记账和分配采样
+// 各子系统通过TrackedResource分配内存。分配和释放先记在线程本地的计数上，每kFlushOps次操作
+// 或净变化超过kFlushBytes时合并到标签的全局计数器 (线程退出时也会合并)，因此每个线程的
+// 统计最多滞后kFlushBytes，峰值在合并时更新。
+// 开启采样后，每个线程平均每分配sample_interval字节 (按指数分布随机取间隔) 记录一次调用栈，
+// 采样的分配在释放前计入"在用"，DumpHeapProfile按gperftools的heap profile文本格式
+// (heap_v2) 输出，可以直接交给pprof分析。
+class MemoryTracker {
+public:
+    // 采样调用栈的最大深度
+    static constexpr size_t kMaxStackDepth = 32;
+
+    // 同时在用的采样分配上限
+    static constexpr size_t kMaxLiveSamples = 4096;
+
+    // 线程本地计数合并到全局计数器的阈值
+    static constexpr uint32_t kFlushOps = 64;
+    static constexpr int64_t kFlushBytes = 64 * 1024;
+
+    static MemoryTracker& GetInstance();
+
+    MemoryTracker();
+    ~MemoryTracker();
+
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    // 记录分配，已开启采样且到达采样点时记录ptr的调用栈
+    void RecordAllocation(MemoryTag tag, void* ptr, size_t bytes);
+    void RecordDeallocation(MemoryTag tag, void* ptr, size_t bytes);
+
+    // 把当前线程累积的计数合并到全局计数器
+    void Flush();
+
+    // 根据上次调用以来的累计分配计算各标签的分配速率，由调用方定期调用
+    void UpdateRates();
+
+    std::vector<MemoryTagStats> GetStats() const;
+
+    // 把峰值重置为当前持有的字节数
+    void ResetPeaks();
+
+    // 设置平均采样间隔，0关闭采样 (已采样的分配保留到释放)
+    void SetSampleInterval(size_t bytes);
+
+    MemoryProfileStats GetProfileStats() const;
+
+    // 在用的采样分配，tag为空时包括所有标签
+    std::string DumpHeapProfile(std::optional<MemoryTag> tag = std::nullopt) const;
+
+private:
+    struct alignas(64) Counters {
+        std::atomic<uint64_t> live_bytes{0};
+        std::atomic<uint64_t> peak_bytes{0};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> deallocations{0};
+        std::atomic<uint64_t> allocated_bytes{0};
+    };
+
+    // 同一调用栈的采样累计
+    struct StackKey {
+        MemoryTag tag;
+        std::vector<void*> frames;
+
+        bool operator<(const StackKey& other) const {
+            return tag != other.tag ? tag < other.tag : frames < other.frames;
+        }
+    };
+
+    struct StackTotals {
+        uint64_t alloc_count = 0;
+        uint64_t alloc_bytes = 0;
+        uint64_t inuse_count = 0;
+        uint64_t inuse_bytes = 0;
+    };
+
+    using StackMap = std::map<StackKey, StackTotals>;
+
+    // 在用的采样分配
+    struct LiveSample {
+        size_t bytes = 0;
+        StackMap::iterator stack;
+    };
+
+    // 合并一个线程的计数
+    void FlushCounters(size_t tag, int64_t live, uint64_t allocations, uint64_t deallocations,
+                       uint64_t allocated_bytes);
+
+    // 线程本地的采样倒计数，到达采样点时返回true并重新抽取间隔
+    bool ShouldSample(size_t bytes);
+
+    void RecordSample(MemoryTag tag, void* ptr, size_t bytes);
+    void RemoveSample(void* ptr);
+
+private:
+    std::array<Counters, kMemoryTagCount> counters_;
+
+    // 速率计算的上一次快照
+    mutable std::mutex rate_mutex_;
+    std::chrono::steady_clock::time_point rate_updated_at_;
+    std::array<uint64_t, kMemoryTagCount> last_allocations_{};
+    std::array<uint64_t, kMemoryTagCount> last_allocated_bytes_{};
+    std::array<double, kMemoryTagCount> bytes_per_second_{};
+    std::array<double, kMemoryTagCount> allocations_per_second_{};
+
+    std::atomic<size_t> sample_interval_{0};
+    // 最近一次开启采样时的间隔，关闭采样后导出的profile仍按它还原
+    std::atomic<size_t> profile_interval_{0};
+    std::atomic<uint64_t> live_samples_{0};
+    std::atomic<uint64_t> samples_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    // 采样分配的地址，释放时无锁查找：从地址的散列位置起探测kProbeLength个槽位
+    std::unique_ptr<std::atomic<uintptr_t>[]> sample_slots_;
+    std::unique_ptr<LiveSample[]> sample_records_;
+
+    // 保护调用栈累计和sample_records_
+    mutable std::mutex profile_mutex_;
+    StackMap stacks_;
+};
+
+// 把分配记入标签的std::pmr适配，默认从全局内存池分配
+// 各子系统的容器使用ForTag返回的共享实例，例如：
+//     std::pmr::vector<int> values(TrackedResource::ForTag(MemoryTag::kRateLimit));
+class TrackedResource : public std::pmr::memory_resource {
+public:
+    explicit TrackedResource(MemoryTag tag, std::pmr::memory_resource* upstream = nullptr);
+
+    // 标签的共享实例，上游为PoolResource::GetInstance()
+    static TrackedResource* ForTag(MemoryTag tag);
+
+    MemoryTag GetTag() const { return tag_; }
+    std::pmr::memory_resource* GetUpstream() const { return upstream_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    MemoryTag tag_;
+    std::pmr::memory_resource* upstream_;
+    MemoryTracker& tracker_;
+};
+
+} // namespace ai_backend::core::memory
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace ai_backend::core::memory {
+
+// 所有请求arena的累计统计
+struct RequestArenaStats {
+    uint64_t requests = 0;          // Reset次数 (即处理过的请求数)
+    uint64_t allocations = 0;       // 累计分配次数
+    uint64_t bytes = 0;             // 累计分配字节数
+    uint64_t overflows = 0;         // 超出初始缓冲区、向上游申请过内存的请求数
+};
+
+// 请求级单调分配器
+// 分配只移动指针，释放是空操作，Reset一次性回收本次请求的全部内存。
+// 初始缓冲区从上游申请一次并跨请求复用，用尽后按几何增长向上游 (默认为全局MemoryPool) 申请，
+// 这部分在Reset时归还。不是线程安全的，同一时刻只能由一个请求使用。
+class RequestArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kDefaultInitialSize = 16 * 1024;
+
+    explicit RequestArena(size_t initial_size = kDefaultInitialSize,
+                          std::pmr::memory_resource* upstream = nullptr);
+    ~RequestArena() override;
+
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    // 回收本次请求的全部内存，计数累加到全局统计
+    void Reset();
+
+    // 本次请求 (上次Reset以来) 的分配次数和字节数
+    size_t GetAllocations() const { return allocations_; }
+    size_t GetBytesAllocated() const { return bytes_; }
+
+    static RequestArenaStats GetStats();
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    std::pmr::memory_resource* upstream_;
+    size_t initial_size_;
+    void* initial_buffer_;
+    std::pmr::monotonic_buffer_resource resource_;
+    size_t allocations_ = 0;
+    size_t bytes_ = 0;
+};
+
+// 会话持有的可复用arena
+// 每个请求借出一个arena，归还时Reset并留给下一个请求。响应写出与下一次读取可能与
+// 处理协程的收尾并发，借出期间再次借用时临时新建一个，不会有两个请求共用同一个arena。
+class RequestArenaSlot {
+public:
+    class Lease {
+    public:
+        Lease(RequestArenaSlot& slot, RequestArena* arena) noexcept : slot_(&slot), arena_(arena) {}
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        RequestArena* operator->() const noexcept { return arena_; }
+        RequestArena& operator*() const noexcept { return *arena_; }
+        RequestArena* Get() const noexcept { return arena_; }
+
+    private:
+        RequestArenaSlot* slot_;
+        RequestArena* arena_;
+    };
+
+    explicit RequestArenaSlot(size_t initial_size = RequestArena::kDefaultInitialSize,
+                              std::pmr::memory_resource* upstream = nullptr) noexcept
+        : initial_size_(initial_size), upstream_(upstream) {}
+    ~RequestArenaSlot();
+
+    RequestArenaSlot(const RequestArenaSlot&) = delete;
+    RequestArenaSlot& operator=(const RequestArenaSlot&) = delete;
+
+    Lease Acquire();
+
+private:
+    void Return(RequestArena* arena) noexcept;
+
+private:
+    size_t initial_size_;
+    std::pmr::memory_resource* upstream_;
+    std::atomic<RequestArena*> spare_{nullptr};
+};
+
+} // namespace ai_backend::core::memory
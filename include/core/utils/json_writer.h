@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ai_backend::core::utils {
+
+// 直接把JSON追加到字符串，不构造DOM
+// 逗号和冒号由写入器插入，括号配对和键值交替由调用方保证。
+// 字符串按JSON规则转义，非ASCII字节原样输出 (要求输入为UTF-8)。
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out_(out) {}
+
+    JsonWriter& BeginObject();
+    JsonWriter& EndObject();
+    JsonWriter& BeginArray();
+    JsonWriter& EndArray();
+
+    JsonWriter& Key(std::string_view key);
+
+    JsonWriter& String(std::string_view value);
+    JsonWriter& Int(int64_t value);
+    JsonWriter& Uint(uint64_t value);
+    JsonWriter& Bool(bool value);
+    JsonWriter& Null();
+
+    // 追加转义后的字符串内容 (不含引号)
+    static void AppendEscaped(std::string& out, std::string_view value);
+
+private:
+    // 同一层的第二个及以后的元素前插入逗号
+    void BeginValue();
+
+private:
+    std::string& out_;
+    bool need_comma_ = false;
+};
+
+} // namespace ai_backend::core::utils
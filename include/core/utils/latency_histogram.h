@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+namespace ai_backend::core::utils {
+
+// 无锁的对数分桶延迟直方图
+// 第i个桶统计[2^(i-1), 2^i)微秒的样本，第0个桶统计不足1微秒的样本，最后一个桶不设上限。
+// Record只做几次relaxed原子操作，可以在IO线程的热路径上调用；快照不是严格一致的，用于导出指标。
+class LatencyHistogram {
+public:
+    static constexpr size_t kBuckets = 32;
+
+    struct Snapshot {
+        std::array<uint64_t, kBuckets> buckets{};
+        uint64_t count = 0;
+        uint64_t sum_us = 0;
+        uint64_t max_us = 0;
+
+        // 第i个桶的上界 (微秒)
+        static uint64_t BucketUpperBound(size_t index) { return uint64_t{1} << index; }
+
+        // 分位数所在桶的上界 (微秒)，没有样本时返回0
+        uint64_t Percentile(double p) const {
+            if (count == 0) {
+                return 0;
+            }
+            auto target = static_cast<uint64_t>(p * static_cast<double>(count - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kBuckets; ++i) {
+                seen += buckets[i];
+                if (seen >= target) {
+                    return i + 1 == kBuckets ? max_us : std::min(BucketUpperBound(i), max_us);
+                }
+            }
+            return max_us;
+        }
+
+        double Mean() const { return count == 0 ? 0.0 : static_cast<double>(sum_us) / count; }
+    };
+
+    void Record(std::chrono::nanoseconds value) {
+        auto us = static_cast<uint64_t>(std::max<int64_t>(0, value.count() / 1000));
+        size_t index = std::min<size_t>(std::bit_width(us), kBuckets - 1);
+        buckets_[index].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_us_.fetch_add(us, std::memory_order_relaxed);
+
+        uint64_t max = max_us_.load(std::memory_order_relaxed);
+        while (us > max && !max_us_.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+        }
+    }
+
+    Snapshot GetSnapshot() const {
+        Snapshot snapshot;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        }
+        snapshot.count = count_.load(std::memory_order_relaxed);
+        snapshot.sum_us = sum_us_.load(std::memory_order_relaxed);
+        snapshot.max_us = max_us_.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    void Reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_us_.store(0, std::memory_order_relaxed);
+        max_us_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_us_{0};
+    std::atomic<uint64_t> max_us_{0};
+};
+
+} // namespace ai_backend::core::utils
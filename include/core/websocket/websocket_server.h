@@ -4,13 +4,14 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
-#include <thread>
 #include <vector>
 
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 
+#include "core/async/runtime.h"
 #include "websocket_session.h"
 
 namespace ai_backend::core::websocket {
@@ -28,7 +29,8 @@ public:
     using CloseHandler = std::function<void(const std::string&)>;
     using DisconnectHandler = std::function<void(const std::string&)>;
     
-    WebSocketServer(uint16_t port, size_t thread_count = 0);
+    // 接受器在运行时的第0个io_context上，连接轮流分给各io_context
+    explicit WebSocketServer(uint16_t port, async::Runtime& runtime = async::Runtime::GetInstance());
     ~WebSocketServer();
     
     void Start();
@@ -49,14 +51,11 @@ private:
     
 private:
     uint16_t port_;
-    size_t thread_count_;
+    async::Runtime& runtime_;
     std::atomic<bool> running_;
     std::atomic<size_t> active_connections_;
     
-    net::io_context io_context_;
-    std::optional<net::executor_work_guard<net::io_context::executor_type>> work_guard_;
     tcp::acceptor acceptor_;
-    std::vector<std::thread> worker_threads_;
     
     std::mutex sessions_mutex_;
     std::vector<std::shared_ptr<WebSocketSession>> sessions_;
@@ -1,14 +1,18 @@
 #pragma once
 
 #include <atomic>
-#include <deque>
 #include <functional>
-#include <mutex>
+#include <memory>
+#include <memory_resource>
 #include <string>
 
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 
+#include "core/async/channel.h"
+#include "core/async/task.h"
+#include "core/async/timer_wheel.h"
+
 namespace ai_backend::core::websocket {
 
 namespace beast = boost::beast;
@@ -37,6 +41,8 @@ public:
     void Start();
     void Close();
     
+    // 把消息放入发送队列，由会话的写协程按顺序写出，不阻塞调用线程
+    // 会话已关闭或队列已满 (对端读取过慢) 时返回false
     bool Send(const std::string& message);
     void AsyncSend(const std::string& message);
     
@@ -47,25 +53,32 @@ private:
     void OnAccept(beast::error_code ec);
     void ReadMessage();
     void OnRead(beast::error_code ec, std::size_t bytes_transferred);
-    void WriteMessage();
-    void OnWrite(beast::error_code ec, std::size_t bytes_transferred);
+    static core::async::Task<void> WriteLoop(std::shared_ptr<WebSocketSession> self);
     void HandleClose();
     void HandleError(beast::error_code ec, const char* what);
+    void OnIdleTimeout();
     
 private:
     websocket::stream<tcp::socket> ws_;
-    beast::flat_buffer buffer_;
+    // 读缓冲区和发送队列中的消息计入websocket标签
+    beast::basic_flat_buffer<std::pmr::polymorphic_allocator<char>> buffer_;
     
     MessageHandler message_handler_;
     ConnectionHandler connection_handler_;
     CloseHandler close_handler_;
     DisconnectHandler disconnect_handler_;
     
-    std::mutex write_mutex_;
-    std::deque<std::string> outgoing_messages_;
+    // 待发送的消息，写协程在会话的strand上逐条写出，关闭后写完剩余消息再发送关闭帧
+    core::async::Channel<std::pmr::string> outgoing_;
     
     std::string client_id_;
     std::atomic<bool> closed_;
+    std::atomic<bool> accepted_{false};
+    
+    // 握手和空闲超时使用io_context的时间轮，代替beast每个连接各自的定时器；
+    // 最后声明，析构时最先取消
+    core::async::TimerWheel& wheel_;
+    core::async::TimerWheel::Timer idle_timer_;
 };
 
 } // namespace ai_backend::core::websocket
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include <nlohmann/json.hpp>
@@ -32,4 +33,69 @@ struct Message {
     static Message FromJson(const nlohmann::json& json);
 };
 
+// 分配器感知的变体，字段从构造时给定的内存资源 (通常是请求级arena) 分配，
+// 用于只在单个请求内使用、随请求一起回收的查询结果
+namespace pmr {
+
+struct Attachment {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    
+    std::pmr::string id;
+    std::pmr::string type;
+    std::pmr::string name;
+    std::pmr::string url;
+    
+    explicit Attachment(allocator_type alloc = {})
+        : id(alloc), type(alloc), name(alloc), url(alloc) {}
+    
+    Attachment(const Attachment& other, allocator_type alloc = {})
+        : id(other.id, alloc), type(other.type, alloc), name(other.name, alloc), url(other.url, alloc) {}
+    
+    Attachment(Attachment&& other, allocator_type alloc)
+        : id(std::move(other.id), alloc), type(std::move(other.type), alloc),
+          name(std::move(other.name), alloc), url(std::move(other.url), alloc) {}
+    
+    Attachment(Attachment&&) = default;
+    Attachment& operator=(const Attachment&) = default;
+    Attachment& operator=(Attachment&&) = default;
+    
+    allocator_type get_allocator() const { return id.get_allocator(); }
+};
+
+struct Message {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    
+    std::pmr::string id;
+    std::pmr::string dialog_id;
+    std::pmr::string role;
+    std::pmr::string content;
+    std::pmr::string type;
+    size_t tokens = 0;
+    std::pmr::string created_at;
+    std::pmr::vector<Attachment> attachments;
+    
+    explicit Message(allocator_type alloc = {})
+        : id(alloc), dialog_id(alloc), role(alloc), content(alloc), type(alloc),
+          created_at(alloc), attachments(alloc) {}
+    
+    Message(const Message& other, allocator_type alloc = {})
+        : id(other.id, alloc), dialog_id(other.dialog_id, alloc), role(other.role, alloc),
+          content(other.content, alloc), type(other.type, alloc), tokens(other.tokens),
+          created_at(other.created_at, alloc), attachments(other.attachments, alloc) {}
+    
+    Message(Message&& other, allocator_type alloc)
+        : id(std::move(other.id), alloc), dialog_id(std::move(other.dialog_id), alloc),
+          role(std::move(other.role), alloc), content(std::move(other.content), alloc),
+          type(std::move(other.type), alloc), tokens(other.tokens),
+          created_at(std::move(other.created_at), alloc), attachments(std::move(other.attachments), alloc) {}
+    
+    Message(Message&&) = default;
+    Message& operator=(const Message&) = default;
+    Message& operator=(Message&&) = default;
+    
+    allocator_type get_allocator() const { return id.get_allocator(); }
+};
+
+} // namespace pmr
+
 } // namespace ai_backend::models
\ No newline at end of file
@@ -41,6 +41,9 @@ public:
 
 private:
     ModelFactory() = default;
+    
+    // 预热到模型API的上游连接
+    void PrewarmConnections();
 
     using ModelCreator = std::function<std::shared_ptr<ModelInterface>()>;
     std::unordered_map<std::string, ModelCreator> model_creators_;
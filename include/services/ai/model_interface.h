@@ -1,17 +1,47 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "core/async/deadline.h"
 #include "core/async/task.h"
 #include "models/message.h"
 #include "common/result.h"
 
 namespace ai_backend::services::ai {
 
+// 单次请求的token用量和耗时
+struct TokenUsage {
+    size_t prompt_tokens = 0;
+    size_t completion_tokens = 0;
+
+    // 命中上游上下文缓存的提示token数
+    size_t cache_hit_tokens = 0;
+
+    // 从发出请求到收到第一个生成token的时间，非流式请求等于总耗时
+    std::chrono::milliseconds time_to_first_token{0};
+
+    // 请求总耗时
+    std::chrono::milliseconds total_latency{0};
+
+    // 上游未返回用量时为本地估算值
+    bool estimated = false;
+
+    size_t GetTotalTokens() const {
+        return prompt_tokens + completion_tokens;
+    }
+};
+
+// 非流式生成的结果
+struct ModelReply {
+    std::string content;
+    TokenUsage usage;
+};
+
 // 模型接口类，定义所有AI模型必须实现的接口
 class ModelInterface {
 public:
@@ -24,6 +54,9 @@ public:
         double presence_penalty = 0.0;
         std::vector<std::string> stop_sequences;
         std::unordered_map<std::string, std::string> additional_params;
+        
+        // 所属请求的截止时间，传递给上游请求
+        core::async::Deadline deadline;
     };
 
     // 流式响应回调类型
@@ -46,31 +79,20 @@ public:
     // 检查模型是否支持流式输出
     virtual bool SupportsStreaming() const = 0;
 
-    // 非流式生成回复
-    virtual core::async::Task<common::Result<std::string>> 
+    // 非流式生成回复，结果包含本次请求的用量
+    // 模型实例在所有请求间共享，实现不能保存任何单次请求的状态
+    virtual core::async::Task<common::Result<ModelReply>> 
     GenerateResponse(const std::vector<models::Message>& messages, 
-                    const ModelConfigconst ModelConfig& config = {} config = ModelConfig()) = 0;
+                    const ModelConfig& config) = 0;
     
-    // 流式生成回复
-    virtual core::async::Task<common::Result<void>> 
+    // 流式生成回复，内容通过callback交付，结果为本次请求的用量
+    virtual core::async::Task<common::Result<TokenUsage>> 
     GenerateStreamingResponse(const std::vector<models::Message>& messages,
                              StreamCallback callback,
-                             const ModelConfigconst ModelConfig& config = {} config = ModelConfig()) = 0;
-    
-    // 获取最后请求的Token数量
-    virtual size_t GetLastPromptTokens() const = 0;
-    
-    // 获取最后响应的Token数量
-    virtual size_t GetLastCompletionTokens() const = 0;
-    
-    // 获取最后一次请求的总Token数量
-    virtual size_t GetLastTotalTokens() const = 0;
+                             const ModelConfig& config) = 0;
     
     // 获取模型服务状态
     virtual bool IsHealthy() const = 0;
-    
-    // 重置模型状态
-    virtual void Reset() = 0;
 };
 
 } // namespace ai_backend::services::ai
\ No newline at end of file
@@ -37,29 +37,21 @@ public:
     common::Result<ModelInfo> GetModelInfo(const std::string& model_id) const;
     std::vector<ModelInfo> GetAllModelsInfo() const;
 
-    // 使用指定模型生成回复
-    core::async::Task<common::Result<std::string>> 
+    // 使用指定模型生成回复，结果包含本次请求的用量
+    core::async::Task<common::Result<ModelReply>> 
     GenerateResponse(const std::string& model_id,
                     const std::vector<models::Message>& messages,
                     const ModelInterface::ModelConfig& config = {});
 
-    // 使用指定模型生成流式回复
-    core::async::Task<common::Result<void>> 
+    // 使用指定模型生成流式回复，结果为本次请求的用量
+    core::async::Task<common::Result<TokenUsage>> 
     GenerateStreamingResponse(const std::string& model_id,
                              const std::vector<models::Message>& messages,
                              ModelInterface::StreamCallback callback,
                              const ModelInterface::ModelConfig& config = {});
 
-    // 获取指定模型的Token使用情况
-    common::Result<size_t> GetLastPromptTokens(const std::string& model_id) const;
-    common::Result<size_t> GetLastCompletionTokens(const std::string& model_id) const;
-    common::Result<size_t> GetLastTotalTokens(const std::string& model_id) const;
-
     // 检查模型健康状态
     bool IsModelHealthy(const std::string& model_id) const;
-    
-    // 重置指定模型状态
-    void ResetModel(const std::string& model_id);
 
 private:
     ModelService() = default;
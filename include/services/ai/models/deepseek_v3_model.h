@@ -1,12 +1,17 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <chrono>
+#include <optional>
 
 #include "services/ai/model_interface.h"
-#include "core/http/request.h"
+#include "core/http/upstream_client.h"
+#include "services/ai/streaming/delta_extractor.h"
+#include "services/ai/tokenizer/bpe_tokenizer.h"
 #include "core/async/task.h"
 #include "common/result.h"
 
@@ -25,42 +30,45 @@ public:
     std::vector<std::string> GetCapabilities() const override;
     bool SupportsStreaming() const override;
 
-    core::async::Task<common::Result<std::string>> 
+    core::async::Task<common::Result<ModelReply>> 
     GenerateResponse(const std::vector<models::Message>& messages, 
                     const ModelConfig& config = {}) override;
     
-    core::async::Task<common::Result<void>> 
+    core::async::Task<common::Result<TokenUsage>> 
     GenerateStreamingResponse(const std::vector<models::Message>& messages,
                              StreamCallback callback,
                              const ModelConfig& config = {}) override;
     
-    size_t GetLastPromptTokens() const override;
-    size_t GetLastCompletionTokens() const override;
-    size_t GetLastTotalTokens() const override;
     bool IsHealthy() const override;
-    void Reset() override;
 
 private:
     // 构建API请求
-    core::http::Request BuildAPIRequest(const std::vector<models::Message>& messages,
-                                     const ModelConfig& config,
-                                     bool stream) const;
+    core::http::UpstreamRequest BuildAPIRequest(const std::vector<models::Message>& messages,
+                                                const ModelConfig& config,
+                                                bool stream) const;
     
     // 解析API响应
-    common::Result<std::string> ParseAPIResponse(const std::string& response);
+    common::Result<ModelReply> ParseAPIResponse(const std::string& response,
+                                                const std::vector<models::Message>& messages) const;
     
-    // 处理流式响应
-    void HandleStreamChunk(const std::string& chunk, StreamCallback callback, bool& is_done);
+    // 处理一个SSE事件的data，提取内容增量和上游返回的用量，有生成内容时返回true
+    // 生成的内容同时交给counter计数，上游未返回用量时使用
+    bool HandleStreamChunk(std::string_view data,
+                           streaming::DeltaExtractor& extractor,
+                           std::optional<streaming::StreamUsage>& usage,
+                           tokenizer::StreamingTokenCounter& counter,
+                           StreamCallback callback,
+                           bool& is_done) const;
     
-    // 计算并记录token数量
-    void CalculateAndStoreTokenCounts(const std::vector<models::Message>& messages, 
-                                     const std::string& response);
+    // 上游未返回用量时用本地分词器计算token数量
+    static TokenUsage EstimateTokenUsage(const std::vector<models::Message>& messages, 
+                                         const std::string& response);
 
 private:
     std::string api_key_;
     std::string api_base_url_;
-    std::atomic<size_t> last_prompt_tokens_;
-    std::atomic<size_t> last_completion_tokens_;
+    std::chrono::milliseconds request_timeout_;
+    std::chrono::milliseconds connect_timeout_;
     std::atomic<bool> is_healthy_;
     
     // 支持的模型列表
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include "services/ai/model_interface.h"
+#include "services/ai/streaming/delta_extractor.h"
+
+namespace ai_backend::services::ai {
+
+// DeepSeek (OpenAI兼容) 响应中usage对象的解析，V3和R1模型的非流式响应共用
+// 命中缓存的提示token数取prompt_cache_hit_tokens，没有时取prompt_tokens_details.cached_tokens，
+// 与流式响应的DeltaExtractor一致
+TokenUsage ParseTokenUsage(const nlohmann::json& usage);
+
+// 流式响应最后一个chunk中的用量，耗时由调用方填写
+TokenUsage ToTokenUsage(const streaming::StreamUsage& usage);
+
+} // namespace ai_backend::services::ai
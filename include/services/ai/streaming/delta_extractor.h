@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <nlohmann/json_fwd.hpp>
+
+namespace ai_backend::services::ai::streaming {
+
+// 上游返回的token用量
+struct StreamUsage {
+    int64_t prompt_tokens = 0;
+    int64_t completion_tokens = 0;
+    int64_t total_tokens = 0;
+
+    // 命中上下文缓存的提示token数 (prompt_cache_hit_tokens或prompt_tokens_details.cached_tokens)
+    int64_t cache_hit_tokens = 0;
+};
+
+// 解析usage对象，非数值的字段按0处理
+// cache_hit_tokens取prompt_cache_hit_tokens (DeepSeek)，没有时取prompt_tokens_details.cached_tokens (OpenAI)
+StreamUsage ParseUsage(const nlohmann::json& usage);
+
+// 从一个chat.completion.chunk中提取的增量字段
+// 视图指向输入数据或DeltaExtractor的内部缓冲区，在下一次Extract之前有效
+struct StreamDelta {
+    std::string_view content;
+    std::string_view reasoning_content;
+    std::string_view finish_reason;
+    std::optional<StreamUsage> usage;
+};
+
+// OpenAI兼容流式响应的快速字段提取器
+// 单遍扫描JSON，只读取choices[0].delta.content/reasoning_content、
+// choices[0].finish_reason和usage，其余值直接跳过而不构建DOM。
+// 不含转义的字符串直接以视图返回，含转义的字符串解码到可复用的缓冲区。
+// 遇到无法处理的结构 (类型不符、格式错误等) 时回退到nlohmann::json完整解析。
+// 每个流使用一个实例，不是线程安全的。
+class DeltaExtractor {
+public:
+    DeltaExtractor() = default;
+
+    // 提取字段，数据不是合法JSON时返回false
+    bool Extract(std::string_view chunk, StreamDelta& delta);
+
+    // 回退到完整解析的次数
+    size_t GetFallbackCount() const { return fallback_count_; }
+
+private:
+    class Scanner;
+
+    // 完整解析路径
+    bool ExtractWithDom(std::string_view chunk, StreamDelta& delta);
+
+private:
+    std::string content_buffer_;
+    std::string reasoning_buffer_;
+    std::string finish_reason_buffer_;
+    size_t fallback_count_ = 0;
+};
+
+} // namespace ai_backend::services::ai::streaming
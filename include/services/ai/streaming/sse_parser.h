@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace ai_backend::services::ai::streaming {
+
+// 一个完整的SSE事件，字段是视图，在下一次调用SseParser::Next或Feed之前有效
+struct SseEvent {
+    // event字段，未指定时为"message"
+    std::string_view event;
+
+    // 所有data行以'\n'连接后的内容
+    std::string_view data;
+
+    // 最近一次的id字段 (按规范在事件之间保留)
+    std::string_view id;
+};
+
+// 增量SSE (text/event-stream) 解析器
+// 输入可以在任意字节处切分，支持CR/LF/CRLF换行、多行data、event/id/retry字段和注释行。
+// 完整落在当前输入块内的单行字段直接以视图返回，只有跨块的行和多行data才会复制。
+//
+// 用法：
+//     parser.Feed(bytes);
+//     SseEvent event;
+//     while (parser.Next(event)) { ... }
+class SseParser {
+public:
+    // 单行最大长度，超出后解析器进入错误状态
+    static constexpr size_t kDefaultMaxLineSize = 1 << 20;
+
+    // 跨块的行和事件字段从resource分配，默认计入ai-stream内存标签
+    explicit SseParser(size_t max_line_size = kDefaultMaxLineSize,
+                       std::pmr::memory_resource* resource = nullptr);
+
+    // 提供下一段输入，调用前必须已经用Next取完上一段输入中的事件
+    void Feed(std::string_view bytes);
+
+    // 取出下一个完整事件，当前输入耗尽时返回false，未完成的行和事件保留到下一次Feed
+    bool Next(SseEvent& event);
+
+    // 服务端通过retry字段建议的重连间隔 (毫秒)
+    std::optional<uint32_t> GetRetryMs() const { return retry_ms_; }
+
+    // 是否因行过长进入错误状态
+    bool HasError() const { return has_error_; }
+
+    // 丢弃所有状态，用于复用解析器
+    void Reset();
+
+private:
+    // 读取下一行，输入耗尽时返回false
+    bool ReadLine(std::string_view& line);
+
+    // 处理一行，遇到空行且有data时返回true
+    bool ProcessLine(std::string_view line, SseEvent& event);
+
+    // 把指向输入块的字段视图复制到自有存储，在输入块失效前调用
+    void PinPendingFields();
+
+    // 清空当前事件的字段
+    void ResetPendingEvent();
+
+private:
+    size_t max_line_size_;
+
+    // 当前输入块和读取位置
+    std::string_view input_;
+    size_t position_ = 0;
+
+    // 跨输入块的不完整行
+    std::pmr::string partial_line_;
+    bool has_partial_line_ = false;
+
+    // 上一块以'\r'结尾，下一块开头的'\n'属于同一个换行
+    bool pending_cr_ = false;
+
+    // 是否已经检查过流开头的UTF-8 BOM
+    bool bom_checked_ = false;
+
+    // 正在组装的事件，视图指向输入块、partial_line_或下面的自有存储
+    std::string_view event_type_;
+    std::string_view data_;
+    bool has_data_ = false;
+    std::pmr::string event_type_storage_;
+    std::pmr::string data_storage_;
+
+    std::pmr::string last_event_id_;
+    std::optional<uint32_t> retry_ms_;
+    bool has_error_ = false;
+};
+
+} // namespace ai_backend::services::ai::streaming
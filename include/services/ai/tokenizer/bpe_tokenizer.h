@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common/result.h"
+
+namespace ai_backend::services::ai::tokenizer {
+
+using TokenId = uint32_t;
+
+// 返回从start开始的预分词片段的结束位置
+// 规则与DeepSeek/cl100k的预分词一致：数字按1~3位切分，CJK连续字符单独成段，
+// 其余部分按"缩写 | 可选前缀+字母串 | 可选空格+标点串+换行 | 含换行的空白 | 空白"切分。
+// Unicode字母类别按码点区间近似判断，ASCII字母串用SIMD扫描。
+size_t NextPretokenEnd(std::string_view text, size_t start);
+
+// 没有词表时的近似估算：ASCII按4字节1个token，其余字符 (主要是中文) 按每字0.6个token
+size_t EstimateTokens(std::string_view text);
+
+// 字节级BPE分词器
+// 词表和合并规则存放在一块连续的只读映像中：token表、按字节内容索引的开放寻址哈希表、
+// 按(左token, 右token)索引的合并表和token字节串。映像可以从tokenizer.json构建，
+// 也可以保存为二进制文件后通过mmap直接加载，多个进程共享同一份物理页。
+// 加载后只读，可以在所有线程间共享。
+class BpeTokenizer {
+public:
+    ~BpeTokenizer();
+
+    BpeTokenizer(const BpeTokenizer&) = delete;
+    BpeTokenizer& operator=(const BpeTokenizer&) = delete;
+
+    // 加载HuggingFace格式的tokenizer.json或SaveCompiled生成的二进制文件
+    static common::Result<std::shared_ptr<BpeTokenizer>> LoadFromFile(const std::string& path);
+
+    // 由原始字节形式的词表 (下标即token id) 和按优先级排序的合并规则构建
+    static common::Result<std::shared_ptr<BpeTokenizer>> Build(
+        const std::vector<std::string>& tokens,
+        const std::vector<std::pair<std::string, std::string>>& merges);
+
+    // 保存为可mmap加载的二进制文件
+    common::Result<void> SaveCompiled(const std::string& path) const;
+
+    // 编码，结果追加到out
+    void Encode(std::string_view text, std::vector<TokenId>& out) const;
+
+    // 只计数，不保存token
+    size_t CountTokens(std::string_view text) const;
+
+    // 解码为原始字节
+    std::string Decode(const std::vector<TokenId>& tokens) const;
+
+    size_t GetVocabSize() const;
+
+    // 是否通过mmap加载
+    bool IsMapped() const { return mapped_ != nullptr; }
+
+private:
+    struct Header;
+    struct TokenEntry;
+    struct MergeEntry;
+
+    BpeTokenizer() = default;
+
+    // 根据映像内容设置各表指针并校验
+    common::Result<void> Attach(const char* image, size_t size);
+
+    // 查找字节串对应的token
+    bool Lookup(std::string_view bytes, TokenId& id) const;
+
+    // 查找合并规则，返回优先级，不存在时返回false
+    bool FindMerge(TokenId left, TokenId right, uint32_t& rank, TokenId& merged) const;
+
+    // 对一个预分词片段执行BPE，每个token调用一次emit
+    template<typename Emit>
+    void EncodePiece(std::string_view piece, Emit&& emit) const;
+
+    template<typename Emit>
+    void MergeSmall(std::string_view piece, Emit&& emit) const;
+
+    template<typename Emit>
+    void MergeLarge(std::string_view piece, Emit&& emit) const;
+
+private:
+    // 映像来源：自有内存或mmap
+    std::vector<char> owned_;
+    void* mapped_ = nullptr;
+    size_t mapped_size_ = 0;
+
+    const Header* header_ = nullptr;
+    const TokenEntry* tokens_ = nullptr;
+    const uint32_t* vocab_slots_ = nullptr;
+    const MergeEntry* merge_slots_ = nullptr;
+    const char* blob_ = nullptr;
+
+    // 单字节token，BPE的初始符号
+    TokenId byte_tokens_[256] = {};
+};
+
+// 流式增量计数
+// 每次追加的增量先与未确定的尾部拼接再预分词，除最后一个片段外的片段都不会再变化，
+// 立即计数并丢弃，因此内存只与最后一个片段的长度有关。
+// tokenizer为空时按EstimateTokens逐段估算。
+class StreamingTokenCounter {
+public:
+    explicit StreamingTokenCounter(std::shared_ptr<const BpeTokenizer> tokenizer = nullptr);
+
+    void Append(std::string_view delta);
+
+    // 已确定的token数加上尾部片段的token数
+    size_t GetCount() const;
+
+private:
+    std::shared_ptr<const BpeTokenizer> tokenizer_;
+    std::string pending_;
+    size_t committed_ = 0;
+};
+
+} // namespace ai_backend::services::ai::tokenizer
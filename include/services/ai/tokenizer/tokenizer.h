@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "services/ai/tokenizer/bpe_tokenizer.h"
+
+namespace ai_backend::services::ai::tokenizer {
+
+// 全局分词器，供token计数和上下文预算使用
+// 配置了词表 (ai.tokenizer.path) 时使用BPE精确计数，否则回退到EstimateTokens。
+// Initialize在启动阶段调用一次，之后只读。
+class Tokenizer {
+public:
+    // 获取单例实例
+    static Tokenizer& GetInstance();
+
+    // 禁止拷贝和移动
+    Tokenizer(const Tokenizer&) = delete;
+    Tokenizer& operator=(const Tokenizer&) = delete;
+    Tokenizer(Tokenizer&&) = delete;
+    Tokenizer& operator=(Tokenizer&&) = delete;
+
+    // 从配置加载词表，加载失败时记录日志并使用估算
+    void Initialize();
+
+    // 计算文本的token数
+    size_t CountTokens(std::string_view text) const;
+
+    // 创建流式计数器
+    StreamingTokenCounter CreateStreamingCounter() const;
+
+    // 是否加载了词表
+    bool HasVocabulary() const { return bpe_ != nullptr; }
+
+private:
+    Tokenizer() = default;
+
+    std::shared_ptr<const BpeTokenizer> bpe_;
+};
+
+} // namespace ai_backend::services::ai::tokenizer
@@ -3,24 +3,27 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include "core/async/deadline.h"
 #include "core/async/task.h"
 #include "common/result.h"
 #include "models/dialog.h"
 
 namespace ai_backend::services::dialog {
 
+// 数据库操作都以调用方传入的截止时间 (通常是request.deadline) 为限，
+// 到期时DeadlineExceeded原样抛出，由路由器转换为504，其他错误仍以错误结果返回
 class DialogService {
 public:
     DialogService();
     
-    core::async::Task<common::Result<models::Dialog>> GetDialogById(const std::string& dialog_id);
-    core::async::Task<common::Result<std::vector<models::Dialog>>> GetDialogsByUserId(const std::string& user_id, int page = 1, int page_size = 20, bool include_archived = false);
+    core::async::Task<common::Result<models::Dialog>> GetDialogById(const std::string& dialog_id, core::async::Deadline deadline);
+    core::async::Task<common::Result<std::vector<models::Dialog>>> GetDialogsByUserId(const std::string& user_id, int page, int page_size, bool include_archived, core::async::Deadline deadline);
     
-    core::async::Task<common::Result<models::Dialog>> CreateDialog(const models::Dialog& dialog);
-    core::async::Task<common::Result<models::Dialog>> UpdateDialog(const models::Dialog& dialog);
-    core::async::Task<common::Result<void>> DeleteDialog(const std::string& dialog_id);
+    core::async::Task<common::Result<models::Dialog>> CreateDialog(const models::Dialog& dialog, core::async::Deadline deadline);
+    core::async::Task<common::Result<models::Dialog>> UpdateDialog(const models::Dialog& dialog, core::async::Deadline deadline);
+    core::async::Task<common::Result<void>> DeleteDialog(const std::string& dialog_id, core::async::Deadline deadline);
     
-    core::async::Task<common::Result<std::string>> ValidateDialogOwnership(const std::string& dialog_id, const std::string& user_id);
+    core::async::Task<common::Result<std::string>> ValidateDialogOwnership(const std::string& dialog_id, const std::string& user_id, core::async::Deadline deadline);
 };
 
 } // namespace ai_backend::services::dialog
\ No newline at end of file
@@ -3,22 +3,33 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include "core/async/deadline.h"
 #include "core/async/task.h"
 #include "common/result.h"
 #include "models/message.h"
 
 namespace ai_backend::services::message {
 
+// 数据库操作都以调用方传入的截止时间 (通常是request.deadline) 为限，
+// 到期时DeadlineExceeded原样抛出，由路由器转换为504，其他错误仍以错误结果返回
 class MessageService {
 public:
     MessageService();
     
-    core::async::Task<common::Result<models::Message>> GetMessageById(const std::string& message_id);
-    core::async::Task<common::Result<std::vector<models::Message>>> GetMessagesByDialogId(const std::string& dialog_id, int page = 1, int page_size = 20);
-    core::async::Task<common::Result<std::vector<models::Message>>> GetAllMessagesByDialogId(const std::string& dialog_id);
+    core::async::Task<common::Result<models::Message>> GetMessageById(const std::string& message_id,
+                                                                       core::async::Deadline deadline);
+    // 结果从memory分配，通常传入请求级arena，随请求一起回收
+    core::async::Task<common::Result<std::pmr::vector<models::pmr::Message>>> GetMessagesByDialogId(
+        const std::string& dialog_id, int page, int page_size,
+        std::pmr::memory_resource* memory, core::async::Deadline deadline);
+    core::async::Task<common::Result<std::vector<models::Message>>> GetAllMessagesByDialogId(
+        const std::string& dialog_id, core::async::Deadline deadline);
     
-    core::async::Task<common::Result<models::Message>> CreateMessage(const models::Message& message);
-    core::async::Task<common::Result<void>> DeleteMessage(const std::string& message_id);
+    core::async::Task<common::Result<models::Message>> CreateMessage(const models::Message& message,
+                                                                     core::async::Deadline deadline);
+    core::async::Task<common::Result<void>> DeleteMessage(const std::string& message_id,
+                                                          core::async::Deadline deadline);
     
     core::async::Task<common::Result<int>> CountTokens(const std::string& content);
 };
@@ -24,8 +24,8 @@ Task<Response> DialogController::GetDialogs(const Request& request) {
         }
         
         // 获取分页参数
-        int page = std::stoi(request.GetQueryParam("page", "1"));
-        int page_size = std::stoi(request.GetQueryParam("page_size", "20"));
+        int page = std::stoi(std::string(request.GetQueryParam("page", "1")));
+        int page_size = std::stoi(std::string(request.GetQueryParam("page_size", "20")));
         bool include_archived = request.GetQueryParam("include_archived", "false") == "true";
         
         // 获取对话列表
@@ -33,7 +33,8 @@ Task<Response> DialogController::GetDialogs(const Request& request) {
             request.user_id.value(), 
             page, 
             page_size, 
-            include_archived
+            include_archived,
+            request.deadline
         );
         
         if (result.IsError()) {
@@ -70,6 +71,8 @@ Task<Response> DialogController::GetDialogs(const Request& request) {
             }}
         });
         
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in GetDialogs: {}", e.what());
         co_return Response::InternalServerError({
@@ -111,7 +114,7 @@ Task<Response> DialogController::CreateDialog(const Request& request) {
         dialog.model_id = request_body["model_id"].get<std::string>();
         
         // 调用服务创建对话
-        auto result = co_await dialog_service_->CreateDialog(dialog);
+        auto result = co_await dialog_service_->CreateDialog(dialog, request.deadline);
         
         if (result.IsError()) {
             co_return Response::InternalServerError({
@@ -148,6 +151,8 @@ Task<Response> DialogController::CreateDialog(const Request& request) {
             {"message", "请求格式错误"},
             {"data", nullptr}
         });
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in CreateDialog: {}", e.what());
         co_return Response::InternalServerError({
@@ -170,10 +175,11 @@ Task<Response> DialogController::GetDialogById(const Request& request) {
         }
         
         // 获取对话ID
-        std::string dialog_id = request.GetPathParam("id");
+        std::string dialog_id(request.GetPathParam("id"));
         
         // 验证用户是否有权访问此对话
-        auto validation = co_await dialog_service_->ValidateDialogOwnership(dialog_id, request.user_id.value());
+        auto validation = co_await dialog_service_->ValidateDialogOwnership(dialog_id, request.user_id.value(),
+                                                                         request.deadline);
         if (validation.IsError()) {
             co_return Response::Forbidden({
                 {"code", 403},
@@ -183,7 +189,7 @@ Task<Response> DialogController::GetDialogById(const Request& request) {
         }
         
         // 获取对话详情
-        auto result = co_await dialog_service_->GetDialogById(dialog_id);
+        auto result = co_await dialog_service_->GetDialogById(dialog_id, request.deadline);
         
         if (result.IsError()) {
             co_return Response::NotFound({
@@ -213,6 +219,8 @@ Task<Response> DialogController::GetDialogById(const Request& request) {
             {"data", dialog_json}
         });
         
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in GetDialogById: {}", e.what());
         co_return Response::InternalServerError({
@@ -235,10 +243,11 @@ Task<Response> DialogController::UpdateDialog(const Request& request) {
         }
         
         // 获取对话ID
-        std::string dialog_id = request.GetPathParam("id");
+        std::string dialog_id(request.GetPathParam("id"));
         
         // 验证用户是否有权访问此对话
-        auto validation = co_await dialog_service_->ValidateDialogOwnership(dialog_id, request.user_id.value());
+        auto validation = co_await dialog_service_->ValidateDialogOwnership(dialog_id, request.user_id.value(),
+                                                                         request.deadline);
         if (validation.IsError()) {
             co_return Response::Forbidden({
                 {"code", 403},
@@ -251,7 +260,7 @@ Task<Response> DialogController::UpdateDialog(const Request& request) {
         json request_body = json::parse(request.body);
         
         // 获取当前对话
-        auto dialog_result = co_await dialog_service_->GetDialogById(dialog_id);
+        auto dialog_result = co_await dialog_service_->GetDialogById(dialog_id, request.deadline);
         if (dialog_result.IsError()) {
             co_return Response::NotFound({
                 {"code", 404},
@@ -272,7 +281,7 @@ Task<Response> DialogController::UpdateDialog(const Request& request) {
         }
         
         // 调用服务更新对话
-        auto result = co_await dialog_service_->UpdateDialog(dialog);
+        auto result = co_await dialog_service_->UpdateDialog(dialog, request.deadline);
         
         if (result.IsError()) {
             co_return Response::InternalServerError({
@@ -309,6 +318,8 @@ Task<Response> DialogController::UpdateDialog(const Request& request) {
             {"message", "请求格式错误"},
             {"data", nullptr}
         });
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in UpdateDialog: {}", e.what());
         co_return Response::InternalServerError({
@@ -331,10 +342,11 @@ Task<Response> DialogController::DeleteDialog(const Request& request) {
         }
         
         // 获取对话ID
-        std::string dialog_id = request.GetPathParam("id");
+        std::string dialog_id(request.GetPathParam("id"));
         
         // 验证用户是否有权访问此对话
-        auto validation = co_await dialog_service_->ValidateDialogOwnership(dialog_id, request.user_id.value());
+        auto validation = co_await dialog_service_->ValidateDialogOwnership(dialog_id, request.user_id.value(),
+                                                                         request.deadline);
         if (validation.IsError()) {
             co_return Response::Forbidden({
                 {"code", 403},
@@ -344,7 +356,7 @@ Task<Response> DialogController::DeleteDialog(const Request& request) {
         }
         
         // 调用服务删除对话
-        auto result = co_await dialog_service_->DeleteDialog(dialog_id);
+        auto result = co_await dialog_service_->DeleteDialog(dialog_id, request.deadline);
         
         if (result.IsError()) {
             co_return Response::InternalServerError({
@@ -361,6 +373,8 @@ Task<Response> DialogController::DeleteDialog(const Request& request) {
             {"data", nullptr}
         });
         
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in DeleteDialog: {}", e.what());
         co_return Response::InternalServerError({
@@ -1,6 +1,10 @@
 #include "api/controllers/message_controller.h"
+#include "core/async/when_all.h"
+#include "core/memory/memory_tracker.h"
+#include "core/utils/json_writer.h"
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
+#include <optional>
 
 namespace ai_backend::api::controllers {
 
@@ -8,6 +12,22 @@ using json = nlohmann::json;
 using namespace core::async;
 using namespace core::http;
 
+namespace {
+
+json UsageToJson(const services::ai::TokenUsage& usage) {
+    return {
+        {"prompt_tokens", usage.prompt_tokens},
+        {"completion_tokens", usage.completion_tokens},
+        {"total_tokens", usage.GetTotalTokens()},
+        {"cache_hit_tokens", usage.cache_hit_tokens},
+        {"time_to_first_token_ms", usage.time_to_first_token.count()},
+        {"total_latency_ms", usage.total_latency.count()},
+        {"estimated", usage.estimated}
+    };
+}
+
+} // namespace
+
 MessageController::MessageController(
     std::shared_ptr<services::message::MessageService> message_service,
     std::shared_ptr<services::dialog::DialogService> dialog_service)
@@ -18,7 +38,7 @@ MessageController::MessageController(
 
 Task<Response> MessageController::GetMessages(const Request& request) {
     try {
-        std::string dialog_id = request.GetPathParam("dialog_id");
+        std::string dialog_id(request.GetPathParam("dialog_id"));
         
         auto validation = co_await ValidateDialogAccess(request, dialog_id);
         if (validation.IsError()) {
@@ -30,10 +50,13 @@ Task<Response> MessageController::GetMessages(const Request& request) {
             co_return Response::Forbidden(error_json);
         }
         
-        int page = std::stoi(request.GetQueryParam("page", "1"));
-        int page_size = std::stoi(request.GetQueryParam("page_size", "50"));
+        int page = std::stoi(std::string(request.GetQueryParam("page", "1")));
+        int page_size = std::stoi(std::string(request.GetQueryParam("page_size", "50")));
         
-        auto result = co_await message_service_->GetMessagesByDialogId(dialog_id, page, page_size);
+        // 查询结果和响应头从请求级arena分配，响应体直接写出JSON，不构造DOM
+        auto* memory = request.GetMemoryResource();
+        auto result = co_await message_service_->GetMessagesByDialogId(dialog_id, page, page_size, memory,
+                                                                   request.deadline);
         
         if (result.IsError()) {
             json error_json = {
@@ -44,47 +67,60 @@ Task<Response> MessageController::GetMessages(const Request& request) {
             co_return Response::InternalServerError(error_json);
         }
         
-        json messages_json = json::array();
-        for (const auto& message : result.GetValue()) {
-            json message_json = {
-                {"id", message.id},
-                {"dialog_id", message.dialog_id},
-                {"role", message.role},
-                {"content", message.content},
-                {"type", message.type},
-                {"created_at", message.created_at},
-                {"tokens", message.tokens}
-            };
+        const auto& messages = result.GetValue();
+        
+        Response response(memory);
+        response.status_code = 200;
+        response.headers["Content-Type"] = "application/json";
+        
+        size_t estimated_size = 128;
+        for (const auto& message : messages) {
+            estimated_size += 160 + message.content.size();
+        }
+        response.body.reserve(estimated_size);
+        
+        core::utils::JsonWriter writer(response.body);
+        writer.BeginObject()
+            .Key("code").Int(0)
+            .Key("message").String("获取成功")
+            .Key("data").BeginObject()
+            .Key("messages").BeginArray();
+        for (const auto& message : messages) {
+            writer.BeginObject()
+                .Key("id").String(message.id)
+                .Key("dialog_id").String(message.dialog_id)
+                .Key("role").String(message.role)
+                .Key("content").String(message.content)
+                .Key("type").String(message.type)
+                .Key("created_at").String(message.created_at)
+                .Key("tokens").Uint(message.tokens);
             
             if (!message.attachments.empty()) {
-                json attachments_json = json::array();
+                writer.Key("attachments").BeginArray();
                 for (const auto& attachment : message.attachments) {
-                    attachments_json.push_back({
-                        {"id", attachment.id},
-                        {"type", attachment.type},
-                        {"name", attachment.name},
-                        {"url", attachment.url}
-                    });
+                    writer.BeginObject()
+                        .Key("id").String(attachment.id)
+                        .Key("type").String(attachment.type)
+                        .Key("name").String(attachment.name)
+                        .Key("url").String(attachment.url)
+                        .EndObject();
                 }
-                message_json["attachments"] = attachments_json;
+                writer.EndArray();
             }
             
-            messages_json.push_back(message_json);
+            writer.EndObject();
         }
+        writer.EndArray()
+            .Key("total").Uint(messages.size())
+            .Key("page").Int(page)
+            .Key("page_size").Int(page_size)
+            .EndObject()
+            .EndObject();
         
-        json response_json = {
-            {"code", 0},
-            {"message", "获取成功"},
-            {"data", {
-                {"messages", messages_json},
-                {"total", messages_json.size()},
-                {"page", page},
-                {"page_size", page_size}
-            }}
-        };
-        
-        co_return Response::OK(response_json);
+        co_return response;
         
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in GetMessages: {}", e.what());
         json error_json = {
@@ -98,7 +134,7 @@ Task<Response> MessageController::GetMessages(const Request& request) {
 
 Task<Response> MessageController::CreateMessage(const Request& request) {
     try {
-        std::string dialog_id = request.GetPathParam("dialog_id");
+        std::string dialog_id(request.GetPathParam("dialog_id"));
         
         auto validation = co_await ValidateDialogAccess(request, dialog_id);
         if (validation.IsError()) {
@@ -150,7 +186,7 @@ Task<Response> MessageController::CreateMessage(const Request& request) {
             }
         }
         
-        auto result = co_await message_service_->CreateMessage(message);
+        auto result = co_await message_service_->CreateMessage(message, request.deadline);
         
         if (result.IsError()) {
             json error_json = {
@@ -195,6 +231,8 @@ Task<Response> MessageController::CreateMessage(const Request& request) {
             {"data", nullptr}
         };
         co_return Response::BadRequest(error_json);
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in CreateMessage: {}", e.what());
         json error_json = {
@@ -209,9 +247,10 @@ Task<Response> MessageController::CreateMessage(const Request& request) {
 // 添加缺失的方法声明
 Task<std::vector<models::Message>> MessageController::BuildMessageContext(
     const std::string& dialog_id,
-    const std::string& message_id) {
+    const std::string& message_id,
+    Deadline deadline) {
     
-    auto messages_result = co_await message_service_->GetAllMessagesByDialogId(dialog_id);
+    auto messages_result = co_await message_service_->GetAllMessagesByDialogId(dialog_id, deadline);
     if (messages_result.IsError()) {
         throw std::runtime_error(messages_result.GetError());
     }
@@ -277,8 +316,8 @@ Task<Response> MessageController::GetReply(const Request& request) {
             co_return co_await GetStreamReply(request);
         }
         
-        std::string dialog_id = request.GetPathParam("dialog_id");
-        std::string message_id = request.GetPathParam("message_id");
+        std::string dialog_id(request.GetPathParam("dialog_id"));
+        std::string message_id(request.GetPathParam("message_id"));
         
         auto validation = co_await ValidateDialogAccess(request, dialog_id);
         if (validation.IsError()) {
@@ -290,7 +329,11 @@ Task<Response> MessageController::GetReply(const Request& request) {
             co_return Response::Forbidden(error_json);
         }
         
-        auto dialog_result = co_await dialog_service_->GetDialogById(dialog_id);
+        // 对话信息和消息上下文互不依赖，并发查询
+        auto [dialog_result, context] = co_await WhenAll(
+            CurrentExecutor(),
+            dialog_service_->GetDialogById(dialog_id, request.deadline),
+            BuildMessageContext(dialog_id, message_id, request.deadline));
         if (dialog_result.IsError()) {
             json error_json = {
                 {"code", 500},
@@ -300,8 +343,8 @@ Task<Response> MessageController::GetReply(const Request& request) {
             co_return Response::InternalServerError(error_json);
         }
         
-        auto context = co_await BuildMessageContext(dialog_id, message_id);
         auto model_config = BuildModelConfig();
+        model_config.deadline = request.deadline;
         
         auto response_result = co_await model_service_.GenerateResponse(
             dialog_result.GetValue().model_id,
@@ -318,13 +361,16 @@ Task<Response> MessageController::GetReply(const Request& request) {
             co_return Response::InternalServerError(error_json);
         }
         
+        const auto& reply = response_result.GetValue();
+        
         models::Message ai_message;
         ai_message.dialog_id = dialog_id;
         ai_message.role = "assistant";
-        ai_message.content = response_result.GetValue();
+        ai_message.content = reply.content;
         ai_message.type = "text";
+        ai_message.tokens = reply.usage.completion_tokens;
         
-        auto save_result = co_await message_service_->CreateMessage(ai_message);
+        auto save_result = co_await message_service_->CreateMessage(ai_message, request.deadline);
         
         if (save_result.IsError()) {
             json error_json = {
@@ -344,7 +390,8 @@ Task<Response> MessageController::GetReply(const Request& request) {
             {"content", created_ai_message.content},
             {"type", created_ai_message.type},
             {"created_at", created_ai_message.created_at},
-            {"tokens", created_ai_message.tokens}
+            {"tokens", created_ai_message.tokens},
+            {"usage", UsageToJson(reply.usage)}
         };
         
         json response_json = {
@@ -355,6 +402,8 @@ Task<Response> MessageController::GetReply(const Request& request) {
         
         co_return Response::OK(response_json);
         
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in GetReply: {}", e.what());
         json error_json = {
@@ -368,8 +417,8 @@ Task<Response> MessageController::GetReply(const Request& request) {
 
 Task<Response> MessageController::GetStreamReply(const Request& request) {
     try {
-        std::string dialog_id = request.GetPathParam("dialog_id");
-        std::string message_id = request.GetPathParam("message_id");
+        std::string dialog_id(request.GetPathParam("dialog_id"));
+        std::string message_id(request.GetPathParam("message_id"));
         
         auto validation = co_await ValidateDialogAccess(request, dialog_id);
         if (validation.IsError()) {
@@ -381,7 +430,11 @@ Task<Response> MessageController::GetStreamReply(const Request& request) {
             co_return Response::Forbidden(error_json);
         }
         
-        auto dialog_result = co_await dialog_service_->GetDialogById(dialog_id);
+        // 对话信息和消息上下文互不依赖，并发查询
+        auto [dialog_result, context] = co_await WhenAll(
+            CurrentExecutor(),
+            dialog_service_->GetDialogById(dialog_id, request.deadline),
+            BuildMessageContext(dialog_id, message_id, request.deadline));
         if (dialog_result.IsError()) {
             json error_json = {
                 {"code", 500},
@@ -391,8 +444,8 @@ Task<Response> MessageController::GetStreamReply(const Request& request) {
             co_return Response::InternalServerError(error_json);
         }
         
-        auto context = co_await BuildMessageContext(dialog_id, message_id);
         auto model_config = BuildModelConfig();
+        model_config.deadline = request.deadline;
         
         Response response;
         response.status_code = 200;
@@ -401,73 +454,74 @@ Task<Response> MessageController::GetStreamReply(const Request& request) {
         response.headers["Connection"] = "keep-alive";
         response.headers["X-Accel-Buffering"] = "no";
         
-        std::string generated_content;
-        std::string generated_message_id;
-        
-        response.stream_handler = [this, 
-                                  &generated_content, 
-                                  &generated_message_id,
+        // 处理函数由HttpSession在发送响应头之后运行，所有状态按值捕获或放在协程帧内
+        response.stream_handler = [this,
                                   dialog_id,
-                                  context,
+                                  context = std::move(context),
                                   model_config,
                                   model_id = dialog_result.GetValue().model_id](StreamWriter& writer) -> Task<void> {
+            // 整个回复在流结束前一直保留，计入ai-stream内存标签
+            std::pmr::string generated_content(
+                core::memory::TrackedResource::ForTag(core::memory::MemoryTag::kAiStream));
+            
             try {
-                co_await model_service_.GenerateStreamingResponse(
-                    model_id,
-                    context,
-                    [&](const std::string& content, bool is_done) {
-                        if (is_done) {
-                            if (!generated_content.empty()) {
-                                models::Message ai_message;
-                                ai_message.dialog_id = dialog_id;
-                                ai_message.role = "assistant";
-                                ai_message.content = generated_content;
-                                ai_message.type = "text";
-                                
-                                auto save_result = message_service_->CreateMessage(ai_message);
-                                
-                                if (co_await save_result.await_ready()) {
-                                    auto result = co_await save_result;
-                                    if (result.IsOk()) {
-                                        generated_message_id = result.GetValue().id;
-                                    }
-                                }
-                            }
-                            
-                            std::string final_data;
-                            if (!generated_message_id.empty()) {
-                                json final_json = {
-                                    {"id", generated_message_id},
-                                    {"dialog_id", dialog_id},
-                                    {"role", "assistant"},
-                                    {"content", generated_content},
-                                    {"type", "text"}
-                                };
-                                final_data = "data: " + final_json.dump() + "\n\n";
-                            }
-                            
-                            final_data += "data: [DONE]\n\n";
-                            writer.Write(final_data);
-                            writer.End();
-                        } else {
-                            generated_content += content;
-                            HandleStreamingResponse(content, is_done, writer);
+                // token回调在上游客户端的strand上运行，只交给pump；pump在会话的strand上等待写入器
+                // 降到低水位后再写出，客户端读得慢时token合并成更大的块，发送队列不超过高水位
+                StreamPump pump(writer);
+                auto [result, pumped] = co_await WhenAll(
+                    CurrentExecutor(),
+                    GenerateStreamingReply(model_id, context, model_config, generated_content, pump),
+                    pump.Run());
+                
+                if (result.IsError()) {
+                    json error_json = {{"error", result.GetError()}};
+                    writer.Write("data: " + error_json.dump() + "\n\n");
+                }
+                
+                std::string final_data;
+                if (!generated_content.empty()) {
+                    models::Message ai_message;
+                    ai_message.dialog_id = dialog_id;
+                    ai_message.role = "assistant";
+                    ai_message.content.assign(generated_content);
+                    ai_message.type = "text";
+                    if (result.IsOk()) {
+                        ai_message.tokens = result.GetValue().completion_tokens;
+                    }
+                    
+                    auto save_result = co_await message_service_->CreateMessage(ai_message, model_config.deadline);
+                    if (save_result.IsOk()) {
+                        json final_json = {
+                            {"id", save_result.GetValue().id},
+                            {"dialog_id", dialog_id},
+                            {"role", "assistant"},
+                            {"content", ai_message.content},
+                            {"type", "text"},
+                            {"tokens", ai_message.tokens}
+                        };
+                        if (result.IsOk()) {
+                            final_json["usage"] = UsageToJson(result.GetValue());
                         }
-                    },
-                    model_config
-                );
+                        final_data = "data: " + final_json.dump() + "\n\n";
+                    }
+                }
+                
+                final_data += "data: [DONE]\n\n";
+                writer.Write(final_data);
             } catch (const std::exception& e) {
                 spdlog::error("Error in stream processing: {}", e.what());
-                writer.Write("data: {\"error\":\"" + std::string(e.what()) + "\"}\n\n");
+                json error_json = {{"error", e.what()}};
+                writer.Write("data: " + error_json.dump() + "\n\n");
                 writer.Write("data: [DONE]\n\n");
-                writer.End();
             }
             
-            co_return;
+            writer.End();
         };
         
         co_return response;
         
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in GetStreamReply: {}", e.what());
         json error_json = {
@@ -481,8 +535,8 @@ Task<Response> MessageController::GetStreamReply(const Request& request) {
 
 Task<Response> MessageController::DeleteMessage(const Request& request) {
     try {
-        std::string dialog_id = request.GetPathParam("dialog_id");
-        std::string message_id = request.GetPathParam("message_id");
+        std::string dialog_id(request.GetPathParam("dialog_id"));
+        std::string message_id(request.GetPathParam("message_id"));
         
         auto validation = co_await ValidateDialogAccess(request, dialog_id);
         if (validation.IsError()) {
@@ -494,7 +548,7 @@ Task<Response> MessageController::DeleteMessage(const Request& request) {
             co_return Response::Forbidden(error_json);
         }
         
-        auto result = co_await message_service_->DeleteMessage(message_id);
+        auto result = co_await message_service_->DeleteMessage(message_id, request.deadline);
         
         if (result.IsError()) {
             json error_json = {
@@ -513,6 +567,8 @@ Task<Response> MessageController::DeleteMessage(const Request& request) {
         
         co_return Response::OK(response_json);
         
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in DeleteMessage: {}", e.what());
         json error_json = {
@@ -524,56 +580,78 @@ Task<Response> MessageController::DeleteMessage(const Request& request) {
     }
 }
 
-common::Result<std::string> MessageController::ValidateDialogAccess(
+Task<common::Result<std::string>> MessageController::ValidateDialogAccess(
     const Request& request, 
     const std::string& dialog_id) {
     
     if (!request.user_id.has_value()) {
-        return common::Result<std::string>::Error("未授权访问");
+        co_return common::Result<std::string>::Error("未授权访问");
     }
     
-    auto result = co_await dialog_service_->ValidateDialogOwnership(dialog_id, request.user_id.value());
+    auto result = co_await dialog_service_->ValidateDialogOwnership(dialog_id, request.user_id.value(),
+                                                                     request.deadline);
     
     co_return result;
 }
 
+Task<common::Result<services::ai::TokenUsage>> MessageController::GenerateStreamingReply(
+    const std::string& model_id,
+    const std::vector<models::Message>& context,
+    const services::ai::ModelInterface::ModelConfig& config,
+    std::pmr::string& generated_content,
+    StreamPump& pump) {
+    
+    std::optional<common::Result<services::ai::TokenUsage>> result;
+    std::exception_ptr error;
+    try {
+        auto generate = model_service_.GenerateStreamingResponse(
+            model_id,
+            context,
+            [&](const std::string& content, bool is_done) {
+                // 客户端断开后不再积累，完成标记结束pump，最终事件在生成结束后统一写出
+                if (!is_done && (content.empty() || !pump.IsOpen())) {
+                    return;
+                }
+                if (!is_done) {
+                    generated_content += content;
+                }
+                HandleStreamingResponse(content, is_done, pump);
+            },
+            config
+        );
+        result.emplace(co_await generate);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    
+    // 模型出错时不一定发送完成标记，这里总是结束pump，写出协程随之返回
+    pump.Finish();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    co_return std::move(*result);
+}
+
 void MessageController::HandleStreamingResponse(
     const std::string& content,
     bool is_done,
-    StreamWriter& writer) {
+    StreamPump& pump) {
     
     if (is_done) {
-        writer.Write("data: [DONE]\n\n");
-        writer.End();
+        pump.Finish();
         return;
     }
     
-    std::string escaped_content = content;
-    // 使用适当的转义方法，不使用json::escape_string
-    std::string escaped = "";
-    for (char c : content) {
-        if (c == '"' || c == '\\' || ('\x00' <= c && c <= '\x1f')) {
-            escaped += '\\';
-            switch(c) {
-                case '"': escaped += '"'; break;
-                case '\\': escaped += '\\'; break;
-                case '\b': escaped += 'b'; break;
-                case '\f': escaped += 'f'; break;
-                case '\n': escaped += 'n'; break;
-                case '\r': escaped += 'r'; break;
-                case '\t': escaped += 't'; break;
-                default:
-                    char buf[8];
-                    snprintf(buf, sizeof buf, "u%04x", c);
-                    escaped += buf;
-            }
-        } else {
-            escaped += c;
-        }
-    }
+    // 事件前后缀和转义后的内容依次写入同一个链，发送时不再拼接
+    std::string escaped;
+    escaped.reserve(content.size() + 16);
+    core::utils::JsonWriter::AppendEscaped(escaped, content);
     
-    std::string data = "data: {\"delta\":\"" + escaped + "\"}\n\n";
-    writer.Write(data);
+    core::memory::BufferChain event;
+    event.Append("data: {\"delta\":\"");
+    event.Append(std::move(escaped));
+    event.Append("\"}\n\n");
+    pump.Push(std::move(event));
 }
 
 } // namespace ai_backend::api::controllers
@@ -2,6 +2,7 @@
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 #include "services/ai/model_service.h"
+#include "core/http/upstream_client.h"
 
 namespace ai_backend::api::controllers {
 
@@ -60,7 +61,7 @@ Task<Response> ModelController::GetModels(const Request& request) {
 Task<Response> ModelController::GetModelById(const Request& request) {
     try {
         // 获取模型ID
-        std::string model_id = request.GetPathParam("id");
+        std::string model_id(request.GetPathParam("id"));
         
         // 获取模型信息
         auto result = model_service_.GetModelInfo(model_id);
@@ -108,4 +109,43 @@ Task<Response> ModelController::GetModelById(const Request& request) {
     }
 }
 
+Task<Response> ModelController::GetUpstreamStats(const Request& /*request*/) {
+    try {
+        json pools_json = json::array();
+        for (const auto& stats : UpstreamClient::GetInstance().GetPoolStats()) {
+            pools_json.push_back({
+                {"base_url", stats.base_url},
+                {"requests", stats.requests},
+                {"failures", stats.failures},
+                {"active", stats.active},
+                {"connections_opened", stats.connections_opened},
+                {"connections_reused", stats.connections_reused},
+                {"http2_requests", stats.http2_requests},
+                {"avg_connect_ms", stats.avg_connect_ms},
+                {"avg_tls_ms", stats.avg_tls_ms}
+            });
+        }
+        
+        json response_json = {
+            {"code", 0},
+            {"message", "获取成功"},
+            {"data", {
+                {"active_transfers", UpstreamClient::GetInstance().GetActiveTransfers()},
+                {"pools", pools_json}
+            }}
+        };
+        
+        co_return Response::OK(response_json);
+        
+    } catch (const std::exception& e) {
+        spdlog::error("Error in GetUpstreamStats: {}", e.what());
+        json error_json = {
+            {"code", 500},
+            {"message", "服务器内部错误"},
+            {"data", nullptr}
+        };
+        co_return Response::InternalServerError(error_json);
+    }
+}
+
 } // namespace ai_backend::api::controllers
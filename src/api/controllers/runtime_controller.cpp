@@ -0,0 +1,263 @@
+#include "api/controllers/runtime_controller.h"
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include "core/async/event_loop.h"
+#include "core/async/frame_allocator.h"
+#include "core/async/runtime.h"
+#include "core/http/admission_controller.h"
+#include "core/memory/memory_pool.h"
+#include "core/memory/memory_tracker.h"
+#include "core/memory/request_arena.h"
+
+namespace ai_backend::api::controllers {
+
+using json = nlohmann::json;
+using namespace core::async;
+using namespace core::http;
+using namespace core::memory;
+
+namespace {
+
+// 直方图只导出非空的桶，le为桶的上界 (微秒)
+json HistogramToJson(const core::utils::LatencyHistogram::Snapshot& snapshot) {
+    json buckets = json::array();
+    for (size_t i = 0; i < snapshot.buckets.size(); ++i) {
+        if (snapshot.buckets[i] > 0) {
+            buckets.push_back({
+                {"le_us", core::utils::LatencyHistogram::Snapshot::BucketUpperBound(i)},
+                {"count", snapshot.buckets[i]}
+            });
+        }
+    }
+    
+    return {
+        {"count", snapshot.count},
+        {"mean_us", snapshot.Mean()},
+        {"p50_us", snapshot.Percentile(0.50)},
+        {"p99_us", snapshot.Percentile(0.99)},
+        {"p999_us", snapshot.Percentile(0.999)},
+        {"max_us", snapshot.max_us},
+        {"buckets", buckets}
+    };
+}
+
+} // namespace
+
+Task<Response> RuntimeController::GetLoopStats(const Request& /*request*/) {
+    try {
+        auto watchdog = Runtime::GetInstance().GetWatchdog();
+        if (!watchdog) {
+            json error_json = {
+                {"code", 404},
+                {"message", "事件循环看门狗未启用"},
+                {"data", nullptr}
+            };
+            co_return Response::NotFound(error_json);
+        }
+        
+        auto stats = watchdog->GetStats();
+        
+        json threads_json = json::array();
+        for (const auto& thread : stats.threads) {
+            threads_json.push_back({
+                {"index", thread.index},
+                {"io_context", thread.io_context},
+                {"lag", HistogramToJson(thread.lag)},
+                {"handlers", HistogramToJson(thread.handlers)},
+                {"slow_handlers", thread.slow_handlers},
+                {"stalls", thread.stalls}
+            });
+        }
+        
+        json slow_json = json::array();
+        for (const auto& handler : stats.slow_handlers) {
+            slow_json.push_back({
+                {"handler", handler.handler},
+                {"count", handler.count},
+                {"total_us", handler.total_us},
+                {"max_us", handler.max_us}
+            });
+        }
+        
+        json response_json = {
+            {"code", 0},
+            {"message", "获取成功"},
+            {"data", {
+                {"threshold_ms", watchdog->GetOptions().threshold.count()},
+                {"threads", threads_json},
+                {"slow_handlers", slow_json}
+            }}
+        };
+        
+        co_return Response::OK(response_json);
+        
+    } catch (const std::exception& e) {
+        spdlog::error("Error in GetLoopStats: {}", e.what());
+        json error_json = {
+            {"code", 500},
+            {"message", "服务器内部错误"},
+            {"data", nullptr}
+        };
+        co_return Response::InternalServerError(error_json);
+    }
+}
+
+Task<Response> RuntimeController::GetAdmissionStats(const Request& /*request*/) {
+    try {
+        auto stats = AdmissionController::GetInstance().GetStats();
+        
+        json classes_json = json::array();
+        for (const auto& route_class : stats.classes) {
+            classes_json.push_back({
+                {"name", route_class.name},
+                {"max_in_flight", route_class.max_in_flight},
+                {"max_queue", route_class.max_queue},
+                {"in_flight", route_class.in_flight},
+                {"queued", route_class.queued},
+                {"overloaded", route_class.overloaded},
+                {"admitted", route_class.admitted},
+                {"shed", {
+                    {"total", route_class.GetShed()},
+                    {"queue_full", route_class.shed_queue_full},
+                    {"queue_timeout", route_class.shed_queue_timeout},
+                    {"sojourn", route_class.shed_sojourn}
+                }},
+                {"sojourn", HistogramToJson(route_class.sojourn)}
+            });
+        }
+        
+        auto& event_loop = EventLoop::GetInstance();
+        
+        json response_json = {
+            {"code", 0},
+            {"message", "获取成功"},
+            {"data", {
+                {"connections", {
+                    {"active", stats.active_connections},
+                    {"rejected", stats.rejected_connections}
+                }},
+                {"classes", classes_json},
+                {"event_loop", {
+                    {"pending", event_loop.GetPendingTasks()},
+                    {"rejected", event_loop.GetRejectedTasks()},
+                    {"sojourn", HistogramToJson(event_loop.GetQueueSojourn())}
+                }}
+            }}
+        };
+        
+        co_return Response::OK(response_json);
+        
+    } catch (const std::exception& e) {
+        spdlog::error("Error in GetAdmissionStats: {}", e.what());
+        json error_json = {
+            {"code", 500},
+            {"message", "服务器内部错误"},
+            {"data", nullptr}
+        };
+        co_return Response::InternalServerError(error_json);
+    }
+}
+
+Task<Response> RuntimeController::GetMemoryStats(const Request& /*request*/) {
+    try {
+        auto& tracker = MemoryTracker::GetInstance();
+        
+        json subsystems_json = json::array();
+        for (const auto& tag : tracker.GetStats()) {
+            subsystems_json.push_back({
+                {"name", GetMemoryTagName(tag.tag)},
+                {"live_bytes", tag.live_bytes},
+                {"peak_bytes", tag.peak_bytes},
+                {"allocations", tag.allocations},
+                {"deallocations", tag.deallocations},
+                {"allocated_bytes", tag.allocated_bytes},
+                {"bytes_per_second", tag.bytes_per_second},
+                {"allocations_per_second", tag.allocations_per_second}
+            });
+        }
+        
+        auto pool = MemoryPool::GetInstance().GetStats();
+        auto arena = RequestArena::GetStats();
+        auto profile = tracker.GetProfileStats();
+        auto frames = GetFrameAllocatorStats();
+        
+        json response_json = {
+            {"code", 0},
+            {"message", "获取成功"},
+            {"data", {
+                {"subsystems", subsystems_json},
+                {"pool", {
+                    {"live_bytes", pool.GetLiveBytes()},
+                    {"reserved_bytes", pool.GetReservedBytes()},
+                    {"large_live_bytes", pool.large_live_bytes}
+                }},
+                {"request_arena", {
+                    {"requests", arena.requests},
+                    {"allocations", arena.allocations},
+                    {"bytes", arena.bytes},
+                    {"overflows", arena.overflows}
+                }},
+                {"coroutine_frames", {
+                    {"allocations", frames.allocations},
+                    {"cache_hits", frames.cache_hits},
+                    {"arena_allocations", frames.arena_allocations},
+                    {"live_frames", frames.GetLiveFrames()},
+                    {"live_bytes", frames.GetLiveBytes()},
+                    {"bytes_allocated", frames.bytes_allocated}
+                }},
+                {"profile", {
+                    {"sample_interval", profile.sample_interval},
+                    {"samples", profile.samples},
+                    {"live_samples", profile.live_samples},
+                    {"dropped", profile.dropped}
+                }}
+            }}
+        };
+        
+        co_return Response::OK(response_json);
+        
+    } catch (const std::exception& e) {
+        spdlog::error("Error in GetMemoryStats: {}", e.what());
+        json error_json = {
+            {"code", 500},
+            {"message", "服务器内部错误"},
+            {"data", nullptr}
+        };
+        co_return Response::InternalServerError(error_json);
+    }
+}
+
+Task<Response> RuntimeController::GetHeapProfile(const Request& request) {
+    try {
+        std::optional<MemoryTag> tag;
+        if (request.HasQueryParam("tag")) {
+            tag = ParseMemoryTag(request.GetQueryParam("tag"));
+            if (!tag) {
+                json error_json = {
+                    {"code", 400},
+                    {"message", "未知的内存标签"},
+                    {"data", nullptr}
+                };
+                co_return Response::BadRequest(error_json);
+            }
+        }
+        
+        Response response;
+        response.status_code = 200;
+        response.headers["Content-Type"] = "text/plain";
+        response.headers["Content-Disposition"] = "attachment; filename=\"heap.prof\"";
+        response.body = MemoryTracker::GetInstance().DumpHeapProfile(tag);
+        co_return response;
+        
+    } catch (const std::exception& e) {
+        spdlog::error("Error in GetHeapProfile: {}", e.what());
+        json error_json = {
+            {"code", 500},
+            {"message", "服务器内部错误"},
+            {"data", nullptr}
+        };
+        co_return Response::InternalServerError(error_json);
+    }
+}
+
+} // namespace ai_backend::api::controllers
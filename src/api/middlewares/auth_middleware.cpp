@@ -11,7 +11,7 @@ AuthMiddleware::AuthMiddleware(std::shared_ptr<services::auth::AuthService> auth
 
 Task<bool> AuthMiddleware::Process(core::http::Request& request) {
     // 获取Authorization头
-    std::string auth_header = request.GetHeader("Authorization");
+    std::string auth_header(request.GetHeader("Authorization"));
     
     // 如果没有Authorization头，继续处理（路由器会检查是否需要认证）
     if (auth_header.empty()) {
@@ -18,7 +18,7 @@ CorsMiddleware::CorsMiddleware() {
 
 Task<bool> CorsMiddleware::Process(core::http::Request& request) {
     // 获取Origin头
-    std::string origin = request.GetHeader("Origin");
+    std::string origin(request.GetHeader("Origin"));
     
     // 如果没有Origin头，不需要处理CORS
     if (origin.empty()) {
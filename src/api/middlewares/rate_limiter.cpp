@@ -1,6 +1,8 @@
 #include "api/middlewares/rate_limiter.h"
 #include <spdlog/spdlog.h>
 #include "core/config/config_manager.h"
+#include "core/async/event_loop.h"
+#include <algorithm>
 #include <chrono>
 #include <map>
 
@@ -8,7 +10,9 @@ namespace ai_backend::api::middlewares {
 
 using namespace core::async;
 
-RateLimiter::RateLimiter() {
+RateLimiter::RateLimiter()
+    : request_history_(core::memory::TrackedResource::ForTag(core::memory::MemoryTag::kRateLimit)),
+      ip_request_history_(core::memory::TrackedResource::ForTag(core::memory::MemoryTag::kRateLimit)) {
     // 从配置中加载速率限制设置
     auto& config = core::config::ConfigManager::GetInstance();
     max_requests_per_minute_ = config.GetInt("rate_limit.max_requests_per_minute", 60);
@@ -23,15 +27,58 @@ RateLimiter::RateLimiter() {
     InitCleanupTask();
 }
 
+RateLimiter::~RateLimiter() {
+    TimerWheel::For(EventLoop::GetInstance().GetIoContext()).Cancel(cleanup_timer_);
+}
+
+void RateLimiter::InitCleanupTask() {
+    // 每5分钟清理一次，回调运行在IO线程上，锁被请求占用时跳过本轮，不阻塞线程
+    cleanup_timer_.SetCallback([this]() {
+        if (mutex_.TryLock()) {
+            CleanupHistory();
+            mutex_.Unlock();
+        }
+        TimerWheel::For(EventLoop::GetInstance().GetIoContext()).Schedule(cleanup_timer_, std::chrono::minutes(5));
+    });
+    TimerWheel::For(EventLoop::GetInstance().GetIoContext()).Schedule(cleanup_timer_, std::chrono::minutes(5));
+}
+
+RateLimiter::History& RateLimiter::GetHistory(HistoryMap& map, const std::string& key) {
+    auto it = map.find(std::string_view(key));
+    if (it == map.end()) {
+        it = map.try_emplace(std::pmr::string(key, map.get_allocator())).first;
+    }
+    return it->second;
+}
+
+void RateLimiter::CleanupHistory() {
+    // 最长的统计窗口是一天，更早的记录不再影响限制
+    auto day_ago = std::chrono::steady_clock::now() - std::chrono::hours(24);
+    auto prune = [day_ago](auto& history) {
+        for (auto it = history.begin(); it != history.end(); ) {
+            auto& timestamps = it->second;
+            timestamps.erase(timestamps.begin(),
+                             std::lower_bound(timestamps.begin(), timestamps.end(), day_ago));
+            if (timestamps.empty()) {
+                it = history.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    };
+    prune(request_history_);
+    prune(ip_request_history_);
+}
+
 Task<bool> RateLimiter::Process(core::http::Request& request) {
     if (!enabled_) {
         co_return true;
     }
     
     // 获取客户端IP
-    std::string client_ip = request.GetHeader("X-Forwarded-For");
+    std::string client_ip(request.GetHeader("X-Forwarded-For"));
     if (client_ip.empty()) {
-        client_ip = request.GetHeader("X-Real-IP");
+        client_ip = std::string(request.GetHeader("X-Real-IP"));
     }
     if (client_ip.empty()) {
         client_ip = request.client_ip;
@@ -62,7 +109,7 @@ Task<bool> RateLimiter::Process(core::http::Request& request) {
         spdlog::warn("Rate limit exceeded for client: {}", client_id);
         
         // 生成服务重新可用的预计时间
-        auto retry_after = CalculateRetryAfter(client_id);
+        auto retry_after = co_await CalculateRetryAfter(client_id);
         
         // 设置响应头
         request.rate_limit_headers["X-RateLimit-Limit"] = std::to_string(max_requests_per_minute_);
@@ -75,8 +122,8 @@ Task<bool> RateLimiter::Process(core::http::Request& request) {
     co_return true;
 }
 
-int RateLimiter::CalculateRetryAfter(const std::string& client_id) {
-    std::unique_lock<std::mutex> lock(mutex_);
+Task<int> RateLimiter::CalculateRetryAfter(const std::string& client_id) {
+    auto lock = co_await mutex_.ScopedLock();
     
     auto now = std::chrono::steady_clock::now();
     auto minute_ago = now - std::chrono::minutes(1);
@@ -84,22 +131,21 @@ int RateLimiter::CalculateRetryAfter(const std::string& client_id) {
     // 找到最早的请求时间
     std::chrono::time_point<std::chrono::steady_clock> earliest_request;
     
-    if (!request_history_[client_id].empty()) {
-        earliest_request = request_history_[client_id].front();
+    auto history = request_history_.find(std::string_view(client_id));
+    if (history != request_history_.end() && !history->second.empty()) {
+        earliest_request = history->second.front();
         
         // 计算到最早请求过期还需要多少秒
         auto duration = std::chrono::duration_cast<std::chrono::seconds>(
             earliest_request + std::chrono::minutes(1) - now);
         
-        return std::max(1, static_cast<int>(duration.count()));
+        co_return std::max(1, static_cast<int>(duration.count()));
     }
     
-    return 60; // 默认1分钟
+    co_return 60; // 默认1分钟
 }
 
 bool RateLimiter::IsWhitelisted(const std::string& ip) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    
     // 简单实现：检查IP是否在白名单中
     static const std::unordered_set<std::string> whitelist = {
         "127.0.0.1",
@@ -115,14 +161,17 @@ Task<bool> RateLimiter::CheckRateLimit(const std::string& client_id, const std::
     auto hour_ago = now - std::chrono::hours(1);
     auto day_ago = now - std::chrono::hours(24);
     
-    std::unique_lock<std::mutex> lock(mutex_);
+    auto lock = co_await mutex_.ScopedLock();
     
     // 添加当前请求
-    request_history_[client_id].push_back(now);
+    auto& history = GetHistory(request_history_, client_id);
+    history.push_back(now);
     
     // 如果是IP限制，也添加到IP历史记录中
+    History* ip_history = nullptr;
     if (client_id.find("ip:") == 0) {
-        ip_request_history_[client_ip].push_back(now);
+        ip_history = &GetHistory(ip_request_history_, client_ip);
+        ip_history->push_back(now);
     }
     
     // 计算最近一分钟/小时/天的请求数
@@ -130,7 +179,7 @@ Task<bool> RateLimiter::CheckRateLimit(const std::string& client_id, const std::
     int hour_requests = 0;
     int day_requests = 0;
     
-    for (const auto& timestamp : request_history_[client_id]) {
+    for (const auto& timestamp : history) {
         if (timestamp >= minute_ago) {
             minute_requests++;
         }
@@ -144,8 +193,8 @@ Task<bool> RateLimiter::CheckRateLimit(const std::string& client_id, const std::
     
     // 特别检查IP限制（防止未认证用户滥用）
     int ip_minute_requests = 0;
-    if (client_id.find("ip:") == 0 && ip_request_history_.find(client_ip) != ip_request_history_.end()) {
-        for (const auto& timestamp : ip_request_history_[client_ip]) {
+    if (ip_history) {
+        for (const auto& timestamp : *ip_history) {
             if (timestamp >= minute_ago) {
                 ip_minute_requests++;
             }
@@ -159,9 +208,9 @@ Task<bool> RateLimiter::CheckRateLimit(const std::string& client_id, const std::
         (client_id.find("ip:") == 0 && ip_minute_requests > ip_max_requests_per_minute_)) {
         
         // 移除当前请求
-        request_history_[client_id].pop_back();
-        if (client_id.find("ip:") == 0) {
-            ip_request_history_[client_ip].pop_back();
+        history.pop_back();
+        if (ip_history) {
+            ip_history->pop_back();
         }
         
         co_return false;
@@ -16,7 +16,7 @@ RequestLogger::RequestLogger() {
 
 Task<bool> RequestLogger::Process(core::http::Request& request) {
     // 记录请求开始时间
-    auto start_time = std::chrono::high_resolution_clock::now();
+    auto start_time = std::chrono::steady_clock::now();
     
     // 设置请求开始时间到请求属性中
     request.start_time = start_time;
@@ -41,7 +41,7 @@ void RequestLogger::LogRequest(const core::http::Request& request) {
     );
     
     // 添加客户端IP
-    std::string client_ip = request.GetHeader("X-Forwarded-For");
+    std::string client_ip(request.GetHeader("X-Forwarded-For"));
     if (client_ip.empty()) {
         client_ip = request.client_ip;
     }
@@ -55,27 +55,27 @@ void RequestLogger::LogRequest(const core::http::Request& request) {
     // 记录请求头
     if (log_headers_) {
         message += "\nHeaders:";
-        for (const auto& [name, value] : request.headers) {
+        request.ForEachHeader([&message](std::string_view name, std::string_view value) {
             // 不记录敏感头部
             if (name == "Authorization" || name == "Cookie") {
                 message += fmt::format("\n  {}: [REDACTED]", name);
             } else {
                 message += fmt::format("\n  {}: {}", name, value);
             }
-        }
+        });
     }
     
     // 记录请求体
     if (log_body_ && !request.body.empty()) {
         // 限制请求体大小以避免日志过大
         const size_t max_body_length = 1000;
-        std::string body = request.body;
+        std::string body(request.body);
         if (body.length() > max_body_length) {
             body = body.substr(0, max_body_length) + "...";
         }
         
         // 检测并脱敏JSON请求体中的敏感字段
-        if (request.GetHeader("Content-Type").find("application/json") != std::string::npos) {
+        if (request.GetHeader("Content-Type").find("application/json") != std::string_view::npos) {
             try {
                 auto json = nlohmann::json::parse(body);
                 SanitizeJsonObject(json);
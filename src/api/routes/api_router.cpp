@@ -1,13 +1,31 @@
 #include "api/routes/api_router.h"
+#include <boost/asio/ip/address.hpp>
 #include <spdlog/spdlog.h>
-#include <regex>
+#include "core/config/config_manager.h"
 
 namespace ai_backend::api::routes {
 
 using namespace core::async;
 using namespace core::http;
 
+namespace {
+
+// 本机直接发起的请求：对端是回环地址，且不是经反向代理转发的 (代理与服务同机时对端也是回环地址)
+bool IsLocalRequest(const Request& request) {
+    if (!request.GetHeader("X-Forwarded-For").empty() || !request.GetHeader("X-Real-IP").empty()) {
+        return false;
+    }
+    boost::system::error_code ec;
+    auto address = boost::asio::ip::make_address(request.client_ip, ec);
+    return !ec && address.is_loopback();
+}
+
+} // namespace
+
 ApiRouter::ApiRouter() {
+    auto& config = core::config::ConfigManager::GetInstance();
+    default_timeout_ = std::chrono::milliseconds(config.GetInt("server.request_timeout_ms", 30000));
+    
     // 创建控制器和中间件
     CreateControllers();
     SetupMiddlewares();
@@ -18,91 +36,27 @@ void ApiRouter::Initialize() {
     // 已在构造函数中初始化
 }
 
-Task<Response> ApiRouter::Route(const Request& request) {
+Task<Response> ApiRouter::Route(Request& request) {
+    alignas(std::max_align_t) std::byte frame_buffer[kFrameBufferSize];
+    FrameArena arena(frame_buffer, sizeof(frame_buffer));
+    
     try {
-        // 创建请求的可变副本，以便中间件可以修改它
-        Request mutable_request = request;
+        Response response = co_await Dispatch(std::allocator_arg, arena, request);
         
-        // 应用所有中间件
-        for (const auto& middleware : middlewares_) {
-            bool should_continue = co_await middleware(mutable_request);
-            if (!should_continue) {
-                // 中间件请求终止处理
-                co_return Response::Forbidden({
-                    {"code", 403},
-                    {"message", "请求被中间件拒绝"},
-                    {"data", nullptr}
-                });
-            }
+        // 附加中间件产生的响应头
+        for (const auto& [name, value] : request.cors_headers) {
+            response.headers[name] = value;
         }
-        
-        // 提取路径和方法
-        std::string path = mutable_request.path;
-        std::string method = mutable_request.method;
-        
-        // 尝试查找精确匹配的路由
-        std::string route_key = method + ":" + path;
-        auto route_it = routes_.find(route_key);
-        
-        if (route_it != routes_.end()) {
-            // 找到精确匹配
-            if (route_it->second.require_auth && !mutable_request.user_id.has_value()) {
-                co_return Response::Unauthorized({
-                    {"code", 401},
-                    {"message", "请先登录"},
-                    {"data", nullptr}
-                });
-            }
-            
-            // 调用路由处理器
-            co_return co_await route_it->second.handler(mutable_request);
-        }
-        
-        // 如果没有精确匹配，尝试使用路径参数匹配
-        for (const auto& [regex, route_template] : path_params_regexes_) {
-            std::smatch matches;
-            if (std::regex_match(path, matches, regex)) {
-                // 找到匹配的正则表达式路由
-                std::string route_key = method + ":" + route_template;
-                auto route_it = routes_.find(route_key);
-                
-                if (route_it != routes_.end()) {
-                    if (route_it->second.require_auth && !mutable_request.user_id.has_value()) {
-                        co_return Response::Unauthorized({
-                            {"code", 401},
-                            {"message", "请先登录"},
-                            {"data", nullptr}
-                        });
-                    }
-                    
-                    // 提取路径参数
-                    std::smatch param_matches;
-                    std::regex param_regex(R"(\{([^{}]+)\})");
-                    std::string route_template_copy = route_template;
-                    std::string::const_iterator search_start = route_template_copy.cbegin();
-                    
-                    size_t param_index = 1; // 跳过第一个匹配（整个字符串）
-                    while (std::regex_search(search_start, route_template_copy.cend(), param_matches, param_regex)) {
-                        if (param_index < matches.size()) {
-                            std::string param_name = param_matches[1].str();
-                            std::string param_value = matches[param_index].str();
-                            mutable_request.path_params[param_name] = param_value;
-                        }
-                        
-                        search_start = param_matches.suffix().first;
-                        param_index++;
-                    }
-                    
-                    // 调用路由处理器
-                    co_return co_await route_it->second.handler(mutable_request);
-                }
-            }
+        for (const auto& [name, value] : request.rate_limit_headers) {
+            response.headers[name] = value;
         }
         
-        // 如果没有找到匹配的路由，返回404
-        co_return Response::NotFound({
-            {"code", 404},
-            {"message", "API路径不存在"},
+        co_return response;
+    } catch (const DeadlineExceeded& e) {
+        spdlog::warn("Deadline exceeded in Route: {} {}", request.method, request.path);
+        co_return Response::GatewayTimeout({
+            {"code", 504},
+            {"message", "请求处理超时"},
             {"data", nullptr}
         });
     } catch (const std::exception& e) {
@@ -115,26 +69,97 @@ Task<Response> ApiRouter::Route(const Request& request) {
     }
 }
 
+Task<Response> ApiRouter::Dispatch(std::allocator_arg_t, FrameArena& arena, Request& request) {
+    // 应用所有中间件，中间件直接修改请求的副状态
+    for (const auto& middleware : middlewares_) {
+        bool should_continue = co_await middleware(std::allocator_arg, arena, request);
+        if (!should_continue) {
+            // 中间件请求终止处理
+            co_return Response::Forbidden({
+                {"code", 403},
+                {"message", "请求被中间件拒绝"},
+                {"data", nullptr}
+            });
+        }
+    }
+    
+    // 预检请求只需要CORS头
+    if (request.is_preflight) {
+        Response response;
+        response.status_code = 204;
+        co_return response;
+    }
+    
+    auto match = route_tree_.Match(request.method, request.path);
+    
+    if (match.status == RouteTree::MatchStatus::kNotFound) {
+        co_return Response::NotFound({
+            {"code", 404},
+            {"message", "API路径不存在"},
+            {"data", nullptr}
+        });
+    }
+    
+    if (match.status == RouteTree::MatchStatus::kMethodNotAllowed) {
+        co_return Response::MethodNotAllowed(std::string(match.allow), {
+            {"code", 405},
+            {"message", "请求方法不被允许"},
+            {"data", nullptr}
+        });
+    }
+    
+    const auto& route = routes_[match.route_id];
+    if (route.require_auth && !request.user_id.has_value()) {
+        co_return Response::Unauthorized({
+            {"code", 401},
+            {"message", "请先登录"},
+            {"data", nullptr}
+        });
+    }
+    
+    // 诊断数据暴露内部状态，只允许在本机上获取
+    if (route.local_only && !IsLocalRequest(request)) {
+        spdlog::warn("Rejected local-only request {} {} from {}", request.method, request.path, request.client_ip);
+        co_return Response::Forbidden({
+            {"code", 403},
+            {"message", "仅允许本机访问"},
+            {"data", nullptr}
+        });
+    }
+    
+    // 路径参数的名称引用路由树，值引用请求路径
+    request.path_params.assign(match.params.begin(), match.params.begin() + match.param_count);
+    
+    // 按路由的处理时限收紧截止时间，下游的数据库和上游调用都以此为准
+    request.deadline = request.deadline.Tighten(route.timeout);
+    
+    // 调用路由处理器
+    co_return co_await route.handler(request);
+}
+
 void ApiRouter::SetupMiddlewares() {
     // 添加中间件，按执行顺序添加
-    middlewares_.push_back([this](Request& req) -> Task<bool> {
-        return co_await cors_middleware_->Process(req);
+    middlewares_.push_back([this](std::allocator_arg_t, FrameArena&, Request& req) -> Task<bool> {
+        co_return co_await cors_middleware_->Process(req);
     });
     
-    middlewares_.push_back([this](Request& req) -> Task<bool> {
-        return co_await request_logger_->Process(req);
+    middlewares_.push_back([this](std::allocator_arg_t, FrameArena&, Request& req) -> Task<bool> {
+        co_return co_await request_logger_->Process(req);
     });
     
-    middlewares_.push_back([this](Request& req) -> Task<bool> {
-        return co_await rate_limiter_->Process(req);
+    middlewares_.push_back([this](std::allocator_arg_t, FrameArena&, Request& req) -> Task<bool> {
+        co_return co_await rate_limiter_->Process(req);
     });
     
-    middlewares_.push_back([this](Request& req) -> Task<bool> {
-        return co_await auth_middleware_->Process(req);
+    middlewares_.push_back([this](std::allocator_arg_t, FrameArena&, Request& req) -> Task<bool> {
+        co_return co_await auth_middleware_->Process(req);
     });
 }
 
 void ApiRouter::SetupRoutes() {
+    auto& config = core::config::ConfigManager::GetInstance();
+    auto reply_timeout = std::chrono::milliseconds(config.GetInt("server.reply_timeout_ms", 300000));
+    
     // 认证相关路由
     AddRoute("/api/v1/auth/register", "POST", 
         [this](const Request& req) { return auth_controller_->Register(req); }, false);
@@ -169,7 +194,7 @@ void ApiRouter::SetupRoutes() {
         [this](const Request& req) { return message_controller_->CreateMessage(req); }, true);
     
     AddRoute("/api/v1/dialogs/{dialog_id}/messages/{message_id}/reply", "GET", 
-        [this](const Request& req) { return message_controller_->GetReply(req); }, true);
+        [this](const Request& req) { return message_controller_->GetReply(req); }, true, reply_timeout);
     
     AddRoute("/api/v1/dialogs/{dialog_id}/messages/{message_id}", "DELETE", 
         [this](const Request& req) { return message_controller_->DeleteMessage(req); }, true);
@@ -190,6 +215,22 @@ void ApiRouter::SetupRoutes() {
     
     AddRoute("/api/v1/models/{id}", "GET", 
         [this](const Request& req) { return model_controller_->GetModelById(req); }, true);
+    
+    AddLocalRoute("/api/v1/models/upstream/stats", "GET", 
+        [this](const Request& req) { return model_controller_->GetUpstreamStats(req); });
+    
+    // 运行时诊断路由
+    AddLocalRoute("/api/v1/runtime/loop/stats", "GET", 
+        [this](const Request& req) { return runtime_controller_->GetLoopStats(req); });
+    
+    AddLocalRoute("/api/v1/runtime/admission/stats", "GET", 
+        [this](const Request& req) { return runtime_controller_->GetAdmissionStats(req); });
+    
+    AddLocalRoute("/api/v1/runtime/memory/stats", "GET", 
+        [this](const Request& req) { return runtime_controller_->GetMemoryStats(req); });
+    
+    AddLocalRoute("/api/v1/runtime/memory/profile", "GET", 
+        [this](const Request& req) { return runtime_controller_->GetHeapProfile(req); });
 }
 
 void ApiRouter::CreateControllers() {
@@ -205,6 +246,7 @@ void ApiRouter::CreateControllers() {
     message_controller_ = std::make_shared<controllers::MessageController>(message_service, dialog_service);
     file_controller_ = std::make_shared<controllers::FileController>(file_service);
     model_controller_ = std::make_shared<controllers::ModelController>();
+    runtime_controller_ = std::make_shared<controllers::RuntimeController>();
     
     // 创建中间件
     auth_middleware_ = std::make_shared<middlewares::AuthMiddleware>(auth_service);
@@ -217,24 +259,23 @@ void ApiRouter::AddRoute(
     const std::string& path, 
     const std::string& method, 
     std::function<Task<Response>(const Request&)> handler,
-    bool require_auth
+    bool require_auth,
+    std::chrono::milliseconds timeout
 ) {
-    std::string route_key = method + ":" + path;
-    routes_[route_key] = {handler, require_auth};
-    
-    // 如果路径包含参数，添加到正则表达式列表
-    if (path.find('{') != std::string::npos && path.find('}') != std::string::npos) {
-        // 将路径模板转换为正则表达式
-        std::string regex_str = path;
-        std::regex param_regex(R"(\{([^{}]+)\})");
-        regex_str = std::regex_replace(regex_str, param_regex, "([^/]+)");
-        
-        // 转义正则表达式中的特殊字符
-        regex_str = std::regex_replace(regex_str, std::regex(R"([.+*?^$()[\]{}|\\])"), "\\$&");
-        
-        // 存储正则表达式和原始模板
-        path_params_regexes_.emplace_back(std::regex(regex_str), path);
+    if (timeout == std::chrono::milliseconds::zero()) {
+        timeout = default_timeout_;
     }
+    route_tree_.Insert(method, path, routes_.size());
+    routes_.push_back({std::move(handler), require_auth, false, timeout});
+}
+
+void ApiRouter::AddLocalRoute(
+    const std::string& path, 
+    const std::string& method, 
+    std::function<Task<Response>(const Request&)> handler
+) {
+    AddRoute(path, method, std::move(handler), true);
+    routes_.back().local_only = true;
 }
 
 } // namespace ai_backend::api::routes
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "core/async/async_event.h"
+#include <spdlog/spdlog.h>
+#include <deque>
+
+namespace ai_backend::core::async {
+
+bool AsyncEvent::WaitAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    // 入队之后等待者可能随时被其他线程恢复，之后只能使用局部变量
+    auto waiter = std::make_shared<detail::Waiter>();
+    waiter->handle = handle;
+    waiter->executor = detail::Waiter::HomeExecutor(event_.executor_);
+    waiter_ = waiter;
+    auto deadline = deadline_;
+
+    {
+        std::lock_guard<std::mutex> lock(event_.mutex_);
+        if (event_.set_) {
+            waiter_.reset();
+            return false;
+        }
+        event_.waiters_.Push(waiter);
+    }
+
+    detail::RegisterDeadline(waiter, deadline);
+    return true;
+}
+
+void AsyncEvent::WaitAwaiter::await_resume() const {
+    if (waiter_ && waiter_->IsCancelled()) {
+        throw DeadlineExceeded("Deadline exceeded while waiting for event");
+    }
+}
+
+AsyncEvent::AsyncEvent(boost::asio::any_io_executor executor, bool initially_set)
+    : set_(initially_set), executor_(std::move(executor)) {
+}
+
+AsyncEvent::~AsyncEvent() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t waiting = waiters_.CountWaiting();
+    if (waiting > 0) {
+        spdlog::error("AsyncEvent destroyed with {} waiting coroutine(s)", waiting);
+    }
+}
+
+void AsyncEvent::Set() {
+    std::deque<std::shared_ptr<detail::Waiter>> resumed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        set_ = true;
+        resumed = waiters_.PopAllWaiting();
+    }
+
+    for (auto& waiter : resumed) {
+        waiter->Resume();
+    }
+}
+
+void AsyncEvent::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    set_ = false;
+}
+
+bool AsyncEvent::IsSet() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return set_;
+}
+
+} // namespace ai_backend::core::async
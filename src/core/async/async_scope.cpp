@@ -0,0 +1,90 @@
+#include "core/async/async_scope.h"
+#include <spdlog/spdlog.h>
+#include <utility>
+
+namespace ai_backend::core::async {
+
+class AsyncScope::JoinAwaiter {
+public:
+    explicit JoinAwaiter(State& state) : state_(state) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        std::lock_guard<std::mutex> lock(state_.mutex);
+        if (state_.active == 0) {
+            return false;
+        }
+        state_.joiner = handle;
+        state_.joiner_executor = CurrentExecutor();
+        return true;
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    State& state_;
+};
+
+AsyncScope::AsyncScope(boost::asio::any_io_executor executor, const Deadline& parent)
+    : executor_(std::move(executor)),
+      state_(std::make_shared<State>()) {
+    state_->deadline = parent.Derive(executor_);
+}
+
+AsyncScope::~AsyncScope() {
+    size_t active = GetActiveCount();
+    if (active > 0) {
+        spdlog::error("AsyncScope destroyed with {} running task(s)", active);
+        Cancel();
+    }
+}
+
+Task<void> AsyncScope::Join() {
+    co_await JoinAwaiter(*state_);
+
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        exception = std::exchange(state_->first_exception, nullptr);
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void AsyncScope::Cancel() const {
+    state_->deadline.Cancel();
+}
+
+size_t AsyncScope::GetActiveCount() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->active;
+}
+
+void AsyncScope::OnChildDone(const std::shared_ptr<State>& state, std::exception_ptr exception) {
+    std::coroutine_handle<> joiner;
+    boost::asio::any_io_executor joiner_executor;
+    bool cancel = false;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (exception && !state->first_exception) {
+            state->first_exception = std::move(exception);
+            cancel = true;
+        }
+        if (--state->active == 0) {
+            joiner = std::exchange(state->joiner, nullptr);
+            joiner_executor = std::move(state->joiner_executor);
+        }
+    }
+
+    // 回调和恢复都在锁外执行，Join的等待者回到它挂起时所在的执行器
+    if (cancel) {
+        state->deadline.Cancel();
+    }
+    if (joiner) {
+        detail::ResumeAt(joiner_executor, joiner);
+    }
+}
+
+} // namespace ai_backend::core::async
@@ -0,0 +1,87 @@
+#include "core/async/async_semaphore.h"
+#include <spdlog/spdlog.h>
+#include <deque>
+
+namespace ai_backend::core::async {
+
+bool AsyncSemaphore::AcquireAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    // 入队之后等待者可能随时被其他线程恢复，之后只能使用局部变量
+    auto waiter = std::make_shared<detail::Waiter>();
+    waiter->handle = handle;
+    waiter->executor = detail::Waiter::HomeExecutor(semaphore_.executor_);
+    waiter_ = waiter;
+    auto deadline = deadline_;
+
+    {
+        std::lock_guard<std::mutex> lock(semaphore_.mutex_);
+        // 加锁前可能有许可被归还
+        if (semaphore_.available_ > 0) {
+            --semaphore_.available_;
+            waiter_.reset();
+            return false;
+        }
+        semaphore_.waiters_.Push(waiter);
+    }
+
+    detail::RegisterDeadline(waiter, deadline);
+    return true;
+}
+
+void AsyncSemaphore::AcquireAwaiter::await_resume() const {
+    if (waiter_ && waiter_->IsCancelled()) {
+        throw DeadlineExceeded("Deadline exceeded while waiting for semaphore");
+    }
+}
+
+AsyncSemaphore::AsyncSemaphore(size_t initial, boost::asio::any_io_executor executor)
+    : available_(initial), executor_(std::move(executor)) {
+}
+
+AsyncSemaphore::~AsyncSemaphore() {
+    size_t waiting = GetWaiterCount();
+    if (waiting > 0) {
+        spdlog::error("AsyncSemaphore destroyed with {} waiting coroutine(s)", waiting);
+    }
+}
+
+bool AsyncSemaphore::TryAcquire() {
+    // 有许可时队列中不会有仍在等待的协程，不需要检查公平性
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (available_ == 0) {
+        return false;
+    }
+    --available_;
+    return true;
+}
+
+void AsyncSemaphore::Release(size_t count) {
+    std::deque<std::shared_ptr<detail::Waiter>> resumed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (count > 0) {
+            auto waiter = waiters_.PopWaiting();
+            if (!waiter) {
+                break;
+            }
+            resumed.push_back(std::move(waiter));
+            --count;
+        }
+        available_ += count;
+    }
+
+    for (auto& waiter : resumed) {
+        waiter->Resume();
+    }
+}
+
+size_t AsyncSemaphore::GetAvailable() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return available_;
+}
+
+size_t AsyncSemaphore::GetWaiterCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return waiters_.CountWaiting();
+}
+
+} // namespace ai_backend::core::async
@@ -0,0 +1,39 @@
+#include "core/async/codel.h"
+#include <algorithm>
+
+namespace ai_backend::core::async {
+
+CoDel::CoDel(std::chrono::milliseconds target, std::chrono::milliseconds interval)
+    : target_(target), interval_(interval) {
+}
+
+bool CoDel::OnDequeue(std::chrono::nanoseconds sojourn, Clock::time_point now) {
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    int64_t sojourn_ns = sojourn.count();
+    int64_t target_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(target_).count();
+
+    // 窗口结束：根据窗口内的最小排队时间决定下一个窗口是否过载，没有样本的窗口不算过载
+    if (now_ns >= interval_end_.load(std::memory_order_acquire) &&
+        !rolling_.exchange(true, std::memory_order_acquire)) {
+        if (now_ns >= interval_end_.load(std::memory_order_relaxed)) {
+            int64_t window_min = min_sojourn_.exchange(kNoSample, std::memory_order_relaxed);
+            overloaded_.store(window_min != kNoSample && window_min > target_ns, std::memory_order_relaxed);
+            interval_end_.store(now_ns + std::chrono::duration_cast<std::chrono::nanoseconds>(interval_).count(),
+                                std::memory_order_release);
+        }
+        rolling_.store(false, std::memory_order_release);
+    }
+
+    int64_t current = min_sojourn_.load(std::memory_order_relaxed);
+    while (sojourn_ns < current &&
+           !min_sojourn_.compare_exchange_weak(current, sojourn_ns, std::memory_order_relaxed)) {
+    }
+
+    return overloaded_.load(std::memory_order_relaxed) && sojourn_ns > 2 * target_ns;
+}
+
+std::chrono::milliseconds CoDel::GetQueueTimeout(std::chrono::milliseconds normal) const {
+    return IsOverloaded() ? std::min(normal, 2 * target_) : normal;
+}
+
+} // namespace ai_backend::core::async
@@ -1,185 +1,222 @@
 #include "core/async/coroutine_pool.h"
 #include <spdlog/spdlog.h>
-#include <chrono>
+#include <algorithm>
 
 namespace ai_backend::core::async {
 
-// Make TaskWrapper::execute() a pure virtual function instead of empty implementation
-class TaskWrapper {
-public:
-    virtual ~TaskWrapper() = default;
-    virtual void execute() = 0; // Changed to pure virtual
+namespace {
+
+// 当前线程所属的池和工作线程下标，池外线程为空
+struct CurrentWorker {
+    const CoroutinePool* pool = nullptr;
+    size_t index = 0;
 };
 
-template <typename Func>
-class ConcreteTask : public TaskWrapper {
-public:
-    explicit ConcreteTask(Func&& func) : func_(std::forward<Func>(func)) {}
-    
-    void execute() override {
-        func_();
-    }
-    
-private:
-    Func func_;
+thread_local CurrentWorker t_current_worker;
+
+// 休眠前的窃取轮数，避免任务间隔很短时频繁进出futex
+constexpr int kSpinRounds = 64;
+
+} // namespace
+
+struct CoroutinePool::Worker {
+    explicit Worker(uint64_t seed) : rng(seed | 1) {}
+
+    WorkStealingDeque<detail::PoolJob*> deque;
+    std::thread thread;
+
+    // 选择窃取目标的xorshift状态，只由本线程访问
+    uint64_t rng;
+
+    size_t NextRandom() {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return static_cast<size_t>(rng);
+    }
 };
 
-CoroutinePool::CoroutinePool(size_t max_coroutines, size_t thread_count)
-    : max_coroutines_(max_coroutines),
-      active_coroutines_(0),
-      should_terminate_(false) {
-    
+CoroutinePool::CoroutinePool(size_t max_coroutines, size_t thread_count, ThreadStartHook on_thread_start)
+    : on_thread_start_(std::move(on_thread_start)) {
     if (thread_count == 0) {
         thread_count = std::thread::hardware_concurrency();
     }
-    
+    thread_count = std::max<size_t>(1, std::min(thread_count, max_coroutines));
+
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.push_back(std::make_unique<Worker>(0x9E3779B97F4A7C15ULL * (i + 1)));
+    }
+    // 所有Worker创建完成后再启动线程，窃取时会遍历workers_
     for (size_t i = 0; i < thread_count; ++i) {
-        worker_threads_.emplace_back(&CoroutinePool::WorkerThread, this);
+        workers_[i]->thread = std::thread(&CoroutinePool::WorkerThread, this, i);
     }
-    
-    // Initialize health check timer
-    StartHealthCheck();
 }
 
 CoroutinePool::~CoroutinePool() {
-    {
-        std::unique_lock<std::mutex> lock(mutex_);
-        should_terminate_ = true;
-        task_cv_.notify_all();
-    }
-    
-    // Join worker threads
-    for (auto& thread : worker_threads_) {
-        if (thread.joinable()) {
-            thread.join();
+    stopping_.store(true, std::memory_order_release);
+    idle_.NotifyAll();
+
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
         }
     }
 }
 
+void CoroutinePool::Enqueue(detail::PoolJob* job) {
+    outstanding_.fetch_add(1, std::memory_order_relaxed);
+
+    if (t_current_worker.pool == this) {
+        workers_[t_current_worker.index]->deque.Push(job);
+    } else {
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        inject_queue_.push_back(job);
+        inject_size_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    idle_.NotifyOne();
+}
+
 void CoroutinePool::WaitAll() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    completion_cv_.wait(lock, [this]() {
-        return task_queue_.empty() && active_coroutines_ == 0;
-    });
+    size_t outstanding = outstanding_.load(std::memory_order_acquire);
+    while (outstanding != 0) {
+        outstanding_.wait(outstanding, std::memory_order_acquire);
+        outstanding = outstanding_.load(std::memory_order_acquire);
+    }
 }
 
 size_t CoroutinePool::GetActiveCount() const {
-    return active_coroutines_.load();
+    return active_.load(std::memory_order_relaxed);
+}
+
+size_t CoroutinePool::GetPendingCount() const {
+    size_t outstanding = outstanding_.load(std::memory_order_relaxed);
+    size_t active = active_.load(std::memory_order_relaxed);
+    return outstanding > active ? outstanding - active : 0;
 }
 
-// New methods for health monitoring
 size_t CoroutinePool::GetPendingTaskCount() const {
-    std::unique_lock<std::mutex> lock(mutex_);
-    return task_queue_.size();
+    return GetPendingCount();
 }
 
 float CoroutinePool::GetUtilizationRate() const {
-    return static_cast<float>(active_coroutines_) / worker_threads_.size();
+    return static_cast<float>(GetActiveCount()) / static_cast<float>(workers_.size());
 }
 
-void CoroutinePool::StartHealthCheck() {
-    health_check_thread_ = std::thread([this]() {
-        while (!should_terminate_) {
-            std::this_thread::sleep_for(std::chrono::seconds(30));
-            PerformHealthCheck();
-        }
-    });
-}
-
-void CoroutinePool::PerformHealthCheck() {
-    // Log metrics for monitoring
-    float utilization = GetUtilizationRate();
-    size_t pending_tasks = GetPendingTaskCount();
-    
-    spdlog::debug("CoroutinePool health: Utilization={}%, Pending tasks={}, Active tasks={}",
-                  utilization * 100.0f, pending_tasks, active_coroutines_.load());
-    
-    // Adaptive scaling based on utilization
-    if (utilization > 0.8f && worker_threads_.size() < max_coroutines_) {
-        // High utilization, add more workers
-        AddWorkers(std::min(2UL, max_coroutines_ - worker_threads_.size()));
-    } else if (utilization < 0.2f && worker_threads_.size() > 2) {
-        // Low utilization, reduce workers
-        RemoveWorkers(1);
-    }
-}
-
-void CoroutinePool::AddWorkers(size_t count) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    
-    spdlog::info("CoroutinePool: Adding {} worker threads", count);
-    
-    for (size_t i = 0; i < count; ++i) {
-        worker_threads_.emplace_back(&CoroutinePool::WorkerThread, this);
-    }
+size_t CoroutinePool::GetWorkerCount() const {
+    return workers_.size();
 }
 
-void CoroutinePool::RemoveWorkers(size_t count) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    
-    count = std::min(count, worker_threads_.size() - 2);  // Keep at least 2 threads
-    if (count == 0) return;
-    
-    spdlog::info("CoroutinePool: Removing {} worker threads", count);
-    
-    // Flag threads for removal
-    workers_to_remove_ = count;
-    task_cv_.notify_all();
+size_t CoroutinePool::GetStealCount() const {
+    return steals_.load(std::memory_order_relaxed);
 }
 
-void CoroutinePool::WorkerThread() {
+void CoroutinePool::WorkerThread(size_t index) {
+    t_current_worker = {this, index};
+    if (on_thread_start_) {
+        on_thread_start_(index);
+    }
+    Worker& worker = *workers_[index];
+
     while (true) {
-        std::unique_ptr<TaskWrapper> task;
-        bool should_exit = false;
-        
-        {
-            std::unique_lock<std::mutex> lock(mutex_);
-            
-            task_cv_.wait(lock, [this]() {
-                return !task_queue_.empty() || should_terminate_ || workers_to_remove_ > 0;
-            });
-            
-            if (should_terminate_) {
-                break;
-            }
-            
-            if (workers_to_remove_ > 0) {
-                --workers_to_remove_;
-                should_exit = true;
-            } else if (!task_queue_.empty()) {
-                task = std::move(task_queue_.front());
-                task_queue_.pop_front();
-                ++active_coroutines_;
-            }
+        detail::PoolJob* job = nullptr;
+        for (int round = 0; round < kSpinRounds && !job; ++round) {
+            job = FindJob(worker);
+        }
+        if (job) {
+            RunJob(job);
+            continue;
+        }
+
+        // 登记后再检查一次，发布任务的线程要么能看到登记，要么这里能看到任务
+        uint32_t key = idle_.PrepareWait();
+        if (HasQueuedJobs()) {
+            idle_.CancelWait();
+            continue;
         }
-        
-        if (should_exit) {
-            spdlog::debug("CoroutinePool worker exiting as part of scaling down");
+        if (stopping_.load(std::memory_order_acquire)) {
+            idle_.CancelWait();
             break;
         }
-        
-        if (task) {
-            try {
-                // Execute with timeout protection
-                auto future = std::async(std::launch::async, [&task]() {
-                    task->execute();
-                });
-                
-                auto status = future.wait_for(std::chrono::seconds(60));
-                if (status == std::future_status::timeout) {
-                    spdlog::error("Task execution timed out after 60 seconds");
-                }
-            } catch (const std::exception& e) {
-                spdlog::error("Exception in task execution: {}", e.what());
-            }
-            
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                --active_coroutines_;
-                completion_cv_.notify_all();
-            }
+        idle_.Wait(key);
+    }
+
+    t_current_worker = {};
+}
+
+detail::PoolJob* CoroutinePool::FindJob(Worker& worker) {
+    if (auto* job = worker.deque.Pop()) {
+        return job;
+    }
+    if (auto* job = PopInjected()) {
+        return job;
+    }
+    return StealFrom(worker);
+}
+
+detail::PoolJob* CoroutinePool::PopInjected() {
+    if (inject_size_.load(std::memory_order_relaxed) == 0) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(inject_mutex_);
+    if (inject_queue_.empty()) {
+        return nullptr;
+    }
+    auto* job = inject_queue_.front();
+    inject_queue_.pop_front();
+    inject_size_.fetch_sub(1, std::memory_order_relaxed);
+    return job;
+}
+
+detail::PoolJob* CoroutinePool::StealFrom(Worker& thief) {
+    size_t count = workers_.size();
+    if (count <= 1) {
+        return nullptr;
+    }
+
+    // 从随机位置开始遍历，避免所有空闲线程同时争抢同一个队列
+    size_t start = thief.NextRandom() % count;
+    for (size_t i = 0; i < count; ++i) {
+        Worker& victim = *workers_[(start + i) % count];
+        if (&victim == &thief) {
+            continue;
         }
+        if (auto* job = victim.deque.Steal()) {
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+bool CoroutinePool::HasQueuedJobs() const {
+    if (inject_size_.load(std::memory_order_relaxed) > 0) {
+        return true;
+    }
+    for (const auto& worker : workers_) {
+        if (!worker->deque.Empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CoroutinePool::RunJob(detail::PoolJob* job) {
+    active_.fetch_add(1, std::memory_order_relaxed);
+    try {
+        job->run(job);
+    } catch (const std::exception& e) {
+        spdlog::error("Exception in pool task: {}", e.what());
+    } catch (...) {
+        spdlog::error("Unknown exception in pool task");
+    }
+    active_.fetch_sub(1, std::memory_order_relaxed);
+
+    if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        outstanding_.notify_all();
     }
 }
 
-} // namespace ai_backend::core::async
\ No newline at end of file
+} // namespace ai_backend::core::async
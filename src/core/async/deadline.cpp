@@ -0,0 +1,177 @@
+#include "core/async/deadline.h"
+#include "core/async/timer_wheel.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+
+namespace ai_backend::core::async {
+
+namespace detail {
+
+struct DeadlineState : std::enable_shared_from_this<DeadlineState> {
+    DeadlineState(const boost::asio::any_io_executor& executor, Deadline::Clock::time_point expiry)
+        : executor(executor), expiry(expiry) {}
+
+    // 标记到期并调用所有回调，只执行一次
+    void Expire() {
+        if (expired.exchange(true)) {
+            return;
+        }
+
+        std::vector<std::pair<uint64_t, std::function<void()>>> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.swap(callbacks);
+        }
+        for (auto& [id, callback] : pending) {
+            callback();
+        }
+    }
+
+    boost::asio::any_io_executor executor;
+    Deadline::Clock::time_point expiry;
+
+    // 计时节点挂在executor所属io_context的时间轮上，状态销毁时自动取消
+    TimerWheel::Timer timer;
+    std::atomic<bool> expired{false};
+
+    std::mutex mutex;
+    uint64_t next_id = 1;
+    std::vector<std::pair<uint64_t, std::function<void()>>> callbacks;
+
+    // 派生截止时间对父截止时间的注册
+    Deadline::Registration parent_registration;
+};
+
+} // namespace detail
+
+using detail::DeadlineState;
+
+Deadline::Registration::Registration(const std::shared_ptr<DeadlineState>& state, uint64_t id)
+    : state_(state), id_(id) {
+}
+
+Deadline::Registration::~Registration() {
+    auto state = state_.lock();
+    if (!state) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto& callbacks = state->callbacks;
+    callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(),
+                                   [this](const auto& entry) { return entry.first == id_; }),
+                    callbacks.end());
+}
+
+Deadline::Registration::Registration(Registration&& other) noexcept
+    : state_(std::move(other.state_)), id_(std::exchange(other.id_, 0)) {
+}
+
+Deadline::Registration& Deadline::Registration::operator=(Registration&& other) noexcept {
+    if (this != &other) {
+        Registration discarded(std::move(*this));
+        state_ = std::move(other.state_);
+        id_ = std::exchange(other.id_, 0);
+    }
+    return *this;
+}
+
+Deadline Deadline::After(const boost::asio::any_io_executor& executor, std::chrono::milliseconds timeout) {
+    auto state = std::make_shared<DeadlineState>(executor, Clock::now() + timeout);
+
+    // 定时器只持有弱引用，所有Deadline副本释放后状态随之销毁，定时器被取消；
+    // 时间轮的回调运行在驱动线程上，到期回调仍投递回创建时的executor执行
+    state->timer.SetCallback([weak = std::weak_ptr<DeadlineState>(state)]() {
+        if (auto state = weak.lock()) {
+            boost::asio::post(state->executor, [state]() { state->Expire(); });
+        }
+    });
+    TimerWheel::For(executor).ScheduleAt(state->timer, state->expiry);
+
+    return Deadline(std::move(state));
+}
+
+Deadline Deadline::Tighten(std::chrono::milliseconds timeout) const {
+    if (!state_) {
+        return *this;
+    }
+    // 先比较剩余时间，避免timeout很大时now + timeout溢出
+    if (timeout >= state_->expiry - Clock::now()) {
+        return *this;
+    }
+
+    auto child = After(state_->executor, timeout);
+    child.state_->parent_registration = OnExpire([weak = std::weak_ptr<DeadlineState>(child.state_)]() {
+        if (auto state = weak.lock()) {
+            state->Expire();
+        }
+    });
+    return child;
+}
+
+Deadline Deadline::Derive(const boost::asio::any_io_executor& executor) const {
+    // 派生对象不单独计时，由父截止时间的回调使其到期
+    auto state = std::make_shared<DeadlineState>(state_ ? state_->executor : executor, GetExpiry());
+    if (state_) {
+        state->parent_registration = OnExpire([weak = std::weak_ptr<DeadlineState>(state)]() {
+            if (auto state = weak.lock()) {
+                state->Expire();
+            }
+        });
+    }
+    return Deadline(std::move(state));
+}
+
+bool Deadline::IsExpired() const {
+    if (!state_) {
+        return false;
+    }
+    return state_->expired.load(std::memory_order_acquire) || Clock::now() >= state_->expiry;
+}
+
+std::chrono::milliseconds Deadline::Remaining() const {
+    if (!state_) {
+        return std::chrono::milliseconds::max();
+    }
+    if (state_->expired.load(std::memory_order_acquire)) {
+        return std::chrono::milliseconds::zero();
+    }
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(state_->expiry - Clock::now());
+    return std::max(remaining, std::chrono::milliseconds::zero());
+}
+
+Deadline::Clock::time_point Deadline::GetExpiry() const {
+    return state_ ? state_->expiry : Clock::time_point::max();
+}
+
+void Deadline::Cancel() const {
+    if (state_) {
+        state_->Expire();
+    }
+}
+
+Deadline::Registration Deadline::OnExpire(std::function<void()> callback) const {
+    if (!state_) {
+        return {};
+    }
+
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->expired.load(std::memory_order_acquire)) {
+            id = state_->next_id++;
+            state_->callbacks.emplace_back(id, std::move(callback));
+            return Registration(state_, id);
+        }
+    }
+
+    callback();
+    return {};
+}
+
+} // namespace ai_backend::core::async
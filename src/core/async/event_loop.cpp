@@ -1,12 +1,16 @@
 #include "core/async/event_loop.h"
+#include "core/async/frame_allocator.h"
 #include <spdlog/spdlog.h>
 
 namespace ai_backend::core::async {
 
-EventLoop::EventLoop(size_t thread_count)
-    : running_(false),
-      metrics_collection_enabled_(true) {
-    thread_count_ = thread_count > 0 ? thread_count : std::thread::hardware_concurrency();
+EventLoop::EventLoop(Runtime& runtime)
+    : io_context_(runtime.GetIoContext()),
+      running_(false),
+      metrics_collection_enabled_(true),
+      max_pending_tasks_(0),
+      pending_tasks_(0),
+      codel_(std::make_unique<CoDel>(std::chrono::milliseconds(50), std::chrono::milliseconds(500))) {
     InitializeMetrics();
 }
 
@@ -22,28 +26,12 @@ void EventLoop::Start() {
     
     running_ = true;
     
-    work_guard_ = std::make_unique<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>(
-        io_context_.get_executor());
-    
-    for (size_t i = 0; i < thread_count_; ++i) {
-        worker_threads_.emplace_back([this] {
-            try {
-                io_context_.run();
-            } catch (const std::exception& e) {
-                spdlog::error("Exception in EventLoop worker thread: {}", e.what());
-                if (metrics_collection_enabled_) {
-                    metrics_.exception_count++;
-                }
-            }
-        });
-    }
-    
     // Start metrics collection
     if (metrics_collection_enabled_) {
         StartMetricsCollection();
     }
     
-    spdlog::info("EventLoop started with {} worker threads", thread_count_);
+    spdlog::info("EventLoop started on runtime io_context");
 }
 
 void EventLoop::Stop() {
@@ -54,22 +42,8 @@ void EventLoop::Stop() {
     
     running_ = false;
     
-    work_guard_.reset();
-    io_context_.stop();
-    
-    for (auto& thread : worker_threads_) {
-        if (thread.joinable()) {
-            thread.join();
-        }
-    }
-    
-    worker_threads_.clear();
-    io_context_.restart();
-    
     // Stop metrics collection
-    if (metrics_thread_.joinable()) {
-        metrics_thread_.join();
-    }
+    TimerWheel::For(io_context_).Cancel(metrics_timer_);
     
     spdlog::info("EventLoop stopped");
 }
@@ -83,6 +57,28 @@ EventLoop& EventLoop::GetInstance() {
     return instance;
 }
 
+void EventLoop::ConfigureQueue(size_t max_pending_tasks, std::chrono::milliseconds target,
+                               std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        throw std::logic_error("EventLoop queue must be configured before Start");
+    }
+    max_pending_tasks_ = max_pending_tasks;
+    codel_ = std::make_unique<CoDel>(target, interval);
+}
+
+size_t EventLoop::GetPendingTasks() const {
+    return pending_tasks_.load(std::memory_order_relaxed);
+}
+
+size_t EventLoop::GetRejectedTasks() const {
+    return metrics_.tasks_rejected.load(std::memory_order_relaxed);
+}
+
+utils::LatencyHistogram::Snapshot EventLoop::GetQueueSojourn() const {
+    return queue_sojourn_.GetSnapshot();
+}
+
 // Explicit template instantiations to prevent linking errors
 template void EventLoop::Post<std::function<void()>>(std::function<void()>&&);
 template void EventLoop::Dispatch<std::function<void()>>(std::function<void()>&&);
@@ -94,11 +90,28 @@ void EventLoop::Post(Task&& task) {
         throw std::runtime_error("EventLoop not running");
     }
     
+    // 队列已满，或排队时间持续超过目标且仍有积压时拒绝；空队列总是接受，过载状态在积压排空后
+    // 的下一个观察窗口解除
+    size_t pending = pending_tasks_.load(std::memory_order_relaxed);
+    if ((max_pending_tasks_ > 0 && pending >= max_pending_tasks_) || (pending > 0 && codel_->IsOverloaded())) {
+        metrics_.tasks_rejected++;
+        throw QueueFullError();
+    }
+    pending_tasks_.fetch_add(1, std::memory_order_relaxed);
+    
     if (metrics_collection_enabled_) {
         metrics_.tasks_posted++;
     }
     
-    boost::asio::post(io_context_, std::forward<Task>(task));
+    // 已投递的任务没有失败通知的途径，CoDel只用于判断过载，不丢弃已入队的任务
+    boost::asio::post(io_context_, [this, posted_at = std::chrono::steady_clock::now(),
+                                    task = std::forward<Task>(task)]() mutable {
+        pending_tasks_.fetch_sub(1, std::memory_order_relaxed);
+        auto sojourn = std::chrono::steady_clock::now() - posted_at;
+        queue_sojourn_.Record(sojourn);
+        codel_->OnDequeue(sojourn);
+        task();
+    });
 }
 
 template <typename Task>
@@ -129,36 +142,7 @@ void EventLoop::Defer(Task&& task) {
 
 template <typename Clock, typename Duration>
 void EventLoop::ScheduleAt(const std::chrono::time_point<Clock, Duration>& time_point, std::function<void()> task) {
-    if (!running_) {
-        throw std::runtime_error("EventLoop not running");
-    }
-    
-    auto timer = std::make_shared<boost::asio::steady_timer>(io_context_, time_point);
-    
-    timer->async_wait([this, timer, task = std::move(task)](const boost::system::error_code& ec) {
-        if (!ec) {
-            try {
-                if (metrics_collection_enabled_) {
-                    metrics_.scheduled_tasks_executed++;
-                }
-                task();
-            } catch (const std::exception& e) {
-                spdlog::error("Exception in scheduled task: {}", e.what());
-                if (metrics_collection_enabled_) {
-                    metrics_.exception_count++;
-                }
-            }
-        } else if (ec != boost::asio::error::operation_aborted) {
-            spdlog::error("Timer error in ScheduleAt: {}", ec.message());
-            if (metrics_collection_enabled_) {
-                metrics_.timer_errors++;
-            }
-        }
-    });
-    
-    if (metrics_collection_enabled_) {
-        metrics_.tasks_scheduled++;
-    }
+    ScheduleAfter(std::chrono::duration_cast<std::chrono::milliseconds>(time_point - Clock::now()), std::move(task));
 }
 
 template <typename Rep, typename Period>
@@ -167,10 +151,11 @@ void EventLoop::ScheduleAfter(const std::chrono::duration<Rep, Period>& duration
         throw std::runtime_error("EventLoop not running");
     }
     
-    auto timer = std::make_shared<boost::asio::steady_timer>(io_context_, duration);
-    
-    timer->async_wait([this, timer, task = std::move(task)](const boost::system::error_code& ec) {
-        if (!ec) {
+    // 定时任务挂在io_context的时间轮上，不再为每个任务创建steady_timer
+    auto delay = std::chrono::ceil<std::chrono::milliseconds>(duration);
+    TimerWheel::For(io_context_).ScheduleAfter(delay, [this, task = std::move(task)]() {
+        // 时间轮回调运行在驱动线程上，任务投递到io_context执行，不阻塞其他定时器
+        boost::asio::post(io_context_, [this, task]() {
             try {
                 if (metrics_collection_enabled_) {
                     metrics_.scheduled_tasks_executed++;
@@ -182,12 +167,7 @@ void EventLoop::ScheduleAfter(const std::chrono::duration<Rep, Period>& duration
                     metrics_.exception_count++;
                 }
             }
-        } else if (ec != boost::asio::error::operation_aborted) {
-            spdlog::error("Timer error in ScheduleAfter: {}", ec.message());
-            if (metrics_collection_enabled_) {
-                metrics_.timer_errors++;
-            }
-        }
+        });
     });
     
     if (metrics_collection_enabled_) {
@@ -200,77 +180,39 @@ void EventLoop::ScheduleRecurring(std::chrono::milliseconds interval, std::funct
         throw std::runtime_error("EventLoop not running");
     }
     
-    struct RecurringTask : std::enable_shared_from_this<RecurringTask> {
-        RecurringTask(EventLoop& event_loop, boost::asio::io_context& io_context, 
-                      std::chrono::milliseconds interval, std::function<void()> task)
-            : event_loop_(event_loop), timer(io_context), interval(interval), task(std::move(task)), 
-              execution_count(0), first_execution_time(std::chrono::steady_clock::now()),
-              last_execution_time(first_execution_time) {
-        }
-        
-        void Start() {
-            timer.expires_after(interval);
-            
-            timer.async_wait([self = shared_from_this()](const boost::system::error_code& ec) {
-                if (!ec) {
-                    try {
-                        // Execute the task
-                        self->task();
-                        
-                        // Update metrics
-                        self->execution_count++;
-                        auto now = std::chrono::steady_clock::now();
-                        self->last_execution_time = now;
-                        auto total_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-                            now - self->first_execution_time).count();
-                        
-                        if (self->event_loop_.IsMetricsCollectionEnabled()) {
-                            self->event_loop_.metrics_.recurring_tasks_executed++;
-                            
-                            // Log recurring task metrics every 10 executions
-                            if (self->execution_count % 10 == 0) {
-                                spdlog::debug("Recurring task metrics: count={}, avg_interval={}ms", 
-                                             self->execution_count,
-                                             total_duration / self->execution_count);
-                            }
-                        }
-                        
-                        // Reschedule
-                        self->Start();
-                    } catch (const std::exception& e) {
-                        spdlog::error("Exception in recurring task: {}", e.what());
-                        if (self->event_loop_.IsMetricsCollectionEnabled()) {
-                            self->event_loop_.metrics_.exception_count++;
-                        }
-                        
-                        // Reschedule despite error
-                        self->Start();
-                    }
-                } else if (ec != boost::asio::error::operation_aborted) {
-                    spdlog::error("Timer error in recurring task: {}", ec.message());
-                    if (self->event_loop_.IsMetricsCollectionEnabled()) {
-                        self->event_loop_.metrics_.timer_errors++;
-                    }
-                    
-                    // Reschedule despite error
-                    self->Start();
-                }
-            });
-        }
-        
-        EventLoop& event_loop_;
-        boost::asio::steady_timer timer;
-        std::chrono::milliseconds interval;
+    struct RecurringState {
         std::function<void()> task;
-        
-        // Metrics
-        size_t execution_count;
-        std::chrono::steady_clock::time_point first_execution_time;
-        std::chrono::steady_clock::time_point last_execution_time;
+        std::atomic<size_t> execution_count{0};
+        std::chrono::steady_clock::time_point first_execution_time = std::chrono::steady_clock::now();
     };
+    auto state = std::make_shared<RecurringState>();
+    state->task = std::move(task);
     
-    auto recurring_task = std::make_shared<RecurringTask>(*this, io_context_, interval, std::move(task));
-    recurring_task->Start();
+    TimerWheel::For(io_context_).ScheduleRecurring(interval, [this, state]() {
+        boost::asio::post(io_context_, [this, state]() {
+            try {
+                state->task();
+                
+                size_t count = ++state->execution_count;
+                if (IsMetricsCollectionEnabled()) {
+                    metrics_.recurring_tasks_executed++;
+                    
+                    // Log recurring task metrics every 10 executions
+                    if (count % 10 == 0) {
+                        auto total_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - state->first_execution_time).count();
+                        spdlog::debug("Recurring task metrics: count={}, avg_interval={}ms", 
+                                     count, total_duration / count);
+                    }
+                }
+            } catch (const std::exception& e) {
+                spdlog::error("Exception in recurring task: {}", e.what());
+                if (IsMetricsCollectionEnabled()) {
+                    metrics_.exception_count++;
+                }
+            }
+        });
+    });
     
     if (metrics_collection_enabled_) {
         metrics_.recurring_tasks_created++;
@@ -282,26 +224,43 @@ void EventLoop::InitializeMetrics() {
 }
 
 void EventLoop::StartMetricsCollection() {
-    // Start a background thread for metrics collection
-    metrics_thread_ = std::thread([this]() {
-        while (running_) {
-            std::this_thread::sleep_for(std::chrono::seconds(60));
-            
-            if (!running_) break;
-            
-            // Log metrics
-            spdlog::info("EventLoop metrics: posted={}, dispatched={}, deferred={}, scheduled={}, "
-                         "executed_scheduled={}, executed_recurring={}, exceptions={}, timer_errors={}",
-                         metrics_.tasks_posted.load(),
-                         metrics_.tasks_dispatched.load(),
-                         metrics_.tasks_deferred.load(),
-                         metrics_.tasks_scheduled.load(),
-                         metrics_.scheduled_tasks_executed.load(),
-                         metrics_.recurring_tasks_executed.load(),
-                         metrics_.exception_count.load(),
-                         metrics_.timer_errors.load());
+    // 指标由时间轮定时输出，不再占用单独的线程
+    metrics_timer_.SetCallback([this]() {
+        if (!running_) {
+            return;
         }
+        
+        // Log metrics
+        auto sojourn = queue_sojourn_.GetSnapshot();
+        spdlog::info("EventLoop metrics: posted={}, rejected={}, pending={}, sojourn_p99={}us, overloaded={}, "
+                     "dispatched={}, deferred={}, scheduled={}, "
+                     "executed_scheduled={}, executed_recurring={}, exceptions={}, timer_errors={}",
+                     metrics_.tasks_posted.load(),
+                     metrics_.tasks_rejected.load(),
+                     pending_tasks_.load(),
+                     sojourn.Percentile(0.99),
+                     codel_->IsOverloaded(),
+                     metrics_.tasks_dispatched.load(),
+                     metrics_.tasks_deferred.load(),
+                     metrics_.tasks_scheduled.load(),
+                     metrics_.scheduled_tasks_executed.load(),
+                     metrics_.recurring_tasks_executed.load(),
+                     metrics_.exception_count.load(),
+                     metrics_.timer_errors.load());
+
+        auto frames = GetFrameAllocatorStats();
+        spdlog::info("Coroutine frame metrics: allocations={}, cache_hits={}, arena={}, "
+                     "live_frames={}, live_bytes={}, bytes_allocated={}",
+                     frames.allocations,
+                     frames.cache_hits,
+                     frames.arena_allocations,
+                     frames.GetLiveFrames(),
+                     frames.GetLiveBytes(),
+                     frames.bytes_allocated);
+        
+        TimerWheel::For(io_context_).Schedule(metrics_timer_, std::chrono::seconds(60));
     });
+    TimerWheel::For(io_context_).Schedule(metrics_timer_, std::chrono::seconds(60));
 }
 
 bool EventLoop::IsMetricsCollectionEnabled() const {
@@ -0,0 +1,291 @@
+#include "core/async/frame_allocator.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace ai_backend::core::async {
+
+namespace {
+
+// 每个帧前面的帧头，记录释放时应归还到哪里；16字节保持帧本身的默认对齐
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FrameHeader {
+    FrameArena* arena;
+    uint32_t kind;
+};
+
+constexpr size_t kHeaderSize = sizeof(FrameHeader);
+
+// 大小级别：128, 256, ..., 4096字节 (含帧头)
+constexpr size_t kMinClassShift = 7;
+constexpr size_t kClassCount = 6;
+constexpr size_t kMaxClassSize = size_t{1} << (kMinClassShift + kClassCount - 1);
+
+constexpr uint32_t kKindHeap = kClassCount;
+constexpr uint32_t kKindArena = kClassCount + 1;
+
+// 每个级别在单个线程上最多缓存的字节数，超出的帧归还给全局堆
+constexpr size_t kMaxCachedBytesPerClass = 256 * 1024;
+
+constexpr size_t ClassSize(size_t index) {
+    return size_t{1} << (kMinClassShift + index);
+}
+
+size_t ClassIndex(size_t total) {
+    size_t index = 0;
+    while (ClassSize(index) < total) {
+        ++index;
+    }
+    return index;
+}
+
+std::atomic<bool> g_pooling_enabled{true};
+
+// 只由所属线程写入的计数器，其他线程汇总时读取
+class Counter {
+public:
+    void Add(uint64_t delta) noexcept {
+        value_.store(value_.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    uint64_t Load() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+struct ThreadCounters {
+    Counter allocations;
+    Counter deallocations;
+    Counter cache_hits;
+    Counter arena_allocations;
+    Counter bytes_allocated;
+    Counter bytes_freed;
+
+    void AddTo(FrameAllocatorStats& stats) const {
+        stats.allocations += allocations.Load();
+        stats.deallocations += deallocations.Load();
+        stats.cache_hits += cache_hits.Load();
+        stats.arena_allocations += arena_allocations.Load();
+        stats.bytes_allocated += bytes_allocated.Load();
+        stats.bytes_freed += bytes_freed.Load();
+    }
+};
+
+struct ThreadCache;
+
+// 所有存活线程的计数器，以及已退出线程的累计值
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadCache*> caches;
+    FrameAllocatorStats retired;
+};
+
+Registry& GetRegistry() {
+    // 不析构，线程本地缓存可能在静态对象析构之后才销毁
+    static Registry* registry = new Registry();
+    return *registry;
+}
+
+struct FreeNode {
+    FreeNode* next;
+};
+
+struct ThreadCache {
+    ThreadCache() {
+        auto& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.caches.push_back(this);
+    }
+
+    ~ThreadCache();
+
+    FreeNode* free_lists[kClassCount] = {};
+    size_t free_counts[kClassCount] = {};
+    ThreadCounters counters;
+};
+
+// 线程退出、缓存已销毁后仍可能有帧被释放，此时直接走全局堆
+thread_local bool t_cache_destroyed = false;
+
+ThreadCache::~ThreadCache() {
+    for (size_t i = 0; i < kClassCount; ++i) {
+        while (FreeNode* node = free_lists[i]) {
+            free_lists[i] = node->next;
+            ::operator delete(node);
+        }
+    }
+
+    auto& registry = GetRegistry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        counters.AddTo(registry.retired);
+        registry.caches.erase(std::remove(registry.caches.begin(), registry.caches.end(), this),
+                              registry.caches.end());
+    }
+    t_cache_destroyed = true;
+}
+
+ThreadCache* GetThreadCache() {
+    if (t_cache_destroyed) {
+        return nullptr;
+    }
+    thread_local ThreadCache cache;
+    return &cache;
+}
+
+// 线程本地缓存销毁后的分配和释放计入已退出线程的累计值
+void RecordRetired(uint64_t allocations, uint64_t deallocations, uint64_t bytes_allocated, uint64_t bytes_freed) {
+    auto& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.retired.allocations += allocations;
+    registry.retired.deallocations += deallocations;
+    registry.retired.bytes_allocated += bytes_allocated;
+    registry.retired.bytes_freed += bytes_freed;
+}
+
+void* WriteHeader(void* block, uint32_t kind, FrameArena* arena) {
+    auto* header = static_cast<FrameHeader*>(block);
+    header->arena = arena;
+    header->kind = kind;
+    return static_cast<std::byte*>(block) + kHeaderSize;
+}
+
+} // namespace
+
+FrameArena::FrameArena(size_t chunk_size) : chunk_size_(chunk_size) {}
+
+FrameArena::FrameArena(void* buffer, size_t size, size_t chunk_size)
+    : chunk_size_(chunk_size),
+      cursor_(static_cast<std::byte*>(buffer)),
+      end_(static_cast<std::byte*>(buffer) + size) {}
+
+FrameArena::~FrameArena() {
+    if (live_frames_ != 0) {
+        spdlog::error("FrameArena destroyed with {} live coroutine frames", live_frames_);
+    }
+    while (Chunk* chunk = chunks_) {
+        chunks_ = chunk->next;
+        ::operator delete(chunk);
+    }
+}
+
+void* FrameArena::Allocate(size_t size) {
+    constexpr size_t kAlign = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    constexpr size_t kChunkHeader = (sizeof(Chunk) + kAlign - 1) & ~(kAlign - 1);
+    size = (size + kAlign - 1) & ~(kAlign - 1);
+
+    if (static_cast<size_t>(end_ - cursor_) < size) {
+        size_t capacity = std::max(chunk_size_, size + kChunkHeader);
+        auto* chunk = static_cast<Chunk*>(::operator new(capacity));
+        chunk->next = chunks_;
+        chunks_ = chunk;
+        cursor_ = reinterpret_cast<std::byte*>(chunk) + kChunkHeader;
+        end_ = reinterpret_cast<std::byte*>(chunk) + capacity;
+        bytes_reserved_ += capacity;
+    }
+
+    void* result = cursor_;
+    cursor_ += size;
+    ++live_frames_;
+    return result;
+}
+
+void SetFramePoolingEnabled(bool enabled) {
+    g_pooling_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsFramePoolingEnabled() {
+    return g_pooling_enabled.load(std::memory_order_relaxed);
+}
+
+FrameAllocatorStats GetFrameAllocatorStats() {
+    auto& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    FrameAllocatorStats stats = registry.retired;
+    for (const auto* cache : registry.caches) {
+        cache->counters.AddTo(stats);
+    }
+    return stats;
+}
+
+namespace detail {
+
+void* AllocateFrame(size_t size) {
+    size_t total = size + kHeaderSize;
+    ThreadCache* cache = GetThreadCache();
+
+    if (!cache) {
+        RecordRetired(1, 0, total, 0);
+        return WriteHeader(::operator new(total), kKindHeap, nullptr);
+    }
+
+    cache->counters.allocations.Add(1);
+    if (total > kMaxClassSize || !g_pooling_enabled.load(std::memory_order_relaxed)) {
+        cache->counters.bytes_allocated.Add(total);
+        return WriteHeader(::operator new(total), kKindHeap, nullptr);
+    }
+
+    size_t index = ClassIndex(total);
+    cache->counters.bytes_allocated.Add(ClassSize(index));
+
+    if (FreeNode* node = cache->free_lists[index]) {
+        cache->free_lists[index] = node->next;
+        --cache->free_counts[index];
+        cache->counters.cache_hits.Add(1);
+        return WriteHeader(node, static_cast<uint32_t>(index), nullptr);
+    }
+    return WriteHeader(::operator new(ClassSize(index)), static_cast<uint32_t>(index), nullptr);
+}
+
+void* AllocateFrame(size_t size, FrameArena& arena) {
+    size_t total = size + kHeaderSize;
+    if (ThreadCache* cache = GetThreadCache()) {
+        cache->counters.allocations.Add(1);
+        cache->counters.arena_allocations.Add(1);
+        cache->counters.bytes_allocated.Add(total);
+    } else {
+        RecordRetired(1, 0, total, 0);
+    }
+    return WriteHeader(arena.Allocate(total), kKindArena, &arena);
+}
+
+void DeallocateFrame(void* frame, size_t size) noexcept {
+    void* block = static_cast<std::byte*>(frame) - kHeaderSize;
+    auto* header = static_cast<FrameHeader*>(block);
+    uint32_t kind = header->kind;
+    ThreadCache* cache = GetThreadCache();
+
+    size_t total = kind < kClassCount ? ClassSize(kind) : size + kHeaderSize;
+    if (cache) {
+        cache->counters.deallocations.Add(1);
+        cache->counters.bytes_freed.Add(total);
+    } else {
+        RecordRetired(0, 1, 0, total);
+    }
+
+    if (kind == kKindArena) {
+        header->arena->Release();
+        return;
+    }
+
+    if (kind < kClassCount && cache &&
+        cache->free_counts[kind] < kMaxCachedBytesPerClass / ClassSize(kind)) {
+        auto* node = static_cast<FreeNode*>(block);
+        node->next = cache->free_lists[kind];
+        cache->free_lists[kind] = node;
+        ++cache->free_counts[kind];
+        return;
+    }
+
+    ::operator delete(block);
+}
+
+} // namespace detail
+
+} // namespace ai_backend::core::async
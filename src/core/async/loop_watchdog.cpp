@@ -0,0 +1,419 @@
+#include "core/async/loop_watchdog.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <sstream>
+
+#include <boost/asio/post.hpp>
+
+#ifdef __linux__
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+namespace ai_backend::core::async {
+
+namespace detail {
+
+thread_local ThreadActivity* t_thread_activity = nullptr;
+
+} // namespace detail
+
+namespace {
+
+using detail::MonotonicNanos;
+using detail::ThreadActivity;
+
+constexpr int64_t kNanosPerMilli = 1000000;
+constexpr int64_t kNanosPerMinute = 60 * 1000 * kNanosPerMilli;
+
+std::string Demangle(const char* name) {
+#ifdef __linux__
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0 && demangled) {
+        std::string result(demangled);
+        std::free(demangled);
+        return result;
+    }
+#endif
+    return name;
+}
+
+#ifdef __linux__
+// 调用栈采集使用的实时信号，避开常用的SIGRTMIN和性能分析器使用的SIGPROF
+int StackSignal() {
+    return SIGRTMIN + 6;
+}
+
+void OnStackSignal(int) {
+    int saved_errno = errno;
+    if (auto* activity = detail::t_thread_activity) {
+        int count = backtrace(activity->frames.data(), static_cast<int>(activity->frames.size()));
+        activity->frame_count.store(count, std::memory_order_release);
+    }
+    errno = saved_errno;
+}
+
+void InstallStackSignalHandler() {
+    static std::once_flag once;
+    std::call_once(once, []() {
+        // backtrace首次调用时会加载libgcc，先在普通上下文中调用一次
+        void* frame = nullptr;
+        backtrace(&frame, 1);
+
+        struct sigaction action{};
+        action.sa_handler = OnStackSignal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        sigaction(StackSignal(), &action, nullptr);
+    });
+}
+#endif
+
+} // namespace
+
+std::string HandlerIdentity::Describe() const {
+    if (type) {
+        return Demangle(type->name());
+    }
+    if (!address) {
+        return "unknown";
+    }
+#ifdef __linux__
+    Dl_info info{};
+    if (dladdr(address, &info) && info.dli_sname) {
+        return Demangle(info.dli_sname);
+    }
+#endif
+    std::ostringstream stream;
+    stream << address;
+    return stream.str();
+}
+
+void HandlerScope::OnSlowHandler(int64_t elapsed_ns) {
+    activity_->slow_handlers.fetch_add(1, std::memory_order_relaxed);
+    activity_->watchdog->RecordSlowHandler(*activity_, identity_, elapsed_ns);
+}
+
+LoopWatchdog::LoopWatchdog(LoopWatchdogOptions options, std::vector<boost::asio::io_context*> io_contexts)
+    : options_(std::move(options)),
+      io_contexts_(std::move(io_contexts)),
+      probes_(io_contexts_.size()) {
+}
+
+LoopWatchdog::~LoopWatchdog() {
+    Stop();
+}
+
+void LoopWatchdog::Start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (thread_.joinable()) {
+        return;
+    }
+
+#ifdef __linux__
+    InstallStackSignalHandler();
+#endif
+
+    stopping_ = false;
+    thread_ = std::thread([this]() { Run(); });
+}
+
+void LoopWatchdog::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!thread_.joinable()) {
+            return;
+        }
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+    thread_.join();
+}
+
+void LoopWatchdog::RegisterCurrentThread(size_t index, size_t io_context) {
+    auto activity = std::make_unique<ThreadActivity>();
+    activity->watchdog = this;
+    activity->index = index;
+    activity->io_context = io_context;
+    activity->threshold_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(options_.threshold).count();
+#ifdef __linux__
+    activity->native_handle = pthread_self();
+#endif
+    activity->registered = true;
+
+    detail::t_thread_activity = activity.get();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.push_back(std::move(activity));
+}
+
+void LoopWatchdog::UnregisterCurrentThread() {
+    auto* activity = detail::t_thread_activity;
+    if (!activity) {
+        return;
+    }
+
+    // 看门狗只在持有锁时向已注册的线程发送信号，注销之后不会再被中断
+    std::lock_guard<std::mutex> lock(mutex_);
+    activity->registered = false;
+    detail::t_thread_activity = nullptr;
+}
+
+void LoopWatchdog::Run() {
+    auto interval = std::max(options_.probe_interval, std::chrono::milliseconds(1));
+    int64_t next_report = MonotonicNanos() +
+        std::chrono::duration_cast<std::chrono::nanoseconds>(options_.report_interval).count();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!wakeup_.wait_for(lock, interval, [this]() { return stopping_; })) {
+        lock.unlock();
+
+        int64_t now = MonotonicNanos();
+        PostProbes(now);
+        CheckThreads(now);
+
+        if (options_.report_interval.count() > 0 && now >= next_report) {
+            Report();
+            next_report = now + std::chrono::duration_cast<std::chrono::nanoseconds>(options_.report_interval).count();
+        }
+
+        lock.lock();
+    }
+}
+
+void LoopWatchdog::PostProbes(int64_t now) {
+    int64_t threshold = std::chrono::duration_cast<std::chrono::nanoseconds>(options_.threshold).count();
+
+    for (size_t i = 0; i < io_contexts_.size(); ++i) {
+        std::vector<ThreadActivity*> stalled;
+        int64_t stalled_for = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& probe = probes_[i];
+
+            if (!probe.outstanding) {
+                probe.outstanding = true;
+                probe.posted_at = now;
+                boost::asio::post(*io_contexts_[i], [self = shared_from_this(), i, posted_at = now]() {
+                    self->OnProbe(i, posted_at);
+                });
+                continue;
+            }
+
+            if (probe.stall_reported || now - probe.posted_at <= threshold) {
+                continue;
+            }
+
+            // 探测任务迟迟没有执行，说明该io_context的所有线程都被占用；
+            // 已由HandlerScope标记的线程由CheckThreads报告，这里只采集其余线程
+            probe.stall_reported = true;
+            stalled_for = now - probe.posted_at;
+            for (auto& activity : threads_) {
+                if (activity->registered && activity->io_context == i) {
+                    activity->stalls.fetch_add(1, std::memory_order_relaxed);
+                    if (activity->busy_since.load(std::memory_order_acquire) == 0) {
+                        stalled.push_back(activity.get());
+                    }
+                }
+            }
+        }
+
+        spdlog::warn("Event loop stall: io_context {} has not run the lag probe for {}ms",
+                     i, stalled_for / kNanosPerMilli);
+
+        for (auto* activity : stalled) {
+            if (!TakeSampleBudget(now)) {
+                break;
+            }
+            auto stack = CaptureStack(*activity);
+            if (!stack.empty()) {
+                spdlog::warn("Stack of io thread {} during stall (outside tracked handlers):\n{}",
+                             activity->index, stack);
+            }
+        }
+    }
+}
+
+void LoopWatchdog::OnProbe(size_t io_context, int64_t posted_at) {
+    int64_t now = MonotonicNanos();
+    if (auto* activity = detail::t_thread_activity) {
+        activity->lag.Record(std::chrono::nanoseconds(now - posted_at));
+    }
+
+    bool recovered = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& probe = probes_[io_context];
+        probe.outstanding = false;
+        recovered = std::exchange(probe.stall_reported, false);
+    }
+
+    if (recovered) {
+        spdlog::warn("Event loop stall on io_context {} ended after {}ms", io_context,
+                     (now - posted_at) / kNanosPerMilli);
+    }
+}
+
+void LoopWatchdog::CheckThreads(int64_t now) {
+    struct Blocked {
+        ThreadActivity* activity;
+        HandlerIdentity identity;
+        int64_t busy_for;
+    };
+
+    std::vector<Blocked> blocked;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& activity : threads_) {
+            int64_t since = activity->busy_since.load(std::memory_order_acquire);
+            if (!activity->registered || since == 0 || since == activity->reported_since ||
+                now - since <= activity->threshold_ns) {
+                continue;
+            }
+            // 每个忙碌区间只报告一次，处理函数结束后由HandlerScope计入慢处理函数
+            activity->reported_since = since;
+            blocked.push_back({activity.get(),
+                               {activity->identity_address.load(std::memory_order_relaxed),
+                                activity->identity_type.load(std::memory_order_relaxed)},
+                               now - since});
+        }
+    }
+
+    for (auto& entry : blocked) {
+        std::string stack;
+        if (TakeSampleBudget(now)) {
+            stack = CaptureStack(*entry.activity);
+        }
+        spdlog::warn("Blocking call on io thread {}: {} has been running for {}ms{}{}",
+                     entry.activity->index, entry.identity.Describe(), entry.busy_for / kNanosPerMilli,
+                     stack.empty() ? "" : "\n", stack);
+    }
+}
+
+void LoopWatchdog::RecordSlowHandler(ThreadActivity& activity, HandlerIdentity identity, int64_t elapsed_ns) {
+    auto elapsed_us = static_cast<uint64_t>(elapsed_ns / 1000);
+    uint64_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& stats = slow_handlers_[identity];
+        count = ++stats.count;
+        stats.total_us += elapsed_us;
+        stats.max_us = std::max(stats.max_us, elapsed_us);
+    }
+
+    // 同一处理函数按1、2、4、8...次输出，避免日志本身成为阻塞来源
+    if ((count & (count - 1)) == 0) {
+        spdlog::warn("Slow handler on io thread {}: {} ran for {}ms (seen {} times)",
+                     activity.index, identity.Describe(), elapsed_ns / kNanosPerMilli, count);
+    }
+}
+
+bool LoopWatchdog::TakeSampleBudget(int64_t now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (now - budget_window_start_ >= kNanosPerMinute) {
+        budget_window_start_ = now;
+        budget_used_ = 0;
+    }
+    if (budget_used_ >= options_.stack_samples_per_minute) {
+        return false;
+    }
+    ++budget_used_;
+    return true;
+}
+
+std::string LoopWatchdog::CaptureStack(ThreadActivity& activity) {
+#ifdef __linux__
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!activity.registered) {
+            return {};
+        }
+        activity.frame_count.store(-1, std::memory_order_relaxed);
+        if (pthread_kill(activity.native_handle, StackSignal()) != 0) {
+            return {};
+        }
+    }
+
+    // 信号处理函数在目标线程上运行，最多等待50毫秒
+    int count = -1;
+    for (int i = 0; i < 50 && (count = activity.frame_count.load(std::memory_order_acquire)) < 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (count <= 0) {
+        return {};
+    }
+
+    std::ostringstream stream;
+    char** symbols = backtrace_symbols(activity.frames.data(), count);
+    // 跳过信号处理函数和信号跳板
+    for (int i = 2; i < count; ++i) {
+        std::string line = symbols ? symbols[i] : "";
+        // 形如 binary(_ZN...+0x1f) [0x...]，将修饰名还原
+        auto open = line.find('(');
+        auto plus = line.find('+', open);
+        if (open != std::string::npos && plus != std::string::npos && plus > open + 1) {
+            line = line.substr(0, open + 1) + Demangle(line.substr(open + 1, plus - open - 1).c_str()) +
+                   line.substr(plus);
+        }
+        stream << "  #" << (i - 2) << ' ' << line << '\n';
+    }
+    std::free(symbols);
+    return stream.str();
+#else
+    (void)activity;
+    return {};
+#endif
+}
+
+void LoopWatchdog::Report() {
+    auto stats = GetStats();
+    for (const auto& thread : stats.threads) {
+        if (thread.lag.count == 0) {
+            continue;
+        }
+        spdlog::info("Event loop lag on io thread {} (io_context {}): p50={}us p99={}us max={}us, "
+                     "handlers={} p99={}us slow={} stalls={}",
+                     thread.index, thread.io_context, thread.lag.Percentile(0.5), thread.lag.Percentile(0.99),
+                     thread.lag.max_us, thread.handlers.count, thread.handlers.Percentile(0.99),
+                     thread.slow_handlers, thread.stalls);
+    }
+    for (size_t i = 0; i < std::min<size_t>(5, stats.slow_handlers.size()); ++i) {
+        const auto& handler = stats.slow_handlers[i];
+        spdlog::info("Slow handler #{}: {} count={} total={}ms max={}ms", i + 1, handler.handler,
+                     handler.count, handler.total_us / 1000, handler.max_us / 1000);
+    }
+}
+
+LoopWatchdog::Stats LoopWatchdog::GetStats() const {
+    Stats stats;
+    std::vector<std::pair<HandlerIdentity, SlowHandlerStats>> slow;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& activity : threads_) {
+            stats.threads.push_back({activity->index,
+                                     activity->io_context,
+                                     activity->lag.GetSnapshot(),
+                                     activity->handlers.GetSnapshot(),
+                                     activity->slow_handlers.load(std::memory_order_relaxed),
+                                     activity->stalls.load(std::memory_order_relaxed)});
+        }
+        slow.assign(slow_handlers_.begin(), slow_handlers_.end());
+    }
+
+    // 符号化在锁外进行
+    for (auto& [identity, handler] : slow) {
+        handler.handler = identity.Describe();
+        stats.slow_handlers.push_back(std::move(handler));
+    }
+    std::sort(stats.slow_handlers.begin(), stats.slow_handlers.end(),
+              [](const auto& a, const auto& b) { return a.total_us > b.total_us; });
+    return stats;
+}
+
+} // namespace ai_backend::core::async
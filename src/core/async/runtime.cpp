@@ -0,0 +1,328 @@
+#include "core/async/runtime.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ai_backend::core::async {
+
+namespace {
+
+// 进程允许运行的CPU，受cgroup cpuset和taskset限制
+std::vector<int> AllowedCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &cpu_set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        size_t count = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t cpu = 0; cpu < count; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+// 将当前线程绑定到指定的CPU集合
+void PinCurrentThread(const std::vector<int>& cpus, const char* role, size_t index) {
+#ifdef __linux__
+    if (cpus.empty()) {
+        return;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &cpu_set);
+    }
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (rc != 0) {
+        spdlog::warn("Failed to pin {} thread {} to CPU {}: error {}", role, index, cpus.front(), rc);
+    }
+#else
+    (void)cpus;
+    (void)role;
+    (void)index;
+#endif
+}
+
+size_t ResolveIoThreads(const RuntimeOptions& options) {
+    return options.io_threads > 0 ? options.io_threads : AllowedCpus().size();
+}
+
+} // namespace
+
+IoMode RuntimeOptions::ParseIoMode(const std::string& name) {
+    if (name == "sharded") {
+        return IoMode::kSharded;
+    }
+
+    if (name != "shared") {
+        spdlog::warn("Unknown runtime io_mode '{}', using shared", name);
+    }
+
+    return IoMode::kShared;
+}
+
+namespace detail {
+
+std::vector<int> ParseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), [](unsigned char c) { return std::isspace(c); }),
+                    range.end());
+        if (range.empty()) {
+            continue;
+        }
+        try {
+            auto dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            spdlog::warn("Invalid CPU list entry '{}'", range);
+        }
+    }
+    return cpus;
+}
+
+std::vector<std::vector<int>> DetectNumaNodes() {
+    auto allowed = AllowedCpus();
+    std::vector<std::vector<int>> nodes;
+
+    // 节点编号可能不连续，连续若干个不存在时停止
+    for (int node = 0, missing = 0; missing < 8; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) {
+            ++missing;
+            continue;
+        }
+        missing = 0;
+
+        std::string text;
+        std::getline(file, text);
+        std::vector<int> cpus;
+        for (int cpu : ParseCpuList(text)) {
+            if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (!cpus.empty()) {
+            nodes.push_back(std::move(cpus));
+        }
+    }
+
+    if (nodes.empty()) {
+        nodes.push_back(std::move(allowed));
+    }
+    return nodes;
+}
+
+} // namespace detail
+
+Runtime::Runtime(RuntimeOptions options) : options_(std::move(options)) {
+    io_contexts_.push_back(std::make_unique<boost::asio::io_context>());
+    ResizeIoContexts();
+}
+
+Runtime::~Runtime() {
+    Stop();
+}
+
+Runtime& Runtime::GetInstance() {
+    static Runtime instance;
+    return instance;
+}
+
+void Runtime::Configure(RuntimeOptions options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        throw std::logic_error("Runtime must be configured before Start");
+    }
+    options_ = std::move(options);
+    ResizeIoContexts();
+}
+
+void Runtime::ResizeIoContexts() {
+    // 第0个io_context始终保留，已经取得它的单例不受影响
+    size_t count = options_.io_mode == IoMode::kSharded ? ResolveIoThreads(options_) : 1;
+    while (io_contexts_.size() > count) {
+        io_contexts_.pop_back();
+    }
+    while (io_contexts_.size() < count) {
+        // 每个分片只由一个线程运行，提示Asio省去调度器锁
+        io_contexts_.push_back(std::make_unique<boost::asio::io_context>(1));
+    }
+}
+
+void Runtime::Start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+
+    nodes_ = options_.numa_aware ? detail::DetectNumaNodes() : std::vector<std::vector<int>>{AllowedCpus()};
+    size_t available = AllowedCpus().size();
+    size_t io_threads = ResolveIoThreads(options_);
+    size_t blocking_threads = std::max<size_t>(1, options_.blocking_threads);
+    size_t cpu_threads = options_.cpu_threads > 0 ? options_.cpu_threads : std::max<size_t>(1, available / 2);
+
+    blocking_pool_ = std::make_unique<CoroutinePool>(blocking_threads, blocking_threads, [this](size_t index) {
+        PinCurrentThread(PoolThreadCpus(index), "blocking", index);
+    });
+    cpu_pool_ = std::make_unique<CoroutinePool>(cpu_threads, cpu_threads, [this](size_t index) {
+        PinCurrentThread(PoolThreadCpus(index), "cpu", index);
+    });
+
+    for (auto& io_context : io_contexts_) {
+        work_guards_.emplace_back(io_context->get_executor());
+    }
+
+    // 看门狗先于IO线程创建，IO线程启动时向它注册
+    watchdog_.reset();
+    if (options_.watchdog.enabled) {
+        std::vector<boost::asio::io_context*> contexts;
+        for (auto& io_context : io_contexts_) {
+            contexts.push_back(io_context.get());
+        }
+        watchdog_ = std::make_shared<LoopWatchdog>(options_.watchdog, std::move(contexts));
+        watchdog_->Start();
+    }
+
+    running_ = true;
+
+    io_threads_.reserve(io_threads);
+    for (size_t i = 0; i < io_threads; ++i) {
+        size_t context_index = i % io_contexts_.size();
+        io_threads_.emplace_back([this, context_index, i, watchdog = watchdog_]() {
+            PinCurrentThread(IoThreadCpus(i), "io", i);
+            if (watchdog) {
+                watchdog->RegisterCurrentThread(i, context_index);
+            }
+            try {
+                io_contexts_[context_index]->run();
+            } catch (const std::exception& e) {
+                spdlog::error("Exception in runtime io thread {}: {}", i, e.what());
+            }
+            if (watchdog) {
+                watchdog->UnregisterCurrentThread();
+            }
+        });
+    }
+
+    spdlog::info("Runtime started: {} io threads ({} mode, {} io_context), {} blocking threads, "
+                 "{} cpu threads, {} NUMA node(s){}{}",
+                 io_threads, options_.io_mode == IoMode::kSharded ? "sharded" : "shared",
+                 io_contexts_.size(), blocking_threads, cpu_threads, nodes_.size(),
+                 options_.pin_threads ? ", pinned" : "", watchdog_ ? ", watchdog" : "");
+}
+
+void Runtime::Stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+
+    if (watchdog_) {
+        watchdog_->Stop();
+    }
+
+    work_guards_.clear();
+    for (auto& io_context : io_contexts_) {
+        io_context->stop();
+    }
+    for (auto& thread : io_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    io_threads_.clear();
+
+    // 线程池析构时执行完已提交的任务，其中可能还会投递到io_context
+    blocking_pool_.reset();
+    cpu_pool_.reset();
+
+    for (auto& io_context : io_contexts_) {
+        io_context->restart();
+    }
+
+    spdlog::info("Runtime stopped");
+}
+
+bool Runtime::IsRunning() const {
+    return running_;
+}
+
+const RuntimeOptions& Runtime::GetOptions() const {
+    return options_;
+}
+
+size_t Runtime::GetIoContextCount() const {
+    return io_contexts_.size();
+}
+
+boost::asio::io_context& Runtime::GetIoContext(size_t index) {
+    return *io_contexts_[index % io_contexts_.size()];
+}
+
+boost::asio::io_context& Runtime::NextIoContext() {
+    return GetIoContext(next_io_context_.fetch_add(1, std::memory_order_relaxed));
+}
+
+std::shared_ptr<LoopWatchdog> Runtime::GetWatchdog() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return watchdog_;
+}
+
+CoroutinePool& Runtime::GetBlockingPool() {
+    if (!blocking_pool_) {
+        throw std::logic_error("Runtime is not running");
+    }
+    return *blocking_pool_;
+}
+
+CoroutinePool& Runtime::GetCpuPool() {
+    if (!cpu_pool_) {
+        throw std::logic_error("Runtime is not running");
+    }
+    return *cpu_pool_;
+}
+
+std::vector<int> Runtime::IoThreadCpus(size_t index) const {
+    if (!options_.pin_threads) {
+        return {};
+    }
+    // 依次轮换节点，同一节点内依次占用核心
+    const auto& node = nodes_[index % nodes_.size()];
+    return {node[(index / nodes_.size()) % node.size()]};
+}
+
+std::vector<int> Runtime::PoolThreadCpus(size_t index) const {
+    // 线程池不独占核心，只在NUMA模式下限制在节点内，与所服务的IO线程共享本地内存
+    if (!options_.pin_threads || !options_.numa_aware) {
+        return {};
+    }
+    return nodes_[index % nodes_.size()];
+}
+
+} // namespace ai_backend::core::async
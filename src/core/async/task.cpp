@@ -1,5 +1,18 @@
 #include "core/async/task.h"
+#include <spdlog/spdlog.h>
 
-namespace ai_backend::core::async {
+namespace ai_backend::core::async::detail {
 
-} // namespace ai_backend::core::async
\ No newline at end of file
+thread_local const boost::asio::any_io_executor* t_current_executor = nullptr;
+
+void LogUnhandledException(std::exception_ptr exception) noexcept {
+    try {
+        std::rethrow_exception(exception);
+    } catch (const std::exception& e) {
+        spdlog::error("Unhandled exception in detached task: {}", e.what());
+    } catch (...) {
+        spdlog::error("Unhandled unknown exception in detached task");
+    }
+}
+
+} // namespace ai_backend::core::async::detail
@@ -0,0 +1,347 @@
+#include "core/async/timer_wheel.h"
+#include "core/async/loop_watchdog.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+
+namespace ai_backend::core::async {
+
+namespace {
+
+// 每个io_context一个时间轮，由绑定在strand上的asio定时器驱动
+class TimerWheelService : public boost::asio::execution_context::service {
+public:
+    static boost::asio::execution_context::id id;
+
+    explicit TimerWheelService(boost::asio::io_context& io_context)
+        : boost::asio::execution_context::service(io_context),
+          strand_(boost::asio::make_strand(io_context)),
+          timer_(strand_) {
+        wheel_.SetWakeupHandler([this]() {
+            boost::asio::post(strand_, [this]() { Rearm(); });
+        });
+    }
+
+    TimerWheel& GetWheel() { return wheel_; }
+
+private:
+    void shutdown() override {
+        wheel_.SetWakeupHandler(nullptr);
+        timer_.cancel();
+    }
+
+    void Rearm() {
+        auto wakeup = wheel_.PrepareWakeup();
+        if (wakeup == TimerWheel::Clock::time_point::max()) {
+            timer_.cancel();
+            return;
+        }
+
+        timer_.expires_at(wakeup);
+        timer_.async_wait([this](const boost::system::error_code& ec) {
+            if (ec) {
+                return;
+            }
+            wheel_.Advance(TimerWheel::Clock::now());
+            Rearm();
+        });
+    }
+
+    TimerWheel wheel_;
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+    boost::asio::steady_timer timer_;
+};
+
+boost::asio::execution_context::id TimerWheelService::id;
+
+} // namespace
+
+struct TimerWheel::OwnedTimer : Timer {
+    OwnedTimer(std::function<void()> callback, std::chrono::milliseconds interval)
+        : Timer(std::move(callback)), interval(interval) {
+        owned_ = true;
+    }
+
+    // 为0时是一次性任务
+    std::chrono::milliseconds interval;
+};
+
+TimerWheel::Timer::~Timer() {
+    if (wheel_) {
+        wheel_->Cancel(*this);
+    }
+}
+
+TimerWheel::TimerWheel(Clock::time_point origin) : origin_(origin) {}
+
+TimerWheel::~TimerWheel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto detach = [](Timer* timer) {
+        while (timer) {
+            Timer* next = timer->next_;
+            timer->slot_ = nullptr;
+            timer->prev_ = timer->next_ = nullptr;
+            timer->wheel_ = nullptr;
+            if (timer->owned_) {
+                delete static_cast<OwnedTimer*>(timer);
+            }
+            timer = next;
+        }
+    };
+
+    for (auto& level : slots_) {
+        for (auto* head : level) {
+            detach(head);
+        }
+    }
+    detach(expired_);
+}
+
+TimerWheel& TimerWheel::For(boost::asio::io_context& io_context) {
+    return boost::asio::use_service<TimerWheelService>(io_context).GetWheel();
+}
+
+TimerWheel& TimerWheel::For(const boost::asio::any_io_executor& executor) {
+    // 项目中的executor都是io_context的executor或其上的strand
+    using IoExecutor = boost::asio::io_context::executor_type;
+    if (const auto* io_executor = executor.target<IoExecutor>()) {
+        return For(io_executor->context());
+    }
+    if (const auto* strand = executor.target<boost::asio::strand<IoExecutor>>()) {
+        return For(strand->get_inner_executor().context());
+    }
+    throw std::invalid_argument("TimerWheel requires an io_context executor");
+}
+
+void TimerWheel::Schedule(Timer& timer, std::chrono::milliseconds delay) {
+    // 超出范围的延迟按时间轮的最大范围处理，避免now + delay溢出
+    delay = std::min(delay, std::chrono::milliseconds(kMaxDelta));
+    ScheduleAt(timer, Clock::now() + delay);
+}
+
+void TimerWheel::ScheduleAt(Timer& timer, Clock::time_point expiry) {
+    uint64_t tick = TickAtOrAfter(expiry);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (timer.slot_) {
+        Unlink(timer);
+    } else {
+        ++size_;
+    }
+    Link(timer, tick);
+}
+
+bool TimerWheel::Cancel(Timer& timer) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (timer.slot_) {
+        Unlink(timer);
+        --size_;
+        // 时间轮已空，让驱动方取消asio定时器，不再占用io_context
+        if (size_ == 0 && wakeup_tick_ != kNoWakeup && wakeup_handler_) {
+            wakeup_tick_ = kNoWakeup;
+            wakeup_handler_();
+        }
+        return true;
+    }
+
+    if (firing_ == &timer && firing_thread_ != std::this_thread::get_id()) {
+        ++firing_waiters_;
+        firing_done_.wait(lock, [&]() { return firing_ != &timer; });
+        --firing_waiters_;
+    }
+    return false;
+}
+
+void TimerWheel::ScheduleAfter(std::chrono::milliseconds delay, std::function<void()> callback) {
+    auto* timer = new OwnedTimer(std::move(callback), std::chrono::milliseconds::zero());
+    Schedule(*timer, delay);
+}
+
+void TimerWheel::ScheduleRecurring(std::chrono::milliseconds interval, std::function<void()> callback) {
+    auto* timer = new OwnedTimer(std::move(callback), std::max(interval, kTick));
+    Schedule(*timer, interval);
+}
+
+size_t TimerWheel::Advance(Clock::time_point now) {
+    if (now < origin_) {
+        return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now - origin_).count());
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t fired = 0;
+
+    while (next_tick_ <= target) {
+        if (size_ == 0) {
+            next_tick_ = target + 1;
+            break;
+        }
+
+        uint64_t tick = next_tick_;
+        size_t index = tick & kSlotMask;
+
+        // 第0层转完一圈时，把上一层对应槽的定时器分散到下一层
+        if (index == 0) {
+            for (size_t level = 1; level < kLevels; ++level) {
+                size_t level_index = (tick >> (level * kSlotBits)) & kSlotMask;
+                Cascade(level, level_index);
+                if (level_index != 0) {
+                    break;
+                }
+            }
+        }
+        ++next_tick_;
+
+        // 先整体移到expired_，回调期间重新启动的定时器不会在本tick再次运行
+        expired_ = std::exchange(slots_[0][index], nullptr);
+        for (Timer* timer = expired_; timer; timer = timer->next_) {
+            timer->slot_ = &expired_;
+        }
+
+        while (Timer* timer = expired_) {
+            Unlink(*timer);
+            --size_;
+            Fire(*timer, tick, lock);
+            ++fired;
+        }
+    }
+
+    return fired;
+}
+
+TimerWheel::Clock::time_point TimerWheel::PrepareWakeup() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (size_ == 0) {
+        wakeup_tick_ = kNoWakeup;
+        return Clock::time_point::max();
+    }
+
+    // 最近的非空槽，最迟在下一次级联时唤醒
+    uint64_t boundary = (next_tick_ & kSlotMask) == 0 ? next_tick_ : (next_tick_ | kSlotMask) + 1;
+    uint64_t tick = next_tick_;
+    while (tick < boundary && !slots_[0][tick & kSlotMask]) {
+        ++tick;
+    }
+
+    wakeup_tick_ = tick;
+    return TimeOfTick(tick);
+}
+
+void TimerWheel::SetWakeupHandler(std::function<void()> handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wakeup_handler_ = std::move(handler);
+}
+
+size_t TimerWheel::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+}
+
+uint64_t TimerWheel::TickAtOrAfter(Clock::time_point time) const {
+    if (time <= origin_) {
+        return 0;
+    }
+    auto elapsed = time - origin_;
+    auto ticks = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+    if (ticks < elapsed) {
+        ++ticks;
+    }
+    return static_cast<uint64_t>(ticks.count());
+}
+
+TimerWheel::Clock::time_point TimerWheel::TimeOfTick(uint64_t tick) const {
+    return origin_ + std::chrono::milliseconds(tick);
+}
+
+void TimerWheel::Link(Timer& timer, uint64_t expiry) {
+    // 已到期的定时器在下一个tick运行
+    expiry = std::max(expiry, next_tick_);
+    uint64_t delta = std::min(expiry - next_tick_, kMaxDelta);
+    expiry = next_tick_ + delta;
+
+    size_t level = 0;
+    while (level + 1 < kLevels && delta >= (uint64_t{1} << ((level + 1) * kSlotBits))) {
+        ++level;
+    }
+
+    Timer** slot = &slots_[level][(expiry >> (level * kSlotBits)) & kSlotMask];
+    timer.wheel_ = this;
+    timer.expiry_ = expiry;
+    timer.slot_ = slot;
+    timer.prev_ = nullptr;
+    timer.next_ = *slot;
+    if (*slot) {
+        (*slot)->prev_ = &timer;
+    }
+    *slot = &timer;
+
+    if (expiry < wakeup_tick_ && wakeup_handler_) {
+        wakeup_tick_ = expiry;
+        wakeup_handler_();
+    }
+}
+
+void TimerWheel::Unlink(Timer& timer) {
+    if (timer.prev_) {
+        timer.prev_->next_ = timer.next_;
+    } else {
+        *timer.slot_ = timer.next_;
+    }
+    if (timer.next_) {
+        timer.next_->prev_ = timer.prev_;
+    }
+    timer.slot_ = nullptr;
+    timer.prev_ = timer.next_ = nullptr;
+}
+
+void TimerWheel::Cascade(size_t level, size_t index) {
+    Timer* timer = std::exchange(slots_[level][index], nullptr);
+    while (timer) {
+        Timer* next = timer->next_;
+        Link(*timer, timer->expiry_);
+        timer = next;
+    }
+}
+
+void TimerWheel::Fire(Timer& timer, uint64_t tick, std::unique_lock<std::mutex>& lock) {
+    firing_ = &timer;
+    firing_thread_ = std::this_thread::get_id();
+    bool owned = timer.owned_;
+
+    // 回调中可以重新启动、取消甚至销毁自己的定时器
+    lock.unlock();
+    try {
+        HandlerScope scope(HandlerIdentity{nullptr, &timer.callback_.target_type()});
+        timer.callback_();
+    } catch (const std::exception& e) {
+        spdlog::error("Exception in timer callback: {}", e.what());
+    } catch (...) {
+        spdlog::error("Unknown exception in timer callback");
+    }
+    lock.lock();
+
+    firing_ = nullptr;
+    if (firing_waiters_ > 0) {
+        firing_done_.notify_all();
+    }
+
+    if (owned && !timer.slot_) {
+        auto& owned_timer = static_cast<OwnedTimer&>(timer);
+        if (owned_timer.interval.count() > 0) {
+            ++size_;
+            Link(timer, tick + static_cast<uint64_t>(owned_timer.interval.count()));
+        } else {
+            timer.wheel_ = nullptr;
+            delete &owned_timer;
+        }
+    }
+}
+
+} // namespace ai_backend::core::async
@@ -0,0 +1,62 @@
+#include "core/async/wait_queue.h"
+#include <algorithm>
+
+namespace ai_backend::core::async::detail {
+
+void Waiter::Resume() {
+    ResumeAt(executor, handle);
+}
+
+void WaitQueue::Push(std::shared_ptr<Waiter> waiter) {
+    while (!waiters_.empty() && waiters_.front()->IsCancelled()) {
+        waiters_.pop_front();
+    }
+
+    // 队首一直有协程等待时，超时的节点会在中间堆积，按倍增的阈值整体清理
+    if (waiters_.size() >= compact_threshold_) {
+        waiters_.erase(std::remove_if(waiters_.begin(), waiters_.end(),
+                                      [](const auto& entry) { return entry->IsCancelled(); }),
+                       waiters_.end());
+        compact_threshold_ = std::max(kMinCompactSize, waiters_.size() * 2);
+    }
+
+    waiters_.push_back(std::move(waiter));
+}
+
+std::shared_ptr<Waiter> WaitQueue::PopWaiting() {
+    while (!waiters_.empty()) {
+        auto waiter = std::move(waiters_.front());
+        waiters_.pop_front();
+        if (waiter->TryResume()) {
+            return waiter;
+        }
+    }
+    return nullptr;
+}
+
+std::deque<std::shared_ptr<Waiter>> WaitQueue::PopAllWaiting() {
+    std::deque<std::shared_ptr<Waiter>> waiting;
+    for (auto& waiter : waiters_) {
+        if (waiter->TryResume()) {
+            waiting.push_back(std::move(waiter));
+        }
+    }
+    waiters_.clear();
+    return waiting;
+}
+
+size_t WaitQueue::CountWaiting() const {
+    return static_cast<size_t>(std::count_if(waiters_.begin(), waiters_.end(),
+                                             [](const auto& entry) { return !entry->IsCancelled(); }));
+}
+
+void RegisterDeadline(const std::shared_ptr<Waiter>& waiter, const Deadline& deadline) {
+    auto registration = deadline.OnExpire([weak = std::weak_ptr<Waiter>(waiter)]() {
+        if (auto waiter = weak.lock(); waiter && waiter->TryCancel()) {
+            waiter->Resume();
+        }
+    });
+    waiter->registration = std::move(registration);
+}
+
+} // namespace ai_backend::core::async::detail
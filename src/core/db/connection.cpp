@@ -0,0 +1,390 @@
+#include "core/db/connection.h"
+#include "core/async/runtime.h"
+#include "core/memory/memory_tracker.h"
+#include <sys/socket.h>
+#include <coroutine>
+#include <spdlog/spdlog.h>
+
+namespace ai_backend::core::db {
+
+using namespace async;
+
+namespace {
+
+// libpq的错误信息以换行结尾
+std::string ErrorText(const char* text) {
+    std::string message = text ? text : "";
+    while (!message.empty() && (message.back() == '\n' || message.back() == ' ')) {
+        message.pop_back();
+    }
+    return message;
+}
+
+// 把套接字异步操作的完成转成协程的恢复
+// 协程回到挂起时所在的执行器 (如会话strand)；该执行器就是连接所在的io_context时在完成回调中直接恢复，
+// 否则投递过去，不会在连接的IO线程上继续执行调用方的代码
+template <typename Initiate>
+class SocketAwaiter {
+public:
+    SocketAwaiter(boost::asio::io_context& io_context, Initiate initiate)
+        : io_context_(io_context), initiate_(std::move(initiate)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        auto executor = CurrentExecutor();
+        bool same_context = !executor || executor == boost::asio::any_io_executor(io_context_.get_executor());
+        initiate_([this, handle, executor = std::move(executor), same_context](const boost::system::error_code& ec,
+                                                                              auto&&...) {
+            ec_ = ec;
+            if (same_context) {
+                ExecutorScope executor_scope(executor);
+                HandlerScope scope(HandlerIdentity::Of(handle));
+                handle.resume();
+            } else {
+                async::detail::ResumeAt(executor, handle);
+            }
+        });
+    }
+
+    boost::system::error_code await_resume() const noexcept { return ec_; }
+
+private:
+    boost::asio::io_context& io_context_;
+    Initiate initiate_;
+    boost::system::error_code ec_;
+};
+
+} // namespace
+
+// 一次连接或查询期间注册截止时间回调，结束后迟到的回调不再中断连接
+class Connection::Operation {
+public:
+    Operation(Connection& connection, const Deadline& deadline) : connection_(connection) {
+        uint64_t id = 0;
+        {
+            std::lock_guard<std::mutex> lock(connection_.mutex_);
+            id = ++connection_.next_operation_;
+            connection_.operation_ = id;
+        }
+        registration_ = deadline.OnExpire([weak = connection_.weak_from_this(), id]() {
+            if (auto connection = weak.lock()) {
+                connection->Interrupt(id);
+            }
+        });
+    }
+
+    ~Operation() {
+        std::lock_guard<std::mutex> lock(connection_.mutex_);
+        connection_.operation_ = 0;
+    }
+
+    Operation(const Operation&) = delete;
+    Operation& operator=(const Operation&) = delete;
+
+private:
+    Connection& connection_;
+    Deadline::Registration registration_;
+};
+
+Connection::Connection(boost::asio::io_context& io_context, PGconn* conn)
+    : io_context_(io_context),
+      conn_(conn),
+      socket_(io_context) {
+}
+
+Connection::~Connection() {
+    // 先从io_context注销，再由PQfinish关闭套接字
+    DetachSocket();
+    PQfinish(conn_);
+}
+
+Task<std::shared_ptr<Connection>> Connection::Connect(boost::asio::io_context& io_context,
+                                                      std::string conninfo,
+                                                      Deadline deadline) {
+    if (deadline.IsExpired()) {
+        throw DeadlineExceeded("Deadline exceeded before connecting to database");
+    }
+
+    PGconn* conn = nullptr;
+    auto& runtime = Runtime::GetInstance();
+    if (runtime.IsRunning()) {
+        // 回到调用方所在的执行器，调用方不在执行器上运行时回到连接所在的io_context
+        auto resume_on = CurrentExecutor();
+        if (!resume_on) {
+            resume_on = io_context.get_executor();
+        }
+        auto start = runtime.RunBlocking([&conninfo]() { return PQconnectStart(conninfo.c_str()); },
+                                         std::move(resume_on));
+        conn = co_await start;
+    } else {
+        conn = PQconnectStart(conninfo.c_str());
+    }
+    if (!conn) {
+        throw DbError("Failed to allocate database connection");
+    }
+
+    std::shared_ptr<Connection> connection(new Connection(io_context, conn));
+    auto handshake = connection->CompleteConnect(std::move(deadline));
+    co_await handshake;
+    co_return connection;
+}
+
+std::shared_ptr<Connection> Connection::ConnectBlocking(boost::asio::io_context& io_context,
+                                                        const std::string& conninfo) {
+    PGconn* conn = PQconnectdb(conninfo.c_str());
+    if (!conn) {
+        throw DbError("Failed to allocate database connection");
+    }
+
+    std::shared_ptr<Connection> connection(new Connection(io_context, conn));
+    if (PQstatus(conn) != CONNECTION_OK) {
+        connection->Fail("Failed to connect to database");
+    }
+    connection->OnConnected();
+    return connection;
+}
+
+Task<void> Connection::CompleteConnect(Deadline deadline) {
+    Operation operation(*this, deadline);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        socket_fd_ = PQsocket(conn_);
+    }
+    if (PQstatus(conn_) == CONNECTION_BAD) {
+        Fail("Failed to connect to database");
+    }
+    AttachSocket();
+
+    // PQconnectStart之后按上一次轮询要求写入处理
+    auto status = PGRES_POLLING_WRITING;
+    for (;;) {
+        if (status == PGRES_POLLING_READING) {
+            auto readable = WaitReadable();
+            co_await readable;
+        } else {
+            auto writable = WaitWritable();
+            co_await writable;
+        }
+
+        // libpq可能关闭当前套接字改用新的 (例如sslmode=prefer被拒绝后不加密重连，或尝试下一个主机)，
+        // 在描述符仍属于这个连接时从io_context注销；持有锁，Interrupt不会关闭已被复用的描述符
+        DetachSocket();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            status = PQconnectPoll(conn_);
+            socket_fd_ = PQsocket(conn_);
+        }
+
+        if (status == PGRES_POLLING_OK) {
+            break;
+        }
+        if (status == PGRES_POLLING_FAILED) {
+            Fail("Failed to connect to database");
+        }
+        AttachSocket();
+    }
+
+    OnConnected();
+}
+
+void Connection::OnConnected() {
+    if (PQsetnonblocking(conn_, 1) != 0) {
+        Fail("Failed to switch database connection to non-blocking mode");
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        socket_fd_ = PQsocket(conn_);
+        cancel_.reset(PQgetCancel(conn_), PQfreeCancel);
+    }
+    AttachSocket();
+}
+
+void Connection::AttachSocket() {
+    DetachSocket();
+    int fd = PQsocket(conn_);
+    if (fd < 0) {
+        return;
+    }
+
+    sockaddr_storage address{};
+    socklen_t length = sizeof(address);
+    int family = ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) == 0 ? address.ss_family : AF_INET;
+
+    boost::system::error_code ec;
+    socket_.assign(boost::asio::generic::stream_protocol(family, 0), fd, ec);
+    if (ec) {
+        broken_ = true;
+        throw DbError("Failed to register database socket: " + ec.message());
+    }
+}
+
+void Connection::DetachSocket() {
+    if (socket_.is_open()) {
+        boost::system::error_code ec;
+        socket_.release(ec);
+    }
+}
+
+Task<void> Connection::WaitReadable() {
+    // 边沿触发的epoll上，asio的async_wait在没有等待者时收到的就绪通知会丢失：PQconsumeInput读完之后、
+    // 注册等待之前到达的数据不会再唤醒等待。MSG_PEEK接收先尝试一次，有数据时立即完成，不取走数据。
+    SocketAwaiter readable(io_context_, [this](auto handler) {
+        socket_.async_receive(boost::asio::buffer(&peek_byte_, 1), Socket::message_peek, std::move(handler));
+    });
+    // 错误 (包括对端关闭时的eof) 由随后的PQconsumeInput报告
+    co_await readable;
+}
+
+Task<void> Connection::WaitWritable() {
+    // 重新注册套接字：asio在第一次等待可写时才把EPOLLOUT加入epoll，并在加锁时检查当前状态，
+    // 之后的等待同样可能错过注册之前的通知
+    AttachSocket();
+    SocketAwaiter writable(io_context_, [this](auto handler) {
+        socket_.async_wait(Socket::wait_write, std::move(handler));
+    });
+    co_await writable;
+}
+
+Task<QueryResult> Connection::Query(std::string sql, QueryParams params, Deadline deadline) {
+    CheckUsable(deadline);
+    Operation operation(*this, deadline);
+
+    std::pmr::vector<const char*> values(memory::TrackedResource::ForTag(memory::MemoryTag::kDb));
+    params.CollectValues(values);
+    if (!PQsendQueryParams(conn_, sql.c_str(), static_cast<int>(values.size()), nullptr, values.data(),
+                           nullptr, nullptr, 0)) {
+        Fail("Failed to send query");
+    }
+
+    auto receive = ReceiveResult();
+    QueryResult result = co_await receive;
+    co_return result;
+}
+
+Task<QueryResult> Connection::Query(const PreparedStatement& statement, QueryParams params, Deadline deadline) {
+    CheckUsable(deadline);
+    Operation operation(*this, deadline);
+
+    if (!prepared_.contains(statement.GetName())) {
+        if (!PQsendPrepare(conn_, statement.GetName().c_str(), statement.GetSQL().c_str(), 0, nullptr)) {
+            Fail("Failed to prepare statement");
+        }
+        auto prepare = ReceiveResult();
+        co_await prepare;
+        prepared_.insert(statement.GetName());
+    }
+
+    std::pmr::vector<const char*> values(memory::TrackedResource::ForTag(memory::MemoryTag::kDb));
+    params.CollectValues(values);
+    if (!PQsendQueryPrepared(conn_, statement.GetName().c_str(), static_cast<int>(values.size()), values.data(),
+                             nullptr, nullptr, 0)) {
+        Fail("Failed to send prepared statement");
+    }
+
+    auto receive = ReceiveResult();
+    QueryResult result = co_await receive;
+    co_return result;
+}
+
+Task<QueryResult> Connection::ReceiveResult() {
+    // 参数较大时发送缓冲区可能一次写不完；单条语句在服务端读完之前不会产生大量输出，只需等待可写
+    for (;;) {
+        int pending = PQflush(conn_);
+        if (pending == 0) {
+            break;
+        }
+        if (pending < 0) {
+            Fail("Failed to send query");
+        }
+        auto writable = WaitWritable();
+        co_await writable;
+    }
+
+    // 读取直到PQgetResult返回空，只保留第一个结果
+    QueryResult result;
+    std::string error;
+    std::string sql_state;
+    for (;;) {
+        while (PQisBusy(conn_)) {
+            auto readable = WaitReadable();
+            co_await readable;
+            if (!PQconsumeInput(conn_)) {
+                Fail("Failed to receive query result");
+            }
+        }
+
+        PGresult* next = PQgetResult(conn_);
+        if (!next) {
+            break;
+        }
+
+        QueryResult current(next);
+        auto status = PQresultStatus(next);
+        if ((status == PGRES_FATAL_ERROR || status == PGRES_BAD_RESPONSE) && error.empty()) {
+            error = ErrorText(PQresultErrorMessage(next));
+            const char* state = PQresultErrorField(next, PG_DIAG_SQLSTATE);
+            sql_state = state ? state : "";
+        }
+        if (!result.Get()) {
+            result = std::move(current);
+        }
+    }
+
+    if (!error.empty()) {
+        throw DbError(error, sql_state);
+    }
+    co_return result;
+}
+
+void Connection::Interrupt(uint64_t operation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (operation != operation_ || interrupted_) {
+        return;
+    }
+    interrupted_ = true;
+
+    // 只关闭读写，描述符仍由libpq持有；等待中的接收随即以eof完成
+    if (socket_fd_ >= 0) {
+        ::shutdown(socket_fd_, SHUT_RDWR);
+    }
+
+    // 通知服务端停止执行语句，PQcancel会新建一个连接，放到阻塞任务池上
+    auto& runtime = Runtime::GetInstance();
+    if (cancel_ && runtime.IsRunning()) {
+        runtime.GetBlockingPool().Post([cancel = cancel_]() {
+            char error[256];
+            if (!PQcancel(cancel.get(), error, sizeof(error))) {
+                spdlog::warn("Failed to cancel database query: {}", error);
+            }
+        });
+    }
+}
+
+void Connection::Fail(const char* what) {
+    broken_ = true;
+    if (interrupted_) {
+        throw DeadlineExceeded(std::string("Deadline exceeded: ") + what);
+    }
+    throw DbError(std::string(what) + ": " + ErrorText(PQerrorMessage(conn_)));
+}
+
+void Connection::CheckUsable(const Deadline& deadline) const {
+    if (IsBroken()) {
+        throw DbError("Database connection is broken");
+    }
+    if (deadline.IsExpired()) {
+        throw DeadlineExceeded("Deadline exceeded before database query");
+    }
+}
+
+bool Connection::IsBroken() const {
+    return broken_ || interrupted_ || PQstatus(conn_) != CONNECTION_OK;
+}
+
+bool Connection::InTransaction() const {
+    auto status = PQtransactionStatus(conn_);
+    return status == PQTRANS_INTRANS || status == PQTRANS_INERROR;
+}
+
+} // namespace ai_backend::core::db
@@ -1,142 +1,388 @@
 #include "core/db/connection_pool.h"
+#include "core/db/transaction.h"
+#include "core/async/runtime.h"
+#include <algorithm>
+#include <optional>
 #include <spdlog/spdlog.h>
+#include <boost/asio/strand.hpp>
 
 namespace ai_backend::core::db {
 
 using namespace async;
 
+namespace {
+
+// 调用方协程所在的执行器，不在执行器上运行时 (如启动阶段) 使用运行时第0个io_context
+boost::asio::any_io_executor CallerExecutor() {
+    auto executor = CurrentExecutor();
+    return executor ? executor : Runtime::GetInstance().GetIoExecutor();
+}
+
+// 调用方协程所在的io_context，项目中的执行器都是io_context的executor或其上的strand
+boost::asio::io_context* CallerIoContext() {
+    using IoExecutor = boost::asio::io_context::executor_type;
+    auto executor = CurrentExecutor();
+    if (const auto* io_executor = executor.target<IoExecutor>()) {
+        return &io_executor->context();
+    }
+    if (const auto* strand = executor.target<boost::asio::strand<IoExecutor>>()) {
+        return &strand->get_inner_executor().context();
+    }
+    return nullptr;
+}
+
+} // namespace
+
+void PooledConnection::Release() {
+    if (pool_ && connection_) {
+        pool_->ReleaseConnection(std::move(connection_));
+    }
+    pool_ = nullptr;
+    connection_.reset();
+}
+
 ConnectionPool& ConnectionPool::GetInstance() {
     static ConnectionPool instance;
     return instance;
 }
 
-ConnectionPool::ConnectionPool() : shutdown_(false) {
+ConnectionPool::ConnectionPool()
+    : shutdown_(false) {
 }
 
 ConnectionPool::~ConnectionPool() {
     CloseAll();
 }
 
-bool ConnectionPool::Initialize(const std::string& connection_string, 
-                            size_t min_connections, 
+bool ConnectionPool::Initialize(const std::string& connection_string,
+                            size_t min_connections,
                             size_t max_connections) {
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (!idle_connections_.empty() || !active_connections_.empty()) {
+
+    if (!idle_connections_.empty() || active_connections_ > 0) {
         spdlog::warn("Connection pool already initialized");
         return false;
     }
-    
+
     connection_string_ = connection_string;
     min_connections_ = min_connections;
     max_connections_ = max_connections;
-    
-    // 初始化连接池
+
+    // 启动时同步建立最少数量的连接，连接串有误时尽早失败
     try {
-        InitializePool();
-        
-        // 启动监控线程
+        auto& runtime = Runtime::GetInstance();
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < min_connections_; ++i) {
+            idle_connections_.push_back({Connection::ConnectBlocking(runtime.NextIoContext(), connection_string_), now});
+        }
+        permits_.Release(max_connections_);
+
+        // 启动连接监控
         shutdown_ = false;
-        monitor_thread_ = std::thread(&ConnectionPool::MonitorConnections, this);
-        
+        ScheduleMonitor();
+
         spdlog::info("Database connection pool initialized with {} connections", min_connections_);
         return true;
     } catch (const std::exception& e) {
+        idle_connections_.clear();
         spdlog::error("Failed to initialize connection pool: {}", e.what());
         return false;
     }
 }
 
-void ConnectionPool::MonitorConnections() {
-    while (!shutdown_) {
-        std::this_thread::sleep_for(std::chrono::seconds(30)); // 每30秒检查一次
-        
-        try {
-            std::unique_lock<std::mutex> lock(mutex_);
-            
-            // 计算需要保留的最小空闲连接数
-            size_t min_idle = min_connections_;
-            
-            // 如果有挂起的请求，保留更多空闲连接
-            if (pending_requests_ > 0) {
-                min_idle = std::min(min_connections_ + pending_requests_.load(), max_connections_);
+void ConnectionPool::ScheduleMonitor() {
+    // 每30秒检查一次；检查中的查询是异步的，直接在运行时的io_context上运行
+    monitor_timer_.SetCallback([this]() {
+        if (shutdown_) {
+            return;
+        }
+        Spawn(Runtime::GetInstance().GetIoExecutor(), MonitorConnections());
+    });
+    TimerWheel::For(Runtime::GetInstance().GetIoContext()).Schedule(monitor_timer_, std::chrono::seconds(30));
+}
+
+Task<void> ConnectionPool::MonitorConnections() {
+    auto executor = Runtime::GetInstance().GetIoExecutor();
+
+    // 关闭闲置超时的连接，至少保留min_connections_个
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        size_t total = active_connections_ + idle_connections_.size();
+        for (auto it = idle_connections_.begin(); it != idle_connections_.end() && total > min_connections_; ) {
+            if (now - it->since >= idle_timeout_) {
+                it = idle_connections_.erase(it);
+                total--;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // 逐个检查空闲连接，检查期间占用一个许可；没有空余许可说明连接池正忙，不需要检查
+    size_t idle_count = GetStats().idle_connections;
+    for (size_t i = 0; i < idle_count && !shutdown_; ++i) {
+        if (!permits_.TryAcquire()) {
+            break;
+        }
+
+        std::optional<IdleConnection> idle;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!idle_connections_.empty()) {
+                idle = std::move(idle_connections_.front());
+                idle_connections_.pop_front();
             }
-            
-            // 移除过多的空闲连接
-            auto now = std::chrono::steady_clock::now();
-            
-            // 检查并关闭不活跃连接
-            for (auto it = idle_connections_.begin(); it != idle_connections_.end(); ) {
-                if (idle_connections_.size() <= min_idle) {
-                    break;
-                }
-                
-                // 测试连接是否仍然有效
-                bool is_valid = false;
-                try {
-                    is_valid = TestConnection(*(*it));
-                } catch (...) {
-                    is_valid = false;
-                }
-                
-                if (!is_valid) {
-                    it = idle_connections_.erase(it);
-                } else {
-                    ++it;
-                }
+        }
+        if (!idle) {
+            permits_.Release();
+            break;
+        }
+
+        bool healthy = false;
+        try {
+            auto check = idle->connection->Query("SELECT 1", {}, Deadline::After(executor, std::chrono::seconds(1)));
+            co_await check;
+            healthy = true;
+        } catch (const std::exception& e) {
+            spdlog::error("Connection test failed: {}", e.what());
+        }
+
+        // 放回队尾时保留原来的空闲时间，检查不算作使用
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (healthy && !shutdown_ && !idle->connection->IsBroken()) {
+                idle_connections_.push_back(std::move(*idle));
             }
-            
-            // 确保至少有最小数量的连接
-            while (idle_connections_.size() < min_idle) {
-                try {
-                    auto conn = CreateConnection();
-                    idle_connections_.push_back(conn);
-                } catch (const std::exception& e) {
-                    spdlog::error("Failed to create connection during monitoring: {}", e.what());
-                    break;
-                }
+        }
+        permits_.Release();
+    }
+
+    // 确保至少有最小数量的连接
+    while (!shutdown_) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (active_connections_ + idle_connections_.size() >= min_connections_) {
+                break;
             }
-            
-            // 记录连接池状态
-            spdlog::debug("Connection pool stats - Active: {}, Idle: {}, Pending: {}",
-                       active_connections_.size(), idle_connections_.size(), pending_requests_.load());
+        }
+        if (!permits_.TryAcquire()) {
+            break;
+        }
+
+        std::shared_ptr<Connection> connection;
+        try {
+            auto connect = CreateConnection(Deadline::After(executor, acquire_timeout_));
+            connection = co_await connect;
         } catch (const std::exception& e) {
-            spdlog::error("Error in connection pool monitoring: {}", e.what());
+            spdlog::error("Failed to create connection during monitoring: {}", e.what());
         }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (connection && !shutdown_) {
+                idle_connections_.push_back({std::move(connection), std::chrono::steady_clock::now()});
+            }
+        }
+        permits_.Release();
+        if (!connection) {
+            break;
+        }
+    }
+
+    // 记录连接池状态
+    auto stats = GetStats();
+    spdlog::debug("Connection pool stats - Active: {}, Idle: {}, Pending: {}",
+               stats.active_connections, stats.idle_connections, stats.pending_requests);
+
+    // 在持有锁时重新启动，与CloseAll的取消不会交错
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!shutdown_) {
+        TimerWheel::For(Runtime::GetInstance().GetIoContext()).Schedule(monitor_timer_, std::chrono::seconds(30));
     }
 }
 
-bool ConnectionPool::TestConnection(pqxx::connection& conn) {
-    try {
-        // 简单检查连接是否仍然有效
-        if (!conn.is_open()) {
-            return false;
-        }
-        
-        // 执行简单查询并设置超时
-        pqxx::work txn(conn);
-        txn.set_variable("statement_timeout", "1000"); // 1秒超时
-        txn.exec1("SELECT 1");
-        txn.commit();
-        
-        return true;
-    } catch (const std::exception& e) {
-        spdlog::error("Connection test failed: {}", e.what());
+void ConnectionPool::SetAcquireTimeout(std::chrono::milliseconds timeout) {
+    acquire_timeout_ = timeout;
+}
+
+Task<PooledConnection> ConnectionPool::Acquire(Deadline deadline) {
+    if (shutdown_) {
+        throw std::runtime_error("Connection pool is shut down");
+    }
+
+    if (!permits_.TryAcquire()) {
+        if (deadline.IsExpired()) {
+            throw DeadlineExceeded("Deadline exceeded before acquiring database connection");
+        }
+
+        // 调用方没有截止时间时使用默认等待时限，避免无限期排队
+        Deadline wait_deadline = deadline.IsSet()
+            ? deadline.Tighten(acquire_timeout_)
+            : Deadline::After(CallerExecutor(), acquire_timeout_);
+
+        pending_requests_++;
+        bool timed_out = false;
         try {
-            // 尝试重新连接
-            conn.disconnect();
-            conn.activate();
-            
-            // 再次测试
-            pqxx::work txn(conn);
-            txn.exec1("SELECT 1");
-            txn.commit();
-            
-            spdlog::info("Connection recovered after disconnect/activate");
-            return true;
+            co_await permits_.Acquire(std::move(wait_deadline));
+        } catch (const DeadlineExceeded&) {
+            timed_out = true;
+        }
+        pending_requests_--;
+
+        if (timed_out) {
+            throw DeadlineExceeded("Timed out waiting for database connection");
+        }
+    }
+
+    if (shutdown_) {
+        // 关闭后被唤醒的等待者归还许可，依次唤醒其余等待者
+        permits_.Release();
+        throw std::runtime_error("Connection pool is shut down");
+    }
+
+    auto connection = TakeIdleConnection();
+    if (!connection) {
+        // 新建连接同样受默认时限约束
+        Deadline connect_deadline = deadline.IsSet()
+            ? deadline.Tighten(acquire_timeout_)
+            : Deadline::After(CallerExecutor(), acquire_timeout_);
+
+        std::exception_ptr error;
+        try {
+            auto connect = CreateConnection(std::move(connect_deadline));
+            connection = co_await connect;
         } catch (...) {
-            return false;
+            error = std::current_exception();
         }
+
+        if (error) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                active_connections_--;
+            }
+            permits_.Release();
+            std::rethrow_exception(error);
+        }
+    }
+    co_return PooledConnection(this, std::move(connection));
+}
+
+Task<QueryResult> ConnectionPool::Query(std::string sql, QueryParams params, Deadline deadline) {
+    auto acquire = Acquire(deadline);
+    auto connection = co_await acquire;
+    auto query = connection->Query(std::move(sql), std::move(params), std::move(deadline));
+    QueryResult result = co_await query;
+    co_return result;
+}
+
+Task<QueryResult> ConnectionPool::Query(const PreparedStatement& statement, QueryParams params, Deadline deadline) {
+    auto acquire = Acquire(deadline);
+    auto connection = co_await acquire;
+    auto query = connection->Query(statement, std::move(params), std::move(deadline));
+    QueryResult result = co_await query;
+    co_return result;
+}
+
+Task<Transaction> ConnectionPool::BeginTransaction(Deadline deadline) {
+    auto acquire = Acquire(deadline);
+    auto connection = co_await acquire;
+    auto begin = connection->Query("BEGIN", {}, deadline);
+    co_await begin;
+    co_return Transaction(std::move(connection), std::move(deadline));
+}
+
+void ConnectionPool::ReleaseConnection(std::shared_ptr<Connection> connection) {
+    if (!connection) {
+        return;
     }
+
+    // 未提交的事务在连接所在的io_context上回滚，回滚完成前连接仍占用许可
+    if (!shutdown_ && !connection->IsBroken() && connection->InTransaction()) {
+        auto& io_context = connection->GetIoContext();
+        Spawn(io_context.get_executor(), RollbackAndReturn(std::move(connection)));
+        return;
+    }
+
+    bool reuse = !connection->IsBroken();
+    ReturnConnection(std::move(connection), reuse);
 }
-}
\ No newline at end of file
+
+Task<void> ConnectionPool::RollbackAndReturn(std::shared_ptr<Connection> connection) {
+    bool rolled_back = false;
+    try {
+        auto deadline = Deadline::After(connection->GetIoContext().get_executor(), acquire_timeout_);
+        auto rollback = connection->Query("ROLLBACK", {}, std::move(deadline));
+        co_await rollback;
+        rolled_back = !connection->InTransaction();
+    } catch (const std::exception& e) {
+        spdlog::warn("Failed to roll back abandoned transaction: {}", e.what());
+    }
+    bool reuse = rolled_back && !connection->IsBroken();
+    ReturnConnection(std::move(connection), reuse);
+}
+
+void ConnectionPool::ReturnConnection(std::shared_ptr<Connection> connection, bool reuse) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_connections_--;
+
+        // 已断开的连接直接丢弃，下一个取得许可的请求会新建连接
+        if (reuse && !shutdown_) {
+            idle_connections_.push_back({std::move(connection), std::chrono::steady_clock::now()});
+        }
+    }
+
+    // 许可直接交给最早的异步等待者，等待者回到各自挂起时所在的执行器
+    permits_.Release();
+}
+
+void ConnectionPool::CloseAll() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+        idle_connections_.clear();
+    }
+
+    TimerWheel::For(Runtime::GetInstance().GetIoContext()).Cancel(monitor_timer_);
+
+    // 唤醒第一个异步等待者，它发现连接池已关闭后归还许可
+    permits_.Release();
+}
+
+ConnectionPool::PoolStats ConnectionPool::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {active_connections_, idle_connections_.size(), pending_requests_.load()};
+}
+
+Task<std::shared_ptr<Connection>> ConnectionPool::CreateConnection(Deadline deadline) {
+    // 建在调用方所在的io_context上，之后的查询完成时不需要跨线程投递
+    auto* io_context = CallerIoContext();
+    if (!io_context) {
+        io_context = &Runtime::GetInstance().NextIoContext();
+    }
+    auto connect = Connection::Connect(*io_context, connection_string_, std::move(deadline));
+    auto connection = co_await connect;
+    co_return connection;
+}
+
+std::shared_ptr<Connection> ConnectionPool::TakeIdleConnection() {
+    auto* preferred = CallerIoContext();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    active_connections_++;
+    if (idle_connections_.empty()) {
+        return nullptr;
+    }
+
+    // 优先取最近归还的、与调用方在同一io_context上的连接，没有时取最近归还的连接
+    auto it = std::find_if(idle_connections_.rbegin(), idle_connections_.rend(), [preferred](const auto& idle) {
+        return &idle.connection->GetIoContext() == preferred;
+    });
+    auto position = it != idle_connections_.rend() ? std::prev(it.base()) : std::prev(idle_connections_.end());
+    auto connection = std::move(position->connection);
+    idle_connections_.erase(position);
+    return connection;
+}
+
+} // namespace ai_backend::core::db
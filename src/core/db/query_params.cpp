@@ -0,0 +1,47 @@
+#include "core/db/query_params.h"
+#include "core/memory/memory_tracker.h"
+
+namespace ai_backend::core::db {
+
+QueryParams::QueryParams()
+    : storage_(memory::TrackedResource::ForTag(memory::MemoryTag::kDb)),
+      offsets_(memory::TrackedResource::ForTag(memory::MemoryTag::kDb)) {
+}
+
+QueryParams::QueryParams(std::initializer_list<QueryParam> params) : QueryParams() {
+    size_t bytes = 0;
+    for (const auto& param : params) {
+        bytes += param.GetText().size() + 1;
+    }
+    storage_.reserve(bytes);
+    offsets_.reserve(params.size());
+    for (const auto& param : params) {
+        Add(param);
+    }
+}
+
+void QueryParams::Add(const QueryParam& param) {
+    if (param.IsNull()) {
+        offsets_.push_back(kNull);
+        return;
+    }
+    offsets_.push_back(storage_.size());
+    auto text = param.GetText();
+    storage_.append(text.data(), text.size());
+    storage_.push_back('\0');
+}
+
+const char* QueryParams::GetValue(size_t index) const {
+    size_t offset = offsets_[index];
+    return offset == kNull ? nullptr : storage_.data() + offset;
+}
+
+void QueryParams::CollectValues(std::pmr::vector<const char*>& values) const {
+    values.clear();
+    values.reserve(offsets_.size());
+    for (size_t i = 0; i < offsets_.size(); ++i) {
+        values.push_back(GetValue(i));
+    }
+}
+
+} // namespace ai_backend::core::db
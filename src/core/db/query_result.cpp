@@ -0,0 +1,59 @@
+#include "core/db/query_result.h"
+#include "core/memory/memory_tracker.h"
+#include <cstdlib>
+
+namespace ai_backend::core::db {
+
+namespace detail {
+
+void ThrowConversionError(std::string_view text, const char* type) {
+    throw DbError("Cannot convert '" + std::string(text.substr(0, 64)) + "' to " + type);
+}
+
+} // namespace detail
+
+QueryResult::QueryResult(PGresult* result) : result_(result) {
+    if (result_) {
+        memory_bytes_ = PQresultMemorySize(result_);
+        memory::MemoryTracker::GetInstance().RecordAllocation(memory::MemoryTag::kDb, result_, memory_bytes_);
+    }
+}
+
+QueryResult::~QueryResult() {
+    Clear();
+}
+
+QueryResult::QueryResult(QueryResult&& other) noexcept
+    : result_(std::exchange(other.result_, nullptr)),
+      memory_bytes_(std::exchange(other.memory_bytes_, 0)) {
+}
+
+QueryResult& QueryResult::operator=(QueryResult&& other) noexcept {
+    if (this != &other) {
+        Clear();
+        result_ = std::exchange(other.result_, nullptr);
+        memory_bytes_ = std::exchange(other.memory_bytes_, 0);
+    }
+    return *this;
+}
+
+std::string_view QueryResult::ColumnName(size_t column) const {
+    const char* name = result_ ? PQfname(result_, static_cast<int>(column)) : nullptr;
+    return name ? std::string_view(name) : std::string_view();
+}
+
+size_t QueryResult::AffectedRows() const {
+    const char* rows = result_ ? PQcmdTuples(result_) : "";
+    return static_cast<size_t>(std::strtoull(rows, nullptr, 10));
+}
+
+void QueryResult::Clear() noexcept {
+    if (result_) {
+        memory::MemoryTracker::GetInstance().RecordDeallocation(memory::MemoryTag::kDb, result_, memory_bytes_);
+        PQclear(result_);
+        result_ = nullptr;
+        memory_bytes_ = 0;
+    }
+}
+
+} // namespace ai_backend::core::db
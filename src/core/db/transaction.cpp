@@ -1,60 +1,46 @@
 #include "core/db/transaction.h"
-#include <spdlog/spdlog.h>
+#include <stdexcept>
 
 namespace ai_backend::core::db {
 
-Transaction::Transaction()
-    : is_active_(false) {
-    conn_ = ConnectionPool::GetInstance().GetConnection();
+using namespace async;
+
+Task<QueryResult> Transaction::Query(std::string sql, QueryParams params) {
+    CheckActive();
+    auto query = connection_->Query(std::move(sql), std::move(params), deadline_);
+    QueryResult result = co_await query;
+    co_return result;
 }
 
-Transaction::~Transaction() {
-    if (is_active_) {
-        try {
-            Rollback();
-        } catch (const std::exception& e) {
-            spdlog::error("Error rolling back transaction in destructor: {}", e.what());
-        }
-    }
-    
-    ConnectionPool::GetInstance().ReleaseConnection(conn_);
+Task<QueryResult> Transaction::Query(const PreparedStatement& statement, QueryParams params) {
+    CheckActive();
+    auto query = connection_->Query(statement, std::move(params), deadline_);
+    QueryResult result = co_await query;
+    co_return result;
 }
 
-void Transaction::Begin() {
-    if (is_active_) {
-        throw std::runtime_error("Transaction already active");
-    }
-    
-    txn_ = std::make_unique<pqxx::work>(*conn_);
-    is_active_ = true;
+Task<void> Transaction::Commit() {
+    auto finish = Finish("COMMIT");
+    co_await finish;
 }
 
-void Transaction::Commit() {
-    if (!is_active_) {
-        throw std::runtime_error("No active transaction to commit");
-    }
-    
-    txn_->commit();
-    txn_.reset();
-    is_active_ = false;
+Task<void> Transaction::Rollback() {
+    auto finish = Finish("ROLLBACK");
+    co_await finish;
 }
 
-void Transaction::Rollback() {
-    if (!is_active_) {
-        throw std::runtime_error("No active transaction to rollback");
-    }
-    
-    txn_->abort();
-    txn_.reset();
-    is_active_ = false;
+Task<void> Transaction::Finish(const char* sql) {
+    CheckActive();
+    // 失败时连接保留在事务中，随Transaction析构交给连接池回滚
+    auto query = connection_->Query(sql, {}, deadline_);
+    co_await query;
+    connection_.Release();
 }
 
-pqxx::work& Transaction::GetTxn() {
-    if (!is_active_) {
+void Transaction::CheckActive() const {
+    if (!connection_) {
         throw std::runtime_error("No active transaction");
     }
-    
-    return *txn_;
 }
 
-} // namespace ai_backend::core::db
\ No newline at end of file
+} // namespace ai_backend::core::db
@@ -0,0 +1,251 @@
+#include "core/http/admission_controller.h"
+
+namespace ai_backend::core::http {
+
+using namespace async;
+
+namespace detail {
+
+RouteClass::RouteClass(RouteClassOptions route_options, const AdmissionOptions& admission)
+    : options(std::move(route_options)),
+      codel(admission.target, admission.interval) {
+    if (options.max_in_flight > 0) {
+        // 等待者在归还名额的线程上恢复，Admit随后切回请求所在的executor
+        permits = std::make_unique<AsyncSemaphore>(options.max_in_flight);
+    }
+}
+
+} // namespace detail
+
+AdmissionTicket::AdmissionTicket(std::shared_ptr<detail::RouteClass> route_class, bool has_permit)
+    : route_class_(std::move(route_class)), has_permit_(has_permit) {
+    route_class_->in_flight.fetch_add(1, std::memory_order_relaxed);
+}
+
+AdmissionTicket::~AdmissionTicket() {
+    Release();
+}
+
+AdmissionTicket::AdmissionTicket(AdmissionTicket&& other) noexcept
+    : route_class_(std::move(other.route_class_)), has_permit_(other.has_permit_) {
+    other.has_permit_ = false;
+}
+
+AdmissionTicket& AdmissionTicket::operator=(AdmissionTicket&& other) noexcept {
+    if (this != &other) {
+        Release();
+        route_class_ = std::move(other.route_class_);
+        has_permit_ = other.has_permit_;
+        other.has_permit_ = false;
+    }
+    return *this;
+}
+
+std::string_view AdmissionTicket::GetRouteClass() const {
+    return route_class_ ? std::string_view(route_class_->options.name) : std::string_view();
+}
+
+void AdmissionTicket::Release() {
+    if (!route_class_) {
+        return;
+    }
+    route_class_->in_flight.fetch_sub(1, std::memory_order_relaxed);
+    if (has_permit_) {
+        route_class_->permits->Release();
+        has_permit_ = false;
+    }
+    route_class_.reset();
+}
+
+ConnectionTicket::~ConnectionTicket() {
+    if (counter_) {
+        counter_->fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+ConnectionTicket& ConnectionTicket::operator=(ConnectionTicket&& other) noexcept {
+    if (this != &other) {
+        if (counter_) {
+            counter_->fetch_sub(1, std::memory_order_relaxed);
+        }
+        counter_ = std::move(other.counter_);
+    }
+    return *this;
+}
+
+AdmissionController::AdmissionController(AdmissionOptions options)
+    : connections_(std::make_shared<std::atomic<size_t>>(0)) {
+    Configure(std::move(options));
+}
+
+AdmissionController& AdmissionController::GetInstance() {
+    static AdmissionController instance;
+    return instance;
+}
+
+void AdmissionController::Configure(AdmissionOptions options) {
+    std::vector<std::shared_ptr<detail::RouteClass>> classes;
+    for (const auto& route_class : options.classes) {
+        classes.push_back(std::make_shared<detail::RouteClass>(route_class, options));
+    }
+    classes.push_back(std::make_shared<detail::RouteClass>(options.default_class, options));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = std::move(options);
+    classes_ = std::move(classes);
+}
+
+ConnectionTicket AdmissionController::AdmitConnection() {
+    size_t max_connections;
+    bool enabled;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        max_connections = options_.max_connections;
+        enabled = options_.enabled;
+    }
+
+    size_t active = connections_->fetch_add(1, std::memory_order_relaxed);
+    if (enabled && max_connections > 0 && active >= max_connections) {
+        connections_->fetch_sub(1, std::memory_order_relaxed);
+        rejected_connections_.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+    return ConnectionTicket(connections_);
+}
+
+Task<AdmissionTicket> AdmissionController::Admit(std::string_view path, Clock::time_point received_at,
+                                                 boost::asio::any_io_executor executor) {
+    auto route_class = Classify(path);
+
+    bool enabled;
+    std::chrono::milliseconds max_queue_time;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        enabled = options_.enabled;
+        max_queue_time = options_.max_queue_time;
+    }
+
+    if (!enabled) {
+        route_class->admitted.fetch_add(1, std::memory_order_relaxed);
+        co_return AdmissionTicket(std::move(route_class), false);
+    }
+
+    bool has_permit = false;
+    if (route_class->permits) {
+        if (!route_class->permits->TryAcquire()) {
+            size_t max_queue = route_class->options.max_queue;
+            if (max_queue > 0 && route_class->queued.load(std::memory_order_relaxed) >= max_queue) {
+                route_class->shed_queue_full.fetch_add(1, std::memory_order_relaxed);
+                co_return AdmissionTicket();
+            }
+
+            route_class->queued.fetch_add(1, std::memory_order_relaxed);
+            bool acquired = true;
+            try {
+                auto acquire = route_class->permits->Acquire(
+                    Deadline::After(executor, route_class->codel.GetQueueTimeout(max_queue_time)));
+                co_await acquire;
+            } catch (const DeadlineExceeded&) {
+                acquired = false;
+            }
+            route_class->queued.fetch_sub(1, std::memory_order_relaxed);
+
+            // 名额由其他请求的线程交出，截止时间由时间轮触发，都需要回到请求所在的executor
+            ResumeOn resume(executor);
+            co_await resume;
+
+            if (!acquired) {
+                route_class->shed_queue_timeout.fetch_add(1, std::memory_order_relaxed);
+                co_return AdmissionTicket();
+            }
+        }
+        has_permit = true;
+    }
+
+    // 先持有凭证，拒绝时由析构归还名额
+    AdmissionTicket ticket(route_class, has_permit);
+
+    auto sojourn = Clock::now() - received_at;
+    route_class->sojourn.Record(sojourn);
+    if (route_class->codel.OnDequeue(sojourn)) {
+        route_class->shed_sojourn.fetch_add(1, std::memory_order_relaxed);
+        co_return AdmissionTicket();
+    }
+
+    route_class->admitted.fetch_add(1, std::memory_order_relaxed);
+    co_return std::move(ticket);
+}
+
+std::chrono::seconds AdmissionController::GetRetryAfter() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_.retry_after;
+}
+
+size_t AdmissionController::GetActiveConnections() const {
+    return connections_->load(std::memory_order_relaxed);
+}
+
+AdmissionController::Stats AdmissionController::GetStats() const {
+    std::vector<std::shared_ptr<detail::RouteClass>> classes;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        classes = classes_;
+    }
+
+    Stats stats;
+    stats.active_connections = GetActiveConnections();
+    stats.rejected_connections = rejected_connections_.load(std::memory_order_relaxed);
+    for (const auto& route_class : classes) {
+        stats.classes.push_back({
+            route_class->options.name,
+            route_class->options.max_in_flight,
+            route_class->options.max_queue,
+            route_class->in_flight.load(std::memory_order_relaxed),
+            route_class->queued.load(std::memory_order_relaxed),
+            route_class->codel.IsOverloaded(),
+            route_class->admitted.load(std::memory_order_relaxed),
+            route_class->shed_queue_full.load(std::memory_order_relaxed),
+            route_class->shed_queue_timeout.load(std::memory_order_relaxed),
+            route_class->shed_sojourn.load(std::memory_order_relaxed),
+            route_class->sojourn.GetSnapshot()
+        });
+    }
+    return stats;
+}
+
+bool AdmissionController::MatchPattern(std::string_view pattern, std::string_view path) {
+    auto next_segment = [](std::string_view& text) {
+        while (!text.empty() && text.front() == '/') {
+            text.remove_prefix(1);
+        }
+        auto end = text.find('/');
+        auto segment = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end);
+        return segment;
+    };
+
+    while (true) {
+        auto expected = next_segment(pattern);
+        if (expected.empty()) {
+            return true;
+        }
+        auto actual = next_segment(path);
+        if (actual.empty() || (expected != "*" && expected != actual)) {
+            return false;
+        }
+    }
+}
+
+std::shared_ptr<detail::RouteClass> AdmissionController::Classify(std::string_view path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i + 1 < classes_.size(); ++i) {
+        for (const auto& pattern : classes_[i]->options.patterns) {
+            if (MatchPattern(pattern, path)) {
+                return classes_[i];
+            }
+        }
+    }
+    return classes_.back();
+}
+
+} // namespace ai_backend::core::http
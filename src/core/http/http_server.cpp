@@ -1,21 +1,29 @@
 #include "core/http/http_server.h"
 #include <spdlog/spdlog.h>
+#include <charconv>
+#include <mutex>
 
 namespace ai_backend::core::http {
 
 using namespace async;
 
-HttpServer::HttpServer(uint16_t port, size_t thread_count)
+namespace {
+
+// 等待下一个请求 (包括keep-alive空闲期间) 的超时
+constexpr std::chrono::seconds kReadTimeout{30};
+
+#ifdef SO_REUSEPORT
+using reuse_port_option = net::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
+} // namespace
+
+HttpServer::HttpServer(uint16_t port, async::Runtime& runtime, AdmissionController& admission)
     : port_(port),
-      thread_count_(thread_count),
-      running_(false),
-      active_connections_(0),
-      io_context_(),
-      acceptor_(io_context_) {
-    
-    if (thread_count_ == 0) {
-        thread_count_ = std::thread::hardware_concurrency();
-    }
+      runtime_(runtime),
+      admission_(admission),
+      max_request_timeout_(std::chrono::minutes(10)),
+      running_(false) {
 }
 
 HttpServer::~HttpServer() {
@@ -28,41 +36,53 @@ void HttpServer::Start() {
     }
     
     try {
-        // 创建工作守卫，防止io_context在没有任务时退出
-        work_guard_.emplace(net::make_work_guard(io_context_));
-        
-        // 配置接受器
-        tcp::endpoint endpoint(tcp::v4(), port_);
-        acceptor_.open(endpoint.protocol());
-        acceptor_.set_option(net::socket_base::reuse_address(true));
-        acceptor_.bind(endpoint);
-        acceptor_.listen(net::socket_base::max_listen_connections);
-        
-        // 启动工作线程
-        worker_threads_.reserve(thread_count_);
-        for (size_t i = 0; i < thread_count_; ++i) {
-            worker_threads_.emplace_back([this]() {
-                try {
-                    io_context_.run();
-                } catch (const std::exception& e) {
-                    spdlog::error("Exception in HTTP server worker thread: {}", e.what());
-                }
-            });
+        // 先为所有io_context绑定端口，任何一个失败都不开始接受连接
+        acceptors_.clear();
+        size_t count = runtime_.GetIoContextCount();
+#ifndef SO_REUSEPORT
+        if (count > 1) {
+            spdlog::warn("SO_REUSEPORT is not supported on this platform, using a single acceptor");
+            count = 1;
+        }
+#endif
+        for (size_t i = 0; i < count; ++i) {
+            auto acceptor = std::make_unique<tcp::acceptor>(runtime_.GetIoContext(i));
+            OpenAcceptor(*acceptor, count > 1);
+            acceptors_.push_back(std::move(acceptor));
         }
         
         running_ = true;
         
-        // 开始接受连接
-        AcceptConnection();
+        for (auto& acceptor : acceptors_) {
+            AcceptConnection(*acceptor);
+        }
         
-        spdlog::info("HTTP server started on port {}", port_);
+        spdlog::info("HTTP server started on port {} ({} acceptors)", port_, acceptors_.size());
     } catch (const std::exception& e) {
         spdlog::error("Failed to start HTTP server: {}", e.what());
-        Stop();
+        acceptors_.clear();
+        running_ = false;
         throw;
     }
 }
 
+void HttpServer::OpenAcceptor(tcp::acceptor& acceptor, bool reuse_port) {
+    tcp::endpoint endpoint(tcp::v4(), port_);
+    acceptor.open(endpoint.protocol());
+    acceptor.set_option(net::socket_base::reuse_address(true));
+    
+#ifdef SO_REUSEPORT
+    if (reuse_port) {
+        acceptor.set_option(reuse_port_option(true));
+    }
+#else
+    boost::ignore_unused(reuse_port);
+#endif
+    
+    acceptor.bind(endpoint);
+    acceptor.listen(net::socket_base::max_listen_connections);
+}
+
 void HttpServer::Stop() {
     if (!running_) {
         return;
@@ -70,27 +90,12 @@ void HttpServer::Stop() {
     
     running_ = false;
     
-    // 关闭接受器
+    // 关闭接受器，IO线程属于Runtime，已建立的会话随Runtime停止
     beast::error_code ec;
-    acceptor_.close(ec);
-    
-    // 移除工作守卫，允许io_context退出
-    if (work_guard_) {
-        work_guard_.reset();
-    }
-    
-    // 停止io_context
-    io_context_.stop();
-    
-    // 等待所有工作线程结束
-    for (auto& thread : worker_threads_) {
-        if (thread.joinable()) {
-            thread.join();
-        }
+    for (auto& acceptor : acceptors_) {
+        acceptor->close(ec);
     }
     
-    worker_threads_.clear();
-    
     spdlog::info("HTTP server stopped");
 }
 
@@ -99,7 +104,7 @@ void HttpServer::SetRouter(std::shared_ptr<Router> router) {
 }
 
 size_t HttpServer::GetActiveConnections() const {
-    return active_connections_;
+    return admission_.GetActiveConnections();
 }
 
 uint16_t HttpServer::GetPort() const {
@@ -110,114 +115,184 @@ bool HttpServer::IsRunning() const {
     return running_;
 }
 
-void HttpServer::AcceptConnection() {
+void HttpServer::SetMaxRequestTimeout(std::chrono::milliseconds timeout) {
+    max_request_timeout_ = timeout;
+}
+
+void HttpServer::AcceptConnection(tcp::acceptor& acceptor) {
     // 确保服务器正在运行
     if (!running_) {
         return;
     }
     
-    acceptor_.async_accept(
-        [self = shared_from_this()](beast::error_code ec, tcp::socket socket) {
+    // 新socket绑定到io_context上的strand，分片模式下会话不会离开接受它的线程；
+    // 流式写入器可从其他线程投递写操作，strand保证会话内的处理函数串行执行
+    auto& io_context = acceptors_.size() == runtime_.GetIoContextCount()
+        ? static_cast<net::io_context&>(acceptor.get_executor().context())
+        : runtime_.NextIoContext();
+    acceptor.async_accept(
+        net::make_strand(io_context),
+        [self = shared_from_this(), &acceptor](beast::error_code ec, tcp::socket socket) {
             if (ec) {
                 if (ec != net::error::operation_aborted && self->running_) {
                     spdlog::error("Accept error: {}", ec.message());
                 }
-            } else {
-                self->active_connections_++;
-                
+            } else if (auto connection = self->admission_.AdmitConnection()) {
                 // 创建新会话
-                auto session = std::make_shared<HttpSession>(std::move(socket), self->router_);
+                auto session = std::make_shared<HttpSession>(std::move(socket), self->router_,
+                                                             self->max_request_timeout_,
+                                                             self->admission_, std::move(connection));
                 session->Start();
+            } else {
+                self->RejectConnection(std::move(socket));
             }
             
             // 继续接受下一个连接
             if (self->running_) {
-                self->AcceptConnection();
+                self->AcceptConnection(acceptor);
             }
         });
 }
 
+void HttpServer::RejectConnection(tcp::socket socket) {
+    // 不读取请求，直接写出固定的503响应后关闭，尽量少占用IO线程
+    struct Rejection {
+        tcp::socket socket;
+        std::string response;
+    };
+    auto rejection = std::make_shared<Rejection>(Rejection{
+        std::move(socket),
+        "HTTP/1.1 503 Service Unavailable\r\n"
+        "Retry-After: " + std::to_string(admission_.GetRetryAfter().count()) + "\r\n"
+        "Content-Length: 0\r\n"
+        "Connection: close\r\n\r\n"
+    });
+    
+    spdlog::debug("Connection limit reached, rejecting connection");
+    net::async_write(rejection->socket, net::buffer(rejection->response),
+        [rejection](beast::error_code, std::size_t) {
+            beast::error_code ec;
+            rejection->socket.shutdown(tcp::socket::shutdown_send, ec);
+        });
+}
+
 // HttpSession实现
-HttpServer::HttpSession::HttpSession(tcp::socket&& socket, std::shared_ptr<Router> router)
+HttpServer::HttpSession::HttpSession(tcp::socket&& socket, std::shared_ptr<Router> router,
+                                     std::chrono::milliseconds max_request_timeout,
+                                     AdmissionController& admission, ConnectionTicket connection)
     : socket_(std::move(socket)),
+      buffer_(memory::TrackedResource::ForTag(memory::MemoryTag::kHttp)),
       router_(router),
-      close_connection_(false) {
+      max_request_timeout_(max_request_timeout),
+      close_connection_(false),
+      admission_(admission),
+      connection_(std::move(connection)),
+      arena_(memory::RequestArena::kDefaultInitialSize, memory::TrackedResource::ForTag(memory::MemoryTag::kHttp)),
+      wheel_(async::TimerWheel::For(socket_.get_executor())) {
 }
 
 void HttpServer::HttpSession::Start() {
+    // 回调在时间轮的驱动线程上运行，投递回会话的strand关闭连接
+    idle_timer_.SetCallback([weak = weak_from_this()]() {
+        if (auto self = weak.lock()) {
+            net::post(self->socket_.get_executor(), [self]() { self->OnIdleTimeout(); });
+        }
+    });
     ReadRequest();
 }
 
 void HttpServer::HttpSession::ReadRequest() {
     auto self = shared_from_this();
     
-    // 设置请求解析器超时
-    socket_.expires_after(std::chrono::seconds(30));
+    // 设置请求读取超时
+    wheel_.Schedule(idle_timer_, kReadTimeout);
     
     // 异步读取请求
     http::async_read(socket_, buffer_, request_,
         [self](beast::error_code ec, std::size_t bytes_transferred) {
             boost::ignore_unused(bytes_transferred);
+            self->wheel_.Cancel(self->idle_timer_);
             
             if (ec) {
                 return self->HandleError(ec, "read");
             }
             
-            // 处理请求
-            self->ProcessRequest();
+            // 排队时间从这里算起，包括处理协程在io_context中等待执行的时间
+            self->received_at_ = std::chrono::steady_clock::now();
+            
+            // 在会话的strand上运行请求处理协程
+            async::Spawn(self->socket_.get_executor(), self->ProcessRequest(self));
         });
 }
 
-Task<void> HttpServer::HttpSession::ProcessRequest() {
+Task<void> HttpServer::HttpSession::ProcessRequest([[maybe_unused]] std::shared_ptr<HttpSession> self) {
+    // 协程分离运行且惰性启动，会话引用作为参数保存在协程帧中，直到响应发出
+    
+    // 请求级arena，先于请求和响应声明，协程结束时最后析构并回收
+    auto arena = arena_.Acquire();
+    
     try {
-        // 转换成我们自己的Request对象
-        Request req;
-        req.method = std::string(request_.method_string());
-        req.target = std::string(request_.target());
+        // 构造请求视图，方法、目标、头部和请求体都直接引用request_的存储，
+        // request_在响应发送完成后才会被下一次读取复用
+        Request req(arena.Get());
+        auto method = request_.method_string();
+        auto target = request_.target();
+        req.method = std::string_view(method.data(), method.size());
+        req.target = std::string_view(target.data(), target.size());
         req.version = request_.version();
-        
-        // 复制头部
-        for (auto const& field : request_) {
-            req.headers.emplace(
-                std::string(field.name_string()),
-                std::string(field.value())
-            );
-        }
-        
-        // 复制body
         req.body = request_.body();
+        req.SetHeaderSource(&request_.base());
         
-        // 解析查询参数
-        if (req.target.find('?') != std::string::npos) {
-            auto pos = req.target.find('?');
-            std::string query_string = req.target.substr(pos + 1);
-            req.path = req.target.substr(0, pos);
-            
-            // 简单解析查询参数
-            std::istringstream stream(query_string);
-            std::string pair;
-            while (std::getline(stream, pair, '&')) {
-                auto eq_pos = pair.find('=');
-                if (eq_pos != std::string::npos) {
-                    std::string key = pair.substr(0, eq_pos);
-                    std::string value = pair.substr(eq_pos + 1);
-                    req.query_params[key] = value;
-                } else {
-                    req.query_params[pair] = "";
-                }
+        // 绝对形式的目标 (http://host/path?query) 去掉协议和主机部分，主机后可以直接跟查询字符串
+        std::string_view path = req.target;
+        if (!path.empty() && path[0] != '/') {
+            auto scheme_pos = path.find("://");
+            if (scheme_pos != std::string_view::npos) {
+                auto path_pos = path.find_first_of("/?", scheme_pos + 3);
+                path = path_pos == std::string_view::npos ? std::string_view{} : path.substr(path_pos);
             }
-        } else {
-            req.path = req.target;
+        }
+        
+        // 分离路径和查询参数
+        auto query_pos = path.find('?');
+        if (query_pos != std::string_view::npos) {
+            req.ParseQueryString(path.substr(query_pos + 1));
+            path = path.substr(0, query_pos);
         }
         
         // 确保路径始终以/开头
-        if (req.path.empty() || req.path[0] != '/') {
-            req.path = "/" + req.path;
+        req.path = (path.empty() || path[0] != '/') ? std::string_view("/") : path;
+        
+        // 客户端地址
+        beast::error_code endpoint_ec;
+        auto endpoint = socket_.remote_endpoint(endpoint_ec);
+        if (!endpoint_ec) {
+            req.client_ip = endpoint.address().to_string();
+        }
+        
+        // 截止时间：客户端可通过X-Request-Timeout (毫秒) 缩短，不超过服务器上限
+        auto timeout = max_request_timeout_;
+        if (auto it = request_.find("X-Request-Timeout"); it != request_.end()) {
+            auto value = it->value();
+            long long timeout_ms = 0;
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), timeout_ms);
+            if (ec == std::errc() && end == value.data() + value.size() && timeout_ms > 0) {
+                timeout = std::min(timeout, std::chrono::milliseconds(timeout_ms));
+            }
         }
+        req.deadline = async::Deadline::After(socket_.get_executor(), timeout);
         
         // 记录请求
         spdlog::info("HTTP {} {}", req.method, req.path);
         
+        // 准入控制：排队过久或超过并发上限的请求直接返回503
+        auto ticket = co_await admission_.Admit(req.path, received_at_, socket_.get_executor());
+        if (!ticket) {
+            spdlog::debug("Request shed: {} {}", req.method, req.path);
+            WriteResponse(Response::ServiceUnavailable(admission_.GetRetryAfter()));
+            co_return;
+        }
+        
         Response resp;
         
         // 通过路由器处理请求
@@ -231,7 +306,14 @@ Task<void> HttpServer::HttpSession::ProcessRequest() {
         }
         
         // 发送响应
-        WriteResponse(resp);
+        if (resp.stream_handler) {
+            WriteStreamingResponse(std::move(resp), std::move(req.deadline), std::move(ticket));
+        } else {
+            WriteResponse(std::move(resp));
+        }
+    } catch (const async::DeadlineExceeded& e) {
+        spdlog::warn("Request deadline exceeded: {}", e.what());
+        WriteResponse(Response::GatewayTimeout());
     } catch (const std::exception& e) {
         spdlog::error("Exception in ProcessRequest: {}", e.what());
         
@@ -240,38 +322,282 @@ Task<void> HttpServer::HttpSession::ProcessRequest() {
         error_resp.status_code = 500;
         error_resp.body = "{\"error\":\"Internal Server Error\"}";
         error_resp.headers["Content-Type"] = "application/json";
-        WriteResponse(error_resp);
+        WriteResponse(std::move(error_resp));
     }
 }
 
-void HttpServer::HttpSession::WriteResponse(const Response& resp) {
-    auto self = shared_from_this();
+// 流式响应写入器
+// Write/End可以从任意线程调用，实际写操作都投递到会话的strand上串行执行。
+// 空闲时第一个数据块立即发送，写入进行中到达的数据块接到同一个BufferChain上，
+// 作为一个HTTP chunk分散/聚集写出，不再拼接成连续的字符串。
+class HttpServer::HttpSession::SessionStreamWriter
+    : public StreamWriter,
+      public std::enable_shared_from_this<SessionStreamWriter> {
+public:
+    // 高水位以上生产者应等待，降到低水位以下时唤醒
+    static constexpr size_t kHighWatermark = 64 * 1024;
+    static constexpr size_t kLowWatermark = 16 * 1024;
     
-    // 转换到Beast的响应格式
-    response_.version(request_.version());
-    response_.result(resp.status_code);
-    response_.set(http::field::server, "AiBackend");
+    SessionStreamWriter(std::shared_ptr<HttpSession> session, bool should_close)
+        : session_(std::move(session)),
+          executor_(session_->socket_.get_executor()),
+          should_close_(should_close) {
+    }
     
-    // 设置内容长度
-    response_.set(http::field::content_length, std::to_string(resp.body.size()));
+    void Write(const std::string& data) override {
+        if (data.empty() || !open_ || end_requested_) {
+            return;
+        }
+        
+        // 直接复制到待发送链尾部的池化段中，多个小数据块共用同一个段
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queue_.Append(data);
+        pending_bytes_ += data.size();
+        ScheduleWrite();
+    }
+    
+    void Write(memory::BufferChain data) override {
+        if (data.Empty() || !open_ || end_requested_) {
+            return;
+        }
+        
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        pending_bytes_ += data.Size();
+        queue_.Append(std::move(data));
+        ScheduleWrite();
+    }
+    
+    void End() override {
+        if (end_requested_.exchange(true)) {
+            return;
+        }
+        
+        net::post(executor_, [self = shared_from_this()]() {
+            self->DoWrite();
+        });
+    }
+    
+    bool IsOpen() const override {
+        return open_ && !expired_;
+    }
+    
+    bool IsWritable() const override {
+        return !open_ || pending_bytes_ < kHighWatermark;
+    }
+    
+    async::Task<void> WaitWritable() override {
+        if (IsWritable()) {
+            co_return;
+        }
+        co_await DrainAwaiter{this};
+    }
+    
+    // 截止时间到期时停止接收数据，发送已排队的数据和终止块；
+    // 连接出错时取消截止时间，通知上游等仍在为该请求工作的环节停止
+    void Watch(async::Deadline deadline) {
+        deadline_ = std::move(deadline);
+        expiry_registration_ = deadline_.OnExpire([weak = weak_from_this()]() {
+            if (auto self = weak.lock()) {
+                self->OnDeadline();
+            }
+        });
+    }
+
+private:
+    void OnDeadline() {
+        if (!open_ || end_requested_) {
+            return;
+        }
+        spdlog::warn("Stream response deadline exceeded");
+        expired_ = true;
+        End();
+        net::post(executor_, [self = shared_from_this()]() {
+            self->ResumeDrainWaiters();
+        });
+    }
+    
+    // 等待发送队列降到低水位的生产者协程和它挂起时所在的执行器
+    struct DrainWaiter {
+        std::coroutine_handle<> handle;
+        net::any_io_executor executor;
+    };
+    
+    // 挂起生产者协程直到发送队列降到低水位，生产者回到它挂起时所在的执行器继续
+    struct DrainAwaiter {
+        SessionStreamWriter* writer;
+        
+        bool await_ready() const noexcept {
+            return writer->IsWritable();
+        }
+        
+        void await_suspend(std::coroutine_handle<> handle) {
+            DrainWaiter waiter{handle, CurrentExecutor()};
+            net::post(writer->executor_, [self = writer->shared_from_this(), waiter = std::move(waiter)]() {
+                // 在strand上重新检查，避免与写完成回调竞争
+                if (!self->open_ || self->expired_ || self->pending_bytes_ < kLowWatermark) {
+                    async::detail::ResumeAt(waiter.executor, waiter.handle);
+                } else {
+                    self->drain_waiters_.push_back(waiter);
+                }
+            });
+        }
+        
+        void await_resume() const noexcept {}
+    };
+    
+    // 持有queue_mutex_时调用，已有待运行的DoWrite时不再重复投递
+    void ScheduleWrite() {
+        if (!write_scheduled_) {
+            write_scheduled_ = true;
+            net::post(executor_, [self = shared_from_this()]() {
+                self->DoWrite();
+            });
+        }
+    }
+    
+    // 以下函数只在strand上运行
+    void DoWrite() {
+        if (writing_ || !session_) {
+            return;
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            write_scheduled_ = false;
+            if (!open_) {
+                queue_.Clear();
+                return;
+            }
+            // current_已在上次写完时清空，交换后由生产者继续使用
+            std::swap(current_, queue_);
+        }
+        
+        writing_ = true;
+        if (!current_.Empty()) {
+            // 写入期间累积的所有数据块作为一个chunk发送
+            net::async_write(session_->socket_, http::make_chunk(current_),
+                [self = shared_from_this()](beast::error_code ec, std::size_t) {
+                    self->OnWrite(ec);
+                });
+        } else if (end_requested_ && !end_sent_) {
+            // 发送终止块
+            end_sent_ = true;
+            net::async_write(session_->socket_, http::make_chunk_last(),
+                [self = shared_from_this()](beast::error_code ec, std::size_t) {
+                    self->OnWrite(ec);
+                });
+        } else {
+            writing_ = false;
+        }
+    }
+    
+    void OnWrite(beast::error_code ec) {
+        writing_ = false;
+        
+        if (ec) {
+            open_ = false;
+            current_.Clear();
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                pending_bytes_ = 0;
+                queue_.Clear();
+            }
+            ResumeDrainWaiters();
+            deadline_.Cancel();
+            
+            auto session = std::move(session_);
+            session->stream_serializer_.reset();
+            return session->HandleError(ec, "stream write");
+        }
+        
+        pending_bytes_ -= std::min<size_t>(pending_bytes_, current_.Size());
+        current_.Clear();
+        
+        if (pending_bytes_ < kLowWatermark) {
+            ResumeDrainWaiters();
+        }
+        
+        if (end_sent_) {
+            // 终止块已发送，释放会话引用并继续处理下一个请求
+            open_ = false;
+            auto session = std::move(session_);
+            session->stream_serializer_.reset();
+            return session->FinishResponse(should_close_);
+        }
+        
+        DoWrite();
+    }
+    
+    void ResumeDrainWaiters() {
+        auto waiters = std::move(drain_waiters_);
+        drain_waiters_.clear();
+        for (auto& waiter : waiters) {
+            async::detail::ResumeAt(waiter.executor, waiter.handle);
+        }
+    }
+
+private:
+    std::shared_ptr<HttpSession> session_;
+    net::any_io_executor executor_;
+    bool should_close_;
+    
+    std::atomic<bool> open_{true};
+    std::atomic<bool> end_requested_{false};
+    std::atomic<bool> expired_{false};
+    std::atomic<size_t> pending_bytes_{0};
+    
+    // 生产者写入的待发送数据
+    std::mutex queue_mutex_;
+    memory::BufferChain queue_;
+    bool write_scheduled_ = false;
+    
+    // 以下成员只在strand上访问
+    memory::BufferChain current_;
+    bool writing_ = false;
+    bool end_sent_ = false;
+    std::vector<DrainWaiter> drain_waiters_;
+    
+    async::Deadline deadline_;
+    async::Deadline::Registration expiry_registration_;
+};
+
+template <typename Body>
+bool HttpServer::HttpSession::PrepareHeaders(http::response<Body>& response, const Response& resp) {
+    // 转换到Beast的响应格式
+    response.version(request_.version());
+    response.result(resp.status_code);
+    response.set(http::field::server, "AiBackend");
     
     // 设置其他头部
     for (const auto& [name, value] : resp.headers) {
-        response_.set(name, value);
+        response.set(name, value);
     }
     
     // 设置Keep-Alive头部
-    bool should_close = close_connection_ || resp.headers.count("Connection") > 0 && 
-                        resp.headers.at("Connection") == "close";
+    bool should_close = close_connection_ || !request_.keep_alive() ||
+                        (resp.headers.count("Connection") > 0 &&
+                         resp.headers.at("Connection") == "close");
     
     if (should_close) {
-        response_.set(http::field::connection, "close");
+        response.set(http::field::connection, "close");
     } else {
-        response_.set(http::field::connection, "keep-alive");
+        response.set(http::field::connection, "keep-alive");
     }
     
-    // 设置响应体
-    response_.body() = resp.body;
+    return should_close;
+}
+
+void HttpServer::HttpSession::WriteResponse(Response resp) {
+    auto self = shared_from_this();
+    
+    response_ = {};
+    bool should_close = PrepareHeaders(response_, resp);
+    
+    // 设置内容长度
+    response_.set(http::field::content_length, std::to_string(resp.body.size()));
+    
+    // 设置响应体，移交给Beast不复制
+    response_.body() = std::move(resp.body);
     
     // 发送响应
     http::async_write(socket_, response_,
@@ -280,24 +606,78 @@ void HttpServer::HttpSession::WriteResponse(const Response& resp) {
                 return self->HandleError(ec, "write");
             }
             
-            if (should_close) {
-                // 关闭连接
-                return self->Close();
+            self->FinishResponse(should_close);
+        });
+}
+
+void HttpServer::HttpSession::WriteStreamingResponse(Response resp, async::Deadline deadline,
+                                                     AdmissionTicket ticket) {
+    auto self = shared_from_this();
+    
+    stream_response_ = {};
+    bool should_close = PrepareHeaders(stream_response_, resp);
+    
+    // 使用分块编码，头部先行发送，首个token无需等待完整响应
+    stream_response_.chunked(true);
+    stream_serializer_.emplace(stream_response_);
+    
+    http::async_write_header(socket_, *stream_serializer_,
+        [self, should_close, handler = std::move(resp.stream_handler), deadline = std::move(deadline),
+         ticket = std::move(ticket)]
+        (beast::error_code ec, std::size_t) mutable {
+            if (ec) {
+                self->stream_serializer_.reset();
+                return self->HandleError(ec, "write header");
             }
             
-            // 清理旧请求数据
-            self->request_ = {};
-            
-            // 读取下一个请求
-            self->ReadRequest();
+            auto writer = std::make_shared<SessionStreamWriter>(self, should_close);
+            writer->Watch(std::move(deadline));
+            async::Spawn(self->socket_.get_executor(),
+                         RunStreamHandler(std::move(writer), std::move(handler), std::move(ticket)));
         });
 }
 
+Task<void> HttpServer::HttpSession::RunStreamHandler(
+    std::shared_ptr<SessionStreamWriter> writer,
+    std::function<Task<void>(StreamWriter&)> handler,
+    [[maybe_unused]] AdmissionTicket ticket) {
+    
+    try {
+        co_await handler(*writer);
+    } catch (const std::exception& e) {
+        spdlog::error("Exception in stream handler: {}", e.what());
+    }
+    
+    // 处理函数未显式结束时补发终止块，保证客户端能收到完整响应
+    writer->End();
+}
+
+void HttpServer::HttpSession::FinishResponse(bool should_close) {
+    if (should_close) {
+        // 关闭连接
+        return Close();
+    }
+    
+    // 清理旧请求数据
+    request_ = {};
+    
+    // 读取下一个请求
+    ReadRequest();
+}
+
 void HttpServer::HttpSession::Close() {
     beast::error_code ec;
     socket_.shutdown(tcp::socket::shutdown_send, ec);
 }
 
+void HttpServer::HttpSession::OnIdleTimeout() {
+    spdlog::debug("HttpSession read timed out");
+    
+    // 关闭socket，未完成的读取以operation_aborted结束
+    beast::error_code ec;
+    socket_.close(ec);
+}
+
 void HttpServer::HttpSession::HandleError(beast::error_code ec, const char* what) {
     if (ec == http::error::end_of_stream) {
         return Close();
@@ -1,41 +1,133 @@
 #include "core/http/request.h"
+#include <boost/beast/core/string.hpp>
 
 namespace ai_backend::core::http {
 
-std::string Request::GetHeader(const std::string& name) const {
-    auto it = headers.find(name);
-    if (it != headers.end()) {
-        return it->second;
+namespace {
+
+// Beast使用boost::string_view，与std::string_view之间零拷贝转换
+inline std::string_view ToStd(boost::beast::string_view sv) {
+    return {sv.data(), sv.size()};
+}
+
+inline boost::beast::string_view ToBeast(std::string_view sv) {
+    return {sv.data(), sv.size()};
+}
+
+} // namespace
+
+void Request::SetHeaderSource(const boost::beast::http::fields* fields) {
+    header_fields_ = fields;
+}
+
+void Request::AddHeader(std::string_view name, std::string_view value) {
+    extra_headers_.emplace_back(name, value);
+}
+
+void Request::ForEachHeader(const std::function<void(std::string_view, std::string_view)>& visitor) const {
+    if (header_fields_) {
+        for (const auto& field : *header_fields_) {
+            visitor(ToStd(field.name_string()), ToStd(field.value()));
+        }
+    }
+
+    for (const auto& [name, value] : extra_headers_) {
+        visitor(name, value);
+    }
+}
+
+void Request::ParseQueryString(std::string_view query) {
+    query_string = query;
+    query_params.clear();
+
+    size_t pos = 0;
+    while (pos < query.size()) {
+        size_t amp = query.find('&', pos);
+        if (amp == std::string_view::npos) {
+            amp = query.size();
+        }
+
+        std::string_view pair = query.substr(pos, amp - pos);
+        if (!pair.empty()) {
+            size_t eq = pair.find('=');
+            if (eq != std::string_view::npos) {
+                query_params.emplace_back(pair.substr(0, eq), pair.substr(eq + 1));
+            } else {
+                query_params.emplace_back(pair, std::string_view{});
+            }
+        }
+
+        pos = amp + 1;
+    }
+}
+
+void Request::SetPathParam(std::string_view name, std::string_view value) {
+    for (auto& param : path_params) {
+        if (param.first == name) {
+            param.second = value;
+            return;
+        }
     }
-    return "";
+    path_params.emplace_back(name, value);
 }
 
-std::string Request::GetQueryParam(const std::string& name, const std::string& default_value) const {
-    auto it = query_params.find(name);
-    if (it != query_params.end()) {
-        return it->second;
+std::string_view Request::GetHeader(std::string_view name) const {
+    if (header_fields_) {
+        auto it = header_fields_->find(ToBeast(name));
+        if (it != header_fields_->end()) {
+            return ToStd(it->value());
+        }
+    }
+
+    for (const auto& [header_name, value] : extra_headers_) {
+        if (boost::beast::iequals(ToBeast(header_name), ToBeast(name))) {
+            return value;
+        }
     }
-    return default_value;
+
+    return {};
 }
 
-std::string Request::GetPathParam(const std::string& name, const std::string& default_value) const {
-    auto it = path_params.find(name);
-    if (it != path_params.end()) {
-        return it->second;
+std::string_view Request::GetQueryParam(std::string_view name, std::string_view default_value) const {
+    const Param* param = FindParam(query_params, name);
+    return param ? param->second : default_value;
+}
+
+std::string_view Request::GetPathParam(std::string_view name, std::string_view default_value) const {
+    const Param* param = FindParam(path_params, name);
+    return param ? param->second : default_value;
+}
+
+bool Request::HasHeader(std::string_view name) const {
+    if (header_fields_ && header_fields_->find(ToBeast(name)) != header_fields_->end()) {
+        return true;
     }
-    return default_value;
+
+    for (const auto& [header_name, value] : extra_headers_) {
+        if (boost::beast::iequals(ToBeast(header_name), ToBeast(name))) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
-bool Request::HasHeader(const std::string& name) const {
-    return headers.find(name) != headers.end();
+bool Request::HasQueryParam(std::string_view name) const {
+    return FindParam(query_params, name) != nullptr;
 }
 
-bool Request::HasQueryParam(const std::string& name) const {
-    return query_params.find(name) != query_params.end();
+bool Request::HasPathParam(std::string_view name) const {
+    return FindParam(path_params, name) != nullptr;
 }
 
-bool Request::HasPathParam(const std::string& name) const {
-    return path_params.find(name) != path_params.end();
+const Request::Param* Request::FindParam(const ParamList& params, std::string_view name) {
+    // 参数个数很少，线性查找比哈希更快
+    for (const auto& param : params) {
+        if (param.first == name) {
+            return &param;
+        }
+    }
+    return nullptr;
 }
 
-} // namespace ai_backend::core::http
\ No newline at end of file
+} // namespace ai_backend::core::http
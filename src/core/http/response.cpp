@@ -11,7 +11,7 @@ Response Response::WithJson(int status_code, const nlohmann::json& json_data) {
 }
 
 Response& Response::SetHeader(const std::string& name, const std::string& value) {
-    headers[name] = value;
+    headers.insert_or_assign(HeaderMap::key_type(name, headers.get_allocator()), value);
     return *this;
 }
 
@@ -63,6 +63,16 @@ Response Response::NotFound(const nlohmann::json& error) {
     });
 }
 
+Response Response::MethodNotAllowed(const std::string& allow, const nlohmann::json& error) {
+    Response response = WithJson(405, {
+        {"code", error.value("code", 405)},
+        {"message", error.value("message", "请求方法不被允许")},
+        {"data", error.value("data", nullptr)}
+    });
+    response.SetHeader("Allow", allow);
+    return response;
+}
+
 Response Response::InternalServerError(const nlohmann::json& error) {
     return WithJson(500, {
         {"code", error.value("code", 500)},
@@ -71,4 +81,22 @@ Response Response::InternalServerError(const nlohmann::json& error) {
     });
 }
 
+Response Response::GatewayTimeout(const nlohmann::json& error) {
+    return WithJson(504, {
+        {"code", error.value("code", 504)},
+        {"message", error.value("message", "请求处理超时")},
+        {"data", error.value("data", nullptr)}
+    });
+}
+
+Response Response::ServiceUnavailable(std::chrono::seconds retry_after, const nlohmann::json& error) {
+    Response response = WithJson(503, {
+        {"code", error.value("code", 503)},
+        {"message", error.value("message", "服务繁忙，请稍后重试")},
+        {"data", error.value("data", nullptr)}
+    });
+    response.SetHeader("Retry-After", std::to_string(retry_after.count()));
+    return response;
+}
+
 } // namespace ai_backend::core::http
\ No newline at end of file
@@ -0,0 +1,232 @@
+#include "core/http/route_tree.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace ai_backend::core::http {
+
+struct RouteTree::Node {
+    // 静态节点匹配的文本，参数节点为空
+    std::string prefix;
+
+    // 静态子节点，indices[i]是static_children[i]前缀的首字符
+    std::string indices;
+    std::vector<std::unique_ptr<Node>> static_children;
+
+    // 参数子节点，匹配到下一个'/'为止
+    std::unique_ptr<Node> param_child;
+
+    // 每个方法对应的routes_下标，-1表示未注册
+    std::array<int32_t, kMethodCount> handlers;
+
+    // 已注册方法列表，如"GET, POST"
+    std::string allow;
+
+    Node() {
+        handlers.fill(-1);
+    }
+
+    bool HasHandlers() const {
+        return !allow.empty();
+    }
+};
+
+RouteTree::RouteTree() : root_(std::make_unique<Node>()) {}
+
+RouteTree::~RouteTree() = default;
+
+void RouteTree::Insert(std::string_view method, std::string_view path_template, size_t route_id) {
+    int method_index = MethodIndex(method);
+    if (method_index < 0) {
+        throw std::invalid_argument("Unsupported route method: " + std::string(method));
+    }
+    if (path_template.empty() || path_template[0] != '/') {
+        throw std::invalid_argument("Route path must start with '/': " + std::string(path_template));
+    }
+
+    RouteRecord record{route_id, {}};
+    Node* node = root_.get();
+    std::string_view rest = path_template;
+
+    while (!rest.empty()) {
+        if (rest[0] == '{') {
+            // 参数段
+            size_t close = rest.find('}');
+            if (close == std::string_view::npos || close == 1) {
+                throw std::invalid_argument("Invalid route parameter in: " + std::string(path_template));
+            }
+            if (record.param_names.size() == kMaxParams) {
+                throw std::invalid_argument("Too many route parameters in: " + std::string(path_template));
+            }
+
+            size_t offset = path_template.size() - rest.size();
+            record.param_names.emplace_back(rest.substr(1, close - 1));
+            rest = rest.substr(close + 1);
+
+            if (path_template[offset - 1] != '/' || (!rest.empty() && rest[0] != '/')) {
+                throw std::invalid_argument("Route parameter must span a whole segment: " + std::string(path_template));
+            }
+
+            if (!node->param_child) {
+                node->param_child = std::make_unique<Node>();
+            }
+            node = node->param_child.get();
+            continue;
+        }
+
+        // 静态段，直到下一个参数为止
+        std::string_view text = rest.substr(0, std::min(rest.find('{'), rest.size()));
+        size_t index = node->indices.find(text[0]);
+
+        if (index == std::string::npos) {
+            auto child = std::make_unique<Node>();
+            child->prefix = std::string(text);
+            node->indices.push_back(text[0]);
+            node->static_children.push_back(std::move(child));
+            node = node->static_children.back().get();
+            rest = rest.substr(text.size());
+            continue;
+        }
+
+        Node* child = node->static_children[index].get();
+        auto mismatch = std::mismatch(child->prefix.begin(), child->prefix.end(), text.begin(), text.end());
+        size_t common = static_cast<size_t>(mismatch.first - child->prefix.begin());
+
+        if (common < child->prefix.size()) {
+            Split(child, common);
+        }
+
+        node = child;
+        rest = rest.substr(common);
+    }
+
+    if (node->handlers[method_index] >= 0) {
+        throw std::invalid_argument("Duplicate route: " + std::string(method) + " " + std::string(path_template));
+    }
+
+    node->handlers[method_index] = static_cast<int32_t>(routes_.size());
+    routes_.push_back(std::move(record));
+    RebuildAllow(node);
+}
+
+RouteTree::MatchResult RouteTree::Match(std::string_view method, std::string_view path) const {
+    MatchResult result;
+    MatchResult fallback;
+
+    if (MatchNode(root_.get(), path, MethodIndex(method), result, fallback)) {
+        // 填充参数名
+        const auto& names = routes_[result.route_id].param_names;
+        for (size_t i = 0; i < result.param_count; ++i) {
+            result.params[i].first = names[i];
+        }
+        result.route_id = routes_[result.route_id].route_id;
+        return result;
+    }
+
+    return fallback;
+}
+
+bool RouteTree::MatchNode(const Node* node, std::string_view rest, int method,
+                          MatchResult& result, MatchResult& fallback) const {
+    if (rest.empty()) {
+        if (method >= 0 && node->handlers[method] >= 0) {
+            result.status = MatchStatus::kFound;
+            result.route_id = static_cast<size_t>(node->handlers[method]);
+            return true;
+        }
+
+        // 记录第一个路径匹配但方法不匹配的节点，其他分支都失败时返回405
+        if (node->HasHandlers() && fallback.status == MatchStatus::kNotFound) {
+            fallback.status = MatchStatus::kMethodNotAllowed;
+            fallback.allow = node->allow;
+        }
+        return false;
+    }
+
+    // 静态子节点优先
+    size_t index = node->indices.find(rest[0]);
+    if (index != std::string::npos) {
+        const Node* child = node->static_children[index].get();
+        if (rest.compare(0, child->prefix.size(), child->prefix) == 0 &&
+            MatchNode(child, rest.substr(child->prefix.size()), method, result, fallback)) {
+            return true;
+        }
+    }
+
+    // 参数子节点，匹配一个非空路径段
+    if (node->param_child) {
+        size_t end = std::min(rest.find('/'), rest.size());
+        if (end > 0) {
+            result.params[result.param_count++].second = rest.substr(0, end);
+            if (MatchNode(node->param_child.get(), rest.substr(end), method, result, fallback)) {
+                return true;
+            }
+            --result.param_count;
+        }
+    }
+
+    return false;
+}
+
+void RouteTree::Split(Node* node, size_t common) {
+    auto tail = std::make_unique<Node>();
+    tail->prefix = node->prefix.substr(common);
+    tail->indices = std::move(node->indices);
+    tail->static_children = std::move(node->static_children);
+    tail->param_child = std::move(node->param_child);
+    tail->handlers = node->handlers;
+    tail->allow = std::move(node->allow);
+
+    node->prefix.resize(common);
+    node->indices.assign(1, tail->prefix[0]);
+    node->static_children.clear();
+    node->static_children.push_back(std::move(tail));
+    node->param_child.reset();
+    node->handlers.fill(-1);
+    node->allow.clear();
+}
+
+void RouteTree::RebuildAllow(Node* node) {
+    node->allow.clear();
+    for (int i = 0; i < kMethodCount; ++i) {
+        if (node->handlers[i] >= 0) {
+            if (!node->allow.empty()) {
+                node->allow += ", ";
+            }
+            node->allow += MethodName(i);
+        }
+    }
+}
+
+int RouteTree::MethodIndex(std::string_view method) {
+    switch (method.size()) {
+    case 3:
+        if (method == "GET") return kGet;
+        if (method == "PUT") return kPut;
+        break;
+    case 4:
+        if (method == "POST") return kPost;
+        if (method == "HEAD") return kHead;
+        break;
+    case 5:
+        if (method == "PATCH") return kPatch;
+        break;
+    case 6:
+        if (method == "DELETE") return kDelete;
+        break;
+    case 7:
+        if (method == "OPTIONS") return kOptions;
+        break;
+    default:
+        break;
+    }
+    return -1;
+}
+
+const char* RouteTree::MethodName(int method) {
+    static constexpr const char* kNames[kMethodCount] = {
+        "GET", "POST", "PUT", "DELETE", "PATCH", "HEAD", "OPTIONS"
+    };
+    return kNames[method];
+}
+
+} // namespace ai_backend::core::http
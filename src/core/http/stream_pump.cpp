@@ -0,0 +1,88 @@
+#include "core/http/stream_pump.h"
+#include <utility>
+
+namespace ai_backend::core::http {
+
+void StreamPump::Push(memory::BufferChain data) {
+    if (data.Empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (finished_ || closed_) {
+            return;
+        }
+        pending_.Append(std::move(data));
+    }
+    ready_.Set();
+}
+
+void StreamPump::Push(std::string_view data) {
+    if (data.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (finished_ || closed_) {
+            return;
+        }
+        pending_.Append(data);
+    }
+    ready_.Set();
+}
+
+void StreamPump::Finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+    }
+    ready_.Set();
+}
+
+async::Task<void> StreamPump::Run() {
+    while (true) {
+        // 先等写入器可写，等待期间到达的数据继续在pending_中合并
+        auto writable = writer_.WaitWritable();
+        co_await writable;
+        auto ready = ready_.Wait();
+        co_await ready;
+
+        // 先复位再取数据，取数据之后的Push会重新置位，不会丢失唤醒
+        ready_.Reset();
+        memory::BufferChain data;
+        bool finished = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!writer_.IsOpen()) {
+                // 客户端已断开或截止时间已到，之后的数据直接丢弃
+                closed_ = true;
+                pending_.Clear();
+                co_return;
+            }
+            // 每次最多交出kMaxWriteBytes，积压的数据不会一次全部进入写入器的发送队列
+            if (pending_.Size() > kMaxWriteBytes) {
+                data = pending_.Split(kMaxWriteBytes);
+            } else {
+                data = std::exchange(pending_, {});
+                finished = finished_;
+            }
+        }
+
+        if (!data.Empty()) {
+            writer_.Write(std::move(data));
+        }
+        if (finished) {
+            co_return;
+        }
+        if (GetPendingBytes() > 0) {
+            ready_.Set();
+        }
+    }
+}
+
+size_t StreamPump::GetPendingBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.Size();
+}
+
+} // namespace ai_backend::core::http
@@ -0,0 +1,539 @@
+#include "core/http/upstream_client.h"
+#include "core/async/event_loop.h"
+#include "core/async/task.h"
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <utility>
+#include <spdlog/spdlog.h>
+
+namespace ai_backend::core::http {
+
+namespace net = boost::asio;
+
+struct UpstreamClient::Transfer {
+    UpstreamRequest request;
+    UpstreamResponse response;
+    UpstreamChunkHandler on_chunk;
+
+    CURL* easy = nullptr;
+    curl_slist* header_list = nullptr;
+    char error_buffer[CURL_ERROR_SIZE] = {};
+
+    // 连接池统计的键
+    std::string base_url;
+
+    // 等待者和它恢复时所在的executor，预热请求为空
+    std::coroutine_handle<> waiter;
+    net::any_io_executor resume_executor;
+
+    // 截止时间回调，传输结束时随之注销
+    async::Deadline::Registration deadline_registration;
+
+    ~Transfer() {
+        if (header_list) {
+            curl_slist_free_all(header_list);
+        }
+        if (easy) {
+            curl_easy_cleanup(easy);
+        }
+    }
+};
+
+struct UpstreamClient::SocketWatcher {
+    SocketWatcher(net::strand<net::io_context::executor_type>& strand, curl_socket_t fd)
+        : socket(fd), descriptor(strand, fd) {}
+
+    curl_socket_t socket;
+    net::posix::stream_descriptor descriptor;
+
+    // curl当前要求的事件 (CURL_POLL_IN/OUT/INOUT)
+    int action = 0;
+
+    bool reading = false;
+    bool writing = false;
+    bool removed = false;
+};
+
+UpstreamClient::UpstreamClient(net::io_context& io_context)
+    : io_context_(io_context),
+      strand_(net::make_strand(io_context)),
+      timer_(strand_) {
+    static std::once_flag curl_init_flag;
+    std::call_once(curl_init_flag, []() {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+    });
+
+    multi_ = curl_multi_init();
+    if (!multi_) {
+        throw std::runtime_error("Failed to create curl multi handle");
+    }
+
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETFUNCTION, &UpstreamClient::SocketCallback);
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERFUNCTION, &UpstreamClient::TimerCallback);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERDATA, this);
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, options_.max_host_connections);
+    curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, options_.max_cached_connections);
+
+    // DNS和TLS会话缓存在连接关闭后仍然保留，所有curl调用都在strand上，无需加锁
+    share_ = curl_share_init();
+    if (!share_) {
+        curl_multi_cleanup(multi_);
+        throw std::runtime_error("Failed to create curl share handle");
+    }
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+}
+
+UpstreamClient::~UpstreamClient() {
+    // 调用方需保证io_context已停止，此时不会再有处理器在strand上运行
+    timer_.cancel();
+
+    // 先移除传输，curl会通过SocketCallback注销对应的套接字
+    for (auto& [easy, transfer] : transfers_) {
+        curl_multi_remove_handle(multi_, easy);
+    }
+    transfers_.clear();
+
+    for (auto& [socket, watcher] : watchers_) {
+        watcher->removed = true;
+        watcher->descriptor.release();
+    }
+    watchers_.clear();
+
+    curl_multi_cleanup(multi_);
+    curl_share_cleanup(share_);
+}
+
+UpstreamClient& UpstreamClient::GetInstance() {
+    static UpstreamClient instance(async::EventLoop::GetInstance().GetIoContext());
+    return instance;
+}
+
+UpstreamClient::SendAwaiter UpstreamClient::Send(UpstreamRequest request) {
+    auto transfer = std::make_shared<Transfer>();
+    transfer->request = std::move(request);
+    return SendAwaiter(*this, std::move(transfer));
+}
+
+UpstreamClient::SendAwaiter UpstreamClient::SendStream(UpstreamRequest request, UpstreamChunkHandler on_chunk) {
+    auto transfer = std::make_shared<Transfer>();
+    transfer->request = std::move(request);
+    transfer->on_chunk = std::move(on_chunk);
+    return SendAwaiter(*this, std::move(transfer));
+}
+
+size_t UpstreamClient::GetActiveTransfers() const {
+    return active_transfers_.load(std::memory_order_relaxed);
+}
+
+void UpstreamClient::Configure(const UpstreamOptions& options) {
+    net::post(strand_, [this, options]() {
+        options_ = options;
+        curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, options_.max_host_connections);
+        curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, options_.max_cached_connections);
+    });
+}
+
+void UpstreamClient::Prewarm(const UpstreamRequest& request, size_t connections) {
+    spdlog::info("Prewarming {} upstream connection(s) to {}", connections, BaseUrlOf(request.url));
+    for (size_t i = 0; i < connections; ++i) {
+        auto transfer = std::make_shared<Transfer>();
+        transfer->request = request;
+        StartTransfer(std::move(transfer));
+    }
+}
+
+std::vector<UpstreamPoolStats> UpstreamClient::GetPoolStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    std::vector<UpstreamPoolStats> result;
+    result.reserve(pool_stats_.size());
+    for (const auto& [base_url, counters] : pool_stats_) {
+        result.push_back(counters.stats);
+    }
+    return result;
+}
+
+std::string UpstreamClient::BaseUrlOf(const std::string& url) {
+    size_t scheme_end = url.find("://");
+    size_t host_begin = scheme_end == std::string::npos ? 0 : scheme_end + 3;
+    size_t path_begin = url.find_first_of("/?#", host_begin);
+    return url.substr(0, path_begin);
+}
+
+void UpstreamClient::StartTransfer(std::shared_ptr<Transfer> transfer) {
+    transfer->base_url = BaseUrlOf(transfer->request.url);
+
+    net::post(strand_, [this, transfer = std::move(transfer)]() mutable {
+        bool started = SetupEasyHandle(*transfer);
+        if (started) {
+            CURLMcode rc = curl_multi_add_handle(multi_, transfer->easy);
+            if (rc != CURLM_OK) {
+                transfer->response.error = curl_multi_strerror(rc);
+                started = false;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            auto& stats = pool_stats_[transfer->base_url].stats;
+            stats.base_url = transfer->base_url;
+            if (started) {
+                stats.active++;
+            } else {
+                stats.failures++;
+            }
+        }
+
+        if (!started) {
+            if (auto waiter = transfer->waiter) {
+                async::detail::ResumeAt(std::exchange(transfer->resume_executor, {}), waiter);
+            }
+            return;
+        }
+
+        active_transfers_.fetch_add(1, std::memory_order_relaxed);
+
+        CURL* easy = transfer->easy;
+        transfer->deadline_registration = transfer->request.deadline.OnExpire(
+            [this, easy, weak = std::weak_ptr<Transfer>(transfer)]() {
+                net::post(strand_, [this, easy, weak]() { AbortTransfer(easy, weak); });
+            });
+        transfers_.emplace(easy, std::move(transfer));
+    });
+}
+
+bool UpstreamClient::SetupEasyHandle(Transfer& transfer) {
+    transfer.easy = curl_easy_init();
+    if (!transfer.easy) {
+        transfer.response.error = "Failed to create curl easy handle";
+        return false;
+    }
+
+    CURL* easy = transfer.easy;
+    const auto& request = transfer.request;
+
+    // 截止时间已过的请求不再发出；curl的超时为0表示不限制，剩余时间至少取1ms
+    if (request.deadline.IsExpired()) {
+        transfer.response.error = "Deadline exceeded";
+        transfer.response.timed_out = true;
+        return false;
+    }
+    auto timeout = std::min(request.timeout,
+                            std::max(request.deadline.Remaining(), std::chrono::milliseconds(1)));
+
+    curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, transfer.error_buffer);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, static_cast<long>(timeout.count()));
+    curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(request.connect_timeout.count()));
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, &UpstreamClient::WriteCallback);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, &transfer);
+    curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, &UpstreamClient::HeaderCallback);
+    curl_easy_setopt(easy, CURLOPT_HEADERDATA, &transfer);
+
+    // 连接复用与缓存
+    curl_easy_setopt(easy, CURLOPT_SHARE, share_);
+    curl_easy_setopt(easy, CURLOPT_DNS_CACHE_TIMEOUT, options_.dns_cache_timeout);
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPIDLE, options_.tcp_keepalive_interval);
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPINTVL, options_.tcp_keepalive_interval);
+
+    if (options_.enable_http2) {
+        curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+    } else {
+        curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
+    }
+
+    if (!request.verify_tls) {
+        curl_easy_setopt(easy, CURLOPT_SSL_VERIFYPEER, 0L);
+        curl_easy_setopt(easy, CURLOPT_SSL_VERIFYHOST, 0L);
+    }
+
+    if (request.method == "GET") {
+        curl_easy_setopt(easy, CURLOPT_HTTPGET, 1L);
+    } else {
+        if (request.method != "POST") {
+            curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, request.method.c_str());
+        }
+        if (!request.body.empty() || request.method == "POST") {
+            curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request.body.data());
+            curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request.body.size()));
+        }
+    }
+
+    for (const auto& [name, value] : request.headers) {
+        std::string line = name + ": " + value;
+        curl_slist* list = curl_slist_append(transfer.header_list, line.c_str());
+        if (!list) {
+            transfer.response.error = "Failed to build request headers";
+            return false;
+        }
+        transfer.header_list = list;
+    }
+    if (transfer.header_list) {
+        curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer.header_list);
+    }
+
+    return true;
+}
+
+void UpstreamClient::SocketAction(curl_socket_t socket, int event_bitmask) {
+    int running_handles = 0;
+    CURLMcode rc = curl_multi_socket_action(multi_, socket, event_bitmask, &running_handles);
+    if (rc != CURLM_OK) {
+        spdlog::error("curl_multi_socket_action failed: {}", curl_multi_strerror(rc));
+    }
+    CheckCompleted();
+}
+
+void UpstreamClient::CheckCompleted() {
+    int messages_left = 0;
+    while (CURLMsg* message = curl_multi_info_read(multi_, &messages_left)) {
+        if (message->msg != CURLMSG_DONE) {
+            continue;
+        }
+
+        CURL* easy = message->easy_handle;
+        CURLcode result = message->data.result;
+
+        auto it = transfers_.find(easy);
+        if (it == transfers_.end()) {
+            curl_multi_remove_handle(multi_, easy);
+            continue;
+        }
+
+        auto transfer = std::move(it->second);
+        transfers_.erase(it);
+        curl_multi_remove_handle(multi_, easy);
+        active_transfers_.fetch_sub(1, std::memory_order_relaxed);
+
+        long status_code = 0;
+        curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &status_code);
+        transfer->response.status_code = static_cast<int>(status_code);
+
+        if (result != CURLE_OK) {
+            transfer->response.timed_out = result == CURLE_OPERATION_TIMEDOUT;
+            transfer->response.error = transfer->error_buffer[0] != '\0'
+                ? std::string(transfer->error_buffer)
+                : std::string(curl_easy_strerror(result));
+            spdlog::warn("Upstream request to {} failed: {}", transfer->request.url, transfer->response.error);
+        }
+
+        FinishTransfer(std::move(transfer), result != CURLE_OK);
+    }
+}
+
+void UpstreamClient::AbortTransfer(CURL* easy, const std::weak_ptr<Transfer>& weak_transfer) {
+    // 传输可能已经完成，easy句柄地址也可能被新的传输复用
+    auto transfer = weak_transfer.lock();
+    auto it = transfers_.find(easy);
+    if (!transfer || it == transfers_.end() || it->second != transfer) {
+        return;
+    }
+
+    transfers_.erase(it);
+    curl_multi_remove_handle(multi_, easy);
+    active_transfers_.fetch_sub(1, std::memory_order_relaxed);
+
+    transfer->response.error = "Deadline exceeded";
+    transfer->response.timed_out = true;
+    spdlog::warn("Upstream request to {} aborted: deadline exceeded", transfer->request.url);
+
+    FinishTransfer(std::move(transfer), true);
+}
+
+void UpstreamClient::FinishTransfer(std::shared_ptr<Transfer> transfer, bool failed) {
+    RecordCompletion(*transfer, failed);
+
+    // 回到等待者所在的executor恢复，避免调用方的后续逻辑占用curl的strand；
+    // 等待器持有transfer，恢复前不会释放。transfer可能在等待者恢复之后才在这里释放，
+    // 恢复时就交出executor，不让它比等待者所在的io_context活得更久
+    if (auto waiter = transfer->waiter) {
+        async::detail::ResumeAt(std::exchange(transfer->resume_executor, {}), waiter);
+    }
+}
+
+void UpstreamClient::RecordCompletion(Transfer& transfer, bool failed) {
+    long new_connections = 0;
+    long http_version = 0;
+    curl_off_t connect_us = 0;
+    curl_off_t tls_us = 0;
+    curl_easy_getinfo(transfer.easy, CURLINFO_NUM_CONNECTS, &new_connections);
+    curl_easy_getinfo(transfer.easy, CURLINFO_HTTP_VERSION, &http_version);
+    curl_easy_getinfo(transfer.easy, CURLINFO_CONNECT_TIME_T, &connect_us);
+    curl_easy_getinfo(transfer.easy, CURLINFO_APPCONNECT_TIME_T, &tls_us);
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    auto& counters = pool_stats_[transfer.base_url];
+    auto& stats = counters.stats;
+
+    stats.active--;
+    stats.requests++;
+    if (failed) {
+        stats.failures++;
+    }
+    if (http_version == CURL_HTTP_VERSION_2_0) {
+        stats.http2_requests++;
+    }
+
+    if (new_connections > 0) {
+        stats.connections_opened++;
+        counters.total_connect_us += connect_us;
+        counters.total_tls_us += tls_us;
+        stats.avg_connect_ms = counters.total_connect_us / 1000.0 / stats.connections_opened;
+        stats.avg_tls_ms = counters.total_tls_us / 1000.0 / stats.connections_opened;
+    } else if (!failed) {
+        stats.connections_reused++;
+    }
+}
+
+void UpstreamClient::WatchSocket(const std::shared_ptr<SocketWatcher>& watcher) {
+    if ((watcher->action & CURL_POLL_IN) && !watcher->reading) {
+        watcher->reading = true;
+        watcher->descriptor.async_wait(net::posix::descriptor_base::wait_read,
+            [this, watcher](const boost::system::error_code& ec) {
+                watcher->reading = false;
+                if (ec || watcher->removed || !(watcher->action & CURL_POLL_IN)) {
+                    return;
+                }
+                SocketAction(watcher->socket, CURL_CSELECT_IN);
+                if (!watcher->removed) {
+                    WatchSocket(watcher);
+                }
+            });
+    }
+
+    if ((watcher->action & CURL_POLL_OUT) && !watcher->writing) {
+        watcher->writing = true;
+        watcher->descriptor.async_wait(net::posix::descriptor_base::wait_write,
+            [this, watcher](const boost::system::error_code& ec) {
+                watcher->writing = false;
+                if (ec || watcher->removed || !(watcher->action & CURL_POLL_OUT)) {
+                    return;
+                }
+                SocketAction(watcher->socket, CURL_CSELECT_OUT);
+                if (!watcher->removed) {
+                    WatchSocket(watcher);
+                }
+            });
+    }
+}
+
+int UpstreamClient::SocketCallback(CURL* /*easy*/, curl_socket_t socket, int what, void* userp, void* /*socketp*/) {
+    auto* client = static_cast<UpstreamClient*>(userp);
+
+    if (what == CURL_POLL_REMOVE) {
+        auto it = client->watchers_.find(socket);
+        if (it != client->watchers_.end()) {
+            // 套接字由curl关闭，这里只解除注册
+            it->second->removed = true;
+            it->second->descriptor.release();
+            client->watchers_.erase(it);
+        }
+        return 0;
+    }
+
+    auto& watcher = client->watchers_[socket];
+    if (!watcher) {
+        watcher = std::make_shared<SocketWatcher>(client->strand_, socket);
+    }
+
+    watcher->action = what;
+    client->WatchSocket(watcher);
+    return 0;
+}
+
+int UpstreamClient::TimerCallback(CURLM* /*multi*/, long timeout_ms, void* userp) {
+    auto* client = static_cast<UpstreamClient*>(userp);
+
+    if (timeout_ms < 0) {
+        client->timer_.cancel();
+        return 0;
+    }
+
+    // 超时为0时同样经由定时器异步触发，避免在回调内重入curl
+    client->timer_.expires_after(std::chrono::milliseconds(timeout_ms));
+    client->timer_.async_wait([client](const boost::system::error_code& ec) {
+        if (!ec) {
+            client->SocketAction(CURL_SOCKET_TIMEOUT, 0);
+        }
+    });
+    return 0;
+}
+
+size_t UpstreamClient::WriteCallback(char* data, size_t size, size_t nmemb, void* userp) {
+    auto* transfer = static_cast<Transfer*>(userp);
+    size_t bytes = size * nmemb;
+
+    if (transfer->on_chunk) {
+        long status_code = 0;
+        curl_easy_getinfo(transfer->easy, CURLINFO_RESPONSE_CODE, &status_code);
+        if (status_code >= 200 && status_code < 300) {
+            try {
+                transfer->on_chunk(std::string_view(data, bytes));
+            } catch (const std::exception& e) {
+                spdlog::error("Exception in upstream chunk handler: {}", e.what());
+                return 0; // 中止传输
+            }
+            return bytes;
+        }
+    }
+
+    transfer->response.body.append(data, bytes);
+    return bytes;
+}
+
+size_t UpstreamClient::HeaderCallback(char* data, size_t size, size_t nmemb, void* userp) {
+    auto* transfer = static_cast<Transfer*>(userp);
+    size_t bytes = size * nmemb;
+    std::string_view line(data, bytes);
+
+    // 新的状态行 (重定向或100-continue之后) 重置已收集的头部
+    if (line.rfind("HTTP/", 0) == 0) {
+        transfer->response.headers.clear();
+        return bytes;
+    }
+
+    auto colon = line.find(':');
+    if (colon == std::string_view::npos) {
+        return bytes;
+    }
+
+    std::string name(line.substr(0, colon));
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    std::string_view value = line.substr(colon + 1);
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == '\r' || value.back() == '\n' || value.back() == ' ')) {
+        value.remove_suffix(1);
+    }
+
+    transfer->response.headers[std::move(name)] = std::string(value);
+    return bytes;
+}
+
+UpstreamClient::SendAwaiter::SendAwaiter(UpstreamClient& client, std::shared_ptr<Transfer> transfer)
+    : client_(client), transfer_(std::move(transfer)) {}
+
+void UpstreamClient::SendAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    // 记录等待者所在的会话strand或分片io_context，不在协程恢复点上等待时回到客户端的io_context
+    transfer_->waiter = handle;
+    transfer_->resume_executor = async::CurrentExecutor();
+    if (!transfer_->resume_executor) {
+        transfer_->resume_executor = client_.io_context_.get_executor();
+    }
+    client_.StartTransfer(transfer_);
+}
+
+UpstreamResponse UpstreamClient::SendAwaiter::await_resume() {
+    return std::move(transfer_->response);
+}
+
+} // namespace ai_backend::core::http
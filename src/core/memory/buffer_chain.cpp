@@ -0,0 +1,266 @@
+#include "core/memory/buffer_chain.h"
+#include "core/memory/memory_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace ai_backend::core::memory {
+
+namespace {
+
+// 段头部和数据放在同一个池化块中
+detail::BufferSegment* NewPooledSegment() {
+    void* block = MemoryPool::GetInstance().Allocate(BufferChain::kSegmentSize);
+    auto* segment = new (block) detail::BufferSegment();
+    segment->destroy = [](detail::BufferSegment* self) {
+        self->~BufferSegment();
+        MemoryPool::GetInstance().Deallocate(self, BufferChain::kSegmentSize);
+    };
+    segment->data = reinterpret_cast<char*>(segment + 1);
+    segment->capacity = BufferChain::kSegmentSize - sizeof(detail::BufferSegment);
+    return segment;
+}
+
+struct StringSegment : detail::BufferSegment {
+    std::string value;
+};
+
+detail::BufferSegment* NewStringSegment(std::string data) {
+    auto* segment = new StringSegment();
+    segment->value = std::move(data);
+    segment->destroy = [](detail::BufferSegment* self) {
+        delete static_cast<StringSegment*>(self);
+    };
+    segment->data = segment->value.data();
+    segment->capacity = segment->value.size();
+    segment->used = segment->value.size();
+    return segment;
+}
+
+} // namespace
+
+BufferSlice BufferSlice::Sub(size_t offset, size_t length) const {
+    if (offset > size_) {
+        throw std::out_of_range("BufferSlice::Sub offset out of range");
+    }
+    length = std::min(length, size_ - offset);
+    detail::RetainSegment(segment_);
+    return BufferSlice(segment_, data_ + offset, length);
+}
+
+BufferChain::BufferChain(std::string data) {
+    Append(std::move(data));
+}
+
+BufferChain::BufferChain(const BufferChain& other)
+    : slices_(other.slices_), size_(other.size_) {
+}
+
+BufferChain& BufferChain::operator=(const BufferChain& other) {
+    if (this != &other) {
+        ReleaseWriteSegment();
+        slices_ = other.slices_;
+        size_ = other.size_;
+    }
+    return *this;
+}
+
+BufferChain::BufferChain(BufferChain&& other) noexcept
+    : slices_(std::move(other.slices_)), size_(other.size_), write_segment_(other.write_segment_) {
+    other.slices_.clear();
+    other.size_ = 0;
+    other.write_segment_ = nullptr;
+}
+
+BufferChain& BufferChain::operator=(BufferChain&& other) noexcept {
+    if (this != &other) {
+        ReleaseWriteSegment();
+        slices_ = std::move(other.slices_);
+        size_ = other.size_;
+        write_segment_ = other.write_segment_;
+        other.slices_.clear();
+        other.size_ = 0;
+        other.write_segment_ = nullptr;
+    }
+    return *this;
+}
+
+BufferChain::~BufferChain() {
+    ReleaseWriteSegment();
+}
+
+void BufferChain::Append(const void* data, size_t size) {
+    auto* bytes = static_cast<const char*>(data);
+    size_ += size;
+
+    while (size > 0) {
+        if (!write_segment_ || write_segment_->used == write_segment_->capacity) {
+            ReleaseWriteSegment();
+            write_segment_ = NewPooledSegment();
+        }
+
+        auto* segment = write_segment_;
+        char* dest = segment->data + segment->used;
+        size_t count = std::min(size, segment->capacity - segment->used);
+        std::memcpy(dest, bytes, count);
+        segment->used += count;
+        bytes += count;
+        size -= count;
+
+        // 紧接着上一次写入时延长尾部切片，否则在段内新开一个切片
+        BufferSlice* tail = slices_.empty() ? nullptr : &slices_.back();
+        if (tail && tail->segment_ == segment && tail->data_ + tail->size_ == dest) {
+            tail->size_ += count;
+        } else {
+            detail::RetainSegment(segment);
+            slices_.emplace_back(segment, dest, count);
+        }
+    }
+}
+
+void BufferChain::Append(std::string&& data) {
+    if (data.size() < kAdoptThreshold) {
+        return Append(std::string_view(data));
+    }
+    size_ += data.size();
+    auto* segment = NewStringSegment(std::move(data));
+    slices_.emplace_back(segment, segment->data, segment->used);
+}
+
+void BufferChain::Append(BufferSlice slice) {
+    if (slice.Size() == 0) {
+        return;
+    }
+    size_ += slice.Size();
+    slices_.push_back(std::move(slice));
+}
+
+void BufferChain::Append(const BufferChain& other) {
+    if (&other == this) {
+        BufferChain copy(other);
+        return Append(std::move(copy));
+    }
+    for (const auto& slice : other.slices_) {
+        slices_.push_back(slice);
+    }
+    size_ += other.size_;
+}
+
+void BufferChain::Append(BufferChain&& other) {
+    if (&other == this) {
+        return Append(static_cast<const BufferChain&>(other));
+    }
+    for (auto& slice : other.slices_) {
+        slices_.push_back(std::move(slice));
+    }
+    size_ += other.size_;
+
+    // 尾部现在是other的数据，接着写入other的段才能与之相连
+    if (other.write_segment_) {
+        ReleaseWriteSegment();
+        write_segment_ = other.write_segment_;
+        other.write_segment_ = nullptr;
+    }
+    other.slices_.clear();
+    other.size_ = 0;
+}
+
+BufferChain BufferChain::Split(size_t n) {
+    if (n > size_) {
+        throw std::out_of_range("BufferChain::Split beyond end of chain");
+    }
+
+    BufferChain head;
+    size_t count = 0;
+    while (n > 0) {
+        auto& slice = slices_[count];
+        if (slice.Size() <= n) {
+            n -= slice.Size();
+            head.size_ += slice.Size();
+            head.slices_.push_back(std::move(slice));
+            ++count;
+        } else {
+            head.slices_.push_back(slice.Sub(0, n));
+            head.size_ += n;
+            slice.RemovePrefix(n);
+            n = 0;
+        }
+    }
+    slices_.erase(slices_.begin(), slices_.begin() + count);
+    size_ -= head.size_;
+    return head;
+}
+
+BufferChain BufferChain::Slice(size_t offset, size_t length) const {
+    if (offset > size_) {
+        throw std::out_of_range("BufferChain::Slice offset out of range");
+    }
+    length = std::min(length, size_ - offset);
+
+    BufferChain result;
+    for (const auto& slice : slices_) {
+        if (length == 0) {
+            break;
+        }
+        if (offset >= slice.Size()) {
+            offset -= slice.Size();
+            continue;
+        }
+        size_t count = std::min(length, slice.Size() - offset);
+        result.slices_.push_back(slice.Sub(offset, count));
+        result.size_ += count;
+        length -= count;
+        offset = 0;
+    }
+    return result;
+}
+
+void BufferChain::Consume(size_t n) {
+    n = std::min(n, size_);
+    size_ -= n;
+
+    size_t count = 0;
+    while (n > 0) {
+        auto& slice = slices_[count];
+        if (slice.Size() <= n) {
+            n -= slice.Size();
+            ++count;
+        } else {
+            slice.RemovePrefix(n);
+            n = 0;
+        }
+    }
+    slices_.erase(slices_.begin(), slices_.begin() + count);
+}
+
+void BufferChain::Clear() {
+    slices_.clear();
+    size_ = 0;
+    // 保留写段：不再被任何切片引用时从头复用，仍被共享时丢弃
+    if (write_segment_ && write_segment_->refs.load(std::memory_order_acquire) == 1) {
+        write_segment_->used = 0;
+    } else {
+        ReleaseWriteSegment();
+    }
+}
+
+std::string BufferChain::ToString() const {
+    std::string result(size_, '\0');
+    CopyTo(result.data());
+    return result;
+}
+
+void BufferChain::CopyTo(char* out) const {
+    for (const auto& slice : slices_) {
+        std::memcpy(out, slice.Data(), slice.Size());
+        out += slice.Size();
+    }
+}
+
+void BufferChain::ReleaseWriteSegment() noexcept {
+    detail::ReleaseSegment(write_segment_);
+    write_segment_ = nullptr;
+}
+
+} // namespace ai_backend::core::memory
@@ -1,74 +1,698 @@
 #include "core/memory/memory_pool.h"
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 
 namespace ai_backend::core::memory {
 
-MemoryPool::MemoryPool(size_t block_size, size_t initial_blocks)
-    : block_size_(block_size) {
-    for (size_t i = 0; i < initial_blocks; ++i) {
-        AllocateNewBlock();
+namespace detail {
+
+namespace {
+
+// 大小级别：16, 32, ..., 32768字节
+constexpr size_t kMinClassShift = 4;
+constexpr size_t kClassCount = 12;
+
+// 弹匣容量按级别大小取max(4, min(64, 64KB / 块大小))，大块不会在线程里囤积太多内存
+constexpr size_t kMaxRounds = 64;
+constexpr size_t kMagazineBytes = 64 * 1024;
+
+// 弹匣按编号分块分配，编号连同版本号放进64位的栈顶，避免ABA
+constexpr size_t kMagazinesPerChunk = 256;
+constexpr size_t kMaxMagazineChunks = 4096;
+
+static_assert((size_t{1} << (kMinClassShift + kClassCount - 1)) == MemoryPool::kMaxBlockSize);
+
+constexpr size_t ClassSize(size_t index) {
+    return size_t{1} << (kMinClassShift + index);
+}
+
+size_t ClassIndex(size_t size) {
+    return size <= ClassSize(0) ? 0 : std::bit_width(size - 1) - kMinClassShift;
+}
+
+uintptr_t SpanOf(void* block) {
+    return reinterpret_cast<uintptr_t>(block) & ~(MemoryPool::kSpanSize - 1);
+}
+
+// 申请kSpanSize对齐的span，Linux上直接映射匿名页，释放时能立即归还给操作系统
+void* MapSpan() {
+#ifdef __linux__
+    size_t length = 2 * MemoryPool::kSpanSize;
+    void* region = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        return nullptr;
+    }
+    auto begin = reinterpret_cast<uintptr_t>(region);
+    auto aligned = (begin + MemoryPool::kSpanSize - 1) & ~(MemoryPool::kSpanSize - 1);
+    if (aligned > begin) {
+        munmap(region, aligned - begin);
+    }
+    if (auto tail = begin + length - (aligned + MemoryPool::kSpanSize); tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + MemoryPool::kSpanSize), tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+#else
+    return ::operator new(MemoryPool::kSpanSize, std::align_val_t(MemoryPool::kSpanSize), std::nothrow);
+#endif
+}
+
+void UnmapSpan(uintptr_t span) {
+#ifdef __linux__
+    munmap(reinterpret_cast<void*>(span), MemoryPool::kSpanSize);
+#else
+    ::operator delete(reinterpret_cast<void*>(span), std::align_val_t(MemoryPool::kSpanSize));
+#endif
+}
+
+// 只由所属线程写入的计数器，其他线程汇总时读取
+class Counter {
+public:
+    void Add(uint64_t delta) noexcept {
+        value_.store(value_.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    uint64_t Load() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+} // namespace
+
+struct Magazine {
+    // 在栈中时下一个弹匣的编号+1，0表示栈底
+    std::atomic<uint32_t> next{0};
+    uint32_t index = 0;
+    uint32_t count = 0;
+    void* rounds[kMaxRounds];
+};
+
+struct PoolCore;
+
+// 弹匣的无锁栈，栈顶是 (版本号 << 32) | (编号 + 1)
+class MagazineStack {
+public:
+    void Push(Magazine* magazine);
+    Magazine* Pop(PoolCore& core);
+
+private:
+    std::atomic<uint64_t> head_{0};
+};
+
+struct SizeClass {
+    size_t size = 0;
+    size_t rounds = 0;
+    size_t blocks_per_span = 0;
+
+    // 装有空闲块的弹匣和空弹匣
+    MagazineStack filled;
+    MagazineStack empty;
+
+    // 仓库中的空闲块数，以及上次Trim以来的最小值 (这部分一直没有被用到)
+    std::atomic<int64_t> depot_blocks{0};
+    std::atomic<int64_t> low_water{0};
+
+    // 切分新span和Trim时加锁，spans由该锁保护
+    std::mutex grow_mutex;
+    std::unordered_set<uintptr_t> spans;
+    std::atomic<uint64_t> span_count{0};
+    std::atomic<uint64_t> spans_released{0};
+};
+
+// 一个线程在一个内存池中的缓存
+struct ThreadCache {
+    std::array<Magazine*, kClassCount> loaded{};
+    std::array<Magazine*, kClassCount> previous{};
+    std::array<Counter, kClassCount> allocations;
+    std::array<Counter, kClassCount> deallocations;
+    // 线程退出后缓存保留在内存池中，计数继续有效，供新线程复用
+    bool active = false;
+};
+
+struct PoolCore : std::enable_shared_from_this<PoolCore> {
+    PoolCore();
+    ~PoolCore();
+
+    Magazine* GetMagazine(uint32_t index) {
+        return &magazine_chunks[index / kMagazinesPerChunk].load(std::memory_order_acquire)[index % kMagazinesPerChunk];
+    }
+
+    // 取一个空弹匣，没有时新建
+    Magazine* TakeEmpty(SizeClass& size_class);
+
+    void PushFilled(SizeClass& size_class, Magazine* magazine);
+    Magazine* PopFilled(SizeClass& size_class);
+
+    // 从仓库取一个装满的弹匣，仓库为空时切分新span
+    Magazine* Refill(SizeClass& size_class);
+
+    // 释放仓库中完全空闲的span，最多释放budget个块所在的span
+    size_t ReleaseSpans(SizeClass& size_class, int64_t budget);
+
+    ThreadCache* RegisterThread();
+    void RetireCache(ThreadCache* cache);
+
+    const uint32_t id;
+    std::array<SizeClass, kClassCount> classes;
+
+    std::array<std::atomic<Magazine*>, kMaxMagazineChunks> magazine_chunks{};
+    std::atomic<uint32_t> magazine_count{0};
+
+    // 保护caches和弹匣块的分配
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadCache>> caches;
+    // 线程本地数据销毁后 (线程退出过程中) 的分配和释放使用这个缓存
+    // 加锁顺序: orphan_mutex -> SizeClass::grow_mutex -> mutex
+    std::mutex orphan_mutex;
+    ThreadCache* orphan_cache = nullptr;
+
+    std::atomic<uint64_t> large_allocations{0};
+    std::atomic<uint64_t> large_deallocations{0};
+    std::atomic<uint64_t> large_bytes_allocated{0};
+    std::atomic<uint64_t> large_bytes_freed{0};
+};
+
+namespace {
+
+std::atomic<uint32_t> g_next_pool_id{0};
+
+// 线程在各个内存池中的缓存，按内存池编号索引；编号不复用
+struct ThreadSlot {
+    PoolCore* core = nullptr;
+    ThreadCache* cache = nullptr;
+    std::weak_ptr<PoolCore> owner;
+};
+
+thread_local bool t_slots_destroyed = false;
+
+struct ThreadSlots {
+    ~ThreadSlots() {
+        for (auto& slot : slots) {
+            if (auto owner = slot.owner.lock()) {
+                owner->RetireCache(slot.cache);
+            }
+        }
+        t_slots_destroyed = true;
+    }
+
+    std::vector<ThreadSlot> slots;
+};
+
+thread_local ThreadSlots t_slots;
+
+} // namespace
+
+void MagazineStack::Push(Magazine* magazine) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t desired;
+    do {
+        magazine->next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        desired = (((head >> 32) + 1) << 32) | (magazine->index + 1);
+    } while (!head_.compare_exchange_weak(head, desired, std::memory_order_release, std::memory_order_relaxed));
+}
+
+Magazine* MagazineStack::Pop(PoolCore& core) {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    while (true) {
+        auto top = static_cast<uint32_t>(head);
+        if (top == 0) {
+            return nullptr;
+        }
+        // 弹匣在内存池析构前不会释放，读到过期的next时版本号不同，CAS会失败
+        Magazine* magazine = core.GetMagazine(top - 1);
+        uint64_t desired = (((head >> 32) + 1) << 32) | magazine->next.load(std::memory_order_relaxed);
+        if (head_.compare_exchange_weak(head, desired, std::memory_order_acquire, std::memory_order_acquire)) {
+            return magazine;
+        }
     }
 }
 
-MemoryPool::~MemoryPool() {
-    for (auto* block : memory_blocks_) {
-        delete[] block;
+PoolCore::PoolCore() : id(g_next_pool_id.fetch_add(1, std::memory_order_relaxed)) {
+    for (size_t i = 0; i < kClassCount; ++i) {
+        auto& size_class = classes[i];
+        size_class.size = ClassSize(i);
+        size_class.rounds = std::clamp<size_t>(kMagazineBytes / size_class.size, 4, kMaxRounds);
+        size_class.blocks_per_span = MemoryPool::kSpanSize / size_class.size;
     }
 }
 
-void* MemoryPool::Allocate(size_t size) {
-    if (size > block_size_) {
+PoolCore::~PoolCore() {
+    uint64_t live_blocks = 0;
+    for (const auto& cache : caches) {
+        for (size_t i = 0; i < kClassCount; ++i) {
+            live_blocks += cache->allocations[i].Load() - cache->deallocations[i].Load();
+        }
+    }
+    if (live_blocks > 0) {
+        spdlog::error("MemoryPool destroyed with {} live blocks", live_blocks);
+    }
+
+    for (auto& size_class : classes) {
+        for (auto span : size_class.spans) {
+            UnmapSpan(span);
+        }
+    }
+    for (auto& chunk : magazine_chunks) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+Magazine* PoolCore::TakeEmpty(SizeClass& size_class) {
+    if (Magazine* magazine = size_class.empty.Pop(*this)) {
+        return magazine;
+    }
+
+    uint32_t index = magazine_count.fetch_add(1, std::memory_order_relaxed);
+    size_t chunk_index = index / kMagazinesPerChunk;
+    if (chunk_index >= kMaxMagazineChunks) {
+        throw std::bad_alloc();
+    }
+
+    if (!magazine_chunks[chunk_index].load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!magazine_chunks[chunk_index].load(std::memory_order_relaxed)) {
+            auto* chunk = new Magazine[kMagazinesPerChunk];
+            for (size_t i = 0; i < kMagazinesPerChunk; ++i) {
+                chunk[i].index = static_cast<uint32_t>(chunk_index * kMagazinesPerChunk + i);
+            }
+            magazine_chunks[chunk_index].store(chunk, std::memory_order_release);
+        }
+    }
+
+    Magazine* magazine = GetMagazine(index);
+    magazine->count = 0;
+    return magazine;
+}
+
+void PoolCore::PushFilled(SizeClass& size_class, Magazine* magazine) {
+    size_class.depot_blocks.fetch_add(magazine->count, std::memory_order_relaxed);
+    size_class.filled.Push(magazine);
+}
+
+Magazine* PoolCore::PopFilled(SizeClass& size_class) {
+    Magazine* magazine = size_class.filled.Pop(*this);
+    if (!magazine) {
+        return nullptr;
+    }
+
+    int64_t remaining = size_class.depot_blocks.fetch_sub(magazine->count, std::memory_order_relaxed) -
+                        static_cast<int64_t>(magazine->count);
+    int64_t low = size_class.low_water.load(std::memory_order_relaxed);
+    while (remaining < low &&
+           !size_class.low_water.compare_exchange_weak(low, remaining, std::memory_order_relaxed)) {
+    }
+    return magazine;
+}
+
+Magazine* PoolCore::Refill(SizeClass& size_class) {
+    if (Magazine* magazine = PopFilled(size_class)) {
+        return magazine;
+    }
+
+    std::lock_guard<std::mutex> lock(size_class.grow_mutex);
+    // 等锁期间可能已有其他线程切分了新span
+    if (Magazine* magazine = PopFilled(size_class)) {
+        return magazine;
+    }
+
+    void* span = MapSpan();
+    if (!span) {
         throw std::bad_alloc();
     }
-    
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (free_blocks_.empty()) {
-        AllocateNewBlock();
+    size_class.spans.insert(reinterpret_cast<uintptr_t>(span));
+    size_class.span_count.fetch_add(1, std::memory_order_relaxed);
+
+    // 第一个弹匣直接返回，其余放入仓库；从高地址向低地址装填，分配时先取低地址
+    auto* base = static_cast<std::byte*>(span);
+    Magazine* result = nullptr;
+    size_t block = size_class.blocks_per_span;
+    while (block > 0) {
+        Magazine* magazine = TakeEmpty(size_class);
+        while (block > 0 && magazine->count < size_class.rounds) {
+            --block;
+            magazine->rounds[magazine->count++] = base + block * size_class.size;
+        }
+        if (block == 0) {
+            result = magazine;
+        } else {
+            PushFilled(size_class, magazine);
+        }
     }
-    
-    void* ptr = free_blocks_.back();
-    free_blocks_.pop_back();
-    used_blocks_++;
-    
-    return ptr;
+    return result;
 }
 
-void MemoryPool::Deallocate(void* ptr) {
+size_t PoolCore::ReleaseSpans(SizeClass& size_class, int64_t budget) {
+    if (budget < static_cast<int64_t>(size_class.blocks_per_span)) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(size_class.grow_mutex);
+
+    // 取出仓库中的所有弹匣，按span统计空闲块；线程缓存中的块不在其中，所在span不会被释放
+    std::vector<Magazine*> magazines;
+    while (Magazine* magazine = PopFilled(size_class)) {
+        magazines.push_back(magazine);
+    }
+
+    std::unordered_map<uintptr_t, size_t> free_blocks;
+    for (auto* magazine : magazines) {
+        for (uint32_t i = 0; i < magazine->count; ++i) {
+            ++free_blocks[SpanOf(magazine->rounds[i])];
+        }
+    }
+
+    std::unordered_set<uintptr_t> released;
+    for (const auto& [span, count] : free_blocks) {
+        if (count == size_class.blocks_per_span && budget >= static_cast<int64_t>(count)) {
+            released.insert(span);
+            budget -= static_cast<int64_t>(count);
+        }
+    }
+
+    // 剩余的块重新装回弹匣放回仓库
+    std::vector<void*> blocks;
+    for (auto* magazine : magazines) {
+        for (uint32_t i = 0; i < magazine->count; ++i) {
+            if (!released.count(SpanOf(magazine->rounds[i]))) {
+                blocks.push_back(magazine->rounds[i]);
+            }
+        }
+        magazine->count = 0;
+    }
+    size_t next = 0;
+    for (auto* magazine : magazines) {
+        while (next < blocks.size() && magazine->count < size_class.rounds) {
+            magazine->rounds[magazine->count++] = blocks[next++];
+        }
+        if (magazine->count > 0) {
+            PushFilled(size_class, magazine);
+        } else {
+            size_class.empty.Push(magazine);
+        }
+    }
+
+    for (auto span : released) {
+        size_class.spans.erase(span);
+        UnmapSpan(span);
+    }
+    size_class.span_count.fetch_sub(released.size(), std::memory_order_relaxed);
+    size_class.spans_released.fetch_add(released.size(), std::memory_order_relaxed);
+    return released.size() * MemoryPool::kSpanSize;
+}
+
+ThreadCache* PoolCore::RegisterThread() {
+    ThreadCache* cache = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& candidate : caches) {
+            if (!candidate->active && candidate.get() != orphan_cache) {
+                cache = candidate.get();
+                break;
+            }
+        }
+        if (!cache) {
+            caches.push_back(std::make_unique<ThreadCache>());
+            cache = caches.back().get();
+        }
+        cache->active = true;
+    }
+
+    auto& slots = t_slots.slots;
+    if (slots.size() <= id) {
+        slots.resize(id + 1);
+    }
+    slots[id] = ThreadSlot{this, cache, weak_from_this()};
+    return cache;
+}
+
+void PoolCore::RetireCache(ThreadCache* cache) {
+    auto flush = [this](SizeClass& size_class, Magazine*& magazine) {
+        if (!magazine) {
+            return;
+        }
+        if (magazine->count > 0) {
+            PushFilled(size_class, magazine);
+        } else {
+            size_class.empty.Push(magazine);
+        }
+        magazine = nullptr;
+    };
+
+    for (size_t i = 0; i < kClassCount; ++i) {
+        flush(classes[i], cache->loaded[i]);
+        flush(classes[i], cache->previous[i]);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    cache->active = false;
+}
+
+} // namespace detail
+
+using detail::kClassCount;
+using detail::Magazine;
+using detail::PoolCore;
+using detail::ThreadCache;
+
+namespace {
+
+// 当前线程在core中的缓存；线程退出过程中返回nullptr，调用方改用加锁的orphan_cache
+ThreadCache* GetThreadCache(PoolCore& core) {
+    if (detail::t_slots_destroyed) {
+        return nullptr;
+    }
+    auto& slots = detail::t_slots.slots;
+    if (core.id < slots.size() && slots[core.id].core == &core) {
+        return slots[core.id].cache;
+    }
+    return core.RegisterThread();
+}
+
+void* AllocateFromCache(PoolCore& core, ThreadCache& cache, size_t index) {
+    auto& size_class = core.classes[index];
+    Magazine*& loaded = cache.loaded[index];
+    Magazine*& previous = cache.previous[index];
+
+    if (!loaded || loaded->count == 0) {
+        if (previous && previous->count > 0) {
+            std::swap(loaded, previous);
+        } else {
+            // 两个弹匣都空了：空弹匣还给仓库，换一个装满的
+            Magazine* full = core.Refill(size_class);
+            if (previous) {
+                size_class.empty.Push(previous);
+            }
+            previous = loaded;
+            loaded = full;
+        }
+    }
+
+    cache.allocations[index].Add(1);
+    return loaded->rounds[--loaded->count];
+}
+
+void DeallocateToCache(PoolCore& core, ThreadCache& cache, size_t index, void* ptr) {
+    auto& size_class = core.classes[index];
+    Magazine*& loaded = cache.loaded[index];
+    Magazine*& previous = cache.previous[index];
+
+    if (!loaded || loaded->count == size_class.rounds) {
+        if (previous && previous->count == 0) {
+            std::swap(loaded, previous);
+        } else {
+            // 两个弹匣都满了：满的交给仓库，换一个空的
+            Magazine* empty = core.TakeEmpty(size_class);
+            if (previous) {
+                core.PushFilled(size_class, previous);
+            }
+            previous = loaded;
+            loaded = empty;
+        }
+    }
+
+    cache.deallocations[index].Add(1);
+    loaded->rounds[loaded->count++] = ptr;
+}
+
+} // namespace
+
+uint64_t MemoryPoolClassStats::GetReservedBytes() const {
+    return spans * MemoryPool::kSpanSize;
+}
+
+uint64_t MemoryPoolStats::GetLiveBytes() const {
+    uint64_t bytes = large_live_bytes;
+    for (const auto& size_class : classes) {
+        bytes += size_class.GetLiveBytes();
+    }
+    return bytes;
+}
+
+uint64_t MemoryPoolStats::GetReservedBytes() const {
+    uint64_t bytes = large_live_bytes;
+    for (const auto& size_class : classes) {
+        bytes += size_class.GetReservedBytes();
+    }
+    return bytes;
+}
+
+MemoryPool::MemoryPool() : core_(std::make_shared<PoolCore>()) {
+    core_->orphan_cache = core_->caches.emplace_back(std::make_unique<ThreadCache>()).get();
+}
+
+MemoryPool::~MemoryPool() = default;
+
+MemoryPool& MemoryPool::GetInstance() {
+    // 不析构，线程本地缓存和静态对象析构时可能仍在释放内存
+    static MemoryPool* instance = new MemoryPool();
+    return *instance;
+}
+
+void* MemoryPool::Allocate(size_t size) {
+    if (size > kMaxBlockSize) {
+        core_->large_allocations.fetch_add(1, std::memory_order_relaxed);
+        core_->large_bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    size_t index = detail::ClassIndex(size);
+    if (ThreadCache* cache = GetThreadCache(*core_)) {
+        return AllocateFromCache(*core_, *cache, index);
+    }
+
+    std::lock_guard<std::mutex> lock(core_->orphan_mutex);
+    return AllocateFromCache(*core_, *core_->orphan_cache, index);
+}
+
+void MemoryPool::Deallocate(void* ptr, size_t size) noexcept {
     if (!ptr) {
         return;
     }
-    
-    std::lock_guard<std::mutex> lock(mutex_);
-    free_blocks_.push_back(ptr);
-    used_blocks_--;
+
+    if (size > kMaxBlockSize) {
+        core_->large_deallocations.fetch_add(1, std::memory_order_relaxed);
+        core_->large_bytes_freed.fetch_add(size, std::memory_order_relaxed);
+        ::operator delete(ptr, size);
+        return;
+    }
+
+    // 新建弹匣失败时抛出bad_alloc，释放路径无法处理，按noexcept终止
+    size_t index = detail::ClassIndex(size);
+    if (ThreadCache* cache = GetThreadCache(*core_)) {
+        return DeallocateToCache(*core_, *cache, index, ptr);
+    }
+
+    std::lock_guard<std::mutex> lock(core_->orphan_mutex);
+    DeallocateToCache(*core_, *core_->orphan_cache, index, ptr);
 }
 
-size_t MemoryPool::GetBlockSize() const {
-    return block_size_;
+size_t MemoryPool::Trim() {
+    size_t released = 0;
+    for (auto& size_class : core_->classes) {
+        // 低水位以下的块在整个周期内都没有被取走，属于闲置内存
+        int64_t idle = size_class.low_water.load(std::memory_order_relaxed);
+        released += core_->ReleaseSpans(size_class, idle);
+        size_class.low_water.store(size_class.depot_blocks.load(std::memory_order_relaxed),
+                                   std::memory_order_relaxed);
+    }
+
+    if (released > 0) {
+        spdlog::debug("MemoryPool trimmed {} bytes", released);
+    }
+    return released;
 }
 
-size_t MemoryPool::GetUsedBlocks() const {
-    return used_blocks_;
+size_t MemoryPool::ReleaseFreeMemory() {
+    size_t released = 0;
+    for (auto& size_class : core_->classes) {
+        released += core_->ReleaseSpans(size_class, INT64_MAX);
+        size_class.low_water.store(size_class.depot_blocks.load(std::memory_order_relaxed),
+                                   std::memory_order_relaxed);
+    }
+    return released;
 }
 
-size_t MemoryPool::GetFreeBlocks() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return free_blocks_.size();
+MemoryPoolStats MemoryPool::GetStats() const {
+    MemoryPoolStats stats;
+    stats.classes.resize(kClassCount);
+
+    {
+        std::lock_guard<std::mutex> lock(core_->mutex);
+        for (const auto& cache : core_->caches) {
+            for (size_t i = 0; i < kClassCount; ++i) {
+                stats.classes[i].allocations += cache->allocations[i].Load();
+                stats.classes[i].deallocations += cache->deallocations[i].Load();
+            }
+        }
+    }
+
+    for (size_t i = 0; i < kClassCount; ++i) {
+        auto& size_class = core_->classes[i];
+        auto& class_stats = stats.classes[i];
+        class_stats.block_size = size_class.size;
+        class_stats.depot_blocks =
+            static_cast<uint64_t>(std::max<int64_t>(0, size_class.depot_blocks.load(std::memory_order_relaxed)));
+        class_stats.spans = size_class.span_count.load(std::memory_order_relaxed);
+        class_stats.spans_released = size_class.spans_released.load(std::memory_order_relaxed);
+
+        // 线程缓存中的块数由总数推算，并发修改时是近似值
+        uint64_t total = class_stats.spans * size_class.blocks_per_span;
+        uint64_t accounted = class_stats.GetLiveBlocks() + class_stats.depot_blocks;
+        class_stats.cached_blocks = total > accounted ? total - accounted : 0;
+    }
+
+    stats.large_allocations = core_->large_allocations.load(std::memory_order_relaxed);
+    stats.large_deallocations = core_->large_deallocations.load(std::memory_order_relaxed);
+    stats.large_live_bytes = core_->large_bytes_allocated.load(std::memory_order_relaxed) -
+                             core_->large_bytes_freed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+size_t MemoryPool::GetBlockSize(size_t size) {
+    return size > kMaxBlockSize ? size : detail::ClassSize(detail::ClassIndex(size));
+}
+
+PoolResource* PoolResource::GetInstance() {
+    static PoolResource* instance = new PoolResource();
+    return instance;
 }
 
-size_t MemoryPool::GetTotalBlocks() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return memory_blocks_.size() * (block_size_ / sizeof(void*));
+void* PoolResource::do_allocate(size_t bytes, size_t alignment) {
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        return pool_->Allocate(bytes);
+    }
+    if (std::max(bytes, alignment) <= MemoryPool::kMaxBlockSize) {
+        return pool_->Allocate(std::max(bytes, alignment));
+    }
+    return ::operator new(bytes, std::align_val_t(alignment));
 }
 
-void MemoryPool::AllocateNewBlock() {
-    char* block = new char[block_size_ * 32];
-    memory_blocks_.push_back(block);
-    
-    for (size_t i = 0; i < 32; ++i) {
-        free_blocks_.push_back(block + i * block_size_);
+void PoolResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        return pool_->Deallocate(ptr, bytes);
+    }
+    if (std::max(bytes, alignment) <= MemoryPool::kMaxBlockSize) {
+        return pool_->Deallocate(ptr, std::max(bytes, alignment));
     }
+    ::operator delete(ptr, bytes, std::align_val_t(alignment));
+}
+
+bool PoolResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    auto* pool_resource = dynamic_cast<const PoolResource*>(&other);
+    return pool_resource && pool_resource->pool_ == pool_;
 }
 
-} // namespace ai_backend::core::memory
\ No newline at end of file
+} // namespace ai_backend::core::memory
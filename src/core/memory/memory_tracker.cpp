@@ -0,0 +1,372 @@
+#include "core/memory/memory_tracker.h"
+#include "core/memory/memory_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <thread>
+#include <fmt/format.h>
+
+#ifdef __linux__
+#include <execinfo.h>
+#endif
+
+namespace ai_backend::core::memory {
+
+namespace {
+
+constexpr const char* kTagNames[kMemoryTagCount] = {
+    "http", "websocket", "ratelimit", "db", "ai-stream", "cache"
+};
+
+// 采样地址表的探测长度，查找最多访问两条缓存行
+constexpr size_t kProbeLength = 16;
+
+static_assert((MemoryTracker::kMaxLiveSamples & (MemoryTracker::kMaxLiveSamples - 1)) == 0,
+              "kMaxLiveSamples must be a power of two");
+
+size_t SlotIndex(uintptr_t address) {
+    // 块至少16字节对齐，去掉低位后做乘法散列
+    return static_cast<size_t>(((address >> 4) * 0x9e3779b97f4a7c15ULL) >> 32) &
+           (MemoryTracker::kMaxLiveSamples - 1);
+}
+
+struct SamplerState {
+    bool initialized = false;
+    int64_t bytes_until_sample = 0;
+    std::minstd_rand rng;
+};
+
+thread_local SamplerState t_sampler;
+
+// 线程本地的计数，达到阈值或线程退出时合并到全局计数器
+struct LocalCounters {
+    int64_t live = 0;
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t allocated_bytes = 0;
+    uint32_t ops = 0;
+};
+
+struct LocalState {
+    std::array<LocalCounters, kMemoryTagCount> tags;
+
+    ~LocalState() {
+        MemoryTracker::GetInstance().Flush();
+    }
+};
+
+thread_local LocalState t_local;
+
+// 指数分布的采样间隔，使采样点构成泊松过程，pprof据此还原总量
+int64_t NextSampleInterval(SamplerState& state, size_t mean) {
+    std::exponential_distribution<double> distribution(1.0 / static_cast<double>(mean));
+    return std::max<int64_t>(1, static_cast<int64_t>(distribution(state.rng)));
+}
+
+} // namespace
+
+const char* GetMemoryTagName(MemoryTag tag) {
+    return kTagNames[static_cast<size_t>(tag)];
+}
+
+std::optional<MemoryTag> ParseMemoryTag(std::string_view name) {
+    for (size_t i = 0; i < kMemoryTagCount; ++i) {
+        if (name == kTagNames[i]) {
+            return static_cast<MemoryTag>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+MemoryTracker& MemoryTracker::GetInstance() {
+    // 不析构：静态对象析构期间仍可能有带标签的内存被释放
+    static MemoryTracker* instance = new MemoryTracker();
+    return *instance;
+}
+
+MemoryTracker::MemoryTracker()
+    : rate_updated_at_(std::chrono::steady_clock::now()),
+      sample_slots_(new std::atomic<uintptr_t>[kMaxLiveSamples]),
+      sample_records_(new LiveSample[kMaxLiveSamples]) {
+    for (size_t i = 0; i < kMaxLiveSamples; ++i) {
+        sample_slots_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+MemoryTracker::~MemoryTracker() = default;
+
+void MemoryTracker::RecordAllocation(MemoryTag tag, void* ptr, size_t bytes) {
+    auto index = static_cast<size_t>(tag);
+    auto& local = t_local.tags[index];
+    local.live += static_cast<int64_t>(bytes);
+    ++local.allocations;
+    local.allocated_bytes += bytes;
+    if (++local.ops >= kFlushOps || local.live >= kFlushBytes) {
+        FlushCounters(index, local.live, local.allocations, local.deallocations, local.allocated_bytes);
+        local = LocalCounters{};
+    }
+
+    if (sample_interval_.load(std::memory_order_relaxed) != 0 && ShouldSample(bytes)) {
+        RecordSample(tag, ptr, bytes);
+    }
+}
+
+void MemoryTracker::RecordDeallocation(MemoryTag tag, void* ptr, size_t bytes) {
+    auto index = static_cast<size_t>(tag);
+    auto& local = t_local.tags[index];
+    local.live -= static_cast<int64_t>(bytes);
+    ++local.deallocations;
+    if (++local.ops >= kFlushOps || local.live <= -kFlushBytes) {
+        FlushCounters(index, local.live, local.allocations, local.deallocations, local.allocated_bytes);
+        local = LocalCounters{};
+    }
+
+    if (live_samples_.load(std::memory_order_relaxed) != 0) {
+        RemoveSample(ptr);
+    }
+}
+
+void MemoryTracker::Flush() {
+    for (size_t i = 0; i < kMemoryTagCount; ++i) {
+        auto& local = t_local.tags[i];
+        if (local.ops != 0) {
+            FlushCounters(i, local.live, local.allocations, local.deallocations, local.allocated_bytes);
+            local = LocalCounters{};
+        }
+    }
+}
+
+void MemoryTracker::FlushCounters(size_t tag, int64_t live, uint64_t allocations, uint64_t deallocations,
+                                  uint64_t allocated_bytes) {
+    auto& counters = counters_[tag];
+    counters.allocations.fetch_add(allocations, std::memory_order_relaxed);
+    counters.deallocations.fetch_add(deallocations, std::memory_order_relaxed);
+    counters.allocated_bytes.fetch_add(allocated_bytes, std::memory_order_relaxed);
+
+    // 无符号回绕相当于减法
+    uint64_t current = counters.live_bytes.fetch_add(static_cast<uint64_t>(live), std::memory_order_relaxed) +
+                       static_cast<uint64_t>(live);
+    uint64_t peak = counters.peak_bytes.load(std::memory_order_relaxed);
+    while (live > 0 && current > peak &&
+           !counters.peak_bytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+}
+
+void MemoryTracker::UpdateRates() {
+    std::lock_guard<std::mutex> lock(rate_mutex_);
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - rate_updated_at_).count();
+    if (seconds <= 0.0) {
+        return;
+    }
+
+    for (size_t i = 0; i < kMemoryTagCount; ++i) {
+        uint64_t allocations = counters_[i].allocations.load(std::memory_order_relaxed);
+        uint64_t bytes = counters_[i].allocated_bytes.load(std::memory_order_relaxed);
+        allocations_per_second_[i] = static_cast<double>(allocations - last_allocations_[i]) / seconds;
+        bytes_per_second_[i] = static_cast<double>(bytes - last_allocated_bytes_[i]) / seconds;
+        last_allocations_[i] = allocations;
+        last_allocated_bytes_[i] = bytes;
+    }
+    rate_updated_at_ = now;
+}
+
+std::vector<MemoryTagStats> MemoryTracker::GetStats() const {
+    std::vector<MemoryTagStats> stats(kMemoryTagCount);
+    std::lock_guard<std::mutex> lock(rate_mutex_);
+    for (size_t i = 0; i < kMemoryTagCount; ++i) {
+        auto& tag_stats = stats[i];
+        tag_stats.tag = static_cast<MemoryTag>(i);
+        tag_stats.live_bytes = counters_[i].live_bytes.load(std::memory_order_relaxed);
+        tag_stats.peak_bytes = counters_[i].peak_bytes.load(std::memory_order_relaxed);
+        tag_stats.allocations = counters_[i].allocations.load(std::memory_order_relaxed);
+        tag_stats.deallocations = counters_[i].deallocations.load(std::memory_order_relaxed);
+        tag_stats.allocated_bytes = counters_[i].allocated_bytes.load(std::memory_order_relaxed);
+        tag_stats.bytes_per_second = bytes_per_second_[i];
+        tag_stats.allocations_per_second = allocations_per_second_[i];
+    }
+    return stats;
+}
+
+void MemoryTracker::ResetPeaks() {
+    for (auto& counters : counters_) {
+        counters.peak_bytes.store(counters.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+void MemoryTracker::SetSampleInterval(size_t bytes) {
+#ifdef __linux__
+    if (bytes != 0) {
+        // backtrace首次调用时会加载libgcc，先在普通上下文中调用一次
+        static std::once_flag once;
+        std::call_once(once, []() {
+            void* frame = nullptr;
+            backtrace(&frame, 1);
+        });
+    }
+#endif
+    if (bytes != 0) {
+        profile_interval_.store(bytes, std::memory_order_relaxed);
+    }
+    sample_interval_.store(bytes, std::memory_order_relaxed);
+}
+
+MemoryProfileStats MemoryTracker::GetProfileStats() const {
+    MemoryProfileStats stats;
+    stats.sample_interval = sample_interval_.load(std::memory_order_relaxed);
+    stats.samples = samples_.load(std::memory_order_relaxed);
+    stats.live_samples = live_samples_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool MemoryTracker::ShouldSample(size_t bytes) {
+    auto& state = t_sampler;
+    size_t interval = sample_interval_.load(std::memory_order_relaxed);
+    if (!state.initialized) {
+        state.rng.seed(static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+        state.bytes_until_sample = NextSampleInterval(state, interval);
+        state.initialized = true;
+    }
+
+    state.bytes_until_sample -= static_cast<int64_t>(bytes);
+    if (state.bytes_until_sample > 0) {
+        return false;
+    }
+    state.bytes_until_sample = NextSampleInterval(state, interval);
+    return true;
+}
+
+void MemoryTracker::RecordSample(MemoryTag tag, void* ptr, size_t bytes) {
+    StackKey key{tag, {}};
+#ifdef __linux__
+    // 第一帧是RecordSample自身
+    void* frames[kMaxStackDepth + 1];
+    int depth = backtrace(frames, static_cast<int>(kMaxStackDepth + 1));
+    if (depth > 1) {
+        key.frames.assign(frames + 1, frames + depth);
+    }
+#endif
+
+    auto address = reinterpret_cast<uintptr_t>(ptr);
+    size_t start = SlotIndex(address);
+    for (size_t i = 0; i < kProbeLength; ++i) {
+        size_t index = (start + i) & (kMaxLiveSamples - 1);
+        uintptr_t expected = 0;
+        if (!sample_slots_[index].compare_exchange_strong(expected, address, std::memory_order_acq_rel)) {
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(profile_mutex_);
+            auto stack = stacks_.try_emplace(std::move(key)).first;
+            auto& totals = stack->second;
+            ++totals.alloc_count;
+            totals.alloc_bytes += bytes;
+            ++totals.inuse_count;
+            totals.inuse_bytes += bytes;
+            sample_records_[index] = LiveSample{bytes, stack};
+        }
+        samples_.fetch_add(1, std::memory_order_relaxed);
+        live_samples_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryTracker::RemoveSample(void* ptr) {
+    auto address = reinterpret_cast<uintptr_t>(ptr);
+    size_t start = SlotIndex(address);
+    for (size_t i = 0; i < kProbeLength; ++i) {
+        size_t index = (start + i) & (kMaxLiveSamples - 1);
+        if (sample_slots_[index].load(std::memory_order_acquire) != address) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(profile_mutex_);
+        auto& record = sample_records_[index];
+        auto& totals = record.stack->second;
+        --totals.inuse_count;
+        totals.inuse_bytes -= record.bytes;
+        record = LiveSample{};
+        sample_slots_[index].store(0, std::memory_order_release);
+        live_samples_.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+}
+
+std::string MemoryTracker::DumpHeapProfile(std::optional<MemoryTag> tag) const {
+    std::string records;
+    StackTotals total;
+    {
+        std::lock_guard<std::mutex> lock(profile_mutex_);
+        for (const auto& [key, totals] : stacks_) {
+            if (tag && key.tag != *tag) {
+                continue;
+            }
+            total.alloc_count += totals.alloc_count;
+            total.alloc_bytes += totals.alloc_bytes;
+            total.inuse_count += totals.inuse_count;
+            total.inuse_bytes += totals.inuse_bytes;
+
+            fmt::format_to(std::back_inserter(records), "{:6}: {:8} [{:6}: {:8}] @",
+                           totals.inuse_count, totals.inuse_bytes, totals.alloc_count, totals.alloc_bytes);
+            for (void* frame : key.frames) {
+                fmt::format_to(std::back_inserter(records), " {:#x}", reinterpret_cast<uintptr_t>(frame));
+            }
+            records += '\n';
+        }
+    }
+
+    // gperftools的heap profile格式：计数是采样值，heap_v2/<间隔>告诉pprof按泊松采样还原
+    std::string profile = fmt::format("heap profile: {:6}: {:8} [{:6}: {:8}] @ heap_v2/{}\n",
+                                      total.inuse_count, total.inuse_bytes, total.alloc_count,
+                                      total.alloc_bytes, profile_interval_.load(std::memory_order_relaxed));
+    profile += records;
+
+    // pprof根据映射表把地址对应到可执行文件和共享库
+    profile += "\nMAPPED_LIBRARIES:\n";
+    std::ifstream maps("/proc/self/maps");
+    profile.append(std::istreambuf_iterator<char>(maps), std::istreambuf_iterator<char>());
+    return profile;
+}
+
+TrackedResource::TrackedResource(MemoryTag tag, std::pmr::memory_resource* upstream)
+    : tag_(tag),
+      upstream_(upstream ? upstream : PoolResource::GetInstance()),
+      tracker_(MemoryTracker::GetInstance()) {
+}
+
+TrackedResource* TrackedResource::ForTag(MemoryTag tag) {
+    static TrackedResource* resources[kMemoryTagCount] = {
+        new TrackedResource(MemoryTag::kHttp),
+        new TrackedResource(MemoryTag::kWebSocket),
+        new TrackedResource(MemoryTag::kRateLimit),
+        new TrackedResource(MemoryTag::kDb),
+        new TrackedResource(MemoryTag::kAiStream),
+        new TrackedResource(MemoryTag::kCache),
+    };
+    return resources[static_cast<size_t>(tag)];
+}
+
+void* TrackedResource::do_allocate(size_t bytes, size_t alignment) {
+    void* ptr = upstream_->allocate(bytes, alignment);
+    tracker_.RecordAllocation(tag_, ptr, bytes);
+    return ptr;
+}
+
+void TrackedResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+    // 先移除采样记录，地址归还后可能立即被其他线程重新分配和采样
+    tracker_.RecordDeallocation(tag_, ptr, bytes);
+    upstream_->deallocate(ptr, bytes, alignment);
+}
+
+bool TrackedResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    auto* tracked = dynamic_cast<const TrackedResource*>(&other);
+    return tracked && tracked->tag_ == tag_ && tracked->upstream_->is_equal(*upstream_);
+}
+
+} // namespace ai_backend::core::memory
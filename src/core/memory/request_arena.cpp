@@ -0,0 +1,90 @@
+#include "core/memory/request_arena.h"
+#include "core/memory/memory_pool.h"
+
+namespace ai_backend::core::memory {
+
+namespace {
+
+std::atomic<uint64_t> g_requests{0};
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_bytes{0};
+std::atomic<uint64_t> g_overflows{0};
+
+} // namespace
+
+RequestArena::RequestArena(size_t initial_size, std::pmr::memory_resource* upstream)
+    : upstream_(upstream ? upstream : PoolResource::GetInstance()),
+      initial_size_(initial_size),
+      initial_buffer_(upstream_->allocate(initial_size_)),
+      resource_(initial_buffer_, initial_size_, upstream_) {
+}
+
+RequestArena::~RequestArena() {
+    resource_.release();
+    upstream_->deallocate(initial_buffer_, initial_size_);
+}
+
+void RequestArena::Reset() {
+    if (allocations_ > 0) {
+        g_allocations.fetch_add(allocations_, std::memory_order_relaxed);
+        g_bytes.fetch_add(bytes_, std::memory_order_relaxed);
+        if (bytes_ > initial_size_) {
+            g_overflows.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    g_requests.fetch_add(1, std::memory_order_relaxed);
+
+    // release把后续申请的块还给上游，下一次分配重新从初始缓冲区开始
+    resource_.release();
+    allocations_ = 0;
+    bytes_ = 0;
+}
+
+RequestArenaStats RequestArena::GetStats() {
+    return {
+        g_requests.load(std::memory_order_relaxed),
+        g_allocations.load(std::memory_order_relaxed),
+        g_bytes.load(std::memory_order_relaxed),
+        g_overflows.load(std::memory_order_relaxed)
+    };
+}
+
+void* RequestArena::do_allocate(size_t bytes, size_t alignment) {
+    ++allocations_;
+    bytes_ += bytes;
+    return resource_.allocate(bytes, alignment);
+}
+
+void RequestArena::do_deallocate(void*, size_t, size_t) {
+    // 单调分配，内存在Reset时统一回收
+}
+
+bool RequestArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+RequestArenaSlot::Lease::~Lease() {
+    if (arena_) {
+        slot_->Return(arena_);
+    }
+}
+
+RequestArenaSlot::~RequestArenaSlot() {
+    delete spare_.load(std::memory_order_acquire);
+}
+
+RequestArenaSlot::Lease RequestArenaSlot::Acquire() {
+    RequestArena* arena = spare_.exchange(nullptr, std::memory_order_acquire);
+    if (!arena) {
+        arena = new RequestArena(initial_size_, upstream_);
+    }
+    return Lease(*this, arena);
+}
+
+void RequestArenaSlot::Return(RequestArena* arena) noexcept {
+    arena->Reset();
+    // 槽位已被并发借出的另一个arena占用时保留一个即可
+    delete spare_.exchange(arena, std::memory_order_acq_rel);
+}
+
+} // namespace ai_backend::core::memory
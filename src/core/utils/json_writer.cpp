@@ -0,0 +1,115 @@
+#include "core/utils/json_writer.h"
+#include <charconv>
+
+namespace ai_backend::core::utils {
+
+JsonWriter& JsonWriter::BeginObject() {
+    BeginValue();
+    out_ += '{';
+    need_comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndObject() {
+    out_ += '}';
+    need_comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::BeginArray() {
+    BeginValue();
+    out_ += '[';
+    need_comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndArray() {
+    out_ += ']';
+    need_comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::Key(std::string_view key) {
+    BeginValue();
+    out_ += '"';
+    AppendEscaped(out_, key);
+    out_ += "\":";
+    need_comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::String(std::string_view value) {
+    BeginValue();
+    out_ += '"';
+    AppendEscaped(out_, value);
+    out_ += '"';
+    return *this;
+}
+
+JsonWriter& JsonWriter::Int(int64_t value) {
+    BeginValue();
+    char buffer[24];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out_.append(buffer, end);
+    return *this;
+}
+
+JsonWriter& JsonWriter::Uint(uint64_t value) {
+    BeginValue();
+    char buffer[24];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out_.append(buffer, end);
+    return *this;
+}
+
+JsonWriter& JsonWriter::Bool(bool value) {
+    BeginValue();
+    out_ += value ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::Null() {
+    BeginValue();
+    out_ += "null";
+    return *this;
+}
+
+void JsonWriter::AppendEscaped(std::string& out, std::string_view value) {
+    static constexpr char kHex[] = "0123456789abcdef";
+
+    // 不需要转义的连续片段整段追加
+    size_t start = 0;
+    for (size_t i = 0; i < value.size(); ++i) {
+        auto c = static_cast<unsigned char>(value[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        out.append(value.data() + start, i - start);
+        start = i + 1;
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += kHex[c >> 4];
+                out += kHex[c & 0xf];
+                break;
+        }
+    }
+    out.append(value.data() + start, value.size() - start);
+}
+
+void JsonWriter::BeginValue() {
+    if (need_comma_) {
+        out_ += ',';
+    }
+    need_comma_ = true;
+}
+
+} // namespace ai_backend::core::utils
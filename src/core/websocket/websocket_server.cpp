@@ -3,17 +3,12 @@
 
 namespace ai_backend::core::websocket {
 
-WebSocketServer::WebSocketServer(uint16_t port, size_t thread_count)
+WebSocketServer::WebSocketServer(uint16_t port, async::Runtime& runtime)
     : port_(port),
-      thread_count_(thread_count),
+      runtime_(runtime),
       running_(false),
       active_connections_(0),
-      io_context_(),
-      acceptor_(io_context_) {
-    
-    if (thread_count_ == 0) {
-        thread_count_ = std::thread::hardware_concurrency();
-    }
+      acceptor_(runtime.GetIoContext()) {
 }
 
 WebSocketServer::~WebSocketServer() {
@@ -26,25 +21,12 @@ void WebSocketServer::Start() {
     }
     
     try {
-        work_guard_.emplace(net::make_work_guard(io_context_));
-        
         tcp::endpoint endpoint(tcp::v4(), port_);
         acceptor_.open(endpoint.protocol());
         acceptor_.set_option(net::socket_base::reuse_address(true));
         acceptor_.bind(endpoint);
         acceptor_.listen(net::socket_base::max_listen_connections);
         
-        worker_threads_.reserve(thread_count_);
-        for (size_t i = 0; i < thread_count_; ++i) {
-            worker_threads_.emplace_back([this]() {
-                try {
-                    io_context_.run();
-                } catch (const std::exception& e) {
-                    spdlog::error("Exception in WebSocket server worker thread: {}", e.what());
-                }
-            });
-        }
-        
         running_ = true;
         
         AcceptConnection();
@@ -67,26 +49,16 @@ void WebSocketServer::Stop() {
     beast::error_code ec;
     acceptor_.close(ec);
     
-    if (work_guard_) {
-        work_guard_.reset();
-    }
-    
-    io_context_.stop();
-    
-    for (auto& thread : worker_threads_) {
-        if (thread.joinable()) {
-            thread.join();
-        }
+    // IO线程属于Runtime，会话各自在strand上关闭
+    std::vector<std::shared_ptr<WebSocketSession>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        sessions.swap(sessions_);
     }
-    
-    worker_threads_.clear();
-    
-    for (auto& session : sessions_) {
+    for (auto& session : sessions) {
         session->Close();
     }
     
-    sessions_.clear();
-    
     spdlog::info("WebSocket server stopped");
 }
 
@@ -133,33 +105,41 @@ void WebSocketServer::AcceptConnection() {
         return;
     }
     
+    // 每个连接一个strand，读写处理器和写协程不会在多个IO线程上并发执行；
+    // 分片模式下连接轮流分给各io_context
     acceptor_.async_accept(
-        [this](beast::error_code ec, tcp::socket socket) {
+        net::make_strand(runtime_.NextIoContext()),
+        [self = shared_from_this()](beast::error_code ec, tcp::socket socket) {
             if (ec) {
-                if (ec != net::error::operation_aborted && running_) {
+                if (ec != net::error::operation_aborted && self->running_) {
                     spdlog::error("WebSocket accept error: {}", ec.message());
                 }
             } else {
-                active_connections_++;
+                self->active_connections_++;
                 
+                // 会话可能比服务器存活更久，只持有弱引用
                 auto session = std::make_shared<WebSocketSession>(
                     std::move(socket), 
-                    message_handler_,
-                    connection_handler_,
-                    close_handler_,
-                    [this](const std::string& client_id) { RemoveSession(client_id); }
+                    self->message_handler_,
+                    self->connection_handler_,
+                    self->close_handler_,
+                    [weak = self->weak_from_this()](const std::string& client_id) {
+                        if (auto server = weak.lock()) {
+                            server->RemoveSession(client_id);
+                        }
+                    }
                 );
                 
                 {
-                    std::lock_guard<std::mutex> lock(sessions_mutex_);
-                    sessions_.push_back(session);
+                    std::lock_guard<std::mutex> lock(self->sessions_mutex_);
+                    self->sessions_.push_back(session);
                 }
                 
                 session->Start();
             }
             
-            if (running_) {
-                AcceptConnection();
+            if (self->running_) {
+                self->AcceptConnection();
             }
         });
 }
@@ -1,9 +1,43 @@
 #include "core/websocket/websocket_session.h"
+#include "core/memory/memory_tracker.h"
 #include "core/utils/uuid.h"
 #include <spdlog/spdlog.h>
 
 namespace ai_backend::core::websocket {
 
+namespace {
+
+// 与beast为服务端建议的超时一致
+constexpr std::chrono::seconds kHandshakeTimeout{30};
+constexpr std::chrono::seconds kIdleTimeout{300};
+
+// 每个连接最多排队的待发送消息数
+constexpr size_t kSendQueueCapacity = 1024;
+
+// 在协程中等待beast的异步写入或关闭，完成处理器在会话的strand上运行
+template <typename Initiate>
+struct OperationAwaiter {
+    Initiate initiate;
+    beast::error_code ec;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        initiate([this, handle, executor = core::async::CurrentExecutor()](beast::error_code result, std::size_t = 0) {
+            ec = result;
+            core::async::ExecutorScope executor_scope(executor);
+            handle.resume();
+        });
+    }
+    beast::error_code await_resume() const noexcept { return ec; }
+};
+
+template <typename Initiate>
+OperationAwaiter<Initiate> AwaitOperation(Initiate initiate) {
+    return OperationAwaiter<Initiate>{std::move(initiate), {}};
+}
+
+} // namespace
+
 WebSocketSession::WebSocketSession(
     tcp::socket&& socket,
     MessageHandler message_handler,
@@ -11,18 +45,22 @@ WebSocketSession::WebSocketSession(
     CloseHandler close_handler,
     DisconnectHandler disconnect_handler)
     : ws_(std::move(socket)),
+      buffer_(memory::TrackedResource::ForTag(memory::MemoryTag::kWebSocket)),
       message_handler_(std::move(message_handler)),
       connection_handler_(std::move(connection_handler)),
       close_handler_(std::move(close_handler)),
       disconnect_handler_(std::move(disconnect_handler)),
+      outgoing_(kSendQueueCapacity, ws_.get_executor()),
       client_id_(core::utils::UuidGenerator::GenerateUuid()),
-      closed_(false) {
+      closed_(false),
+      wheel_(core::async::TimerWheel::For(ws_.get_executor())) {
     
-    ws_.set_option(
-        websocket::stream_base::timeout::suggested(
-            beast::role_type::server
-        )
-    );
+    // 超时由时间轮处理，关闭beast内置的定时器
+    websocket::stream_base::timeout timeout_option{};
+    timeout_option.handshake_timeout = websocket::stream_base::none();
+    timeout_option.idle_timeout = websocket::stream_base::none();
+    timeout_option.keep_alive_pings = false;
+    ws_.set_option(timeout_option);
     
     ws_.set_option(websocket::stream_base::decorator(
         [](websocket::response_type& res) {
@@ -36,6 +74,13 @@ WebSocketSession::~WebSocketSession() {
 }
 
 void WebSocketSession::Start() {
+    idle_timer_.SetCallback([weak = weak_from_this()]() {
+        if (auto self = weak.lock()) {
+            net::post(self->ws_.get_executor(), [self]() { self->OnIdleTimeout(); });
+        }
+    });
+    wheel_.Schedule(idle_timer_, kHandshakeTimeout);
+    
     ws_.async_accept(
         beast::bind_front_handler(
             &WebSocketSession::OnAccept,
@@ -50,6 +95,10 @@ void WebSocketSession::OnAccept(beast::error_code ec) {
     }
     
     spdlog::info("WebSocket connection established: {}", client_id_);
+    wheel_.Schedule(idle_timer_, kIdleTimeout);
+    
+    accepted_ = true;
+    core::async::Spawn(ws_.get_executor(), WriteLoop(shared_from_this()));
     
     if (connection_handler_) {
         connection_handler_(client_id_);
@@ -84,6 +133,8 @@ void WebSocketSession::OnRead(beast::error_code ec, std::size_t bytes_transferre
         return HandleError(ec, "read");
     }
     
+    wheel_.Schedule(idle_timer_, kIdleTimeout);
+    
     std::string message = beast::buffers_to_string(buffer_.data());
     buffer_.consume(buffer_.size());
     
@@ -101,78 +152,57 @@ bool WebSocketSession::Send(const std::string& message) {
         return false;
     }
     
-    try {
-        std::lock_guard<std::mutex> lock(write_mutex_);
-        ws_.write(net::buffer(message));
-        return true;
-    } catch (const std::exception& e) {
-        spdlog::error("Failed to send WebSocket message: {}", e.what());
+    std::pmr::string queued(message, memory::TrackedResource::ForTag(memory::MemoryTag::kWebSocket));
+    if (!outgoing_.TrySend(std::move(queued))) {
+        if (!outgoing_.IsClosed()) {
+            spdlog::warn("WebSocket send queue full, dropping message for {}", client_id_);
+        }
         return false;
     }
+    return true;
 }
 
 void WebSocketSession::AsyncSend(const std::string& message) {
-    if (closed_) {
-        return;
-    }
-    
-    auto self = shared_from_this();
-    
-    net::post(
-        ws_.get_executor(),
-        [self, message]() {
-            std::lock_guard<std::mutex> lock(self->write_mutex_);
-            self->outgoing_messages_.push_back(message);
-            
-            if (self->outgoing_messages_.size() == 1) {
-                self->WriteMessage();
-            }
-        }
-    );
+    Send(message);
 }
 
-void WebSocketSession::WriteMessage() {
-    if (closed_ || outgoing_messages_.empty()) {
-        return;
-    }
-    
-    auto self = shared_from_this();
-    
-    ws_.async_write(
-        net::buffer(outgoing_messages_.front()),
-        [self](beast::error_code ec, std::size_t bytes_transferred) {
-            self->OnWrite(ec, bytes_transferred);
+core::async::Task<void> WebSocketSession::WriteLoop(std::shared_ptr<WebSocketSession> self) {
+    // 同一时刻只有这一个写操作，读和写都在会话的strand上发起
+    while (auto message = co_await self->outgoing_.Receive()) {
+        auto write = AwaitOperation([&](auto handler) {
+            self->ws_.async_write(net::buffer(*message), std::move(handler));
+        });
+        if (auto ec = co_await write) {
+            self->HandleError(ec, "write");
+            co_return;
         }
-    );
-}
-
-void WebSocketSession::OnWrite(beast::error_code ec, std::size_t bytes_transferred) {
-    boost::ignore_unused(bytes_transferred);
-    
-    if (ec) {
-        return HandleError(ec, "write");
     }
     
-    std::lock_guard<std::mutex> lock(write_mutex_);
-    outgoing_messages_.pop_front();
-    
-    if (!outgoing_messages_.empty()) {
-        WriteMessage();
+    // 已排队的消息全部写出后发送关闭帧；对端先关闭或连接已断开时会失败，忽略即可
+    auto close = AwaitOperation([&](auto handler) {
+        self->ws_.async_close(websocket::close_code::normal, std::move(handler));
+    });
+    if (auto ec = co_await close) {
+        spdlog::debug("WebSocket close for {}: {}", self->client_id_, ec.message());
     }
 }
 
 void WebSocketSession::Close() {
-    if (closed_) {
+    if (closed_.exchange(true)) {
         return;
     }
     
-    closed_ = true;
-    
-    beast::error_code ec;
-    ws_.close(websocket::close_code::normal, ec);
+    wheel_.Cancel(idle_timer_);
     
-    if (ec) {
-        spdlog::error("Error closing WebSocket connection: {}", ec.message());
+    // 写协程写完剩余消息后异步发送关闭帧；握手尚未完成时直接关闭socket
+    outgoing_.Close();
+    if (!accepted_) {
+        if (auto self = weak_from_this().lock()) {
+            net::post(ws_.get_executor(), [self]() {
+                beast::error_code ec;
+                beast::get_lowest_layer(self->ws_).close(ec);
+            });
+        }
     }
     
     if (disconnect_handler_) {
@@ -181,11 +211,12 @@ void WebSocketSession::Close() {
 }
 
 void WebSocketSession::HandleClose() {
-    if (closed_) {
+    if (closed_.exchange(true)) {
         return;
     }
     
-    closed_ = true;
+    wheel_.Cancel(idle_timer_);
+    outgoing_.Close();
     
     spdlog::info("WebSocket connection closed: {}", client_id_);
     
@@ -208,6 +239,18 @@ void WebSocketSession::HandleError(beast::error_code ec, const char* what) {
     Close();
 }
 
+void WebSocketSession::OnIdleTimeout() {
+    if (closed_) {
+        return;
+    }
+    
+    spdlog::info("WebSocket connection timed out: {}", client_id_);
+    
+    // 直接关闭底层socket，未完成的读取以operation_aborted结束
+    beast::error_code ec;
+    beast::get_lowest_layer(ws_).close(ec);
+}
+
 std::string WebSocketSession::GetClientId() const {
     return client_id_;
 }
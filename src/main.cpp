@@ -2,10 +2,15 @@
 #include <signal.h>
 #include <spdlog/spdlog.h>
 
+#include "core/async/event_loop.h"
+#include "core/async/runtime.h"
 #include "core/config/config_manager.h"
 #include "core/http/http_server.h"
 #include "core/http/router.h"
+#include "core/http/upstream_client.h"
 #include "core/db/connection_pool.h"
+#include "core/memory/memory_pool.h"
+#include "core/memory/memory_tracker.h"
 #include "api/routes/api_router.h"
 #include "services/ai/model_service.h"
 
@@ -61,6 +66,29 @@ int main(int argc, char* argv[]) {
             spdlog::set_level(spdlog::level::critical);
         }
         
+        // 启动运行时，IO线程、阻塞任务池和CPU任务池都在这里创建，其他子系统从中获取executor
+        ai_backend::core::async::RuntimeOptions runtime_options;
+        runtime_options.io_threads = static_cast<size_t>(config.GetInt("runtime.io_threads", 0));
+        runtime_options.io_mode = ai_backend::core::async::RuntimeOptions::ParseIoMode(
+            config.GetString("runtime.io_mode", "shared"));
+        runtime_options.blocking_threads = static_cast<size_t>(config.GetInt("runtime.blocking_threads", 8));
+        runtime_options.cpu_threads = static_cast<size_t>(config.GetInt("runtime.cpu_threads", 0));
+        runtime_options.pin_threads = config.GetBool("runtime.pin_threads", false);
+        runtime_options.numa_aware = config.GetBool("runtime.numa_aware", false);
+        runtime_options.watchdog.enabled = config.GetBool("runtime.watchdog.enabled", true);
+        runtime_options.watchdog.probe_interval =
+            std::chrono::milliseconds(config.GetInt("runtime.watchdog.probe_interval_ms", 100));
+        runtime_options.watchdog.threshold =
+            std::chrono::milliseconds(config.GetInt("runtime.watchdog.threshold_ms", 50));
+        runtime_options.watchdog.stack_samples_per_minute =
+            static_cast<size_t>(config.GetInt("runtime.watchdog.stack_samples_per_minute", 6));
+        runtime_options.watchdog.report_interval =
+            std::chrono::seconds(config.GetInt("runtime.watchdog.report_interval", 60));
+        
+        auto& runtime = ai_backend::core::async::Runtime::GetInstance();
+        runtime.Configure(runtime_options);
+        runtime.Start();
+        
         // 初始化数据库连接池
         std::string db_connection_string = config.GetString("database.connection_string", "");
         if (db_connection_string.empty()) {
@@ -69,6 +97,8 @@ int main(int argc, char* argv[]) {
         }
         
         auto& db_pool = ai_backend::core::db::ConnectionPool::GetInstance();
+        db_pool.SetAcquireTimeout(
+            std::chrono::milliseconds(config.GetInt("database.acquire_timeout_ms", 5000)));
         if (!db_pool.Initialize(db_connection_string, 
                               config.GetInt("database.min_connections", 5),
                               config.GetInt("database.max_connections", 20))) {
@@ -78,6 +108,40 @@ int main(int argc, char* argv[]) {
         
         spdlog::info("Database connection pool initialized");
         
+        // 启动事件循环，上游HTTP客户端的套接字和定时器运行在运行时的第0个io_context上
+        ai_backend::core::async::EventLoop::GetInstance().ConfigureQueue(
+            static_cast<size_t>(config.GetInt("runtime.max_pending_tasks", 10000)),
+            std::chrono::milliseconds(config.GetInt("server.admission.target_ms", 50)),
+            std::chrono::milliseconds(config.GetInt("server.admission.interval_ms", 500)));
+        ai_backend::core::async::EventLoop::GetInstance().Start();
+        spdlog::info("Event loop started");
+        
+        // 定期把内存池中闲置的span归还给操作系统
+        auto memory_trim_interval = std::chrono::seconds(config.GetInt("memory.trim_interval", 30));
+        if (memory_trim_interval.count() > 0) {
+            ai_backend::core::async::EventLoop::GetInstance().ScheduleRecurring(
+                memory_trim_interval, []() { ai_backend::core::memory::MemoryPool::GetInstance().Trim(); });
+        }
+        
+        // 按子系统的内存记账：定期计算分配速率，按配置的平均间隔采样分配调用栈
+        auto& memory_tracker = ai_backend::core::memory::MemoryTracker::GetInstance();
+        memory_tracker.SetSampleInterval(
+            static_cast<size_t>(config.GetInt("memory.profile_sample_interval", 512 * 1024)));
+        auto memory_stats_interval = std::chrono::seconds(config.GetInt("memory.stats_interval", 10));
+        if (memory_stats_interval.count() > 0) {
+            ai_backend::core::async::EventLoop::GetInstance().ScheduleRecurring(
+                memory_stats_interval, [&memory_tracker]() { memory_tracker.UpdateRates(); });
+        }
+        
+        // 配置上游连接管理
+        ai_backend::core::http::UpstreamOptions upstream_options;
+        upstream_options.max_host_connections = config.GetInt("upstream.max_host_connections", 16);
+        upstream_options.max_cached_connections = config.GetInt("upstream.max_cached_connections", 64);
+        upstream_options.dns_cache_timeout = config.GetInt("upstream.dns_cache_timeout", 300);
+        upstream_options.enable_http2 = config.GetBool("upstream.enable_http2", true);
+        upstream_options.tcp_keepalive_interval = config.GetInt("upstream.tcp_keepalive_interval", 60);
+        ai_backend::core::http::UpstreamClient::GetInstance().Configure(upstream_options);
+        
         // 初始化模型服务
         ai_backend::services::ai::ModelService::GetInstance().Initialize();
         spdlog::info("AI Model service initialized");
@@ -87,11 +151,39 @@ int main(int argc, char* argv[]) {
         router->Initialize();
         spdlog::info("API router initialized");
         
+        // 配置准入控制，路由类别按列出的顺序匹配
+        ai_backend::core::http::AdmissionOptions admission_options;
+        admission_options.enabled = config.GetBool("server.admission.enabled", true);
+        admission_options.target = std::chrono::milliseconds(config.GetInt("server.admission.target_ms", 50));
+        admission_options.interval = std::chrono::milliseconds(config.GetInt("server.admission.interval_ms", 500));
+        admission_options.max_queue_time =
+            std::chrono::milliseconds(config.GetInt("server.admission.max_queue_time_ms", 1000));
+        admission_options.retry_after = std::chrono::seconds(config.GetInt("server.admission.retry_after", 1));
+        admission_options.max_connections =
+            static_cast<size_t>(config.GetInt("server.admission.max_connections", 0));
+        for (const auto& name : config.GetStringList("server.admission.classes")) {
+            std::string prefix = "server.admission." + name + ".";
+            admission_options.classes.push_back({
+                name,
+                config.GetStringList(prefix + "patterns"),
+                static_cast<size_t>(config.GetInt(prefix + "max_in_flight", 0)),
+                static_cast<size_t>(config.GetInt(prefix + "max_queue", 0))
+            });
+        }
+        admission_options.default_class.max_in_flight =
+            static_cast<size_t>(config.GetInt("server.admission.default.max_in_flight", 0));
+        admission_options.default_class.max_queue =
+            static_cast<size_t>(config.GetInt("server.admission.default.max_queue", 0));
+        ai_backend::core::http::AdmissionController::GetInstance().Configure(admission_options);
+        spdlog::info("Admission control {}: {} route class(es), target {}ms",
+                     admission_options.enabled ? "enabled" : "disabled",
+                     admission_options.classes.size() + 1, admission_options.target.count());
+        
         // 创建HTTP服务器
         uint16_t port = static_cast<uint16_t>(config.GetInt("server.port", 8080));
-        size_t thread_count = static_cast<size_t>(config.GetInt("server.threads", 0));
-        
-        g_http_server = std::make_shared<ai_backend::core::http::HttpServer>(port, thread_count);
+        g_http_server = std::make_shared<ai_backend::core::http::HttpServer>(port, runtime);
+        g_http_server->SetMaxRequestTimeout(
+            std::chrono::milliseconds(config.GetInt("server.max_request_timeout_ms", 600000)));
         g_http_server->SetRouter(router);
         
         // 设置信号处理
@@ -102,7 +194,7 @@ int main(int argc, char* argv[]) {
         spdlog::info("Starting HTTP server on port {}", port);
         g_http_server->Start();
         
-        // 主线程等待，实际工作由工作线程池处理
+        // 主线程等待，实际工作由运行时的IO线程处理
         std::string cmd;
         spdlog::info("Server running. Press 'q' to quit.");
         while (std::cin >> cmd) {
@@ -114,6 +206,9 @@ int main(int argc, char* argv[]) {
         // 停止服务器
         spdlog::info("Shutting down server...");
         g_http_server->Stop();
+        ai_backend::core::async::EventLoop::GetInstance().Stop();
+        ai_backend::core::db::ConnectionPool::GetInstance().CloseAll();
+        runtime.Stop();
         
         spdlog::info("Server shutdown complete");
         return 0;
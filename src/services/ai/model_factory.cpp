@@ -1,6 +1,8 @@
 #include "services/ai/model_factory.h"
 #include "services/ai/models/deepseek_r1_model.h"
 #include "services/ai/models/deepseek_v3_model.h"
+#include "core/config/config_manager.h"
+#include "core/http/upstream_client.h"
 #include <spdlog/spdlog.h>
 
 namespace ai_backend::services::ai {
@@ -35,6 +37,26 @@ void ModelFactory::Initialize() {
     for (const auto& model : available_models_) {
         spdlog::info("Available model: {}", model);
     }
+    
+    PrewarmConnections();
+}
+
+void ModelFactory::PrewarmConnections() {
+    // 提前建立到DeepSeek API的TLS连接，第一条回复不再承担DNS/TCP/TLS握手
+    auto& config = core::config::ConfigManager::GetInstance();
+    int connections = config.GetInt("ai.deepseek.prewarm_connections", 2);
+    std::string api_key = config.GetString("ai.deepseek.api_key", "");
+    if (connections <= 0 || api_key.empty()) {
+        return;
+    }
+    
+    core::http::UpstreamRequest request;
+    request.method = "GET";
+    request.url = config.GetString("ai.deepseek.base_url", "https://api.deepseek.com/v1") + "/models";
+    request.headers = {{"Authorization", "Bearer " + api_key}};
+    request.timeout = std::chrono::seconds(10);
+    
+    core::http::UpstreamClient::GetInstance().Prewarm(request, static_cast<size_t>(connections));
 }
 
 template <typename ModelType>
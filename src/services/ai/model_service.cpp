@@ -1,4 +1,5 @@
 #include "services/ai/model_service.h"
+#include "services/ai/tokenizer/tokenizer.h"
 #include <spdlog/spdlog.h>
 
 namespace ai_backend::services::ai {
@@ -11,6 +12,9 @@ ModelService& ModelService::GetInstance() {
 }
 
 void ModelService::Initialize() {
+    // 加载分词器，用于token计数和上下文预算
+    tokenizer::Tokenizer::GetInstance().Initialize();
+    
     // 初始化模型工厂
     ModelFactory::GetInstance().Initialize();
 }
@@ -50,24 +54,24 @@ std::vector<ModelService::ModelInfo> ModelService::GetAllModelsInfo() const {
     return result;
 }
 
-Task<common::Result<std::string>> 
+Task<common::Result<ModelReply>> 
 ModelService::GenerateResponse(const std::string& model_id,
                             const std::vector<models::Message>& messages,
                             const ModelInterface::ModelConfig& config) {
     auto model = GetOrCreateModel(model_id);
     if (!model) {
-        co_return common::Result<std::string>::Error("Model not found: " + model_id);
+        co_return common::Result<ModelReply>::Error("Model not found: " + model_id);
     }
     
     if (!model->IsHealthy()) {
-        co_return common::Result<std::string>::Error("Model is not healthy: " + model_id);
+        co_return common::Result<ModelReply>::Error("Model is not healthy: " + model_id);
     }
     
     auto result = co_await model->GenerateResponse(messages, config);
     co_return result;
 }
 
-Task<common::Result<void>> 
+Task<common::Result<TokenUsage>> 
 ModelService::GenerateStreamingResponse(const std::string& model_id,
                                      const std::vector<models::Message>& messages,
                                      ModelInterface::StreamCallback callback,
@@ -75,12 +79,12 @@ ModelService::GenerateStreamingResponse(const std::string& model_id,
     auto model = GetOrCreateModel(model_id);
     if (!model) {
         callback("", true); // 标记完成
-        co_return common::Result<void>::Error("Model not found: " + model_id);
+        co_return common::Result<TokenUsage>::Error("Model not found: " + model_id);
     }
     
     if (!model->IsHealthy()) {
         callback("", true); // 标记完成
-        co_return common::Result<void>::Error("Model is not healthy: " + model_id);
+        co_return common::Result<TokenUsage>::Error("Model is not healthy: " + model_id);
     }
     
     if (!model->SupportsStreaming()) {
@@ -89,23 +93,21 @@ ModelService::GenerateStreamingResponse(const std::string& model_id,
         
         if (!response_result.IsOk()) {
             callback("", true); // 标记完成
-            co_return common::Result<void>::Error(response_result.GetError());
+            co_return common::Result<TokenUsage>::Error(response_result.GetError());
         }
         
-        const std::string& response = response_result.GetValue();
+        const std::string& response = response_result.GetValue().content;
         
         // 模拟流式输出，每次发送一小部分文本
+        // 这里不能co_await std::suspend_always，没有人会恢复该协程
         const size_t chunk_size = 10;
         for (size_t i = 0; i < response.size(); i += chunk_size) {
             size_t length = std::min(chunk_size, response.size() - i);
             callback(response.substr(i, length), false);
-            
-            // 添加小延迟模拟真实流式输出
-            co_await std::suspend_always{};
         }
         
         callback("", true); // 标记完成
-        co_return common::Result<void>::Ok();
+        co_return common::Result<TokenUsage>::Ok(response_result.GetValue().usage);
     }
     
     // 使用真正的流式API
@@ -113,36 +115,6 @@ ModelService::GenerateStreamingResponse(const std::string& model_id,
     co_return result;
 }
 
-common::Result<size_t> 
-ModelService::GetLastPromptTokens(const std::string& model_id) const {
-    auto model = GetOrCreateModel(model_id);
-    if (!model) {
-        return common::Result<size_t>::Error("Model not found: " + model_id);
-    }
-    
-    return common::Result<size_t>::Ok(model->GetLastPromptTokens());
-}
-
-common::Result<size_t> 
-ModelService::GetLastCompletionTokens(const std::string& model_id) const {
-    auto model = GetOrCreateModel(model_id);
-    if (!model) {
-        return common::Result<size_t>::Error("Model not found: " + model_id);
-    }
-    
-    return common::Result<size_t>::Ok(model->GetLastCompletionTokens());
-}
-
-common::Result<size_t> 
-ModelService::GetLastTotalTokens(const std::string& model_id) const {
-    auto model = GetOrCreateModel(model_id);
-    if (!model) {
-        return common::Result<size_t>::Error("Model not found: " + model_id);
-    }
-    
-    return common::Result<size_t>::Ok(model->GetLastTotalTokens());
-}
-
 bool ModelService::IsModelHealthy(const std::string& model_id) const {
     auto model = GetOrCreateModel(model_id);
     if (!model) {
@@ -152,13 +124,6 @@ bool ModelService::IsModelHealthy(const std::string& model_id) const {
     return model->IsHealthy();
 }
 
-void ModelService::ResetModel(const std::string& model_id) {
-    auto model = GetOrCreateModel(model_id);
-    if (model) {
-        model->Reset();
-    }
-}
-
 std::shared_ptr<ModelInterface> 
 ModelService::GetOrCreateModel(const std::string& model_id) const {
     // 第一次检查：不加锁
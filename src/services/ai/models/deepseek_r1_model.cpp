@@ -1,7 +1,10 @@
 #include "services/ai/models/deepseek_r1_model.h"
 #include "core/config/config_manager.h"
-#include "core/http/request.h"
-#include "core/http/response.h"
+#include "core/http/upstream_client.h"
+#include "services/ai/models/usage_parser.h"
+#include "services/ai/streaming/delta_extractor.h"
+#include "services/ai/streaming/sse_parser.h"
+#include "services/ai/tokenizer/tokenizer.h"
 #include "core/utils/string_utils.h"
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
@@ -12,13 +15,13 @@ using json = nlohmann::json;
 using namespace core::async;
 
 DeepseekR1Model::DeepseekR1Model() 
-    : last_prompt_tokens_(0), 
-      last_completion_tokens_(0),
-      is_healthy_(true) {
+    : is_healthy_(true) {
     // 从配置加载API密钥和URL
     auto& config = core::config::ConfigManager::GetInstance();
     api_key_ = config.GetString("ai.deepseek.api_key", "");
     api_base_url_ = config.GetString("ai.deepseek.base_url", "https://api.deepseek.com/v1");
+    request_timeout_ = std::chrono::milliseconds(config.GetInt("ai.deepseek.timeout_ms", 300000));
+    connect_timeout_ = std::chrono::milliseconds(config.GetInt("ai.deepseek.connect_timeout_ms", 10000));
     
     // 验证配置
     if (api_key_.empty()) {
@@ -54,30 +57,39 @@ bool DeepseekR1Model::SupportsStreaming() const {
     return true;
 }
 
-Task<common::Result<std::string>> 
+Task<common::Result<ModelReply>> 
 DeepseekR1Model::GenerateResponse(const std::vector<models::Message>& messages, 
-                                const ModelConfig& config) {
+                                  const ModelConfig& config) {
     try {
+        auto start_time = std::chrono::steady_clock::now();
+        
         // 构建API请求
         auto request = BuildAPIRequest(messages, config, false);
         
         // 发送请求
-        auto response = co_await request.SendAsync();
+        auto response = co_await core::http::UpstreamClient::GetInstance().Send(std::move(request));
+        
+        if (!response.IsTransportOk()) {
+            std::string error_msg = "DeepSeek API request failed: " + response.error;
+            spdlog::error(error_msg);
+            co_return common::Result<ModelReply>::Error(error_msg);
+        }
         
         if (response.status_code != 200) {
             std::string error_msg = "DeepSeek API error: " + 
                                   std::to_string(response.status_code) + " " + 
                                   response.body;
             spdlog::error(error_msg);
-            co_return common::Result<std::string>::Error(error_msg);
+            co_return common::Result<ModelReply>::Error(error_msg);
         }
         
         // 解析响应
-        auto result = ParseAPIResponse(response.body);
-        
-        // 计算token使用情况
+        auto result = ParseAPIResponse(response.body, messages);
         if (result.IsOk()) {
-            CalculateAndStoreTokenCounts(messages, result.GetValue());
+            auto& usage = result.GetValue().usage;
+            usage.total_latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start_time);
+            usage.time_to_first_token = usage.total_latency;
         }
         
         co_return result;
@@ -85,36 +97,55 @@ DeepseekR1Model::GenerateResponse(const std::vector<models::Message>& messages,
         std::string error_msg = "Exception in DeepseekR1Model::GenerateResponse: ";
         error_msg += e.what();
         spdlog::error(error_msg);
-        co_return common::Result<std::string>::Error(error_msg);
+        co_return common::Result<ModelReply>::Error(error_msg);
     }
 }
 
-Task<common::Result<void>> 
+Task<common::Result<TokenUsage>> 
 DeepseekR1Model::GenerateStreamingResponse(const std::vector<models::Message>& messages,
-                                         StreamCallback callback,
-                                         const ModelConfig& config) {
+                                           StreamCallback callback,
+                                           const ModelConfig& config) {
     try {
+        auto start_time = std::chrono::steady_clock::now();
+        
         // 构建API请求
         auto request = BuildAPIRequest(messages, config, true);
         
-        // 发送流式请求
+        // 本次请求的状态全部放在协程帧内，模型实例可以被并发请求共享
         bool is_done = false;
-        size_t tokens = 0;
+        size_t generated_events = 0;
+        std::optional<std::chrono::steady_clock::time_point> first_token_time;
+        streaming::SseParser parser;
+        streaming::DeltaExtractor extractor;
+        std::optional<streaming::StreamUsage> upstream_usage;
+        auto completion_counter = tokenizer::Tokenizer::GetInstance().CreateStreamingCounter();
         
-        auto stream_handler = [this, &callback, &is_done, &tokens]
-                              (const std::string& chunk) {
-            this->HandleStreamChunk(chunk, callback, is_done);
-            tokens++;
+        // 上游数据块不按事件对齐，由SSE解析器增量切分后再交给HandleStreamChunk
+        auto stream_handler = [this, &callback, &is_done, &generated_events, &first_token_time,
+                               &parser, &extractor, &upstream_usage, &completion_counter](std::string_view data) {
+            parser.Feed(data);
+            streaming::SseEvent event;
+            while (parser.Next(event)) {
+                if (this->HandleStreamChunk(event.data, extractor, upstream_usage, completion_counter,
+                                              callback, is_done)) {
+                    generated_events++;
+                    if (!first_token_time) {
+                        first_token_time = std::chrono::steady_clock::now();
+                    }
+                }
+            }
         };
         
-        auto response = co_await request.SendStreamAsync(stream_handler);
+        auto response = co_await core::http::UpstreamClient::GetInstance().SendStream(
+            std::move(request), stream_handler);
         
-        if (response.status_code != 200) {
+        if (!response.IsTransportOk() || response.status_code != 200) {
             std::string error_msg = "DeepSeek API streaming error: " + 
-                                  std::to_string(response.status_code);
+                                  (response.IsTransportOk() ? std::to_string(response.status_code) + " " + response.body
+                                                            : response.error);
             spdlog::error(error_msg);
             callback("", true); // 标记完成
-            co_return common::Result<void>::Error(error_msg);
+            co_return common::Result<TokenUsage>::Error(error_msg);
         }
         
         // 确保完成回调被调用
@@ -122,41 +153,35 @@ DeepseekR1Model::GenerateStreamingResponse(const std::vector<models::Message>& m
             callback("", true);
         }
         
-        // 设置完成tokens
-        last_completion_tokens_ = tokens;
+        // 上游返回了用量时以上游为准，否则用本地分词器计算
+        TokenUsage usage;
+        if (upstream_usage) {
+            usage = ToTokenUsage(*upstream_usage);
+        } else {
+            usage = EstimateTokenUsage(messages, "");
+            usage.completion_tokens = completion_counter.GetCount();
+        }
+        
+        auto end_time = std::chrono::steady_clock::now();
+        usage.total_latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+        usage.time_to_first_token = std::chrono::duration_cast<std::chrono::milliseconds>(
+            first_token_time.value_or(end_time) - start_time);
         
-        co_return common::Result<void>::Ok();
+        co_return common::Result<TokenUsage>::Ok(usage);
     } catch (const std::exception& e) {
         std::string error_msg = "Exception in DeepseekR1Model::GenerateStreamingResponse: ";
         error_msg += e.what();
         spdlog::error(error_msg);
         callback("", true); // 标记完成
-        co_return common::Result<void>::Error(error_msg);
+        co_return common::Result<TokenUsage>::Error(error_msg);
     }
 }
 
-size_t DeepseekR1Model::GetLastPromptTokens() const {
-    return last_prompt_tokens_;
-}
-
-size_t DeepseekR1Model::GetLastCompletionTokens() const {
-    return last_completion_tokens_;
-}
-
-size_t DeepseekR1Model::GetLastTotalTokens() const {
-    return last_prompt_tokens_ + last_completion_tokens_;
-}
-
 bool DeepseekR1Model::IsHealthy() const {
     return is_healthy_;
 }
 
-void DeepseekR1Model::Reset() {
-    last_prompt_tokens_ = 0;
-    last_completion_tokens_ = 0;
-}
-
-core::http::Request 
+core::http::UpstreamRequest 
 DeepseekR1Model::BuildAPIRequest(const std::vector<models::Message>& messages,
                                const ModelConfig& config,
                                bool stream) const {
@@ -190,9 +215,12 @@ DeepseekR1Model::BuildAPIRequest(const std::vector<models::Message>& messages,
     }
     
     // 构建HTTP请求
-    core::http::Request request;
+    core::http::UpstreamRequest request;
     request.url = api_base_url_ + "/chat/completions";
     request.method = "POST";
+    request.timeout = request_timeout_;
+    request.connect_timeout = connect_timeout_;
+    request.deadline = config.deadline;
     request.headers = {
         {"Content-Type", "application/json"},
         {"Authorization", "Bearer " + api_key_}
@@ -202,8 +230,9 @@ DeepseekR1Model::BuildAPIRequest(const std::vector<models::Message>& messages,
     return request;
 }
 
-common::Result<std::string> 
-DeepseekR1Model::ParseAPIResponse(const std::string& response) {
+common::Result<ModelReply> 
+DeepseekR1Model::ParseAPIResponse(const std::string& response,
+                                  const std::vector<models::Message>& messages) const {
     try {
         auto json_response = json::parse(response);
         
@@ -214,80 +243,83 @@ DeepseekR1Model::ParseAPIResponse(const std::string& response) {
             } else {
                 error_msg += "Unknown error";
             }
-            return common::Result<std::string>::Error(error_msg);
+            return common::Result<ModelReply>::Error(error_msg);
         }
         
         if (!json_response.contains("choices") || 
             json_response["choices"].empty() ||
             !json_response["choices"][0].contains("message") ||
             !json_response["choices"][0]["message"].contains("content")) {
-            return common::Result<std::string>::Error("Invalid response format from DeepSeek API");
+            return common::Result<ModelReply>::Error("Invalid response format from DeepSeek API");
         }
         
-        std::string content = json_response["choices"][0]["message"]["content"].get<std::string>();
+        ModelReply reply;
+        reply.content = json_response["choices"][0]["message"]["content"].get<std::string>();
         
-        // 获取token计数
-        if (json_response.contains("usage")) {
-            last_prompt_tokens_ = json_response["usage"]["prompt_tokens"].get<size_t>();
-            last_completion_tokens_ = json_response["usage"]["completion_tokens"].get<size_t>();
+        // 获取token计数，上游未返回时估算
+        if (json_response.contains("usage") && json_response["usage"].is_object()) {
+            reply.usage = ParseTokenUsage(json_response["usage"]);
+        } else {
+            reply.usage = EstimateTokenUsage(messages, reply.content);
         }
         
-        return common::Result<std::string>::Ok(content);
+        return common::Result<ModelReply>::Ok(std::move(reply));
     } catch (const std::exception& e) {
         std::string error_msg = "Failed to parse DeepSeek API response: ";
         error_msg += e.what();
-        return common::Result<std::string>::Error(error_msg);
+        return common::Result<ModelReply>::Error(error_msg);
     }
 }
 
-void DeepseekR1Model::HandleStreamChunk(const std::string& chunk, 
-                                      StreamCallback callback, 
-                                      bool& is_done) {
-    if (chunk.empty()) {
-        return;
+bool DeepseekR1Model::HandleStreamChunk(std::string_view data,
+                                        streaming::DeltaExtractor& extractor,
+                                        std::optional<streaming::StreamUsage>& usage,
+                                        tokenizer::StreamingTokenCounter& counter,
+                                        StreamCallback callback,
+                                        bool& is_done) const {
+    if (data.empty()) {
+        return false;
     }
     
-    try {
-        // 处理SSE格式
-        if (chunk.find("data: ") == 0) {
-            std::string json_str = chunk.substr(6); // 跳过"data: "
-            
-            // 检查是否是[DONE]标记
-            if (json_str == "[DONE]") {
-                is_done = true;
-                callback("", true);
-                return;
-            }
-            
-            auto json_response = json::parse(json_str);
-            
-            if (json_response.contains("choices") && 
-                !json_response["choices"].empty() &&
-                json_response["choices"][0].contains("delta") &&
-                json_response["choices"][0]["delta"].contains("content")) {
-                
-                std::string content_delta = json_response["choices"][0]["delta"]["content"].get<std::string>();
-                callback(content_delta, false);
-            }
-        }
-    } catch (const std::exception& e) {
-        spdlog::error("Error parsing stream chunk: {}", e.what());
+    // 检查是否是[DONE]标记
+    if (data == "[DONE]") {
+        is_done = true;
+        callback("", true);
+        return false;
+    }
+    
+    streaming::StreamDelta delta;
+    if (!extractor.Extract(data, delta)) {
+        spdlog::error("Error parsing stream chunk: invalid JSON");
+        return false;
+    }
+    
+    if (delta.usage) {
+        usage = delta.usage;
+    }
+    
+    // 思考内容同样计入输出token
+    counter.Append(delta.reasoning_content);
+    counter.Append(delta.content);
+    
+    if (!delta.content.empty()) {
+        callback(std::string(delta.content), false);
     }
+    
+    return !delta.content.empty() || !delta.reasoning_content.empty();
 }
 
-void DeepseekR1Model::CalculateAndStoreTokenCounts(const std::vector<models::Message>& messages, 
-                                                const std::string& response) {
-    // 这里使用简单估算，实际项目中可能需要更复杂的tokenizer
-    size_t prompt_tokens = 0;
+TokenUsage DeepseekR1Model::EstimateTokenUsage(const std::vector<models::Message>& messages, 
+                                               const std::string& response) {
+    const auto& token_counter = tokenizer::Tokenizer::GetInstance();
+    TokenUsage usage;
+    usage.estimated = true;
     for (const auto& message : messages) {
-        // 估算：平均每4个字符约等于1个token
-        prompt_tokens += message.content.size() / 4;
+        usage.prompt_tokens += token_counter.CountTokens(message.content);
     }
     
-    size_t completion_tokens = response.size() / 4;
-    
-    last_prompt_tokens_ = prompt_tokens;
-    last_completion_tokens_ = completion_tokens;
+    usage.completion_tokens = token_counter.CountTokens(response);
+    return usage;
 }
 
 } // namespace ai_backend::services::ai
\ No newline at end of file
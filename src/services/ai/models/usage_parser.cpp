@@ -0,0 +1,17 @@
+#include "services/ai/models/usage_parser.h"
+
+namespace ai_backend::services::ai {
+
+TokenUsage ParseTokenUsage(const nlohmann::json& usage) {
+    return ToTokenUsage(streaming::ParseUsage(usage));
+}
+
+TokenUsage ToTokenUsage(const streaming::StreamUsage& usage) {
+    TokenUsage result;
+    result.prompt_tokens = static_cast<size_t>(usage.prompt_tokens);
+    result.completion_tokens = static_cast<size_t>(usage.completion_tokens);
+    result.cache_hit_tokens = static_cast<size_t>(usage.cache_hit_tokens);
+    return result;
+}
+
+} // namespace ai_backend::services::ai
@@ -0,0 +1,440 @@
+#include "services/ai/streaming/delta_extractor.h"
+#include <cstring>
+#include <nlohmann/json.hpp>
+
+namespace ai_backend::services::ai::streaming {
+
+using json = nlohmann::json;
+
+// 只前进不回溯的JSON扫描器，任何不支持的输入都返回false并由调用方回退
+class DeltaExtractor::Scanner {
+public:
+    explicit Scanner(std::string_view text)
+        : current_(text.data()), end_(text.data() + text.size()) {}
+
+    void SkipWhitespace() {
+        while (current_ < end_ && (*current_ == ' ' || *current_ == '\n' ||
+                                   *current_ == '\r' || *current_ == '\t')) {
+            ++current_;
+        }
+    }
+
+    bool AtEnd() {
+        SkipWhitespace();
+        return current_ == end_;
+    }
+
+    bool Consume(char c) {
+        SkipWhitespace();
+        if (current_ < end_ && *current_ == c) {
+            ++current_;
+            return true;
+        }
+        return false;
+    }
+
+    bool PeekIs(char c) {
+        SkipWhitespace();
+        return current_ < end_ && *current_ == c;
+    }
+
+    // 遍历对象成员，on_member(key)必须消费对应的值
+    template<typename OnMember>
+    bool ParseObject(OnMember&& on_member) {
+        if (!Consume('{')) {
+            return false;
+        }
+        if (Consume('}')) {
+            return true;
+        }
+        for (;;) {
+            std::string_view key;
+            if (!ReadKey(key) || !Consume(':') || !on_member(key)) {
+                return false;
+            }
+            if (Consume(',')) {
+                continue;
+            }
+            return Consume('}');
+        }
+    }
+
+    // 读取字符串或null，null时out为空视图
+    bool ReadNullableString(std::string_view& out, std::string& buffer) {
+        if (PeekIs('n')) {
+            out = {};
+            return ReadLiteral("null");
+        }
+        return ReadString(out, buffer);
+    }
+
+    bool ReadNull() {
+        return PeekIs('n') && ReadLiteral("null");
+    }
+
+    bool ReadInt64(int64_t& value) {
+        SkipWhitespace();
+        bool negative = current_ < end_ && *current_ == '-';
+        if (negative) {
+            ++current_;
+        }
+        const char* digits = current_;
+        int64_t result = 0;
+        while (current_ < end_ && *current_ >= '0' && *current_ <= '9') {
+            if (current_ - digits >= 18) {
+                return false;
+            }
+            result = result * 10 + (*current_ - '0');
+            ++current_;
+        }
+        if (current_ == digits) {
+            return false;
+        }
+        // 小数和指数交给完整解析
+        if (current_ < end_ && (*current_ == '.' || *current_ == 'e' || *current_ == 'E')) {
+            return false;
+        }
+        value = negative ? -result : result;
+        return true;
+    }
+
+    // 跳过任意值，嵌套结构只做括号匹配
+    bool SkipValue() {
+        SkipWhitespace();
+        if (current_ == end_) {
+            return false;
+        }
+
+        char c = *current_;
+        if (c == '"') {
+            return SkipString();
+        }
+
+        if (c == '{' || c == '[') {
+            int depth = 0;
+            while (current_ < end_) {
+                c = *current_;
+                if (c == '"') {
+                    if (!SkipString()) {
+                        return false;
+                    }
+                    continue;
+                }
+                ++current_;
+                if (c == '{' || c == '[') {
+                    ++depth;
+                } else if (c == '}' || c == ']') {
+                    if (--depth == 0) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // 数字、true、false、null
+        const char* start = current_;
+        while (current_ < end_ && *current_ != ',' && *current_ != '}' && *current_ != ']' &&
+               *current_ != ' ' && *current_ != '\n' && *current_ != '\r' && *current_ != '\t') {
+            ++current_;
+        }
+        return current_ != start;
+    }
+
+private:
+    bool ReadLiteral(std::string_view literal) {
+        if (static_cast<size_t>(end_ - current_) < literal.size() ||
+            std::memcmp(current_, literal.data(), literal.size()) != 0) {
+            return false;
+        }
+        current_ += literal.size();
+        return true;
+    }
+
+    // 成员名不做反转义，含转义的成员名回退
+    bool ReadKey(std::string_view& key) {
+        if (!Consume('"')) {
+            return false;
+        }
+        const char* quote = static_cast<const char*>(std::memchr(current_, '"', end_ - current_));
+        if (!quote || std::memchr(current_, '\\', quote - current_)) {
+            return false;
+        }
+        key = std::string_view(current_, quote - current_);
+        current_ = quote + 1;
+        return true;
+    }
+
+    bool SkipString() {
+        ++current_;  // 开头的引号
+        while (current_ < end_) {
+            const char* quote = static_cast<const char*>(std::memchr(current_, '"', end_ - current_));
+            if (!quote) {
+                return false;
+            }
+            // 引号前连续反斜杠为奇数个时是转义的引号
+            const char* back = quote;
+            while (back > current_ && back[-1] == '\\') {
+                --back;
+            }
+            current_ = quote + 1;
+            if ((quote - back) % 2 == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 不含转义时直接返回输入的视图，否则解码到buffer
+    bool ReadString(std::string_view& out, std::string& buffer) {
+        if (!Consume('"')) {
+            return false;
+        }
+        const char* quote = static_cast<const char*>(std::memchr(current_, '"', end_ - current_));
+        if (!quote) {
+            return false;
+        }
+        if (!std::memchr(current_, '\\', quote - current_)) {
+            out = std::string_view(current_, quote - current_);
+            current_ = quote + 1;
+            return true;
+        }
+
+        buffer.clear();
+        while (current_ < end_) {
+            char c = *current_++;
+            if (c == '"') {
+                out = buffer;
+                return true;
+            }
+            if (c != '\\') {
+                buffer.push_back(c);
+                continue;
+            }
+            if (current_ == end_) {
+                return false;
+            }
+            switch (*current_++) {
+            case '"': buffer.push_back('"'); break;
+            case '\\': buffer.push_back('\\'); break;
+            case '/': buffer.push_back('/'); break;
+            case 'b': buffer.push_back('\b'); break;
+            case 'f': buffer.push_back('\f'); break;
+            case 'n': buffer.push_back('\n'); break;
+            case 'r': buffer.push_back('\r'); break;
+            case 't': buffer.push_back('\t'); break;
+            case 'u':
+                if (!AppendUnicodeEscape(buffer)) {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool ReadHex4(uint32_t& code) {
+        if (end_ - current_ < 4) {
+            return false;
+        }
+        code = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *current_++;
+            code <<= 4;
+            if (c >= '0' && c <= '9') {
+                code |= static_cast<uint32_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                code |= static_cast<uint32_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                code |= static_cast<uint32_t>(c - 'A' + 10);
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 解码\uXXXX (含代理对) 为UTF-8
+    bool AppendUnicodeEscape(std::string& buffer) {
+        uint32_t code;
+        if (!ReadHex4(code)) {
+            return false;
+        }
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            uint32_t low;
+            if (end_ - current_ < 2 || current_[0] != '\\' || current_[1] != 'u') {
+                return false;
+            }
+            current_ += 2;
+            if (!ReadHex4(low) || low < 0xDC00 || low > 0xDFFF) {
+                return false;
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        } else if (code >= 0xDC00 && code <= 0xDFFF) {
+            return false;
+        }
+
+        if (code < 0x80) {
+            buffer.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            buffer.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            buffer.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            buffer.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            buffer.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            buffer.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            buffer.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            buffer.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            buffer.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            buffer.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        return true;
+    }
+
+private:
+    const char* current_;
+    const char* end_;
+};
+
+bool DeltaExtractor::Extract(std::string_view chunk, StreamDelta& delta) {
+    delta = StreamDelta{};
+    Scanner scanner(chunk);
+
+    auto parse_usage = [&]() {
+        if (scanner.ReadNull()) {
+            return true;
+        }
+        StreamUsage usage;
+        std::optional<int64_t> cache_hit_tokens;
+        std::optional<int64_t> cached_tokens;
+        bool ok = scanner.ParseObject([&](std::string_view key) {
+            if (key == "prompt_tokens") return scanner.ReadInt64(usage.prompt_tokens);
+            if (key == "completion_tokens") return scanner.ReadInt64(usage.completion_tokens);
+            if (key == "total_tokens") return scanner.ReadInt64(usage.total_tokens);
+            if (key == "prompt_cache_hit_tokens") return scanner.ReadInt64(cache_hit_tokens.emplace());
+            if (key == "prompt_tokens_details") {
+                return scanner.ReadNull() || scanner.ParseObject([&](std::string_view detail) {
+                    if (detail == "cached_tokens") return scanner.ReadInt64(cached_tokens.emplace());
+                    return scanner.SkipValue();
+                });
+            }
+            return scanner.SkipValue();
+        });
+        if (ok) {
+            // 与ParseUsage相同，两个字段都出现时以prompt_cache_hit_tokens为准，与字段顺序无关
+            usage.cache_hit_tokens = cache_hit_tokens.value_or(cached_tokens.value_or(0));
+            delta.usage = usage;
+        }
+        return ok;
+    };
+
+    auto parse_delta = [&]() {
+        if (scanner.ReadNull()) {
+            return true;
+        }
+        return scanner.ParseObject([&](std::string_view key) {
+            if (key == "content") return scanner.ReadNullableString(delta.content, content_buffer_);
+            if (key == "reasoning_content") return scanner.ReadNullableString(delta.reasoning_content, reasoning_buffer_);
+            return scanner.SkipValue();
+        });
+    };
+
+    // 只读取choices[0]
+    auto parse_choices = [&]() {
+        if (!scanner.Consume('[')) {
+            return false;
+        }
+        if (scanner.Consume(']')) {
+            return true;
+        }
+        bool ok = scanner.ParseObject([&](std::string_view key) {
+            if (key == "delta") return parse_delta();
+            if (key == "finish_reason") return scanner.ReadNullableString(delta.finish_reason, finish_reason_buffer_);
+            return scanner.SkipValue();
+        });
+        while (ok && scanner.Consume(',')) {
+            ok = scanner.SkipValue();
+        }
+        return ok && scanner.Consume(']');
+    };
+
+    bool ok = scanner.ParseObject([&](std::string_view key) {
+        if (key == "choices") return parse_choices();
+        if (key == "usage") return parse_usage();
+        return scanner.SkipValue();
+    });
+
+    if (ok && scanner.AtEnd()) {
+        return true;
+    }
+
+    fallback_count_++;
+    delta = StreamDelta{};
+    return ExtractWithDom(chunk, delta);
+}
+
+bool DeltaExtractor::ExtractWithDom(std::string_view chunk, StreamDelta& delta) {
+    auto root = json::parse(chunk, nullptr, false);
+    if (root.is_discarded() || !root.is_object()) {
+        return false;
+    }
+
+    auto copy_string = [](const json& object, const char* key, std::string& buffer, std::string_view& out) {
+        auto it = object.find(key);
+        if (it != object.end() && it->is_string()) {
+            buffer = it->get<std::string>();
+            out = buffer;
+        }
+    };
+
+    auto choices = root.find("choices");
+    if (choices != root.end() && choices->is_array() && !choices->empty() && (*choices)[0].is_object()) {
+        const auto& choice = (*choices)[0];
+        auto delta_it = choice.find("delta");
+        if (delta_it != choice.end() && delta_it->is_object()) {
+            copy_string(*delta_it, "content", content_buffer_, delta.content);
+            copy_string(*delta_it, "reasoning_content", reasoning_buffer_, delta.reasoning_content);
+        }
+        copy_string(choice, "finish_reason", finish_reason_buffer_, delta.finish_reason);
+    }
+
+    auto usage = root.find("usage");
+    if (usage != root.end() && usage->is_object()) {
+        delta.usage = ParseUsage(*usage);
+    }
+
+    return true;
+}
+
+StreamUsage ParseUsage(const json& usage) {
+    auto read_count = [](const json& object, const char* key) -> std::optional<int64_t> {
+        auto it = object.find(key);
+        if (it == object.end() || !it->is_number()) {
+            return std::nullopt;
+        }
+        return it->get<int64_t>();
+    };
+
+    StreamUsage result;
+    if (!usage.is_object()) {
+        return result;
+    }
+    result.prompt_tokens = read_count(usage, "prompt_tokens").value_or(0);
+    result.completion_tokens = read_count(usage, "completion_tokens").value_or(0);
+    result.total_tokens = read_count(usage, "total_tokens").value_or(0);
+
+    auto cache_hit_tokens = read_count(usage, "prompt_cache_hit_tokens");
+    if (!cache_hit_tokens) {
+        auto details = usage.find("prompt_tokens_details");
+        if (details != usage.end() && details->is_object()) {
+            cache_hit_tokens = read_count(*details, "cached_tokens");
+        }
+    }
+    result.cache_hit_tokens = cache_hit_tokens.value_or(0);
+    return result;
+}
+
+} // namespace ai_backend::services::ai::streaming
@@ -0,0 +1,221 @@
+#include "services/ai/streaming/sse_parser.h"
+#include "core/memory/memory_tracker.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ai_backend::services::ai::streaming {
+
+namespace {
+
+constexpr std::string_view kDefaultEventType = "message";
+constexpr std::string_view kUtf8Bom = "\xEF\xBB\xBF";
+
+// 查找第一个'\r'或'\n'，两次memchr比逐字节find_first_of快得多
+size_t FindLineEnd(std::string_view text) {
+    const void* lf = std::memchr(text.data(), '\n', text.size());
+    size_t limit = lf ? static_cast<size_t>(static_cast<const char*>(lf) - text.data()) : text.size();
+    const void* cr = std::memchr(text.data(), '\r', limit);
+    if (cr) {
+        return static_cast<size_t>(static_cast<const char*>(cr) - text.data());
+    }
+    return lf ? limit : std::string_view::npos;
+}
+
+bool PointsInto(std::string_view view, std::string_view storage) {
+    return view.data() >= storage.data() && view.data() <= storage.data() + storage.size();
+}
+
+} // namespace
+
+SseParser::SseParser(size_t max_line_size, std::pmr::memory_resource* resource)
+    : max_line_size_(max_line_size),
+      partial_line_(resource ? resource : core::memory::TrackedResource::ForTag(core::memory::MemoryTag::kAiStream)),
+      event_type_storage_(partial_line_.get_allocator()),
+      data_storage_(partial_line_.get_allocator()),
+      last_event_id_(partial_line_.get_allocator()) {
+}
+
+void SseParser::Feed(std::string_view bytes) {
+    input_ = bytes;
+    position_ = 0;
+
+    // 流开头的BOM按规范忽略
+    if (!bom_checked_ && !bytes.empty()) {
+        bom_checked_ = true;
+        if (!has_partial_line_ && bytes.substr(0, kUtf8Bom.size()) == kUtf8Bom) {
+            position_ = kUtf8Bom.size();
+        }
+    }
+}
+
+bool SseParser::Next(SseEvent& event) {
+    if (has_error_) {
+        return false;
+    }
+
+    std::string_view line;
+    while (ReadLine(line)) {
+        if (ProcessLine(line, event)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SseParser::Reset() {
+    input_ = {};
+    position_ = 0;
+    partial_line_.clear();
+    has_partial_line_ = false;
+    pending_cr_ = false;
+    bom_checked_ = false;
+    ResetPendingEvent();
+    event_type_storage_.clear();
+    data_storage_.clear();
+    last_event_id_.clear();
+    retry_ms_.reset();
+    has_error_ = false;
+}
+
+bool SseParser::ReadLine(std::string_view& line) {
+    // 上一块末尾的'\r'与这一块开头的'\n'组成CRLF
+    if (pending_cr_ && position_ < input_.size()) {
+        pending_cr_ = false;
+        if (input_[position_] == '\n') {
+            position_++;
+        }
+    }
+
+    std::string_view rest = input_.substr(std::min(position_, input_.size()));
+    size_t end = FindLineEnd(rest);
+
+    if (end == std::string_view::npos) {
+        // 输入耗尽：当前事件的视图即将失效，先复制到自有存储，再保存不完整的行
+        PinPendingFields();
+        if (!has_partial_line_) {
+            partial_line_.clear();
+        }
+        if (partial_line_.size() + rest.size() > max_line_size_) {
+            has_error_ = true;
+        } else {
+            partial_line_.append(rest);
+        }
+        has_partial_line_ = !partial_line_.empty();
+        input_ = {};
+        position_ = 0;
+        return false;
+    }
+
+    if (has_partial_line_) {
+        if (partial_line_.size() + end > max_line_size_) {
+            has_error_ = true;
+            return false;
+        }
+        // partial_line_的内容保留到输入块耗尽，期间字段视图可以指向它
+        partial_line_.append(rest.substr(0, end));
+        line = partial_line_;
+        has_partial_line_ = false;
+    } else {
+        if (end > max_line_size_) {
+            has_error_ = true;
+            return false;
+        }
+        line = rest.substr(0, end);
+    }
+
+    position_ += end + 1;
+    if (rest[end] == '\r') {
+        if (position_ < input_.size()) {
+            if (input_[position_] == '\n') {
+                position_++;
+            }
+        } else {
+            pending_cr_ = true;
+        }
+    }
+    return true;
+}
+
+bool SseParser::ProcessLine(std::string_view line, SseEvent& event) {
+    // 空行：分发事件
+    if (line.empty()) {
+        if (!has_data_) {
+            ResetPendingEvent();
+            return false;
+        }
+
+        event.event = event_type_.empty() ? kDefaultEventType : event_type_;
+        event.data = data_;
+        event.id = last_event_id_;
+        ResetPendingEvent();
+        return true;
+    }
+
+    // 注释行
+    if (line[0] == ':') {
+        return false;
+    }
+
+    std::string_view field = line;
+    std::string_view value;
+    size_t colon = line.find(':');
+    if (colon != std::string_view::npos) {
+        field = line.substr(0, colon);
+        value = line.substr(colon + 1);
+        if (!value.empty() && value[0] == ' ') {
+            value.remove_prefix(1);
+        }
+    }
+
+    if (field == "data") {
+        if (!has_data_) {
+            data_ = value;
+            has_data_ = true;
+        } else {
+            // 多行data才需要拼接到自有存储
+            if (!PointsInto(data_, data_storage_)) {
+                data_storage_.assign(data_);
+            }
+            data_storage_ += '\n';
+            data_storage_.append(value);
+            data_ = data_storage_;
+        }
+    } else if (field == "event") {
+        event_type_ = value;
+    } else if (field == "id") {
+        if (value.find('\0') == std::string_view::npos) {
+            last_event_id_.assign(value);
+        }
+    } else if (field == "retry") {
+        if (!value.empty() && value.size() <= 9 &&
+            value.find_first_not_of("0123456789") == std::string_view::npos) {
+            uint32_t retry = 0;
+            for (char c : value) {
+                retry = retry * 10 + static_cast<uint32_t>(c - '0');
+            }
+            retry_ms_ = retry;
+        }
+    }
+    // 其他字段按规范忽略
+
+    return false;
+}
+
+void SseParser::PinPendingFields() {
+    if (has_data_ && !PointsInto(data_, data_storage_)) {
+        data_storage_.assign(data_);
+        data_ = data_storage_;
+    }
+    if (!event_type_.empty() && !PointsInto(event_type_, event_type_storage_)) {
+        event_type_storage_.assign(event_type_);
+        event_type_ = event_type_storage_;
+    }
+}
+
+void SseParser::ResetPendingEvent() {
+    event_type_ = {};
+    data_ = {};
+    has_data_ = false;
+}
+
+} // namespace ai_backend::services::ai::streaming
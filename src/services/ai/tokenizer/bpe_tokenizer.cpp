@@ -0,0 +1,964 @@
+#include "services/ai/tokenizer/bpe_tokenizer.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <boost/container/small_vector.hpp>
+#include <nlohmann/json.hpp>
+
+namespace ai_backend::services::ai::tokenizer {
+
+using json = nlohmann::json;
+
+// ---------------------------------------------------------------------------
+// 预分词
+// ---------------------------------------------------------------------------
+
+namespace {
+
+enum class CharClass : uint8_t {
+    kLetter,
+    kDigit,
+    kCjk,
+    kSpace,
+    kNewline,
+    kOther,  // 标点、符号等
+};
+
+struct CodePoint {
+    uint32_t value;
+    uint32_t length;
+};
+
+// 解码一个UTF-8码点，非法或不完整的序列按单字节处理
+CodePoint DecodeUtf8(std::string_view text, size_t pos) {
+    auto byte = static_cast<uint8_t>(text[pos]);
+    if (byte < 0x80) {
+        return {byte, 1};
+    }
+
+    uint32_t length;
+    uint32_t value;
+    if ((byte & 0xE0) == 0xC0) {
+        length = 2;
+        value = byte & 0x1F;
+    } else if ((byte & 0xF0) == 0xE0) {
+        length = 3;
+        value = byte & 0x0F;
+    } else if ((byte & 0xF8) == 0xF0) {
+        length = 4;
+        value = byte & 0x07;
+    } else {
+        return {0xFFFD, 1};
+    }
+
+    if (pos + length > text.size()) {
+        return {0xFFFD, 1};
+    }
+    for (uint32_t i = 1; i < length; ++i) {
+        auto next = static_cast<uint8_t>(text[pos + i]);
+        if ((next & 0xC0) != 0x80) {
+            return {0xFFFD, 1};
+        }
+        value = (value << 6) | (next & 0x3F);
+    }
+    return {value, length};
+}
+
+CharClass Classify(uint32_t cp) {
+    if (cp < 0x80) {
+        if ((cp | 0x20) >= 'a' && (cp | 0x20) <= 'z') return CharClass::kLetter;
+        if (cp >= '0' && cp <= '9') return CharClass::kDigit;
+        if (cp == '\n' || cp == '\r') return CharClass::kNewline;
+        if (cp == ' ' || cp == '\t' || cp == '\v' || cp == '\f') return CharClass::kSpace;
+        return CharClass::kOther;
+    }
+
+    // 与DeepSeek预分词的CJK规则一致：汉字、假名、谚文
+    if ((cp >= 0x4E00 && cp <= 0x9FFF) || (cp >= 0x3400 && cp <= 0x4DBF) ||
+        (cp >= 0x3040 && cp <= 0x30FF) || (cp >= 0xAC00 && cp <= 0xD7AF) ||
+        (cp >= 0xF900 && cp <= 0xFAFF) || (cp >= 0x20000 && cp <= 0x2FFFF)) {
+        return CharClass::kCjk;
+    }
+
+    if (cp == 0x85 || cp == 0x2028 || cp == 0x2029) return CharClass::kNewline;
+    if (cp == 0xA0 || cp == 0x1680 || (cp >= 0x2000 && cp <= 0x200A) ||
+        cp == 0x202F || cp == 0x205F || cp == 0x3000) {
+        return CharClass::kSpace;
+    }
+    if (cp >= 0xFF10 && cp <= 0xFF19) return CharClass::kDigit;
+
+    // 常见标点和符号区间，其余非ASCII字符按字母处理
+    if ((cp >= 0x80 && cp <= 0xBF) || cp == 0xD7 || cp == 0xF7 ||
+        (cp >= 0x2000 && cp <= 0x2BFF) || (cp >= 0x3000 && cp <= 0x303F) ||
+        (cp >= 0xFE30 && cp <= 0xFE4F) || (cp >= 0xFF00 && cp <= 0xFF0F) ||
+        (cp >= 0xFF1A && cp <= 0xFF20) || (cp >= 0xFF3B && cp <= 0xFF40) ||
+        (cp >= 0xFF5B && cp <= 0xFF65) || (cp >= 0x1F000 && cp <= 0x1FAFF) ||
+        cp == 0xFFFD) {
+        return CharClass::kOther;
+    }
+    return CharClass::kLetter;
+}
+
+struct CharInfo {
+    CharClass cls;
+    uint32_t length;
+};
+
+inline CharInfo CharAt(std::string_view text, size_t pos) {
+    auto byte = static_cast<uint8_t>(text[pos]);
+    if (byte < 0x80) {
+        return {Classify(byte), 1};
+    }
+    auto cp = DecodeUtf8(text, pos);
+    return {Classify(cp.value), cp.length};
+}
+
+// 从pos开始的连续ASCII字母个数
+inline size_t ScanAsciiLetters(std::string_view text, size_t pos) {
+    size_t start = pos;
+#if defined(__SSE2__)
+    // (c | 0x20) - 'a' < 26 的字节是字母；加上偏移后用有符号比较
+    const __m128i lower_bit = _mm_set1_epi8(0x20);
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80 - 'a'));
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(-128 + 26));
+    while (pos + 16 <= text.size()) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));
+        __m128i shifted = _mm_add_epi8(_mm_or_si128(bytes, lower_bit), bias);
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmplt_epi8(shifted, limit)));
+        if (mask != 0xFFFF) {
+            return pos - start + static_cast<size_t>(__builtin_ctz(~mask));
+        }
+        pos += 16;
+    }
+#endif
+    while (pos < text.size()) {
+        auto c = static_cast<uint8_t>(text[pos]) | 0x20;
+        if (c < 'a' || c > 'z') {
+            break;
+        }
+        ++pos;
+    }
+    return pos - start;
+}
+
+// 从pos开始消费字母串 (ASCII快速路径 + 非ASCII字母)
+size_t ConsumeLetters(std::string_view text, size_t pos) {
+    while (pos < text.size()) {
+        pos += ScanAsciiLetters(text, pos);
+        if (pos >= text.size() || static_cast<uint8_t>(text[pos]) < 0x80) {
+            break;
+        }
+        auto info = CharAt(text, pos);
+        if (info.cls != CharClass::kLetter) {
+            break;
+        }
+        pos += info.length;
+    }
+    return pos;
+}
+
+// 缩写后缀 's 't 're 've 'm 'll 'd，返回长度，不匹配返回0
+size_t MatchContraction(std::string_view text, size_t pos) {
+    if (text[pos] != '\'' || pos + 1 >= text.size()) {
+        return 0;
+    }
+    char c1 = static_cast<char>(text[pos + 1] | 0x20);
+    if (c1 == 's' || c1 == 't' || c1 == 'm' || c1 == 'd') {
+        return 2;
+    }
+    if (pos + 2 < text.size()) {
+        char c2 = static_cast<char>(text[pos + 2] | 0x20);
+        if ((c1 == 'r' && c2 == 'e') || (c1 == 'v' && c2 == 'e') || (c1 == 'l' && c2 == 'l')) {
+            return 3;
+        }
+    }
+    return 0;
+}
+
+inline bool IsSpaceClass(CharClass cls) {
+    return cls == CharClass::kSpace || cls == CharClass::kNewline;
+}
+
+} // namespace
+
+size_t NextPretokenEnd(std::string_view text, size_t start) {
+    const size_t size = text.size();
+    if (start >= size) {
+        return size;
+    }
+
+    auto first = CharAt(text, start);
+
+    // 数字：1~3位一组
+    if (first.cls == CharClass::kDigit) {
+        size_t pos = start;
+        for (int i = 0; i < 3 && pos < size; ++i) {
+            auto info = CharAt(text, pos);
+            if (info.cls != CharClass::kDigit) {
+                break;
+            }
+            pos += info.length;
+        }
+        return pos;
+    }
+
+    // CJK连续字符单独成段
+    if (first.cls == CharClass::kCjk) {
+        size_t pos = start + first.length;
+        while (pos < size) {
+            auto info = CharAt(text, pos);
+            if (info.cls != CharClass::kCjk) {
+                break;
+            }
+            pos += info.length;
+        }
+        return pos;
+    }
+
+    // 以下规则作用于数字和CJK之间的段，段尾视为文本结尾
+
+    // 缩写
+    if (size_t length = MatchContraction(text, start)) {
+        return start + length;
+    }
+
+    // 可选的非字母数字前缀 + 字母串
+    if (first.cls == CharClass::kLetter) {
+        return ConsumeLetters(text, start + first.length);
+    }
+    size_t after_first = start + first.length;
+    if (first.cls != CharClass::kNewline && after_first < size &&
+        CharAt(text, after_first).cls == CharClass::kLetter) {
+        return ConsumeLetters(text, after_first);
+    }
+
+    // 可选空格 + 标点串 + 换行
+    size_t punct_start = start;
+    if (first.cls == CharClass::kSpace && text[start] == ' ' && after_first < size &&
+        CharAt(text, after_first).cls == CharClass::kOther) {
+        punct_start = after_first;
+    }
+    if (CharAt(text, punct_start).cls == CharClass::kOther) {
+        size_t pos = punct_start;
+        while (pos < size) {
+            auto info = CharAt(text, pos);
+            if (info.cls != CharClass::kOther) {
+                break;
+            }
+            pos += info.length;
+        }
+        while (pos < size && (text[pos] == '\r' || text[pos] == '\n')) {
+            ++pos;
+        }
+        return pos;
+    }
+
+    // 空白串
+    size_t pos = start;
+    size_t last_newline_end = 0;
+    size_t last_char_start = start;
+    while (pos < size) {
+        auto info = CharAt(text, pos);
+        if (!IsSpaceClass(info.cls)) {
+            break;
+        }
+        if (info.cls == CharClass::kNewline) {
+            last_newline_end = pos + info.length;
+        }
+        last_char_start = pos;
+        pos += info.length;
+    }
+
+    // \s*[\r\n]+ ：到最后一个换行为止
+    if (last_newline_end != 0) {
+        return last_newline_end;
+    }
+
+    // \s+(?!\S) ：后面是非空白时留下最后一个空白给下一个片段
+    bool followed_by_segment_text = pos < size && [&]() {
+        auto cls = CharAt(text, pos).cls;
+        return cls != CharClass::kDigit && cls != CharClass::kCjk;
+    }();
+    if (followed_by_segment_text && last_char_start > start) {
+        return last_char_start;
+    }
+    return pos;
+}
+
+size_t EstimateTokens(std::string_view text) {
+    size_t ascii_bytes = 0;
+    size_t other_chars = 0;
+    for (char c : text) {
+        auto byte = static_cast<uint8_t>(c);
+        if (byte < 0x80) {
+            ascii_bytes++;
+        } else if ((byte & 0xC0) != 0x80) {
+            other_chars++;
+        }
+    }
+    return (ascii_bytes + 3) / 4 + (other_chars * 3 + 4) / 5;
+}
+
+// ---------------------------------------------------------------------------
+// 二进制映像
+// ---------------------------------------------------------------------------
+
+// 所有整数按小端存储，映像在文件中的偏移均为4字节对齐
+struct BpeTokenizer::Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t vocab_size;
+    uint32_t merge_count;
+    uint32_t vocab_slot_count;   // 2的幂
+    uint32_t merge_slot_count;   // 2的幂
+    uint64_t blob_size;
+};
+
+struct BpeTokenizer::TokenEntry {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct BpeTokenizer::MergeEntry {
+    uint32_t left;
+    uint32_t right;
+    uint32_t rank;
+    uint32_t merged;
+};
+
+namespace {
+
+constexpr char kMagic[4] = {'B', 'P', 'E', '1'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kEmptySlot = 0xFFFFFFFFu;
+
+inline uint64_t HashBytes(std::string_view bytes) {
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (char c : bytes) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+inline uint64_t HashPair(uint32_t left, uint32_t right) {
+    uint64_t key = (static_cast<uint64_t>(left) << 32) | right;
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return key;
+}
+
+uint32_t SlotCountFor(size_t entries) {
+    // 负载因子不超过0.5
+    uint32_t slots = 16;
+    while (slots < entries * 2) {
+        slots <<= 1;
+    }
+    return slots;
+}
+
+size_t AlignUp(size_t value) {
+    return (value + 7) & ~size_t{7};
+}
+
+// GPT-2字节级编码：可打印字节映射到自身，其余字节映射到U+0100之后的码点
+std::vector<int> UnicodeToByteTable() {
+    std::vector<int> table(0x200, -1);
+    int extra = 0;
+    for (int b = 0; b < 256; ++b) {
+        bool printable = (b >= 33 && b <= 126) || (b >= 161 && b <= 172) || (b >= 174 && b <= 255);
+        if (printable) {
+            table[b] = b;
+        } else {
+            table[256 + extra] = b;
+            extra++;
+        }
+    }
+    return table;
+}
+
+// 把tokenizer.json中的token字符串还原为原始字节，含映射外字符时返回false
+bool DecodeByteLevel(const std::string& token, const std::vector<int>& table, std::string& bytes) {
+    bytes.clear();
+    for (size_t pos = 0; pos < token.size();) {
+        auto cp = DecodeUtf8(token, pos);
+        if (cp.value >= table.size() || table[cp.value] < 0) {
+            return false;
+        }
+        bytes.push_back(static_cast<char>(table[cp.value]));
+        pos += cp.length;
+    }
+    return true;
+}
+
+} // namespace
+
+BpeTokenizer::~BpeTokenizer() {
+    if (mapped_) {
+        munmap(mapped_, mapped_size_);
+    }
+}
+
+common::Result<std::shared_ptr<BpeTokenizer>> BpeTokenizer::Build(
+    const std::vector<std::string>& tokens,
+    const std::vector<std::pair<std::string, std::string>>& merges) {
+    using ResultType = common::Result<std::shared_ptr<BpeTokenizer>>;
+
+    if (tokens.empty() || tokens.size() >= kEmptySlot) {
+        return ResultType::Error("Invalid vocabulary size");
+    }
+
+    size_t blob_size = 0;
+    for (const auto& token : tokens) {
+        blob_size += token.size();
+    }
+
+    uint32_t vocab_slot_count = SlotCountFor(tokens.size());
+    uint32_t merge_slot_count = SlotCountFor(merges.size());
+
+    size_t tokens_offset = AlignUp(sizeof(Header));
+    size_t vocab_offset = AlignUp(tokens_offset + tokens.size() * sizeof(TokenEntry));
+    size_t merge_offset = AlignUp(vocab_offset + vocab_slot_count * sizeof(uint32_t));
+    size_t blob_offset = AlignUp(merge_offset + merge_slot_count * sizeof(MergeEntry));
+
+    std::shared_ptr<BpeTokenizer> tokenizer(new BpeTokenizer());
+    auto& image = tokenizer->owned_;
+    image.assign(blob_offset + blob_size, 0);
+
+    auto* header = reinterpret_cast<Header*>(image.data());
+    std::memcpy(header->magic, kMagic, sizeof(kMagic));
+    header->version = kVersion;
+    header->vocab_size = static_cast<uint32_t>(tokens.size());
+    header->vocab_slot_count = vocab_slot_count;
+    header->merge_slot_count = merge_slot_count;
+    header->blob_size = blob_size;
+
+    // token表和字节串
+    auto* entries = reinterpret_cast<TokenEntry*>(image.data() + tokens_offset);
+    char* blob = image.data() + blob_offset;
+    uint32_t offset = 0;
+    for (size_t id = 0; id < tokens.size(); ++id) {
+        entries[id] = {offset, static_cast<uint32_t>(tokens[id].size())};
+        std::memcpy(blob + offset, tokens[id].data(), tokens[id].size());
+        offset += static_cast<uint32_t>(tokens[id].size());
+    }
+
+    // 字节串 -> token，重复的字节串保留较小的id
+    auto* vocab_slots = reinterpret_cast<uint32_t*>(image.data() + vocab_offset);
+    std::fill(vocab_slots, vocab_slots + vocab_slot_count, kEmptySlot);
+    for (size_t id = 0; id < tokens.size(); ++id) {
+        if (tokens[id].empty()) {
+            continue;
+        }
+        uint32_t mask = vocab_slot_count - 1;
+        for (uint64_t slot = HashBytes(tokens[id]) & mask;; slot = (slot + 1) & mask) {
+            uint32_t existing = vocab_slots[slot];
+            if (existing == kEmptySlot) {
+                vocab_slots[slot] = static_cast<uint32_t>(id);
+                break;
+            }
+            if (tokens[existing] == tokens[id]) {
+                break;
+            }
+        }
+    }
+
+    // 先挂上词表部分，用于解析合并规则
+    auto attached = tokenizer->Attach(image.data(), image.size());
+    if (attached.IsError()) {
+        return ResultType::Error(attached.GetError());
+    }
+
+    auto* merge_slots = reinterpret_cast<MergeEntry*>(image.data() + merge_offset);
+    for (uint32_t i = 0; i < merge_slot_count; ++i) {
+        merge_slots[i] = {kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot};
+    }
+
+    uint32_t merge_count = 0;
+    for (size_t rank = 0; rank < merges.size(); ++rank) {
+        const auto& [left_bytes, right_bytes] = merges[rank];
+        TokenId left, right, merged;
+        if (!tokenizer->Lookup(left_bytes, left) || !tokenizer->Lookup(right_bytes, right) ||
+            !tokenizer->Lookup(left_bytes + right_bytes, merged)) {
+            continue;
+        }
+
+        uint32_t mask = merge_slot_count - 1;
+        for (uint64_t slot = HashPair(left, right) & mask;; slot = (slot + 1) & mask) {
+            auto& entry = merge_slots[slot];
+            if (entry.left == kEmptySlot) {
+                entry = {left, right, static_cast<uint32_t>(rank), merged};
+                merge_count++;
+                break;
+            }
+            if (entry.left == left && entry.right == right) {
+                break;  // 重复规则保留优先级高的
+            }
+        }
+    }
+    header->merge_count = merge_count;
+
+    return ResultType::Ok(std::move(tokenizer));
+}
+
+common::Result<std::shared_ptr<BpeTokenizer>> BpeTokenizer::LoadFromFile(const std::string& path) {
+    using ResultType = common::Result<std::shared_ptr<BpeTokenizer>>;
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return ResultType::Error("Cannot open tokenizer file: " + path);
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(kMagic))) {
+        ::close(fd);
+        return ResultType::Error("Invalid tokenizer file: " + path);
+    }
+
+    char magic[sizeof(kMagic)];
+    if (::pread(fd, magic, sizeof(magic), 0) != static_cast<ssize_t>(sizeof(magic))) {
+        ::close(fd);
+        return ResultType::Error("Cannot read tokenizer file: " + path);
+    }
+
+    // 编译后的二进制映像直接mmap
+    if (std::memcmp(magic, kMagic, sizeof(kMagic)) == 0) {
+        size_t size = static_cast<size_t>(st.st_size);
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            return ResultType::Error("Cannot mmap tokenizer file: " + path);
+        }
+
+        std::shared_ptr<BpeTokenizer> tokenizer(new BpeTokenizer());
+        tokenizer->mapped_ = mapped;
+        tokenizer->mapped_size_ = size;
+        auto attached = tokenizer->Attach(static_cast<const char*>(mapped), size);
+        if (attached.IsError()) {
+            return ResultType::Error(attached.GetError() + ": " + path);
+        }
+        return ResultType::Ok(std::move(tokenizer));
+    }
+    ::close(fd);
+
+    // tokenizer.json
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    auto root = json::parse(content.str(), nullptr, false);
+    if (root.is_discarded() || !root.contains("model") || !root["model"].is_object()) {
+        return ResultType::Error("Invalid tokenizer.json: " + path);
+    }
+
+    const auto& model = root["model"];
+    if (!model.contains("vocab") || !model["vocab"].is_object() ||
+        !model.contains("merges") || !model["merges"].is_array()) {
+        return ResultType::Error("tokenizer.json has no BPE vocab/merges: " + path);
+    }
+
+    auto table = UnicodeToByteTable();
+    std::vector<std::string> tokens;
+    std::unordered_map<std::string, std::string> decoded;
+    std::string bytes;
+
+    auto place = [&](size_t id, const std::string& value) {
+        if (id >= kEmptySlot) {
+            return;
+        }
+        if (tokens.size() <= id) {
+            tokens.resize(id + 1);
+        }
+        tokens[id] = value;
+    };
+
+    for (const auto& [token, id] : model["vocab"].items()) {
+        if (!id.is_number_unsigned()) {
+            continue;
+        }
+        // 不在字节映射表内的token按原始UTF-8保存
+        std::string raw = DecodeByteLevel(token, table, bytes) ? bytes : token;
+        place(id.get<size_t>(), raw);
+        decoded.emplace(token, std::move(raw));
+    }
+
+    // 特殊token按原文保存，只用于解码
+    if (root.contains("added_tokens") && root["added_tokens"].is_array()) {
+        for (const auto& added : root["added_tokens"]) {
+            if (added.contains("id") && added["id"].is_number_unsigned() &&
+                added.contains("content") && added["content"].is_string()) {
+                place(added["id"].get<size_t>(), added["content"].get<std::string>());
+            }
+        }
+    }
+
+    std::vector<std::pair<std::string, std::string>> merges;
+    merges.reserve(model["merges"].size());
+    auto raw_of = [&](const std::string& token) {
+        auto it = decoded.find(token);
+        return it != decoded.end() ? it->second : token;
+    };
+    for (const auto& merge : model["merges"]) {
+        if (merge.is_string()) {
+            const auto& text = merge.get_ref<const std::string&>();
+            size_t space = text.find(' ');
+            if (space == std::string::npos) {
+                continue;
+            }
+            merges.emplace_back(raw_of(text.substr(0, space)), raw_of(text.substr(space + 1)));
+        } else if (merge.is_array() && merge.size() == 2 && merge[0].is_string() && merge[1].is_string()) {
+            merges.emplace_back(raw_of(merge[0].get<std::string>()), raw_of(merge[1].get<std::string>()));
+        }
+    }
+
+    return Build(tokens, merges);
+}
+
+common::Result<void> BpeTokenizer::SaveCompiled(const std::string& path) const {
+    const char* image = reinterpret_cast<const char*>(header_);
+    size_t size = IsMapped() ? mapped_size_ : owned_.size();
+
+    std::string temp_path = path + ".tmp";
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file.write(image, static_cast<std::streamsize>(size))) {
+        return common::Result<void>::Error("Cannot write tokenizer file: " + temp_path);
+    }
+    file.close();
+
+    // 先写临时文件再改名，正在mmap旧文件的进程不受影响
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        return common::Result<void>::Error("Cannot rename tokenizer file to: " + path);
+    }
+    return common::Result<void>::Ok();
+}
+
+common::Result<void> BpeTokenizer::Attach(const char* image, size_t size) {
+    if (size < sizeof(Header)) {
+        return common::Result<void>::Error("Truncated tokenizer image");
+    }
+
+    header_ = reinterpret_cast<const Header*>(image);
+    if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0 || header_->version != kVersion) {
+        return common::Result<void>::Error("Unsupported tokenizer image version");
+    }
+
+    auto is_power_of_two = [](uint32_t value) { return value != 0 && (value & (value - 1)) == 0; };
+    if (!is_power_of_two(header_->vocab_slot_count) || !is_power_of_two(header_->merge_slot_count)) {
+        return common::Result<void>::Error("Corrupted tokenizer image");
+    }
+
+    size_t tokens_offset = AlignUp(sizeof(Header));
+    size_t vocab_offset = AlignUp(tokens_offset + size_t{header_->vocab_size} * sizeof(TokenEntry));
+    size_t merge_offset = AlignUp(vocab_offset + size_t{header_->vocab_slot_count} * sizeof(uint32_t));
+    size_t blob_offset = AlignUp(merge_offset + size_t{header_->merge_slot_count} * sizeof(MergeEntry));
+    if (blob_offset + header_->blob_size != size) {
+        return common::Result<void>::Error("Corrupted tokenizer image");
+    }
+
+    tokens_ = reinterpret_cast<const TokenEntry*>(image + tokens_offset);
+    vocab_slots_ = reinterpret_cast<const uint32_t*>(image + vocab_offset);
+    merge_slots_ = reinterpret_cast<const MergeEntry*>(image + merge_offset);
+    blob_ = image + blob_offset;
+
+    for (uint32_t id = 0; id < header_->vocab_size; ++id) {
+        if (size_t{tokens_[id].offset} + tokens_[id].length > header_->blob_size) {
+            return common::Result<void>::Error("Corrupted tokenizer image");
+        }
+    }
+
+    // 字节级BPE要求所有单字节都有对应token
+    for (int b = 0; b < 256; ++b) {
+        char byte = static_cast<char>(b);
+        if (!Lookup(std::string_view(&byte, 1), byte_tokens_[b])) {
+            return common::Result<void>::Error("Vocabulary is missing byte token " + std::to_string(b));
+        }
+    }
+    return common::Result<void>::Ok();
+}
+
+bool BpeTokenizer::Lookup(std::string_view bytes, TokenId& id) const {
+    uint32_t mask = header_->vocab_slot_count - 1;
+    for (uint64_t slot = HashBytes(bytes) & mask;; slot = (slot + 1) & mask) {
+        uint32_t candidate = vocab_slots_[slot];
+        if (candidate == kEmptySlot) {
+            return false;
+        }
+        const auto& entry = tokens_[candidate];
+        if (entry.length == bytes.size() && std::memcmp(blob_ + entry.offset, bytes.data(), bytes.size()) == 0) {
+            id = candidate;
+            return true;
+        }
+    }
+}
+
+bool BpeTokenizer::FindMerge(TokenId left, TokenId right, uint32_t& rank, TokenId& merged) const {
+    uint32_t mask = header_->merge_slot_count - 1;
+    for (uint64_t slot = HashPair(left, right) & mask;; slot = (slot + 1) & mask) {
+        const auto& entry = merge_slots_[slot];
+        if (entry.left == kEmptySlot) {
+            return false;
+        }
+        if (entry.left == left && entry.right == right) {
+            rank = entry.rank;
+            merged = entry.merged;
+            return true;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// BPE合并
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// 短片段直接线性扫描，长片段 (如长段CJK) 用堆避免O(n^2)
+constexpr size_t kSmallPieceLimit = 64;
+constexpr uint32_t kNoRank = 0xFFFFFFFFu;
+
+} // namespace
+
+template<typename Emit>
+void BpeTokenizer::EncodePiece(std::string_view piece, Emit&& emit) const {
+    if (piece.size() == 1) {
+        emit(byte_tokens_[static_cast<uint8_t>(piece[0])]);
+        return;
+    }
+
+    // 整个片段就是一个token时跳过合并
+    TokenId whole;
+    if (Lookup(piece, whole)) {
+        emit(whole);
+        return;
+    }
+
+    if (piece.size() <= kSmallPieceLimit) {
+        MergeSmall(piece, emit);
+    } else {
+        MergeLarge(piece, emit);
+    }
+}
+
+template<typename Emit>
+void BpeTokenizer::MergeSmall(std::string_view piece, Emit&& emit) const {
+    boost::container::small_vector<TokenId, kSmallPieceLimit> symbols;
+    boost::container::small_vector<uint32_t, kSmallPieceLimit> ranks;
+    boost::container::small_vector<TokenId, kSmallPieceLimit> merged_ids;
+
+    for (char c : piece) {
+        symbols.push_back(byte_tokens_[static_cast<uint8_t>(c)]);
+    }
+
+    // ranks[i]是symbols[i]与symbols[i+1]合并的优先级
+    auto pair_rank = [&](size_t i, TokenId& merged) {
+        uint32_t rank;
+        return FindMerge(symbols[i], symbols[i + 1], rank, merged) ? rank : kNoRank;
+    };
+    ranks.resize(symbols.size() - 1);
+    merged_ids.resize(symbols.size() - 1);
+    for (size_t i = 0; i + 1 < symbols.size(); ++i) {
+        ranks[i] = pair_rank(i, merged_ids[i]);
+    }
+
+    while (symbols.size() > 1) {
+        auto best = std::min_element(ranks.begin(), ranks.end());
+        if (*best == kNoRank) {
+            break;
+        }
+        size_t i = static_cast<size_t>(best - ranks.begin());
+
+        symbols[i] = merged_ids[i];
+        symbols.erase(symbols.begin() + static_cast<std::ptrdiff_t>(i) + 1);
+        ranks.erase(ranks.begin() + static_cast<std::ptrdiff_t>(i));
+        merged_ids.erase(merged_ids.begin() + static_cast<std::ptrdiff_t>(i));
+
+        if (i < ranks.size()) {
+            ranks[i] = pair_rank(i, merged_ids[i]);
+        }
+        if (i > 0) {
+            ranks[i - 1] = pair_rank(i - 1, merged_ids[i - 1]);
+        }
+    }
+
+    for (TokenId id : symbols) {
+        emit(id);
+    }
+}
+
+template<typename Emit>
+void BpeTokenizer::MergeLarge(std::string_view piece, Emit&& emit) const {
+    // 双向链表 + 最小堆，堆中过期的候选通过版本号识别
+    const size_t n = piece.size();
+    std::vector<TokenId> symbols(n);
+    std::vector<int32_t> prev(n), next(n);
+    std::vector<uint32_t> version(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        symbols[i] = byte_tokens_[static_cast<uint8_t>(piece[i])];
+        prev[i] = static_cast<int32_t>(i) - 1;
+        next[i] = i + 1 < n ? static_cast<int32_t>(i + 1) : -1;
+    }
+
+    struct Candidate {
+        uint32_t rank;
+        int32_t left;
+        uint32_t left_version;
+        uint32_t right_version;
+        TokenId merged;
+        bool operator>(const Candidate& other) const {
+            return rank != other.rank ? rank > other.rank : left > other.left;
+        }
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> heap;
+
+    auto push = [&](int32_t left) {
+        if (left < 0 || next[left] < 0) {
+            return;
+        }
+        int32_t right = next[left];
+        uint32_t rank;
+        TokenId merged;
+        if (FindMerge(symbols[left], symbols[right], rank, merged)) {
+            heap.push({rank, left, version[left], version[right], merged});
+        }
+    };
+
+    for (size_t i = 0; i + 1 < n; ++i) {
+        push(static_cast<int32_t>(i));
+    }
+
+    while (!heap.empty()) {
+        auto candidate = heap.top();
+        heap.pop();
+
+        int32_t left = candidate.left;
+        int32_t right = next[left];
+        if (right < 0 || version[left] != candidate.left_version || version[right] != candidate.right_version) {
+            continue;
+        }
+
+        // 合并到left，right从链表中摘除
+        symbols[left] = candidate.merged;
+        version[left]++;
+        version[right]++;
+        next[left] = next[right];
+        if (next[right] >= 0) {
+            prev[next[right]] = left;
+        }
+
+        push(prev[left]);
+        push(left);
+    }
+
+    for (int32_t i = 0; i >= 0; i = next[i]) {
+        emit(symbols[i]);
+    }
+}
+
+void BpeTokenizer::Encode(std::string_view text, std::vector<TokenId>& out) const {
+    for (size_t pos = 0; pos < text.size();) {
+        size_t end = NextPretokenEnd(text, pos);
+        EncodePiece(text.substr(pos, end - pos), [&](TokenId id) { out.push_back(id); });
+        pos = end;
+    }
+}
+
+size_t BpeTokenizer::CountTokens(std::string_view text) const {
+    size_t count = 0;
+    for (size_t pos = 0; pos < text.size();) {
+        size_t end = NextPretokenEnd(text, pos);
+        EncodePiece(text.substr(pos, end - pos), [&](TokenId) { count++; });
+        pos = end;
+    }
+    return count;
+}
+
+std::string BpeTokenizer::Decode(const std::vector<TokenId>& tokens) const {
+    std::string text;
+    for (TokenId id : tokens) {
+        if (id < header_->vocab_size) {
+            text.append(blob_ + tokens_[id].offset, tokens_[id].length);
+        }
+    }
+    return text;
+}
+
+size_t BpeTokenizer::GetVocabSize() const {
+    return header_->vocab_size;
+}
+
+// ---------------------------------------------------------------------------
+// 流式计数
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// 末尾未完整的UTF-8序列的字节数
+size_t IncompleteUtf8Tail(std::string_view text) {
+    size_t limit = std::min<size_t>(text.size(), 3);
+    for (size_t i = 1; i <= limit; ++i) {
+        auto byte = static_cast<uint8_t>(text[text.size() - i]);
+        if ((byte & 0xC0) == 0x80) {
+            continue;
+        }
+        size_t expected = (byte & 0xE0) == 0xC0 ? 2 : (byte & 0xF0) == 0xE0 ? 3 : (byte & 0xF8) == 0xF0 ? 4 : 1;
+        return expected > i ? i : 0;
+    }
+    return 0;
+}
+
+} // namespace
+
+StreamingTokenCounter::StreamingTokenCounter(std::shared_ptr<const BpeTokenizer> tokenizer)
+    : tokenizer_(std::move(tokenizer)) {
+}
+
+void StreamingTokenCounter::Append(std::string_view delta) {
+    if (!tokenizer_) {
+        committed_ += EstimateTokens(delta);
+        return;
+    }
+
+    pending_.append(delta);
+
+    // 末尾不完整的UTF-8序列等下一个增量到达后再参与预分词
+    std::string_view complete(pending_);
+    complete.remove_suffix(IncompleteUtf8Tail(complete));
+
+    // 找到最后一个片段的起点，之前的片段都已确定
+    size_t last_start = 0;
+    for (size_t pos = 0; pos < complete.size();) {
+        size_t end = NextPretokenEnd(complete, pos);
+        if (end >= complete.size()) {
+            last_start = pos;
+            break;
+        }
+        pos = end;
+    }
+
+    if (last_start > 0) {
+        committed_ += tokenizer_->CountTokens(std::string_view(pending_).substr(0, last_start));
+        pending_.erase(0, last_start);
+    }
+}
+
+size_t StreamingTokenCounter::GetCount() const {
+    if (!tokenizer_) {
+        return committed_;
+    }
+    return committed_ + tokenizer_->CountTokens(pending_);
+}
+
+} // namespace ai_backend::services::ai::tokenizer
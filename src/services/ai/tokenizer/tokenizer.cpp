@@ -0,0 +1,48 @@
+#include "services/ai/tokenizer/tokenizer.h"
+#include "core/config/config_manager.h"
+#include <spdlog/spdlog.h>
+
+namespace ai_backend::services::ai::tokenizer {
+
+Tokenizer& Tokenizer::GetInstance() {
+    static Tokenizer instance;
+    return instance;
+}
+
+void Tokenizer::Initialize() {
+    auto& config = core::config::ConfigManager::GetInstance();
+    std::string path = config.GetString("ai.tokenizer.path", "");
+    if (path.empty()) {
+        spdlog::info("Tokenizer vocabulary not configured, using estimated token counts");
+        return;
+    }
+
+    auto result = BpeTokenizer::LoadFromFile(path);
+    if (result.IsError()) {
+        spdlog::error("Failed to load tokenizer: {}", result.GetError());
+        return;
+    }
+
+    bpe_ = result.GetValue();
+    spdlog::info("Tokenizer loaded from {} ({} tokens, {})", path, bpe_->GetVocabSize(),
+                 bpe_->IsMapped() ? "mmap" : "compiled in memory");
+
+    // 从tokenizer.json加载时生成二进制文件，下次启动直接mmap
+    std::string compiled_path = config.GetString("ai.tokenizer.compiled_path", "");
+    if (!compiled_path.empty() && !bpe_->IsMapped()) {
+        auto saved = bpe_->SaveCompiled(compiled_path);
+        if (saved.IsError()) {
+            spdlog::warn("Failed to save compiled tokenizer: {}", saved.GetError());
+        }
+    }
+}
+
+size_t Tokenizer::CountTokens(std::string_view text) const {
+    return bpe_ ? bpe_->CountTokens(text) : EstimateTokens(text);
+}
+
+StreamingTokenCounter Tokenizer::CreateStreamingCounter() const {
+    return StreamingTokenCounter(bpe_);
+}
+
+} // namespace ai_backend::services::ai::tokenizer
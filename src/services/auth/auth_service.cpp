@@ -5,7 +5,6 @@
 #include "core/config/config_manager.h"
 #include "core/db/connection_pool.h"
 #include <spdlog/spdlog.h>
-#include <pqxx/pqxx>
 #include <openssl/evp.h>
 #include <openssl/sha.h>
 #include <chrono>
@@ -1,8 +1,8 @@
 #include "services/dialog/dialog_service.h"
 #include "core/utils/uuid.h"
 #include "core/db/connection_pool.h"
+#include "core/db/transaction.h"
 #include <spdlog/spdlog.h>
-#include <pqxx/pqxx>
 
 namespace ai_backend::services::dialog {
 
@@ -11,41 +11,38 @@ using namespace core::async;
 DialogService::DialogService() {
 }
 
-Task<common::Result<models::Dialog>> DialogService::GetDialogById(const std::string& dialog_id) {
+Task<common::Result<models::Dialog>> DialogService::GetDialogById(const std::string& dialog_id, Deadline deadline) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
-        auto result = txn.exec_params(
+        auto query = db_pool.Query(
             "SELECT id, user_id, title, model_id, is_archived, created_at, updated_at, "
             "(SELECT content FROM messages WHERE dialog_id = d.id ORDER BY created_at DESC LIMIT 1) as last_message "
             "FROM dialogs d WHERE id = $1",
-            dialog_id
+            {dialog_id},
+            deadline
         );
+        auto result = co_await query;
         
         if (result.empty()) {
-            db_pool.ReleaseConnection(conn);
             co_return common::Result<models::Dialog>::Error("对话不存在");
         }
         
         models::Dialog dialog;
-        dialog.id = result[0][0].as<std::string>();
-        dialog.user_id = result[0][1].as<std::string>();
-        dialog.title = result[0][2].as<std::string>();
-        dialog.model_id = result[0][3].as<std::string>();
-        dialog.is_archived = result[0][4].as<bool>();
-        dialog.created_at = result[0][5].as<std::string>();
-        dialog.updated_at = result[0][6].as<std::string>();
-        
-        if (!result[0][7].is_null()) {
-            dialog.last_message = result[0][7].as<std::string>();
+        dialog.id = result[0][0].As<std::string>();
+        dialog.user_id = result[0][1].As<std::string>();
+        dialog.title = result[0][2].As<std::string>();
+        dialog.model_id = result[0][3].As<std::string>();
+        dialog.is_archived = result[0][4].As<bool>();
+        dialog.created_at = result[0][5].As<std::string>();
+        dialog.updated_at = result[0][6].As<std::string>();
+        
+        if (!result[0][7].IsNull()) {
+            dialog.last_message = result[0][7].As<std::string>();
         }
         
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
-        
         co_return common::Result<models::Dialog>::Ok(dialog);
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in GetDialogById: {}", e.what());
         co_return common::Result<models::Dialog>::Error("获取对话失败");
@@ -53,134 +50,131 @@ Task<common::Result<models::Dialog>> DialogService::GetDialogById(const std::str
 }
 
 Task<common::Result<std::vector<models::Dialog>>> 
-DialogService::GetDialogsByUserId(const std::string& user_id, int page, int page_size, bool include_archived) {
+DialogService::GetDialogsByUserId(const std::string& user_id, int page, int page_size, bool include_archived,
+                                  Deadline deadline) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
         
-        std::string query =
+        std::string sql =
             "SELECT id, user_id, title, model_id, is_archived, created_at, updated_at, "
             "(SELECT content FROM messages WHERE dialog_id = d.id ORDER BY created_at DESC LIMIT 1) as last_message "
             "FROM dialogs d WHERE user_id = $1";
         
         if (!include_archived) {
-            query += " AND is_archived = false";
+            sql += " AND is_archived = false";
         }
         
-        query += " ORDER BY updated_at DESC LIMIT $2 OFFSET $3";
+        sql += " ORDER BY updated_at DESC LIMIT $2 OFFSET $3";
         
         int offset = (page - 1) * page_size;
-        auto result = txn.exec_params(
-            query,
-            user_id, page_size, offset
+        auto query = db_pool.Query(
+            std::move(sql),
+            {user_id, page_size, offset},
+            deadline
         );
+        auto result = co_await query;
         
         std::vector<models::Dialog> dialogs;
         for (const auto& row : result) {
             models::Dialog dialog;
-            dialog.id = row[0].as<std::string>();
-            dialog.user_id = row[1].as<std::string>();
-            dialog.title = row[2].as<std::string>();
-            dialog.model_id = row[3].as<std::string>();
-            dialog.is_archived = row[4].as<bool>();
-            dialog.created_at = row[5].as<std::string>();
-            dialog.updated_at = row[6].as<std::string>();
+            dialog.id = row[0].As<std::string>();
+            dialog.user_id = row[1].As<std::string>();
+            dialog.title = row[2].As<std::string>();
+            dialog.model_id = row[3].As<std::string>();
+            dialog.is_archived = row[4].As<bool>();
+            dialog.created_at = row[5].As<std::string>();
+            dialog.updated_at = row[6].As<std::string>();
             
-            if (!row[7].is_null()) {
-                dialog.last_message = row[7].as<std::string>();
+            if (!row[7].IsNull()) {
+                dialog.last_message = row[7].As<std::string>();
             }
             
             dialogs.push_back(dialog);
         }
         
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
-        
         co_return common::Result<std::vector<models::Dialog>>::Ok(dialogs);
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in GetDialogsByUserId: {}", e.what());
         co_return common::Result<std::vector<models::Dialog>>::Error("获取对话列表失败");
     }
 }
 
-Task<common::Result<models::Dialog>> DialogService::CreateDialog(const models::Dialog& dialog) {
+Task<common::Result<models::Dialog>> DialogService::CreateDialog(const models::Dialog& dialog, Deadline deadline) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
         
         // 生成UUID
         std::string dialog_id = core::utils::UuidGenerator::GenerateUuid();
         
-        pqxx::work txn(*conn);
-        txn.exec_params(
+        auto insert = db_pool.Query(
             "INSERT INTO dialogs (id, user_id, title, model_id, is_archived, created_at, updated_at) "
             "VALUES ($1, $2, $3, $4, $5, NOW(), NOW())",
-            dialog_id, dialog.user_id, dialog.title, dialog.model_id, dialog.is_archived
+            {dialog_id, dialog.user_id, dialog.title, dialog.model_id, dialog.is_archived},
+            deadline
         );
-        
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
+        co_await insert;
         
         // 获取新创建的对话
-        auto result = co_await GetDialogById(dialog_id);
+        auto result = co_await GetDialogById(dialog_id, deadline);
         
         co_return result;
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in CreateDialog: {}", e.what());
         co_return common::Result<models::Dialog>::Error("创建对话失败");
     }
 }
 
-Task<common::Result<models::Dialog>> DialogService::UpdateDialog(const models::Dialog& dialog) {
+Task<common::Result<models::Dialog>> DialogService::UpdateDialog(const models::Dialog& dialog, Deadline deadline) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
-        txn.exec_params(
+        auto update = db_pool.Query(
             "UPDATE dialogs SET title = $1, is_archived = $2, updated_at = NOW() "
             "WHERE id = $3",
-            dialog.title, dialog.is_archived, dialog.id
+            {dialog.title, dialog.is_archived, dialog.id},
+            deadline
         );
-        
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
+        co_await update;
         
         // 获取更新后的对话
-        auto result = co_await GetDialogById(dialog.id);
+        auto result = co_await GetDialogById(dialog.id, deadline);
         
         co_return result;
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in UpdateDialog: {}", e.what());
         co_return common::Result<models::Dialog>::Error("更新对话失败");
     }
 }
 
-Task<common::Result<void>> DialogService::DeleteDialog(const std::string& dialog_id) {
+Task<common::Result<void>> DialogService::DeleteDialog(const std::string& dialog_id, Deadline deadline) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
+        auto txn = co_await db_pool.BeginTransaction(deadline);
         
         // 先删除对话中的所有消息
-        txn.exec_params(
+        auto delete_messages = txn.Query(
             "DELETE FROM messages WHERE dialog_id = $1",
-            dialog_id
+            {dialog_id}
         );
+        co_await delete_messages;
         
         // 然后删除对话
-        txn.exec_params(
+        auto delete_dialog = txn.Query(
             "DELETE FROM dialogs WHERE id = $1",
-            dialog_id
+            {dialog_id}
         );
+        co_await delete_dialog;
         
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
+        co_await txn.Commit();
         
         co_return common::Result<void>::Ok();
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in DeleteDialog: {}", e.what());
         co_return common::Result<void>::Error("删除对话失败");
@@ -188,31 +182,30 @@ Task<common::Result<void>> DialogService::DeleteDialog(const std::string& dialog
 }
 
 Task<common::Result<std::string>> 
-DialogService::ValidateDialogOwnership(const std::string& dialog_id, const std::string& user_id) {
+DialogService::ValidateDialogOwnership(const std::string& dialog_id, const std::string& user_id,
+                                       Deadline deadline) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
-        auto result = txn.exec_params(
+        auto query = db_pool.Query(
             "SELECT user_id FROM dialogs WHERE id = $1",
-            dialog_id
+            {dialog_id},
+            deadline
         );
+        auto result = co_await query;
         
         if (result.empty()) {
-            db_pool.ReleaseConnection(conn);
             co_return common::Result<std::string>::Error("对话不存在");
         }
         
-        std::string owner_id = result[0][0].as<std::string>();
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
+        std::string owner_id = result[0][0].As<std::string>();
         
         if (owner_id != user_id) {
             co_return common::Result<std::string>::Error("无权访问此对话");
         }
         
         co_return common::Result<std::string>::Ok(owner_id);
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in ValidateDialogOwnership: {}", e.what());
         co_return common::Result<std::string>::Error("验证对话所有权失败");
@@ -4,7 +4,6 @@
 #include "core/config/config_manager.h"
 #include "core/db/connection_pool.h"
 #include <spdlog/spdlog.h>
-#include <pqxx/pqxx>
 #include <fstream>
 #include <regex>
 #include <filesystem>
@@ -132,19 +131,14 @@ FileService::SaveFile(const models::File& file_info, const std::vector<uint8_t>&
         
         // 保存文件记录到数据库
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
-        txn.exec_params(
+        auto insert = db_pool.Query(
             "INSERT INTO files (id, user_id, message_id, name, type, size, url, created_at) "
             "VALUES ($1, $2, $3, $4, $5, $6, $7, NOW())",
-            file_id, file_info.user_id, file_info.message_id, safe_filename, 
-            detected_mime.empty() ? file_info.type : detected_mime,
-            data.size(), url
+            {file_id, file_info.user_id, file_info.message_id, safe_filename, 
+             detected_mime.empty() ? file_info.type : detected_mime,
+             data.size(), url}
         );
-        
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
+        co_await insert;
         
         // 返回完整的文件信息
         models::File saved_file = file_info;
@@ -203,34 +197,28 @@ Task<common::Result<models::File>>
 FileService::GetFileById(const std::string& file_id) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
-        auto result = txn.exec_params(
+        auto query = db_pool.Query(
             "SELECT id, user_id, message_id, name, type, size, url, created_at "
             "FROM files WHERE id = $1",
-            file_id
+            {file_id}
         );
+        auto result = co_await query;
         
         if (result.empty()) {
-            db_pool.ReleaseConnection(conn);
             co_return common::Result<models::File>::Error("文件不存在");
         }
         
         models::File file;
-        file.id = result[0][0].as<std::string>();
-        file.user_id = result[0][1].as<std::string>();
-        if (!result[0][2].is_null()) {
-            file.message_id = result[0][2].as<std::string>();
+        file.id = result[0][0].As<std::string>();
+        file.user_id = result[0][1].As<std::string>();
+        if (!result[0][2].IsNull()) {
+            file.message_id = result[0][2].As<std::string>();
         }
-        file.name = result[0][3].as<std::string>();
-        file.type = result[0][4].as<std::string>();
-        file.size = result[0][5].as<size_t>();
-        file.url = result[0][6].as<std::string>();
-        file.created_at = result[0][7].as<std::string>();
-        
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
+        file.name = result[0][3].As<std::string>();
+        file.type = result[0][4].As<std::string>();
+        file.size = result[0][5].As<size_t>();
+        file.url = result[0][6].As<std::string>();
+        file.created_at = result[0][7].As<std::string>();
         
         co_return common::Result<models::File>::Ok(file);
     } catch (const std::exception& e) {
@@ -243,38 +231,32 @@ Task<common::Result<std::vector<models::File>>>
 FileService::GetFilesByUserId(const std::string& user_id, int page, int page_size) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
-        
         int offset = (page - 1) * page_size;
-        auto result = txn.exec_params(
+        auto query = db_pool.Query(
             "SELECT id, user_id, message_id, name, type, size, url, created_at "
             "FROM files WHERE user_id = $1 "
             "ORDER BY created_at DESC LIMIT $2 OFFSET $3",
-            user_id, page_size, offset
+            {user_id, page_size, offset}
         );
+        auto result = co_await query;
         
         std::vector<models::File> files;
         for (const auto& row : result) {
             models::File file;
-            file.id = row[0].as<std::string>();
-            file.user_id = row[1].as<std::string>();
-            if (!row[2].is_null()) {
-                file.message_id = row[2].as<std::string>();
+            file.id = row[0].As<std::string>();
+            file.user_id = row[1].As<std::string>();
+            if (!row[2].IsNull()) {
+                file.message_id = row[2].As<std::string>();
             }
-            file.name = row[3].as<std::string>();
-            file.type = row[4].as<std::string>();
-            file.size = row[5].as<size_t>();
-            file.url = row[6].as<std::string>();
-            file.created_at = row[7].as<std::string>();
+            file.name = row[3].As<std::string>();
+            file.type = row[4].As<std::string>();
+            file.size = row[5].As<size_t>();
+            file.url = row[6].As<std::string>();
+            file.created_at = row[7].As<std::string>();
             
             files.push_back(file);
         }
         
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
-        
         co_return common::Result<std::vector<models::File>>::Ok(files);
     } catch (const std::exception& e) {
         spdlog::error("Error in GetFilesByUserId: {}", e.what());
@@ -286,33 +268,28 @@ Task<common::Result<std::vector<models::File>>>
 FileService::GetFilesByMessageId(const std::string& message_id) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
-        auto result = txn.exec_params(
+        auto query = db_pool.Query(
             "SELECT id, user_id, message_id, name, type, size, url, created_at "
             "FROM files WHERE message_id = $1",
-            message_id
+            {message_id}
         );
+        auto result = co_await query;
         
         std::vector<models::File> files;
         for (const auto& row : result) {
             models::File file;
-            file.id = row[0].as<std::string>();
-            file.user_id = row[1].as<std::string>();
-            file.message_id = row[2].as<std::string>();
-            file.name = row[3].as<std::string>();
-            file.type = row[4].as<std::string>();
-            file.size = row[5].as<size_t>();
-            file.url = row[6].as<std::string>();
-            file.created_at = row[7].as<std::string>();
+            file.id = row[0].As<std::string>();
+            file.user_id = row[1].As<std::string>();
+            file.message_id = row[2].As<std::string>();
+            file.name = row[3].As<std::string>();
+            file.type = row[4].As<std::string>();
+            file.size = row[5].As<size_t>();
+            file.url = row[6].As<std::string>();
+            file.created_at = row[7].As<std::string>();
             
             files.push_back(file);
         }
         
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
-        
         co_return common::Result<std::vector<models::File>>::Ok(files);
     } catch (const std::exception& e) {
         spdlog::error("Error in GetFilesByMessageId: {}", e.what());
@@ -374,13 +351,7 @@ FileService::DeleteFile(const std::string& file_id) {
         
         // 从数据库中删除文件记录
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
         txn.exec_params("DELETE FROM files WHERE id = $1", file_id);
-        txn.commit();
-        
-        db_pool.ReleaseConnection(conn);
         
         // 从文件系统中删除文件
         if (fs::exists(filepath)) {
@@ -436,34 +407,28 @@ Task<common::Result<models::File>>
 FileService::GetFileById(const std::string& file_id) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
-        auto result = txn.exec_params(
+        auto query = db_pool.Query(
             "SELECT id, user_id, message_id, name, type, size, url, created_at "
             "FROM files WHERE id = $1",
-            file_id
+            {file_id}
         );
+        auto result = co_await query;
         
         if (result.empty()) {
-            db_pool.ReleaseConnection(conn);
             co_return common::Result<models::File>::Error("文件不存在");
         }
         
         models::File file;
-        file.id = result[0][0].as<std::string>();
-        file.user_id = result[0][1].as<std::string>();
-        if (!result[0][2].is_null()) {
-            file.message_id = result[0][2].as<std::string>();
+        file.id = result[0][0].As<std::string>();
+        file.user_id = result[0][1].As<std::string>();
+        if (!result[0][2].IsNull()) {
+            file.message_id = result[0][2].As<std::string>();
         }
-        file.name = result[0][3].as<std::string>();
-        file.type = result[0][4].as<std::string>();
-        file.size = result[0][5].as<size_t>();
-        file.url = result[0][6].as<std::string>();
-        file.created_at = result[0][7].as<std::string>();
-        
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
+        file.name = result[0][3].As<std::string>();
+        file.type = result[0][4].As<std::string>();
+        file.size = result[0][5].As<size_t>();
+        file.url = result[0][6].As<std::string>();
+        file.created_at = result[0][7].As<std::string>();
         
         co_return common::Result<models::File>::Ok(file);
     } catch (const std::exception& e) {
@@ -476,38 +441,32 @@ Task<common::Result<std::vector<models::File>>>
 FileService::GetFilesByUserId(const std::string& user_id, int page, int page_size) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
-        
         int offset = (page - 1) * page_size;
-        auto result = txn.exec_params(
+        auto query = db_pool.Query(
             "SELECT id, user_id, message_id, name, type, size, url, created_at "
             "FROM files WHERE user_id = $1 "
             "ORDER BY created_at DESC LIMIT $2 OFFSET $3",
-            user_id, page_size, offset
+            {user_id, page_size, offset}
         );
+        auto result = co_await query;
         
         std::vector<models::File> files;
         for (const auto& row : result) {
             models::File file;
-            file.id = row[0].as<std::string>();
-            file.user_id = row[1].as<std::string>();
-            if (!row[2].is_null()) {
-                file.message_id = row[2].as<std::string>();
+            file.id = row[0].As<std::string>();
+            file.user_id = row[1].As<std::string>();
+            if (!row[2].IsNull()) {
+                file.message_id = row[2].As<std::string>();
             }
-            file.name = row[3].as<std::string>();
-            file.type = row[4].as<std::string>();
-            file.size = row[5].as<size_t>();
-            file.url = row[6].as<std::string>();
-            file.created_at = row[7].as<std::string>();
+            file.name = row[3].As<std::string>();
+            file.type = row[4].As<std::string>();
+            file.size = row[5].As<size_t>();
+            file.url = row[6].As<std::string>();
+            file.created_at = row[7].As<std::string>();
             
             files.push_back(file);
         }
         
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
-        
         co_return common::Result<std::vector<models::File>>::Ok(files);
     } catch (const std::exception& e) {
         spdlog::error("Error in GetFilesByUserId: {}", e.what());
@@ -519,33 +478,28 @@ Task<common::Result<std::vector<models::File>>>
 FileService::GetFilesByMessageId(const std::string& message_id) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
-        auto result = txn.exec_params(
+        auto query = db_pool.Query(
             "SELECT id, user_id, message_id, name, type, size, url, created_at "
             "FROM files WHERE message_id = $1",
-            message_id
+            {message_id}
         );
+        auto result = co_await query;
         
         std::vector<models::File> files;
         for (const auto& row : result) {
             models::File file;
-            file.id = row[0].as<std::string>();
-            file.user_id = row[1].as<std::string>();
-            file.message_id = row[2].as<std::string>();
-            file.name = row[3].as<std::string>();
-            file.type = row[4].as<std::string>();
-            file.size = row[5].as<size_t>();
-            file.url = row[6].as<std::string>();
-            file.created_at = row[7].as<std::string>();
+            file.id = row[0].As<std::string>();
+            file.user_id = row[1].As<std::string>();
+            file.message_id = row[2].As<std::string>();
+            file.name = row[3].As<std::string>();
+            file.type = row[4].As<std::string>();
+            file.size = row[5].As<size_t>();
+            file.url = row[6].As<std::string>();
+            file.created_at = row[7].As<std::string>();
             
             files.push_back(file);
         }
         
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
-        
         co_return common::Result<std::vector<models::File>>::Ok(files);
     } catch (const std::exception& e) {
         spdlog::error("Error in GetFilesByMessageId: {}", e.what());
@@ -607,13 +561,7 @@ FileService::DeleteFile(const std::string& file_id) {
         
         // 从数据库中删除文件记录
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
         txn.exec_params("DELETE FROM files WHERE id = $1", file_id);
-        txn.commit();
-        
-        db_pool.ReleaseConnection(conn);
         
         // 从文件系统中删除文件
         if (fs::exists(filepath)) {
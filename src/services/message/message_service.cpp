@@ -1,8 +1,9 @@
 #include "services/message/message_service.h"
 #include "core/utils/uuid.h"
 #include "core/db/connection_pool.h"
+#include "core/db/transaction.h"
+#include "services/ai/tokenizer/tokenizer.h"
 #include <spdlog/spdlog.h>
-#include <pqxx/pqxx>
 
 namespace ai_backend::services::message {
 
@@ -12,166 +13,172 @@ MessageService::MessageService() {
 }
 
 Task<common::Result<models::Message>> 
-MessageService::GetMessageById(const std::string& message_id) {
+MessageService::GetMessageById(const std::string& message_id, Deadline deadline) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
+        auto conn = co_await db_pool.Acquire(deadline);
         
-        pqxx::work txn(*conn);
-        auto result = txn.exec_params(
+        auto query = conn->Query(
             "SELECT id, dialog_id, role, content, type, tokens, created_at "
             "FROM messages WHERE id = $1",
-            message_id
+            {message_id},
+            deadline
         );
+        auto result = co_await query;
         
         if (result.empty()) {
-            db_pool.ReleaseConnection(conn);
             co_return common::Result<models::Message>::Error("消息不存在");
         }
         
         models::Message message;
-        message.id = result[0][0].as<std::string>();
-        message.dialog_id = result[0][1].as<std::string>();
-        message.role = result[0][2].as<std::string>();
-        message.content = result[0][3].as<std::string>();
-        message.type = result[0][4].as<std::string>();
-        message.tokens = result[0][5].as<size_t>();
-        message.created_at = result[0][6].as<std::string>();
+        message.id = result[0][0].As<std::string>();
+        message.dialog_id = result[0][1].As<std::string>();
+        message.role = result[0][2].As<std::string>();
+        message.content = result[0][3].As<std::string>();
+        message.type = result[0][4].As<std::string>();
+        message.tokens = result[0][5].As<size_t>();
+        message.created_at = result[0][6].As<std::string>();
         
         // 获取附件
-        auto file_result = txn.exec_params(
+        auto file_query = conn->Query(
             "SELECT id, name, type, url FROM files WHERE message_id = $1",
-            message_id
+            {message_id},
+            deadline
         );
+        auto file_result = co_await file_query;
         
         for (const auto& row : file_result) {
             models::Attachment attachment;
-            attachment.id = row[0].as<std::string>();
-            attachment.name = row[1].as<std::string>();
-            attachment.type = row[2].as<std::string>();
-            attachment.url = row[3].as<std::string>();
+            attachment.id = row[0].As<std::string>();
+            attachment.name = row[1].As<std::string>();
+            attachment.type = row[2].As<std::string>();
+            attachment.url = row[3].As<std::string>();
             
             message.attachments.push_back(attachment);
         }
         
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
-        
         co_return common::Result<models::Message>::Ok(message);
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in GetMessageById: {}", e.what());
         co_return common::Result<models::Message>::Error("获取消息失败");
     }
 }
 
-Task<common::Result<std::vector<models::Message>>> 
-MessageService::GetMessagesByDialogId(const std::string& dialog_id, int page, int page_size) {
+Task<common::Result<std::pmr::vector<models::pmr::Message>>> 
+MessageService::GetMessagesByDialogId(const std::string& dialog_id, int page, int page_size,
+                                      std::pmr::memory_resource* memory, Deadline deadline) {
+    using MessageList = std::pmr::vector<models::pmr::Message>;
+    
+    // 字段通过View直接从PGresult的缓冲区复制到memory，不经过临时std::string
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
+        auto conn = co_await db_pool.Acquire(deadline);
         
         int offset = (page - 1) * page_size;
-        auto result = txn.exec_params(
+        auto query = conn->Query(
             "SELECT id, dialog_id, role, content, type, tokens, created_at "
             "FROM messages WHERE dialog_id = $1 "
             "ORDER BY created_at DESC LIMIT $2 OFFSET $3",
-            dialog_id, page_size, offset
+            {dialog_id, page_size, offset},
+            deadline
         );
+        auto result = co_await query;
         
-        std::vector<models::Message> messages;
+        MessageList messages(memory);
+        messages.reserve(result.size());
         for (const auto& row : result) {
-            models::Message message;
-            message.id = row[0].as<std::string>();
-            message.dialog_id = row[1].as<std::string>();
-            message.role = row[2].as<std::string>();
-            message.content = row[3].as<std::string>();
-            message.type = row[4].as<std::string>();
-            message.tokens = row[5].as<size_t>();
-            message.created_at = row[6].as<std::string>();
-            
-            messages.push_back(message);
+            auto& message = messages.emplace_back();
+            message.id = row[0].View();
+            message.dialog_id = row[1].View();
+            message.role = row[2].View();
+            message.content = row[3].View();
+            message.type = row[4].View();
+            message.tokens = row[5].As<size_t>();
+            message.created_at = row[6].View();
         }
         
         // 获取所有消息的附件
         for (auto& message : messages) {
-            auto file_result = txn.exec_params(
+            auto file_query = conn->Query(
                 "SELECT id, name, type, url FROM files WHERE message_id = $1",
-                message.id
+                {std::string_view(message.id)},
+                deadline
             );
+            auto file_result = co_await file_query;
             
+            message.attachments.reserve(file_result.size());
             for (const auto& row : file_result) {
-                models::Attachment attachment;
-                attachment.id = row[0].as<std::string>();
-                attachment.name = row[1].as<std::string>();
-                attachment.type = row[2].as<std::string>();
-                attachment.url = row[3].as<std::string>();
-                
-                message.attachments.push_back(attachment);
+                auto& attachment = message.attachments.emplace_back();
+                attachment.id = row[0].View();
+                attachment.name = row[1].View();
+                attachment.type = row[2].View();
+                attachment.url = row[3].View();
             }
         }
         
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
-        
-        co_return common::Result<std::vector<models::Message>>::Ok(messages);
+        co_return common::Result<MessageList>::Ok(std::move(messages));
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in GetMessagesByDialogId: {}", e.what());
-        co_return common::Result<std::vector<models::Message>>::Error("获取消息列表失败");
+        co_return common::Result<MessageList>::Error("获取消息列表失败");
     }
 }
 
 Task<common::Result<std::vector<models::Message>>> 
-MessageService::GetAllMessagesByDialogId(const std::string& dialog_id) {
+MessageService::GetAllMessagesByDialogId(const std::string& dialog_id, Deadline deadline) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
+        auto conn = co_await db_pool.Acquire(deadline);
         
-        pqxx::work txn(*conn);
-        auto result = txn.exec_params(
+        auto query = conn->Query(
             "SELECT id, dialog_id, role, content, type, tokens, created_at "
             "FROM messages WHERE dialog_id = $1 "
             "ORDER BY created_at",
-            dialog_id
+            {dialog_id},
+            deadline
         );
+        auto result = co_await query;
         
         std::vector<models::Message> messages;
         for (const auto& row : result) {
             models::Message message;
-            message.id = row[0].as<std::string>();
-            message.dialog_id = row[1].as<std::string>();
-            message.role = row[2].as<std::string>();
-            message.content = row[3].as<std::string>();
-            message.type = row[4].as<std::string>();
-            message.tokens = row[5].as<size_t>();
-            message.created_at = row[6].as<std::string>();
+            message.id = row[0].As<std::string>();
+            message.dialog_id = row[1].As<std::string>();
+            message.role = row[2].As<std::string>();
+            message.content = row[3].As<std::string>();
+            message.type = row[4].As<std::string>();
+            message.tokens = row[5].As<size_t>();
+            message.created_at = row[6].As<std::string>();
             
             messages.push_back(message);
         }
         
         // 获取所有消息的附件
         for (auto& message : messages) {
-            auto file_result = txn.exec_params(
+            auto file_query = conn->Query(
                 "SELECT id, name, type, url FROM files WHERE message_id = $1",
-                message.id
+                {message.id},
+                deadline
             );
+            auto file_result = co_await file_query;
             
             for (const auto& row : file_result) {
                 models::Attachment attachment;
-                attachment.id = row[0].as<std::string>();
-                attachment.name = row[1].as<std::string>();
-                attachment.type = row[2].as<std::string>();
-                attachment.url = row[3].as<std::string>();
+                attachment.id = row[0].As<std::string>();
+                attachment.name = row[1].As<std::string>();
+                attachment.type = row[2].As<std::string>();
+                attachment.url = row[3].As<std::string>();
                 
                 message.attachments.push_back(attachment);
             }
         }
         
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
-        
         co_return common::Result<std::vector<models::Message>>::Ok(messages);
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in GetAllMessagesByDialogId: {}", e.what());
         co_return common::Result<std::vector<models::Message>>::Error("获取消息列表失败");
@@ -179,87 +186,93 @@ MessageService::GetAllMessagesByDialogId(const std::string& dialog_id) {
 }
 
 Task<common::Result<models::Message>> 
-MessageService::CreateMessage(const models::Message& message) {
+MessageService::CreateMessage(const models::Message& message, Deadline deadline) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
         
         // 生成UUID
         std::string message_id = core::utils::UuidGenerator::GenerateUuid();
         
-        pqxx::work txn(*conn);
-        
-        // 插入消息
-        txn.exec_params(
-            "INSERT INTO messages (id, dialog_id, role, content, type, tokens, created_at) "
-            "VALUES ($1, $2, $3, $4, $5, $6, NOW())",
-            message_id, message.dialog_id, message.role, message.content, message.type, message.tokens
-        );
-        
-        // 关联现有附件
-        for (const auto& attachment : message.attachments) {
-            txn.exec_params(
-                "UPDATE files SET message_id = $1 WHERE id = $2",
-                message_id, attachment.id
+        {
+            auto txn = co_await db_pool.BeginTransaction(deadline);
+            
+            // 插入消息
+            auto insert = txn.Query(
+                "INSERT INTO messages (id, dialog_id, role, content, type, tokens, created_at) "
+                "VALUES ($1, $2, $3, $4, $5, $6, NOW())",
+                {message_id, message.dialog_id, message.role, message.content, message.type, message.tokens}
+            );
+            co_await insert;
+            
+            // 关联现有附件
+            for (const auto& attachment : message.attachments) {
+                auto update = txn.Query(
+                    "UPDATE files SET message_id = $1 WHERE id = $2",
+                    {message_id, attachment.id}
+                );
+                co_await update;
+            }
+            
+            // 更新对话的更新时间
+            auto touch = txn.Query(
+                "UPDATE dialogs SET updated_at = NOW() WHERE id = $1",
+                {message.dialog_id}
             );
+            co_await touch;
+            
+            co_await txn.Commit();
         }
         
-        // 更新对话的更新时间
-        txn.exec_params(
-            "UPDATE dialogs SET updated_at = NOW() WHERE id = $1",
-            message.dialog_id
-        );
-        
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
-        
         // 获取新创建的消息
-        auto result = co_await GetMessageById(message_id);
+        auto result = co_await GetMessageById(message_id, deadline);
         
         co_return result;
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in CreateMessage: {}", e.what());
         co_return common::Result<models::Message>::Error("创建消息失败");
     }
 }
 
-Task<common::Result<void>> MessageService::DeleteMessage(const std::string& message_id) {
+Task<common::Result<void>> MessageService::DeleteMessage(const std::string& message_id, Deadline deadline) {
     try {
         auto& db_pool = core::db::ConnectionPool::GetInstance();
-        auto conn = co_await db_pool.GetConnectionAsync();
-        
-        pqxx::work txn(*conn);
+        auto txn = co_await db_pool.BeginTransaction(deadline);
         
         // 获取消息所属的对话ID
-        auto dialog_result = txn.exec_params(
+        auto select = txn.Query(
             "SELECT dialog_id FROM messages WHERE id = $1",
-            message_id
+            {message_id}
         );
+        auto dialog_result = co_await select;
         
         if (dialog_result.empty()) {
-            txn.abort();
-            db_pool.ReleaseConnection(conn);
+            co_await txn.Rollback();
             co_return common::Result<void>::Error("消息不存在");
         }
         
-        std::string dialog_id = dialog_result[0][0].as<std::string>();
+        std::string dialog_id = dialog_result[0][0].As<std::string>();
         
         // 删除消息
-        txn.exec_params(
+        auto remove = txn.Query(
             "DELETE FROM messages WHERE id = $1",
-            message_id
+            {message_id}
         );
+        co_await remove;
         
         // 更新对话的更新时间
-        txn.exec_params(
+        auto touch = txn.Query(
             "UPDATE dialogs SET updated_at = NOW() WHERE id = $1",
-            dialog_id
+            {dialog_id}
         );
+        co_await touch;
         
-        txn.commit();
-        db_pool.ReleaseConnection(conn);
+        co_await txn.Commit();
         
         co_return common::Result<void>::Ok();
+    } catch (const DeadlineExceeded&) {
+        throw;
     } catch (const std::exception& e) {
         spdlog::error("Error in DeleteMessage: {}", e.what());
         co_return common::Result<void>::Error("删除消息失败");
@@ -268,11 +281,9 @@ Task<common::Result<void>> MessageService::DeleteMessage(const std::string& mess
 
 Task<common::Result<int>> MessageService::CountTokens(const std::string& content) {
     try {
-        // 简单估算：按照4个字符约等于1个token
-        int estimated_tokens = static_cast<int>(content.size() / 4);
-        
-        // 返回估算的token数量
-        co_return common::Result<int>::Ok(estimated_tokens);
+        // 配置了词表时为精确计数，否则为估算值
+        auto tokens = ai::tokenizer::Tokenizer::GetInstance().CountTokens(content);
+        co_return common::Result<int>::Ok(static_cast<int>(tokens));
     } catch (const std::exception& e) {
         spdlog::error("Error in CountTokens: {}", e.what());
         co_return common::Result<int>::Error("计算token失败");
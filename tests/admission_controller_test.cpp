@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <optional>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "core/async/codel.h"
+#include "core/http/admission_controller.h"
+
+namespace ai_backend::test {
+
+using core::async::CoDel;
+using core::async::Spawn;
+using core::async::Task;
+using core::http::AdmissionController;
+using core::http::AdmissionOptions;
+using core::http::AdmissionTicket;
+using core::http::RouteClassOptions;
+using namespace std::chrono_literals;
+
+namespace {
+
+AdmissionOptions LimitedOptions(size_t max_in_flight, size_t max_queue) {
+    AdmissionOptions options;
+    options.target = 50ms;
+    options.interval = 500ms;
+    options.max_queue_time = 100ms;
+    options.classes.push_back(RouteClassOptions{"reply", {"/api/v1/dialogs/*/messages"}, max_in_flight, max_queue});
+    return options;
+}
+
+// 在io_context上运行Admit，结果写入tickets[index]
+Task<void> AdmitInto(AdmissionController& admission, std::string path,
+                     boost::asio::any_io_executor executor,
+                     std::vector<std::optional<AdmissionTicket>>& tickets, size_t index) {
+    tickets[index] = co_await admission.Admit(path, AdmissionController::Clock::now(), executor);
+}
+
+} // namespace
+
+TEST(AdmissionControllerTest, CoDelOverloadsOnStandingQueue) {
+    CoDel codel(10ms, 100ms);
+    auto now = CoDel::Clock::now();
+
+    // 短暂的突发不算过载
+    EXPECT_FALSE(codel.OnDequeue(50ms, now));
+    EXPECT_FALSE(codel.OnDequeue(1ms, now + 50ms));
+    EXPECT_FALSE(codel.OnDequeue(50ms, now + 100ms));
+    EXPECT_FALSE(codel.IsOverloaded());
+    EXPECT_EQ(codel.GetQueueTimeout(1s), 1s);
+
+    // 整个窗口的排队时间都超过目标
+    EXPECT_FALSE(codel.OnDequeue(30ms, now + 150ms));
+    EXPECT_TRUE(codel.OnDequeue(30ms, now + 200ms));
+    EXPECT_TRUE(codel.IsOverloaded());
+    EXPECT_FALSE(codel.OnDequeue(15ms, now + 210ms));
+    EXPECT_EQ(codel.GetQueueTimeout(1s), 20ms);
+
+    // 排队回到目标以内后下一个窗口恢复
+    EXPECT_FALSE(codel.OnDequeue(1ms, now + 250ms));
+    EXPECT_FALSE(codel.OnDequeue(30ms, now + 300ms));
+    EXPECT_FALSE(codel.IsOverloaded());
+}
+
+TEST(AdmissionControllerTest, MatchesPatternsBySegment) {
+    EXPECT_TRUE(AdmissionController::MatchPattern("/api/v1/dialogs/*/messages", "/api/v1/dialogs/42/messages"));
+    EXPECT_TRUE(AdmissionController::MatchPattern("/api/v1/dialogs/*/messages",
+                                                  "/api/v1/dialogs/42/messages/7/reply"));
+    EXPECT_FALSE(AdmissionController::MatchPattern("/api/v1/dialogs/*/messages", "/api/v1/dialogs/42"));
+    EXPECT_FALSE(AdmissionController::MatchPattern("/api/v1/dialogs/*/messages", "/api/v1/dialogs/42/files"));
+    EXPECT_FALSE(AdmissionController::MatchPattern("/api/v1/files", "/api/v1/filesystem"));
+    EXPECT_TRUE(AdmissionController::MatchPattern("/", "/anything"));
+}
+
+TEST(AdmissionControllerTest, BoundsInFlightAndQueue) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    AdmissionController admission(LimitedOptions(1, 1));
+
+    std::vector<std::optional<AdmissionTicket>> tickets(4);
+    for (size_t i = 0; i < 3; ++i) {
+        Spawn(executor, AdmitInto(admission, "/api/v1/dialogs/1/messages", executor, tickets, i));
+    }
+    // 未匹配的路径走默认类别，不受限制
+    Spawn(executor, AdmitInto(admission, "/api/v1/models", executor, tickets, 3));
+    io_context.poll();
+
+    ASSERT_TRUE(tickets[0].has_value());
+    EXPECT_TRUE(*tickets[0]);
+    EXPECT_EQ(tickets[0]->GetRouteClass(), "reply");
+    EXPECT_FALSE(tickets[1].has_value());
+    ASSERT_TRUE(tickets[2].has_value());
+    EXPECT_FALSE(*tickets[2]);
+    ASSERT_TRUE(tickets[3].has_value());
+    EXPECT_EQ(tickets[3]->GetRouteClass(), "default");
+
+    // 归还名额后排队的请求被接纳
+    tickets[0]->Release();
+    io_context.poll();
+    ASSERT_TRUE(tickets[1].has_value());
+    EXPECT_TRUE(*tickets[1]);
+
+    auto stats = admission.GetStats();
+    ASSERT_EQ(stats.classes.size(), 2u);
+    EXPECT_EQ(stats.classes[0].name, "reply");
+    EXPECT_EQ(stats.classes[0].admitted, 2u);
+    EXPECT_EQ(stats.classes[0].shed_queue_full, 1u);
+    EXPECT_EQ(stats.classes[0].in_flight, 1u);
+    EXPECT_EQ(stats.classes[1].admitted, 1u);
+}
+
+TEST(AdmissionControllerTest, ShedsRequestsQueuedPastTimeout) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    auto work = boost::asio::make_work_guard(io_context);
+    AdmissionController admission(LimitedOptions(1, 0));
+
+    std::vector<std::optional<AdmissionTicket>> tickets(2);
+    for (size_t i = 0; i < 2; ++i) {
+        Spawn(executor, AdmitInto(admission, "/api/v1/dialogs/1/messages", executor, tickets, i));
+    }
+    io_context.run_for(300ms);
+
+    ASSERT_TRUE(tickets[0].has_value() && tickets[1].has_value());
+    EXPECT_TRUE(*tickets[0]);
+    EXPECT_FALSE(*tickets[1]);
+    EXPECT_EQ(admission.GetStats().classes[0].shed_queue_timeout, 1u);
+}
+
+TEST(AdmissionControllerTest, LimitsConnections) {
+    AdmissionOptions options;
+    options.max_connections = 2;
+    AdmissionController admission(options);
+
+    auto first = admission.AdmitConnection();
+    auto second = admission.AdmitConnection();
+    auto third = admission.AdmitConnection();
+    EXPECT_TRUE(first);
+    EXPECT_TRUE(second);
+    EXPECT_FALSE(third);
+    EXPECT_EQ(admission.GetActiveConnections(), 2u);
+
+    first = {};
+    EXPECT_TRUE(admission.AdmitConnection());
+    EXPECT_EQ(admission.GetActiveConnections(), 1u);
+    EXPECT_EQ(admission.GetStats().rejected_connections, 1u);
+}
+
+} // namespace ai_backend::test
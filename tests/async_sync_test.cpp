@@ -0,0 +1,259 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <future>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "core/async/async_event.h"
+#include "core/async/async_mutex.h"
+#include "core/async/async_semaphore.h"
+#include "core/async/channel.h"
+
+namespace ai_backend::test {
+
+using core::async::AsyncEvent;
+using core::async::AsyncMutex;
+using core::async::AsyncSemaphore;
+using core::async::Channel;
+using core::async::Deadline;
+using core::async::DeadlineExceeded;
+using core::async::Spawn;
+using core::async::Task;
+using namespace std::chrono_literals;
+
+namespace {
+
+// 让出当前线程，协程在executor上重新排队
+struct YieldAwaiter {
+    boost::asio::any_io_executor executor;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        boost::asio::post(executor, [handle]() { handle.resume(); });
+    }
+    void await_resume() const noexcept {}
+};
+
+void RunOnThreads(boost::asio::io_context& io_context, size_t count) {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < count; ++i) {
+        threads.emplace_back([&io_context]() { io_context.run(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace
+
+TEST(AsyncSyncTest, MutexSerializesCoroutinesAcrossThreads) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    AsyncMutex mutex(executor);
+
+    constexpr int kTasks = 64;
+    constexpr int kIterations = 50;
+    int counter = 0;
+    std::atomic<int> inside{0};
+    std::atomic<int> max_inside{0};
+
+    auto worker = [&]() -> Task<void> {
+        for (int i = 0; i < kIterations; ++i) {
+            auto lock = co_await mutex.ScopedLock();
+            int current = ++inside;
+            max_inside = std::max(max_inside.load(), current);
+            // 临界区内挂起，其他协程只能排队而不是阻塞线程
+            int value = counter;
+            YieldAwaiter yield{executor};
+            co_await yield;
+            counter = value + 1;
+            --inside;
+        }
+    };
+
+    for (int i = 0; i < kTasks; ++i) {
+        Spawn(executor, worker());
+    }
+    RunOnThreads(io_context, 4);
+
+    EXPECT_EQ(counter, kTasks * kIterations);
+    EXPECT_EQ(max_inside.load(), 1);
+    EXPECT_FALSE(mutex.IsLocked());
+}
+
+TEST(AsyncSyncTest, SemaphoreHandsOffInOrderAndHonorsDeadline) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    AsyncSemaphore semaphore(1, executor);
+
+    std::vector<int> order;
+    bool timed_out = false;
+
+    auto waiter = [&](int id) -> Task<void> {
+        co_await semaphore.Acquire();
+        order.push_back(id);
+        YieldAwaiter yield{executor};
+        co_await yield;
+        semaphore.Release();
+    };
+    auto impatient = [&]() -> Task<void> {
+        try {
+            co_await semaphore.Acquire(Deadline::After(executor, 1ms));
+        } catch (const DeadlineExceeded&) {
+            timed_out = true;
+        }
+    };
+
+    ASSERT_TRUE(semaphore.TryAcquire());
+    for (int i = 0; i < 3; ++i) {
+        Spawn(executor, waiter(i));
+    }
+    Spawn(executor, impatient());
+    io_context.poll();
+    EXPECT_EQ(semaphore.GetWaiterCount(), 4u);
+
+    // 超时的等待者不占用许可，之后的Release仍按顺序交给其余等待者
+    while (!timed_out) {
+        io_context.run_one();
+    }
+    EXPECT_EQ(semaphore.GetWaiterCount(), 3u);
+
+    semaphore.Release();
+    io_context.restart();
+    io_context.run();
+
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(semaphore.GetAvailable(), 1u);
+    EXPECT_EQ(semaphore.GetWaiterCount(), 0u);
+}
+
+TEST(AsyncSyncTest, WaiterResumesOnItsOwnStrand) {
+    // 原语构造时的executor属于另一个io_context，等待者仍回到它挂起时所在的strand
+    boost::asio::io_context primitive_context;
+    boost::asio::io_context session_context;
+    auto guard = boost::asio::make_work_guard(session_context);
+    std::thread session_thread([&]() { session_context.run(); });
+
+    AsyncSemaphore semaphore(0, primitive_context.get_executor());
+    auto strand = boost::asio::make_strand(session_context);
+    std::promise<bool> on_strand;
+
+    auto waiter = [&]() -> Task<void> {
+        co_await semaphore.Acquire();
+        on_strand.set_value(strand.running_in_this_thread());
+    };
+    Spawn(strand, waiter());
+
+    while (semaphore.GetWaiterCount() == 0) {
+        std::this_thread::sleep_for(1ms);
+    }
+    semaphore.Release();
+
+    auto future = on_strand.get_future();
+    ASSERT_EQ(future.wait_for(5s), std::future_status::ready);
+    EXPECT_TRUE(future.get());
+    EXPECT_EQ(primitive_context.poll(), 0u);
+
+    guard.reset();
+    session_thread.join();
+}
+
+TEST(AsyncSyncTest, EventWakesAllWaiters) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    AsyncEvent event(executor);
+    int woken = 0;
+
+    auto waiter = [&]() -> Task<void> {
+        co_await event.Wait();
+        ++woken;
+    };
+    for (int i = 0; i < 5; ++i) {
+        Spawn(executor, waiter());
+    }
+    io_context.poll();
+    EXPECT_EQ(woken, 0);
+
+    // 没有待执行的任务时poll会停止io_context
+    event.Set();
+    io_context.restart();
+    io_context.poll();
+    EXPECT_EQ(woken, 5);
+
+    // 已设置的事件不再挂起
+    Spawn(executor, waiter());
+    io_context.restart();
+    io_context.poll();
+    EXPECT_EQ(woken, 6);
+}
+
+TEST(AsyncSyncTest, ChannelDeliversEveryItemAcrossProducersAndConsumers) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    Channel<int> channel(4, executor);
+
+    constexpr int kProducers = 4;
+    constexpr int kItems = 500;
+    std::atomic<int> producers_left{kProducers};
+    std::atomic<long> sum{0};
+    std::atomic<int> received{0};
+
+    auto producer = [&](int base) -> Task<void> {
+        for (int i = 0; i < kItems; ++i) {
+            EXPECT_TRUE(co_await channel.Send(base + i));
+        }
+        if (--producers_left == 0) {
+            channel.Close();
+        }
+    };
+    auto consumer = [&]() -> Task<void> {
+        while (auto value = co_await channel.Receive()) {
+            sum += *value;
+            ++received;
+        }
+    };
+
+    for (int i = 0; i < 3; ++i) {
+        Spawn(executor, consumer());
+    }
+    for (int p = 0; p < kProducers; ++p) {
+        Spawn(executor, producer(p * kItems));
+    }
+    RunOnThreads(io_context, 4);
+
+    long expected = static_cast<long>(kProducers * kItems) * (kProducers * kItems - 1) / 2;
+    EXPECT_EQ(received.load(), kProducers * kItems);
+    EXPECT_EQ(sum.load(), expected);
+    EXPECT_FALSE(channel.TrySend(1));
+}
+
+TEST(AsyncSyncTest, ChannelSendTimesOutWhenFull) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    Channel<int> channel(1, executor);
+    ASSERT_TRUE(channel.TrySend(1));
+    EXPECT_FALSE(channel.TrySend(2));
+
+    bool timed_out = false;
+    auto sender = [&]() -> Task<void> {
+        try {
+            co_await channel.Send(2, Deadline::After(executor, 5ms));
+        } catch (const DeadlineExceeded&) {
+            timed_out = true;
+        }
+    };
+    Spawn(executor, sender());
+    io_context.run();
+
+    EXPECT_TRUE(timed_out);
+    EXPECT_EQ(channel.TryReceive(), std::optional<int>(1));
+    EXPECT_EQ(channel.TryReceive(), std::nullopt);
+}
+
+} // namespace ai_backend::test
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "services/ai/tokenizer/bpe_tokenizer.h"
+
+namespace ai_backend::test {
+
+using services::ai::tokenizer::BpeTokenizer;
+using services::ai::tokenizer::NextPretokenEnd;
+using services::ai::tokenizer::StreamingTokenCounter;
+using services::ai::tokenizer::TokenId;
+
+namespace {
+
+std::vector<std::string> Pretokenize(const std::string& text) {
+    std::vector<std::string> pieces;
+    for (size_t pos = 0; pos < text.size();) {
+        size_t end = NextPretokenEnd(text, pos);
+        pieces.push_back(text.substr(pos, end - pos));
+        pos = end;
+    }
+    return pieces;
+}
+
+// 256个单字节token加上按顺序生效的合并规则
+std::shared_ptr<BpeTokenizer> BuildTestTokenizer() {
+    std::vector<std::string> tokens;
+    for (int b = 0; b < 256; ++b) {
+        tokens.emplace_back(1, static_cast<char>(b));
+    }
+
+    std::vector<std::pair<std::string, std::string>> merges = {
+        {"b", "c"}, {"a", "b"}, {"a", "bc"},
+        {"l", "l"}, {"h", "e"}, {"he", "ll"}, {"hell", "o"},
+        {" ", "w"}, {" w", "o"}, {" wo", "r"}, {" wor", "l"}, {" worl", "d"},
+        {"\xE4\xBD", "\xA0"}, {"\xE5\xA5", "\xBD"}, {"你", "好"},
+    };
+    for (const auto& [left, right] : merges) {
+        tokens.push_back(left + right);
+    }
+    // 合并规则的中间结果
+    tokens.push_back("\xE4\xBD");
+    tokens.push_back("\xE5\xA5");
+    merges.insert(merges.begin(), {{"\xE4", "\xBD"}, {"\xE5", "\xA5"}});
+
+    auto result = BpeTokenizer::Build(tokens, merges);
+    EXPECT_TRUE(result.IsOk()) << result.GetError();
+    return result.GetValue();
+}
+
+} // namespace
+
+TEST(BpeTokenizerTest, PretokenizerSplitsLikeReference) {
+    EXPECT_EQ(Pretokenize("Hello world 123456 你好!"),
+              (std::vector<std::string>{"Hello", " world", " ", "123", "456", " ", "你好", "!"}));
+    EXPECT_EQ(Pretokenize("don't stop"), (std::vector<std::string>{"don", "'t", " stop"}));
+    EXPECT_EQ(Pretokenize("a  b"), (std::vector<std::string>{"a", " ", " b"}));
+    EXPECT_EQ(Pretokenize("x\n\ny ..."), (std::vector<std::string>{"x", "\n\n", "y", " ..."}));
+    EXPECT_EQ(Pretokenize("(abc)  "), (std::vector<std::string>{"(abc", ")", "  "}));
+    EXPECT_EQ(Pretokenize("中文，测试"), (std::vector<std::string>{"中文", "，", "测试"}));
+}
+
+TEST(BpeTokenizerTest, MergesByRank) {
+    auto tokenizer = BuildTestTokenizer();
+    ASSERT_TRUE(tokenizer);
+
+    std::vector<TokenId> ids;
+    tokenizer->Encode("hello world", ids);
+    ASSERT_EQ(ids.size(), 2);
+    EXPECT_EQ(tokenizer->Decode({ids[0]}), "hello");
+    EXPECT_EQ(tokenizer->Decode({ids[1]}), " world");
+
+    // b+c优先于a+b，然后a+bc
+    ids.clear();
+    tokenizer->Encode("abc", ids);
+    ASSERT_EQ(ids.size(), 1);
+    EXPECT_EQ(tokenizer->Decode(ids), "abc");
+
+    // 没有合并规则的字节保持为单字节token
+    ids.clear();
+    tokenizer->Encode("xyz", ids);
+    EXPECT_EQ(ids.size(), 3);
+}
+
+TEST(BpeTokenizerTest, RoundTripsArbitraryBytes) {
+    auto tokenizer = BuildTestTokenizer();
+    ASSERT_TRUE(tokenizer);
+
+    std::string text = "hello 你好，world\r\n\t12345 \xFF\xC3 😀 abcabc";
+    std::vector<TokenId> ids;
+    tokenizer->Encode(text, ids);
+    EXPECT_EQ(tokenizer->Decode(ids), text);
+    EXPECT_EQ(tokenizer->CountTokens(text), ids.size());
+}
+
+TEST(BpeTokenizerTest, LongPiecesMatchShortPieces) {
+    auto tokenizer = BuildTestTokenizer();
+    ASSERT_TRUE(tokenizer);
+
+    // 超过64字节的CJK片段走堆合并路径
+    std::string text;
+    for (int i = 0; i < 40; ++i) {
+        text += "你好";
+    }
+    text += "你";
+    EXPECT_EQ(tokenizer->CountTokens(text), 41);
+    EXPECT_EQ(tokenizer->CountTokens("你好你"), 2);
+
+    std::vector<TokenId> ids;
+    tokenizer->Encode(text, ids);
+    EXPECT_EQ(tokenizer->Decode(ids), text);
+}
+
+TEST(BpeTokenizerTest, StreamingCountMatchesFullCount) {
+    auto tokenizer = BuildTestTokenizer();
+    ASSERT_TRUE(tokenizer);
+
+    const std::string text = "hello world, don't 12345678 你好你好 abc\n\n  hello\tworld 😀!";
+    size_t expected = tokenizer->CountTokens(text);
+
+    for (size_t step : {1, 2, 3, 5, 7, 64}) {
+        StreamingTokenCounter counter(tokenizer);
+        for (size_t pos = 0; pos < text.size(); pos += step) {
+            counter.Append(std::string_view(text).substr(pos, step));
+        }
+        EXPECT_EQ(counter.GetCount(), expected) << "step=" << step;
+    }
+}
+
+TEST(BpeTokenizerTest, CompiledImageLoadsWithMmap) {
+    auto tokenizer = BuildTestTokenizer();
+    ASSERT_TRUE(tokenizer);
+
+    std::string path = ::testing::TempDir() + "bpe_tokenizer_test.bin";
+    ASSERT_TRUE(tokenizer->SaveCompiled(path).IsOk());
+
+    auto loaded = BpeTokenizer::LoadFromFile(path);
+    ASSERT_TRUE(loaded.IsOk()) << loaded.GetError();
+    EXPECT_TRUE(loaded.GetValue()->IsMapped());
+    EXPECT_EQ(loaded.GetValue()->GetVocabSize(), tokenizer->GetVocabSize());
+
+    const std::string text = "hello world 你好 abc";
+    std::vector<TokenId> expected, actual;
+    tokenizer->Encode(text, expected);
+    loaded.GetValue()->Encode(text, actual);
+    EXPECT_EQ(actual, expected);
+
+    std::remove(path.c_str());
+}
+
+TEST(BpeTokenizerTest, LoadsHuggingFaceJson) {
+    // GPT-2字节级编码：不可打印字节映射到U+0100之后，空格为U+0120
+    nlohmann::json vocab = nlohmann::json::object();
+    int extra = 0;
+    for (int b = 0; b < 256; ++b) {
+        bool printable = (b >= 33 && b <= 126) || (b >= 161 && b <= 172) || (b >= 174 && b <= 255);
+        int code_point = printable ? b : 256 + extra++;
+        std::string token;
+        if (code_point < 0x80) {
+            token.push_back(static_cast<char>(code_point));
+        } else {
+            token.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+            token.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+        vocab[token] = b;
+    }
+    vocab["\u0120h"] = 256;
+    vocab["\u0120hi"] = 257;
+
+    nlohmann::json root = {
+        {"added_tokens", {{{"id", 258}, {"content", "<eos>"}}}},
+        {"model", {{"type", "BPE"}, {"vocab", vocab}, {"merges", {"\u0120 h", "\u0120h i"}}}},
+    };
+
+    std::string path = ::testing::TempDir() + "bpe_tokenizer_test.json";
+    {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        ASSERT_NE(file, nullptr);
+        std::fputs(root.dump().c_str(), file);
+        std::fclose(file);
+    }
+
+    auto loaded = BpeTokenizer::LoadFromFile(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(loaded.IsOk()) << loaded.GetError();
+
+    auto tokenizer = loaded.GetValue();
+    EXPECT_FALSE(tokenizer->IsMapped());
+    EXPECT_EQ(tokenizer->GetVocabSize(), 259);
+
+    std::vector<TokenId> ids;
+    tokenizer->Encode("oh hi", ids);
+    EXPECT_EQ(ids, (std::vector<TokenId>{'o', 'h', 257}));
+    EXPECT_EQ(tokenizer->Decode({258}), "<eos>");
+
+    EXPECT_TRUE(BpeTokenizer::LoadFromFile(path).IsError());
+}
+
+} // namespace ai_backend::test
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+#include "core/memory/buffer_chain.h"
+
+namespace ai_backend::test {
+
+using core::memory::BufferChain;
+
+TEST(BufferChainTest, AppendNeverRelocatesWrittenData) {
+    BufferChain chain;
+    chain.Append("data: ");
+    const char* first = chain.GetSlices().front().Data();
+
+    // 写满多个段，已写入的数据留在原地
+    std::string token(100, 't');
+    for (int i = 0; i < 200; ++i) {
+        chain.Append(token);
+    }
+    EXPECT_EQ(chain.GetSlices().front().Data(), first);
+    EXPECT_EQ(chain.Size(), 6u + 200 * token.size());
+    EXPECT_GT(chain.GetSliceCount(), 1u);
+    EXPECT_LT(chain.GetSliceCount(), 10u);
+
+    std::string expected = "data: ";
+    for (int i = 0; i < 200; ++i) {
+        expected += token;
+    }
+    EXPECT_EQ(chain.ToString(), expected);
+}
+
+TEST(BufferChainTest, AdoptsLargeStringsWithoutCopy) {
+    std::string body(64 * 1024, 'b');
+    const char* data = body.data();
+
+    BufferChain chain;
+    chain.Append("header");
+    chain.Append(std::move(body));
+    ASSERT_EQ(chain.GetSliceCount(), 2u);
+    EXPECT_EQ(chain.GetSlices()[1].Data(), data);
+
+    BufferChain adopted(std::string(4096, 'a'));
+    EXPECT_EQ(adopted.Size(), 4096u);
+    EXPECT_EQ(adopted.GetSliceCount(), 1u);
+}
+
+TEST(BufferChainTest, SplitAndSliceShareSegments) {
+    BufferChain chain;
+    chain.Append("hello, ");
+    chain.Append(std::string(2000, 'w'));
+    chain.Append("!");
+    const char* base = chain.GetSlices().front().Data();
+
+    BufferChain slice = chain.Slice(3, 10);
+    EXPECT_EQ(slice.ToString(), "lo, wwwwww");
+    EXPECT_EQ(slice.GetSlices().front().Data(), base + 3);
+
+    BufferChain head = chain.Split(5);
+    EXPECT_EQ(head.ToString(), "hello");
+    EXPECT_EQ(head.GetSlices().front().Data(), base);
+    EXPECT_EQ(chain.Size(), 2 + 2000 + 1u);
+    EXPECT_EQ(chain.GetSlices().front().Data(), base + 5);
+
+    chain.Consume(2 + 2000);
+    EXPECT_EQ(chain.ToString(), "!");
+
+    // 原链释放后切片仍然有效
+    chain.Clear();
+    EXPECT_EQ(slice.ToString(), "lo, wwwwww");
+    EXPECT_THROW(head.Split(6), std::out_of_range);
+}
+
+TEST(BufferChainTest, CopiesDoNotWriteIntoSharedSegment) {
+    BufferChain original;
+    original.Append("shared");
+
+    BufferChain copy = original;
+    copy.Append("-copy");
+    original.Append("-original");
+
+    EXPECT_EQ(copy.ToString(), "shared-copy");
+    EXPECT_EQ(original.ToString(), "shared-original");
+
+    // 移动后接着写入同一个段，与尾部切片相连
+    BufferChain moved;
+    moved.Append(std::move(original));
+    moved.Append("!");
+    EXPECT_EQ(moved.ToString(), "shared-original!");
+    EXPECT_EQ(moved.GetSliceCount(), 1u);
+    EXPECT_TRUE(original.Empty());
+}
+
+TEST(BufferChainTest, IsAConstBufferSequence) {
+    static_assert(boost::asio::is_const_buffer_sequence<BufferChain>::value);
+
+    BufferChain chain;
+    chain.Append("data: ");
+    chain.Append(std::string(3000, 'x'));
+    chain.Append("\n\n");
+
+    EXPECT_EQ(boost::asio::buffer_size(chain), chain.Size());
+
+    std::vector<char> out(chain.Size());
+    size_t copied = boost::asio::buffer_copy(boost::asio::buffer(out), chain);
+    EXPECT_EQ(copied, chain.Size());
+    EXPECT_EQ(std::string(out.begin(), out.end()), chain.ToString());
+}
+
+} // namespace ai_backend::test
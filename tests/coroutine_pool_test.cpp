@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/system_executor.hpp>
+
+#include "core/async/coroutine_pool.h"
+#include "core/async/task.h"
+#include "core/async/work_stealing_deque.h"
+
+namespace ai_backend::test {
+
+using core::async::CoroutinePool;
+using core::async::Task;
+using core::async::WorkStealingDeque;
+
+TEST(WorkStealingDequeTest, OwnerPopsLifoThievesStealFifo) {
+    WorkStealingDeque<int*> deque(2);
+    int values[8] = {};
+    for (auto& value : values) {
+        deque.Push(&value);
+    }
+    EXPECT_EQ(deque.Size(), 8u);
+
+    EXPECT_EQ(deque.Steal(), &values[0]);
+    EXPECT_EQ(deque.Pop(), &values[7]);
+    EXPECT_EQ(deque.Steal(), &values[1]);
+    EXPECT_EQ(deque.Pop(), &values[6]);
+    EXPECT_EQ(deque.Size(), 4u);
+
+    while (deque.Pop()) {
+    }
+    EXPECT_TRUE(deque.Empty());
+    EXPECT_EQ(deque.Steal(), nullptr);
+}
+
+TEST(WorkStealingDequeTest, ConcurrentStealsTakeEachItemOnce) {
+    constexpr int kItems = 100000;
+    constexpr int kThieves = 3;
+
+    WorkStealingDeque<int*> deque(16);
+    std::vector<int> items(kItems);
+    std::vector<std::atomic<int>> taken(kItems);
+    std::atomic<bool> done{false};
+
+    auto record = [&](int* item) {
+        taken[item - items.data()].fetch_add(1, std::memory_order_relaxed);
+    };
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < kThieves; ++t) {
+        thieves.emplace_back([&]() {
+            while (!done.load(std::memory_order_acquire) || !deque.Empty()) {
+                if (int* item = deque.Steal()) {
+                    record(item);
+                }
+            }
+        });
+    }
+
+    // 所有者交替压入和弹出，与窃取者竞争最后一个元素
+    for (int i = 0; i < kItems; ++i) {
+        deque.Push(&items[i]);
+        if (i % 3 == 0) {
+            if (int* item = deque.Pop()) {
+                record(item);
+            }
+        }
+    }
+    while (int* item = deque.Pop()) {
+        record(item);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+
+    for (int i = 0; i < kItems; ++i) {
+        ASSERT_EQ(taken[i].load(), 1) << "item " << i;
+    }
+}
+
+TEST(CoroutinePoolTest, SubmitReturnsResultsAndExceptions) {
+    CoroutinePool pool(4, 4);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.push_back(pool.Submit([i]() { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(futures[i].get(), i * i);
+    }
+
+    auto failed = pool.Submit([]() -> int { throw std::runtime_error("boom"); });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+}
+
+TEST(CoroutinePoolTest, NestedPostsAreStolenAndAwaited) {
+    CoroutinePool pool(4, 4);
+    std::atomic<int> leaves{0};
+
+    // 每个任务在池内再提交两个子任务，形成深度为12的二叉树
+    std::function<void(int)> fan_out = [&](int depth) {
+        if (depth == 0) {
+            leaves.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        pool.Post([&, depth]() { fan_out(depth - 1); });
+        pool.Post([&, depth]() { fan_out(depth - 1); });
+    };
+    pool.Post([&]() { fan_out(12); });
+    pool.WaitAll();
+
+    EXPECT_EQ(leaves.load(), 1 << 12);
+    EXPECT_EQ(pool.GetPendingCount(), 0u);
+    EXPECT_EQ(pool.GetActiveCount(), 0u);
+}
+
+TEST(CoroutinePoolTest, ScheduleResumesCoroutineOnPool) {
+    CoroutinePool pool(2, 2);
+    std::atomic<bool> done{false};
+    std::thread::id caller = std::this_thread::get_id();
+    std::thread::id resumed_on;
+
+    auto task = [&]() -> Task<void> {
+        co_await pool.Schedule();
+        resumed_on = std::this_thread::get_id();
+        done = true;
+    };
+    core::async::Spawn(boost::asio::system_executor(), task());
+
+    while (!done.load()) {
+        std::this_thread::yield();
+    }
+    pool.WaitAll();
+
+    EXPECT_NE(resumed_on, caller);
+}
+
+TEST(CoroutinePoolTest, DestructorDrainsQueuedJobs) {
+    std::atomic<int> executed{0};
+    {
+        CoroutinePool pool(2, 2);
+        for (int i = 0; i < 1000; ++i) {
+            pool.Post([&]() { executed.fetch_add(1, std::memory_order_relaxed); });
+        }
+    }
+    EXPECT_EQ(executed.load(), 1000);
+}
+
+} // namespace ai_backend::test
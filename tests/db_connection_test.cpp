@@ -0,0 +1,749 @@
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include "api/controllers/dialog_controller.h"
+#include "core/async/deadline.h"
+#include "core/async/runtime.h"
+#include "core/async/task.h"
+#include "core/db/connection.h"
+#include "core/db/connection_pool.h"
+#include "core/db/query_params.h"
+#include "core/db/query_result.h"
+#include "core/http/admission_controller.h"
+#include "core/http/http_server.h"
+#include "core/http/router.h"
+#include "services/dialog/dialog_service.h"
+
+namespace ai_backend::test {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+using core::async::Deadline;
+using core::async::DeadlineExceeded;
+using core::async::Runtime;
+using core::async::RuntimeOptions;
+using core::async::Task;
+using core::db::Connection;
+using core::db::ConnectionPool;
+using core::db::DbError;
+using core::db::PreparedStatement;
+using core::db::QueryParams;
+using core::db::QueryResult;
+
+// 只实现扩展查询协议的本地PostgreSQL模拟服务端，每个连接一个线程
+// 语句 (Parse中的SQL) 决定结果：
+//   echo          每个参数一列，原样返回 (NULL仍为NULL)
+//   rows N        N行，每行一列行号
+//   sleep N       等待N毫秒后返回一行done
+//   fail          返回SQLSTATE 23505的错误
+//   BEGIN/COMMIT/ROLLBACK  改变事务状态
+// 其他语句 (如服务层的真实SQL) 返回空结果；SetStatementDelay可以让每条语句都卡住一段时间
+class PgMockServer {
+public:
+    PgMockServer() : acceptor_(io_context_, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0)) {
+        accept_thread_ = std::thread([this]() { AcceptLoop(); });
+    }
+
+    ~PgMockServer() {
+        stopping_ = true;
+        boost::system::error_code ec;
+        tcp::socket wakeup(io_context_);
+        wakeup.connect(acceptor_.local_endpoint(), ec);
+        if (accept_thread_.joinable()) {
+            accept_thread_.join();
+        }
+        acceptor_.close(ec);
+
+        // 关闭读写唤醒阻塞在读取上的连接线程
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int fd : open_sockets_) {
+                ::shutdown(fd, SHUT_RDWR);
+            }
+            threads.swap(threads_);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    std::string ConnInfo() const {
+        return "host=127.0.0.1 port=" + std::to_string(acceptor_.local_endpoint().port()) +
+               " user=test dbname=test sslmode=disable gssencmode=disable connect_timeout=5";
+    }
+
+    // 收到的Parse消息数，用于确认预处理语句只准备一次
+    size_t ParseCount() const { return parse_count_; }
+
+    // 之后执行的每条语句都先等待delay
+    void SetStatementDelay(std::chrono::milliseconds delay) { statement_delay_ms_ = static_cast<int>(delay.count()); }
+
+    // 收到的取消请求 (PQcancel) 数
+    size_t CancelCount() const { return cancel_count_; }
+
+private:
+    struct Result {
+        std::vector<std::string> columns;
+        std::vector<std::vector<std::optional<std::string>>> rows;
+        std::string tag;
+        std::string error_code;
+        int sleep_ms = 0;
+    };
+
+    void AcceptLoop() {
+        for (;;) {
+            boost::system::error_code ec;
+            tcp::socket socket(io_context_);
+            acceptor_.accept(socket, ec);
+            if (ec || stopping_) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            open_sockets_.push_back(socket.native_handle());
+            threads_.emplace_back([this, socket = std::move(socket)]() mutable {
+                Serve(std::move(socket));
+            });
+        }
+    }
+
+    static uint32_t ReadInt32(const char* data) {
+        uint32_t value;
+        std::memcpy(&value, data, 4);
+        return ntohl(value);
+    }
+
+    static uint16_t ReadInt16(const char* data) {
+        uint16_t value;
+        std::memcpy(&value, data, 2);
+        return ntohs(value);
+    }
+
+    static void AppendInt32(std::string& out, uint32_t value) {
+        value = htonl(value);
+        out.append(reinterpret_cast<const char*>(&value), 4);
+    }
+
+    static void AppendInt16(std::string& out, uint16_t value) {
+        value = htons(value);
+        out.append(reinterpret_cast<const char*>(&value), 2);
+    }
+
+    static void AppendMessage(std::string& out, char type, const std::string& body) {
+        out.push_back(type);
+        AppendInt32(out, static_cast<uint32_t>(body.size() + 4));
+        out.append(body);
+    }
+
+    static std::string ReadCString(const char*& data) {
+        std::string value(data);
+        data += value.size() + 1;
+        return value;
+    }
+
+    static Result Evaluate(const std::string& sql, const std::vector<std::optional<std::string>>& params) {
+        Result result;
+        if (sql == "echo") {
+            for (size_t i = 0; i < params.size(); ++i) {
+                result.columns.push_back("p" + std::to_string(i + 1));
+            }
+            result.rows.push_back(params);
+            result.tag = "SELECT 1";
+        } else if (sql.rfind("rows ", 0) == 0) {
+            int count = std::stoi(sql.substr(5));
+            result.columns.push_back("n");
+            for (int i = 0; i < count; ++i) {
+                result.rows.push_back({std::to_string(i)});
+            }
+            result.tag = "SELECT " + std::to_string(count);
+        } else if (sql.rfind("sleep ", 0) == 0) {
+            result.sleep_ms = std::stoi(sql.substr(6));
+            result.columns.push_back("status");
+            result.rows.push_back({std::string("done")});
+            result.tag = "SELECT 1";
+        } else if (sql == "fail") {
+            result.error_code = "23505";
+        } else if (sql.rfind("UPDATE", 0) == 0) {
+            result.tag = "UPDATE 3";
+        } else {
+            result.tag = sql;
+        }
+        return result;
+    }
+
+    void Serve(tcp::socket socket) {
+        boost::system::error_code ec;
+
+        // 启动：拒绝SSL请求，接受启动消息后直接认证成功
+        for (;;) {
+            char header[8];
+            net::read(socket, net::buffer(header, 4), ec);
+            if (ec) {
+                return;
+            }
+            std::string body(ReadInt32(header) - 4, '\0');
+            net::read(socket, net::buffer(body), ec);
+            if (ec || body.size() < 4) {
+                return;
+            }
+            uint32_t code = ReadInt32(body.data());
+            if (code == 80877103 || code == 80877104) {
+                net::write(socket, net::buffer("N", 1), ec);
+                continue;
+            }
+            if (code == 80877102) {
+                cancel_count_++;
+                return;
+            }
+            break;
+        }
+
+        std::string out;
+        std::string auth;
+        AppendInt32(auth, 0);
+        AppendMessage(out, 'R', auth);
+        for (auto [name, value] : {std::pair{"server_version", "15.0"},
+                                   std::pair{"client_encoding", "UTF8"},
+                                   std::pair{"standard_conforming_strings", "on"},
+                                   std::pair{"integer_datetimes", "on"}}) {
+            AppendMessage(out, 'S', std::string(name) + '\0' + value + '\0');
+        }
+        std::string key;
+        AppendInt32(key, 4242);
+        AppendInt32(key, 1234);
+        AppendMessage(out, 'K', key);
+        AppendMessage(out, 'Z', "I");
+        net::write(socket, net::buffer(out), ec);
+
+        char transaction = 'I';
+        bool failed = false;
+        std::map<std::string, std::string> statements;
+        std::string unnamed;
+        std::optional<Result> portal;
+
+        for (;;) {
+            char header[5];
+            net::read(socket, net::buffer(header, 5), ec);
+            if (ec) {
+                return;
+            }
+            char type = header[0];
+            std::string body(ReadInt32(header + 1) - 4, '\0');
+            net::read(socket, net::buffer(body), ec);
+            if (ec || type == 'X') {
+                return;
+            }
+
+            out.clear();
+            const char* data = body.data();
+            if (type == 'S') {
+                failed = false;
+                AppendMessage(out, 'Z', std::string(1, transaction));
+            } else if (failed) {
+                continue;
+            } else if (type == 'P') {
+                parse_count_++;
+                std::string name = ReadCString(data);
+                std::string sql = ReadCString(data);
+                (name.empty() ? unnamed : statements[name]) = sql;
+                AppendMessage(out, '1', "");
+            } else if (type == 'B') {
+                ReadCString(data);
+                std::string name = ReadCString(data);
+                uint16_t formats = ReadInt16(data);
+                data += 2 + formats * 2;
+                uint16_t count = ReadInt16(data);
+                data += 2;
+                std::vector<std::optional<std::string>> params;
+                for (uint16_t i = 0; i < count; ++i) {
+                    int32_t length = static_cast<int32_t>(ReadInt32(data));
+                    data += 4;
+                    if (length < 0) {
+                        params.emplace_back();
+                    } else {
+                        params.emplace_back(std::string(data, length));
+                        data += length;
+                    }
+                }
+                portal = Evaluate(name.empty() ? unnamed : statements[name], params);
+                AppendMessage(out, '2', "");
+            } else if (type == 'D') {
+                if (portal && !portal->columns.empty()) {
+                    std::string description;
+                    AppendInt16(description, static_cast<uint16_t>(portal->columns.size()));
+                    for (const auto& column : portal->columns) {
+                        description += column + '\0';
+                        AppendInt32(description, 0);
+                        AppendInt16(description, 0);
+                        AppendInt32(description, 25);
+                        AppendInt16(description, 0xFFFF);
+                        AppendInt32(description, 0xFFFFFFFF);
+                        AppendInt16(description, 0);
+                    }
+                    AppendMessage(out, 'T', description);
+                } else {
+                    AppendMessage(out, 'n', "");
+                }
+            } else if (type == 'E') {
+                if (!portal) {
+                    continue;
+                }
+                int sleep_ms = portal->sleep_ms + statement_delay_ms_;
+                for (int waited = 0; waited < sleep_ms && !stopping_; waited += 10) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+                if (!portal->error_code.empty()) {
+                    std::string error;
+                    error += std::string("SERROR") + '\0';
+                    error += std::string("VERROR") + '\0';
+                    error += "C" + portal->error_code + '\0';
+                    error += std::string("Mduplicate key value violates unique constraint") + '\0';
+                    error += '\0';
+                    AppendMessage(out, 'E', error);
+                    failed = true;
+                    if (transaction == 'T') {
+                        transaction = 'E';
+                    }
+                } else {
+                    for (const auto& row : portal->rows) {
+                        std::string data_row;
+                        AppendInt16(data_row, static_cast<uint16_t>(row.size()));
+                        for (const auto& value : row) {
+                            if (!value) {
+                                AppendInt32(data_row, 0xFFFFFFFF);
+                            } else {
+                                AppendInt32(data_row, static_cast<uint32_t>(value->size()));
+                                data_row += *value;
+                            }
+                        }
+                        AppendMessage(out, 'D', data_row);
+                    }
+                    if (portal->tag == "BEGIN") {
+                        transaction = 'T';
+                    } else if (portal->tag == "COMMIT" || portal->tag == "ROLLBACK") {
+                        transaction = 'I';
+                    }
+                    AppendMessage(out, 'C', portal->tag + '\0');
+                }
+                portal.reset();
+            }
+
+            if (!out.empty()) {
+                net::write(socket, net::buffer(out), ec);
+                if (ec) {
+                    return;
+                }
+            }
+        }
+    }
+
+    net::io_context io_context_;
+    tcp::acceptor acceptor_;
+    std::thread accept_thread_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<size_t> parse_count_{0};
+    std::atomic<int> statement_delay_ms_{0};
+    std::atomic<size_t> cancel_count_{0};
+    std::mutex mutex_;
+    std::vector<int> open_sockets_;
+    std::vector<std::thread> threads_;
+};
+
+class DbConnectionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        work_guard_.emplace(io_context_.get_executor());
+        io_thread_ = std::thread([this]() { io_context_.run(); });
+    }
+
+    void TearDown() override {
+        work_guard_.reset();
+        io_context_.stop();
+        io_thread_.join();
+    }
+
+    // 在io_context上运行协程并同步等待结果，异常原样抛出
+    template <typename T>
+    T RunSync(Task<T> task) {
+        std::promise<T> promise;
+        auto future = promise.get_future();
+        core::async::Spawn(io_context_.get_executor(), Forward(std::move(task), promise));
+        EXPECT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+        return future.get();
+    }
+
+    template <typename T>
+    static Task<void> Forward(Task<T> task, std::promise<T>& promise) {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await task;
+                promise.set_value();
+            } else {
+                T value = co_await task;
+                promise.set_value(std::move(value));
+            }
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    }
+
+    std::shared_ptr<Connection> Connect() {
+        return RunSync(Connection::Connect(io_context_, server_.ConnInfo()));
+    }
+
+    Deadline After(std::chrono::milliseconds timeout) {
+        return Deadline::After(io_context_.get_executor(), timeout);
+    }
+
+    PgMockServer server_;
+    net::io_context io_context_;
+    std::optional<net::executor_work_guard<net::io_context::executor_type>> work_guard_;
+    std::thread io_thread_;
+};
+
+// 用libpq构造结果，不需要服务端
+QueryResult MakeResult(const std::vector<std::vector<const char*>>& rows) {
+    PGresult* result = PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK);
+    std::vector<PGresAttDesc> attributes(rows.empty() ? 0 : rows[0].size());
+    std::vector<std::string> names;
+    for (size_t i = 0; i < attributes.size(); ++i) {
+        names.push_back("c" + std::to_string(i));
+    }
+    for (size_t i = 0; i < attributes.size(); ++i) {
+        attributes[i] = PGresAttDesc{const_cast<char*>(names[i].c_str()), 0, 0, 0, 25, -1, -1};
+    }
+    PQsetResultAttrs(result, static_cast<int>(attributes.size()), attributes.data());
+    for (size_t row = 0; row < rows.size(); ++row) {
+        for (size_t column = 0; column < rows[row].size(); ++column) {
+            const char* value = rows[row][column];
+            PQsetvalue(result, static_cast<int>(row), static_cast<int>(column),
+                       const_cast<char*>(value), value ? static_cast<int>(std::strlen(value)) : -1);
+        }
+    }
+    return QueryResult(result);
+}
+
+TEST(QueryParamsTest, EncodesValuesAsText) {
+    std::string owned = "owned";
+    std::optional<int> present = 7;
+    std::optional<int> absent;
+    QueryParams params{"text", std::string_view("view"), owned, 42, -3L, size_t(18446744073709551615ULL),
+                       1.5, true, false, nullptr, present, absent};
+
+    ASSERT_EQ(params.Size(), 12);
+    EXPECT_STREQ(params.GetValue(0), "text");
+    EXPECT_STREQ(params.GetValue(1), "view");
+    EXPECT_STREQ(params.GetValue(2), "owned");
+    EXPECT_STREQ(params.GetValue(3), "42");
+    EXPECT_STREQ(params.GetValue(4), "-3");
+    EXPECT_STREQ(params.GetValue(5), "18446744073709551615");
+    EXPECT_STREQ(params.GetValue(6), "1.5");
+    EXPECT_STREQ(params.GetValue(7), "t");
+    EXPECT_STREQ(params.GetValue(8), "f");
+    EXPECT_EQ(params.GetValue(9), nullptr);
+    EXPECT_STREQ(params.GetValue(10), "7");
+    EXPECT_EQ(params.GetValue(11), nullptr);
+}
+
+TEST(QueryResultTest, ConvertsFields) {
+    auto result = MakeResult({{"1", "t", "alice", nullptr, "2.5"},
+                              {"2", "false", "bob", "x", "-1"}});
+
+    ASSERT_EQ(result.size(), 2);
+    ASSERT_EQ(result.Columns(), 5);
+    EXPECT_EQ(result.ColumnName(2), "c2");
+
+    EXPECT_EQ(result[0][0].As<int>(), 1);
+    EXPECT_TRUE(result[0][1].As<bool>());
+    EXPECT_FALSE(result[1][1].As<bool>());
+    EXPECT_EQ(result[0][2].As<std::string>(), "alice");
+    EXPECT_EQ(result[1][2].View(), "bob");
+    EXPECT_TRUE(result[0][3].IsNull());
+    EXPECT_EQ(result[0][3].As<std::optional<std::string>>(), std::nullopt);
+    EXPECT_EQ(result[1][3].As<std::optional<std::string>>(), "x");
+    EXPECT_DOUBLE_EQ(result[0][4].As<double>(), 2.5);
+
+    // 非optional类型遇到NULL、无法解析、超出范围都抛出DbError
+    EXPECT_THROW(result[0][3].As<std::string>(), DbError);
+    EXPECT_THROW(result[0][2].As<int>(), DbError);
+    EXPECT_THROW(result[1][4].As<unsigned>(), DbError);
+
+    std::vector<std::string> names;
+    for (const auto& row : result) {
+        names.push_back(row[2].As<std::string>());
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{"alice", "bob"}));
+}
+
+TEST_F(DbConnectionTest, QueryRoundTripsParameters) {
+    auto connection = Connect();
+    EXPECT_FALSE(connection->IsBroken());
+
+    auto result = RunSync(connection->Query("echo", {"hello", 42, nullptr, true}, Deadline()));
+    ASSERT_EQ(result.size(), 1);
+    ASSERT_EQ(result.Columns(), 4);
+    EXPECT_EQ(result.ColumnName(0), "p1");
+    EXPECT_EQ(result[0][0].As<std::string>(), "hello");
+    EXPECT_EQ(result[0][1].As<int>(), 42);
+    EXPECT_TRUE(result[0][2].IsNull());
+    EXPECT_TRUE(result[0][3].As<bool>());
+
+    auto update = RunSync(connection->Query("UPDATE t SET x = 1", {}, Deadline()));
+    EXPECT_TRUE(update.empty());
+    EXPECT_EQ(update.AffectedRows(), 3);
+}
+
+TEST_F(DbConnectionTest, LargeParametersAndResults) {
+    auto connection = Connect();
+
+    // 参数和结果都远大于套接字缓冲区，发送和接收都要多次等待
+    std::string large(4 * 1024 * 1024, 'x');
+    auto echoed = RunSync(connection->Query("echo", {large}, Deadline()));
+    ASSERT_EQ(echoed.size(), 1);
+    EXPECT_EQ(echoed[0][0].View().size(), large.size());
+
+    auto rows = RunSync(connection->Query("rows 50000", {}, Deadline()));
+    ASSERT_EQ(rows.size(), 50000);
+    EXPECT_EQ(rows[49999][0].As<int>(), 49999);
+}
+
+TEST_F(DbConnectionTest, ErrorKeepsConnectionUsable) {
+    auto connection = Connect();
+
+    try {
+        RunSync(connection->Query("fail", {}, Deadline()));
+        FAIL() << "expected DbError";
+    } catch (const DbError& e) {
+        EXPECT_EQ(e.GetSqlState(), "23505");
+        EXPECT_NE(std::string(e.what()).find("duplicate key"), std::string::npos);
+    }
+
+    EXPECT_FALSE(connection->IsBroken());
+    auto result = RunSync(connection->Query("echo", {"ok"}, Deadline()));
+    EXPECT_EQ(result[0][0].As<std::string>(), "ok");
+}
+
+TEST_F(DbConnectionTest, TracksTransactionStatus) {
+    auto connection = Connect();
+    EXPECT_FALSE(connection->InTransaction());
+
+    RunSync(connection->Query("BEGIN", {}, Deadline()));
+    EXPECT_TRUE(connection->InTransaction());
+
+    // 出错的事务在回滚之前仍算作事务中
+    EXPECT_THROW(RunSync(connection->Query("fail", {}, Deadline())), DbError);
+    EXPECT_TRUE(connection->InTransaction());
+
+    RunSync(connection->Query("ROLLBACK", {}, Deadline()));
+    EXPECT_FALSE(connection->InTransaction());
+}
+
+TEST_F(DbConnectionTest, PreparesStatementOncePerConnection) {
+    static const PreparedStatement statement("echo_statement", "echo");
+    auto connection = Connect();
+
+    size_t before = server_.ParseCount();
+    for (int i = 0; i < 3; ++i) {
+        auto result = RunSync(connection->Query(statement, {i}, Deadline()));
+        EXPECT_EQ(result[0][0].As<int>(), i);
+    }
+    EXPECT_EQ(server_.ParseCount() - before, 1);
+}
+
+TEST_F(DbConnectionTest, ConcurrentQueriesShareOneIoThread) {
+    constexpr int kConnections = 4;
+    std::vector<std::shared_ptr<Connection>> connections;
+    for (int i = 0; i < kConnections; ++i) {
+        connections.push_back(Connect());
+    }
+
+    // 4条300ms的语句在同一个IO线程上并发等待，总耗时接近单条语句
+    std::vector<std::promise<QueryResult>> promises(kConnections);
+    std::vector<std::future<QueryResult>> futures;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kConnections; ++i) {
+        futures.push_back(promises[i].get_future());
+        core::async::Spawn(io_context_.get_executor(), Forward(connections[i]->Query("sleep 300", {}, Deadline()), promises[i]));
+    }
+    for (auto& future : futures) {
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_EQ(future.get()[0][0].As<std::string>(), "done");
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, std::chrono::milliseconds(900));
+
+    // IO线程在等待期间仍可以执行其他任务
+    std::promise<void> ran;
+    net::post(io_context_, [&ran]() { ran.set_value(); });
+    EXPECT_EQ(ran.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+}
+
+TEST_F(DbConnectionTest, ResumesCallerOnItsOwnStrand) {
+    // 连接注册在io_context_上，调用方协程运行在另一个io_context的strand上
+    auto connection = Connect();
+    net::io_context session_context;
+    auto guard = net::make_work_guard(session_context);
+    std::thread session_thread([&]() { session_context.run(); });
+    auto strand = net::make_strand(session_context);
+
+    std::promise<int> on_strand;
+    auto caller = [&]() -> Task<void> {
+        int count = 0;
+        for (int i = 0; i < 3; ++i) {
+            auto query = connection->Query("echo", {i}, Deadline());
+            auto result = co_await query;
+            if (strand.running_in_this_thread() && result[0][0].As<int>() == i) {
+                ++count;
+            }
+        }
+        on_strand.set_value(count);
+    };
+    core::async::Spawn(strand, caller());
+
+    auto future = on_strand.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(future.get(), 3);
+
+    guard.reset();
+    session_thread.join();
+}
+
+TEST_F(DbConnectionTest, DeadlineInterruptsQuery) {
+    auto connection = Connect();
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_THROW(RunSync(connection->Query("sleep 5000", {}, After(std::chrono::milliseconds(200)))),
+                 DeadlineExceeded);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+
+    // 被中断的连接作废，不会再借出
+    EXPECT_TRUE(connection->IsBroken());
+    EXPECT_THROW(RunSync(connection->Query("echo", {"x"}, Deadline())), DbError);
+}
+
+TEST_F(DbConnectionTest, ExpiredDeadlineFailsFast) {
+    auto connection = Connect();
+    auto deadline = After(std::chrono::milliseconds(0));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    EXPECT_THROW(RunSync(connection->Query("echo", {"x"}, deadline)), DeadlineExceeded);
+    EXPECT_FALSE(connection->IsBroken());
+}
+
+TEST_F(DbConnectionTest, ConnectFailureThrows) {
+    // 取得一个没有监听的端口
+    unsigned short port = 0;
+    {
+        tcp::acceptor acceptor(io_context_, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+        port = acceptor.local_endpoint().port();
+    }
+
+    std::string conninfo = "host=127.0.0.1 port=" + std::to_string(port) +
+                           " user=test dbname=test sslmode=disable gssencmode=disable connect_timeout=2";
+    EXPECT_THROW(RunSync(Connection::Connect(io_context_, conninfo)), DbError);
+}
+
+// 与ApiRouter相同：按路由时限收紧截止时间后交给控制器，DeadlineExceeded由HttpSession转换为504
+class DialogRouter : public core::http::Router {
+public:
+    explicit DialogRouter(std::chrono::milliseconds timeout)
+        : controller_(std::make_shared<services::dialog::DialogService>()), timeout_(timeout) {}
+
+    void Initialize() override {}
+
+    Task<core::http::Response> Route(core::http::Request& request) override {
+        request.user_id = "user";
+        request.SetPathParam("id", "dialog");
+        request.deadline = request.deadline.Tighten(timeout_);
+        co_return co_await controller_.GetDialogById(request);
+    }
+
+private:
+    api::controllers::DialogController controller_;
+    std::chrono::milliseconds timeout_;
+};
+
+TEST(RequestDeadlineTest, RouteDeadlineCancelsSlowQuery) {
+    // 连接池的连接和取消请求使用进程共享的运行时，它要先于连接池构造、后于连接池析构
+    auto& shared_runtime = Runtime::GetInstance();
+    auto& pool = ConnectionPool::GetInstance();
+    PgMockServer server;
+    ASSERT_TRUE(pool.Initialize(server.ConnInfo(), 1, 2));
+    shared_runtime.Start();
+
+    // 会话持有准入控制器的连接凭证，准入控制器要比HTTP服务器的运行时后析构
+    core::http::AdmissionController admission;
+    RuntimeOptions options;
+    options.io_threads = 1;
+    options.blocking_threads = 1;
+    options.cpu_threads = 1;
+    Runtime runtime(options);
+    runtime.Start();
+
+    unsigned short port = 0;
+    {
+        net::io_context io_context;
+        tcp::acceptor acceptor(io_context, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+        port = acceptor.local_endpoint().port();
+    }
+    auto http_server = std::make_shared<core::http::HttpServer>(port, runtime, admission);
+    http_server->SetRouter(std::make_shared<DialogRouter>(std::chrono::milliseconds(200)));
+    http_server->Start();
+
+    // 语句卡住的时间远超路由时限
+    server.SetStatementDelay(std::chrono::seconds(5));
+
+    auto start = std::chrono::steady_clock::now();
+    net::io_context client_context;
+    tcp::socket socket(client_context);
+    socket.connect(tcp::endpoint(net::ip::make_address("127.0.0.1"), port));
+    std::string request = "GET /api/v1/dialogs/dialog HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    net::write(socket, net::buffer(request));
+
+    beast::flat_buffer buffer;
+    http::response<http::string_body> response;
+    http::read(socket, buffer, response);
+
+    // 截止时间到期时语句被取消，请求在时限附近以504结束，不等语句执行完
+    EXPECT_EQ(response.result_int(), 504);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+
+    // 取消请求在阻塞任务池上异步发出
+    for (int i = 0; i < 200 && server.CancelCount() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(server.CancelCount(), 1u);
+
+    // 被中断的连接已作废，不会回到空闲队列
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.active_connections, 0u);
+    EXPECT_EQ(stats.idle_connections, 0u);
+
+    http_server->Stop();
+    runtime.Stop();
+    pool.CloseAll();
+    shared_runtime.Stop();
+}
+
+} // namespace ai_backend::test
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <coroutine>
+#include <stdexcept>
+#include <string>
+
+#include <boost/asio.hpp>
+
+#include "core/async/deadline.h"
+#include "core/async/timeout_task.h"
+
+namespace ai_backend::test {
+
+using core::async::Deadline;
+using core::async::DeadlineExceeded;
+using core::async::Spawn;
+using core::async::Task;
+using core::async::TimeoutTask;
+using namespace std::chrono_literals;
+
+namespace {
+
+// 等待定时器到期
+struct TimerAwaiter {
+    boost::asio::steady_timer& timer;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        timer.async_wait([handle](const boost::system::error_code&) { handle.resume(); });
+    }
+    void await_resume() const noexcept {}
+};
+
+Task<int> Delayed(boost::asio::any_io_executor executor, std::chrono::milliseconds delay, int value) {
+    boost::asio::steady_timer timer(executor, delay);
+    co_await TimerAwaiter{timer};
+    co_return value;
+}
+
+} // namespace
+
+TEST(DeadlineTest, UnsetDeadlineNeverExpires) {
+    Deadline deadline;
+    EXPECT_FALSE(deadline.IsSet());
+    EXPECT_FALSE(deadline.IsExpired());
+    EXPECT_EQ(deadline.Remaining(), std::chrono::milliseconds::max());
+
+    bool fired = false;
+    auto registration = deadline.OnExpire([&]() { fired = true; });
+    deadline.Cancel();
+    EXPECT_FALSE(fired);
+}
+
+TEST(DeadlineTest, FiresCallbacksOnExpiry) {
+    boost::asio::io_context io_context;
+    auto deadline = Deadline::After(io_context.get_executor(), 10ms);
+
+    int fired = 0;
+    auto first = deadline.OnExpire([&]() { fired++; });
+    auto second = deadline.OnExpire([&]() { fired++; });
+    EXPECT_FALSE(deadline.IsExpired());
+
+    io_context.run();
+
+    EXPECT_EQ(fired, 2);
+    EXPECT_TRUE(deadline.IsExpired());
+    EXPECT_EQ(deadline.Remaining(), 0ms);
+
+    // 已到期时注册的回调立即执行
+    auto late = deadline.OnExpire([&]() { fired++; });
+    EXPECT_EQ(fired, 3);
+}
+
+TEST(DeadlineTest, RegistrationUnregistersOnDestruction) {
+    boost::asio::io_context io_context;
+    auto deadline = Deadline::After(io_context.get_executor(), 5ms);
+
+    bool fired = false;
+    {
+        auto registration = deadline.OnExpire([&]() { fired = true; });
+    }
+    io_context.run();
+
+    EXPECT_TRUE(deadline.IsExpired());
+    EXPECT_FALSE(fired);
+}
+
+TEST(DeadlineTest, TightenTakesEarlierExpiryAndFollowsParent) {
+    boost::asio::io_context io_context;
+    auto parent = Deadline::After(io_context.get_executor(), 1h);
+
+    // 更宽松的时限不改变截止时间
+    auto loose = parent.Tighten(2h);
+    EXPECT_EQ(loose.GetExpiry(), parent.GetExpiry());
+
+    auto child = parent.Tighten(30min);
+    EXPECT_LT(child.GetExpiry(), parent.GetExpiry());
+
+    // 取消父截止时间时派生的截止时间一起到期，反之不影响父截止时间
+    auto sibling = parent.Tighten(10min);
+    sibling.Cancel();
+    EXPECT_TRUE(sibling.IsExpired());
+    EXPECT_FALSE(parent.IsExpired());
+
+    bool child_fired = false;
+    auto registration = child.OnExpire([&]() { child_fired = true; });
+    parent.Cancel();
+    EXPECT_TRUE(child.IsExpired());
+    EXPECT_TRUE(child_fired);
+}
+
+TEST(TimeoutTaskTest, ReturnsResultBeforeTimeout) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    int result = 0;
+
+    auto outer = [&]() -> Task<void> {
+        result = co_await TimeoutTask<int>(executor, Delayed(executor, 1ms, 7), 10s);
+    };
+    Spawn(executor, outer());
+    io_context.run();
+
+    EXPECT_EQ(result, 7);
+}
+
+TEST(TimeoutTaskTest, ThrowsDeadlineExceededOnTimeout) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    bool timed_out = false;
+
+    auto outer = [&]() -> Task<void> {
+        try {
+            auto deadline = Deadline::After(executor, 5ms);
+            co_await TimeoutTask<int>(executor, Delayed(executor, 200ms, 7), deadline);
+        } catch (const DeadlineExceeded&) {
+            timed_out = true;
+        }
+    };
+    auto start = std::chrono::steady_clock::now();
+    Spawn(executor, outer());
+    io_context.run_for(100ms);
+
+    EXPECT_TRUE(timed_out);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 150ms);
+
+    // 子任务在后台运行结束后帧被释放
+    io_context.run();
+}
+
+TEST(TimeoutTaskTest, TimesOutAfterDuration) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    bool timed_out = false;
+
+    auto outer = [&]() -> Task<void> {
+        try {
+            co_await TimeoutTask<int>(executor, Delayed(executor, 200ms, 7), 5ms);
+        } catch (const DeadlineExceeded&) {
+            timed_out = true;
+        }
+    };
+    auto start = std::chrono::steady_clock::now();
+    Spawn(executor, outer());
+    io_context.run_for(100ms);
+
+    EXPECT_TRUE(timed_out);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 150ms);
+    io_context.run();
+}
+
+TEST(TimeoutTaskTest, ExpiredDeadlineSkipsTask) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    bool started = false;
+    bool timed_out = false;
+
+    auto child = [&]() -> Task<void> {
+        started = true;
+        co_return;
+    };
+    auto outer = [&]() -> Task<void> {
+        auto deadline = Deadline().Derive(executor);
+        deadline.Cancel();
+        try {
+            co_await TimeoutTask<void>(executor, child(), deadline);
+        } catch (const DeadlineExceeded&) {
+            timed_out = true;
+        }
+    };
+    Spawn(executor, outer());
+    io_context.run();
+
+    EXPECT_TRUE(timed_out);
+    EXPECT_FALSE(started);
+}
+
+TEST(TimeoutTaskTest, PropagatesException) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    std::string message;
+
+    auto throwing = []() -> Task<void> {
+        throw std::runtime_error("boom");
+        co_return;
+    };
+    auto outer = [&]() -> Task<void> {
+        try {
+            co_await TimeoutTask<void>(executor, throwing(), 10s);
+        } catch (const std::runtime_error& e) {
+            message = e.what();
+        }
+    };
+    Spawn(executor, outer());
+    io_context.run();
+
+    EXPECT_EQ(message, "boom");
+}
+
+} // namespace ai_backend::test
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "services/ai/streaming/delta_extractor.h"
+
+namespace ai_backend::test {
+
+using services::ai::streaming::DeltaExtractor;
+using services::ai::streaming::StreamDelta;
+
+TEST(DeltaExtractorTest, ExtractsContentWithoutCopy) {
+    const std::string chunk =
+        R"({"id":"x","object":"chat.completion.chunk","created":1,"model":"deepseek-chat",)"
+        R"("choices":[{"index":0,"delta":{"role":"assistant","content":"Hello"},"logprobs":null,"finish_reason":null}]})";
+
+    DeltaExtractor extractor;
+    StreamDelta delta;
+    ASSERT_TRUE(extractor.Extract(chunk, delta));
+
+    EXPECT_EQ(delta.content, "Hello");
+    EXPECT_TRUE(delta.reasoning_content.empty());
+    EXPECT_TRUE(delta.finish_reason.empty());
+    EXPECT_FALSE(delta.usage.has_value());
+    EXPECT_GE(delta.content.data(), chunk.data());
+    EXPECT_LT(delta.content.data(), chunk.data() + chunk.size());
+    EXPECT_EQ(extractor.GetFallbackCount(), 0);
+}
+
+TEST(DeltaExtractorTest, UnescapesIntoBuffer) {
+    const std::string chunk =
+        R"({"choices":[{"delta":{"content":"a\"b\\c\n你好 😀","reasoning_content":"think\t"}}]})";
+
+    DeltaExtractor extractor;
+    StreamDelta delta;
+    ASSERT_TRUE(extractor.Extract(chunk, delta));
+
+    EXPECT_EQ(delta.content, "a\"b\\c\n你好 😀");
+    EXPECT_EQ(delta.reasoning_content, "think\t");
+    EXPECT_EQ(extractor.GetFallbackCount(), 0);
+}
+
+TEST(DeltaExtractorTest, ExtractsFinishReasonAndUsage) {
+    const std::string chunk =
+        R"({"choices":[{"index":0,"delta":{"content":""},"finish_reason":"stop"}],)"
+        R"("usage":{"prompt_tokens":12,"completion_tokens":34,"total_tokens":46,)"
+        R"("prompt_tokens_details":{"cached_tokens":8}}})";
+
+    DeltaExtractor extractor;
+    StreamDelta delta;
+    ASSERT_TRUE(extractor.Extract(chunk, delta));
+
+    EXPECT_EQ(delta.finish_reason, "stop");
+    ASSERT_TRUE(delta.usage.has_value());
+    EXPECT_EQ(delta.usage->prompt_tokens, 12);
+    EXPECT_EQ(delta.usage->completion_tokens, 34);
+    EXPECT_EQ(delta.usage->total_tokens, 46);
+    EXPECT_EQ(delta.usage->cache_hit_tokens, 8);
+    EXPECT_EQ(extractor.GetFallbackCount(), 0);
+}
+
+TEST(DeltaExtractorTest, SkipsNestedValuesAndNulls) {
+    const std::string chunk =
+        R"({"meta":{"a":[1,{"b":"}]\"["}],"c":true},"choices":[{"delta":{"content":null,"tool_calls":[{"x":1}]}},{"delta":{"content":"second"}}],"usage":null})";
+
+    DeltaExtractor extractor;
+    StreamDelta delta;
+    ASSERT_TRUE(extractor.Extract(chunk, delta));
+
+    EXPECT_TRUE(delta.content.empty());
+    EXPECT_FALSE(delta.usage.has_value());
+    EXPECT_EQ(extractor.GetFallbackCount(), 0);
+}
+
+TEST(DeltaExtractorTest, FallsBackToDomOnUnusualInput) {
+    DeltaExtractor extractor;
+    StreamDelta delta;
+
+    // 成员名含转义
+    ASSERT_TRUE(extractor.Extract(R"({"choices":[{"delta":{"con\u0074ent":"x"}}]})", delta));
+    EXPECT_EQ(delta.content, "x");
+    EXPECT_EQ(extractor.GetFallbackCount(), 1);
+
+    // 用量为浮点数
+    ASSERT_TRUE(extractor.Extract(R"({"usage":{"prompt_tokens":1.0,"completion_tokens":2}})", delta));
+    ASSERT_TRUE(delta.usage.has_value());
+    EXPECT_EQ(delta.usage->prompt_tokens, 1);
+    EXPECT_EQ(delta.usage->completion_tokens, 2);
+    EXPECT_EQ(extractor.GetFallbackCount(), 2);
+
+    // 类型不符时忽略该字段
+    ASSERT_TRUE(extractor.Extract(R"({"choices":[{"delta":{"content":42}}]})", delta));
+    EXPECT_TRUE(delta.content.empty());
+    EXPECT_EQ(extractor.GetFallbackCount(), 3);
+}
+
+TEST(DeltaExtractorTest, RejectsInvalidJson) {
+    DeltaExtractor extractor;
+    StreamDelta delta;
+
+    EXPECT_FALSE(extractor.Extract(R"({"choices":[{"delta":{"content":"x"}})", delta));
+    EXPECT_FALSE(extractor.Extract("[DONE]", delta));
+    EXPECT_FALSE(extractor.Extract(R"({"choices":[]} trailing)", delta));
+}
+
+} // namespace ai_backend::test
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include <boost/asio.hpp>
+
+#include "core/async/event_loop.h"
+
+namespace ai_backend::test {
+
+using core::async::EventLoop;
+using core::async::QueueFullError;
+using core::async::Runtime;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Runtime不启动，由测试线程手动运行io_context，投递的任务在Drain之前一直排队
+size_t Drain(boost::asio::io_context& io_context) {
+    io_context.restart();
+    return io_context.poll();
+}
+
+void PostCounter(EventLoop& loop, int& counter) {
+    loop.Post(std::function<void()>([&counter]() { ++counter; }));
+}
+
+} // namespace
+
+TEST(EventLoopTest, PostRejectsWhenQueueIsFull) {
+    Runtime runtime;
+    EventLoop loop(runtime);
+    loop.ConfigureQueue(4, 1000ms, 10000ms);
+    loop.Start();
+    EXPECT_THROW(loop.ConfigureQueue(8, 1000ms, 10000ms), std::logic_error);
+
+    int executed = 0;
+    for (int i = 0; i < 4; ++i) {
+        PostCounter(loop, executed);
+    }
+    EXPECT_EQ(loop.GetPendingTasks(), 4u);
+    EXPECT_THROW(PostCounter(loop, executed), QueueFullError);
+    EXPECT_THROW(PostCounter(loop, executed), QueueFullError);
+    EXPECT_EQ(loop.GetRejectedTasks(), 2u);
+    EXPECT_EQ(loop.GetPendingTasks(), 4u);
+
+    // 积压排空后重新接受任务
+    Drain(runtime.GetIoContext());
+    EXPECT_EQ(executed, 4);
+    EXPECT_EQ(loop.GetPendingTasks(), 0u);
+    EXPECT_EQ(loop.GetQueueSojourn().count, 4u);
+
+    PostCounter(loop, executed);
+    EXPECT_EQ(loop.GetPendingTasks(), 1u);
+    Drain(runtime.GetIoContext());
+    EXPECT_EQ(executed, 5);
+    EXPECT_EQ(loop.GetPendingTasks(), 0u);
+    EXPECT_EQ(loop.GetRejectedTasks(), 2u);
+
+    loop.Stop();
+}
+
+TEST(EventLoopTest, PostRejectsWhileCoDelReportsOverload) {
+    Runtime runtime;
+    EventLoop loop(runtime);
+    // 不限队列长度，只由排队时间决定是否拒绝
+    loop.ConfigureQueue(0, 5ms, 20ms);
+    loop.Start();
+    auto& io_context = runtime.GetIoContext();
+
+    // 连续两个窗口的排队时间都超过目标，进入过载状态
+    int executed = 0;
+    for (int i = 0; i < 2; ++i) {
+        PostCounter(loop, executed);
+        std::this_thread::sleep_for(30ms);
+        Drain(io_context);
+    }
+    EXPECT_EQ(executed, 2);
+
+    // 过载时空队列仍然接受，有积压时拒绝
+    PostCounter(loop, executed);
+    EXPECT_THROW(PostCounter(loop, executed), QueueFullError);
+    EXPECT_EQ(loop.GetRejectedTasks(), 1u);
+    Drain(io_context);
+    EXPECT_EQ(executed, 3);
+    EXPECT_EQ(loop.GetPendingTasks(), 0u);
+
+    // 一个窗口内的排队时间回到目标以内后解除过载
+    std::this_thread::sleep_for(30ms);
+    PostCounter(loop, executed);
+    Drain(io_context);
+    PostCounter(loop, executed);
+    PostCounter(loop, executed);
+    EXPECT_EQ(loop.GetPendingTasks(), 2u);
+    Drain(io_context);
+    EXPECT_EQ(executed, 6);
+    EXPECT_EQ(loop.GetPendingTasks(), 0u);
+    EXPECT_EQ(loop.GetRejectedTasks(), 1u);
+
+    loop.Stop();
+}
+
+} // namespace ai_backend::test
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+
+#include "core/async/frame_allocator.h"
+#include "core/async/task.h"
+
+namespace ai_backend::test {
+
+using core::async::FrameArena;
+using core::async::GetFrameAllocatorStats;
+using core::async::Task;
+
+namespace {
+
+Task<int> Leaf(int value) {
+    co_return value;
+}
+
+Task<int> Chain(int depth) {
+    if (depth == 0) {
+        co_return 0;
+    }
+    co_return co_await Chain(depth - 1) + co_await Leaf(1);
+}
+
+Task<int> ArenaLeaf(std::allocator_arg_t, FrameArena&, int value) {
+    co_return value;
+}
+
+Task<int> ArenaChain(std::allocator_arg_t, FrameArena& arena, int depth) {
+    int total = 0;
+    for (int i = 0; i < depth; ++i) {
+        total += co_await ArenaLeaf(std::allocator_arg, arena, 1);
+    }
+    co_return total;
+}
+
+struct Handler {
+    int base = 10;
+
+    Task<int> Handle(std::allocator_arg_t, FrameArena&, int value) {
+        co_return base + value;
+    }
+};
+
+// 在当前线程上同步运行到结束
+template <typename T>
+T RunSync(Task<T> task) {
+    auto driver = [](Task<T> inner, T* out) -> Task<void> {
+        *out = co_await inner;
+    };
+    T result{};
+    auto handle = driver(std::move(task), &result).Release();
+    handle.resume();
+    handle.destroy();
+    return result;
+}
+
+} // namespace
+
+TEST(FrameAllocatorTest, FramesAreReusedFromThreadCache) {
+    // 先运行一次填充当前线程的空闲链表
+    EXPECT_EQ(RunSync(Chain(8)), 8);
+
+    auto before = GetFrameAllocatorStats();
+    EXPECT_EQ(RunSync(Chain(8)), 8);
+    auto after = GetFrameAllocatorStats();
+
+    uint64_t frames = after.allocations - before.allocations;
+    EXPECT_GE(frames, 17u);
+    EXPECT_EQ(after.deallocations - before.deallocations, frames);
+    EXPECT_EQ(after.cache_hits - before.cache_hits, frames);
+}
+
+TEST(FrameAllocatorTest, ArenaFramesComeFromArena) {
+    FrameArena arena(256);
+    Handler handler;
+
+    auto before = GetFrameAllocatorStats();
+    EXPECT_EQ(RunSync(ArenaChain(std::allocator_arg, arena, 5)), 5);
+    EXPECT_EQ(RunSync(handler.Handle(std::allocator_arg, arena, 1)), 11);
+    auto after = GetFrameAllocatorStats();
+
+    EXPECT_EQ(after.arena_allocations - before.arena_allocations, 7u);
+    EXPECT_EQ(arena.GetLiveFrames(), 0u);
+    EXPECT_GT(arena.GetBytesReserved(), 0u);
+}
+
+TEST(FrameAllocatorTest, FramesFreedOnAnotherThread) {
+    auto task = Leaf(3);
+    auto before = GetFrameAllocatorStats();
+
+    std::thread([task = std::move(task)]() mutable {
+        EXPECT_EQ(RunSync(std::move(task)), 3);
+    }).join();
+
+    auto after = GetFrameAllocatorStats();
+    EXPECT_GE(after.deallocations - before.deallocations, 1u);
+}
+
+TEST(FrameAllocatorTest, PoolingCanBeDisabled) {
+    core::async::SetFramePoolingEnabled(false);
+    auto before = GetFrameAllocatorStats();
+    EXPECT_EQ(RunSync(Chain(4)), 4);
+    auto after = GetFrameAllocatorStats();
+    core::async::SetFramePoolingEnabled(true);
+
+    EXPECT_EQ(after.cache_hits, before.cache_hits);
+    EXPECT_GT(after.allocations, before.allocations);
+}
+
+} // namespace ai_backend::test
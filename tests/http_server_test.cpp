@@ -0,0 +1,269 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include "core/async/async_event.h"
+#include "core/async/runtime.h"
+#include "core/async/task.h"
+#include "core/http/admission_controller.h"
+#include "core/http/http_server.h"
+#include "core/http/router.h"
+#include "core/http/stream_pump.h"
+
+namespace ai_backend::test {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+using core::async::AsyncEvent;
+using core::async::Runtime;
+using core::async::RuntimeOptions;
+using core::async::Task;
+using core::http::AdmissionController;
+using core::http::HttpServer;
+using core::http::Request;
+using core::http::Response;
+using core::http::Router;
+using core::http::StreamPump;
+using core::http::StreamWriter;
+using namespace std::chrono_literals;
+
+namespace {
+
+// 每个请求都返回同一个流式处理函数
+class StreamRouter : public Router {
+public:
+    void Initialize() override {}
+
+    Task<Response> Route(Request& /*request*/) override {
+        Response response;
+        response.headers["Content-Type"] = "text/event-stream";
+        response.stream_handler = handler;
+        co_return response;
+    }
+
+    std::function<Task<void>(StreamWriter&)> handler;
+};
+
+// 在当前执行器上等待一段时间，恢复后当前执行器不变
+struct SleepAwaiter {
+    std::chrono::milliseconds delay;
+    std::shared_ptr<net::steady_timer> timer;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        auto executor = core::async::CurrentExecutor();
+        timer = std::make_shared<net::steady_timer>(executor, delay);
+        timer->async_wait([executor, handle](const boost::system::error_code&) {
+            core::async::ExecutorScope scope(executor);
+            handle.resume();
+        });
+    }
+    void await_resume() const noexcept {}
+};
+
+// 转发到会话的写入器，统计交给写入器的字节数
+class CountingWriter : public StreamWriter {
+public:
+    CountingWriter(StreamWriter& inner, std::atomic<size_t>& written) : inner_(inner), written_(written) {}
+
+    void Write(const std::string& data) override {
+        written_ += data.size();
+        inner_.Write(data);
+    }
+    void Write(core::memory::BufferChain data) override {
+        written_ += data.Size();
+        inner_.Write(std::move(data));
+    }
+    void End() override { inner_.End(); }
+    bool IsOpen() const override { return inner_.IsOpen(); }
+    bool IsWritable() const override { return inner_.IsWritable(); }
+    Task<void> WaitWritable() override { return inner_.WaitWritable(); }
+
+private:
+    StreamWriter& inner_;
+    std::atomic<size_t>& written_;
+};
+
+uint16_t FreePort() {
+    net::io_context io_context;
+    tcp::acceptor acceptor(io_context, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+    return acceptor.local_endpoint().port();
+}
+
+} // namespace
+
+class HttpServerTest : public ::testing::Test {
+protected:
+    HttpServerTest() : runtime_(Options()) {}
+
+    void SetUp() override {
+        runtime_.Start();
+        router_ = std::make_shared<StreamRouter>();
+        server_ = std::make_shared<HttpServer>(FreePort(), runtime_, admission_);
+        server_->SetRouter(router_);
+        server_->Start();
+    }
+
+    void TearDown() override {
+        server_->Stop();
+        runtime_.Stop();
+    }
+
+    static RuntimeOptions Options() {
+        RuntimeOptions options;
+        options.io_threads = 1;
+        options.blocking_threads = 1;
+        options.cpu_threads = 1;
+        return options;
+    }
+
+    // 建立连接并发送一个GET请求
+    tcp::socket SendRequest(const std::string& extra_headers = "") {
+        tcp::socket socket(client_context_);
+        socket.connect(tcp::endpoint(net::ip::make_address("127.0.0.1"), server_->GetPort()));
+        std::string request = "GET /stream HTTP/1.1\r\nHost: localhost\r\n" + extra_headers + "\r\n";
+        net::write(socket, net::buffer(request));
+        return socket;
+    }
+
+    // 会话持有准入控制器的连接凭证，准入控制器要比运行时 (及其中残留的会话) 后析构
+    AdmissionController admission_;
+    net::io_context client_context_;
+    Runtime runtime_;
+    std::shared_ptr<StreamRouter> router_;
+    std::shared_ptr<HttpServer> server_;
+};
+
+TEST_F(HttpServerTest, SendsHeadersBeforeHandlerWrites) {
+    AsyncEvent released;
+    router_->handler = [&](StreamWriter& writer) -> Task<void> {
+        auto wait = released.Wait();
+        co_await wait;
+        writer.Write("data: 1\n\n");
+    };
+
+    auto socket = SendRequest();
+    beast::flat_buffer buffer;
+    http::response_parser<http::string_body> parser;
+
+    // 处理函数还在等待时客户端已经收到响应头
+    http::read_header(socket, buffer, parser);
+    EXPECT_EQ(parser.get().result_int(), 200);
+    EXPECT_TRUE(parser.chunked());
+
+    released.Set();
+    http::read(socket, buffer, parser);
+    EXPECT_EQ(parser.get().body(), "data: 1\n\n");
+}
+
+TEST_F(HttpServerTest, EndsStreamWhenHandlerThrows) {
+    router_->handler = [](StreamWriter& writer) -> Task<void> {
+        writer.Write("partial");
+        SleepAwaiter sleep{10ms, nullptr};
+        co_await sleep;
+        throw std::runtime_error("handler failed");
+    };
+
+    auto socket = SendRequest();
+    beast::flat_buffer buffer;
+    http::response_parser<http::string_body> parser;
+    http::read(socket, buffer, parser);
+
+    // 已写出的数据块之后补发终止块，客户端收到完整的响应，连接仍可复用
+    EXPECT_TRUE(parser.is_done());
+    EXPECT_EQ(parser.get().body(), "partial");
+    EXPECT_TRUE(parser.get().keep_alive());
+}
+
+TEST_F(HttpServerTest, DeadlineEndsStream) {
+    std::promise<void> saw_closed;
+    router_->handler = [&](StreamWriter& writer) -> Task<void> {
+        writer.Write("start");
+        while (writer.IsOpen()) {
+            SleepAwaiter sleep{10ms, nullptr};
+            co_await sleep;
+        }
+        writer.Write("ignored");
+        saw_closed.set_value();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    auto socket = SendRequest("X-Request-Timeout: 200\r\n");
+    beast::flat_buffer buffer;
+    http::response_parser<http::string_body> parser;
+    http::read(socket, buffer, parser);
+
+    // 截止时间到期后写入器关闭，已排队的数据和终止块照常发出
+    EXPECT_TRUE(parser.is_done());
+    EXPECT_EQ(parser.get().body(), "start");
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+
+    // 终止块由截止时间回调发出，处理函数在下一次检查时才看到写入器已关闭
+    EXPECT_EQ(saw_closed.get_future().wait_for(5s), std::future_status::ready);
+}
+
+TEST_F(HttpServerTest, PumpStopsWritingWhileClientIsNotReading) {
+    // 远大于回环套接字的内核缓冲区，客户端不读时服务端必然积压
+    constexpr size_t kChunk = 4096;
+    constexpr size_t kChunks = 8192;
+    constexpr size_t kTotal = kChunk * kChunks;
+
+    std::atomic<bool> produced{false};
+    std::atomic<size_t> written{0};
+    router_->handler = [&](StreamWriter& writer) -> Task<void> {
+        CountingWriter counting(writer, written);
+        StreamPump pump(counting);
+
+        // 生产者在其他线程上同步推送，模拟上游客户端的token回调
+        std::thread producer([&]() {
+            std::string chunk(kChunk, 'x');
+            for (size_t i = 0; i < kChunks; ++i) {
+                pump.Push(chunk);
+            }
+            pump.Finish();
+            produced = true;
+        });
+
+        auto run = pump.Run();
+        co_await run;
+        producer.join();
+    };
+
+    auto socket = SendRequest();
+    beast::flat_buffer buffer;
+    http::response_parser<http::string_body> parser;
+    parser.body_limit((std::numeric_limits<std::uint64_t>::max)());
+    http::read_header(socket, buffer, parser);
+
+    while (!produced) {
+        std::this_thread::sleep_for(10ms);
+    }
+    std::this_thread::sleep_for(200ms);
+
+    // 客户端不读时，交给写入器的数据只比内核缓冲区多出高水位左右，其余数据留在pump中
+    EXPECT_GT(written.load(), 0u);
+    EXPECT_LT(written.load(), kTotal / 2);
+
+    http::read(socket, buffer, parser);
+    EXPECT_EQ(parser.get().body().size(), kTotal);
+    EXPECT_EQ(written.load(), kTotal);
+}
+
+} // namespace ai_backend::test
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include "core/async/loop_watchdog.h"
+#include "core/async/runtime.h"
+#include "core/utils/latency_histogram.h"
+
+namespace ai_backend::test {
+
+using core::async::HandlerIdentity;
+using core::async::Runtime;
+using core::async::RuntimeOptions;
+using core::async::Spawn;
+using core::async::Task;
+using core::utils::LatencyHistogram;
+using namespace std::chrono_literals;
+
+TEST(LoopWatchdogTest, HistogramReportsBucketUpperBounds) {
+    LatencyHistogram histogram;
+    for (int i = 0; i < 99; ++i) {
+        histogram.Record(3us);
+    }
+    histogram.Record(5ms);
+
+    auto snapshot = histogram.GetSnapshot();
+    EXPECT_EQ(snapshot.count, 100u);
+    EXPECT_EQ(snapshot.max_us, 5000u);
+    // 3微秒落在[2, 4)桶
+    EXPECT_EQ(snapshot.Percentile(0.5), 4u);
+    EXPECT_EQ(snapshot.Percentile(1.0), 5000u);
+    EXPECT_EQ(LatencyHistogram::Snapshot{}.Percentile(0.99), 0u);
+}
+
+TEST(LoopWatchdogTest, DescribesFunctionObjectsByType) {
+    auto handler = []() {};
+    EXPECT_NE(HandlerIdentity::Of(handler).Describe().find("lambda"), std::string::npos);
+    EXPECT_EQ(HandlerIdentity{}.Describe(), "unknown");
+}
+
+TEST(LoopWatchdogTest, RecordsLagAndSlowCoroutines) {
+    RuntimeOptions options;
+    options.io_threads = 1;
+    options.blocking_threads = 1;
+    options.cpu_threads = 1;
+    options.watchdog.probe_interval = 5ms;
+    options.watchdog.threshold = 20ms;
+    options.watchdog.report_interval = 0s;
+    Runtime runtime(options);
+    runtime.Start();
+
+    // 等待几轮探测，记录空闲时的延迟
+    std::this_thread::sleep_for(30ms);
+
+    std::promise<void> done;
+    auto blocking = [&]() -> Task<void> {
+        // 模拟IO线程上的同步调用
+        std::this_thread::sleep_for(80ms);
+        done.set_value();
+        co_return;
+    };
+    Spawn(runtime.GetIoExecutor(), blocking());
+    ASSERT_EQ(done.get_future().wait_for(5s), std::future_status::ready);
+    std::this_thread::sleep_for(30ms);
+    runtime.Stop();
+
+    auto stats = runtime.GetWatchdog()->GetStats();
+    ASSERT_EQ(stats.threads.size(), 1u);
+    const auto& thread = stats.threads[0];
+    EXPECT_GT(thread.lag.count, 0u);
+    // 阻塞期间投递的探测任务要等协程结束才能执行
+    EXPECT_GE(thread.lag.max_us, 20000u);
+    EXPECT_GE(thread.stalls, 1u);
+    EXPECT_EQ(thread.slow_handlers, 1u);
+    EXPECT_GE(thread.handlers.max_us, 80000u);
+
+    ASSERT_EQ(stats.slow_handlers.size(), 1u);
+    EXPECT_EQ(stats.slow_handlers[0].count, 1u);
+    EXPECT_GE(stats.slow_handlers[0].max_us, 80000u);
+}
+
+} // namespace ai_backend::test
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "core/memory/memory_pool.h"
+
+namespace ai_backend::test {
+
+using core::memory::MemoryPool;
+using core::memory::PoolAllocator;
+
+TEST(MemoryPoolTest, RoundsSizesToClasses) {
+    EXPECT_EQ(MemoryPool::GetBlockSize(0), 16u);
+    EXPECT_EQ(MemoryPool::GetBlockSize(1), 16u);
+    EXPECT_EQ(MemoryPool::GetBlockSize(17), 32u);
+    EXPECT_EQ(MemoryPool::GetBlockSize(1000), 1024u);
+    EXPECT_EQ(MemoryPool::GetBlockSize(MemoryPool::kMaxBlockSize), MemoryPool::kMaxBlockSize);
+    EXPECT_EQ(MemoryPool::GetBlockSize(MemoryPool::kMaxBlockSize + 1), MemoryPool::kMaxBlockSize + 1);
+}
+
+TEST(MemoryPoolTest, TracksLiveBlocksPerClass) {
+    MemoryPool pool;
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < 1000; ++i) {
+        void* block = pool.Allocate(100);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(block) % 128, 0u);
+        std::memset(block, 0xab, 100);
+        blocks.push_back(block);
+    }
+    void* large = pool.Allocate(100000);
+
+    auto stats = pool.GetStats();
+    const auto& size_class = stats.classes[3];
+    EXPECT_EQ(size_class.block_size, 128u);
+    EXPECT_EQ(size_class.GetLiveBlocks(), 1000u);
+    EXPECT_EQ(size_class.spans, 1u);
+    EXPECT_EQ(size_class.depot_blocks + size_class.cached_blocks + size_class.GetLiveBlocks(),
+              MemoryPool::kSpanSize / 128);
+    EXPECT_EQ(stats.large_live_bytes, 100000u);
+    EXPECT_EQ(stats.GetLiveBytes(), 1000u * 128 + 100000);
+
+    for (void* block : blocks) {
+        pool.Deallocate(block, 100);
+    }
+    pool.Deallocate(large, 100000);
+
+    stats = pool.GetStats();
+    EXPECT_EQ(stats.classes[3].GetLiveBlocks(), 0u);
+    EXPECT_EQ(stats.classes[3].allocations, 1000u);
+    EXPECT_EQ(stats.large_live_bytes, 0u);
+}
+
+TEST(MemoryPoolTest, FreesAcrossThreadsAndReleasesSpans) {
+    MemoryPool pool;
+    constexpr size_t kBlocks = 20000;
+    std::vector<void*> blocks(kBlocks);
+
+    std::thread producer([&] {
+        for (auto& block : blocks) {
+            block = pool.Allocate(64);
+        }
+    });
+    producer.join();
+
+    // 在另一个线程上释放，线程退出时弹匣交还仓库
+    std::thread consumer([&] {
+        for (void* block : blocks) {
+            pool.Deallocate(block, 64);
+        }
+    });
+    consumer.join();
+
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.classes[2].GetLiveBlocks(), 0u);
+    EXPECT_EQ(stats.classes[2].cached_blocks, 0u);
+    uint64_t spans = stats.classes[2].spans;
+    EXPECT_GE(spans, kBlocks * 64 / MemoryPool::kSpanSize);
+
+    // 第一次Trim只记录低水位，闲置满一个周期后才归还
+    EXPECT_EQ(pool.Trim(), 0u);
+    EXPECT_EQ(pool.Trim(), spans * MemoryPool::kSpanSize);
+
+    stats = pool.GetStats();
+    EXPECT_EQ(stats.classes[2].spans, 0u);
+    EXPECT_EQ(stats.classes[2].spans_released, spans);
+    EXPECT_EQ(stats.GetReservedBytes(), 0u);
+
+    // 释放后仍可以正常分配
+    void* block = pool.Allocate(64);
+    EXPECT_EQ(pool.GetStats().classes[2].spans, 1u);
+    pool.Deallocate(block, 64);
+}
+
+TEST(MemoryPoolTest, KeepsSpansInUse) {
+    MemoryPool pool;
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < 2 * MemoryPool::kSpanSize / 1024; ++i) {
+        blocks.push_back(pool.Allocate(1024));
+    }
+    // 保留一个块，它所在的span不能归还
+    for (size_t i = 1; i < blocks.size(); ++i) {
+        pool.Deallocate(blocks[i], 1024);
+    }
+
+    std::thread([&] { pool.ReleaseFreeMemory(); }).join();
+    EXPECT_GE(pool.GetStats().classes[6].spans, 1u);
+    std::memset(blocks[0], 0, 1024);
+    pool.Deallocate(blocks[0], 1024);
+}
+
+TEST(MemoryPoolTest, AllocatorWorksWithContainers) {
+    MemoryPool pool;
+    {
+        std::vector<int, PoolAllocator<int>> values{PoolAllocator<int>(pool)};
+        for (int i = 0; i < 10000; ++i) {
+            values.push_back(i);
+        }
+        EXPECT_EQ(values[9999], 9999);
+
+        std::map<int, std::string, std::less<>, PoolAllocator<std::pair<const int, std::string>>> names{
+            PoolAllocator<std::pair<const int, std::string>>(pool)};
+        for (int i = 0; i < 1000; ++i) {
+            names.emplace(i, std::to_string(i));
+        }
+        EXPECT_EQ(names.at(500), "500");
+        EXPECT_GT(pool.GetStats().GetLiveBytes(), 0u);
+    }
+    EXPECT_EQ(pool.GetStats().GetLiveBytes(), 0u);
+
+    EXPECT_EQ(PoolAllocator<int>(pool), PoolAllocator<double>(pool));
+    EXPECT_NE(PoolAllocator<int>(pool), PoolAllocator<int>());
+}
+
+} // namespace ai_backend::test
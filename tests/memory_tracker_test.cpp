@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/memory/memory_tracker.h"
+
+namespace ai_backend::test {
+
+using core::memory::GetMemoryTagName;
+using core::memory::MemoryTag;
+using core::memory::MemoryTracker;
+using core::memory::ParseMemoryTag;
+using core::memory::TrackedResource;
+
+namespace {
+
+// 计数先记在线程本地，读取前合并当前线程的计数
+core::memory::MemoryTagStats StatsFor(MemoryTag tag) {
+    MemoryTracker::GetInstance().Flush();
+    return MemoryTracker::GetInstance().GetStats()[static_cast<size_t>(tag)];
+}
+
+} // namespace
+
+TEST(MemoryTrackerTest, TagNamesRoundTrip) {
+    EXPECT_STREQ(GetMemoryTagName(MemoryTag::kAiStream), "ai-stream");
+    EXPECT_EQ(ParseMemoryTag("ratelimit"), MemoryTag::kRateLimit);
+    EXPECT_EQ(ParseMemoryTag("websocket"), MemoryTag::kWebSocket);
+    EXPECT_FALSE(ParseMemoryTag("unknown").has_value());
+}
+
+TEST(MemoryTrackerTest, CountsLiveAndPeakBytesPerTag) {
+    auto before = StatsFor(MemoryTag::kCache);
+    auto other_before = StatsFor(MemoryTag::kDb);
+
+    {
+        std::pmr::vector<char> values(TrackedResource::ForTag(MemoryTag::kCache));
+        values.resize(10000);
+        auto during = StatsFor(MemoryTag::kCache);
+        EXPECT_EQ(during.live_bytes, before.live_bytes + 10000);
+        EXPECT_GE(during.peak_bytes, before.live_bytes + 10000);
+        EXPECT_EQ(during.allocations, before.allocations + 1);
+    }
+
+    auto after = StatsFor(MemoryTag::kCache);
+    EXPECT_EQ(after.live_bytes, before.live_bytes);
+    EXPECT_GE(after.peak_bytes, before.live_bytes + 10000);
+    EXPECT_EQ(after.deallocations, before.deallocations + 1);
+    EXPECT_EQ(after.allocated_bytes, before.allocated_bytes + 10000);
+
+    // 其他标签不受影响
+    EXPECT_EQ(StatsFor(MemoryTag::kDb).allocations, other_before.allocations);
+
+    MemoryTracker::GetInstance().ResetPeaks();
+    EXPECT_EQ(StatsFor(MemoryTag::kCache).peak_bytes, after.live_bytes);
+}
+
+TEST(MemoryTrackerTest, FlushesThreadCountersOnExit) {
+    auto before = StatsFor(MemoryTag::kCache);
+
+    std::thread([]() {
+        auto* resource = TrackedResource::ForTag(MemoryTag::kCache);
+        void* ptr = resource->allocate(100);
+        resource->deallocate(ptr, 100);
+    }).join();
+
+    auto after = MemoryTracker::GetInstance().GetStats()[static_cast<size_t>(MemoryTag::kCache)];
+    EXPECT_EQ(after.allocations, before.allocations + 1);
+    EXPECT_EQ(after.deallocations, before.deallocations + 1);
+    EXPECT_EQ(after.live_bytes, before.live_bytes);
+}
+
+TEST(MemoryTrackerTest, ComputesAllocationRates) {
+    auto& tracker = MemoryTracker::GetInstance();
+    tracker.Flush();
+    tracker.UpdateRates();
+
+    std::pmr::string value(TrackedResource::ForTag(MemoryTag::kCache));
+    for (int i = 0; i < 100; ++i) {
+        value = std::string(100 + i, 'x');
+        value.shrink_to_fit();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    tracker.Flush();
+    tracker.UpdateRates();
+
+    auto stats = StatsFor(MemoryTag::kCache);
+    EXPECT_GT(stats.allocations_per_second, 0.0);
+    EXPECT_GT(stats.bytes_per_second, stats.allocations_per_second * 100);
+}
+
+TEST(MemoryTrackerTest, DumpsSampledAllocationsAsHeapProfile) {
+    auto& tracker = MemoryTracker::GetInstance();
+    auto before = tracker.GetProfileStats();
+
+    // 间隔为1字节时每次分配都会采样
+    tracker.SetSampleInterval(1);
+    std::vector<std::pmr::string> live;
+    live.reserve(8);
+    for (int i = 0; i < 8; ++i) {
+        live.emplace_back(std::string(1000, 'r'), TrackedResource::ForTag(MemoryTag::kRateLimit));
+    }
+    {
+        std::pmr::string freed(std::string(5000, 'w'), TrackedResource::ForTag(MemoryTag::kWebSocket));
+    }
+    tracker.SetSampleInterval(0);
+
+    auto stats = tracker.GetProfileStats();
+    EXPECT_EQ(stats.samples, before.samples + 9);
+    EXPECT_EQ(stats.live_samples, before.live_samples + 8);
+
+    std::string profile = tracker.DumpHeapProfile(MemoryTag::kRateLimit);
+    EXPECT_EQ(profile.rfind("heap profile:", 0), 0u);
+    EXPECT_NE(profile.find("@ heap_v2/1\n"), std::string::npos);
+    EXPECT_NE(profile.find("\nMAPPED_LIBRARIES:\n"), std::string::npos);
+    // 同一调用点的8次分配合并为一条记录，字节数是请求的大小 (含字符串结尾的空字符)
+    EXPECT_NE(profile.find("     8:     8008 [     8:     8008] @ 0x"), std::string::npos);
+
+    // 已释放的采样只计入累计分配
+    std::string websocket_profile = tracker.DumpHeapProfile(MemoryTag::kWebSocket);
+    EXPECT_NE(websocket_profile.find("     0:        0 [     1:     5001] @ 0x"), std::string::npos);
+
+    live.clear();
+    EXPECT_EQ(tracker.GetProfileStats().live_samples, before.live_samples);
+    EXPECT_EQ(tracker.DumpHeapProfile(MemoryTag::kRateLimit).rfind("heap profile:      0:        0 [", 0), 0u);
+}
+
+} // namespace ai_backend::test
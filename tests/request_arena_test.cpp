@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "core/http/request.h"
+#include "core/http/response.h"
+#include "core/memory/memory_pool.h"
+#include "core/memory/request_arena.h"
+#include "models/message.h"
+
+namespace ai_backend::test {
+
+using core::memory::MemoryPool;
+using core::memory::PoolResource;
+using core::memory::RequestArena;
+using core::memory::RequestArenaSlot;
+
+TEST(RequestArenaTest, CountsAndResetsPerRequest) {
+    RequestArena arena(4096);
+    auto before = RequestArena::GetStats();
+
+    std::pmr::vector<std::pmr::string> values(&arena);
+    for (int i = 0; i < 100; ++i) {
+        values.emplace_back("a string that does not fit in the small buffer " + std::to_string(i));
+    }
+    EXPECT_GT(arena.GetAllocations(), 100u);
+    EXPECT_GT(arena.GetBytesAllocated(), 4096u);
+
+    values = std::pmr::vector<std::pmr::string>(&arena);
+    arena.Reset();
+    EXPECT_EQ(arena.GetAllocations(), 0u);
+
+    auto after = RequestArena::GetStats();
+    EXPECT_EQ(after.requests, before.requests + 1);
+    EXPECT_GT(after.allocations, before.allocations + 100);
+    EXPECT_EQ(after.overflows, before.overflows + 1);
+
+    // 复位后从初始缓冲区重新开始
+    std::pmr::string small("fits", &arena);
+    EXPECT_EQ(arena.GetAllocations(), 0u);
+    std::pmr::string large(100, 'x', &arena);
+    EXPECT_EQ(arena.GetAllocations(), 1u);
+}
+
+TEST(RequestArenaTest, SlotHandsOutOneArenaPerRequest) {
+    RequestArenaSlot slot(1024);
+    RequestArena* first_arena;
+    {
+        auto first = slot.Acquire();
+        first_arena = first.Get();
+        std::pmr::string value(200, 'x', first.Get());
+
+        // 前一个请求尚未归还时借出另一个arena
+        auto second = slot.Acquire();
+        EXPECT_NE(second.Get(), first_arena);
+    }
+
+    auto reused = slot.Acquire();
+    EXPECT_EQ(reused->GetAllocations(), 0u);
+}
+
+TEST(RequestArenaTest, RequestAndModelsAllocateFromArena) {
+    RequestArena arena;
+
+    core::http::Request request(&arena);
+    request.cors_headers["Access-Control-Allow-Origin"] = "https://example.com";
+    request.client_ip = "192.168.100.200";
+    EXPECT_EQ(request.GetMemoryResource(), &arena);
+    EXPECT_EQ(request.cors_headers.get_allocator().resource(), &arena);
+
+    core::http::Response response(request.GetMemoryResource());
+    response.SetHeader("X-Request-Id", std::string(40, 'r'));
+    EXPECT_EQ(response.headers.begin()->first.get_allocator().resource(), &arena);
+
+    std::pmr::vector<models::pmr::Message> messages(&arena);
+    auto& message = messages.emplace_back();
+    message.content = std::string(200, 'c');
+    message.attachments.emplace_back().url = std::string(100, 'u');
+    EXPECT_EQ(message.content.get_allocator().resource(), &arena);
+    EXPECT_EQ(message.attachments[0].url.get_allocator().resource(), &arena);
+
+    // 容器扩容时元素按uses-allocator规则移入同一个arena
+    for (int i = 0; i < 10; ++i) {
+        messages.emplace_back().id = std::string(50, 'i');
+    }
+    EXPECT_EQ(messages[0].content, std::pmr::string(200, 'c'));
+    EXPECT_EQ(messages[0].attachments[0].url.get_allocator().resource(), &arena);
+}
+
+TEST(RequestArenaTest, PoolResourceServesAlignedRequests) {
+    MemoryPool pool;
+    PoolResource resource(pool);
+
+    void* small = resource.allocate(24, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(small) % 64, 0u);
+    void* large = resource.allocate(MemoryPool::kMaxBlockSize * 2, 128);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(large) % 128, 0u);
+    EXPECT_EQ(pool.GetStats().classes[2].GetLiveBlocks(), 1u);
+
+    resource.deallocate(small, 24, 64);
+    resource.deallocate(large, MemoryPool::kMaxBlockSize * 2, 128);
+    EXPECT_EQ(pool.GetStats().GetLiveBytes(), 0u);
+    EXPECT_TRUE(resource.is_equal(PoolResource(pool)));
+    EXPECT_FALSE(resource.is_equal(*PoolResource::GetInstance()));
+}
+
+} // namespace ai_backend::test
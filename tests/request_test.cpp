@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include "core/async/runtime.h"
+#include "core/async/task.h"
+#include "core/http/admission_controller.h"
+#include "core/http/http_server.h"
+#include "core/http/request.h"
+#include "core/http/router.h"
+
+namespace ai_backend::test {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+using core::async::Runtime;
+using core::async::RuntimeOptions;
+using core::async::Task;
+using core::http::AdmissionController;
+using core::http::HttpServer;
+using core::http::Request;
+using core::http::Response;
+using core::http::Router;
+using namespace std::chrono_literals;
+
+TEST(RequestTest, ParseQueryStringSkipsEmptyPairs) {
+    Request request;
+    request.ParseQueryString("a=1&&b=2&");
+
+    EXPECT_EQ(request.query_string, "a=1&&b=2&");
+    ASSERT_EQ(request.query_params.size(), 2u);
+    EXPECT_EQ(request.GetQueryParam("a"), "1");
+    EXPECT_EQ(request.GetQueryParam("b"), "2");
+    EXPECT_FALSE(request.HasQueryParam(""));
+}
+
+TEST(RequestTest, ParseQueryStringKeepsKeysWithoutValue) {
+    Request request;
+    request.ParseQueryString("flag&name=&x=1=2");
+
+    ASSERT_EQ(request.query_params.size(), 3u);
+    EXPECT_TRUE(request.HasQueryParam("flag"));
+    EXPECT_EQ(request.GetQueryParam("flag", "default"), "");
+    EXPECT_TRUE(request.HasQueryParam("name"));
+    EXPECT_EQ(request.GetQueryParam("name", "default"), "");
+    // 只按第一个'='切分，值未做URL解码
+    EXPECT_EQ(request.GetQueryParam("x"), "1=2");
+}
+
+TEST(RequestTest, DuplicateQueryKeysReturnFirstValue) {
+    Request request;
+    request.ParseQueryString("tag=a&tag=b&tag=c");
+
+    // 所有值都保留在query_params中，按名称查找取第一个
+    ASSERT_EQ(request.query_params.size(), 3u);
+    EXPECT_EQ(request.GetQueryParam("tag"), "a");
+    EXPECT_EQ(request.query_params[2].second, "c");
+}
+
+TEST(RequestTest, ParseQueryStringReplacesPreviousParams) {
+    Request request;
+    request.ParseQueryString("a=1");
+    request.ParseQueryString("b=2");
+
+    EXPECT_FALSE(request.HasQueryParam("a"));
+    EXPECT_EQ(request.GetQueryParam("b"), "2");
+}
+
+TEST(RequestTest, GetHeaderIgnoresCase) {
+    http::fields fields;
+    fields.set("Content-Type", "application/json");
+    fields.set("X-Request-Id", "r1");
+
+    Request request;
+    request.SetHeaderSource(&fields);
+    request.AddHeader("X-Extra", "extra");
+
+    EXPECT_EQ(request.GetHeader("content-type"), "application/json");
+    EXPECT_EQ(request.GetHeader("CONTENT-TYPE"), "application/json");
+    EXPECT_EQ(request.GetHeader("x-request-id"), "r1");
+    EXPECT_EQ(request.GetHeader("x-EXTRA"), "extra");
+    EXPECT_TRUE(request.HasHeader("x-extra"));
+    EXPECT_EQ(request.GetHeader("X-Missing"), "");
+    EXPECT_FALSE(request.HasHeader("X-Missing"));
+}
+
+namespace {
+
+// 在当前执行器上等待一段时间，恢复后当前执行器不变
+struct SleepAwaiter {
+    std::chrono::milliseconds delay;
+    std::shared_ptr<net::steady_timer> timer;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        auto executor = core::async::CurrentExecutor();
+        timer = std::make_shared<net::steady_timer>(executor, delay);
+        timer->async_wait([executor, handle](const boost::system::error_code&) {
+            core::async::ExecutorScope scope(executor);
+            handle.resume();
+        });
+    }
+    void await_resume() const noexcept {}
+};
+
+// 挂起一次后把会话解析出的字段写回响应体，字段以'|'分隔
+class EchoRouter : public Router {
+public:
+    void Initialize() override {}
+
+    Task<Response> Route(Request& request) override {
+        SleepAwaiter sleep{10ms, nullptr};
+        co_await sleep;
+
+        Response response;
+        response.status_code = 200;
+        response.headers["Content-Type"] = "text/plain";
+        response.body = std::string(request.path) + "|" + std::string(request.query_string) + "|" +
+                        std::string(request.GetQueryParam("q")) + "|" +
+                        std::string(request.GetHeader("x-trace"));
+        co_return response;
+    }
+};
+
+uint16_t FreePort() {
+    net::io_context io_context;
+    tcp::acceptor acceptor(io_context, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+    return acceptor.local_endpoint().port();
+}
+
+} // namespace
+
+class RequestParsingTest : public ::testing::Test {
+protected:
+    RequestParsingTest() : runtime_(Options()) {}
+
+    void SetUp() override {
+        runtime_.Start();
+        server_ = std::make_shared<HttpServer>(FreePort(), runtime_, admission_);
+        server_->SetRouter(std::make_shared<EchoRouter>());
+        server_->Start();
+        socket_.connect(tcp::endpoint(net::ip::make_address("127.0.0.1"), server_->GetPort()));
+    }
+
+    void TearDown() override {
+        socket_.close();
+        server_->Stop();
+        runtime_.Stop();
+    }
+
+    static RuntimeOptions Options() {
+        RuntimeOptions options;
+        options.io_threads = 1;
+        options.blocking_threads = 1;
+        options.cpu_threads = 1;
+        return options;
+    }
+
+    static std::string MakeRequest(const std::string& target, const std::string& trace) {
+        return "GET " + target + " HTTP/1.1\r\nHost: localhost\r\nX-Trace: " + trace + "\r\n\r\n";
+    }
+
+    std::string ReadBody() {
+        http::response<http::string_body> response;
+        http::read(socket_, buffer_, response);
+        EXPECT_EQ(response.result_int(), 200);
+        return response.body();
+    }
+
+    // 会话持有准入控制器的连接凭证，准入控制器要比运行时 (及其中残留的会话) 后析构
+    AdmissionController admission_;
+    net::io_context client_context_;
+    tcp::socket socket_{client_context_};
+    beast::flat_buffer buffer_;
+    Runtime runtime_;
+    std::shared_ptr<HttpServer> server_;
+};
+
+TEST_F(RequestParsingTest, StripsSchemeAndHostFromAbsoluteTarget) {
+    net::write(socket_, net::buffer(MakeRequest("http://example.com:8080/api/v1/models?q=1&x=2", "t1")));
+    EXPECT_EQ(ReadBody(), "/api/v1/models|q=1&x=2|1|t1");
+
+    // 没有路径部分时按根路径处理
+    net::write(socket_, net::buffer(MakeRequest("http://example.com?q=2", "t2")));
+    EXPECT_EQ(ReadBody(), "/|q=2|2|t2");
+}
+
+TEST_F(RequestParsingTest, FieldsStayValidWhileNextRequestIsBuffered) {
+    // 两个请求一次写出，第一个请求处理期间第二个请求已在会话的读缓冲区中，
+    // 处理完成后解析器和缓冲区被复用来读取第二个请求
+    net::write(socket_, net::buffer(MakeRequest("/first?q=one", "a") +
+                                    MakeRequest("http://localhost/second?q=two&q=three", "b")));
+
+    EXPECT_EQ(ReadBody(), "/first|q=one|one|a");
+    EXPECT_EQ(ReadBody(), "/second|q=two&q=three|two|b");
+}
+
+} // namespace ai_backend::test
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include "core/http/route_tree.h"
+
+namespace ai_backend::test {
+
+using core::http::RouteTree;
+
+class RouteTreeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tree_.Insert("GET", "/api/v1/dialogs", 0);
+        tree_.Insert("POST", "/api/v1/dialogs", 1);
+        tree_.Insert("GET", "/api/v1/dialogs/{id}", 2);
+        tree_.Insert("DELETE", "/api/v1/dialogs/{id}", 3);
+        tree_.Insert("GET", "/api/v1/dialogs/{dialog_id}/messages", 4);
+        tree_.Insert("GET", "/api/v1/dialogs/{dialog_id}/messages/{message_id}/reply", 5);
+        tree_.Insert("GET", "/api/v1/files/recent", 6);
+        tree_.Insert("GET", "/api/v1/files/{id}", 7);
+        tree_.Insert("POST", "/api/v1/auth/login", 8);
+    }
+
+    RouteTree tree_;
+};
+
+TEST_F(RouteTreeTest, MatchesStaticRoute) {
+    auto result = tree_.Match("POST", "/api/v1/dialogs");
+    ASSERT_EQ(result.status, RouteTree::MatchStatus::kFound);
+    EXPECT_EQ(result.route_id, 1);
+    EXPECT_EQ(result.param_count, 0);
+}
+
+TEST_F(RouteTreeTest, ExtractsParameters) {
+    auto result = tree_.Match("GET", "/api/v1/dialogs/d42/messages/m7/reply");
+    ASSERT_EQ(result.status, RouteTree::MatchStatus::kFound);
+    EXPECT_EQ(result.route_id, 5);
+    ASSERT_EQ(result.param_count, 2);
+    EXPECT_EQ(result.params[0].first, "dialog_id");
+    EXPECT_EQ(result.params[0].second, "d42");
+    EXPECT_EQ(result.params[1].first, "message_id");
+    EXPECT_EQ(result.params[1].second, "m7");
+}
+
+TEST_F(RouteTreeTest, ParameterNamesArePerRoute) {
+    auto result = tree_.Match("GET", "/api/v1/dialogs/d42");
+    ASSERT_EQ(result.status, RouteTree::MatchStatus::kFound);
+    ASSERT_EQ(result.param_count, 1);
+    EXPECT_EQ(result.params[0].first, "id");
+}
+
+TEST_F(RouteTreeTest, StaticSegmentTakesPriority) {
+    auto result = tree_.Match("GET", "/api/v1/files/recent");
+    ASSERT_EQ(result.status, RouteTree::MatchStatus::kFound);
+    EXPECT_EQ(result.route_id, 6);
+
+    result = tree_.Match("GET", "/api/v1/files/rec");
+    ASSERT_EQ(result.status, RouteTree::MatchStatus::kFound);
+    EXPECT_EQ(result.route_id, 7);
+    EXPECT_EQ(result.params[0].second, "rec");
+}
+
+TEST_F(RouteTreeTest, ReportsMethodNotAllowed) {
+    auto result = tree_.Match("PUT", "/api/v1/dialogs/d42");
+    ASSERT_EQ(result.status, RouteTree::MatchStatus::kMethodNotAllowed);
+    EXPECT_EQ(result.allow, "GET, DELETE");
+
+    result = tree_.Match("GET", "/api/v1/auth/login");
+    ASSERT_EQ(result.status, RouteTree::MatchStatus::kMethodNotAllowed);
+    EXPECT_EQ(result.allow, "POST");
+}
+
+TEST_F(RouteTreeTest, ReportsNotFound) {
+    EXPECT_EQ(tree_.Match("GET", "/api/v1/dialog").status, RouteTree::MatchStatus::kNotFound);
+    EXPECT_EQ(tree_.Match("GET", "/api/v1/dialogs/").status, RouteTree::MatchStatus::kNotFound);
+    EXPECT_EQ(tree_.Match("GET", "/api/v1/dialogs/d42/unknown").status, RouteTree::MatchStatus::kNotFound);
+}
+
+TEST_F(RouteTreeTest, RejectsInvalidRoutes) {
+    EXPECT_THROW(tree_.Insert("GET", "/api/v1/dialogs", 9), std::invalid_argument);
+    EXPECT_THROW(tree_.Insert("GET", "/api/v1/{broken", 9), std::invalid_argument);
+    EXPECT_THROW(tree_.Insert("GET", "/api/v1/x{id}", 9), std::invalid_argument);
+    EXPECT_THROW(tree_.Insert("BREW", "/api/v1/coffee", 9), std::invalid_argument);
+}
+
+} // namespace ai_backend::test
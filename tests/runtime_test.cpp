@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include <boost/asio.hpp>
+
+#include "core/async/runtime.h"
+
+namespace ai_backend::test {
+
+using core::async::IoMode;
+using core::async::Runtime;
+using core::async::RuntimeOptions;
+using core::async::Spawn;
+using core::async::Task;
+
+namespace {
+
+RuntimeOptions SmallOptions(IoMode mode) {
+    RuntimeOptions options;
+    options.io_threads = 2;
+    options.io_mode = mode;
+    options.blocking_threads = 2;
+    options.cpu_threads = 1;
+    return options;
+}
+
+} // namespace
+
+TEST(RuntimeTest, ParsesCpuLists) {
+    using core::async::detail::ParseCpuList;
+    EXPECT_EQ(ParseCpuList("0-3,8-9"), (std::vector<int>{0, 1, 2, 3, 8, 9}));
+    EXPECT_EQ(ParseCpuList("5"), (std::vector<int>{5}));
+    EXPECT_EQ(ParseCpuList(" 1, 3 \n"), (std::vector<int>{1, 3}));
+    EXPECT_TRUE(ParseCpuList("").empty());
+
+    EXPECT_EQ(RuntimeOptions::ParseIoMode("sharded"), IoMode::kSharded);
+    EXPECT_EQ(RuntimeOptions::ParseIoMode("bogus"), IoMode::kShared);
+    EXPECT_FALSE(core::async::detail::DetectNumaNodes().empty());
+}
+
+TEST(RuntimeTest, ShardedModeCreatesOneIoContextPerThread) {
+    Runtime shared(SmallOptions(IoMode::kShared));
+    EXPECT_EQ(shared.GetIoContextCount(), 1u);
+
+    Runtime sharded(SmallOptions(IoMode::kSharded));
+    EXPECT_EQ(sharded.GetIoContextCount(), 2u);
+    auto& first = sharded.NextIoContext();
+    EXPECT_NE(&first, &sharded.NextIoContext());
+    EXPECT_EQ(&first, &sharded.NextIoContext());
+
+    // 第0个io_context在重新配置后保持不变
+    auto* context = &sharded.GetIoContext();
+    sharded.Configure(SmallOptions(IoMode::kShared));
+    EXPECT_EQ(sharded.GetIoContextCount(), 1u);
+    EXPECT_EQ(&sharded.GetIoContext(), context);
+
+    sharded.Start();
+    EXPECT_THROW(sharded.Configure(SmallOptions(IoMode::kSharded)), std::logic_error);
+    sharded.Stop();
+}
+
+TEST(RuntimeTest, RunBlockingResumesOnIoExecutor) {
+    Runtime runtime(SmallOptions(IoMode::kShared));
+    EXPECT_THROW(runtime.GetBlockingPool(), std::logic_error);
+    runtime.Start();
+
+    auto executor = runtime.GetIoExecutor();
+    std::promise<void> done;
+    std::thread::id blocking_thread;
+    std::thread::id resumed_thread;
+    bool resumed_on_io = false;
+    int value = 0;
+    bool rethrown = false;
+
+    auto task = [&]() -> Task<void> {
+        value = co_await runtime.RunBlocking([&]() {
+            blocking_thread = std::this_thread::get_id();
+            return 42;
+        }, executor);
+        resumed_thread = std::this_thread::get_id();
+        resumed_on_io = runtime.GetIoContext().get_executor().running_in_this_thread();
+
+        try {
+            co_await runtime.RunCpu([]() { throw std::runtime_error("boom"); }, executor);
+        } catch (const std::runtime_error&) {
+            rethrown = runtime.GetIoContext().get_executor().running_in_this_thread();
+        }
+        done.set_value();
+    };
+    Spawn(executor, task());
+    ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    runtime.Stop();
+
+    EXPECT_EQ(value, 42);
+    EXPECT_NE(blocking_thread, resumed_thread);
+    EXPECT_TRUE(resumed_on_io);
+    EXPECT_TRUE(rethrown);
+}
+
+} // namespace ai_backend::test
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "services/ai/streaming/sse_parser.h"
+
+namespace ai_backend::test {
+
+using services::ai::streaming::SseEvent;
+using services::ai::streaming::SseParser;
+
+struct ParsedEvent {
+    std::string event;
+    std::string data;
+    std::string id;
+
+    bool operator==(const ParsedEvent& other) const {
+        return event == other.event && data == other.data && id == other.id;
+    }
+};
+
+// 按给定切分位置逐块喂给解析器，返回所有事件的副本
+std::vector<ParsedEvent> ParseInSlices(SseParser& parser, const std::string& stream,
+                                       const std::vector<size_t>& cuts) {
+    std::vector<ParsedEvent> events;
+    size_t begin = 0;
+    auto feed = [&](size_t end) {
+        // 每块单独分配，块失效后视图不能再被引用
+        std::string slice = stream.substr(begin, end - begin);
+        parser.Feed(slice);
+        SseEvent event;
+        while (parser.Next(event)) {
+            events.push_back({std::string(event.event), std::string(event.data), std::string(event.id)});
+        }
+        begin = end;
+    };
+    for (size_t cut : cuts) {
+        feed(cut);
+    }
+    feed(stream.size());
+    return events;
+}
+
+std::vector<ParsedEvent> Parse(const std::string& stream) {
+    SseParser parser;
+    return ParseInSlices(parser, stream, {});
+}
+
+TEST(SseParserTest, ParsesDeepseekStyleStream) {
+    auto events = Parse(
+        "data: {\"choices\":[{\"delta\":{\"content\":\"Hi\"}}]}\n\n"
+        ": keep-alive\n\n"
+        "data: [DONE]\n\n");
+
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[0], (ParsedEvent{"message", R"({"choices":[{"delta":{"content":"Hi"}}]})", ""}));
+    EXPECT_EQ(events[1].data, "[DONE]");
+}
+
+TEST(SseParserTest, HandlesLineEndingsAndFields) {
+    auto events = Parse(
+        "event: delta\r\nid: 7\r\ndata: first\r\ndata:second\r\n\r\n"
+        "data: cr only\r\r"
+        "retry: 1500\nevent: ignored\n\n");
+
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[0], (ParsedEvent{"delta", "first\nsecond", "7"}));
+    EXPECT_EQ(events[1], (ParsedEvent{"message", "cr only", "7"}));
+}
+
+TEST(SseParserTest, EmptyDataAndFieldWithoutColon) {
+    SseParser parser;
+    auto events = ParseInSlices(parser, "data\n\ndata:\ndata:\n\n", {});
+
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[0].data, "");
+    EXPECT_EQ(events[1].data, "\n");
+}
+
+TEST(SseParserTest, ParsesRetryAndSkipsBom) {
+    SseParser parser;
+    auto events = ParseInSlices(parser, "\xEF\xBB\xBFretry: 2500\ndata: x\n\n", {});
+
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].data, "x");
+    ASSERT_TRUE(parser.GetRetryMs().has_value());
+    EXPECT_EQ(*parser.GetRetryMs(), 2500);
+}
+
+TEST(SseParserTest, SameEventsForEverySplitPoint) {
+    const std::string stream =
+        "event: delta\r\n"
+        "data: {\"a\":1}\r\n"
+        "data: {\"b\":2}\r\n"
+        "\r\n"
+        ": comment\n"
+        "id: 42\n"
+        "data: tail\r"
+        "\r"
+        "data: [DONE]\n\n";
+
+    auto expected = Parse(stream);
+    ASSERT_EQ(expected.size(), 3);
+
+    // 一刀和两刀的所有切分位置
+    for (size_t i = 0; i <= stream.size(); ++i) {
+        SseParser parser;
+        EXPECT_EQ(ParseInSlices(parser, stream, {i}), expected) << "cut at " << i;
+
+        for (size_t j = i; j <= stream.size(); ++j) {
+            SseParser parser2;
+            ASSERT_EQ(ParseInSlices(parser2, stream, {i, j}), expected) << "cuts at " << i << "," << j;
+        }
+    }
+
+    // 逐字节输入
+    std::vector<size_t> cuts;
+    for (size_t i = 1; i < stream.size(); ++i) {
+        cuts.push_back(i);
+    }
+    SseParser parser;
+    EXPECT_EQ(ParseInSlices(parser, stream, cuts), expected);
+}
+
+TEST(SseParserTest, IncompleteEventIsHeldUntilBlankLine) {
+    SseParser parser;
+    SseEvent event;
+
+    parser.Feed("data: par");
+    EXPECT_FALSE(parser.Next(event));
+    parser.Feed("tial\n");
+    EXPECT_FALSE(parser.Next(event));
+    parser.Feed("\n");
+    ASSERT_TRUE(parser.Next(event));
+    EXPECT_EQ(event.data, "partial");
+    EXPECT_FALSE(parser.Next(event));
+}
+
+TEST(SseParserTest, RejectsOverlongLine) {
+    SseParser parser(12);
+    SseEvent event;
+
+    parser.Feed("data: 0123");
+    EXPECT_FALSE(parser.Next(event));
+    EXPECT_FALSE(parser.HasError());
+
+    parser.Feed("456789\n\n");
+    EXPECT_FALSE(parser.Next(event));
+    EXPECT_TRUE(parser.HasError());
+
+    parser.Reset();
+    parser.Feed("data: ok\n\n");
+    ASSERT_TRUE(parser.Next(event));
+    EXPECT_EQ(event.data, "ok");
+}
+
+} // namespace ai_backend::test
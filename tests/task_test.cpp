@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include <boost/asio.hpp>
+
+#include "core/async/task.h"
+
+namespace ai_backend::test {
+
+using core::async::ResumeOn;
+using core::async::Spawn;
+using core::async::Task;
+
+namespace {
+
+// 析构时置位，用于确认协程帧已销毁
+struct FrameGuard {
+    bool* destroyed;
+    ~FrameGuard() { *destroyed = true; }
+};
+
+Task<int> Value(int value, bool* started = nullptr) {
+    if (started) {
+        *started = true;
+    }
+    co_return value;
+}
+
+Task<int> Throwing() {
+    throw std::runtime_error("boom");
+    co_return 0;
+}
+
+Task<int> Sum(int count) {
+    int total = 0;
+    for (int i = 0; i < count; ++i) {
+        total += co_await Value(1);
+    }
+    co_return total;
+}
+
+Task<int> Recursive(int depth) {
+    if (depth == 0) {
+        co_return 0;
+    }
+    co_return 1 + co_await Recursive(depth - 1);
+}
+
+} // namespace
+
+TEST(TaskTest, StartsLazilyWhenAwaited) {
+    boost::asio::io_context io_context;
+    bool started = false;
+    int result = 0;
+
+    auto outer = [&]() -> Task<void> {
+        auto task = Value(42, &started);
+        EXPECT_FALSE(started);
+        result = co_await task;
+        EXPECT_TRUE(started);
+    };
+
+    Spawn(io_context.get_executor(), outer());
+    io_context.run();
+    EXPECT_EQ(result, 42);
+}
+
+TEST(TaskTest, PropagatesExceptions) {
+    boost::asio::io_context io_context;
+    bool caught = false;
+
+    auto outer = [&]() -> Task<void> {
+        try {
+            co_await Throwing();
+        } catch (const std::runtime_error& e) {
+            caught = std::string(e.what()) == "boom";
+        }
+    };
+
+    Spawn(io_context.get_executor(), outer());
+    io_context.run();
+    EXPECT_TRUE(caught);
+}
+
+TEST(TaskTest, LongAwaitChainsComplete) {
+    boost::asio::io_context io_context;
+    int sum = 0;
+    int depth = 0;
+
+    auto outer = [&]() -> Task<void> {
+        // 同步完成的子任务循环等待，对称转移在优化构建中编译为尾调用，栈深度不随次数增长；
+        // 开启sanitizer时编译器不做尾调用，次数取在默认栈大小以内
+        sum = co_await Sum(2000);
+        depth = co_await Recursive(500);
+    };
+
+    Spawn(io_context.get_executor(), outer());
+    io_context.run();
+    EXPECT_EQ(sum, 2000);
+    EXPECT_EQ(depth, 500);
+}
+
+TEST(TaskTest, SpawnedTaskDestroysItsFrame) {
+    boost::asio::io_context io_context;
+    bool ran = false;
+    bool destroyed = false;
+
+    auto body = [](bool* ran, bool* destroyed) -> Task<void> {
+        FrameGuard guard{destroyed};
+        *ran = true;
+        co_return;
+    };
+
+    Spawn(io_context.get_executor(), body(&ran, &destroyed));
+    EXPECT_FALSE(ran);
+    io_context.run();
+    EXPECT_TRUE(ran);
+    EXPECT_TRUE(destroyed);
+
+    // 异常只记录日志，不会传播出事件循环
+    io_context.restart();
+    Spawn(io_context.get_executor(), Throwing());
+    EXPECT_NO_THROW(io_context.run());
+}
+
+TEST(TaskTest, UnstartedSpawnIsDestroyedWithExecutor) {
+    bool ran = false;
+    bool destroyed = false;
+
+    auto body = [](bool* ran, bool* destroyed) -> Task<void> {
+        FrameGuard guard{destroyed};
+        *ran = true;
+        co_return;
+    };
+
+    {
+        boost::asio::io_context io_context;
+        Spawn(io_context.get_executor(), body(&ran, &destroyed));
+    }
+    EXPECT_FALSE(ran);
+    // 帧在挂起点之前就被销毁，局部变量未构造
+    EXPECT_FALSE(destroyed);
+}
+
+TEST(TaskTest, ResumesOnChosenExecutor) {
+    boost::asio::io_context main_context;
+    boost::asio::io_context other_context;
+    auto work = boost::asio::make_work_guard(other_context);
+    std::thread other_thread([&]() { other_context.run(); });
+
+    std::thread::id before, during, after;
+    auto outer = [&]() -> Task<void> {
+        before = std::this_thread::get_id();
+        co_await ResumeOn(other_context.get_executor());
+        during = std::this_thread::get_id();
+        co_await ResumeOn(main_context.get_executor());
+        after = std::this_thread::get_id();
+    };
+
+    // 切回main_context之前run()可能因无任务而返回，用work guard保持运行直到协程结束
+    // 协程lambda必须比任务活得久，不能直接调用临时lambda
+    auto main_work = boost::asio::make_work_guard(main_context);
+    auto run = [&]() -> Task<void> {
+        co_await outer();
+        main_work.reset();
+    };
+    Spawn(main_context.get_executor(), run());
+    main_context.run();
+
+    work.reset();
+    other_thread.join();
+
+    EXPECT_EQ(before, std::this_thread::get_id());
+    EXPECT_NE(during, std::this_thread::get_id());
+    EXPECT_EQ(after, std::this_thread::get_id());
+}
+
+} // namespace ai_backend::test
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "core/async/timer_wheel.h"
+
+namespace ai_backend::test {
+
+using core::async::TimerWheel;
+using namespace std::chrono_literals;
+
+TEST(TimerWheelTest, FiresAtExpiryAcrossLevels) {
+    auto origin = TimerWheel::Clock::now();
+    TimerWheel wheel(origin);
+
+    // 分别落在第0、1、2、3层，以及各层的边界
+    const std::vector<std::chrono::milliseconds> delays = {
+        1ms, 255ms, 256ms, 300ms, 65535ms, 65536ms, 70000ms, 16777216ms + 5ms};
+    std::vector<int> fired(delays.size(), 0);
+    std::vector<std::unique_ptr<TimerWheel::Timer>> timers;
+    for (size_t i = 0; i < delays.size(); ++i) {
+        timers.push_back(std::make_unique<TimerWheel::Timer>([&fired, i]() { ++fired[i]; }));
+        wheel.ScheduleAt(*timers.back(), origin + delays[i]);
+    }
+    EXPECT_EQ(wheel.Size(), delays.size());
+
+    for (size_t i = 0; i < delays.size(); ++i) {
+        wheel.Advance(origin + delays[i] - 1ms);
+        EXPECT_EQ(fired[i], 0) << "delay " << delays[i].count();
+        wheel.Advance(origin + delays[i]);
+        EXPECT_EQ(fired[i], 1) << "delay " << delays[i].count();
+    }
+    EXPECT_EQ(wheel.Size(), 0u);
+}
+
+TEST(TimerWheelTest, CancelAndRescheduleAreConstantTime) {
+    auto origin = TimerWheel::Clock::now();
+    TimerWheel wheel(origin);
+    int fired = 0;
+
+    TimerWheel::Timer first([&]() { fired += 1; });
+    TimerWheel::Timer second([&]() { fired += 10; });
+    wheel.ScheduleAt(first, origin + 10ms);
+    wheel.ScheduleAt(second, origin + 10ms);
+
+    EXPECT_TRUE(wheel.Cancel(first));
+    EXPECT_FALSE(wheel.Cancel(first));
+
+    // 空闲超时的用法：每次活动时把到期时间往后推
+    wheel.ScheduleAt(second, origin + 500ms);
+    wheel.Advance(origin + 100ms);
+    EXPECT_EQ(fired, 0);
+    wheel.Advance(origin + 500ms);
+    EXPECT_EQ(fired, 10);
+}
+
+TEST(TimerWheelTest, CallbacksMayRescheduleAndOwnedTimersRecur) {
+    auto origin = TimerWheel::Clock::now();
+    TimerWheel wheel(origin);
+
+    int recurring = 0;
+    wheel.ScheduleRecurring(100ms, [&]() { ++recurring; });
+
+    int one_shot = 0;
+    wheel.ScheduleAfter(-5ms, [&]() { ++one_shot; });
+
+    int self_rearm = 0;
+    TimerWheel::Timer timer;
+    timer.SetCallback([&]() {
+        if (++self_rearm < 3) {
+            wheel.ScheduleAt(timer, origin + 50ms * (self_rearm + 1));
+        }
+    });
+    wheel.ScheduleAt(timer, origin + 50ms);
+
+    wheel.Advance(origin + 1s);
+    EXPECT_GE(recurring, 9);
+    EXPECT_EQ(one_shot, 1);
+    EXPECT_EQ(self_rearm, 3);
+    EXPECT_EQ(wheel.Size(), 1u);
+}
+
+TEST(TimerWheelTest, DrivenByIoContext) {
+    boost::asio::io_context io_context;
+    auto& wheel = TimerWheel::For(io_context);
+    EXPECT_EQ(&wheel, &TimerWheel::For(io_context.get_executor()));
+
+    auto start = TimerWheel::Clock::now();
+    TimerWheel::Clock::time_point fired_at;
+    TimerWheel::Timer timer([&]() { fired_at = TimerWheel::Clock::now(); });
+    wheel.Schedule(timer, 20ms);
+
+    // 取消的定时器不应让io_context一直运行
+    TimerWheel::Timer cancelled([]() { FAIL(); });
+    wheel.Schedule(cancelled, 1h);
+    wheel.Cancel(cancelled);
+
+    io_context.run();
+    EXPECT_GE(fired_at - start, 20ms);
+    EXPECT_EQ(wheel.Size(), 0u);
+}
+
+} // namespace ai_backend::test
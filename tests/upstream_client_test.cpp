@@ -0,0 +1,302 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+
+#include "core/async/task.h"
+#include "core/http/upstream_client.h"
+
+namespace ai_backend::test {
+
+namespace beast = boost::beast;
+namespace net = boost::asio;
+namespace ssl = net::ssl;
+using tcp = net::ip::tcp;
+
+using core::http::UpstreamClient;
+using core::http::UpstreamRequest;
+using core::http::UpstreamResponse;
+
+// 使用config/ssl证书的本地HTTPS模拟上游，每个连接一个线程，支持keep-alive
+class TlsMockServer {
+public:
+    TlsMockServer()
+        : ssl_context_(ssl::context::tls_server),
+          acceptor_(io_context_, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0)) {
+        ssl_context_.use_certificate_chain_file(std::string(AI_BACKEND_SOURCE_DIR) + "/config/ssl/cert.pem");
+        ssl_context_.use_private_key_file(std::string(AI_BACKEND_SOURCE_DIR) + "/config/ssl/key.pem", ssl::context::pem);
+        accept_thread_ = std::thread([this]() { AcceptLoop(); });
+    }
+
+    ~TlsMockServer() {
+        // 阻塞中的accept不会因close返回，用一个本地连接唤醒接受线程
+        stopping_ = true;
+        beast::error_code ec;
+        tcp::socket wakeup(io_context_);
+        wakeup.connect(acceptor_.local_endpoint(), ec);
+        if (accept_thread_.joinable()) {
+            accept_thread_.join();
+        }
+        acceptor_.close(ec);
+
+        // 连接线程使用io_context_和ssl_context_，等它们结束 (客户端已断开，慢请求睡眠结束后写入失败)
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& thread : serve_threads_) {
+            thread.join();
+        }
+    }
+
+    std::string BaseUrl() const {
+        return "https://127.0.0.1:" + std::to_string(acceptor_.local_endpoint().port());
+    }
+
+private:
+    void AcceptLoop() {
+        for (;;) {
+            beast::error_code ec;
+            tcp::socket socket(io_context_);
+            acceptor_.accept(socket, ec);
+            if (ec || stopping_) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            serve_threads_.emplace_back([this, socket = std::move(socket)]() mutable {
+                Serve(std::move(socket));
+            });
+        }
+    }
+
+    void Serve(tcp::socket socket) {
+        beast::error_code ec;
+        beast::ssl_stream<tcp::socket> stream(std::move(socket), ssl_context_);
+        stream.handshake(ssl::stream_base::server, ec);
+        if (ec) {
+            return;
+        }
+
+        beast::flat_buffer buffer;
+        for (;;) {
+            beast::http::request<beast::http::string_body> request;
+            beast::http::read(stream, buffer, request, ec);
+            if (ec) {
+                return;
+            }
+
+            std::string target(request.target());
+            if (target == "/slow") {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+            }
+
+            if (target == "/stream") {
+                beast::http::response<beast::http::empty_body> response{beast::http::status::ok, request.version()};
+                response.set(beast::http::field::content_type, "text/event-stream");
+                response.chunked(true);
+                beast::http::response_serializer<beast::http::empty_body> serializer{response};
+                beast::http::write_header(stream, serializer, ec);
+                for (int i = 0; i < 3 && !ec; ++i) {
+                    std::string event = "data: {\"n\":" + std::to_string(i) + "}\n\n";
+                    net::write(stream, beast::http::make_chunk(net::buffer(event)), ec);
+                }
+                net::write(stream, beast::http::make_chunk_last(), ec);
+            } else {
+                beast::http::response<beast::http::string_body> response{beast::http::status::ok, request.version()};
+                response.set(beast::http::field::content_type, "application/json");
+                response.keep_alive(request.keep_alive());
+                response.body() = R"({"echo":")" + request.body() + R"("})";
+                response.prepare_payload();
+                beast::http::write(stream, response, ec);
+            }
+
+            if (ec) {
+                return;
+            }
+        }
+    }
+
+    net::io_context io_context_;
+    ssl::context ssl_context_;
+    tcp::acceptor acceptor_;
+    std::thread accept_thread_;
+    std::atomic<bool> stopping_{false};
+
+    std::mutex mutex_;
+    std::vector<std::thread> serve_threads_;
+};
+
+class UpstreamClientTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        work_guard_.emplace(io_context_.get_executor());
+        client_ = std::make_unique<UpstreamClient>(io_context_);
+        io_thread_ = std::thread([this]() { io_context_.run(); });
+    }
+
+    void TearDown() override {
+        StopIoThread();
+        client_.reset();
+    }
+
+    // 停止客户端的IO线程，之后不会再有传输在其上完成或释放
+    void StopIoThread() {
+        work_guard_.reset();
+        io_context_.stop();
+        if (io_thread_.joinable()) {
+            io_thread_.join();
+        }
+    }
+
+    UpstreamRequest MakeRequest(const std::string& path) const {
+        UpstreamRequest request;
+        request.method = "POST";
+        request.url = server_.BaseUrl() + path;
+        request.body = "ping";
+        request.verify_tls = false;
+        request.timeout = std::chrono::seconds(5);
+        return request;
+    }
+
+    // 在io_context上运行一次请求并同步等待结果
+    UpstreamResponse SendSync(UpstreamRequest request, core::http::UpstreamChunkHandler on_chunk = nullptr) {
+        std::promise<UpstreamResponse> promise;
+        auto future = promise.get_future();
+
+        core::async::Spawn(io_context_.get_executor(), Run(std::move(request), std::move(on_chunk), promise));
+
+        EXPECT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+        return future.get();
+    }
+
+    core::async::Task<void> Run(UpstreamRequest request,
+                                core::http::UpstreamChunkHandler on_chunk,
+                                std::promise<UpstreamResponse>& promise) {
+        UpstreamResponse response;
+        if (on_chunk) {
+            response = co_await client_->SendStream(std::move(request), std::move(on_chunk));
+        } else {
+            response = co_await client_->Send(std::move(request));
+        }
+        promise.set_value(std::move(response));
+    }
+
+    core::http::UpstreamPoolStats StatsFor(const std::string& base_url) const {
+        for (const auto& stats : client_->GetPoolStats()) {
+            if (stats.base_url == base_url) {
+                return stats;
+            }
+        }
+        return {};
+    }
+
+    TlsMockServer server_;
+    net::io_context io_context_;
+    std::optional<net::executor_work_guard<net::io_context::executor_type>> work_guard_;
+    std::unique_ptr<UpstreamClient> client_;
+    std::thread io_thread_;
+};
+
+TEST_F(UpstreamClientTest, BaseUrlOf) {
+    EXPECT_EQ(UpstreamClient::BaseUrlOf("https://api.deepseek.com/v1/chat/completions"), "https://api.deepseek.com");
+    EXPECT_EQ(UpstreamClient::BaseUrlOf("http://127.0.0.1:8080?x=1"), "http://127.0.0.1:8080");
+    EXPECT_EQ(UpstreamClient::BaseUrlOf("https://example.com"), "https://example.com");
+}
+
+TEST_F(UpstreamClientTest, ReusesTlsConnection) {
+    for (int i = 0; i < 5; ++i) {
+        auto response = SendSync(MakeRequest("/echo"));
+        ASSERT_TRUE(response.IsTransportOk()) << response.error;
+        EXPECT_EQ(response.status_code, 200);
+        EXPECT_EQ(response.body, R"({"echo":"ping"})");
+        EXPECT_EQ(response.headers["content-type"], "application/json");
+    }
+
+    auto stats = StatsFor(server_.BaseUrl());
+    EXPECT_EQ(stats.requests, 5);
+    EXPECT_EQ(stats.failures, 0);
+    EXPECT_EQ(stats.active, 0);
+    EXPECT_EQ(stats.connections_opened, 1);
+    EXPECT_EQ(stats.connections_reused, 4);
+    EXPECT_GT(stats.avg_tls_ms, 0.0);
+}
+
+TEST_F(UpstreamClientTest, PrewarmedConnectionIsReused) {
+    auto request = MakeRequest("/echo");
+    client_->Prewarm(request, 1);
+
+    // 等待预热请求完成
+    for (int i = 0; i < 100 && StatsFor(server_.BaseUrl()).requests == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    auto response = SendSync(request);
+    ASSERT_TRUE(response.IsTransportOk()) << response.error;
+
+    auto stats = StatsFor(server_.BaseUrl());
+    EXPECT_EQ(stats.requests, 2);
+    EXPECT_EQ(stats.connections_opened, 1);
+    EXPECT_EQ(stats.connections_reused, 1);
+}
+
+TEST_F(UpstreamClientTest, StreamsChunks) {
+    std::string received;
+    size_t chunks = 0;
+    auto response = SendSync(MakeRequest("/stream"), [&](std::string_view data) {
+        received.append(data);
+        chunks++;
+    });
+
+    ASSERT_TRUE(response.IsTransportOk()) << response.error;
+    EXPECT_EQ(response.status_code, 200);
+    EXPECT_TRUE(response.body.empty());
+    EXPECT_GE(chunks, 1);
+    EXPECT_EQ(received, "data: {\"n\":0}\n\ndata: {\"n\":1}\n\ndata: {\"n\":2}\n\n");
+}
+
+TEST_F(UpstreamClientTest, ResumesOnCallerStrand) {
+    // 会话在另一个io_context的strand上运行，响应到达后应回到该strand，而不是客户端的io_context
+    net::io_context session_context;
+    auto work = net::make_work_guard(session_context);
+    std::thread session_thread([&session_context]() { session_context.run(); });
+    auto strand = net::make_strand(session_context);
+
+    std::promise<bool> on_strand;
+    auto run = [&]() -> core::async::Task<void> {
+        auto response = co_await client_->Send(MakeRequest("/echo"));
+        EXPECT_TRUE(response.IsTransportOk()) << response.error;
+        on_strand.set_value(strand.running_in_this_thread());
+    };
+    core::async::Spawn(strand, run());
+
+    auto future = on_strand.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    EXPECT_TRUE(future.get());
+
+    // 传输在客户端线程上释放，先停止它再销毁会话的io_context
+    StopIoThread();
+    work.reset();
+    session_thread.join();
+}
+
+TEST_F(UpstreamClientTest, ReportsTimeout) {
+    auto request = MakeRequest("/slow");
+    request.timeout = std::chrono::milliseconds(200);
+
+    auto response = SendSync(request);
+    EXPECT_FALSE(response.IsTransportOk());
+    EXPECT_TRUE(response.timed_out);
+    EXPECT_EQ(StatsFor(server_.BaseUrl()).failures, 1);
+}
+
+} // namespace ai_backend::test
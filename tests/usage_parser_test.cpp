@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "services/ai/models/usage_parser.h"
+#include "services/ai/streaming/delta_extractor.h"
+
+namespace ai_backend::test {
+
+using services::ai::ParseTokenUsage;
+using services::ai::ToTokenUsage;
+using services::ai::TokenUsage;
+using services::ai::streaming::DeltaExtractor;
+using services::ai::streaming::StreamDelta;
+
+namespace {
+
+// 按流式路径解析：最后一个chunk中的usage经DeltaExtractor提取后转换
+TokenUsage StreamingUsage(const std::string& usage) {
+    DeltaExtractor extractor;
+    StreamDelta delta;
+    std::string chunk = R"({"choices":[{"index":0,"delta":{},"finish_reason":"stop"}],"usage":)" + usage + "}";
+    EXPECT_TRUE(extractor.Extract(chunk, delta));
+    EXPECT_TRUE(delta.usage.has_value());
+    return delta.usage ? ToTokenUsage(*delta.usage) : TokenUsage{};
+}
+
+} // namespace
+
+TEST(UsageParserTest, ReadsDeepSeekCacheHitTokens) {
+    auto usage = ParseTokenUsage(nlohmann::json::parse(
+        R"({"prompt_tokens":20,"completion_tokens":5,"total_tokens":25,)"
+        R"("prompt_cache_hit_tokens":16,"prompt_cache_miss_tokens":4})"));
+
+    EXPECT_EQ(usage.prompt_tokens, 20u);
+    EXPECT_EQ(usage.completion_tokens, 5u);
+    EXPECT_EQ(usage.cache_hit_tokens, 16u);
+}
+
+TEST(UsageParserTest, FallsBackToCachedTokens) {
+    const std::string usage =
+        R"({"prompt_tokens":20,"completion_tokens":5,"total_tokens":25,"prompt_tokens_details":{"cached_tokens":12}})";
+
+    auto parsed = ParseTokenUsage(nlohmann::json::parse(usage));
+    EXPECT_EQ(parsed.prompt_tokens, 20u);
+    EXPECT_EQ(parsed.completion_tokens, 5u);
+    EXPECT_EQ(parsed.cache_hit_tokens, 12u);
+
+    // 流式路径与非流式路径结果一致
+    auto streamed = StreamingUsage(usage);
+    EXPECT_EQ(streamed.prompt_tokens, 20u);
+    EXPECT_EQ(streamed.completion_tokens, 5u);
+    EXPECT_EQ(streamed.cache_hit_tokens, 12u);
+}
+
+TEST(UsageParserTest, PrefersCacheHitTokensRegardlessOfOrder) {
+    // cached_tokens出现在prompt_cache_hit_tokens之后也不覆盖
+    const std::string usage =
+        R"({"prompt_tokens":20,"completion_tokens":5,"prompt_cache_hit_tokens":16,)"
+        R"("prompt_tokens_details":{"cached_tokens":12}})";
+
+    EXPECT_EQ(ParseTokenUsage(nlohmann::json::parse(usage)).cache_hit_tokens, 16u);
+    EXPECT_EQ(StreamingUsage(usage).cache_hit_tokens, 16u);
+}
+
+TEST(UsageParserTest, MissingOrInvalidFieldsAreZero) {
+    const std::string usage = R"({"prompt_tokens":"20","prompt_tokens_details":null})";
+
+    auto parsed = ParseTokenUsage(nlohmann::json::parse(usage));
+    EXPECT_EQ(parsed.prompt_tokens, 0u);
+    EXPECT_EQ(parsed.completion_tokens, 0u);
+    EXPECT_EQ(parsed.cache_hit_tokens, 0u);
+
+    auto empty = ParseTokenUsage(nlohmann::json::object());
+    EXPECT_EQ(empty.prompt_tokens, 0u);
+    EXPECT_EQ(empty.cache_hit_tokens, 0u);
+}
+
+} // namespace ai_backend::test
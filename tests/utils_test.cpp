@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include "core/utils/json_writer.h"
 #include "core/utils/string_utils.h"
 #include "core/utils/uuid.h"
 
@@ -26,4 +28,22 @@ TEST(UuidTest, GenerateUuid) {
     EXPECT_TRUE(ai_backend::core::utils::UuidGenerator::IsValid(uuid));
 }
 
+// JSON写入器测试
+TEST(JsonWriterTest, WritesNestedValues) {
+    std::string out;
+    ai_backend::core::utils::JsonWriter writer(out);
+    writer.BeginObject()
+        .Key("code").Int(-1)
+        .Key("items").BeginArray()
+        .Uint(1).Bool(true).Null().BeginObject().EndObject()
+        .EndArray()
+        .Key("text").String("引号\"反斜杠\\换行\n\x01")
+        .EndObject();
+
+    EXPECT_EQ(out, R"({"code":-1,"items":[1,true,null,{}],"text":"引号\"反斜杠\\换行\n\u0001"})");
+
+    auto parsed = nlohmann::json::parse(out);
+    EXPECT_EQ(parsed["text"].get<std::string>(), "引号\"反斜杠\\换行\n\x01");
+}
+
 } // namespace ai_backend::test
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "core/async/async_scope.h"
+#include "core/async/when_all.h"
+#include "core/async/when_any.h"
+
+namespace ai_backend::test {
+
+using core::async::AsyncScope;
+using core::async::Deadline;
+using core::async::Spawn;
+using core::async::Task;
+using core::async::WhenAll;
+using core::async::WhenAny;
+using namespace std::chrono_literals;
+
+namespace {
+
+// 等待定时器到期，截止时间到期时提前返回
+struct SleepAwaiter {
+    std::shared_ptr<boost::asio::steady_timer> timer;
+    Deadline deadline;
+    Deadline::Registration registration;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        // 定时器可能在其他线程上立即恢复协程，启动等待之后不能再访问this
+        registration = deadline.OnExpire([timer = timer]() {
+            boost::asio::post(timer->get_executor(), [timer]() { timer->cancel(); });
+        });
+        timer->async_wait([handle](const boost::system::error_code&) { handle.resume(); });
+    }
+    void await_resume() const noexcept {}
+};
+
+Task<int> Delayed(boost::asio::any_io_executor executor, std::chrono::milliseconds delay, int value,
+                  Deadline cancel = {}) {
+    SleepAwaiter sleep{std::make_shared<boost::asio::steady_timer>(executor, delay), cancel, {}};
+    co_await sleep;
+    co_return value;
+}
+
+Task<void> FailAfter(boost::asio::any_io_executor executor, std::chrono::milliseconds delay) {
+    co_await Delayed(executor, delay, 0);
+    throw std::runtime_error("boom");
+}
+
+} // namespace
+
+TEST(WhenAllTest, RunsChildrenConcurrently) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    int first = 0;
+    std::string second;
+
+    auto text = [](std::string value) -> Task<std::string> { co_return value; };
+    auto outer = [&]() -> Task<void> {
+        auto [a, b, c] = co_await WhenAll(executor, Delayed(executor, 50ms, 1), text("x"), Delayed(executor, 50ms, 3));
+        first = a + c;
+        second = b;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    Spawn(executor, outer());
+    io_context.run();
+
+    EXPECT_EQ(first, 4);
+    EXPECT_EQ(second, "x");
+    // 两个50ms的子任务重叠执行
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 95ms);
+}
+
+TEST(WhenAllTest, PropagatesFirstExceptionAndCancelsSiblings) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    std::string message;
+
+    auto outer = [&]() -> Task<void> {
+        auto cancel = Deadline().Derive(executor);
+        try {
+            co_await WhenAll(executor, cancel, Delayed(executor, 10s, 1, cancel), FailAfter(executor, 5ms));
+        } catch (const std::runtime_error& e) {
+            message = e.what();
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    Spawn(executor, outer());
+    io_context.run();
+
+    EXPECT_EQ(message, "boom");
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+}
+
+TEST(WhenAllTest, CollectsVectorResultsOnThreadPool) {
+    boost::asio::thread_pool pool(4);
+    auto executor = pool.get_executor();
+    std::atomic<int> sum{0};
+    std::atomic<bool> done{false};
+
+    auto outer = [&]() -> Task<void> {
+        std::vector<Task<int>> tasks;
+        for (int i = 0; i < 200; ++i) {
+            tasks.push_back(Delayed(executor, 1ms, i));
+        }
+        auto results = co_await WhenAll(executor, std::move(tasks));
+        for (size_t i = 0; i < results.size(); ++i) {
+            EXPECT_EQ(results[i], static_cast<int>(i));
+            sum += results[i];
+        }
+        done = true;
+    };
+    Spawn(executor, outer());
+    pool.join();
+
+    EXPECT_TRUE(done);
+    EXPECT_EQ(sum, 199 * 200 / 2);
+}
+
+TEST(WhenAllTest, ResumesParentOnItsStrand) {
+    // 父协程运行在会话io_context的strand上，子任务在另一个io_context的线程上完成
+    boost::asio::io_context session_context;
+    boost::asio::io_context worker_context;
+    auto session_guard = boost::asio::make_work_guard(session_context);
+    auto worker_guard = boost::asio::make_work_guard(worker_context);
+    std::thread session_thread([&]() { session_context.run(); });
+    std::thread worker_thread([&]() { worker_context.run(); });
+
+    auto strand = boost::asio::make_strand(session_context);
+    auto worker = worker_context.get_executor();
+    std::promise<bool> on_strand;
+
+    auto outer = [&]() -> Task<void> {
+        auto [a, b] = co_await WhenAll(worker, Delayed(worker, 5ms, 1), Delayed(worker, 10ms, 2));
+        EXPECT_EQ(a + b, 3);
+        on_strand.set_value(strand.running_in_this_thread());
+    };
+    Spawn(strand, outer());
+
+    auto future = on_strand.get_future();
+    ASSERT_EQ(future.wait_for(5s), std::future_status::ready);
+    EXPECT_TRUE(future.get());
+
+    session_guard.reset();
+    worker_guard.reset();
+    session_thread.join();
+    worker_thread.join();
+}
+
+TEST(WhenAnyTest, ReturnsFirstAndCancelsLosers) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    size_t winner = 99;
+    int value = 0;
+
+    auto outer = [&]() -> Task<void> {
+        auto cancel = Deadline().Derive(executor);
+        auto result = co_await WhenAny(executor, cancel,
+                                       Delayed(executor, 10s, 1, cancel),
+                                       Delayed(executor, 5ms, 2, cancel));
+        winner = result.index();
+        value = std::get<1>(result);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    Spawn(executor, outer());
+    io_context.run();
+
+    EXPECT_EQ(winner, 1u);
+    EXPECT_EQ(value, 2);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+}
+
+TEST(AsyncScopeTest, JoinsSpawnedTasksAndRethrows) {
+    boost::asio::io_context io_context;
+    auto executor = io_context.get_executor();
+    std::atomic<int> completed{0};
+    std::string message;
+
+    auto outer = [&]() -> Task<void> {
+        AsyncScope scope(executor);
+        auto count = [&](std::chrono::milliseconds delay) -> Task<void> {
+            co_await Delayed(executor, delay, 0, scope.GetDeadline());
+            completed++;
+        };
+        scope.Spawn(count(1ms));
+        scope.Spawn(count(2ms));
+        co_await scope.Join();
+        EXPECT_EQ(completed, 2);
+        EXPECT_FALSE(scope.GetDeadline().IsExpired());
+
+        scope.Spawn(count(10s));
+        scope.Spawn(FailAfter(executor, 1ms));
+        try {
+            co_await scope.Join();
+        } catch (const std::runtime_error& e) {
+            message = e.what();
+        }
+        EXPECT_TRUE(scope.GetDeadline().IsExpired());
+        EXPECT_EQ(scope.GetActiveCount(), 0u);
+    };
+
+    Spawn(executor, outer());
+    io_context.run();
+
+    EXPECT_EQ(completed, 3);
+    EXPECT_EQ(message, "boom");
+}
+
+} // namespace ai_backend::test